@@ -108,6 +108,9 @@ public:
   const std::vector<std::vector<std::vector<double>>>& getPredictions() const {
     return predictions;
   }
+
+  // Load forest from file
+  void loadFromFile(std::string filename);
   size_t getDependentVarId() const {
     return dependent_varID;
   }
@@ -161,8 +164,6 @@ protected:
   void computeTreePermutationImportanceInThread(uint thread_idx, std::vector<double>& importance,
       std::vector<double>& variance);
 
-  // Load forest from file
-  void loadFromFile(std::string filename);
   virtual void loadFromFileInternal(std::ifstream& infile) = 0;
 
   // Set split select weights and variables to be always considered for splitting
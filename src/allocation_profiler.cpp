@@ -0,0 +1,140 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "allocation_profiler.hpp"
+
+#ifdef PROFILE_ALLOCATIONS
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace octopus {
+
+namespace {
+
+constexpr std::array<const char*, num_allocation_subsystems> subsystemNames {
+    "untagged", "readpipe", "hapgen", "models", "io"
+};
+
+struct SubsystemCounters
+{
+    std::atomic<std::uint64_t> bytes {0};
+    std::atomic<std::uint64_t> count {0};
+};
+
+// Relaxed atomics rather than a mutex; operator new is hot enough that lock
+// contention here would distort the very profile being measured
+std::array<SubsystemCounters, num_allocation_subsystems> allocation_counters {};
+
+thread_local AllocationSubsystem current_allocation_tag {AllocationSubsystem::untagged};
+
+void record_allocation(const std::size_t size) noexcept
+{
+    auto& counters = allocation_counters[static_cast<std::size_t>(current_allocation_tag)];
+    counters.bytes.fetch_add(size, std::memory_order_relaxed);
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+namespace detail {
+
+AllocationSubsystem exchange_allocation_tag(const AllocationSubsystem tag) noexcept
+{
+    const auto result = current_allocation_tag;
+    current_allocation_tag = tag;
+    return result;
+}
+
+} // namespace detail
+
+bool allocation_profiling_enabled() noexcept
+{
+    return true;
+}
+
+void write_allocation_report(std::ostream& os)
+{
+    os << "subsystem\tbytes\tcount\n";
+    for (std::size_t s {0}; s < num_allocation_subsystems; ++s) {
+        os << subsystemNames[s]
+           << '\t' << allocation_counters[s].bytes.load(std::memory_order_relaxed)
+           << '\t' << allocation_counters[s].count.load(std::memory_order_relaxed)
+           << '\n';
+    }
+}
+
+} // namespace octopus
+
+void* operator new(const std::size_t size)
+{
+    auto result = std::malloc(size > 0 ? size : 1);
+    if (!result) throw std::bad_alloc {};
+    octopus::record_allocation(size);
+    return result;
+}
+
+void* operator new[](const std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept
+{
+    auto result = std::malloc(size > 0 ? size : 1);
+    if (result) octopus::record_allocation(size);
+    return result;
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+#else
+
+namespace octopus {
+
+bool allocation_profiling_enabled() noexcept
+{
+    return false;
+}
+
+void write_allocation_report(std::ostream&) {}
+
+} // namespace octopus
+
+#endif
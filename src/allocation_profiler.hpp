@@ -0,0 +1,79 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef allocation_profiler_hpp
+#define allocation_profiler_hpp
+
+//#define PROFILE_ALLOCATIONS
+
+#include <cstddef>
+#include <ostream>
+
+namespace octopus {
+
+// Opt-in accounting of global operator new, tagged by subsystem. When
+// PROFILE_ALLOCATIONS is defined the translation unit replaces the global
+// allocation functions and charges every request to the subsystem named by
+// the innermost ScopedAllocationTag on the calling thread; untagged threads
+// (and code outside any tag) are charged to 'untagged'. The report counts
+// bytes requested, not bytes resident - it is an allocation-pressure profile
+// for finding allocation storms, not a leak detector. Without the flag the
+// tags compile to nothing and the allocator is untouched
+
+enum class AllocationSubsystem : std::size_t
+{
+    untagged, readpipe, hapgen, models, io
+};
+
+constexpr std::size_t num_allocation_subsystems {5};
+
+bool allocation_profiling_enabled() noexcept;
+
+void write_allocation_report(std::ostream& os);
+
+#ifdef PROFILE_ALLOCATIONS
+
+namespace detail {
+
+AllocationSubsystem exchange_allocation_tag(AllocationSubsystem tag) noexcept;
+
+} // namespace detail
+
+class ScopedAllocationTag
+{
+public:
+    ScopedAllocationTag() = delete;
+
+    explicit ScopedAllocationTag(AllocationSubsystem tag) noexcept
+    : previous_ {detail::exchange_allocation_tag(tag)}
+    {}
+
+    ScopedAllocationTag(const ScopedAllocationTag&)            = delete;
+    ScopedAllocationTag& operator=(const ScopedAllocationTag&) = delete;
+
+    ~ScopedAllocationTag() noexcept
+    {
+        detail::exchange_allocation_tag(previous_);
+    }
+
+private:
+    AllocationSubsystem previous_;
+};
+
+#else
+
+class ScopedAllocationTag
+{
+public:
+    ScopedAllocationTag() = delete;
+    explicit ScopedAllocationTag(AllocationSubsystem) noexcept {}
+    ScopedAllocationTag(const ScopedAllocationTag&)            = delete;
+    ScopedAllocationTag& operator=(const ScopedAllocationTag&) = delete;
+    ~ScopedAllocationTag() = default;
+};
+
+#endif
+
+} // namespace octopus
+
+#endif
@@ -4,6 +4,7 @@
 #include "aligned_read.hpp"
 
 #include <ostream>
+#include <unordered_map>
 
 #include <boost/functional/hash.hpp>
 
@@ -42,7 +43,7 @@ bool AlignedRead::Segment::is_marked_reverse_mapped() const
 
 const std::string& AlignedRead::name() const noexcept
 {
-    return name_;
+    return *name_;
 }
 
 const std::string& AlignedRead::read_group() const noexcept
@@ -57,22 +58,22 @@ const GenomicRegion& AlignedRead::mapped_region() const noexcept
 
 const AlignedRead::NucleotideSequence& AlignedRead::sequence() const noexcept
 {
-    return sequence_;
+    return data_->sequence;
 }
 
-AlignedRead::NucleotideSequence& AlignedRead::sequence() noexcept
+AlignedRead::NucleotideSequence& AlignedRead::sequence()
 {
-    return sequence_;
+    return unique_data().sequence;
 }
 
 const AlignedRead::BaseQualityVector& AlignedRead::base_qualities() const noexcept
 {
-    return base_qualities_;
+    return data_->base_qualities;
 }
 
-AlignedRead::BaseQualityVector& AlignedRead::base_qualities() noexcept
+AlignedRead::BaseQualityVector& AlignedRead::base_qualities()
 {
-    return base_qualities_;
+    return unique_data().base_qualities;
 }
 
 AlignedRead::MappingQuality AlignedRead::mapping_quality() const noexcept
@@ -115,7 +116,7 @@ AlignedRead::Flags AlignedRead::flags() const noexcept
 
 void AlignedRead::realign(GenomicRegion new_region, CigarString new_cigar) noexcept
 {
-    assert(sequence_size(new_cigar) == sequence_.size());
+    assert(sequence_size(new_cigar) == data_->sequence.size());
     assert(reference_size(new_cigar) == size(new_region));
     region_ = std::move(new_region);
     cigar_ = std::move(new_cigar);
@@ -163,6 +164,16 @@ bool AlignedRead::is_marked_supplementary_alignment() const noexcept
 
 // private methods
 
+AlignedRead::Data& AlignedRead::unique_data()
+{
+    // Copy-on-write: the payload may be shared with other reads, so clone it
+    // before handing out mutable access
+    if (data_.use_count() > 1) {
+        data_ = std::make_shared<Data>(*data_);
+    }
+    return *data_;
+}
+
 AlignedRead::FlagBits AlignedRead::compress(const Flags& flags) const noexcept
 {
     FlagBits result {};
@@ -205,6 +216,34 @@ std::size_t ReadHash::operator()(const octopus::AlignedRead &read) const
 
 // Non-member methods
 
+std::size_t intern_duplicate_read_data(std::vector<AlignedRead>& reads)
+{
+    std::unordered_map<std::size_t, std::vector<std::shared_ptr<AlignedRead::Data>>> pool {};
+    pool.reserve(reads.size());
+    std::size_t result {0};
+    for (auto& read : reads) {
+        std::size_t payload_hash {};
+        using boost::hash_combine;
+        hash_combine(payload_hash, boost::hash_range(std::cbegin(read.sequence()), std::cend(read.sequence())));
+        hash_combine(payload_hash, boost::hash_range(std::cbegin(read.base_qualities()), std::cend(read.base_qualities())));
+        auto& bucket = pool[payload_hash];
+        const auto match_itr = std::find_if(std::cbegin(bucket), std::cend(bucket),
+                                            [&read] (const auto& data) {
+                                                return data->sequence == read.sequence()
+                                                    && data->base_qualities == read.base_qualities();
+                                            });
+        if (match_itr != std::cend(bucket)) {
+            if (*match_itr != read.data_) {
+                read.data_ = *match_itr;
+                ++result;
+            }
+        } else {
+            bucket.push_back(read.data_);
+        }
+    }
+    return result;
+}
+
 void capitalise_bases(AlignedRead& read) noexcept
 {
     utils::capitalise(read.sequence());
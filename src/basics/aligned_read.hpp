@@ -13,6 +13,7 @@
 #include <iterator>
 #include <utility>
 #include <functional>
+#include <memory>
 #include <iosfwd>
 
 #include <boost/optional.hpp>
@@ -105,9 +106,9 @@ public:
     const std::string& read_group() const noexcept;
     const GenomicRegion& mapped_region() const noexcept;
     const NucleotideSequence& sequence() const noexcept;
-    NucleotideSequence& sequence() noexcept;
+    NucleotideSequence& sequence();
     const BaseQualityVector& base_qualities() const noexcept;
-    BaseQualityVector& base_qualities() noexcept;
+    BaseQualityVector& base_qualities();
     MappingQuality mapping_quality() const noexcept;
     const CigarString& cigar() const noexcept;
     Direction direction() const noexcept;
@@ -129,20 +130,43 @@ public:
 private:
     static constexpr std::size_t numFlags_ = 10;
     using FlagBits = std::bitset<numFlags_>;
-    
-    // should be ordered by sizeof
+
+    // Reads are copied freely between containers and duplicate-sequence reads
+    // are common at high depth, so the sequence and base qualities live behind
+    // a shared buffer with copy-on-write semantics; equal payloads of distinct
+    // reads can be pooled with intern_duplicate_read_data
+    struct Data
+    {
+        Data() = default;
+        template <typename Seq_, typename Qualities_>
+        Data(Seq_&& sequence, Qualities_&& base_qualities)
+        : sequence {std::forward<Seq_>(sequence)}
+        , base_qualities {std::forward<Qualities_>(base_qualities)}
+        {}
+        NucleotideSequence sequence;
+        BaseQualityVector base_qualities;
+    };
+
+    // The members scanned by overlap, coverage, and filtering passes (region,
+    // flags, mapping quality) are laid out first so that those scans stay
+    // within the read's leading cache line; the payload members follow. The
+    // name string is only needed when reads are written back to BAM, so it
+    // lives behind a shared immutable block and read copies bump a reference
+    // count instead of copying the characters
     GenomicRegion region_;
-    std::string name_;
-    NucleotideSequence sequence_;
-    BaseQualityVector base_qualities_;
+    FlagBits flags_;
+    MappingQuality mapping_quality_;
+    std::shared_ptr<const std::string> name_ = std::make_shared<const std::string>();
+    std::shared_ptr<Data> data_ = std::make_shared<Data>();
     CigarString cigar_;
     std::string read_group_;
     boost::optional<Segment> next_segment_;
-    FlagBits flags_;
-    MappingQuality mapping_quality_;
-    
+
+    Data& unique_data();
     FlagBits compress(const Flags& flags) const noexcept;
     Flags decompress(const FlagBits& flags) const noexcept;
+
+    friend std::size_t intern_duplicate_read_data(std::vector<AlignedRead>& reads);
 };
 
 struct AlignedRead::Segment::Flags
@@ -170,14 +194,13 @@ template <typename String_, typename GenomicRegion_, typename Seq, typename Qual
 AlignedRead::AlignedRead(String_&& name, GenomicRegion_&& reference_region, Seq&& sequence, Qualities_&& qualities,
                          CigarString_&& cigar, MappingQuality mapping_quality, const Flags& flags, String2_&& read_group)
 : region_ {std::forward<GenomicRegion_>(reference_region)}
-, name_ {std::forward<String_>(name)}
-, sequence_ {std::forward<Seq>(sequence)}
-, base_qualities_ {std::forward<Qualities_>(qualities)}
+, flags_ {compress(flags)}
+, mapping_quality_ {mapping_quality}
+, name_ {std::make_shared<const std::string>(std::forward<String_>(name))}
+, data_ {std::make_shared<Data>(std::forward<Seq>(sequence), std::forward<Qualities_>(qualities))}
 , cigar_ {std::forward<CigarString_>(cigar)}
 , read_group_ {std::forward<String2_>(read_group)}
 , next_segment_ {}
-, flags_ {compress(flags)}
-, mapping_quality_ {mapping_quality}
 {}
 
 template <typename String1_, typename GenomicRegion_, typename Seq, typename Qualities_, typename CigarString_,
@@ -187,17 +210,16 @@ AlignedRead::AlignedRead(String1_&& name, GenomicRegion_&& reference_region, Seq
                          String3_&& next_segment_contig_name, MappingDomain::Position next_segment_begin,
                          MappingDomain::Size inferred_template_length, const Segment::Flags& next_segment_flags)
 : region_ {std::forward<GenomicRegion_>(reference_region)}
-, name_ {std::forward<String1_>(name)}
-, sequence_ {std::forward<Seq>(sequence)}
-, base_qualities_ {std::forward<Qualities_>(qualities)}
+, flags_ {compress(flags)}
+, mapping_quality_ {mapping_quality}
+, name_ {std::make_shared<const std::string>(std::forward<String1_>(name))}
+, data_ {std::make_shared<Data>(std::forward<Seq>(sequence), std::forward<Qualities_>(qualities))}
 , cigar_ {std::forward<CigarString_>(cigar)}
 , read_group_ {std::forward<String2_>(read_group)}
 , next_segment_ {
     Segment {std::forward<String3_>(next_segment_contig_name), next_segment_begin,
     inferred_template_length, next_segment_flags}
   }
-, flags_ {compress(flags)}
-, mapping_quality_ {mapping_quality}
 {}
 
 template <typename String_>
@@ -255,6 +277,10 @@ bool operator==(const AlignedRead::Segment& lhs, const AlignedRead::Segment& rhs
 std::ostream& operator<<(std::ostream& os, const AlignedRead::BaseQualityVector& qualities);
 std::ostream& operator<<(std::ostream& os, const AlignedRead& read);
 
+// Rebinds reads holding identical (sequence, base qualities) payloads onto one
+// shared buffer, returning the number of payloads released
+std::size_t intern_duplicate_read_data(std::vector<AlignedRead>& reads);
+
 struct ReadHash
 {
     std::size_t operator()(const AlignedRead& read) const;
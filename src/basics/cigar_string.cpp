@@ -15,31 +15,6 @@
 
 namespace octopus {
 
-CigarOperation::CigarOperation(const Size size, const Flag flag) noexcept
-: size_ {size}
-, flag_ {flag}
-{}
-
-void CigarOperation::set_flag(Flag type) noexcept
-{
-    flag_ = type;
-}
-
-void CigarOperation::set_size(Size size) noexcept
-{
-    size_ = size;
-}
-
-CigarOperation::Flag CigarOperation::flag() const noexcept
-{
-    return flag_;
-}
-
-CigarOperation::Size CigarOperation::size() const noexcept
-{
-    return size_;
-}
-
 // non-member methods
 
 bool is_valid(const CigarOperation::Flag flag) noexcept
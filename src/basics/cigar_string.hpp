@@ -13,6 +13,7 @@
 #include <functional>
 #include <limits>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/functional/hash.hpp>
 
 #include "concepts/comparable.hpp"
@@ -36,27 +37,63 @@ public:
     };
     
     using Size = std::uint_fast32_t;
-    
+
     CigarOperation() = default;
-    
-    explicit CigarOperation(Size size, Flag type) noexcept;
-    
+
+    explicit CigarOperation(const Size size, const Flag type) noexcept
+    : rep_ {(static_cast<std::uint32_t>(size) << sizeShift) | compress(type)}
+    {}
+
     CigarOperation(const CigarOperation&)            = default;
     CigarOperation& operator=(const CigarOperation&) = default;
     CigarOperation(CigarOperation&&)                 = default;
     CigarOperation& operator=(CigarOperation&&)      = default;
-    
+
     ~CigarOperation() = default;
-    
-    void set_flag(Flag type) noexcept;
-    void set_size(Size size) noexcept;
-    
-    Flag flag() const noexcept;
-    Size size() const noexcept;
-    
+
+    void set_flag(const Flag type) noexcept
+    {
+        rep_ = (rep_ & ~flagMask) | compress(type);
+    }
+
+    void set_size(const Size size) noexcept
+    {
+        rep_ = (rep_ & flagMask) | (static_cast<std::uint32_t>(size) << sizeShift);
+    }
+
+    Flag flag() const noexcept { return decompress(rep_ & flagMask); }
+    Size size() const noexcept { return rep_ >> sizeShift; }
+
 private:
-    Size size_;
-    Flag flag_;
+    static constexpr std::uint32_t sizeShift {4};
+    static constexpr std::uint32_t flagMask {0xf};
+
+    static std::uint32_t compress(const Flag flag) noexcept
+    {
+        switch (flag) {
+            case Flag::alignmentMatch: return 0;
+            case Flag::insertion:      return 1;
+            case Flag::deletion:       return 2;
+            case Flag::skipped:        return 3;
+            case Flag::softClipped:    return 4;
+            case Flag::hardClipped:    return 5;
+            case Flag::padding:        return 6;
+            case Flag::sequenceMatch:  return 7;
+            case Flag::substitution:   return 8;
+            default:                   return 15;
+        }
+    }
+
+    static Flag decompress(const std::uint32_t code) noexcept
+    {
+        constexpr static char opChars[] {'M', 'I', 'D', 'N', 'S', 'H', 'P', '=', 'X',
+                                         '?', '?', '?', '?', '?', '?', '?'};
+        return static_cast<Flag>(opChars[code]);
+    }
+
+    // Packed as in the BAM spec: operation length in the high 28 bits and the
+    // operation code in the low 4, so an operation is one shift or mask away
+    std::uint32_t rep_;
 };
 
 void increment_size(CigarOperation& op, CigarOperation::Size n = 1) noexcept;
@@ -80,7 +117,9 @@ bool is_clipping(const CigarOperation& op) noexcept;
 
 // CigarString
 
-using CigarString = std::vector<CigarOperation>;
+// Nearly all CIGARs have just a few operations, so they are stored inline and
+// only long alignments fall back to the heap
+using CigarString = boost::container::small_vector<CigarOperation, 8>;
 
 CigarString parse_cigar(const std::string& cigar);
 
@@ -8,6 +8,10 @@
 #include <functional>
 #include <stdexcept>
 #include <ostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 #include <cassert>
 
 #include <boost/optional.hpp>
@@ -34,7 +38,7 @@ public:
     using Size       = ContigRegion::Size;
     using Distance   = ContigRegion::Distance;
     
-    GenomicRegion() = default;  // for use with containers
+    GenomicRegion();  // for use with containers
     
     template <typename T>
     explicit GenomicRegion(T&& contig_name, Position begin, Position end);
@@ -56,8 +60,12 @@ public:
     Position end() const noexcept;
 
 private:
-    ContigName contig_name_;
+    using ContigNamePtr = std::shared_ptr<const ContigName>;
+    
+    ContigNamePtr contig_name_;
     ContigRegion contig_region_;
+    
+    friend bool is_same_contig(const GenomicRegion& lhs, const GenomicRegion& rhs) noexcept;
 };
 
 class BadRegionCompare : public std::logic_error
@@ -85,23 +93,54 @@ private:
     mutable std::string msg_;
 };
 
+namespace detail {
+
+// Process-wide pool of unique contig names. Every region holds a shared
+// reference into the pool, so contig identity is a pointer comparison and
+// region copies never touch the heap. The pool only ever sees a handful of
+// names (one per reference contig), and the same contig is requested
+// repeatedly while a task is processed, so a single-entry thread-local cache
+// absorbs almost all lookups
+inline std::shared_ptr<const GenomicRegion::ContigName> intern_contig_name(GenomicRegion::ContigName name)
+{
+    thread_local std::shared_ptr<const GenomicRegion::ContigName> cached {};
+    if (cached && *cached == name) return cached;
+    static std::unordered_map<GenomicRegion::ContigName, std::shared_ptr<const GenomicRegion::ContigName>> pool {};
+    static std::mutex pool_mutex {};
+    std::lock_guard<std::mutex> lock {pool_mutex};
+    auto itr = pool.find(name);
+    if (itr == std::cend(pool)) {
+        auto name_ptr = std::make_shared<const GenomicRegion::ContigName>(std::move(name));
+        itr = pool.emplace(*name_ptr, std::move(name_ptr)).first;
+    }
+    cached = itr->second;
+    return cached;
+}
+
+} // namespace detail
+
 // public member methods
 
+inline GenomicRegion::GenomicRegion()
+: contig_name_ {detail::intern_contig_name(ContigName {})}
+, contig_region_ {}
+{}
+
 template <typename T>
 GenomicRegion::GenomicRegion(T&& contig_name, const Position begin, const Position end)
-: contig_name_ {std::forward<T>(contig_name)}
+: contig_name_ {detail::intern_contig_name(std::forward<T>(contig_name))}
 , contig_region_ {begin, end}
 {}
 
 template <typename T, typename R>
 GenomicRegion::GenomicRegion(T&& contig_name, R&& contig_region)
-: contig_name_ {std::forward<T>(contig_name)}
+: contig_name_ {detail::intern_contig_name(std::forward<T>(contig_name))}
 , contig_region_ {std::forward<R>(contig_region)}
 {}
 
 inline const GenomicRegion::ContigName& GenomicRegion::contig_name() const noexcept
 {
-    return contig_name_;
+    return *contig_name_;
 }
 
 inline const ContigRegion& GenomicRegion::contig_region() const noexcept
@@ -159,7 +198,8 @@ inline bool is_position(const GenomicRegion& region) noexcept
 
 inline bool is_same_contig(const GenomicRegion& lhs, const GenomicRegion& rhs) noexcept
 {
-    return lhs.contig_name() == rhs.contig_name();
+    // Interning makes pointer equality equivalent to name equality
+    return lhs.contig_name_ == rhs.contig_name_;
 }
 
 inline bool begins_equal(const GenomicRegion& lhs, const GenomicRegion& rhs)
@@ -6,6 +6,7 @@
 
 #include <type_traits>
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
 #include <stdexcept>
 #include <string>
@@ -61,6 +62,13 @@ public:
         return score_;
     }
     
+    // The score in fixed-point milli-phreds. Emission code rounds and clamps
+    // many scores, and fixed point makes those pure integer operations
+    std::int64_t milli_score() const noexcept
+    {
+        return static_cast<std::int64_t>(static_cast<double>(score_) * 1000 + 0.5);
+    }
+    
     Probability probability_true() const noexcept
     {
         static constexpr Q one {1};
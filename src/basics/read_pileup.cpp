@@ -3,6 +3,7 @@
 
 #include "read_pileup.hpp"
 
+#include <cassert>
 #include <iterator>
 #include <numeric>
 
@@ -37,6 +38,18 @@ void ReadPileup::add(const AlignedRead& read)
     summaries_[copy_sequence(read, region)].push_back({copy_base_qualities(read, region), read.mapping_quality()});
 }
 
+void ReadPileup::add(const AlignedRead& read, const std::size_t first_base_index, const std::size_t last_base_index)
+{
+    assert(first_base_index <= last_base_index && last_base_index <= sequence_size(read));
+    const auto& sequence = read.sequence();
+    const auto& base_qualities = read.base_qualities();
+    NucleotideSequence subsequence {std::next(std::cbegin(sequence), first_base_index),
+                                    std::next(std::cbegin(sequence), last_base_index)};
+    std::vector<BaseQuality> subqualities {std::next(std::cbegin(base_qualities), first_base_index),
+                                           std::next(std::cbegin(base_qualities), last_base_index)};
+    summaries_[std::move(subsequence)].push_back({std::move(subqualities), read.mapping_quality()});
+}
+
 const ReadPileup::ReadSummaries& ReadPileup::summaries(const NucleotideSequence& sequence) const
 {
     const auto itr = summaries_.find(sequence);
@@ -63,6 +76,39 @@ auto overlap_range(std::vector<ReadPileup>& pileups, const AlignedRead& read)
     return overlap_range(std::begin(pileups), std::end(pileups), contig_region(read), BidirectionallySortedTag {});
 }
 
+// For each reference position covered by a read, the half-open range of read
+// sequence indices aligned to that position. Inserted and soft clipped bases
+// attach to the next aligned reference position, and deleted positions after
+// the first in a run get empty ranges, matching AlignedRead copy semantics.
+// Built with a single cigar walk so pileup construction need not re-walk the
+// cigar for every position the read overlaps.
+using ExpandedAlignment = std::vector<std::pair<std::size_t, std::size_t>>;
+
+ExpandedAlignment expand_alignment(const AlignedRead& read)
+{
+    ExpandedAlignment result {};
+    result.reserve(region_size(read));
+    std::size_t sequence_position {0}, pending_begin {0};
+    for (const CigarOperation& op : read.cigar()) {
+        if (advances_reference(op)) {
+            if (advances_sequence(op)) {
+                for (CigarOperation::Size n {0}; n < op.size(); ++n) {
+                    result.emplace_back(pending_begin, ++sequence_position);
+                    pending_begin = sequence_position;
+                }
+            } else {
+                for (CigarOperation::Size n {0}; n < op.size(); ++n) {
+                    result.emplace_back(pending_begin, sequence_position);
+                    pending_begin = sequence_position;
+                }
+            }
+        } else if (advances_sequence(op)) {
+            sequence_position += op.size();
+        }
+    }
+    return result;
+}
+
 } // namespace
 
 ReadPileups make_pileups(const ReadContainer& reads, const GenomicRegion& region)
@@ -73,8 +119,12 @@ ReadPileups make_pileups(const ReadContainer& reads, const GenomicRegion& region
         result.emplace_back(position);
     }
     for (const AlignedRead& read : overlap_range(reads, region)) {
+        const auto alignment = expand_alignment(read);
+        const auto read_begin = mapped_begin(read);
         for (ReadPileup& pileup : overlap_range(result, read)) {
-            pileup.add(read);
+            const auto offset = mapped_begin(pileup) - read_begin;
+            assert(offset < alignment.size());
+            pileup.add(read, alignment[offset].first, alignment[offset].second);
         }
     }
     return result;
@@ -46,7 +46,10 @@ public:
     unsigned depth(const NucleotideSequence& sequence) const noexcept;
     
     void add(const AlignedRead& read);
-    
+    // Adds the given slice of the read's sequence and base qualities, avoiding
+    // a cigar string walk when the aligned slice is already known
+    void add(const AlignedRead& read, std::size_t first_base_index, std::size_t last_base_index);
+
     const ReadSummaries& summaries(const NucleotideSequence& sequence) const;
     
     unsigned sum_base_qualities(const NucleotideSequence& sequence) const;
@@ -16,6 +16,7 @@
 #include "containers/mappable_flat_set.hpp"
 #include "containers/mappable_flat_multi_set.hpp"
 #include "containers/mappable_map.hpp"
+#include "containers/huge_page_allocator.hpp"
 #include "logging/logging.hpp"
 
 namespace octopus {
@@ -29,8 +30,10 @@ using ContigName = GenomicRegion::ContigName;
 
 using InputRegionMap = MappableSetMap<ContigName, GenomicRegion>;
 
-using ReadContainer = MappableFlatMultiSet<AlignedRead>;
-using ReadMap       = MappableMap<SampleName, AlignedRead>;
+// Read buffers are the biggest long-lived allocations, so back them with
+// transparent huge pages where the kernel supports it
+using ReadContainer = MappableFlatMultiSet<AlignedRead, HugePageAllocator<AlignedRead>>;
+using ReadMap       = MappableMap<SampleName, AlignedRead, ReadContainer>;
 
 enum class ExecutionPolicy { seq, par, par_vec }; // To match Parallelism TS
 
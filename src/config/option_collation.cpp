@@ -25,6 +25,7 @@
 #include "utils/mappable_algorithms.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/repeat_finder.hpp"
+#include "utils/reference_repeat_index.hpp"
 #include "utils/append.hpp"
 #include "utils/maths.hpp"
 #include "basics/phred.hpp"
@@ -37,7 +38,9 @@
 #include "core/models/haplotype_likelihood_model.hpp"
 #include "core/models/error/error_model_factory.hpp"
 #include "core/callers/caller_builder.hpp"
+#include "core/tools/replay_bundle.hpp"
 #include "logging/logging.hpp"
+#include "io/read/htslib_sam_facade.hpp"
 #include "io/region/region_parser.hpp"
 #include "io/pedigree/pedigree_reader.hpp"
 #include "io/variant/vcf_reader.hpp"
@@ -68,9 +71,15 @@ unsigned as_unsigned(const std::string& option, const OptionMap& options)
 
 bool is_run_command(const OptionMap& options)
 {
-    return !is_set("help", options) && !is_set("version", options);
+    return !is_set("help", options) && !is_set("version", options) && !is_set("batch", options);
 }
 
+bool is_batch_run(const OptionMap& options)
+{
+    return is_set("batch", options);
+}
+
+
 bool is_debug_mode(const OptionMap& options)
 {
     return is_set("debug", options);
@@ -134,6 +143,11 @@ fs::path resolve_path(const fs::path& path, const OptionMap& options)
     return ::octopus::resolve_path(path, get_working_directory(options));
 }
 
+fs::path get_batch_script_path(const OptionMap& options)
+{
+    return resolve_path(options.at("batch").as<fs::path>(), options);
+}
+
 struct Line
 {
     std::string line_data;
@@ -274,6 +288,15 @@ boost::optional<fs::path> get_trace_log_file_name(const OptionMap& options)
     }
 }
 
+boost::optional<fs::path> get_progress_telemetry_file(const OptionMap& options)
+{
+    if (is_set("progress-telemetry", options)) {
+        return resolve_path(options.at("progress-telemetry").as<fs::path>(), options);
+    } else {
+        return boost::none;
+    }
+}
+
 bool is_fast_mode(const OptionMap& options)
 {
     return options.at("fast").as<bool>() || options.at("very-fast").as<bool>();
@@ -284,10 +307,15 @@ bool is_very_fast_mode(const OptionMap& options)
     return options.at("very-fast").as<bool>();
 }
 
-ReferenceGenome make_reference(const OptionMap& options)
+fs::path get_reference_path(const OptionMap& options)
 {
     const fs::path input_path {options.at("reference").as<std::string>()};
-    auto resolved_path = resolve_path(input_path, options);
+    return resolve_path(input_path, options);
+}
+
+ReferenceGenome make_reference(const OptionMap& options)
+{
+    auto resolved_path = get_reference_path(options);
     auto ref_cache_size = options.at("max-reference-cache-footprint").as<MemoryFootprint>();
     static constexpr MemoryFootprint min_non_zero_reference_cache_size {1'000}; // 1Kb
     if (ref_cache_size.num_bytes() > 0 && ref_cache_size < min_non_zero_reference_cache_size) {
@@ -311,7 +339,13 @@ ReferenceGenome make_reference(const OptionMap& options)
         }
     }
     try {
-        return octopus::make_reference(std::move(resolved_path), ref_cache_size, is_threading_allowed(options));
+        auto result = octopus::make_reference(resolved_path, ref_cache_size, is_threading_allowed(options));
+        if (options.at("index-reference-repeats").as<bool>() && !result.repeat_index()) {
+            const auto repeat_index_path = reference_repeat_index_path(resolved_path);
+            build_reference_repeat_index(result, repeat_index_path);
+            result.attach_repeat_index(std::make_shared<ReferenceRepeatIndex>(repeat_index_path));
+        }
+        return result;
     } catch (MissingFileError& e) {
         e.set_location_specified("the command line option --reference");
         throw;
@@ -581,6 +615,33 @@ InputRegionMap get_search_regions(const OptionMap& options, const ReferenceGenom
     return result;
 }
 
+std::string get_search_region_signature(const OptionMap& options)
+{
+    std::ostringstream ss {};
+    const auto append_region_values = [&] (const std::string& label) {
+        ss << label << '=';
+        if (is_set(label, options)) {
+            for (const auto& value : options.at(label).as<std::vector<std::string>>()) {
+                ss << value << ';';
+            }
+        }
+        ss << '|';
+    };
+    const auto append_region_file = [&] (const std::string& label) {
+        ss << label << '=';
+        if (is_set(label, options)) {
+            ss << resolve_path(options.at(label).as<fs::path>(), options).string();
+        }
+        ss << '|';
+    };
+    append_region_values("regions");
+    append_region_file("regions-file");
+    append_region_values("skip-regions");
+    append_region_file("skip-regions-file");
+    ss << "one-based-indexing=" << options.at("one-based-indexing").as<bool>();
+    return ss.str();
+}
+
 ContigOutputOrder get_contig_output_order(const OptionMap& options)
 {
     return options.at("contig-output-order").as<ContigOutputOrder>();
@@ -683,6 +744,15 @@ ReadManager make_read_manager(const OptionMap& options)
 {
     auto read_paths = get_read_paths(options);
     const auto max_open_files = as_unsigned("max-open-read-files", options);
+    // Point htslib's shared CRAM reference cache at the calling reference so
+    // CRAM readers decode local slices rather than consulting REF_PATH
+    io::HtslibSamFacade::set_cram_reference(resolve_path(options.at("reference").as<std::string>(), options));
+    if (is_threading_allowed(options)) {
+        constexpr unsigned maxDecodeThreads {4};
+        const auto num_threads = get_num_threads(options);
+        io::HtslibSamFacade::set_decode_thread_pool(std::min(num_threads ? *num_threads : std::thread::hardware_concurrency(),
+                                                             maxDecodeThreads));
+    }
     return ReadManager {std::move(read_paths), max_open_files};
 }
 
@@ -691,12 +761,35 @@ bool allow_assembler_generation(const OptionMap& options)
     return options.at("assembly-candidate-generator").as<bool>() && !is_fast_mode(options);
 }
 
-auto make_read_transformers(const OptionMap& options)
+boost::optional<readpipe::BinBaseQualities>
+make_base_quality_binner(const OptionMap& options, const boost::optional<ReadSetProfile>& read_profile)
+{
+    if (!options.at("bin-base-qualities").as<bool>() || !read_profile) return boost::none;
+    // The read pipe transforms every sample's reads uniformly, so the per
+    // sample palettes are merged; a sample without a small quality alphabet
+    // makes the whole input unbinnable
+    std::vector<AlignedRead::BaseQuality> palette {};
+    for (const auto& sample_palette : read_profile->sample_base_quality_palette) {
+        if (sample_palette.empty()) return boost::none;
+        utils::append(sample_palette, palette);
+    }
+    std::sort(std::begin(palette), std::end(palette));
+    palette.erase(std::unique(std::begin(palette), std::end(palette)), std::end(palette));
+    if (palette.empty() || palette.size() > ReadSetProfileConfig {}.max_base_quality_palette_size) return boost::none;
+    return readpipe::BinBaseQualities {std::move(palette)};
+}
+
+auto make_read_transformers(const OptionMap& options, const boost::optional<ReadSetProfile>& read_profile)
 {
     using namespace octopus::readpipe;
     ReadTransformer prefilter_transformer {}, postfilter_transformer {};
     prefilter_transformer.add(CapitaliseBases {});
     prefilter_transformer.add(CapBaseQualities {125});
+    auto base_quality_binner = make_base_quality_binner(options, read_profile);
+    if (base_quality_binner) {
+        // Before the masking transforms, so masked zeros stay zero
+        prefilter_transformer.add(std::move(*base_quality_binner));
+    }
     if (options.at("read-transforms").as<bool>()) {
         if (is_set("mask-low-quality-tails", options)) {
             const auto threshold = static_cast<AlignedRead::BaseQuality>(as_unsigned("mask-low-quality-tails", options));
@@ -753,7 +846,8 @@ auto make_read_filterer(const OptionMap& options)
     using ReadFilterer = ReadPipe::ReadFilterer;
     
     ReadFilterer result {};
-    
+    result.set_execution_policy(get_thread_execution_policy(options));
+
     // these filters are mandatory
     result.add(make_unique<HasValidBaseQualities>());
     result.add(make_unique<HasWellFormedCigar>());
@@ -830,9 +924,10 @@ boost::optional<readpipe::Downsampler> make_downsampler(const OptionMap& options
     return boost::none;
 }
 
-ReadPipe make_read_pipe(ReadManager& read_manager, std::vector<SampleName> samples, const OptionMap& options)
+ReadPipe make_read_pipe(ReadManager& read_manager, std::vector<SampleName> samples, const OptionMap& options,
+                        const boost::optional<ReadSetProfile>& read_profile)
 {
-    auto transformers = make_read_transformers(options);
+    auto transformers = make_read_transformers(options, read_profile);
     if (transformers.second.num_transforms() > 0) {
         return ReadPipe {read_manager, std::move(transformers.first), make_read_filterer(options),
                          std::move(transformers.second), make_downsampler(options), std::move(samples)};
@@ -1054,6 +1149,12 @@ auto make_variant_generator_builder(const OptionMap& options)
                 vcf_options.min_quality = options.at("min-source-quality").as<Phred<double>>().score();
             }
             vcf_options.extract_filtered = options.at("extract-filtered-source-candidates").as<bool>();
+            if (options.at("cache-source-candidates").as<bool>()) {
+                const auto cache_path = coretools::candidate_variant_cache_path(source_path);
+                if (!fs::exists(cache_path) || fs::last_write_time(cache_path) < fs::last_write_time(source_path)) {
+                    coretools::build_candidate_variant_cache(VcfReader {source_path}, cache_path);
+                }
+            }
             result.add_vcf_extractor(std::move(source_path), vcf_options);
         }
     }
@@ -1607,7 +1708,8 @@ auto get_normal_contamination_risk(const OptionMap& options)
 
 CallerFactory make_caller_factory(const ReferenceGenome& reference, ReadPipe& read_pipe,
                                   const InputRegionMap& regions, const OptionMap& options,
-                                  const boost::optional<ReadSetProfile> read_profile)
+                                  const boost::optional<ReadSetProfile> read_profile,
+                                  boost::optional<fs::path> temp_directory)
 {
     CallerBuilder vc_builder {reference, read_pipe,
                               make_variant_generator_builder(options),
@@ -1648,6 +1750,35 @@ CallerFactory make_caller_factory(const ReferenceGenome& reference, ReadPipe& re
     }
     vc_builder.set_ploidies(get_ploidy_map(options));
     vc_builder.set_max_haplotypes(get_max_haplotypes(options));
+    if (is_threading_allowed(options)) {
+        vc_builder.set_max_evaluation_threads(get_num_threads(options));
+        if (const auto evaluation_workers = vc_builder.evaluation_workers()) {
+            read_pipe.enable_parallel_sorting(*evaluation_workers);
+        }
+    }
+    if (is_set("save-likelihood-checkpoint", options)) {
+        using Checkpoint = HaplotypeLikelihoodCheckpoint;
+        const auto checkpoint_path = resolve_path(options.at("save-likelihood-checkpoint").as<fs::path>(), options);
+        vc_builder.set_likelihood_checkpoint(std::make_shared<Checkpoint>(checkpoint_path, Checkpoint::Mode::record));
+    } else if (is_set("load-likelihood-checkpoint", options)) {
+        using Checkpoint = HaplotypeLikelihoodCheckpoint;
+        const auto checkpoint_path = resolve_path(options.at("load-likelihood-checkpoint").as<fs::path>(), options);
+        vc_builder.set_likelihood_checkpoint(std::make_shared<Checkpoint>(checkpoint_path, Checkpoint::Mode::replay));
+    }
+    if (is_set("capture-slow-regions", options)) {
+        const auto bundle_directory = resolve_path("octopus_replay_bundles", options);
+        vc_builder.set_replay_bundle_writer(std::make_shared<ReplayBundleWriter>(bundle_directory,
+                                                                                 options.at("capture-slow-regions").as<double>()));
+    }
+    if (is_likelihood_cache_spilling_requested(options)) {
+        if (temp_directory) {
+            vc_builder.set_likelihood_cache_memory_budget(options.at("max-likelihood-cache-footprint").as<MemoryFootprint>(),
+                                                          std::move(*temp_directory));
+        } else {
+            logging::WarningLogger log {};
+            log << "Ignoring request to limit likelihood cache memory as no temporary directory is available";
+        }
+    }
     vc_builder.set_haplotype_extension_threshold(options.at("haplotype-extension-threshold").as<Phred<double>>());
     vc_builder.set_reference_haplotype_protection(options.at("protect-reference-haplotype").as<bool>());
     auto min_phase_score = options.at("min-phase-score").as<Phred<double>>();
@@ -1657,6 +1788,7 @@ CallerFactory make_caller_factory(const ReferenceGenome& reference, ReadPipe& re
         vc_builder.set_indel_heterozygosity(options.at("indel-heterozygosity").as<float>());
     }
     vc_builder.set_model_based_haplotype_dedup(options.at("dedup-haplotypes-with-prior-model").as<bool>());
+    vc_builder.set_near_duplicate_haplotype_collapse(options.at("collapse-near-duplicate-haplotypes").as<bool>());
     vc_builder.set_independent_genotype_prior_flag(options.at("use-independent-genotype-priors").as<bool>());
     if (caller == "cancer") {
         if (is_set("normal-sample", options)) {
@@ -1682,6 +1814,8 @@ CallerFactory make_caller_factory(const ReferenceGenome& reference, ReadPipe& re
         vc_builder.set_min_denovo_posterior(options.at("min-denovo-posterior").as<Phred<double>>());
     } else if (caller == "polyclone") {
         vc_builder.set_max_clones(as_unsigned("max-clones", options));
+    } else if (caller == "population" && pedigree) {
+        vc_builder.set_pedigree(*pedigree);
     }
     vc_builder.set_model_filtering(allow_model_filtering(options));
     vc_builder.set_max_genotypes(as_unsigned("max-genotypes", options));
@@ -1697,6 +1831,31 @@ CallerFactory make_caller_factory(const ReferenceGenome& reference, ReadPipe& re
     return CallerFactory {std::move(vc_builder)};
 }
 
+bool is_likelihood_cache_spilling_requested(const OptionMap& options) noexcept
+{
+    return is_set("max-likelihood-cache-footprint", options);
+}
+
+bool is_resume_run(const OptionMap& options) noexcept
+{
+    return options.at("resume").as<bool>();
+}
+
+bool is_numa_aware_mode_requested(const OptionMap& options) noexcept
+{
+    return options.at("numa-aware").as<bool>();
+}
+
+unsigned get_num_distributed_jobs(const OptionMap& options) noexcept
+{
+    return static_cast<unsigned>(options.at("distributed-jobs").as<int>());
+}
+
+unsigned get_distributed_job_id(const OptionMap& options) noexcept
+{
+    return static_cast<unsigned>(options.at("distributed-job-id").as<int>());
+}
+
 bool is_call_filtering_requested(const OptionMap& options) noexcept
 {
     return options.at("call-filtering").as<bool>();
@@ -1890,6 +2049,16 @@ boost::optional<fs::path> create_temp_file_directory(const OptionMap& options)
     
     logging::WarningLogger log {};
     
+    if (is_resume_run(options) || get_num_distributed_jobs(options) > 1) {
+        if (fs::exists(result)) {
+            return result;
+        }
+        if (is_resume_run(options)) {
+            log << "Resume was requested but no previous temporary directory was found"
+            " - starting a fresh run";
+        }
+    }
+    
     while (fs::exists(result) && temp_dir_counter <= temp_dir_name_count_limit) {
         if (fs::is_empty(result)) {
             stream(log) << "Found empty temporary directory " << result
@@ -1907,6 +2076,10 @@ boost::optional<fs::path> create_temp_file_directory(const OptionMap& options)
     }
     
     if (!fs::create_directory(result)) {
+        if (get_num_distributed_jobs(options) > 1 && fs::exists(result)) {
+            // Another distributed job won the race to create the shared directory
+            return result;
+        }
         stream(log) << "Failed to create temporary directory " << result << " - check permissions";
         return boost::none;
     }
@@ -29,11 +29,16 @@ namespace octopus { namespace options {
 
 bool is_run_command(const OptionMap& options);
 
+bool is_batch_run(const OptionMap& options);
+
+fs::path get_batch_script_path(const OptionMap& options);
+
 bool is_debug_mode(const OptionMap& options);
 bool is_trace_mode(const OptionMap& options);
 
 boost::optional<fs::path> get_debug_log_file_name(const OptionMap& options);
 boost::optional<fs::path> get_trace_log_file_name(const OptionMap& options);
+boost::optional<fs::path> get_progress_telemetry_file(const OptionMap& options);
 
 boost::optional<unsigned> get_num_threads(const OptionMap& options);
 
@@ -41,8 +46,14 @@ MemoryFootprint get_target_read_buffer_size(const OptionMap& options);
 
 ReferenceGenome make_reference(const OptionMap& options);
 
+fs::path get_reference_path(const OptionMap& options);
+
 InputRegionMap get_search_regions(const OptionMap& options, const ReferenceGenome& reference);
 
+// A stable description of the option values that determine get_search_regions
+// output, letting batch runs reuse resolved regions between jobs that share them
+std::string get_search_region_signature(const OptionMap& options);
+
 ContigOutputOrder get_contig_output_order(const OptionMap& options);
 
 bool ignore_unmapped_contigs(const OptionMap& options);
@@ -51,7 +62,8 @@ boost::optional<std::vector<SampleName>> get_user_samples(const OptionMap& optio
 
 ReadManager make_read_manager(const OptionMap& options);
 
-ReadPipe make_read_pipe(ReadManager& read_manager, std::vector<SampleName> samples, const OptionMap& options);
+ReadPipe make_read_pipe(ReadManager& read_manager, std::vector<SampleName> samples, const OptionMap& options,
+                        const boost::optional<ReadSetProfile>& read_profile = boost::none);
 
 bool call_sites_only(const OptionMap& options);
 
@@ -61,7 +73,18 @@ boost::optional<Pedigree> get_pedigree(const OptionMap& options, const std::vect
 
 CallerFactory make_caller_factory(const ReferenceGenome& reference, ReadPipe& read_pipe,
                                   const InputRegionMap& regions, const OptionMap& options,
-                                  boost::optional<ReadSetProfile> input_reads_profile = boost::none);
+                                  boost::optional<ReadSetProfile> input_reads_profile = boost::none,
+                                  boost::optional<fs::path> temp_directory = boost::none);
+
+bool is_likelihood_cache_spilling_requested(const OptionMap& options) noexcept;
+
+bool is_resume_run(const OptionMap& options) noexcept;
+
+bool is_numa_aware_mode_requested(const OptionMap& options) noexcept;
+
+unsigned get_num_distributed_jobs(const OptionMap& options) noexcept;
+
+unsigned get_distributed_job_id(const OptionMap& options) noexcept;
 
 bool is_call_filtering_requested(const OptionMap& options) noexcept;
 
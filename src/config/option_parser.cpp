@@ -53,6 +53,16 @@ OptionMap parse_options(const int argc, const char** argv)
     ("config",
      po::value<fs::path>(),
      "A config file, used to populate command line options")
+
+    ("replay",
+     po::value<fs::path>(),
+     "A replay bundle directory written by --capture-slow-regions, used to"
+     " populate the reference, read, and region options from the bundle")
+    
+    ("batch",
+     po::value<fs::path>(),
+     "A file of octopus command lines, one job per line, run in turn by this"
+     " process so that later jobs start with warm calling components")
     
     ("debug",
      po::value<fs::path>()->implicit_value("octopus_debug.log"),
@@ -61,6 +71,11 @@ OptionMap parse_options(const int argc, const char** argv)
     ("trace",
      po::value<fs::path>()->implicit_value("octopus_trace.log"),
      "Writes very verbose debug information to trace.log in the working directory")
+
+    ("progress-telemetry",
+     po::value<fs::path>(),
+     "Writes machine readable (JSON lines) throughput telemetry to the given"
+     " file as regions complete")
     
     ("fast",
      po::bool_switch()->default_value(false),
@@ -87,13 +102,44 @@ OptionMap parse_options(const int argc, const char** argv)
      po::value<MemoryFootprint>()->default_value(*parse_footprint("500MB"), "500MB"),
      "Maximum memory footprint for cached reference sequence")
     
+    ("index-reference-repeats",
+     po::value<bool>()->default_value(false),
+     "Build a tandem repeat index beside the reference, reused by subsequent runs"
+     " against the same reference instead of re-scanning for repeats")
+
     ("target-read-buffer-footprint,B",
      po::value<MemoryFootprint>()->default_value(*parse_footprint("6GB"), "6GB"),
      "None binding request to limit the memory footprint of buffered read data")
-    
+
+    ("max-likelihood-cache-footprint",
+     po::value<MemoryFootprint>(),
+     "Maximum memory footprint of haplotype likelihood caches before their"
+     " likelihoods are stored in memory mapped temporary files")
+
     ("max-open-read-files",
      po::value<int>()->default_value(250),
      "Limits the number of read files that can be open simultaneously")
+    
+    ("resume",
+     po::bool_switch()->default_value(false),
+     "Resume an interrupted multithreaded run from the checkpoint left in the"
+     " working directory's temporary directory, skipping completed regions")
+
+    ("numa-aware",
+     po::bool_switch()->default_value(false),
+     "Pin each contig's calling tasks to a single NUMA node so their read"
+     " buffers and caches stay in node local memory (Linux only)")
+
+    ("distributed-jobs",
+     po::value<int>()->default_value(1),
+     "Number of cooperating octopus processes sharing this run's working"
+     " directory (which must be on a shared filesystem); contigs are"
+     " partitioned between them and the last process to finish merges the"
+     " final output")
+
+    ("distributed-job-id",
+     po::value<int>()->default_value(0),
+     "Zero-based id of this process amongst the --distributed-jobs processes")
     ;
     
     po::options_description input("I/O");
@@ -150,7 +196,25 @@ OptionMap parse_options(const int argc, const char** argv)
     ("pedigree",
      po::value<fs::path>(),
      "PED file containing sample pedigree")
-    
+
+    ("save-likelihood-checkpoint",
+     po::value<fs::path>(),
+     "Save haplotype likelihoods per active region to the given file,"
+     " for replaying with --load-likelihood-checkpoint when re-calling"
+     " with different downstream parameters")
+
+    ("load-likelihood-checkpoint",
+     po::value<fs::path>(),
+     "Replay haplotype likelihoods from a file written with"
+     " --save-likelihood-checkpoint rather than recomputing them, whenever"
+     " the haplotypes and reads match the recorded ones")
+
+    ("capture-slow-regions",
+     po::value<double>(),
+     "Write a self-contained replay bundle (post-pipe reads, candidate"
+     " variants, reference slice) for any region whose calling wall time"
+     " exceeds the given number of seconds, for replaying with --replay")
+
     ("output,o",
      po::value<fs::path>(),
      "File to where output is written. If unspecified, calls are written to stdout")
@@ -187,6 +251,11 @@ OptionMap parse_options(const int argc, const char** argv)
      po::value<bool>()->default_value(true),
      "Enable all read transformations")
     
+    ("bin-base-qualities",
+     po::value<bool>()->default_value(false),
+     "Bin base qualities onto the dominant quality values detected in the input reads,"
+     " concentrating the pair HMM penalties onto a small palette")
+    
     ("mask-low-quality-tails",
      po::value<int>()->implicit_value(3),
      "Masks read tail bases with base quality less than this")
@@ -320,6 +389,11 @@ OptionMap parse_options(const int argc, const char** argv)
     ("extract-filtered-source-candidates",
      po::value<bool>()->default_value(false),
      "Extract variants from source VCF records that have been filtered")
+
+    ("cache-source-candidates",
+     po::value<bool>()->default_value(false),
+     "Convert source candidate variant files into binary caches, written beside the source files"
+     " and reused by subsequent runs, to avoid re-parsing VCF text")
     
     ("min-base-quality",
      po::value<int>()->default_value(20),
@@ -409,6 +483,11 @@ OptionMap parse_options(const int argc, const char** argv)
     ("dedup-haplotypes-with-prior-model",
      po::value<bool>()->default_value(true),
      "Remove duplicate haplotypes using mutation prior model")
+
+    ("collapse-near-duplicate-haplotypes",
+     po::value<bool>()->default_value(false),
+     "Collapse haplotypes that are near-identical at the sequence level before"
+     " likelihood calculation, keeping the least complex of each cluster")
     
     ("protect-reference-haplotype",
      po::value<bool>()->default_value(true),
@@ -696,12 +775,23 @@ OptionMap parse_options(const int argc, const char** argv)
         return vm_init;
     }
     
+    if (vm_init.count("batch") == 1) {
+        // Each batch line is parsed as a command of its own, so the batch
+        // invocation itself is not validated any further
+        return vm_init;
+    }
+    
     OptionMap vm;
     
     if (vm_init.count("config") == 1) {
         auto config_path = resolve_path(vm_init.at("config").as<fs::path>(), vm_init);
         parse_config_file(config_path, vm, all);
     }
+
+    if (vm_init.count("replay") == 1) {
+        const auto bundle_path = resolve_path(vm_init.at("replay").as<fs::path>(), vm_init);
+        parse_config_file(bundle_path / "replay.config", vm, all);
+    }
     
     vm_init.clear();
     po::store(run(po::command_line_parser(argc, argv).options(all)), vm);
@@ -929,6 +1019,15 @@ void check_probability(const std::string& option, const OptionMap& vm)
     }
 }
 
+void check_distributed_job_consistent(const OptionMap& vm)
+{
+    const auto num_jobs = vm.at("distributed-jobs").as<int>();
+    const auto job_id = vm.at("distributed-job-id").as<int>();
+    if (job_id >= num_jobs) {
+        throw InvalidCommandLineOptionValue {"distributed-job-id", job_id, "must be less than --distributed-jobs"};
+    }
+}
+
 void conflicting_options(const OptionMap& vm, const std::string& opt1, const std::string& opt2)
 {
     if (vm.count(opt1) == 1 && !vm[opt1].defaulted() && vm.count(opt2) == 1 && !vm[opt2].defaulted()) {
@@ -1014,13 +1113,14 @@ void validate(const OptionMap& vm)
         "min-mapping-quality", "good-base-quality", "min-good-bases", "min-read-length",
         "max-read-length", "min-base-quality", "min-supporting-reads", "max-variant-size",
         "num-fallback-kmers", "max-assemble-region-overlap", "assembler-mask-base-quality",
-        "min-kmer-prune", "max-bubbles", "max-holdout-depth"
+        "min-kmer-prune", "max-bubbles", "max-holdout-depth", "distributed-job-id"
     };
     const std::vector<std::string> strictly_positive_int_options {
         "max-open-read-files", "downsample-above", "downsample-target",
         "max-region-to-assemble", "fallback-kmer-gap", "organism-ploidy",
         "max-haplotypes", "haplotype-holdout-threshold", "haplotype-overflow",
-        "max-genotypes", "max-joint-genotypes", "max-somatic-haplotypes", "max-clones"
+        "max-genotypes", "max-joint-genotypes", "max-somatic-haplotypes", "max-clones",
+        "distributed-jobs"
     };
     const std::vector<std::string> probability_options {
         "snp-heterozygosity", "snp-heterozygosity-stdev", "indel-heterozygosity",
@@ -1041,6 +1141,7 @@ void validate(const OptionMap& vm)
     check_reads_present(vm);
     check_region_files_consistent(vm);
     check_trio_consistent(vm);
+    check_distributed_job_consistent(vm);
     validate_caller(vm);
 }
 
@@ -0,0 +1,500 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef flat_hash_map_hpp
+#define flat_hash_map_hpp
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <boost/optional.hpp>
+
+namespace octopus {
+
+/*
+ FlatHashMap and FlatHashSet are open addressing hash containers with
+ Robin Hood probing and backward shift deletion. All entries live in one
+ contiguous slot array, so lookups touch adjacent memory and there is no
+ per-entry node allocation, which makes them considerably cheaper than the
+ standard unordered containers for keys that are inserted and erased in
+ bulk (kmers, graph vertices, candidate variants).
+
+ Differences from the standard containers that matter to callers:
+   - any insertion or erasure invalidates all iterators and references
+   - the map's value type has a mutable key; it must not be modified
+     through iterators
+   - the hash and key equality functors must be stateless
+ */
+
+namespace detail {
+
+// Finalising mixer (splitmix64); user hashes are often identity-like
+// (pointers, packed kmers) and the table indexes with the low bits only
+inline std::size_t mix_hash(const std::size_t h) noexcept
+{
+    auto z = static_cast<std::uint64_t>(h);
+    z ^= z >> 30;
+    z *= 0xbf58476d1ce4e5b9ULL;
+    z ^= z >> 27;
+    z *= 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return static_cast<std::size_t>(z);
+}
+
+template <typename ValueType, typename KeyOf, typename Hash, typename KeyEqual>
+class FlatHashTable
+{
+public:
+    using value_type = ValueType;
+    using size_type  = std::size_t;
+
+    template <typename V>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename std::remove_const<V>::type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = V*;
+        using reference         = V&;
+
+        Iterator() noexcept = default;
+        Iterator(const std::int8_t* probe, const std::int8_t* probe_end, V* value) noexcept
+        : probe_ {probe}, probe_end_ {probe_end}, value_ {value}
+        {
+            skip_empty();
+        }
+        operator Iterator<const V>() const noexcept // iterator to const_iterator
+        {
+            Iterator<const V> result {};
+            result.probe_ = probe_; result.probe_end_ = probe_end_; result.value_ = value_;
+            return result;
+        }
+
+        reference operator*() const noexcept { return *value_; }
+        pointer operator->() const noexcept { return value_; }
+
+        Iterator& operator++() noexcept
+        {
+            ++probe_; ++value_;
+            skip_empty();
+            return *this;
+        }
+        Iterator operator++(int) noexcept
+        {
+            auto result = *this;
+            ++(*this);
+            return result;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept
+        {
+            return lhs.probe_ == rhs.probe_;
+        }
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        void skip_empty() noexcept
+        {
+            while (probe_ != probe_end_ && *probe_ < 0) {
+                ++probe_; ++value_;
+            }
+        }
+
+        const std::int8_t* probe_ = nullptr;
+        const std::int8_t* probe_end_ = nullptr;
+        V* value_ = nullptr;
+
+        template <typename> friend class Iterator;
+        friend class FlatHashTable;
+    };
+
+    using iterator       = Iterator<value_type>;
+    using const_iterator = Iterator<const value_type>;
+
+    FlatHashTable() noexcept = default;
+
+    FlatHashTable(const FlatHashTable& other)
+    {
+        reserve(other.size_);
+        for (const auto& value : other) place(value_type {value});
+        size_ = other.size_;
+    }
+    FlatHashTable& operator=(const FlatHashTable& other)
+    {
+        if (this != &other) {
+            FlatHashTable tmp {other};
+            swap(tmp);
+        }
+        return *this;
+    }
+    FlatHashTable(FlatHashTable&& other) noexcept
+    {
+        swap(other);
+    }
+    FlatHashTable& operator=(FlatHashTable&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~FlatHashTable()
+    {
+        destroy_values();
+    }
+
+    void swap(FlatHashTable& other) noexcept
+    {
+        std::swap(storage_, other.storage_);
+        std::swap(probes_, other.probes_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    iterator begin() noexcept
+    {
+        return {probes(), probes() + capacity_, values()};
+    }
+    const_iterator begin() const noexcept
+    {
+        return {probes(), probes() + capacity_, values()};
+    }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept
+    {
+        return {probes() + capacity_, probes() + capacity_, values() + capacity_};
+    }
+    const_iterator end() const noexcept
+    {
+        return {probes() + capacity_, probes() + capacity_, values() + capacity_};
+    }
+    const_iterator cend() const noexcept { return end(); }
+
+    void clear() noexcept
+    {
+        destroy_values();
+        std::fill(probes(), probes() + capacity_, std::int8_t {-1});
+        size_ = 0;
+    }
+
+    void reserve(const size_type n)
+    {
+        if (n > max_load(capacity_)) {
+            rebuild(min_capacity_for(n));
+        }
+    }
+    // Shrinks or grows to the smallest capacity holding at least
+    // max(n, size()) entries, like the standard container member
+    void rehash(const size_type n)
+    {
+        rebuild(min_capacity_for(std::max(n, size_)));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return do_insert(value);
+    }
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+        return do_insert(std::move(value));
+    }
+    // Hinted inserts (the hint is ignored); these allow std::inserter
+    iterator insert(const_iterator, const value_type& value)
+    {
+        return do_insert(value).first;
+    }
+    iterator insert(const_iterator, value_type&& value)
+    {
+        return do_insert(std::move(value)).first;
+    }
+
+    template <typename K>
+    iterator find(const K& key) noexcept
+    {
+        const auto idx = find_index(key);
+        return idx ? make_iterator(*idx) : end();
+    }
+    template <typename K>
+    const_iterator find(const K& key) const noexcept
+    {
+        const auto idx = find_index(key);
+        return idx ? make_const_iterator(*idx) : end();
+    }
+    template <typename K>
+    size_type count(const K& key) const noexcept
+    {
+        return find_index(key) ? 1 : 0;
+    }
+
+    template <typename K>
+    size_type erase(const K& key) noexcept
+    {
+        const auto idx = find_index(key);
+        if (!idx) return 0;
+        erase_index(*idx);
+        return 1;
+    }
+    // Backward shift deletion can move the next entry into the erased slot,
+    // so the returned iterator resumes from the erased position
+    iterator erase(const_iterator position) noexcept
+    {
+        const auto idx = static_cast<size_type>(position.probe_ - probes());
+        erase_index(idx);
+        return make_iterator(idx);
+    }
+    iterator erase(iterator position) noexcept
+    {
+        return erase(static_cast<const_iterator>(position));
+    }
+
+protected:
+    template <typename K>
+    value_type* find_value(const K& key) noexcept
+    {
+        const auto idx = find_index(key);
+        return idx ? values() + *idx : nullptr;
+    }
+    template <typename K>
+    const value_type* find_value(const K& key) const noexcept
+    {
+        const auto idx = find_index(key);
+        return idx ? values() + *idx : nullptr;
+    }
+
+private:
+    static constexpr size_type minCapacity {16};
+    static constexpr std::int8_t maxProbeLength {120};
+
+    std::unique_ptr<unsigned char[]> storage_;
+    std::unique_ptr<std::int8_t[]> probes_;
+    size_type capacity_ = 0;
+    size_type size_ = 0;
+
+    value_type* values() noexcept
+    {
+        return reinterpret_cast<value_type*>(storage_.get());
+    }
+    const value_type* values() const noexcept
+    {
+        return reinterpret_cast<const value_type*>(storage_.get());
+    }
+    std::int8_t* probes() const noexcept { return probes_.get(); }
+
+    static size_type max_load(const size_type capacity) noexcept
+    {
+        return capacity - capacity / 4; // 0.75
+    }
+    static size_type min_capacity_for(const size_type n) noexcept
+    {
+        auto result = minCapacity;
+        while (max_load(result) < n) result *= 2;
+        return result;
+    }
+
+    template <typename K>
+    size_type index_for(const K& key) const noexcept
+    {
+        return mix_hash(Hash {}(key)) & (capacity_ - 1);
+    }
+    size_type next_index(const size_type idx) const noexcept
+    {
+        return (idx + 1) & (capacity_ - 1);
+    }
+
+    iterator make_iterator(const size_type idx) noexcept
+    {
+        return {probes() + idx, probes() + capacity_, values() + idx};
+    }
+    const_iterator make_const_iterator(const size_type idx) const noexcept
+    {
+        return {probes() + idx, probes() + capacity_, values() + idx};
+    }
+
+    template <typename K>
+    boost::optional<size_type> find_index(const K& key) const noexcept
+    {
+        if (capacity_ == 0) return boost::none;
+        auto idx = index_for(key);
+        std::int8_t probe {0};
+        // The Robin Hood invariant means the key cannot sit after any slot
+        // that is closer to its own home than we are to ours
+        while (probes()[idx] >= probe) {
+            if (KeyEqual {}(KeyOf {}(values()[idx]), key)) return idx;
+            idx = next_index(idx);
+            ++probe;
+        }
+        return boost::none;
+    }
+
+    template <typename V>
+    std::pair<iterator, bool> do_insert(V&& value)
+    {
+        const auto existing = find_index(KeyOf {}(value));
+        if (existing) return {make_iterator(*existing), false};
+        if (size_ + 1 > max_load(capacity_)) {
+            rebuild(capacity_ ? 2 * capacity_ : minCapacity);
+        }
+        const auto idx = place(std::forward<V>(value));
+        ++size_;
+        return {make_iterator(idx), true};
+    }
+
+    // Robin Hood insertion of a key known to be absent; displaced entries move
+    // on with the probe sequence so every entry stays as close to home as the
+    // order of insertion allows. Returns the slot the given value ended up in
+    size_type place(value_type value)
+    {
+        auto idx = index_for(KeyOf {}(value));
+        std::int8_t probe {0};
+        auto result_idx = capacity_; // i.e. unset
+        while (true) {
+            if (probe == maxProbeLength) {
+                // Pathological clustering; grow and place everything again. If
+                // the table is already mostly empty then growing cannot break
+                // the cluster and the hash function must be degenerate (only
+                // the basic exception guarantee is given here)
+                if (capacity_ > 8 * (size_ + 1)) {
+                    throw std::runtime_error {"FlatHashTable: degenerate hash function"};
+                }
+                if (result_idx == capacity_) {
+                    rebuild(2 * capacity_);
+                    return place(std::move(value));
+                } else {
+                    // The original value already has a slot the rebuild will move,
+                    // so remember its key and look it up afterwards
+                    const auto original_key = KeyOf {}(values()[result_idx]);
+                    rebuild(2 * capacity_);
+                    place(std::move(value));
+                    return *find_index(original_key);
+                }
+            }
+            if (probes()[idx] < 0) {
+                new (values() + idx) value_type {std::move(value)};
+                probes()[idx] = probe;
+                return result_idx == capacity_ ? idx : result_idx;
+            }
+            if (probes()[idx] < probe) {
+                std::swap(value, values()[idx]);
+                std::swap(probe, probes()[idx]);
+                if (result_idx == capacity_) result_idx = idx;
+            }
+            idx = next_index(idx);
+            ++probe;
+        }
+    }
+
+    void erase_index(size_type idx) noexcept
+    {
+        values()[idx].~value_type();
+        probes()[idx] = -1;
+        auto next = next_index(idx);
+        // Backward shift: pull displaced successors one slot closer to home
+        while (probes()[next] > 0) {
+            new (values() + idx) value_type {std::move(values()[next])};
+            values()[next].~value_type();
+            probes()[idx] = static_cast<std::int8_t>(probes()[next] - 1);
+            probes()[next] = -1;
+            idx = next;
+            next = next_index(next);
+        }
+        --size_;
+    }
+
+    void destroy_values() noexcept
+    {
+        if (!std::is_trivially_destructible<value_type>::value) {
+            for (size_type i {0}; i < capacity_; ++i) {
+                if (probes()[i] >= 0) values()[i].~value_type();
+            }
+        }
+    }
+
+    void rebuild(const size_type new_capacity)
+    {
+        FlatHashTable old {};
+        swap(old);
+        storage_.reset(new unsigned char[new_capacity * sizeof(value_type)]);
+        probes_.reset(new std::int8_t[new_capacity]);
+        capacity_ = new_capacity;
+        size_ = old.size_;
+        std::fill(probes(), probes() + capacity_, std::int8_t {-1});
+        for (auto& value : old) place(std::move(value));
+    }
+};
+
+struct PairKeyOf
+{
+    template <typename Pair>
+    const typename Pair::first_type& operator()(const Pair& p) const noexcept { return p.first; }
+};
+
+struct IdentityKeyOf
+{
+    template <typename K>
+    const K& operator()(const K& k) const noexcept { return k; }
+};
+
+} // namespace detail
+
+template <typename Key,
+          typename T,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+: public detail::FlatHashTable<std::pair<Key, T>, detail::PairKeyOf, Hash, KeyEqual>
+{
+public:
+    using key_type    = Key;
+    using mapped_type = T;
+
+    T& at(const Key& key)
+    {
+        const auto value = this->find_value(key);
+        if (!value) throw std::out_of_range {"FlatHashMap::at"};
+        return value->second;
+    }
+    const T& at(const Key& key) const
+    {
+        const auto value = this->find_value(key);
+        if (!value) throw std::out_of_range {"FlatHashMap::at"};
+        return value->second;
+    }
+
+    T& operator[](const Key& key)
+    {
+        return this->emplace(key, T {}).first->second;
+    }
+};
+
+template <typename Key,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FlatHashSet
+: public detail::FlatHashTable<Key, detail::IdentityKeyOf, Hash, KeyEqual>
+{
+public:
+    using key_type = Key;
+};
+
+} // namespace octopus
+
+#endif
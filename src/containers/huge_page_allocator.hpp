@@ -0,0 +1,85 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef huge_page_allocator_hpp
+#define huge_page_allocator_hpp
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <sys/mman.h>
+
+namespace octopus {
+
+/*
+ HugePageAllocator is a minimal standard allocator that asks the kernel to back
+ large allocations with transparent huge pages, reducing TLB pressure when
+ scanning big contiguous structures such as likelihood matrices and read
+ buffers.
+
+ Allocations below the huge page size go through malloc unchanged. Larger ones
+ are aligned and padded to the huge page boundary so the kernel can promote
+ whole pages, and flagged with MADV_HUGEPAGE where the platform defines it;
+ elsewhere the alignment is harmless and the advice is skipped.
+ */
+template <typename T>
+class HugePageAllocator
+{
+public:
+    using value_type = T;
+
+    static constexpr std::size_t hugePageSize {2 * 1024 * 1024};
+
+    HugePageAllocator() noexcept = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    HugePageAllocator(const HugePageAllocator&)            = default;
+    HugePageAllocator& operator=(const HugePageAllocator&) = default;
+
+    ~HugePageAllocator() = default;
+
+    T* allocate(const std::size_t n)
+    {
+        const auto num_bytes = n * sizeof(T);
+        void* result {nullptr};
+        if (num_bytes >= hugePageSize) {
+            const auto padded_bytes = (num_bytes + hugePageSize - 1) & ~(hugePageSize - 1);
+            if (posix_memalign(&result, hugePageSize, padded_bytes) != 0) {
+                throw std::bad_alloc {};
+            }
+#ifdef MADV_HUGEPAGE
+            madvise(result, padded_bytes, MADV_HUGEPAGE); // advisory; failure is harmless
+#endif
+        } else {
+            result = std::malloc(num_bytes);
+            if (result == nullptr && num_bytes > 0) {
+                throw std::bad_alloc {};
+            }
+        }
+        return static_cast<T*>(result);
+    }
+
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        std::free(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const HugePageAllocator<T>&, const HugePageAllocator<U>&) noexcept
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const HugePageAllocator<T>&, const HugePageAllocator<U>&) noexcept
+{
+    return false;
+}
+
+} // namespace octopus
+
+#endif
@@ -89,6 +89,10 @@ public:
     iterator insert(const_iterator, MappableType&& mappable);
     template <typename InputIterator>
     void insert(InputIterator, InputIterator);
+    // Merges a presorted range in linear time; falls back to insert if the
+    // range turns out not to be sorted
+    template <typename InputIterator>
+    void insert_sorted(InputIterator, InputIterator);
     iterator insert(std::initializer_list<MappableType>);
     iterator erase(const_iterator);
     size_type erase(const MappableType&);
@@ -181,6 +185,21 @@ private:
     base_t elements_;
     bool is_bidirectionally_sorted_;
     typename RegionType<MappableType>::Position max_element_size_;
+    // The maximum mapped end in each fixed-size block of elements. Only built when
+    // the container is not bidirectionally sorted, where it lets overlap queries
+    // skip blocks that cannot reach the queried region rather than scanning the
+    // full window implied by the largest element
+    std::vector<typename RegionType<MappableType>::Position> block_max_ends_;
+
+    static constexpr size_type overlapIndexBlockSize {64};
+    static constexpr size_type minOverlapIndexSize {4 * overlapIndexBlockSize};
+
+    void update_overlap_index();
+    void update_overlap_index(const_iterator hint);
+    void rebuild_overlap_index_from(size_type block);
+    template <typename MappableType_>
+    const_iterator refine_overlap_search_start(const_iterator search_first, const_iterator search_last,
+                                               const MappableType_& mappable) const;
 };
 
 template <typename MappableType, typename Allocator>
@@ -196,14 +215,18 @@ MappableFlatMultiSet<MappableType, Allocator>::MappableFlatMultiSet(InputIterato
 : elements_ {first, second}
 , is_bidirectionally_sorted_ {is_bidirectionally_sorted(elements_)}
 , max_element_size_ {(elements_.empty()) ? 0 : region_size(*largest_mappable(elements_))}
-{}
+{
+    update_overlap_index();
+}
 
 template <typename MappableType, typename Allocator>
 MappableFlatMultiSet<MappableType, Allocator>::MappableFlatMultiSet(std::initializer_list<MappableType> mappables)
 : elements_ {mappables}
 , is_bidirectionally_sorted_ {is_bidirectionally_sorted(elements_)}
 , max_element_size_ {(elements_.empty()) ? 0 : region_size(*largest_mappable(elements_))}
-{}
+{
+    update_overlap_index();
+}
 
 template <typename MappableType, typename Allocator>
 typename MappableFlatMultiSet<MappableType, Allocator>::iterator
@@ -364,6 +387,7 @@ MappableFlatMultiSet<MappableType, Allocator>::emplace(Args... args)
         is_bidirectionally_sorted_ = is_bidirectionally_sorted(overlapped);
     }
     max_element_size_ = std::max(max_element_size_, region_size(*it));
+    update_overlap_index(it);
     return it;
 }
 
@@ -377,6 +401,7 @@ MappableFlatMultiSet<MappableType, Allocator>::insert(const MappableType& m)
         is_bidirectionally_sorted_ = is_bidirectionally_sorted(overlapped);
     }
     max_element_size_ = std::max(max_element_size_, region_size(*it));
+    update_overlap_index(it);
     return it;
 }
 
@@ -390,6 +415,7 @@ MappableFlatMultiSet<MappableType, Allocator>::insert(MappableType&& m)
         is_bidirectionally_sorted_ = is_bidirectionally_sorted(overlapped);
     }
     max_element_size_ = std::max(max_element_size_, region_size(*it));
+    update_overlap_index(it);
     return it;
 }
 
@@ -403,6 +429,7 @@ MappableFlatMultiSet<MappableType, Allocator>::insert(const_iterator hint, const
         is_bidirectionally_sorted_ = is_bidirectionally_sorted(overlapped);
     }
     max_element_size_ = std::max(max_element_size_, region_size(m));
+    update_overlap_index(it2);
     return it2;
 }
 
@@ -416,6 +443,7 @@ MappableFlatMultiSet<MappableType, Allocator>::insert(const_iterator hint, Mappa
         is_bidirectionally_sorted_ = is_bidirectionally_sorted(overlapped);
     }
     max_element_size_ = std::max(max_element_size_, region_size(m));
+    update_overlap_index(it2);
     return it2;
 }
 
@@ -430,6 +458,26 @@ MappableFlatMultiSet<MappableType, Allocator>::insert(InputIterator first, Input
         if (is_bidirectionally_sorted_) {
             is_bidirectionally_sorted_ = is_bidirectionally_sorted(elements_);
         }
+        update_overlap_index();
+    }
+}
+
+template <typename MappableType, typename Allocator>
+template <typename InputIterator>
+void
+MappableFlatMultiSet<MappableType, Allocator>::insert_sorted(InputIterator first, InputIterator last)
+{
+    if (first != last) {
+        if (std::is_sorted(first, last)) {
+            max_element_size_ = std::max(max_element_size_, region_size(*largest_mappable(first, last)));
+            elements_.insert(boost::container::ordered_range, first, last);
+            if (is_bidirectionally_sorted_) {
+                is_bidirectionally_sorted_ = is_bidirectionally_sorted(elements_);
+            }
+            update_overlap_index();
+        } else {
+            insert(first, last);
+        }
     }
 }
 
@@ -444,6 +492,7 @@ MappableFlatMultiSet<MappableType, Allocator>::insert(std::initializer_list<Mapp
     if (is_bidirectionally_sorted_ && !il.empty() ) {
         is_bidirectionally_sorted_ = is_bidirectionally_sorted(elements_);
     }
+    update_overlap_index();
     return result;
 }
 
@@ -462,6 +511,7 @@ MappableFlatMultiSet<MappableType, Allocator>::erase(const_iterator p)
             max_element_size_ = region_size(*largest_mappable(elements_));
         }
     }
+    update_overlap_index(result);
     return result;
 }
 
@@ -480,6 +530,7 @@ MappableFlatMultiSet<MappableType, Allocator>::erase(const MappableType& m)
                 max_element_size_ = region_size(*largest_mappable(elements_));
             }
         }
+        update_overlap_index();
         return result;
     }
     return 0;
@@ -500,6 +551,7 @@ MappableFlatMultiSet<MappableType, Allocator>::erase(const_iterator first, const
             max_element_size_ = region_size(*largest_mappable(elements_));
         }
     }
+    update_overlap_index(result);
     return result;
 }
 
@@ -535,6 +587,7 @@ MappableFlatMultiSet<MappableType, Allocator>::erase_all(InputIt first, InputIt
             max_element_size_ = 0;
             is_bidirectionally_sorted_ = true;
         }
+        update_overlap_index();
     }
     return result;
 }
@@ -545,6 +598,68 @@ void MappableFlatMultiSet<MappableType, Allocator>::clear()
     elements_.clear();
     is_bidirectionally_sorted_ = true;
     max_element_size_ = 0;
+    block_max_ends_.clear();
+}
+
+template <typename MappableType, typename Allocator>
+void MappableFlatMultiSet<MappableType, Allocator>::update_overlap_index()
+{
+    if (is_bidirectionally_sorted_ || elements_.size() < minOverlapIndexSize) {
+        block_max_ends_.clear();
+    } else {
+        rebuild_overlap_index_from(0);
+    }
+}
+
+template <typename MappableType, typename Allocator>
+void MappableFlatMultiSet<MappableType, Allocator>::update_overlap_index(const_iterator hint)
+{
+    if (is_bidirectionally_sorted_ || elements_.size() < minOverlapIndexSize) {
+        block_max_ends_.clear();
+    } else if (block_max_ends_.empty()) {
+        rebuild_overlap_index_from(0);
+    } else {
+        // Elements before the mutation point are unchanged, so only blocks from
+        // the one containing it need recomputing
+        const auto index = static_cast<size_type>(std::distance(std::cbegin(elements_), hint));
+        rebuild_overlap_index_from(index / overlapIndexBlockSize);
+    }
+}
+
+template <typename MappableType, typename Allocator>
+void MappableFlatMultiSet<MappableType, Allocator>::rebuild_overlap_index_from(const size_type block)
+{
+    block_max_ends_.resize(block);
+    auto itr = std::next(std::cbegin(elements_), block * overlapIndexBlockSize);
+    const auto last = std::cend(elements_);
+    while (itr != last) {
+        auto max_end = mapped_end(*itr++);
+        for (size_type i {1}; i < overlapIndexBlockSize && itr != last; ++i, ++itr) {
+            max_end = std::max(max_end, mapped_end(*itr));
+        }
+        block_max_ends_.push_back(max_end);
+    }
+}
+
+template <typename MappableType, typename Allocator>
+template <typename MappableType_>
+typename MappableFlatMultiSet<MappableType, Allocator>::const_iterator
+MappableFlatMultiSet<MappableType, Allocator>::refine_overlap_search_start(const_iterator search_first, const_iterator search_last,
+                                                                           const MappableType_& mappable) const
+{
+    // Any block whose maximum mapped end is strictly left of the query cannot
+    // contain an overlapping element, so the linear part of the search can start
+    // at the first block that reaches the query
+    const auto query_begin = mapped_begin(mappable);
+    const auto first_index = static_cast<size_type>(std::distance(std::cbegin(elements_), search_first));
+    const auto last_index  = static_cast<size_type>(std::distance(std::cbegin(elements_), search_last));
+    auto block = first_index / overlapIndexBlockSize;
+    while (block * overlapIndexBlockSize < last_index && block_max_ends_[block] < query_begin) {
+        ++block;
+    }
+    const auto refined_index = block * overlapIndexBlockSize;
+    if (refined_index <= first_index) return search_first;
+    return std::next(std::cbegin(elements_), std::min(refined_index, last_index));
 }
 
 template <typename MappableType, typename Allocator>
@@ -658,6 +773,10 @@ MappableFlatMultiSet<MappableType, Allocator>::count_overlapped(const_iterator f
     if (is_bidirectionally_sorted_) {
         return count_overlapped(first, last, mappable, BidirectionallySortedTag {});
     }
+    if (!block_max_ends_.empty()) {
+        using octopus::size;
+        return size(overlap_range(first, last, mappable));
+    }
     return count_overlapped(first, last, mappable, max_element_size_);
 }
 
@@ -679,7 +798,20 @@ MappableFlatMultiSet<MappableType, Allocator>::overlap_range(const_iterator firs
     if (is_bidirectionally_sorted_) {
         return overlap_range(first, last, mappable, BidirectionallySortedTag {});
     }
-    return overlap_range(first, last, mappable, max_element_size_);
+    if (block_max_ends_.empty()) {
+        return overlap_range(first, last, mappable, max_element_size_);
+    }
+    // As the max element size version, but the linear search for the first overlapped
+    // element consults the block index so most of the window can be stepped over
+    const auto it1 = find_first_after(first, last, mappable);
+    const auto leftmost = shift(mapped_region(mappable), -std::min(mapped_begin(mappable), max_element_size_));
+    auto it2 = std::lower_bound(first, it1, leftmost,
+                                [] (const auto& lhs, const auto& rhs) {
+                                    return begins_before(lhs, rhs);
+                                });
+    it2 = refine_overlap_search_start(it2, it1, mappable);
+    it2 = std::find_if(it2, it1, [&mappable] (const auto& m) { return overlaps(m, mappable); });
+    return make_overlap_range(it2, it1, mappable);
 }
 
 template <typename MappableType, typename Allocator>
@@ -862,6 +994,7 @@ void swap(MappableFlatMultiSet<MappableType, Allocator>& lhs,
     swap(lhs.elements_, rhs.elements_);
     swap(lhs.is_bidirectionally_sorted_, rhs.is_bidirectionally_sorted_);
     swap(lhs.max_element_size_, rhs.max_element_size_);
+    swap(lhs.block_max_ends_, rhs.block_max_ends_);
 }
 
 template <typename ForwardIterator, typename MappableType1, typename MappableType2, typename Allocator>
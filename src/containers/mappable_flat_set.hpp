@@ -95,6 +95,8 @@ public:
     iterator erase(const_iterator, const_iterator);
     template <typename BidirIt>
     size_type erase_all(BidirIt first, BidirIt last);
+    template <typename UnaryPredicate>
+    size_type erase_all(UnaryPredicate pred);
     
     void clear();
     
@@ -661,6 +663,38 @@ MappableFlatSet<MappableType, Allocator>::erase_all(BidirIt first, const BidirIt
     return num_erased;
 }
 
+template <typename MappableType, typename Allocator>
+template <typename UnaryPredicate>
+typename MappableFlatSet<MappableType, Allocator>::size_type
+MappableFlatSet<MappableType, Allocator>::erase_all(UnaryPredicate pred)
+{
+    typename RegionType<MappableType>::Size max_erased_size {0};
+    const auto first_erased = std::remove_if(std::begin(elements_), std::end(elements_),
+                                             [&] (const MappableType& element) {
+                                                 if (pred(element)) {
+                                                     max_erased_size = std::max(max_erased_size, region_size(element));
+                                                     return true;
+                                                 }
+                                                 return false;
+                                             });
+    const auto num_erased = static_cast<size_type>(std::distance(first_erased, std::end(elements_)));
+    if (num_erased > 0) {
+        elements_.erase(first_erased, std::end(elements_));
+        if (!elements_.empty()) {
+            if (!is_bidirectionally_sorted_) {
+                is_bidirectionally_sorted_ = is_bidirectionally_sorted(elements_);
+            }
+            if (max_element_size_ == max_erased_size) {
+                max_element_size_ = region_size(*largest_mappable(elements_));
+            }
+        } else {
+            max_element_size_ = 0;
+            is_bidirectionally_sorted_ = true;
+        }
+    }
+    return num_erased;
+}
+
 template <typename MappableType, typename Allocator>
 void MappableFlatSet<MappableType, Allocator>::clear()
 {
@@ -27,13 +27,13 @@ using MappableMap = std::unordered_map<KeyType, Container>;
 template <typename KeyType, typename MappableType>
 using MappableSetMap = MappableMap<KeyType, MappableType, MappableFlatSet<MappableType>>;
 
-template <typename Map>
-MappableMap<typename Map::key_type, typename Map::mapped_type::value_type>
+template <typename Container, typename Map>
+MappableMap<typename Map::key_type, typename Map::mapped_type::value_type, Container>
 make_mappable_map(Map map)
 {
     using std::make_move_iterator; using std::begin; using std::end;
     using MappableTp = typename Map::mapped_type::value_type;
-    MappableMap<typename Map::key_type, MappableTp> result {map.size()};
+    MappableMap<typename Map::key_type, MappableTp, Container> result {map.size()};
     std::for_each(make_move_iterator(begin(map)), make_move_iterator(end(map)),
                   [&result] (auto&& p) {
                       result.emplace(std::piecewise_construct,
@@ -44,6 +44,13 @@ make_mappable_map(Map map)
     return result;
 }
 
+template <typename Map>
+auto make_mappable_map(Map map)
+{
+    using Container = MappableFlatMultiSet<typename Map::mapped_type::value_type>;
+    return make_mappable_map<Container>(std::move(map));
+}
+
 template <typename KeyType, typename Container>
 auto sum_region_sizes(const MappableMap<KeyType, typename Container::value_type, Container>& mappables)
 {
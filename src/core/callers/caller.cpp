@@ -4,14 +4,21 @@
 #include "caller.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <utility>
 #include <tuple>
 #include <iterator>
+#include <unordered_map>
 #include <stdexcept>
+#include <limits>
 #include <cassert>
 #include <iostream>
 
+#include <boost/functional/hash.hpp>
+
 #include "concepts/mappable.hpp"
+#include "io/reference/local_reference_cache.hpp"
+#include "utils/kmer_mapper.hpp"
 #include "utils/mappable_algorithms.hpp"
 #include "utils/read_stats.hpp"
 #include "utils/maths.hpp"
@@ -24,6 +31,7 @@
 #include "core/types/calls/reference_call.hpp"
 
 #include "timers.hpp"
+#include "allocation_profiler.hpp"
 
 #include "core/tools/read_assigner.hpp"
 #include "core/tools/read_realigner.hpp"
@@ -43,6 +51,11 @@ Caller::Caller(Components&& components, Parameters parameters)
 , likelihood_model_ {std::move(components.likelihood_model)}
 , phaser_ {std::move(components.phaser)}
 , parameters_ {std::move(parameters)}
+, evaluation_workers_ {std::move(components.evaluation_workers)}
+, likelihood_cache_budget_ {components.likelihood_cache_budget}
+, likelihood_cache_spill_directory_ {std::move(components.likelihood_cache_spill_directory)}
+, likelihood_checkpoint_ {std::move(components.likelihood_checkpoint)}
+, replay_bundle_writer_ {std::move(components.replay_bundle_writer)}
 {
     if (parameters_.max_haplotypes == 0) {
         throw std::logic_error {"Caller: max haplotypes must be > 0"};
@@ -53,6 +66,10 @@ Caller::Caller(Components&& components, Parameters parameters)
     if (TRACE_MODE) {
         trace_log_ = logging::TraceLogger {};
     }
+    if (evaluation_workers_ && !evaluation_workers_->empty()) {
+        candidate_generator_.enable_parallel_generation(*evaluation_workers_);
+        phaser_.enable_parallel_phasing(*evaluation_workers_);
+    }
 }
 
 std::string Caller::name() const
@@ -141,39 +158,152 @@ auto convert_to_vcf(std::deque<CallWrapper>&& calls, const VcfRecordFactory& fac
     return result;
 }
 
+bool is_refcall(const CallWrapper& call)
+{
+    return dynamic_cast<const ReferenceCall*>(call.call.get()) != nullptr;
+}
+
+// The record factory resolves interactions between nearby calls - boundary
+// insertions, indel padding, phase regions - so the call stream can only be
+// cut where a wide run of pure reference calls guarantees nothing reaches
+// across the cut
+constexpr GenomicRegion::Position refcallStreamGuardSize {50000};
+constexpr std::size_t minStreamedConversionChunkSize {10000};
+
+std::vector<std::size_t> find_streamed_conversion_cut_points(const std::deque<CallWrapper>& calls)
+{
+    std::vector<std::size_t> result {};
+    const auto num_calls = calls.size();
+    if (num_calls < 2 * minStreamedConversionChunkSize) return result;
+    std::vector<bool> refcalls(num_calls);
+    std::transform(std::cbegin(calls), std::cend(calls), std::begin(refcalls),
+                   [] (const CallWrapper& call) { return is_refcall(call); });
+    constexpr auto maxPosition = std::numeric_limits<GenomicRegion::Position>::max();
+    std::vector<GenomicRegion::Position> next_variant_begins(num_calls + 1, maxPosition);
+    for (auto i = num_calls; i-- > 0;) {
+        next_variant_begins[i] = refcalls[i] ? next_variant_begins[i + 1] : calls[i].mapped_region().begin();
+    }
+    GenomicRegion::Position prev_variant_end {0};
+    std::size_t last_cut {0};
+    for (std::size_t i {1}; i < num_calls; ++i) {
+        if (!refcalls[i - 1]) {
+            prev_variant_end = std::max(prev_variant_end, calls[i - 1].mapped_region().end());
+        }
+        if (refcalls[i - 1] && refcalls[i] && i - last_cut >= minStreamedConversionChunkSize) {
+            const auto cut_position = calls[i].mapped_region().begin();
+            if (cut_position >= prev_variant_end + refcallStreamGuardSize
+                && (next_variant_begins[i] == maxPosition
+                    || next_variant_begins[i] >= cut_position + refcallStreamGuardSize)) {
+                result.push_back(i);
+                last_cut = i;
+            }
+        }
+    }
+    return result;
+}
+
+auto convert_to_vcf_streamed(std::deque<CallWrapper>&& calls, const VcfRecordFactory& factory,
+                             const GenomicRegion& call_region)
+{
+    // Converting chunk by chunk frees the heavyweight calls in each chunk as
+    // the frontier advances, rather than holding every call alongside every
+    // record until the end of the task
+    auto cut_points = find_streamed_conversion_cut_points(calls);
+    cut_points.push_back(calls.size());
+    std::deque<VcfRecord> result {};
+    std::size_t chunk_begin_idx {0};
+    for (const auto chunk_end_idx : cut_points) {
+        const auto chunk_begin_itr = std::next(std::begin(calls), chunk_begin_idx);
+        const auto chunk_end_itr   = std::next(std::begin(calls), chunk_end_idx);
+        std::vector<CallWrapper> chunk {std::make_move_iterator(chunk_begin_itr), std::make_move_iterator(chunk_end_itr)};
+        auto records = factory.make(std::move(chunk));
+        erase_calls_outside_region(records, call_region);
+        utils::append(std::move(records), result);
+        chunk_begin_idx = chunk_end_idx;
+    }
+    return result;
+}
+
 } // namespace
 
-std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMeter& progress_meter) const
+Caller::CallingPrelude Caller::prepare_to_call(const GenomicRegion& call_region) const
 {
+    CallingPrelude result {call_region, {}, {}, boost::none, std::chrono::steady_clock::now()};
+    ScopedAllocationTag readpipe_alloc_tag {AllocationSubsystem::readpipe};
+    ScopedStageTimer candidate_stage_timer {StageProfiler::Stage::candidate_generation, contig_name(call_region)};
     resume(init_timer);
-    ReadMap reads;
     if (candidate_generator_.requires_reads()) {
-        reads = read_pipe_.get().fetch_reads(expand(call_region, 100));
-        add_reads(reads, candidate_generator_);
-        if (!refcalls_requested() && all_empty(reads)) {
+        result.reads = read_pipe_.get().fetch_reads(expand(call_region, 100));
+        add_reads(result.reads, candidate_generator_);
+        if (!refcalls_requested() && all_empty(result.reads)) {
             if (debug_log_) stream(*debug_log_) << "Stopping early as no reads found in call region " << call_region;
-            return {};
+            return result;
         }
-        if (debug_log_) stream(*debug_log_) << "Using " << count_reads(reads) << " reads in call region " << call_region;
+        if (debug_log_) stream(*debug_log_) << "Using " << count_reads(result.reads) << " reads in call region " << call_region;
+    }
+    const auto candidate_region = calculate_candidate_region(call_region, result.reads, reference_, candidate_generator_);
+    // Tell the shared reader where the calling frontier is so caching readers
+    // pin this window; the snapshot fetch below then doubles as the prefetch,
+    // running on the pipeline's prelude thread when windows are overlapped
+    reference_.get().hint_next_fetch_region(candidate_region);
+    // One read of the task window up front; haplotype construction and record
+    // formatting then take their reference context from local memory instead
+    // of contending on the shared reader
+    result.local_reference.emplace(std::make_unique<io::LocalReferenceCache>(reference_, candidate_region));
+    result.candidates = generate_candidate_variants(candidate_region);
+    if (debug_log_) debug::print_final_candidates(stream(*debug_log_), result.candidates, candidate_region);
+    if (!candidate_generator_.requires_reads() && (refcalls_requested() || !result.candidates.empty())) {
+        // as we didn't fetch them earlier
+        result.reads = read_pipe_.get().fetch_reads(call_region);
+    }
+    pause(init_timer);
+    return result;
+}
+
+std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMeter& progress_meter) const
+{
+    return call(prepare_to_call(call_region), progress_meter);
+}
+
+std::deque<VcfRecord> Caller::call(CallingPrelude prelude, ProgressMeter& progress_meter) const
+{
+    const auto& call_region = prelude.region;
+    if (!prelude.local_reference) {
+        return {}; // the prelude stopped early as the call region had no reads
     }
-    const auto candidate_region = calculate_candidate_region(call_region, reads, reference_, candidate_generator_);
-    auto candidates = generate_candidate_variants(candidate_region);
-    if (debug_log_) debug::print_final_candidates(stream(*debug_log_), candidates, candidate_region);
-    if (!refcalls_requested() && candidates.empty()) {
+    if (!refcalls_requested() && prelude.candidates.empty()) {
         progress_meter.log_completed(call_region);
         return {};
     }
-    if (!candidate_generator_.requires_reads()) {
-        // as we didn't fetch them earlier
-        reads = read_pipe_.get().fetch_reads(call_region);
+    const auto& local_reference = *prelude.local_reference;
+    auto calls = call_variants(call_region, prelude.candidates, prelude.reads, local_reference, progress_meter);
+    if (replay_bundle_writer_) {
+        const std::chrono::duration<double> call_duration {std::chrono::steady_clock::now() - prelude.start_time};
+        if (call_duration.count() >= replay_bundle_writer_->threshold_seconds()) {
+            try {
+                const auto bundle = replay_bundle_writer_->write(call_region, prelude.reads, prelude.candidates, reference_,
+                                                                 read_pipe_.get().read_manager().paths().front());
+                logging::InfoLogger log {};
+                stream(log) << "Captured replay bundle " << bundle.string() << " for " << call_region
+                            << " after " << call_duration.count() << "s";
+            } catch (const std::exception& e) {
+                logging::WarningLogger log {};
+                stream(log) << "Failed to capture replay bundle for " << call_region << ": " << e.what();
+            }
+        }
     }
-    pause(init_timer);
-    auto calls = call_variants(call_region, candidates, reads, progress_meter);
-    candidates.clear();
-    candidates.shrink_to_fit();
+    prelude.candidates.clear();
+    prelude.candidates.shrink_to_fit();
     progress_meter.log_completed(call_region);
-    const auto record_factory = make_record_factory(reads);
+    ScopedAllocationTag io_alloc_tag {AllocationSubsystem::io};
+    ScopedStageTimer output_stage_timer {StageProfiler::Stage::output, contig_name(call_region)};
+    const auto record_factory = make_record_factory(prelude.reads, local_reference);
     if (debug_log_) stream(*debug_log_) << "Converting " << calls.size() << " calls made in " << call_region << " to VCF";
+    if (refcalls_requested()) {
+        // With refcalls the call set covers the whole task region and dwarfs
+        // the plain VCF case, so conversion is streamed over the refcall runs
+        return convert_to_vcf_streamed(std::move(calls), record_factory, call_region);
+    }
     return convert_to_vcf(std::move(calls), record_factory, call_region);
 }
 
@@ -182,9 +312,10 @@ std::vector<VcfRecord> Caller::regenotype(const std::vector<Variant>& variants,
     return {}; // TODO
 }
 
-auto assign_and_realign(const std::vector<AlignedRead>& reads, const Genotype<Haplotype>& genotype)
+auto assign_and_realign(const std::vector<AlignedRead>& reads, const Genotype<Haplotype>& genotype,
+                        const CachedHaplotypeLikelihoods& cached_likelihoods)
 {
-    auto result = compute_haplotype_support(genotype, reads, {AssignmentConfig::AmbiguousAction::first});
+    auto result = compute_haplotype_support(genotype, reads, cached_likelihoods, {AssignmentConfig::AmbiguousAction::first});
     for (auto& p : result) realign_to_reference(p.second, p.first);
     return result;
 }
@@ -295,11 +426,28 @@ bool has_reference(const Container& haplotypes)
     return find_reference(haplotypes) != std::cend(haplotypes);
 }
 
+auto model_fit_digest(const std::vector<Haplotype>& haplotypes, const ReadMap& reads)
+{
+    std::size_t result {0};
+    const std::hash<Haplotype> haplotype_hash {};
+    for (const auto& haplotype : haplotypes) {
+        boost::hash_combine(result, haplotype_hash(haplotype));
+    }
+    const std::hash<AlignedRead> read_hash {};
+    for (const auto& p : reads) {
+        boost::hash_combine(result, std::hash<SampleName>{}(p.first));
+        for (const auto& read : p.second) {
+            boost::hash_combine(result, read_hash(read));
+        }
+    }
+    return result;
+}
+
 } // namespace
 
 std::deque<CallWrapper>
 Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Variant>& candidates,
-                      const ReadMap& reads, ProgressMeter& progress_meter) const
+                      const ReadMap& reads, const ReferenceGenome& reference, ProgressMeter& progress_meter) const
 {
     std::deque<CallWrapper> result {};
     auto haplotype_likelihoods = make_haplotype_likelihood_cache();
@@ -310,16 +458,34 @@ Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Va
         progress_meter.log_completed(call_region);
         return result;
     }
-    auto haplotype_generator = make_haplotype_generator(candidates, reads);
+    auto haplotype_generator = make_haplotype_generator(candidates, reads, reference);
     GeneratorStatus status;
     std::vector<Haplotype> haplotypes {}, next_haplotypes {};
     GenomicRegion active_region;
     boost::optional<GenomicRegion> next_active_region {}, prev_called_region {};
+    boost::optional<GenomicRegion> likelihood_cache_region {};
     auto completed_region = head_region(call_region);
     std::deque<Haplotype> protected_haplotypes {};
+    // The generator can backtrack and re-present an identical haplotype set for the
+    // same reads (common around dense indels), so completed fits are memoised by
+    // (haplotypes, reads) digest. Each entry owns the haplotypes and reads it was
+    // fitted against: the latents reference the entry's own vector rather than the
+    // loop's working set, and a digest hit is only honoured after the stored key
+    // compares equal, so a hash collision can never reuse a foreign fit
+    struct CachedModelFit
+    {
+        std::vector<Haplotype> haplotypes;
+        ReadMap reads;
+        std::shared_ptr<Latents> latents;
+    };
+    std::unordered_map<std::size_t, CachedModelFit> latents_cache {};
     while (true) {
-        status = generate_active_haplotypes(call_region, haplotype_generator, active_region,
-                                            next_active_region, haplotypes, next_haplotypes);
+        {
+            ScopedAllocationTag hapgen_alloc_tag {AllocationSubsystem::hapgen};
+            ScopedStageTimer haplotype_stage_timer {StageProfiler::Stage::haplotype_generation, contig_name(call_region)};
+            status = generate_active_haplotypes(call_region, haplotype_generator, active_region,
+                                                next_active_region, haplotypes, next_haplotypes);
+        }
         if (status == GeneratorStatus::done) {
             if (refcalls_requested()) {
                 if (!prev_called_region) {
@@ -343,11 +509,20 @@ Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Va
             continue;
         }
         if (debug_log_) stream(*debug_log_) << "There are " << count_reads(active_reads) << " active reads in " << active_region;
+        // Likelihoods of haplotypes scored in the previous pass can only be reused
+        // if the active reads - and hence the flank state - are unchanged
+        if (likelihood_cache_region && *likelihood_cache_region != active_region) {
+            haplotype_likelihoods.clear();
+        }
+        // Cheap kmer-similarity screen so clearly unsupported haplotypes never
+        // reach the HMM
+        prefilter_haplotypes(haplotypes, haplotype_generator, haplotype_likelihoods, active_reads, protected_haplotypes);
         if (!populate(haplotype_likelihoods, active_region, haplotypes, candidates, active_reads)) {
             haplotype_generator.clear_progress();
             haplotype_likelihoods.clear();
             continue;
         }
+        likelihood_cache_region = active_region;
         if (!protected_haplotypes.empty()) {
             assert(!haplotypes.empty());
             std::sort(std::begin(haplotypes), std::end(haplotypes));
@@ -363,7 +538,25 @@ Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Va
         auto has_removal_impact = filter_haplotypes(haplotypes, haplotype_generator, haplotype_likelihoods, protected_haplotypes);
         if (haplotypes.empty()) continue;
         resume(latent_timer);
-        const auto caller_latents = infer_latents(haplotypes, haplotype_likelihoods);
+        ScopedAllocationTag models_alloc_tag {AllocationSubsystem::models};
+        ScopedStageTimer model_fit_stage_timer {StageProfiler::Stage::model_fitting, contig_name(call_region)};
+        const auto fit_digest = model_fit_digest(haplotypes, active_reads);
+        std::shared_ptr<Latents> caller_latents {};
+        const auto cached_latents_itr = latents_cache.find(fit_digest);
+        if (cached_latents_itr != std::cend(latents_cache)
+            && cached_latents_itr->second.haplotypes == haplotypes
+            && cached_latents_itr->second.reads == active_reads) {
+            if (debug_log_) stream(*debug_log_) << "Reusing cached model fit for " << active_region;
+            caller_latents = cached_latents_itr->second.latents;
+        } else {
+            CachedModelFit fit {haplotypes, active_reads, nullptr};
+            // Fit against the entry's own copy so the latents stay valid after the
+            // working vector is reassigned; all latents lookups compare by value
+            caller_latents = infer_latents(fit.haplotypes, haplotype_likelihoods);
+            fit.latents = caller_latents;
+            latents_cache[fit_digest] = std::move(fit);
+        }
+        model_fit_stage_timer.stop();
         pause(latent_timer);
         if (trace_log_) {
             debug::print_haplotype_posteriors(stream(*trace_log_), *caller_latents->haplotype_posteriors(), -1);
@@ -390,7 +583,7 @@ Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Va
         call_variants(active_region, call_region, next_active_region, backtrack_region,
                       candidates, haplotypes, haplotype_likelihoods, active_reads, *caller_latents,
                       result, prev_called_region, completed_region);
-        haplotype_likelihoods.clear();
+        // The cache is kept so that haplotypes regenerated in the next pass need not be rescored
         progress_meter.log_completed(completed_region);
     }
     return result;
@@ -401,6 +594,11 @@ std::size_t Caller::do_remove_duplicates(std::vector<Haplotype>& haplotypes) con
     return octopus::remove_duplicates(haplotypes, Haplotype {haplotype_region(haplotypes), reference_.get()});
 }
 
+ThreadPool* Caller::evaluation_workers() const noexcept
+{
+    return evaluation_workers_.get();
+}
+
 Caller::GeneratorStatus
 Caller::generate_active_haplotypes(const GenomicRegion& call_region,
                                    HaplotypeGenerator& haplotype_generator,
@@ -457,6 +655,104 @@ void Caller::remove_duplicates(std::vector<Haplotype>& haplotypes) const
             stream(*debug_log_) << "There are no duplicate haplotypes";
         }
     }
+    if (parameters_.collapse_near_duplicate_haplotypes && haplotypes.size() > 1) {
+        const IsLessComplex cmp {Haplotype {haplotype_region(haplotypes), reference_.get()}};
+        const auto num_collapsed = collapse_near_duplicates(haplotypes, cmp);
+        if (debug_log_) {
+            stream(*debug_log_) << num_collapsed << " near-duplicate haplotypes were collapsed";
+        }
+    }
+}
+
+namespace {
+
+// Best-offset kmer hit counts between each read and the haplotype - the same
+// mapping the likelihood model uses to seed HMM alignments, without the HMM
+auto count_haplotype_kmer_hits(const std::vector<KmerPerfectHashes>& read_hashes, const Haplotype& haplotype)
+{
+    static constexpr unsigned char mapperKmerSize {6};
+    auto& haplotype_hashes = thread_local_kmer_hash_table<mapperKmerSize>();
+    populate_kmer_hash_table<mapperKmerSize>(haplotype.sequence(), haplotype_hashes);
+    auto mapping_counts = init_mapping_counts(haplotype_hashes);
+    std::vector<unsigned> result(read_hashes.size());
+    std::transform(std::cbegin(read_hashes), std::cend(read_hashes), std::begin(result),
+                   [&] (const auto& query) {
+                       const auto hits = max_query_to_target_hits(query, haplotype_hashes, mapping_counts);
+                       reset_mapping_counts(mapping_counts);
+                       return hits;
+                   });
+    return result;
+}
+
+} // namespace
+
+void Caller::prefilter_haplotypes(std::vector<Haplotype>& haplotypes,
+                                  HaplotypeGenerator& haplotype_generator,
+                                  HaplotypeLikelihoodCache& haplotype_likelihoods,
+                                  const ReadMap& active_reads,
+                                  const std::deque<Haplotype>& protected_haplotypes) const
+{
+    static constexpr unsigned char mapperKmerSize {6};
+    // One mismatched base breaks up to kmer-size shared kmers, so scores within
+    // this slack of a read's best haplotype count as ties
+    static constexpr unsigned kmerHitSlack {mapperKmerSize};
+    static constexpr std::size_t minHaplotypesToPrefilter {50};
+    if (haplotypes.size() <= minHaplotypesToPrefilter) return;
+    std::vector<KmerPerfectHashes> read_hashes {};
+    read_hashes.reserve(count_reads(active_reads));
+    for (const auto& p : active_reads) {
+        for (const auto& read : p.second) {
+            read_hashes.push_back(compute_kmer_hashes<mapperKmerSize>(read.sequence()));
+        }
+    }
+    if (read_hashes.empty()) return;
+    std::vector<std::vector<unsigned>> hit_counts {};
+    hit_counts.reserve(haplotypes.size());
+    std::vector<unsigned> best_hit_counts(read_hashes.size(), 0);
+    for (const auto& haplotype : haplotypes) {
+        hit_counts.push_back(count_haplotype_kmer_hits(read_hashes, haplotype));
+        std::transform(std::cbegin(hit_counts.back()), std::cend(hit_counts.back()),
+                       std::cbegin(best_hit_counts), std::begin(best_hit_counts),
+                       [] (const auto lhs, const auto rhs) { return std::max(lhs, rhs); });
+    }
+    std::vector<Haplotype> protected_copies {std::cbegin(protected_haplotypes), std::cend(protected_haplotypes)};
+    for (auto& haplotype : protected_copies) {
+        haplotype = remap(haplotype, haplotype_region(haplotypes));
+    }
+    std::vector<Haplotype> kept_haplotypes {}, removed_haplotypes {};
+    kept_haplotypes.reserve(haplotypes.size());
+    for (std::size_t haplotype_idx {0}; haplotype_idx < haplotypes.size(); ++haplotype_idx) {
+        auto& haplotype = haplotypes[haplotype_idx];
+        const auto& counts = hit_counts[haplotype_idx];
+        // A haplotype is hopeless if no read prefers it, even approximately -
+        // every read maps better onto some other haplotype. The true haplotypes
+        // keep their supporting reads' best scores, so they can never all be
+        // filtered here
+        bool hopeless {true};
+        for (std::size_t read_idx {0}; read_idx < counts.size(); ++read_idx) {
+            if (counts[read_idx] + kmerHitSlack >= best_hit_counts[read_idx]) {
+                hopeless = false;
+                break;
+            }
+        }
+        if (hopeless && !is_reference(haplotype)
+            && std::find(std::cbegin(protected_copies), std::cend(protected_copies), haplotype) == std::cend(protected_copies)) {
+            removed_haplotypes.push_back(std::move(haplotype));
+        } else {
+            kept_haplotypes.push_back(std::move(haplotype));
+        }
+    }
+    if (removed_haplotypes.empty()) return;
+    if (debug_log_) {
+        stream(*debug_log_) << "Removing " << removed_haplotypes.size()
+                            << " haplotypes without kmer support before likelihood calculation";
+    }
+    haplotypes = std::move(kept_haplotypes);
+    haplotype_likelihoods.erase(removed_haplotypes);
+    if (haplotype_generator.removal_has_impact()) {
+        haplotype_generator.remove(removed_haplotypes);
+        haplotype_generator.collapse(haplotypes);
+    }
 }
 
 bool Caller::filter_haplotypes(std::vector<Haplotype>& haplotypes,
@@ -685,7 +981,11 @@ void Caller::call_variants(const GenomicRegion& active_region,
         if (!active_candidates.empty()) {
             if (debug_log_) stream(*debug_log_) << "Calling variants in region " << uncalled_region;
             resume(calling_timer);
-            calls = wrap(call_variants(active_candidates, latents));
+            {
+                ScopedAllocationTag models_alloc_tag {AllocationSubsystem::models};
+                ScopedStageTimer calling_stage_timer {StageProfiler::Stage::calling, contig_name(call_region)};
+                calls = wrap(call_variants(active_candidates, latents));
+            }
             pause(calling_timer);
             if (!calls.empty()) {
                 set_model_posteriors(calls, latents, haplotypes, haplotype_likelihoods);
@@ -694,7 +994,7 @@ void Caller::call_variants(const GenomicRegion& active_region,
         }
         if (refcalls_requested()) {
             const auto refcall_region = right_overhang_region(uncalled_region, completed_region);
-            const auto pileups = make_pileups(reads, latents, refcall_region);
+            const auto pileups = make_pileups(reads, latents, haplotype_likelihoods, refcall_region);
             auto alleles = generate_reference_alleles(refcall_region, active_candidates, calls);
             auto reference_calls = wrap(call_reference(alleles, latents, pileups));
             const auto itr = utils::append(std::move(reference_calls), calls);
@@ -706,14 +1006,23 @@ void Caller::call_variants(const GenomicRegion& active_region,
     }
 }
 
+const Genotype<Haplotype>& Caller::Latents::max_posterior_genotype(const SampleName& sample) const
+{
+    auto table_itr = max_posterior_genotypes_.find(sample);
+    if (table_itr == std::cend(max_posterior_genotypes_)) {
+        const auto genotype_posteriors_ptr = genotype_posteriors();
+        const auto& sample_posteriors = (*genotype_posteriors_ptr)[sample];
+        auto itr = std::max_element(std::cbegin(sample_posteriors), std::cend(sample_posteriors),
+                                    [] (const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; });
+        assert(itr != std::cend(sample_posteriors));
+        table_itr = max_posterior_genotypes_.emplace(sample, itr->first).first;
+    }
+    return table_itr->second;
+}
+
 Genotype<Haplotype> Caller::call_genotype(const Latents& latents, const SampleName& sample) const
 {
-    const auto genotype_posteriors_ptr = latents.genotype_posteriors();
-    const auto& genotype_posteriors = (*genotype_posteriors_ptr)[sample];
-    auto itr = std::max_element(std::cbegin(genotype_posteriors), std::cend(genotype_posteriors),
-                                [] (const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; });
-    assert(itr != std::cend(genotype_posteriors));
-    return itr->first;
+    return latents.max_posterior_genotype(sample);
 }
 
 std::deque<Haplotype> Caller::get_called_haplotypes(const Latents& latents) const
@@ -805,11 +1114,15 @@ void Caller::set_phasing(std::vector<CallWrapper>& calls, const Latents& latents
                          const GenomicRegion& call_region) const
 {
     resume(phasing_timer);
-    const auto phase = phaser_.force_phase(haplotypes, *latents.genotype_posteriors(),
-                                           extract_regions(calls), get_genotype_calls(latents));
-    pause(phasing_timer);
-    if (debug_log_) debug::print_phase_sets(stream(*debug_log_), phase);
-    octopus::set_phasing(calls, phase, call_region);
+    {
+        ScopedAllocationTag models_alloc_tag {AllocationSubsystem::models};
+        ScopedStageTimer phasing_stage_timer {StageProfiler::Stage::phasing, contig_name(call_region)};
+        const auto phase = phaser_.force_phase(haplotypes, *latents.genotype_posteriors(),
+                                               extract_regions(calls), get_genotype_calls(latents));
+        pause(phasing_timer);
+        if (debug_log_) debug::print_phase_sets(stream(*debug_log_), phase);
+        octopus::set_phasing(calls, phase, call_region);
+    }
 }
 
 bool Caller::refcalls_requested() const noexcept
@@ -840,19 +1153,34 @@ MappableFlatSet<Variant> Caller::generate_candidate_variants(const GenomicRegion
 }
 
 HaplotypeGenerator Caller::make_haplotype_generator(const MappableFlatSet<Variant>& candidates,
-                                                    const ReadMap& reads) const
+                                                    const ReadMap& reads, const ReferenceGenome& reference) const
 {
-    return haplotype_generator_builder_.build(reference_, candidates, reads);
+    auto result = haplotype_generator_builder_.build(reference, candidates, reads);
+    if (evaluation_workers_ && !evaluation_workers_->empty()) {
+        result.enable_parallel_holdout_search(*evaluation_workers_);
+    }
+    return result;
 }
 
 HaplotypeLikelihoodCache Caller::make_haplotype_likelihood_cache() const
 {
-    return HaplotypeLikelihoodCache {likelihood_model_, parameters_.max_haplotypes, samples_};
+    HaplotypeLikelihoodCache result {likelihood_model_, parameters_.max_haplotypes, samples_};
+    if (evaluation_workers_ && !evaluation_workers_->empty()) {
+        result.enable_parallel_evaluation(*evaluation_workers_);
+    }
+    if (likelihood_cache_budget_ && likelihood_cache_spill_directory_) {
+        result.set_memory_budget(*likelihood_cache_budget_, *likelihood_cache_spill_directory_);
+    }
+    return result;
 }
 
-VcfRecordFactory Caller::make_record_factory(const ReadMap& reads) const
+VcfRecordFactory Caller::make_record_factory(const ReadMap& reads, const ReferenceGenome& reference) const
 {
-    return VcfRecordFactory {reference_, reads, samples_, parameters_.call_sites_only};
+    VcfRecordFactory result {reference, reads, samples_, parameters_.call_sites_only};
+    if (evaluation_workers_ && !evaluation_workers_->empty()) {
+        result.enable_parallel_conversion(*evaluation_workers_);
+    }
+    return result;
 }
 
 auto calculate_flank_regions(const GenomicRegion& haplotype_region,
@@ -900,7 +1228,8 @@ bool Caller::populate(HaplotypeLikelihoodCache& haplotype_likelihoods,
                       const MappableFlatSet<Variant>& candidates,
                       const ReadMap& active_reads) const
 {
-    assert(haplotype_likelihoods.is_empty());
+    ScopedAllocationTag models_alloc_tag {AllocationSubsystem::models};
+    ScopedStageTimer likelihood_stage_timer {StageProfiler::Stage::likelihood_calculation, contig_name(active_region)};
     boost::optional<HaplotypeLikelihoodCache::FlankState> flank_state {};
     if (debug_log_) {
         stream(*debug_log_) << "Calculating likelihoods for " << haplotypes.size() << " haplotypes";
@@ -916,7 +1245,25 @@ bool Caller::populate(HaplotypeLikelihoodCache& haplotype_likelihoods,
     }
     try {
         resume(haplotype_likelihood_timer);
-        haplotype_likelihoods.populate(active_reads, haplotypes, std::move(flank_state));
+        bool replayed {false};
+        if (likelihood_checkpoint_) {
+            replayed = likelihood_checkpoint_->load(active_region, haplotypes, active_reads,
+                                                    flank_state, haplotype_likelihoods);
+            if (replayed && debug_log_) {
+                stream(*debug_log_) << "Replayed haplotype likelihoods for " << active_region << " from checkpoint";
+            }
+        }
+        if (!replayed) {
+            if (haplotype_likelihoods.is_empty()) {
+                haplotype_likelihoods.populate(active_reads, haplotypes, flank_state);
+            } else {
+                haplotype_likelihoods.update(active_reads, haplotypes, flank_state);
+            }
+            if (likelihood_checkpoint_) {
+                likelihood_checkpoint_->save(active_region, haplotypes, active_reads,
+                                             flank_state, haplotype_likelihoods);
+            }
+        }
         pause(haplotype_likelihood_timer);
     } catch(const HaplotypeLikelihoodModel::ShortHaplotypeError& e) {
         if (debug_log_) {
@@ -1031,16 +1378,53 @@ bool Caller::done_calling(const GenomicRegion& region) const noexcept
     return is_empty(region);
 }
 
+std::vector<std::unique_ptr<ReferenceCall>>
+Caller::call_reference(const std::vector<Allele>& alleles, const ReadPileupMap& pileups) const
+{
+    return {};
+}
+
+namespace {
+
+bool supports_only_reference(const ReadPileups& pileups, const ReferenceGenome::GeneticSequence& ref_sequence)
+{
+    assert(pileups.size() == ref_sequence.size());
+    ReadPileup::NucleotideSequence ref_base(1, 'A');
+    for (std::size_t i {0}; i < pileups.size(); ++i) {
+        ref_base.front() = ref_sequence[i];
+        if (pileups[i].depth(ref_base) != pileups[i].depth()) return false;
+    }
+    return true;
+}
+
+} // namespace
+
 std::vector<CallWrapper> Caller::call_reference(const GenomicRegion& region, const ReadMap& reads) const
 {
     const auto active_reads = copy_overlapped(reads, region);
+    if (has_closed_form_reference_model()) {
+        // With no candidates the latents cannot support variation, so when the
+        // raw pileups agree with the reference everywhere the caller's closed
+        // form gives the same confidences without any likelihood inference
+        ReadPileupMap raw_pileups {};
+        raw_pileups.reserve(samples_.size());
+        for (const auto& sample : samples_) {
+            raw_pileups.emplace(sample, octopus::make_pileups(active_reads.at(sample), region));
+        }
+        const auto ref_sequence = reference_.get().fetch_sequence(region);
+        const auto is_clean = [&] (const auto& sample) { return supports_only_reference(raw_pileups.at(sample), ref_sequence); };
+        if (std::all_of(std::cbegin(samples_), std::cend(samples_), is_clean)) {
+            const auto alleles = generate_reference_alleles(region);
+            return wrap(call_reference(alleles, raw_pileups));
+        }
+    }
     const auto active_reads_region = encompassing_region(active_reads);
     const auto haplotype_region = expand(active_reads_region, HaplotypeLikelihoodModel{}.pad_requirement());
     const std::vector<Haplotype> haplotypes {{haplotype_region, reference_}};
     auto haplotype_likelihoods = make_haplotype_likelihood_cache();
     haplotype_likelihoods.populate(active_reads, haplotypes);
     const auto latents = infer_latents(haplotypes, haplotype_likelihoods);
-    const auto pileups = make_pileups(active_reads, *latents, region);
+    const auto pileups = make_pileups(active_reads, *latents, haplotype_likelihoods, region);
     const auto alleles = generate_reference_alleles(region);
     return wrap(call_reference(alleles, *latents, pileups));
 }
@@ -1138,9 +1522,10 @@ auto overlap_range(std::vector<ReadPileup>& pileups, const AlignedRead& read)
 
 } // namespace
 
-auto make_pileups(const std::vector<AlignedRead>& reads, const Genotype<Haplotype>& genotype, const GenomicRegion& region)
+auto make_pileups(const std::vector<AlignedRead>& reads, const Genotype<Haplotype>& genotype,
+                  const CachedHaplotypeLikelihoods& cached_likelihoods, const GenomicRegion& region)
 {
-    const auto realignments = assign_and_realign(reads, genotype);
+    const auto realignments = assign_and_realign(reads, genotype, cached_likelihoods);
     ReadPileups result {};
     result.reserve(size(region));
     for (auto position = region.begin(); position < region.end(); ++position) {
@@ -1156,19 +1541,23 @@ auto make_pileups(const std::vector<AlignedRead>& reads, const Genotype<Haplotyp
     return result;
 }
 
-auto make_pileups(const ReadContainer& reads, const Genotype<Haplotype>& genotype, const GenomicRegion& region)
+auto make_pileups(const ReadContainer& reads, const Genotype<Haplotype>& genotype,
+                  const CachedHaplotypeLikelihoods& cached_likelihoods, const GenomicRegion& region)
 {
     const std::vector<AlignedRead> copy {std::cbegin(reads), std::cend(reads)};
-    return make_pileups(copy, genotype, region);
+    return make_pileups(copy, genotype, cached_likelihoods, region);
 }
 
-Caller::ReadPileupMap Caller::make_pileups(const ReadMap& reads, const Latents& latents, const GenomicRegion& region) const
+Caller::ReadPileupMap Caller::make_pileups(const ReadMap& reads, const Latents& latents,
+                                           const HaplotypeLikelihoodCache& haplotype_likelihoods,
+                                           const GenomicRegion& region) const
 {
     ReadPileupMap result {};
     result.reserve(samples_.size());
     for (const auto& sample : samples_) {
         const auto called_genotype = call_genotype(latents, sample);
-        result.emplace(sample, octopus::make_pileups(reads.at(sample), called_genotype, region));
+        const CachedHaplotypeLikelihoods cached_likelihoods {haplotype_likelihoods, sample, reads.at(sample)};
+        result.emplace(sample, octopus::make_pileups(reads.at(sample), called_genotype, cached_likelihoods, region));
     }
     return result;
 }
@@ -9,6 +9,7 @@
 #include <functional>
 #include <memory>
 #include <deque>
+#include <chrono>
 #include <typeindex>
 #include <set>
 
@@ -22,8 +23,11 @@
 #include "core/types/haplotype.hpp"
 #include "core/tools/coretools.hpp"
 #include "core/models/haplotype_likelihood_cache.hpp"
+#include "core/models/haplotype_likelihood_checkpoint.hpp"
+#include "core/tools/replay_bundle.hpp"
 #include "containers/mappable_flat_set.hpp"
 #include "containers/probability_matrix.hpp"
+#include "utils/thread_pool.hpp"
 #include "logging/progress_meter.hpp"
 #include "logging/logging.hpp"
 #include "io/variant/vcf_record.hpp"
@@ -69,6 +73,24 @@ public:
     
     std::deque<VcfRecord> call(const GenomicRegion& call_region, ProgressMeter& progress_meter) const;
     
+    // Everything call does before the model fit: the read fetch, candidate
+    // generation, and local reference snapshot for one region. The prelude
+    // touches only internally synchronised shared components, so the next
+    // region's prelude can be prepared on another thread while this region's
+    // model is being fitted. Preludes must be prepared one at a time as
+    // candidate generation uses per-caller state
+    struct CallingPrelude
+    {
+        GenomicRegion region;
+        ReadMap reads;
+        MappableFlatSet<Variant> candidates;
+        boost::optional<ReferenceGenome> local_reference;
+        std::chrono::steady_clock::time_point start_time;
+    };
+    
+    CallingPrelude prepare_to_call(const GenomicRegion& call_region) const;
+    std::deque<VcfRecord> call(CallingPrelude prelude, ProgressMeter& progress_meter) const;
+    
     std::vector<VcfRecord> regenotype(const std::vector<Variant>& variants, ProgressMeter& progress_meter) const;
     
 protected:
@@ -93,6 +115,15 @@ protected:
         // we avoid copying.
         virtual std::shared_ptr<HaplotypeProbabilityMap> haplotype_posteriors() const = 0;
         virtual std::shared_ptr<GenotypeProbabilityMap> genotype_posteriors() const = 0;
+        
+        // The modal genotype of each sample, reduced lazily from genotype_posteriors().
+        // Calling, phasing, and pileup generation all need this reduction, and keeping
+        // the table with the latents means reusing a cached model fit also reuses it.
+        // Not synchronised - queries must come from the thread running the caller.
+        const Genotype<Haplotype>& max_posterior_genotype(const SampleName& sample) const;
+        
+    private:
+        mutable std::unordered_map<SampleName, Genotype<Haplotype>> max_posterior_genotypes_;
     };
     
 public:
@@ -104,6 +135,18 @@ public:
         HaplotypeGenerator::Builder haplotype_generator_builder;
         HaplotypeLikelihoodModel likelihood_model;
         Phaser phaser;
+        // May be shared between callers; haplotype likelihood evaluation is
+        // sharded between the pool's threads when set
+        std::shared_ptr<ThreadPool> evaluation_workers;
+        // When set, likelihood matrices beyond this footprint are backed by
+        // memory mapped files in the spill directory
+        boost::optional<MemoryFootprint> likelihood_cache_budget;
+        boost::optional<boost::filesystem::path> likelihood_cache_spill_directory;
+        // Shared between callers; records or replays per-region HMM scores
+        std::shared_ptr<HaplotypeLikelihoodCheckpoint> likelihood_checkpoint;
+        // Shared between callers; captures replay bundles for regions that
+        // breach its wall time threshold
+        std::shared_ptr<ReplayBundleWriter> replay_bundle_writer;
     };
     
     struct Parameters
@@ -114,6 +157,7 @@ public:
         Phred<double> haplotype_extension_threshold, saturation_limit;
         bool allow_model_filtering;
         bool protect_reference_haplotype;
+        bool collapse_near_duplicate_haplotypes;
     };
     
 private:
@@ -127,6 +171,11 @@ private:
     HaplotypeLikelihoodModel likelihood_model_;
     Phaser phaser_;
     Parameters parameters_;
+    std::shared_ptr<ThreadPool> evaluation_workers_;
+    boost::optional<MemoryFootprint> likelihood_cache_budget_;
+    boost::optional<boost::filesystem::path> likelihood_cache_spill_directory_;
+    std::shared_ptr<HaplotypeLikelihoodCheckpoint> likelihood_checkpoint_;
+    std::shared_ptr<ReplayBundleWriter> replay_bundle_writer_;
     
     // virtual methods
     
@@ -137,7 +186,11 @@ private:
 
 protected:
     virtual std::size_t do_remove_duplicates(std::vector<Haplotype>& haplotypes) const;
-    
+
+    // The shared evaluation pool, if any; derived callers may use it to
+    // parallelise their own model evaluation
+    ThreadPool* evaluation_workers() const noexcept;
+
     using ReadPileupMap = std::unordered_map<SampleName, ReadPileups>;
 
 private:
@@ -159,16 +212,27 @@ private:
     call_reference(const std::vector<Allele>& alleles, const Latents& latents,
                    const ReadPileupMap& pileups) const = 0;
     
+    // Callers whose reference model reduces to a closed form when the pileups
+    // hold no non-reference evidence can override these so that clean refcall
+    // stretches skip exact likelihood inference
+    virtual bool has_closed_form_reference_model() const noexcept { return false; }
+    virtual std::vector<std::unique_ptr<ReferenceCall>>
+    call_reference(const std::vector<Allele>& alleles, const ReadPileupMap& pileups) const;
+    
     // helper methods
     
     std::deque<CallWrapper>
     call_variants(const GenomicRegion& call_region,  const MappableFlatSet<Variant>& candidates,
-                  const ReadMap& reads, ProgressMeter& progress_meter) const;
+                  const ReadMap& reads, const ReferenceGenome& reference, ProgressMeter& progress_meter) const;
     bool refcalls_requested() const noexcept;
     MappableFlatSet<Variant> generate_candidate_variants(const GenomicRegion& region) const;
-    HaplotypeGenerator make_haplotype_generator(const MappableFlatSet<Variant>& candidates, const ReadMap& reads) const;
+    HaplotypeGenerator make_haplotype_generator(const MappableFlatSet<Variant>& candidates, const ReadMap& reads,
+                                                const ReferenceGenome& reference) const;
     HaplotypeLikelihoodCache make_haplotype_likelihood_cache() const;
-    VcfRecordFactory make_record_factory(const ReadMap& reads) const;
+    VcfRecordFactory make_record_factory(const ReadMap& reads, const ReferenceGenome& reference) const;
+    void prefilter_haplotypes(std::vector<Haplotype>& haplotypes, HaplotypeGenerator& haplotype_generator,
+                              HaplotypeLikelihoodCache& haplotype_likelihoods, const ReadMap& active_reads,
+                              const std::deque<Haplotype>& protected_haplotypes) const;
     std::vector<Haplotype>
     filter(std::vector<Haplotype>& haplotypes, const HaplotypeLikelihoodCache& haplotype_likelihoods,
            const std::deque<Haplotype>& protected_haplotypes) const;
@@ -217,7 +281,9 @@ private:
                                const std::vector<Variant>& candidates,
                                const std::vector<CallWrapper>& calls) const;
     std::vector<Allele> generate_reference_alleles(const GenomicRegion& region) const;
-    ReadPileupMap make_pileups(const ReadMap& reads, const Latents& latents, const GenomicRegion& region) const;
+    ReadPileupMap make_pileups(const ReadMap& reads, const Latents& latents,
+                               const HaplotypeLikelihoodCache& haplotype_likelihoods,
+                               const GenomicRegion& region) const;
 };
 
 } // namespace octopus
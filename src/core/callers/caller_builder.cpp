@@ -15,7 +15,7 @@ namespace octopus {
 
 CallerBuilder::CallerBuilder(const ReferenceGenome& reference, const ReadPipe& read_pipe,
                              VariantGeneratorBuilder vgb, HaplotypeGenerator::Builder hgb)
-: components_ {reference, read_pipe, std::move(vgb), std::move(hgb), HaplotypeLikelihoodModel {}, Phaser {}}
+: components_ {reference, read_pipe, std::move(vgb), std::move(hgb), HaplotypeLikelihoodModel {}, Phaser {}, nullptr, boost::none, boost::none, nullptr, nullptr}
 , params_ {}
 , factory_ {}
 {
@@ -25,6 +25,7 @@ CallerBuilder::CallerBuilder(const ReferenceGenome& reference, const ReadPipe& r
     params_.general.haplotype_extension_threshold = Phred<> {150.0};
     params_.general.saturation_limit = Phred<> {10.0};
     params_.general.max_haplotypes = 200;
+    params_.general.collapse_near_duplicate_haplotypes = false;
     factory_ = generate_factory();
 }
 
@@ -109,6 +110,12 @@ CallerBuilder& CallerBuilder::set_reference_haplotype_protection(bool b) noexcep
     return *this;
 }
 
+CallerBuilder& CallerBuilder::set_near_duplicate_haplotype_collapse(bool b) noexcept
+{
+    params_.general.collapse_near_duplicate_haplotypes = b;
+    return *this;
+}
+
 CallerBuilder& CallerBuilder::set_min_variant_posterior(Phred<double> posterior) noexcept
 {
     params_.min_variant_posterior = posterior;
@@ -175,6 +182,50 @@ CallerBuilder& CallerBuilder::set_likelihood_model(HaplotypeLikelihoodModel mode
     return *this;
 }
 
+CallerBuilder& CallerBuilder::set_max_evaluation_threads(boost::optional<unsigned> n)
+{
+    // As with filtering, no request means let the application decide
+    const auto num_cores = std::thread::hardware_concurrency();
+    unsigned num_workers {0};
+    if (n) {
+        if (*n > 1) {
+            num_workers = num_cores > 0 ? std::min(*n, num_cores) : *n;
+        }
+    } else {
+        num_workers = num_cores > 0 ? num_cores : 8;
+    }
+    if (num_workers > 1) {
+        components_.evaluation_workers = std::make_shared<ThreadPool>(num_workers);
+    } else {
+        components_.evaluation_workers = nullptr;
+    }
+    return *this;
+}
+
+std::shared_ptr<ThreadPool> CallerBuilder::evaluation_workers() const noexcept
+{
+    return components_.evaluation_workers;
+}
+
+CallerBuilder& CallerBuilder::set_likelihood_cache_memory_budget(MemoryFootprint budget, boost::filesystem::path spill_directory)
+{
+    components_.likelihood_cache_budget = budget;
+    components_.likelihood_cache_spill_directory = std::move(spill_directory);
+    return *this;
+}
+
+CallerBuilder& CallerBuilder::set_likelihood_checkpoint(std::shared_ptr<HaplotypeLikelihoodCheckpoint> checkpoint) noexcept
+{
+    components_.likelihood_checkpoint = std::move(checkpoint);
+    return *this;
+}
+
+CallerBuilder& CallerBuilder::set_replay_bundle_writer(std::shared_ptr<ReplayBundleWriter> writer) noexcept
+{
+    components_.replay_bundle_writer = std::move(writer);
+    return *this;
+}
+
 CallerBuilder& CallerBuilder::set_model_based_haplotype_dedup(bool use) noexcept
 {
     params_.deduplicate_haplotypes_with_caller_model = use;
@@ -249,6 +300,12 @@ CallerBuilder& CallerBuilder::set_trio(Trio trio)
     return *this;
 }
 
+CallerBuilder& CallerBuilder::set_pedigree(Pedigree pedigree)
+{
+    params_.pedigree = std::move(pedigree);
+    return *this;
+}
+
 CallerBuilder& CallerBuilder::set_min_denovo_posterior(Phred<double> posterior) noexcept
 {
     params_.min_denovo_posterior = posterior;
@@ -292,7 +349,12 @@ Caller::Components CallerBuilder::make_components() const
         components_.variant_generator_builder.build(components_.reference),
         components_.haplotype_generator_builder,
         components_.likelihood_model,
-        Phaser {params_.min_phase_score}
+        Phaser {params_.min_phase_score},
+        components_.evaluation_workers,
+        components_.likelihood_cache_budget,
+        components_.likelihood_cache_spill_directory,
+        components_.likelihood_checkpoint,
+        components_.replay_bundle_writer
     };
 }
 
@@ -364,6 +426,7 @@ CallerBuilder::CallerFactoryMap CallerBuilder::generate_factory() const
                                                           get_ploidies(samples, *requested_contig_, params_.ploidies),
                                                           make_population_prior_model(params_.snp_heterozygosity, params_.indel_heterozygosity),
                                                           params_.max_joint_genotypes,
+                                                          params_.pedigree,
                                                           params_.use_independent_genotype_priors,
                                                           params_.deduplicate_haplotypes_with_caller_model
                                                       });
@@ -50,6 +50,7 @@ public:
     CallerBuilder& set_refcall_type(Caller::RefCallType type) noexcept;
     CallerBuilder& set_sites_only() noexcept;
     CallerBuilder& set_reference_haplotype_protection(bool b) noexcept;
+    CallerBuilder& set_near_duplicate_haplotype_collapse(bool b) noexcept;
     CallerBuilder& set_min_variant_posterior(Phred<double> posterior) noexcept;
     CallerBuilder& set_min_refcall_posterior(Phred<double> posterior) noexcept;
     CallerBuilder& set_max_haplotypes(unsigned n) noexcept;
@@ -61,6 +62,11 @@ public:
     CallerBuilder& set_max_genotypes(unsigned max) noexcept;
     CallerBuilder& set_max_joint_genotypes(unsigned max) noexcept;
     CallerBuilder& set_likelihood_model(HaplotypeLikelihoodModel model) noexcept;
+    CallerBuilder& set_max_evaluation_threads(boost::optional<unsigned> n);
+    std::shared_ptr<ThreadPool> evaluation_workers() const noexcept;
+    CallerBuilder& set_likelihood_cache_memory_budget(MemoryFootprint budget, boost::filesystem::path spill_directory);
+    CallerBuilder& set_likelihood_checkpoint(std::shared_ptr<HaplotypeLikelihoodCheckpoint> checkpoint) noexcept;
+    CallerBuilder& set_replay_bundle_writer(std::shared_ptr<ReplayBundleWriter> writer) noexcept;
     CallerBuilder& set_model_based_haplotype_dedup(bool use) noexcept;
     CallerBuilder& set_independent_genotype_prior_flag(bool use_independent) noexcept;
     
@@ -98,6 +104,11 @@ private:
         HaplotypeGenerator::Builder haplotype_generator_builder;
         HaplotypeLikelihoodModel likelihood_model;
         Phaser phaser;
+        std::shared_ptr<ThreadPool> evaluation_workers; // shared by all built callers
+        boost::optional<MemoryFootprint> likelihood_cache_budget;
+        boost::optional<boost::filesystem::path> likelihood_cache_spill_directory;
+        std::shared_ptr<HaplotypeLikelihoodCheckpoint> likelihood_checkpoint; // shared by all built callers
+        std::shared_ptr<ReplayBundleWriter> replay_bundle_writer; // shared by all built callers
     };
     
     struct Parameters
@@ -30,6 +30,7 @@
 #include "utils/merge_transform.hpp"
 #include "utils/mappable_algorithms.hpp"
 #include "utils/maths.hpp"
+#include "utils/select_top_k.hpp"
 #include "logging/logging.hpp"
 #include "core/types/calls/germline_variant_call.hpp"
 #include "core/types/calls/reference_call.hpp"
@@ -128,11 +129,26 @@ CancerCaller::infer_latents(const std::vector<Haplotype>& haplotypes,
     set_model_priors(*result);
     generate_germline_genotypes(*result, haplotypes);
     if (debug_log_) stream(*debug_log_) << "There are " << result->germline_genotypes_.size() << " candidate germline genotypes";
-    evaluate_germline_model(*result, haplotype_likelihoods);
-    evaluate_cnv_model(*result, haplotype_likelihoods);
+    if (evaluation_workers() && !evaluation_workers()->empty()) {
+        // The germline fit works on its own pooled likelihood cache and the CNV fit
+        // on a private prior model (the coalescent caches are not thread safe), so
+        // the two tasks only share read-only state; the CNV task is the sole primer
+        // of the main likelihood cache
+        const auto cnv_prior_model = make_germline_prior_model(haplotypes);
+        if (result->germline_genotype_indices_) cnv_prior_model->prime(haplotypes);
+        auto cnv_fit = evaluation_workers()->push([&] () {
+            evaluate_cnv_model(*result, haplotype_likelihoods, *cnv_prior_model);
+        });
+        evaluate_germline_model(*result, haplotype_likelihoods);
+        cnv_fit.get();
+    } else {
+        evaluate_germline_model(*result, haplotype_likelihoods);
+        evaluate_cnv_model(*result, haplotype_likelihoods, *result->germline_prior_model_);
+    }
     fit_tumour_model(*result, haplotype_likelihoods);
-    evaluate_noise_model(*result, haplotype_likelihoods);
+    // The noise model pre-screens on the model posteriors, so they must be set first
     set_model_posteriors(*result);
+    evaluate_noise_model(*result, haplotype_likelihoods);
     return result;
 }
 
@@ -295,23 +311,31 @@ auto extract_greatest_probability_values(const std::vector<T>& values,
 {
     assert(values.size() == probabilities.size());
     if (values.size() <= n) return values;
-    auto value_probabilities = zip_cref(values, probabilities);
-    auto last_include_itr = std::next(std::begin(value_probabilities), n);
-    const auto probability_greater = [] (const auto& lhs, const auto& rhs) noexcept { return lhs.second > rhs.second; };
-    std::partial_sort(std::begin(value_probabilities), last_include_itr, std::end(value_probabilities), probability_greater);
+    // Heap select the top n rather than sorting a zipped copy of the whole
+    // posterior vector - n is typically tiny relative to the genotype count
+    auto top_indices = select_top_k_indices(probabilities.size(), n,
+                                            [&] (Index idx) noexcept { return probabilities[idx]; });
+    auto last_include_itr = std::end(top_indices);
     if (min_include_probability) {
-        last_include_itr = std::upper_bound(std::begin(value_probabilities), last_include_itr, *min_include_probability,
-                                            [] (auto lhs, const auto& rhs) noexcept { return lhs > rhs.second; });
-        if (last_include_itr == std::begin(value_probabilities)) ++last_include_itr;
+        last_include_itr = std::upper_bound(std::begin(top_indices), last_include_itr, *min_include_probability,
+                                            [&] (auto lhs, auto rhs) noexcept { return lhs > probabilities[rhs]; });
+        if (last_include_itr == std::begin(top_indices)) ++last_include_itr;
+    }
+    top_indices.erase(last_include_itr, std::end(top_indices));
+    std::vector<T> result {};
+    result.reserve(top_indices.size());
+    for (const auto idx : top_indices) {
+        result.push_back(values[idx]);
     }
     if (max_exclude_probability) {
-        last_include_itr = std::partition(last_include_itr, std::end(value_probabilities),
-                                          [&] (const auto& p) noexcept { return p.second > *max_exclude_probability; });
+        std::vector<bool> selected(values.size(), false);
+        for (const auto idx : top_indices) selected[idx] = true;
+        for (Index idx {0}; idx < values.size(); ++idx) {
+            if (!selected[idx] && probabilities[idx] > *max_exclude_probability) {
+                result.push_back(values[idx]);
+            }
+        }
     }
-    std::vector<T> result {};
-    result.reserve(std::distance(std::begin(value_probabilities), last_include_itr));
-    std::transform(std::begin(value_probabilities), last_include_itr, std::back_inserter(result),
-                   [] (const auto& p) { return p.first.get(); });
     return result;
 }
 
@@ -341,6 +365,68 @@ auto extract_greatest_probability_genotypes(const std::vector<Genotype<Haplotype
     return std::make_pair(std::move(result_genotypes), std::move(result_indices));
 }
 
+auto compute_marginal_haplotype_posteriors(const std::vector<Haplotype>& haplotypes,
+                                           const std::vector<Genotype<Haplotype>>& genotypes,
+                                           const boost::optional<std::vector<GenotypeIndex>>& genotype_indices,
+                                           const std::vector<double>& genotype_posteriors)
+{
+    std::vector<double> result(haplotypes.size());
+    if (genotype_indices) {
+        GenotypeIndex buffer {};
+        for (std::size_t g {0}; g < genotypes.size(); ++g) {
+            for (auto idx : (*genotype_indices)[g]) {
+                if (std::find(std::cbegin(buffer), std::cend(buffer), idx) == std::cend(buffer)) {
+                    result[idx] += genotype_posteriors[g];
+                    buffer.push_back(idx);
+                }
+            }
+            buffer.clear();
+        }
+    } else {
+        using HaplotypeReference = std::reference_wrapper<const Haplotype>;
+        std::unordered_map<HaplotypeReference, double> tmp {};
+        tmp.reserve(haplotypes.size());
+        for (std::size_t g {0}; g < genotypes.size(); ++g) {
+            for (const auto& haplotype : genotypes[g].copy_unique_ref()) {
+                tmp[haplotype] += genotype_posteriors[g];
+            }
+        }
+        std::transform(std::cbegin(haplotypes), std::cend(haplotypes), std::begin(result),
+                       [&tmp] (const auto& haplotype) { return tmp.at(haplotype); });
+    }
+    return result;
+}
+
+auto calculate_max_somatic_haplotypes(const std::size_t num_haplotypes, const std::size_t num_germline_bases,
+                                      const unsigned somatic_ploidy, const std::size_t max_genotypes)
+{
+    // Every germline base is crossed with the whole somatic extension space, so
+    // shrink the candidate somatic haplotype set until the product respects the
+    // genotype budget
+    auto result = num_haplotypes;
+    while (result > 1 && num_germline_bases * num_genotypes(static_cast<unsigned>(result), somatic_ploidy) > max_genotypes) {
+        --result;
+    }
+    return result;
+}
+
+auto select_somatic_candidate_haplotypes(const std::vector<Haplotype>& haplotypes,
+                                         const std::vector<double>& haplotype_posteriors,
+                                         const std::size_t max_somatic_haplotypes)
+{
+    auto selected = select_top_k_indices(haplotypes.size(), max_somatic_haplotypes,
+                                         [&] (const Index idx) noexcept { return haplotype_posteriors[idx]; });
+    // Keep the candidates in haplotype order so the generated somatic genotypes
+    // follow the same conventions as a full enumeration
+    std::sort(std::begin(selected), std::end(selected));
+    std::vector<Haplotype> candidates {};
+    candidates.reserve(selected.size());
+    for (const auto idx : selected) {
+        candidates.push_back(haplotypes[idx]);
+    }
+    return std::make_pair(std::move(candidates), std::move(selected));
+}
+
 } // namespace
 
 void CancerCaller::generate_cancer_genotypes(Latents& latents, const HaplotypeLikelihoodCache& haplotype_likelihoods) const
@@ -385,6 +471,10 @@ void CancerCaller::generate_cancer_genotypes_with_clean_normal(Latents& latents,
     const auto& germline_normal_posteriors = latents.normal_germline_inferences_->posteriors.genotype_probabilities;
     const auto max_allowed_cancer_genotypes = std::max(parameters_.max_genotypes, germline_genotypes.size());
     const auto max_germline_genotype_bases = calculate_max_germline_genotype_bases(max_allowed_cancer_genotypes, latents.haplotypes_.get().size(), latents.somatic_ploidy_);
+    const auto& haplotypes = latents.haplotypes_.get();
+    const auto haplotype_posteriors = compute_marginal_haplotype_posteriors(haplotypes, germline_genotypes,
+                                                                            latents.germline_genotype_indices_,
+                                                                            germline_normal_posteriors);
     if (latents.germline_genotype_indices_) {
         std::vector<Genotype<Haplotype>> germline_bases;
         std::vector<GenotypeIndex> germline_bases_indices;
@@ -393,15 +483,27 @@ void CancerCaller::generate_cancer_genotypes_with_clean_normal(Latents& latents,
                                                                                                   germline_normal_posteriors,
                                                                                                   max_germline_genotype_bases,
                                                                                                   1e-100, 1e-2);
+        const auto max_somatic_haplotypes = calculate_max_somatic_haplotypes(haplotypes.size(), germline_bases.size(),
+                                                                             latents.somatic_ploidy_, max_allowed_cancer_genotypes);
+        const auto somatic_candidates = select_somatic_candidate_haplotypes(haplotypes, haplotype_posteriors, max_somatic_haplotypes);
         std::vector<CancerGenotypeIndex> cancer_genotype_indices {};
         latents.cancer_genotypes_ = generate_all_cancer_genotypes(germline_bases, germline_bases_indices,
-                                                                  latents.haplotypes_, cancer_genotype_indices,
+                                                                  somatic_candidates.first, cancer_genotype_indices,
                                                                   latents.somatic_ploidy_);
+        // The generated somatic indices refer to the candidate subset
+        for (auto& genotype_index : cancer_genotype_indices) {
+            for (auto& idx : genotype_index.somatic) {
+                idx = static_cast<unsigned>(somatic_candidates.second[idx]);
+            }
+        }
         latents.cancer_genotype_indices_ = std::move(cancer_genotype_indices);
     } else {
         auto germline_bases = extract_greatest_probability_values(germline_genotypes, germline_normal_posteriors,
                                                                   max_germline_genotype_bases, 1e-100, 1e-2);
-        latents.cancer_genotypes_ = generate_all_cancer_genotypes(germline_bases, latents.haplotypes_, latents.somatic_ploidy_);
+        const auto max_somatic_haplotypes = calculate_max_somatic_haplotypes(haplotypes.size(), germline_bases.size(),
+                                                                             latents.somatic_ploidy_, max_allowed_cancer_genotypes);
+        const auto somatic_candidates = select_somatic_candidate_haplotypes(haplotypes, haplotype_posteriors, max_somatic_haplotypes);
+        latents.cancer_genotypes_ = generate_all_cancer_genotypes(germline_bases, somatic_candidates.first, latents.somatic_ploidy_);
     }
 }
 
@@ -436,29 +538,9 @@ void CancerCaller::generate_cancer_genotypes_with_no_normal(Latents& latents, co
     const auto& haplotypes = latents.haplotypes_.get();
     const auto& germline_genotypes = latents.germline_genotypes_;
     const auto& germline_genotype_posteriors = latents.germline_model_inferences_.posteriors.genotype_probabilities;
-    std::vector<double> germline_model_haplotype_posteriors(haplotypes.size());
-    if (latents.germline_genotype_indices_) {
-        GenotypeIndex buffer {};
-        for (std::size_t g {0}; g < germline_genotypes.size(); ++g) {
-            const auto& g_indices = (*latents.germline_genotype_indices_)[g];
-            for (auto idx : g_indices) {
-                if (std::find(std::cbegin(buffer), std::cend(buffer), idx) == std::cend(buffer)) {
-                    germline_model_haplotype_posteriors[idx] += germline_genotype_posteriors[g];
-                }
-            }
-            buffer.clear();
-        }
-    } else {
-        std::unordered_map<HaplotypeReference, double> tmp {};
-        tmp.reserve(haplotypes.size());
-        for (std::size_t g {0}; g < germline_genotypes.size(); ++g) {
-            for (const auto& haplotype : germline_genotypes[g].copy_unique_ref()) {
-                tmp[haplotype] += germline_genotype_posteriors[g];
-            }
-            std::transform(std::cbegin(haplotypes), std::cend(haplotypes), std::begin(germline_model_haplotype_posteriors),
-                           [&tmp] (const auto& haplotype) { return tmp.at(haplotype); });
-        }
-    }
+    const auto germline_model_haplotype_posteriors = compute_marginal_haplotype_posteriors(haplotypes, germline_genotypes,
+                                                                                           latents.germline_genotype_indices_,
+                                                                                           germline_genotype_posteriors);
     const auto max_allowed_cancer_genotypes = std::max(parameters_.max_genotypes, germline_genotypes.size());
     const auto max_germline_genotype_bases = calculate_max_germline_genotype_bases(max_allowed_cancer_genotypes, latents.haplotypes_.get().size(), latents.somatic_ploidy_);
     const auto max_germline_haplotype_bases = max_num_elements(max_germline_genotype_bases, parameters_.ploidy);
@@ -491,13 +573,26 @@ void CancerCaller::generate_cancer_genotypes_with_no_normal(Latents& latents, co
                 germline_bases_indices.push_back((*latents.germline_genotype_indices_)[genotype_indices.at(genotype)]);
             }
         }
+        const auto max_somatic_haplotypes = calculate_max_somatic_haplotypes(haplotypes.size(), germline_bases.size(),
+                                                                             latents.somatic_ploidy_, max_allowed_cancer_genotypes);
+        const auto somatic_candidates = select_somatic_candidate_haplotypes(haplotypes, germline_model_haplotype_posteriors,
+                                                                            max_somatic_haplotypes);
         std::vector<CancerGenotypeIndex> cancer_genotype_indices {};
         latents.cancer_genotypes_ = generate_all_cancer_genotypes(germline_bases, germline_bases_indices,
-                                                                  latents.haplotypes_, cancer_genotype_indices,
+                                                                  somatic_candidates.first, cancer_genotype_indices,
                                                                   latents.somatic_ploidy_);
+        for (auto& genotype_index : cancer_genotype_indices) {
+            for (auto& idx : genotype_index.somatic) {
+                idx = static_cast<unsigned>(somatic_candidates.second[idx]);
+            }
+        }
         latents.cancer_genotype_indices_ = std::move(cancer_genotype_indices);
     } else {
-        latents.cancer_genotypes_ = generate_all_cancer_genotypes(germline_bases, haplotypes, latents.somatic_ploidy_);
+        const auto max_somatic_haplotypes = calculate_max_somatic_haplotypes(haplotypes.size(), germline_bases.size(),
+                                                                             latents.somatic_ploidy_, max_allowed_cancer_genotypes);
+        const auto somatic_candidates = select_somatic_candidate_haplotypes(haplotypes, germline_model_haplotype_posteriors,
+                                                                            max_somatic_haplotypes);
+        latents.cancer_genotypes_ = generate_all_cancer_genotypes(germline_bases, somatic_candidates.first, latents.somatic_ploidy_);
     }
 }
 
@@ -535,17 +630,22 @@ void CancerCaller::evaluate_germline_model(Latents& latents, const HaplotypeLike
     }
 }
 
-void CancerCaller::evaluate_cnv_model(Latents& latents, const HaplotypeLikelihoodCache& haplotype_likelihoods) const
+void CancerCaller::evaluate_cnv_model(Latents& latents, const HaplotypeLikelihoodCache& haplotype_likelihoods,
+                                      const GenotypePriorModel& germline_prior_model) const
 {
-    assert(!latents.germline_genotypes_.empty() && latents.germline_prior_model_);
-    auto cnv_model_priors = get_cnv_model_priors(*latents.germline_prior_model_);
-    const CNVModel cnv_model {samples_, cnv_model_priors};
+    assert(!latents.germline_genotypes_.empty());
+    auto cnv_model_priors = get_cnv_model_priors(germline_prior_model);
+    CNVModel cnv_model {samples_, cnv_model_priors};
+    if (cnv_mixture_weight_memo_) {
+        cnv_model.prime_mixture_weights(*cnv_mixture_weight_memo_);
+    }
     if (latents.germline_genotype_indices_) {
         latents.cnv_model_inferences_ = cnv_model.evaluate(latents.germline_genotypes_, *latents.germline_genotype_indices_,
                                                            haplotype_likelihoods);
     } else {
         latents.cnv_model_inferences_ = cnv_model.evaluate(latents.germline_genotypes_, haplotype_likelihoods);
     }
+    cnv_mixture_weight_memo_ = latents.cnv_model_inferences_.posteriors.alphas;
 }
 
 void CancerCaller::evaluate_tumour_model(Latents& latents, const HaplotypeLikelihoodCache& haplotype_likelihoods) const
@@ -554,7 +654,12 @@ void CancerCaller::evaluate_tumour_model(Latents& latents, const HaplotypeLikeli
     SomaticMutationModel mutation_model {parameters_.somatic_mutation_model_params};
     latents.cancer_genotype_prior_model_ = CancerGenotypePriorModel {*latents.germline_prior_model_, std::move(mutation_model)};
     auto somatic_model_priors = get_somatic_model_priors(*latents.cancer_genotype_prior_model_, latents.somatic_ploidy_);
-    const TumourModel somatic_model {samples_, somatic_model_priors};
+    TumourModel somatic_model {samples_, somatic_model_priors};
+    if (evaluation_workers()) somatic_model.enable_parallel_evaluation(*evaluation_workers());
+    const auto memo_itr = somatic_mixture_weight_memo_.find(latents.somatic_ploidy_);
+    if (memo_itr != std::cend(somatic_mixture_weight_memo_)) {
+        somatic_model.prime_mixture_weights(memo_itr->second);
+    }
     if (latents.cancer_genotype_indices_) {
         assert(latents.cancer_genotype_prior_model_->germline_model().is_primed());
         latents.cancer_genotype_prior_model_->mutation_model().prime(latents.haplotypes_);
@@ -563,6 +668,7 @@ void CancerCaller::evaluate_tumour_model(Latents& latents, const HaplotypeLikeli
     } else {
         latents.tumour_model_inferences_ = somatic_model.evaluate(latents.cancer_genotypes_, haplotype_likelihoods);
     }
+    somatic_mixture_weight_memo_[latents.somatic_ploidy_] = latents.tumour_model_inferences_.posteriors.alphas;
 }
 
 auto get_high_posterior_genotypes(const std::vector<CancerGenotype<Haplotype>>& genotypes,
@@ -571,9 +677,22 @@ auto get_high_posterior_genotypes(const std::vector<CancerGenotype<Haplotype>>&
     return extract_greatest_probability_values(genotypes, latents.posteriors.genotype_probabilities, 10, 1e-3);
 }
 
+namespace {
+
+Phred<double> calculate_somatic_posterior(double somatic_model_posterior, double somatic_mass);
+
+} // namespace
+
 void CancerCaller::evaluate_noise_model(Latents& latents, const HaplotypeLikelihoodCache& haplotype_likelihoods) const
 {
     if (has_normal_sample() && !has_high_normal_contamination_risk(latents)) {
+        const auto somatic_posterior = calculate_somatic_posterior(latents.model_posteriors_.somatic,
+                                                                   calculate_somatic_mass(latents));
+        if (somatic_posterior < parameters_.min_somatic_posterior) {
+            // Clearly germline; the noise model is only consulted when a somatic call
+            // is on the table, which the somatic posterior already rules out
+            return;
+        }
         if (!latents.normal_germline_inferences_) {
             assert(latents.germline_model_);
             haplotype_likelihoods.prime(normal_sample());
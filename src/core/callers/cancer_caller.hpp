@@ -137,7 +137,8 @@ private:
     bool has_high_normal_contamination_risk(const Latents& latents) const;
     
     void evaluate_germline_model(Latents& latents, const HaplotypeLikelihoodCache& haplotype_likelihoods) const;
-    void evaluate_cnv_model(Latents& latents, const HaplotypeLikelihoodCache& haplotype_likelihoods) const;
+    void evaluate_cnv_model(Latents& latents, const HaplotypeLikelihoodCache& haplotype_likelihoods,
+                            const GenotypePriorModel& germline_prior_model) const;
     void evaluate_tumour_model(Latents& latents, const HaplotypeLikelihoodCache& haplotype_likelihoods) const;
     void evaluate_noise_model(Latents& latents, const HaplotypeLikelihoodCache& haplotype_likelihoods) const;
     
@@ -145,6 +146,12 @@ private:
     void set_model_posteriors(Latents& latents) const;
     
     void fit_tumour_model(Latents& latents, const HaplotypeLikelihoodCache& haplotype_likelihoods) const;
+
+    // Converged mixture weight posteriors from the last active region;
+    // adjacent regions share clonal composition, so these warm-start the next
+    // region's VB fits (the somatic memo is keyed by somatic ploidy)
+    mutable boost::optional<CNVModel::Latents::GenotypeMixturesDirichletAlphaMap> cnv_mixture_weight_memo_;
+    mutable std::unordered_map<unsigned, TumourModel::Latents::GenotypeMixturesDirichletAlphaMap> somatic_mixture_weight_memo_;
     
     std::unique_ptr<GenotypePriorModel> make_germline_prior_model(const std::vector<Haplotype>& haplotypes) const;
     CNVModel::Priors get_cnv_model_priors(const GenotypePriorModel& prior_model) const;
@@ -132,10 +132,74 @@ IndividualCaller::infer_latents(const std::vector<Haplotype>& haplotypes,
     const auto prior_model = make_prior_model(haplotypes);
     const model::IndividualModel model {*prior_model, debug_log_};
     haplotype_likelihoods.prime(sample());
-    auto inferences = model.evaluate(genotypes, haplotype_likelihoods);
+    auto inferences = evaluate_genotype_model(model, haplotypes, genotypes, haplotype_likelihoods);
     return std::make_unique<Latents>(sample(), haplotypes, std::move(genotypes), std::move(inferences));
 }
 
+namespace {
+
+bool is_haplotype_subset(std::vector<Haplotype> haplotypes, const std::vector<Haplotype>& sorted_superset)
+{
+    if (haplotypes.size() >= sorted_superset.size()) return false;
+    std::sort(std::begin(haplotypes), std::end(haplotypes));
+    return std::includes(std::cbegin(sorted_superset), std::cend(sorted_superset),
+                         std::cbegin(haplotypes), std::cend(haplotypes));
+}
+
+auto make_sorted(std::vector<Haplotype> haplotypes)
+{
+    std::sort(std::begin(haplotypes), std::end(haplotypes));
+    return haplotypes;
+}
+
+boost::optional<std::vector<std::size_t>>
+find_genotype_indices(const std::vector<Genotype<Haplotype>>& genotypes,
+                      const std::vector<Genotype<Haplotype>>& evaluated_genotypes)
+{
+    std::unordered_map<Genotype<Haplotype>, std::size_t> evaluated_genotype_indices {};
+    evaluated_genotype_indices.reserve(evaluated_genotypes.size());
+    for (std::size_t genotype_idx {0}; genotype_idx < evaluated_genotypes.size(); ++genotype_idx) {
+        evaluated_genotype_indices.emplace(evaluated_genotypes[genotype_idx], genotype_idx);
+    }
+    std::vector<std::size_t> result(genotypes.size());
+    for (std::size_t genotype_idx {0}; genotype_idx < genotypes.size(); ++genotype_idx) {
+        const auto itr = evaluated_genotype_indices.find(genotypes[genotype_idx]);
+        if (itr == std::cend(evaluated_genotype_indices)) return boost::none;
+        result[genotype_idx] = itr->second;
+    }
+    return result;
+}
+
+} // namespace
+
+model::IndividualModel::InferredLatents
+IndividualCaller::evaluate_genotype_model(const model::IndividualModel& model,
+                                          const std::vector<Haplotype>& haplotypes,
+                                          const std::vector<Genotype<Haplotype>>& genotypes,
+                                          const HaplotypeLikelihoodCache& haplotype_likelihoods) const
+{
+    // Haplotype equality includes the mapped region, so a subset of the last
+    // evaluated haplotypes implies the same active reads - and hence the same
+    // likelihoods and genotype priors - with some haplotypes filtered away,
+    // which is exactly the case the model can downdate
+    if (model_evaluation_memo_ && is_haplotype_subset(haplotypes, model_evaluation_memo_->haplotypes)) {
+        const auto surviving_genotype_indices = find_genotype_indices(genotypes, model_evaluation_memo_->genotypes);
+        if (surviving_genotype_indices) {
+            auto downdated = model.downdate(model_evaluation_memo_->inferences, *surviving_genotype_indices);
+            if (downdated) {
+                if (debug_log_) {
+                    stream(*debug_log_) << "Downdated previous model latents over "
+                                        << genotypes.size() << " surviving genotypes";
+                }
+                return std::move(*downdated);
+            }
+        }
+    }
+    auto result = model.evaluate(genotypes, haplotype_likelihoods);
+    model_evaluation_memo_ = ModelEvaluationMemo {make_sorted(haplotypes), genotypes, result};
+    return result;
+}
+
 boost::optional<double>
 IndividualCaller::calculate_model_posterior(const std::vector<Haplotype>& haplotypes,
                                             const HaplotypeLikelihoodCache& haplotype_likelihoods,
@@ -213,22 +277,40 @@ using GenotypeCalls = std::vector<GenotypeCall>;
 
 // allele posterior calculations
 
-auto compute_posterior(const Allele& allele, const GenotypeProbabilityMap& genotype_posteriors)
-{
-    auto p = std::accumulate(std::cbegin(genotype_posteriors), std::cend(genotype_posteriors),
-                             0.0, [&allele] (const auto curr, const auto& p) {
-                                 return curr + (contains(p.first, allele) ? 0.0 : p.second);
-                             });
-    return probability_to_phred(p);
-}
-
 auto compute_candidate_posteriors(const std::vector<Variant>& candidates,
-                                  const GenotypeProbabilityMap& genotype_posteriors)
-{
+                                  const GenotypeProbabilityMap& genotype_posteriors,
+                                  const Phred<double> min_posterior)
+{
+    // Genotypes are scanned in posterior order so each candidate's scan can
+    // stop as soon as the unseen tail can neither move it across the emission
+    // threshold nor visibly change the reported quality. Only candidates in
+    // the borderline band - typically a small fraction - pay for the full sum.
+    std::vector<std::pair<const Genotype<Haplotype>*, double>> ordered_posteriors {};
+    ordered_posteriors.reserve(genotype_posteriors.size());
+    for (const auto& p : genotype_posteriors) {
+        ordered_posteriors.emplace_back(&p.first, p.second);
+    }
+    std::sort(std::begin(ordered_posteriors), std::end(ordered_posteriors),
+              [] (const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+    const auto min_mass_to_call = min_posterior.probability_true();
+    constexpr double qualityMassTolerance {1e-10};
     VariantPosteriorVector result {};
     result.reserve(candidates.size());
     for (const auto& candidate : candidates) {
-        result.emplace_back(candidate, compute_posterior(candidate.alt_allele(), genotype_posteriors));
+        const auto& allele = candidate.alt_allele();
+        double p {0}, seen_mass {0};
+        for (const auto& genotype_posterior : ordered_posteriors) {
+            seen_mass += genotype_posterior.second;
+            if (!contains(*genotype_posterior.first, allele)) p += genotype_posterior.second;
+            const auto unseen_mass = std::max(0.0, 1.0 - seen_mass);
+            if (p + unseen_mass < min_mass_to_call) {
+                // Below the emission threshold however the tail falls
+                p += unseen_mass;
+                break;
+            }
+            if (p >= min_mass_to_call && unseen_mass < qualityMassTolerance) break;
+        }
+        result.emplace_back(candidate, probability_to_phred(p));
     }
     return result;
 }
@@ -375,7 +457,8 @@ IndividualCaller::call_variants(const std::vector<Variant>& candidates,
     if (parameters_.ploidy == 0) return {};
     const auto& genotype_posteriors = (*latents.genotype_posteriors_)[sample()];
     debug::log(genotype_posteriors, debug_log_, trace_log_);
-    const auto candidate_posteriors = compute_candidate_posteriors(candidates, genotype_posteriors);
+    const auto candidate_posteriors = compute_candidate_posteriors(candidates, genotype_posteriors,
+                                                                   parameters_.min_variant_posterior);
     debug::log(candidate_posteriors, debug_log_, trace_log_, parameters_.min_variant_posterior);
     const bool force_call_non_ref {has_callable(candidate_posteriors, parameters_.min_variant_posterior)};
     const auto genotype_call = octopus::call_genotype(genotype_posteriors, force_call_non_ref);
@@ -487,6 +570,29 @@ IndividualCaller::call_reference(const std::vector<Allele>& alleles,
     return transform_calls(std::move(calls), sample(), parameters_.ploidy);
 }
 
+bool IndividualCaller::has_closed_form_reference_model() const noexcept
+{
+    return true;
+}
+
+std::vector<std::unique_ptr<ReferenceCall>>
+IndividualCaller::call_reference(const std::vector<Allele>& alleles, const ReadPileupMap& pileups) const
+{
+    // Without non-reference evidence the genotype posteriors cannot support
+    // variation, so compute_homozygous_posterior reduces to its depth term
+    std::vector<RefCall> calls {};
+    calls.reserve(alleles.size());
+    const auto& sample_pileups = pileups.at(sample());
+    for (const auto& allele : alleles) {
+        const auto coverage = mean_depth(sample_pileups, mapped_region(allele));
+        const Phred<double> posterior {2 * static_cast<double>(coverage)};
+        if (posterior >= parameters_.min_refcall_posterior) {
+            calls.push_back({allele, posterior});
+        }
+    }
+    return transform_calls(std::move(calls), sample(), parameters_.ploidy);
+}
+
 const SampleName& IndividualCaller::sample() const noexcept
 {
     return samples_.front();
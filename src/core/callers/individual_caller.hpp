@@ -92,9 +92,31 @@ private:
     call_reference(const std::vector<Allele>& alleles, const Latents& latents,
                    const ReadPileupMap& pileups) const;
     
-    const SampleName& sample() const noexcept;
+    bool has_closed_form_reference_model() const noexcept override;
+    
+    std::vector<std::unique_ptr<ReferenceCall>>
+    call_reference(const std::vector<Allele>& alleles, const ReadPileupMap& pileups) const override;
     
+    const SampleName& sample() const noexcept;
+
     std::unique_ptr<GenotypePriorModel> make_prior_model(const std::vector<Haplotype>& haplotypes) const;
+
+    // The last full model evaluation; repeat passes over an active region that
+    // only remove haplotypes can renormalise these posteriors over the
+    // surviving genotypes rather than re-evaluate the model
+    struct ModelEvaluationMemo
+    {
+        std::vector<Haplotype> haplotypes; // sorted
+        std::vector<Genotype<Haplotype>> genotypes;
+        model::IndividualModel::InferredLatents inferences;
+    };
+    mutable boost::optional<ModelEvaluationMemo> model_evaluation_memo_;
+
+    model::IndividualModel::InferredLatents
+    evaluate_genotype_model(const model::IndividualModel& model,
+                            const std::vector<Haplotype>& haplotypes,
+                            const std::vector<Genotype<Haplotype>>& genotypes,
+                            const HaplotypeLikelihoodCache& haplotype_likelihoods) const;
 };
 
 class IndividualCaller::Latents : public Caller::Latents
@@ -178,6 +178,7 @@ void fit_sublone_model(const std::vector<Haplotype>& haplotypes, const Haplotype
                        const double haploid_model_evidence, const std::function<double(unsigned)>& clonality_prior,
                        const std::size_t max_genotypes, std::vector<Genotype<Haplotype>>& polyploid_genotypes,
                        model::SubcloneModel::InferredLatents& sublonal_inferences,
+                       std::unordered_map<unsigned, model::SubcloneModel::Latents::GenotypeMixturesDirichletAlphas>& mixture_weight_memo,
                        boost::optional<logging::DebugLogger>& debug_log)
 {
     const auto haploid_prior = std::log(clonality_prior(1));
@@ -190,7 +191,20 @@ void fit_sublone_model(const std::vector<Haplotype>& haplotypes, const Haplotype
         if (genotypes.empty()) break;
         model::SubcloneModel::Priors subclonal_model_priors {genotype_prior_model, make_sublone_model_mixture_prior_map(sample, num_clones)};
         model::SubcloneModel subclonal_model {{sample}, subclonal_model_priors};
+        const auto memo_itr = mixture_weight_memo.find(num_clones);
+        if (memo_itr != std::cend(mixture_weight_memo)) {
+            subclonal_model.prime_mixture_weights({{sample, memo_itr->second}});
+        } else if (num_clones > 2) {
+            // Warm-start from the converged smaller model by splitting its dominant
+            // component between the new clone and its parent
+            auto split_alphas = sublonal_inferences.posteriors.alphas.at(sample);
+            const auto dominant_itr = std::max_element(std::begin(split_alphas), std::end(split_alphas));
+            *dominant_itr /= 2;
+            split_alphas.push_back(*dominant_itr);
+            subclonal_model.prime_mixture_weights({{sample, std::move(split_alphas)}});
+        }
         auto inferences = subclonal_model.evaluate(genotypes, haplotype_likelihoods);
+        mixture_weight_memo[num_clones] = inferences.posteriors.alphas.at(sample);
         if (debug_log) stream(*debug_log) << "Evidence for model with clonality " << num_clones << " is " << inferences.approx_log_evidence;
         if (num_clones == 2) {
             polyploid_genotypes = std::move(genotypes);
@@ -198,10 +212,16 @@ void fit_sublone_model(const std::vector<Haplotype>& haplotypes, const Haplotype
             if ((std::log(clonal_model_prior) + sublonal_inferences.approx_log_evidence)
                 < (haploid_prior + haploid_model_evidence)) break;
         } else {
-            if ((std::log(clonal_model_prior) + inferences.approx_log_evidence)
-                <= (std::log(clonality_prior(num_clones - 1)) + sublonal_inferences.approx_log_evidence))  break;
-            polyploid_genotypes = std::move(genotypes);
-            sublonal_inferences = std::move(inferences);
+            const auto prev_joint_evidence = std::log(clonality_prior(num_clones - 1)) + sublonal_inferences.approx_log_evidence;
+            const auto joint_evidence = std::log(clonal_model_prior) + inferences.approx_log_evidence;
+            if (joint_evidence > prev_joint_evidence) {
+                polyploid_genotypes = std::move(genotypes);
+                sublonal_inferences = std::move(inferences);
+            }
+            // Evidence gains within VB convergence noise are no real support for extra
+            // clonality, so the ladder stops when the gain flattens, not only when it falls
+            constexpr double evidenceFlatnessTolerance {0.1};
+            if (joint_evidence <= prev_joint_evidence + evidenceFlatnessTolerance) break;
         }
     }
 }
@@ -221,7 +241,7 @@ PolycloneCaller::infer_latents(const std::vector<Haplotype>& haplotypes, const H
     std::vector<Genotype<Haplotype>> polyploid_genotypes; model::SubcloneModel::InferredLatents sublonal_inferences;
     fit_sublone_model(haplotypes, haplotype_likelihoods, *genotype_prior_model, sample(), parameters_.max_clones,
                       haploid_inferences.log_evidence, parameters_.clonality_prior, parameters_.max_genotypes, polyploid_genotypes,
-                      sublonal_inferences, debug_log_);
+                      sublonal_inferences, mixture_weight_memo_, debug_log_);
     if (debug_log_) stream(*debug_log_) << "There are " << polyploid_genotypes.size() << " candidate polyploid genotypes";
     using std::move;
     return std::make_unique<Latents>(move(haploid_genotypes), move(polyploid_genotypes),
@@ -296,22 +316,40 @@ using GenotypeCalls = std::vector<GenotypeCall>;
 
 // allele posterior calculations
 
-auto compute_posterior(const Allele& allele, const GenotypeProbabilityMap& genotype_posteriors)
-{
-    auto p = std::accumulate(std::cbegin(genotype_posteriors), std::cend(genotype_posteriors),
-                             0.0, [&allele] (const auto curr, const auto& p) {
-        return curr + (contains(p.first, allele) ? 0.0 : p.second);
-    });
-    return probability_to_phred(p);
-}
-
 auto compute_candidate_posteriors(const std::vector<Variant>& candidates,
-                                  const GenotypeProbabilityMap& genotype_posteriors)
-{
+                                  const GenotypeProbabilityMap& genotype_posteriors,
+                                  const Phred<double> min_posterior)
+{
+    // Genotypes are scanned in posterior order so each candidate's scan can
+    // stop once the unseen tail can neither move it across the emission
+    // threshold nor visibly change the reported quality; only borderline
+    // candidates pay for the full sum
+    std::vector<std::pair<const Genotype<Haplotype>*, double>> ordered_posteriors {};
+    ordered_posteriors.reserve(genotype_posteriors.size());
+    for (const auto& p : genotype_posteriors) {
+        ordered_posteriors.emplace_back(&p.first, p.second);
+    }
+    std::sort(std::begin(ordered_posteriors), std::end(ordered_posteriors),
+              [] (const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+    const auto min_mass_to_call = min_posterior.probability_true();
+    constexpr double qualityMassTolerance {1e-10};
     VariantPosteriorVector result {};
     result.reserve(candidates.size());
     for (const auto& candidate : candidates) {
-        result.emplace_back(candidate, compute_posterior(candidate.alt_allele(), genotype_posteriors));
+        const auto& allele = candidate.alt_allele();
+        double p {0}, seen_mass {0};
+        for (const auto& genotype_posterior : ordered_posteriors) {
+            seen_mass += genotype_posterior.second;
+            if (!contains(*genotype_posterior.first, allele)) p += genotype_posterior.second;
+            const auto unseen_mass = std::max(0.0, 1.0 - seen_mass);
+            if (p + unseen_mass < min_mass_to_call) {
+                // Below the emission threshold however the tail falls
+                p += unseen_mass;
+                break;
+            }
+            if (p >= min_mass_to_call && unseen_mass < qualityMassTolerance) break;
+        }
+        result.emplace_back(candidate, probability_to_phred(p));
     }
     return result;
 }
@@ -453,7 +491,8 @@ PolycloneCaller::call_variants(const std::vector<Variant>& candidates, const Lat
     log(latents);
     const auto& genotype_posteriors = (*latents.genotype_posteriors())[sample()];
     debug::log(genotype_posteriors, debug_log_, trace_log_);
-    const auto candidate_posteriors = compute_candidate_posteriors(candidates, genotype_posteriors);
+    const auto candidate_posteriors = compute_candidate_posteriors(candidates, genotype_posteriors,
+                                                                   parameters_.min_variant_posterior);
     debug::log(candidate_posteriors, debug_log_, trace_log_, parameters_.min_variant_posterior);
     const bool force_call_non_ref {has_callable(candidate_posteriors, parameters_.min_variant_posterior)};
     const auto genotype_call = octopus::call_genotype(genotype_posteriors, force_call_non_ref);
@@ -8,6 +8,7 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <unordered_map>
 
 #include <boost/optional.hpp>
 
@@ -104,9 +105,15 @@ private:
                    const ReadPileupMap& pileup) const;
     
     const SampleName& sample() const noexcept;
-    
+
     std::unique_ptr<GenotypePriorModel> make_prior_model(const std::vector<Haplotype>& haplotypes) const;
-    
+
+    // Converged subclone model mixture posteriors from the last active region,
+    // by clonality; adjacent regions share clonal composition, so these
+    // warm-start the VB fit in the next region
+    using MixtureWeightMemo = std::unordered_map<unsigned, model::SubcloneModel::Latents::GenotypeMixturesDirichletAlphas>;
+    mutable MixtureWeightMemo mixture_weight_memo_;
+
     // debug
     void log(const Latents& latents) const;
 };
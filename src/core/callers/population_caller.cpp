@@ -562,13 +562,15 @@ auto compute_polymorphism_posteriors(const std::vector<Variant>& variants,
 
 // allele genotype calling
 
-auto marginalise(const Genotype<Allele>& genotype, const GenotypeProbabilityMap& genotype_posteriors)
-{
-    auto p = std::accumulate(std::cbegin(genotype_posteriors), std::cend(genotype_posteriors), 0.0,
-                             [&genotype] (const double curr, const auto& p) {
-                                 return curr + (contains(p.first, genotype) ? 0.0 : p.second);
-                             });
-    return probability_to_phred(p);
+auto compute_genotype_containments(const PopulationGenotypeProbabilityMap& genotype_posteriors,
+                                   const Genotype<Allele>& genotype)
+{
+    AlleleBools result(genotype_posteriors.size2());
+    const auto& test_sample = genotype_posteriors.begin()->first;
+    std::transform(genotype_posteriors.begin(test_sample), genotype_posteriors.end(test_sample),
+                   std::begin(result),
+                   [&genotype] (const auto& p) { return contains(p.first, genotype); });
+    return result;
 }
 
 auto call_genotypes(const std::vector<SampleName>& samples,
@@ -578,12 +580,23 @@ auto call_genotypes(const std::vector<SampleName>& samples,
 {
     GenotypeCalls result {};
     result.reserve(variant_regions.size());
+    // Genotype ordering is shared between samples, and samples frequently call
+    // the same genotype at a site, so the containment scan - the expensive part
+    // of marginalisation - is done once per unique called genotype at each site
+    // and served to all samples from the table
+    std::unordered_map<Genotype<Allele>, AlleleBools> containment_cache {};
     for (const auto& region : variant_regions) {
+        containment_cache.clear();
         std::vector<GenotypeCall> region_calls {};
         region_calls.reserve(samples.size());
         for (std::size_t s {0}; s < samples.size(); ++s) {
             auto genotype_chunk = copy<Allele>(genotype_calls[s], region);
-            const auto posterior = marginalise(genotype_chunk, genotype_posteriors[samples[s]]);
+            auto cache_itr = containment_cache.find(genotype_chunk);
+            if (cache_itr == std::cend(containment_cache)) {
+                cache_itr = containment_cache.emplace(genotype_chunk,
+                                                      compute_genotype_containments(genotype_posteriors, genotype_chunk)).first;
+            }
+            const auto posterior = marginalise(genotype_posteriors[samples[s]], cache_itr->second);
             region_calls.push_back({std::move(genotype_chunk), posterior});
         }
         result.push_back(std::move(region_calls));
@@ -746,7 +759,10 @@ PopulationCaller::infer_latents_with_joint_model(const std::vector<Haplotype>& h
 {
     const auto prior_model = make_joint_prior_model(haplotypes);
     prior_model->prime(haplotypes);
-    const model::PopulationModel model {*prior_model, {parameters_.max_joint_genotypes}, debug_log_};
+    model::PopulationModel::Options model_options {};
+    model_options.max_joint_genotypes = parameters_.max_joint_genotypes;
+    model_options.pedigree = parameters_.pedigree;
+    const model::PopulationModel model {*prior_model, std::move(model_options), debug_log_};
     if (parameters_.ploidies.size() == 1) {
         std::vector<GenotypeIndex> genotype_indices;
         auto genotypes = generate_all_genotypes(haplotypes, parameters_.ploidies.front(), genotype_indices);
@@ -12,6 +12,7 @@
 #include "config/common.hpp"
 #include "basics/ploidy_map.hpp"
 #include "basics/phred.hpp"
+#include "basics/pedigree.hpp"
 #include "core/models/mutation/coalescent_model.hpp"
 #include "core/models/genotype/genotype_prior_model.hpp"
 #include "core/models/genotype/population_prior_model.hpp"
@@ -38,6 +39,7 @@ public:
         std::vector<unsigned> ploidies;
         boost::optional<CoalescentModel::Parameters> prior_model_params;
         std::size_t max_joint_genotypes;
+        boost::optional<Pedigree> pedigree;
         bool use_independent_genotype_priors = false;
         bool deduplicate_haplotypes_with_germline_model = true;
     };
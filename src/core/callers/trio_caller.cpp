@@ -26,6 +26,7 @@
 #include "core/models/genotype/coalescent_population_prior_model.hpp"
 #include "core/models/genotype/population_model.hpp"
 #include "utils/map_utils.hpp"
+#include "utils/select_top_k.hpp"
 #include "utils/mappable_algorithms.hpp"
 #include "utils/maths.hpp"
 #include "exceptions/unimplemented_feature_error.hpp"
@@ -49,6 +50,7 @@ TrioCaller::TrioCaller(Caller::Components&& components,
                        Parameters specific_parameters)
 : Caller {std::move(components), std::move(general_parameters)}
 , parameters_ {std::move(specific_parameters)}
+, denovo_model_ {parameters_.denovo_model_params, 1000, DeNovoModel::CachingStrategy::address}
 {
     if (parameters_.maternal_ploidy == 0 || parameters_.paternal_ploidy == 0 || parameters_.child_ploidy == 0) {
         throw std::logic_error {"TrioCaller: ploidy must be > 0"};
@@ -278,17 +280,18 @@ TrioCaller::infer_latents(const std::vector<Haplotype>& haplotypes,
                           const HaplotypeLikelihoodCache& haplotype_likelihoods) const
 {
     auto germline_prior_model = make_prior_model(haplotypes);
-    DeNovoModel denovo_model {parameters_.denovo_model_params, haplotypes.size(), DeNovoModel::CachingStrategy::address};
-    const model::TrioModel model {
-        parameters_.trio, *germline_prior_model, denovo_model,
+    denovo_model_.unprime();
+    model::TrioModel model {
+        parameters_.trio, *germline_prior_model, denovo_model_,
         TrioModel::Options {parameters_.max_joint_genotypes},
         debug_log_
     };
+    if (evaluation_workers()) model.enable_parallel_evaluation(*evaluation_workers());
     std::vector<std::vector<unsigned>> genotype_indices {};
     auto maternal_genotypes = generate_all_genotypes(haplotypes, parameters_.maternal_ploidy, genotype_indices);
     if (parameters_.maternal_ploidy == parameters_.paternal_ploidy) {
         germline_prior_model->prime(haplotypes);
-        denovo_model.prime(haplotypes);
+        denovo_model_.prime(haplotypes);
         auto latents = model.evaluate(maternal_genotypes, genotype_indices, haplotype_likelihoods);
         return std::make_unique<Latents>(haplotypes, std::move(maternal_genotypes),
                                          std::move(latents), parameters_.trio);
@@ -341,11 +344,12 @@ TrioCaller::calculate_model_posterior(const std::vector<Haplotype>& haplotypes,
         std::vector<std::vector<unsigned>> genotype_indices {};
         const auto genotypes = generate_all_genotypes(haplotypes, max_ploidy + 1, genotype_indices);
         const auto germline_prior_model = make_prior_model(haplotypes);
-        DeNovoModel denovo_model {parameters_.denovo_model_params};
+        denovo_model_.unprime();
         germline_prior_model->prime(haplotypes);
-        denovo_model.prime(haplotypes);
-        const model::TrioModel model {parameters_.trio, *germline_prior_model, denovo_model,
-                                      TrioModel::Options {parameters_.max_joint_genotypes}};
+        denovo_model_.prime(haplotypes);
+        model::TrioModel model {parameters_.trio, *germline_prior_model, denovo_model_,
+                                TrioModel::Options {parameters_.max_joint_genotypes}};
+        if (evaluation_workers()) model.enable_parallel_evaluation(*evaluation_workers());
         const auto inferences = model.evaluate(genotypes, genotype_indices, haplotype_likelihoods);
         return octopus::calculate_model_posterior(latents.model_latents.log_evidence, inferences.log_evidence);
     } else {
@@ -715,17 +719,22 @@ auto call_trio(const TrioProbabilityVector& trio_posteriors,
     if (trio_posteriors.size() == 1 || is_viable_genotype_call(*map_itr, germline_calls, denovo_calls)) {
         return to_call(*map_itr);
     } else {
-        std::vector<std::reference_wrapper<const JointProbability>> trio_posterior_refs {};
-        trio_posterior_refs.reserve(trio_posteriors.size());
-        std::copy(std::cbegin(trio_posteriors), std::cend(trio_posteriors), std::back_inserter(trio_posterior_refs));
-        std::sort(std::begin(trio_posterior_refs), std::end(trio_posterior_refs),
-                  [] (const auto& lhs, const auto& rhs) { return lhs.get().probability > rhs.get().probability; });
-        auto viable_map_itr = std::find_if(std::next(std::cbegin(trio_posterior_refs)), std::cend(trio_posterior_refs),
-                                           [&] (const auto& p) {
-                                               return is_viable_genotype_call(p,  germline_calls, denovo_calls);
-                                           });
-        if (viable_map_itr != std::cend(trio_posterior_refs)) {
-            return to_call(*viable_map_itr);
+        // Walk the posteriors in descending order lazily - a viable call is
+        // usually found within a few pops, so sorting the full vector is waste
+        const JointProbability* viable_map {nullptr};
+        std::size_t rank {0};
+        visit_in_descending_score_order(trio_posteriors.size(),
+                                        [&] (Index idx) noexcept { return trio_posteriors[idx].probability; },
+                                        [&] (Index idx) {
+                                            if (rank++ == 0) return true; // the MAP call was checked above
+                                            if (is_viable_genotype_call(trio_posteriors[idx], germline_calls, denovo_calls)) {
+                                                viable_map = std::addressof(trio_posteriors[idx]);
+                                                return false;
+                                            }
+                                            return true;
+                                        });
+        if (viable_map) {
+            return to_call(*viable_map);
         } else {
             return to_call(*map_itr);
         }
@@ -54,6 +54,9 @@ private:
     class Latents;
     
     Parameters parameters_;
+    // Kept across active regions so the mutation model's sequence-pair cache
+    // persists for the lifetime of the task
+    mutable DeNovoModel denovo_model_;
     
     std::string do_name() const override;
     CallTypeSet do_call_types() const override;
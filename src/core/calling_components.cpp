@@ -8,6 +8,8 @@
 #include <iterator>
 #include <algorithm>
 #include <functional>
+#include <future>
+#include <thread>
 #include <exception>
 
 #include "config/config.hpp"
@@ -30,8 +32,9 @@ VcfWriter make_vcf_writer(boost::optional<fs::path> dst)
 } // namespace
 
 GenomeCallingComponents::GenomeCallingComponents(ReferenceGenome&& reference, ReadManager&& read_manager,
-                                                 VcfWriter&& output, const options::OptionMap& options)
-: components_ {std::move(reference), std::move(read_manager), std::move(output), options}
+                                                 VcfWriter&& output, const options::OptionMap& options,
+                                                 boost::optional<InputRegionMap> warm_search_regions)
+: components_ {std::move(reference), std::move(read_manager), std::move(output), options, std::move(warm_search_regions)}
 {}
 
 GenomeCallingComponents::GenomeCallingComponents(GenomeCallingComponents&& other) noexcept
@@ -95,6 +98,11 @@ std::size_t GenomeCallingComponents::read_buffer_size() const noexcept
     return components_.read_buffer_size;
 }
 
+MemoryFootprint GenomeCallingComponents::target_read_buffer_footprint() const noexcept
+{
+    return components_.target_read_buffer_footprint;
+}
+
 const boost::optional<GenomeCallingComponents::Path>& GenomeCallingComponents::temp_directory() const noexcept
 {
     return components_.temp_directory;
@@ -173,6 +181,26 @@ bool GenomeCallingComponents::sites_only() const noexcept
     return components_.sites_only;
 }
 
+bool GenomeCallingComponents::resume() const noexcept
+{
+    return components_.resume;
+}
+
+bool GenomeCallingComponents::numa_aware() const noexcept
+{
+    return components_.numa_aware;
+}
+
+unsigned GenomeCallingComponents::distributed_jobs() const noexcept
+{
+    return components_.distributed_jobs;
+}
+
+unsigned GenomeCallingComponents::distributed_job_id() const noexcept
+{
+    return components_.distributed_job_id;
+}
+
 const PloidyMap& GenomeCallingComponents::ploidies() const noexcept
 {
     return components_.ploidies;
@@ -207,9 +235,12 @@ std::vector<ContigName> get_unmapped_contigs(const ReadManager& rm, const Refere
     return copy_unmapped_contigs(rm, reference, reference.contig_names());
 }
 
-auto get_search_regions(const options::OptionMap& options, const ReferenceGenome& reference, const ReadManager& rm)
+auto get_search_regions(const options::OptionMap& options, const ReferenceGenome& reference, const ReadManager& rm,
+                        boost::optional<InputRegionMap> warm_regions)
 {
-    auto result = options::get_search_regions(options, reference);
+    // Batch runs resolve search regions once per script and hand them in warm;
+    // any unmapped contig filtering is per job and still happens on the copy
+    auto result = warm_regions ? std::move(*warm_regions) : options::get_search_regions(options, reference);
     if (options::ignore_unmapped_contigs(options)) {
         const auto unmapped_contigs = get_unmapped_contigs(rm, reference);
         if (!unmapped_contigs.empty()) {
@@ -363,7 +394,9 @@ bool require_temp_dir_for_filtering(const options::OptionMap& options)
 
 bool is_temp_directory_needed(const options::OptionMap& options)
 {
-    return is_multithreaded_run(options) || require_temp_dir_for_filtering(options);
+    return is_multithreaded_run(options)
+           || require_temp_dir_for_filtering(options)
+           || options::is_likelihood_cache_spilling_requested(options);
 }
 
 boost::optional<fs::path> get_temp_directory(const options::OptionMap& options)
@@ -474,25 +507,31 @@ public:
 } // namespace
 
 GenomeCallingComponents::Components::Components(ReferenceGenome&& reference, ReadManager&& read_manager,
-                                                VcfWriter&& output, const options::OptionMap& options)
+                                                VcfWriter&& output, const options::OptionMap& options,
+                                                boost::optional<InputRegionMap> warm_search_regions)
 : reference {std::move(reference)}
 , read_manager {std::move(read_manager)}
 , samples {extract_samples(options, this->read_manager)}
-, regions {get_search_regions(options, this->reference, this->read_manager)}
+, regions {get_search_regions(options, this->reference, this->read_manager, std::move(warm_search_regions))}
 , contigs {get_contigs(this->regions, this->reference, options::get_contig_output_order(options))}
 , temp_directory {get_temp_directory(options)}
 , reads_profile_ {profile_reads(this->samples, this->regions, this->read_manager)}
-, read_pipe {options::make_read_pipe(this->read_manager, this->samples, options)}
-, caller_factory {options::make_caller_factory(this->reference, this->read_pipe, this->regions, options, this->reads_profile_)}
+, read_pipe {options::make_read_pipe(this->read_manager, this->samples, options, this->reads_profile_)}
+, caller_factory {options::make_caller_factory(this->reference, this->read_pipe, this->regions, options, this->reads_profile_, this->temp_directory)}
 , call_filter_factory {options::make_call_filter_factory(this->reference, this->read_pipe, options, this->temp_directory)}
 , filter_read_pipe {}
 , output {std::move(output)}
 , num_threads {options::get_num_threads(options)}
 , read_buffer_size {}
+, target_read_buffer_footprint {}
 , progress_meter {regions}
 , ploidies {options::get_ploidy_map(options)}
 , pedigree {options::get_pedigree(options, samples)}
 , sites_only {options::call_sites_only(options)}
+, resume {options::is_resume_run(options)}
+, numa_aware {options::is_numa_aware_mode_requested(options)}
+, distributed_jobs {options::get_num_distributed_jobs(options)}
+, distributed_job_id {options::get_distributed_job_id(options)}
 , filtered_output {}
 , legacy {}
 , filter_request_ {}
@@ -503,6 +542,7 @@ GenomeCallingComponents::Components::Components(ReferenceGenome&& reference, Rea
     setup_progress_meter(options);
     set_read_buffer_size(options);
     setup_writers(options);
+    setup_output_compression_threads();
     setup_filter_read_pipe(options);
     filter_request_ = options::filter_request(options);
     if (filter_request_ && !all_samples_in_vcf(samples, *filter_request_)) {
@@ -521,12 +561,17 @@ void GenomeCallingComponents::Components::setup_progress_meter(const options::Op
     } else {
         progress_meter.set_max_tick_size(0.1);
     }
+    const auto telemetry_file = options::get_progress_telemetry_file(options);
+    if (telemetry_file) {
+        progress_meter.set_telemetry_file(*telemetry_file);
+    }
 }
 
 void GenomeCallingComponents::Components::set_read_buffer_size(const options::OptionMap& options)
 {
     if (!samples.empty() && !regions.empty() && read_manager.good()) {
-        read_buffer_size = calculate_max_num_reads(options::get_target_read_buffer_size(options), reads_profile_);
+        target_read_buffer_footprint = options::get_target_read_buffer_size(options);
+        read_buffer_size = calculate_max_num_reads(target_read_buffer_footprint, reads_profile_);
     }
 }
 
@@ -556,6 +601,21 @@ void GenomeCallingComponents::Components::setup_writers(const options::OptionMap
     }
 }
 
+void GenomeCallingComponents::Components::setup_output_compression_threads()
+{
+    // bgzf block compression of the output is pure serial time on big cohorts;
+    // a small share of the thread budget lets it overlap record conversion
+    constexpr unsigned maxCompressionThreads {4};
+    const auto num_compression_threads = std::min(num_threads ? *num_threads : std::thread::hardware_concurrency(),
+                                                  maxCompressionThreads);
+    if (num_compression_threads > 1) {
+        output.set_threads(num_compression_threads);
+        if (filtered_output) {
+            filtered_output->set_threads(num_compression_threads);
+        }
+    }
+}
+
 void GenomeCallingComponents::Components::setup_filter_read_pipe(const options::OptionMap& options)
 {
     if (!options::use_calling_read_pipe_for_call_filtering(options)) {
@@ -626,10 +686,18 @@ VcfWriter make_output_vcf_writer(const options::OptionMap& options)
 
 } // namespace
 
-GenomeCallingComponents collate_genome_calling_components(const options::OptionMap& options)
+GenomeCallingComponents collate_genome_calling_components(const options::OptionMap& options,
+                                                          boost::optional<ReferenceGenome> warm_reference,
+                                                          boost::optional<InputRegionMap> warm_search_regions)
 {
-    auto reference    = options::make_reference(options);
+    // The reference index and the read file headers are opened independently,
+    // so overlap the two to cut cold start latency. A warm reference handed
+    // in by a batch run is used as is
+    auto reference_future = std::async(std::launch::async, [&options, &warm_reference] () {
+        return warm_reference ? std::move(*warm_reference) : options::make_reference(options);
+    });
     auto read_manager = options::make_read_manager(options);
+    auto reference = reference_future.get();
     // Check this here to avoid creating output file on error
     if (!options::ignore_unmapped_contigs(options) && !all_reference_contigs_mapped(read_manager, reference)) {
         throw UnmatchedReference {reference};
@@ -639,7 +707,8 @@ GenomeCallingComponents collate_genome_calling_components(const options::OptionM
         std::move(reference),
         std::move(read_manager),
         std::move(output),
-        options
+        options,
+        std::move(warm_search_regions)
     };
 }
 
@@ -679,6 +748,7 @@ ContigCallingComponents::ContigCallingComponents(const GenomicRegion::ContigName
 , samples {genome_components.samples()}
 , caller {genome_components.caller_factory().make(contig)}
 , read_buffer_size {genome_components.read_buffer_size()}
+, target_read_buffer_footprint {genome_components.target_read_buffer_footprint()}
 , output {genome_components.output()}
 , progress_meter {genome_components.progress_meter()}
 {}
@@ -691,6 +761,7 @@ ContigCallingComponents::ContigCallingComponents(const GenomicRegion::ContigName
 , samples {genome_components.samples()}
 , caller {genome_components.caller_factory().make(contig)}
 , read_buffer_size {genome_components.read_buffer_size()}
+, target_read_buffer_footprint {genome_components.target_read_buffer_footprint()}
 , output {output}
 , progress_meter {genome_components.progress_meter()}
 {}
@@ -24,6 +24,7 @@
 #include "core/callers/caller_factory.hpp"
 #include "core/csr/filters/variant_call_filter_factory.hpp"
 #include "utils/input_reads_profiler.hpp"
+#include "utils/memory_footprint.hpp"
 #include "logging/progress_meter.hpp"
 
 namespace octopus {
@@ -36,7 +37,8 @@ public:
     GenomeCallingComponents() = delete;
     
     GenomeCallingComponents(ReferenceGenome&& reference, ReadManager&& read_manager,
-                            VcfWriter&& output, const options::OptionMap& options);
+                            VcfWriter&& output, const options::OptionMap& options,
+                            boost::optional<InputRegionMap> warm_search_regions = boost::none);
     
     GenomeCallingComponents(const GenomeCallingComponents&)            = delete;
     GenomeCallingComponents& operator=(const GenomeCallingComponents&) = delete;
@@ -56,6 +58,7 @@ public:
     VcfWriter& output() noexcept;
     const VcfWriter& output() const noexcept;
     std::size_t read_buffer_size() const noexcept;
+    MemoryFootprint target_read_buffer_footprint() const noexcept;
     const boost::optional<Path>& temp_directory() const noexcept;
     boost::optional<unsigned> num_threads() const noexcept;
     const CallerFactory& caller_factory() const noexcept;
@@ -66,6 +69,10 @@ public:
     const ReadPipe& filter_read_pipe() const noexcept;
     ProgressMeter& progress_meter() noexcept;
     bool sites_only() const noexcept;
+    bool resume() const noexcept;
+    bool numa_aware() const noexcept;
+    unsigned distributed_jobs() const noexcept;
+    unsigned distributed_job_id() const noexcept;
     const PloidyMap& ploidies() const noexcept;
     boost::optional<Pedigree> pedigree() const;
     boost::optional<Path> legacy() const;
@@ -79,7 +86,8 @@ private:
         Components() = delete;
         
         Components(ReferenceGenome&& reference, ReadManager&& read_manager,
-                   VcfWriter&& output, const options::OptionMap& options);
+                   VcfWriter&& output, const options::OptionMap& options,
+                   boost::optional<InputRegionMap> warm_search_regions);
         
         Components(const Components&)            = delete;
         Components& operator=(const Components&) = delete;
@@ -102,10 +110,15 @@ private:
         VcfWriter output;
         boost::optional<unsigned> num_threads;
         std::size_t read_buffer_size;
+        MemoryFootprint target_read_buffer_footprint;
         ProgressMeter progress_meter;
         PloidyMap ploidies;
         boost::optional<Pedigree> pedigree;
         bool sites_only;
+        bool resume;
+        bool numa_aware;
+        unsigned distributed_jobs;
+        unsigned distributed_job_id;
         boost::optional<VcfWriter> filtered_output;
         boost::optional<Path> legacy;
         boost::optional<Path> filter_request_;
@@ -114,6 +127,7 @@ private:
         void setup_progress_meter(const options::OptionMap& options);
         void set_read_buffer_size(const options::OptionMap& options);
         void setup_writers(const options::OptionMap& options);
+        void setup_output_compression_threads();
         void setup_filter_read_pipe(const options::OptionMap& options);
     };
     
@@ -122,7 +136,9 @@ private:
     void update_dependents() noexcept;
 };
 
-GenomeCallingComponents collate_genome_calling_components(const options::OptionMap& options);
+GenomeCallingComponents collate_genome_calling_components(const options::OptionMap& options,
+                                                          boost::optional<ReferenceGenome> warm_reference = boost::none,
+                                                          boost::optional<InputRegionMap> warm_search_regions = boost::none);
 
 bool validate(const GenomeCallingComponents& components);
 
@@ -136,6 +152,7 @@ struct ContigCallingComponents
     std::reference_wrapper<const std::vector<SampleName>> samples;
     std::unique_ptr<const Caller> caller;
     std::size_t read_buffer_size;
+    MemoryFootprint target_read_buffer_footprint;
     std::reference_wrapper<VcfWriter> output;
     std::reference_wrapper<ProgressMeter> progress_meter;
     
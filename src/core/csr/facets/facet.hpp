@@ -17,6 +17,7 @@
 #include "core/tools/read_assigner.hpp"
 #include "basics/ploidy_map.hpp"
 #include "basics/pedigree.hpp"
+#include "pileup_stats.hpp"
 
 namespace octopus { namespace csr {
 
@@ -40,6 +41,7 @@ public:
                                       std::reference_wrapper<const Haplotype>,
                                       std::reference_wrapper<const GenotypeMap>,
                                       std::reference_wrapper<const LocalPloidyMap>,
+                                      std::reference_wrapper<const PileupStatsMap>,
                                       std::reference_wrapper<const octopus::Pedigree>
                                      >;
     
@@ -8,11 +8,11 @@
 #include <algorithm>
 #include <iterator>
 #include <array>
-#include <future>
 #include <cassert>
 
 #include "exceptions/program_error.hpp"
 #include "overlapping_reads.hpp"
+#include "pileups.hpp"
 #include "read_assignments.hpp"
 #include "reference_context.hpp"
 #include "samples.hpp"
@@ -133,7 +133,7 @@ bool requires_reference(const std::vector<std::string>& facets) noexcept
 
 bool requires_reads(const std::string& facet) noexcept
 {
-    const static std::array<std::string, 2> read_facets{name<OverlappingReads>(), name<ReadAssignments>()};
+    const static std::array<std::string, 3> read_facets{name<OverlappingReads>(), name<ReadAssignments>(), name<Pileups>()};
     return std::find(std::cbegin(read_facets), std::cend(read_facets), facet) != std::cend(read_facets);
 }
 
@@ -193,48 +193,32 @@ public:
     BadFacetFactoryRequest(std::string facet) : facet_ {std::move(facet)} {}
 };
 
-std::vector<FacetFactory::FacetBlock>
-FacetFactory::make(const std::vector<std::string>& names,
-                   const std::vector<CallBlock>& blocks,
-                   ThreadPool& workers) const
+FacetFactory::BlockData
+FacetFactory::prefetch_block_data(const std::vector<std::string>& names, const CallBlock& block) const
 {
-    if (blocks.empty()) return {};
     check_requirements(names);
-    std::vector<FacetBlock> result {};
-    result.reserve(blocks.size());
-    if (blocks.size() > 1 && !workers.empty()) {
-        std::vector<std::future<FacetBlock>> futures {};
-        futures.reserve(blocks.size());
-        const auto fetch_reads = requires_reads(names);
-        const auto fetch_genotypes = requires_genotypes(names);
-        for (const auto& block : blocks) {
-            // It's faster to fetch reads serially from left to right, so do this outside the thread pool
-            BlockData data {};
-            if (!block.empty()) {
-                data.region = encompassing_region(block);
-                if (fetch_reads) {
-                    data.reads = read_pipe_->fetch_reads(*data.region);
-                }
-            }
-            futures.push_back(workers.push([this, &names, data {std::move(data)}, &block, fetch_genotypes] () mutable {
-                if (fetch_genotypes) {
-                    data.genotypes = extract_genotypes(block, samples_, *reference_);
-                }
-                return this->make(names, data);
-            }));
-        }
-        for (auto& fut : futures) {
-            result.push_back(fut.get());
-        }
-    } else {
-        for (const auto& block : blocks) {
-            const auto data = make_block_data(names, block);
-            result.push_back(make(names, data));
+    BlockData result {};
+    if (!block.empty()) {
+        result.region = encompassing_region(block);
+        // It's faster to fetch reads serially from left to right, so this should be
+        // done on the calling thread rather than from a thread pool
+        if (requires_reads(names)) {
+            result.reads = std::make_shared<const ReadMap>(read_pipe_->fetch_reads(*result.region));
         }
     }
     return result;
 }
 
+FacetFactory::FacetBlock
+FacetFactory::make(const std::vector<std::string>& names, const CallBlock& block, BlockData data) const
+{
+    // Genotype extraction is deferred to here so that it can run on any thread
+    if (!block.empty() && requires_genotypes(names) && !data.genotypes) {
+        data.genotypes = std::make_shared<const GenotypeMap>(extract_genotypes(block, samples_, *reference_));
+    }
+    return make(names, data);
+}
+
 // private methods
 
 void FacetFactory::setup_facet_makers()
@@ -242,7 +226,16 @@ void FacetFactory::setup_facet_makers()
     facet_makers_[name<OverlappingReads>()] = [] (const BlockData& block) -> FacetWrapper
     {
         assert(block.reads);
-        return {std::make_unique<OverlappingReads>(*block.reads)};
+        return {std::make_unique<OverlappingReads>(block.reads)};
+    };
+    facet_makers_[name<Pileups>()] = [] (const BlockData& block) -> FacetWrapper
+    {
+        assert(block.reads);
+        auto stats = std::make_shared<PileupStatsMap>(block.reads->size());
+        for (const auto& p : *block.reads) {
+            stats->emplace(p.first, SamplePileupStats {p.second});
+        }
+        return {std::make_unique<Pileups>(std::move(stats))};
     };
     facet_makers_[name<ReadAssignments>()] = [this] (const BlockData& block) -> FacetWrapper
     {
@@ -265,7 +258,7 @@ void FacetFactory::setup_facet_makers()
     facet_makers_[name<Genotypes>()] = [] (const BlockData& block) -> FacetWrapper
     {
         assert(block.genotypes);
-        return {std::make_unique<Genotypes>(*block.genotypes)};
+        return {std::make_unique<Genotypes>(block.genotypes)};
     };
     facet_makers_[name<Ploidies>()] = [this] (const BlockData& block) -> FacetWrapper
     {
@@ -326,10 +319,10 @@ FacetFactory::BlockData FacetFactory::make_block_data(const std::vector<std::str
     if (!block.empty()) {
         result.region = encompassing_region(block);
         if (requires_reads(names)) {
-            result.reads = read_pipe_->fetch_reads(*result.region);
+            result.reads = std::make_shared<const ReadMap>(read_pipe_->fetch_reads(*result.region));
         }
         if (requires_genotypes(names)) {
-            result.genotypes = extract_genotypes(block, samples_, *reference_);
+            result.genotypes = std::make_shared<const GenotypeMap>(extract_genotypes(block, samples_, *reference_));
         }
     }
     return result;
@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <memory>
 #include <unordered_map>
 
 #include <boost/optional.hpp>
@@ -19,7 +20,6 @@
 #include "io/reference/reference_genome.hpp"
 #include "readpipe/buffered_read_pipe.hpp"
 #include "utils/genotype_reader.hpp"
-#include "utils/thread_pool.hpp"
 #include "facet.hpp"
 
 namespace octopus { namespace csr {
@@ -44,18 +44,22 @@ public:
     
     ~FacetFactory() = default;
     
-    FacetWrapper make(const std::string& name, const CallBlock& block) const;
-    FacetBlock make(const std::vector<std::string>& names, const CallBlock& block) const;
-    std::vector<FacetBlock> make(const std::vector<std::string>& names, const std::vector<CallBlock>& blocks, ThreadPool& workers) const;
-
-private:
+    // A block's raw data, from which the facets themselves can be made on any thread.
+    // The expensive payloads are shared with the facets that expose them rather than
+    // copied into each one
     struct BlockData
     {
         boost::optional<GenomicRegion> region;
-        boost::optional<ReadMap> reads;
-        boost::optional<GenotypeMap> genotypes;
+        std::shared_ptr<const ReadMap> reads;
+        std::shared_ptr<const GenotypeMap> genotypes;
     };
-    
+
+    FacetWrapper make(const std::string& name, const CallBlock& block) const;
+    FacetBlock make(const std::vector<std::string>& names, const CallBlock& block) const;
+    BlockData prefetch_block_data(const std::vector<std::string>& names, const CallBlock& block) const;
+    FacetBlock make(const std::vector<std::string>& names, const CallBlock& block, BlockData data) const;
+
+private:
     VcfHeader input_header_;
     std::vector<std::string> samples_;
     boost::optional<std::reference_wrapper<const ReferenceGenome>> reference_;
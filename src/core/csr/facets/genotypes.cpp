@@ -9,11 +9,11 @@ namespace octopus { namespace csr {
 
 const std::string Genotypes::name_ {"Genotypes"};
 
-Genotypes::Genotypes(GenotypeMap genotypes) : genotypes_ {std::move(genotypes)} {}
+Genotypes::Genotypes(std::shared_ptr<const GenotypeMap> genotypes) : genotypes_ {std::move(genotypes)} {}
 
 Facet::ResultType Genotypes::do_get() const
 {
-    return std::cref(genotypes_);
+    return std::cref(*genotypes_);
 }
 
 } // namespace csr
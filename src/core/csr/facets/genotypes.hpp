@@ -6,6 +6,7 @@
 
 #include <string>
 #include <functional>
+#include <memory>
 
 #include "facet.hpp"
 
@@ -17,12 +18,13 @@ public:
     using ResultType = std::reference_wrapper<const GenotypeMap>;
     
     Genotypes() = default;
-    Genotypes(GenotypeMap genotypes);
+    Genotypes(std::shared_ptr<const GenotypeMap> genotypes);
 
 private:
     static const std::string name_;
     
-    GenotypeMap genotypes_;
+    // Shared with the factory's block data rather than copied
+    std::shared_ptr<const GenotypeMap> genotypes_;
     
     const std::string& do_name() const noexcept override { return name_; }
     Facet::ResultType do_get() const override;
@@ -9,11 +9,11 @@ namespace octopus { namespace csr {
 
 const std::string OverlappingReads::name_ {"OverlappingReads"};
 
-OverlappingReads::OverlappingReads(ReadMap reads) : reads_ {std::move(reads)} {}
+OverlappingReads::OverlappingReads(std::shared_ptr<const ReadMap> reads) : reads_ {std::move(reads)} {}
 
 Facet::ResultType OverlappingReads::do_get() const
 {
-    return std::cref(reads_);
+    return std::cref(*reads_);
 }
 
 } // namespace csr
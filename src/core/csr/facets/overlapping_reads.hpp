@@ -6,6 +6,7 @@
 
 #include <string>
 #include <functional>
+#include <memory>
 
 #include "facet.hpp"
 #include "config/common.hpp"
@@ -20,12 +21,13 @@ public:
     
     OverlappingReads() = default;
     
-    OverlappingReads(ReadMap reads);
+    OverlappingReads(std::shared_ptr<const ReadMap> reads);
 
 private:
     static const std::string name_;
     
-    ReadMap reads_;
+    // Shared with the factory's block data rather than copied
+    std::shared_ptr<const ReadMap> reads_;
     
     const std::string& do_name() const noexcept override { return name_; }
     Facet::ResultType do_get() const override;
@@ -0,0 +1,153 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "pileup_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "basics/aligned_read.hpp"
+#include "concepts/mappable.hpp"
+
+namespace octopus { namespace csr {
+
+namespace {
+
+auto squared(const AlignedRead::MappingQuality mapping_quality) noexcept
+{
+    const auto q = static_cast<std::uint64_t>(mapping_quality);
+    return q * q;
+}
+
+auto prefix_sum(const std::vector<std::uint64_t>& cumulative_sums, const std::size_t n) noexcept
+{
+    return n > 0 ? cumulative_sums[n - 1] : std::uint64_t {0};
+}
+
+} // namespace
+
+SamplePileupStats::SamplePileupStats(const ReadContainer& reads)
+: contig_ {}
+, begins_ {}
+, ends_ {}
+, begin_ordered_squared_mapping_quality_sums_ {}
+, end_ordered_squared_mapping_quality_sums_ {}
+, empty_read_summaries_ {}
+, num_mapping_quality_zero_ {0}
+{
+    if (reads.empty()) return;
+    contig_ = contig_name(reads.front());
+    begins_.reserve(reads.size());
+    begin_ordered_squared_mapping_quality_sums_.reserve(reads.size());
+    std::vector<std::pair<Position, std::uint64_t>> end_summaries {};
+    end_summaries.reserve(reads.size());
+    std::uint64_t running_sum {0};
+    for (const AlignedRead& read : reads) {
+        if (read.mapping_quality() == 0) ++num_mapping_quality_zero_;
+        const auto squared_mapping_quality = squared(read.mapping_quality());
+        if (is_empty_region(read)) {
+            empty_read_summaries_.emplace_back(mapped_begin(read), squared_mapping_quality);
+        } else {
+            // The container is position sorted, so begins come out in order
+            begins_.push_back(mapped_begin(read));
+            running_sum += squared_mapping_quality;
+            begin_ordered_squared_mapping_quality_sums_.push_back(running_sum);
+            end_summaries.emplace_back(mapped_end(read), squared_mapping_quality);
+        }
+    }
+    std::sort(std::begin(end_summaries), std::end(end_summaries));
+    ends_.reserve(end_summaries.size());
+    end_ordered_squared_mapping_quality_sums_.reserve(end_summaries.size());
+    running_sum = 0;
+    for (const auto& summary : end_summaries) {
+        ends_.push_back(summary.first);
+        running_sum += summary.second;
+        end_ordered_squared_mapping_quality_sums_.push_back(running_sum);
+    }
+}
+
+std::size_t SamplePileupStats::count_overlapped(const GenomicRegion& region) const noexcept
+{
+    if (region.contig_name() != contig_) return 0;
+    const auto bounds = overlap_bounds(region.contig_region());
+    auto result = bounds.first - bounds.second;
+    for (const auto& summary : empty_read_summaries_) {
+        if (overlaps(ContigRegion {summary.first, summary.first}, region.contig_region())) {
+            ++result;
+        }
+    }
+    return result;
+}
+
+std::uint64_t SamplePileupStats::sum_squared_mapping_qualities(const GenomicRegion& region) const noexcept
+{
+    if (region.contig_name() != contig_) return 0;
+    const auto bounds = overlap_bounds(region.contig_region());
+    auto result = prefix_sum(begin_ordered_squared_mapping_quality_sums_, bounds.first)
+                  - prefix_sum(end_ordered_squared_mapping_quality_sums_, bounds.second);
+    for (const auto& summary : empty_read_summaries_) {
+        if (overlaps(ContigRegion {summary.first, summary.first}, region.contig_region())) {
+            result += summary.second;
+        }
+    }
+    return result;
+}
+
+std::size_t SamplePileupStats::mapping_quality_zero_count() const noexcept
+{
+    return num_mapping_quality_zero_;
+}
+
+// A read overlaps a non-empty query iff it begins before the query ends and
+// ends after the query begins; a read overlaps an empty query iff the query
+// position is within the read (boundaries included). In either case the reads
+// excluded by the end test are a subset of those admitted by the begin test,
+// so the overlap count is the difference of two binary search bounds
+std::pair<std::size_t, std::size_t>
+SamplePileupStats::overlap_bounds(const ContigRegion& region) const noexcept
+{
+    std::vector<Position>::const_iterator begin_bound, end_bound;
+    if (is_empty(region)) {
+        begin_bound = std::upper_bound(std::cbegin(begins_), std::cend(begins_), region.begin());
+        end_bound   = std::lower_bound(std::cbegin(ends_), std::cend(ends_), region.begin());
+    } else {
+        begin_bound = std::lower_bound(std::cbegin(begins_), std::cend(begins_), region.end());
+        end_bound   = std::upper_bound(std::cbegin(ends_), std::cend(ends_), region.begin());
+    }
+    return {static_cast<std::size_t>(std::distance(std::cbegin(begins_), begin_bound)),
+            static_cast<std::size_t>(std::distance(std::cbegin(ends_), end_bound))};
+}
+
+std::size_t count_overlapped(const PileupStatsMap& stats, const GenomicRegion& region) noexcept
+{
+    std::size_t result {0};
+    for (const auto& p : stats) {
+        result += p.second.count_overlapped(region);
+    }
+    return result;
+}
+
+double rmq_mapping_quality(const PileupStatsMap& stats, const GenomicRegion& region) noexcept
+{
+    std::size_t num_overlapped {0};
+    std::uint64_t sum_squared_mapping_qualities {0};
+    for (const auto& p : stats) {
+        num_overlapped += p.second.count_overlapped(region);
+        sum_squared_mapping_qualities += p.second.sum_squared_mapping_qualities(region);
+    }
+    if (num_overlapped == 0) return 0.0;
+    return std::sqrt(static_cast<double>(sum_squared_mapping_qualities) / num_overlapped);
+}
+
+std::size_t count_mapq_zero(const PileupStatsMap& stats) noexcept
+{
+    std::size_t result {0};
+    for (const auto& p : stats) {
+        result += p.second.mapping_quality_zero_count();
+    }
+    return result;
+}
+
+} // namespace csr
+} // namespace octopus
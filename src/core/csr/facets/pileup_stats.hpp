@@ -0,0 +1,76 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef pileup_stats_hpp
+#define pileup_stats_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "config/common.hpp"
+#include "basics/contig_region.hpp"
+#include "basics/genomic_region.hpp"
+
+namespace octopus { namespace csr {
+
+/*
+ SamplePileupStats summarises one sample's reads into position sorted columns
+ - read begins, read ends, and running squared mapping quality sums - in a
+ single scan, so the read based measures can answer their per call queries
+ with a pair of binary searches rather than each walking the overlapping
+ reads again. Counts and sums agree exactly with what a scan of the
+ equivalent overlap_range would produce.
+*/
+class SamplePileupStats
+{
+public:
+    SamplePileupStats() = default;
+
+    SamplePileupStats(const ReadContainer& reads);
+
+    SamplePileupStats(const SamplePileupStats&)            = default;
+    SamplePileupStats& operator=(const SamplePileupStats&) = default;
+    SamplePileupStats(SamplePileupStats&&)                 = default;
+    SamplePileupStats& operator=(SamplePileupStats&&)      = default;
+
+    ~SamplePileupStats() = default;
+
+    // The number of reads overlapping the given region
+    std::size_t count_overlapped(const GenomicRegion& region) const noexcept;
+    // The sum of squared mapping qualities of reads overlapping the given region
+    std::uint64_t sum_squared_mapping_qualities(const GenomicRegion& region) const noexcept;
+    // The number of reads with mapping quality zero, over all summarised reads
+    std::size_t mapping_quality_zero_count() const noexcept;
+
+private:
+    using Position = ContigRegion::Position;
+
+    GenomicRegion::ContigName contig_;
+    std::vector<Position> begins_, ends_;
+    std::vector<std::uint64_t> begin_ordered_squared_mapping_quality_sums_;
+    std::vector<std::uint64_t> end_ordered_squared_mapping_quality_sums_;
+    // Reads with empty mapped regions (e.g. fully clipped alignments) do not
+    // fit the column query; they are rare enough to scan directly
+    std::vector<std::pair<Position, std::uint64_t>> empty_read_summaries_;
+    std::size_t num_mapping_quality_zero_;
+
+    std::pair<std::size_t, std::size_t> overlap_bounds(const ContigRegion& region) const noexcept;
+};
+
+using PileupStatsMap = std::unordered_map<SampleName, SamplePileupStats>;
+
+// non-member methods
+
+std::size_t count_overlapped(const PileupStatsMap& stats, const GenomicRegion& region) noexcept;
+
+double rmq_mapping_quality(const PileupStatsMap& stats, const GenomicRegion& region) noexcept;
+
+std::size_t count_mapq_zero(const PileupStatsMap& stats) noexcept;
+
+} // namespace csr
+} // namespace octopus
+
+#endif
@@ -0,0 +1,20 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "pileups.hpp"
+
+#include <utility>
+
+namespace octopus { namespace csr {
+
+const std::string Pileups::name_ {"Pileups"};
+
+Pileups::Pileups(std::shared_ptr<const PileupStatsMap> stats) : stats_ {std::move(stats)} {}
+
+Facet::ResultType Pileups::do_get() const
+{
+    return std::cref(*stats_);
+}
+
+} // namespace csr
+} // namespace octopus
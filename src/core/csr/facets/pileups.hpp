@@ -0,0 +1,40 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef pileups_hpp
+#define pileups_hpp
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "facet.hpp"
+#include "pileup_stats.hpp"
+
+namespace octopus { namespace csr {
+
+// Columnar summaries of the block's reads, built in one scan per sample and
+// shared by the read depth and mapping quality measures so each call does not
+// trigger its own walks over the overlapping reads
+class Pileups : public Facet
+{
+public:
+    using ResultType = std::reference_wrapper<const PileupStatsMap>;
+
+    Pileups() = default;
+
+    Pileups(std::shared_ptr<const PileupStatsMap> stats);
+
+private:
+    static const std::string name_;
+
+    std::shared_ptr<const PileupStatsMap> stats_;
+
+    const std::string& do_name() const noexcept override { return name_; }
+    Facet::ResultType do_get() const override;
+};
+
+} // namespace csr
+} // namespace octopus
+
+#endif
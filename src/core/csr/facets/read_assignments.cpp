@@ -46,8 +46,9 @@ ReadAssignments::ReadAssignments(const ReferenceGenome& reference, const Genotyp
             if (!local_reads.empty()) {
                 HaplotypeSupportMap genotype_support {};
                 std::deque<AlignedRead> unassigned {};
+                SupportAlignmentMap support_alignments {};
                 if (!genotype.is_homozygous()) {
-                    genotype_support = compute_haplotype_support(genotype, local_reads, unassigned, assigner_config);
+                    genotype_support = compute_haplotype_support(genotype, local_reads, unassigned, support_alignments, assigner_config);
                 } else {
                     if (is_reference(genotype[0])) {
                         genotype_support[genotype[0]] = std::move(local_reads);
@@ -56,11 +57,11 @@ ReadAssignments::ReadAssignments(const ReferenceGenome& reference, const Genotyp
                         Haplotype ref {mapped_region(genotype), reference};
                         result_.support[sample][ref] = {};
                         augmented_genotype.emplace(std::move(ref));
-                        genotype_support = compute_haplotype_support(augmented_genotype, local_reads, unassigned, assigner_config);
+                        genotype_support = compute_haplotype_support(augmented_genotype, local_reads, unassigned, support_alignments, assigner_config);
                     }
                 }
                 for (auto& s : genotype_support) {
-                    safe_realign_to_reference(s.second, s.first);
+                    safe_realign_to_reference(s.second, s.first, support_alignments);
                     result_.support[sample][s.first] = std::move(s.second);
                 }
                 move_insert(unassigned, sample, result_.ambiguous);
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <numeric>
 #include <iostream>
+#include <future>
 #include <cassert>
 #include <cmath>
 
@@ -65,9 +66,6 @@ ConditionalRandomForestFilter::ConditionalRandomForestFilter(FacetFactory facet_
 , data_buffer_ {}
 {
     check_all_exists(forest_paths_);
-    forests_.reserve(forest_paths_.size());
-    std::generate_n(std::back_inserter(forests_), forest_paths_.size(),
-                    [] () { return std::make_unique<ranger::ForestProbability>(); });
 }
 
 const std::string ConditionalRandomForestFilter::call_qual_name_ = "RFQUAL";
@@ -244,45 +242,77 @@ void ConditionalRandomForestFilter::prepare_for_classification(boost::optional<L
 {
     close_data_files();
     const Path ranger_prefix {temp_dir_ / "octopus_ranger_temp"};
-    const Path ranger_prediction_fname {ranger_prefix.string() + ".prediction"};
     data_buffer_.resize(1);
     auto& predictions = data_buffer_[0];
     predictions.resize(num_records_);
     const auto num_samples = choices_.size();
+    for (auto& record_predictions : predictions) {
+        record_predictions.resize(num_samples);
+    }
+    std::vector<std::pair<std::size_t, std::size_t>> prediction_tasks {};
     for (std::size_t forest_idx {0}; forest_idx < forest_paths_.size(); ++forest_idx) {
         for (std::size_t sample_idx {0}; sample_idx < num_samples; ++sample_idx) {
-            auto forest_choice_itr = std::find(std::cbegin(choices_[sample_idx]), std::cend(choices_[sample_idx]), forest_idx);
+            const auto forest_choice_itr = std::find(std::cbegin(choices_[sample_idx]), std::cend(choices_[sample_idx]), forest_idx);
             if (forest_choice_itr != std::cend(choices_[sample_idx])) {
-                const auto& file = data_[forest_idx][sample_idx];
-                std::vector<std::string> tmp {}, cat_vars {};
-                auto& forest = forests_[forest_idx];
-                try {
-                    forest->initCpp("TP", ranger::MemoryMode::MEM_DOUBLE, file.path.string(), 0, ranger_prefix.string(),
-                                    1000, nullptr, 12, 1, forest_paths_[forest_idx].string(), ranger::ImportanceMode::IMP_GINI, 1, "",
-                                    tmp, "", true, cat_vars, false, ranger::SplitRule::LOGRANK, "", false, 1.0,
-                                    ranger::DEFAULT_ALPHA, ranger::DEFAULT_MINPROP, false,
-                                    ranger::PredictionType::RESPONSE, ranger::DEFAULT_NUM_RANDOM_SPLITS);
-                } catch (const std::runtime_error& e) {
-                    throw MalformedForestFile {forest_paths_[forest_idx]};
-                }
-                forest->run(false);
-                forest->writePredictionFile();
-                std::ifstream prediction_file {ranger_prediction_fname.string()};
-                const auto tp_first = read_header(prediction_file);
-                std::string line;
-                while (std::getline(prediction_file, line)) {
-                    if (!line.empty()) {
-                        const auto record_idx = std::distance(std::cbegin(choices_[sample_idx]), forest_choice_itr);
-                        predictions[record_idx].push_back(get_prob_false(line, tp_first));
-                        assert(forest_choice_itr != std::cend(choices_[sample_idx]));
-                        forest_choice_itr = std::find(std::next(forest_choice_itr), std::cend(choices_[sample_idx]), forest_idx);
-                    }
-                }
-                boost::filesystem::remove(file.path);
+                prediction_tasks.emplace_back(forest_idx, sample_idx);
+            }
+        }
+    }
+    // Each task runs its own forest with a unique output prefix, so tasks can
+    // run concurrently, and writes predictions into its own (record, sample)
+    // slots, so no merge step or synchronisation is needed
+    const auto run_forest_predictions = [&] (const std::size_t forest_idx, const std::size_t sample_idx,
+                                             const unsigned num_threads) {
+        const auto& file = data_[forest_idx][sample_idx];
+        const Path task_prefix {ranger_prefix.string() + "_" + std::to_string(forest_idx) + "_" + std::to_string(sample_idx)};
+        const Path task_prediction_fname {task_prefix.string() + ".prediction"};
+        std::vector<std::string> tmp {}, cat_vars {};
+        const std::unique_ptr<ranger::Forest> forest = std::make_unique<ranger::ForestProbability>();
+        try {
+            forest->initCpp("TP", ranger::MemoryMode::MEM_DOUBLE, file.path.string(), 0, task_prefix.string(),
+                            1000, nullptr, 12, num_threads, forest_paths_[forest_idx].string(), ranger::ImportanceMode::IMP_GINI, 1, "",
+                            tmp, "", true, cat_vars, false, ranger::SplitRule::LOGRANK, "", false, 1.0,
+                            ranger::DEFAULT_ALPHA, ranger::DEFAULT_MINPROP, false,
+                            ranger::PredictionType::RESPONSE, ranger::DEFAULT_NUM_RANDOM_SPLITS);
+        } catch (const std::runtime_error& e) {
+            throw MalformedForestFile {forest_paths_[forest_idx]};
+        }
+        forest->run(false);
+        forest->writePredictionFile();
+        std::ifstream prediction_file {task_prediction_fname.string()};
+        const auto tp_first = read_header(prediction_file);
+        auto forest_choice_itr = std::find(std::cbegin(choices_[sample_idx]), std::cend(choices_[sample_idx]), forest_idx);
+        std::string line;
+        while (std::getline(prediction_file, line)) {
+            if (!line.empty()) {
+                const auto record_idx = std::distance(std::cbegin(choices_[sample_idx]), forest_choice_itr);
+                predictions[record_idx][sample_idx] = get_prob_false(line, tp_first);
+                assert(forest_choice_itr != std::cend(choices_[sample_idx]));
+                forest_choice_itr = std::find(std::next(forest_choice_itr), std::cend(choices_[sample_idx]), forest_idx);
             }
         }
+        boost::filesystem::remove(file.path);
+        boost::filesystem::remove(task_prediction_fname);
+    };
+    auto& prediction_workers = workers();
+    if (!prediction_workers.empty() && prediction_tasks.size() > 1) {
+        // Divide the pool between tasks; ranger parallelises each prediction
+        // over subsets of its trees with the threads given to it
+        const auto num_ranger_threads = static_cast<unsigned>(std::max(prediction_workers.size() / prediction_tasks.size(), std::size_t {1}));
+        std::vector<std::future<void>> futures {};
+        futures.reserve(prediction_tasks.size());
+        for (const auto& task : prediction_tasks) {
+            futures.push_back(prediction_workers.push([&run_forest_predictions, task, num_ranger_threads] () {
+                run_forest_predictions(task.first, task.second, num_ranger_threads);
+            }));
+        }
+        for (auto& future : futures) future.get();
+    } else {
+        const auto num_ranger_threads = static_cast<unsigned>(std::max(prediction_workers.size(), std::size_t {1}));
+        for (const auto& task : prediction_tasks) {
+            run_forest_predictions(task.first, task.second, num_ranger_threads);
+        }
     }
-    boost::filesystem::remove(ranger_prediction_fname);
     data_.clear();
     data_.shrink_to_fit();
     choices_.clear();
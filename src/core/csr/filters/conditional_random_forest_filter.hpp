@@ -14,8 +14,6 @@
 #include <boost/optional.hpp>
 #include <boost/filesystem.hpp>
 
-#include "ranger/Forest.h"
-
 #include "double_pass_variant_call_filter.hpp"
 
 namespace octopus { namespace csr {
@@ -55,7 +53,6 @@ private:
     
     std::vector<Path> forest_paths_;
     Path temp_dir_;
-    std::vector<std::unique_ptr<ranger::Forest>> forests_;
     std::function<std::int8_t(std::vector<Measure::ResultType>)> chooser_;
     std::size_t num_chooser_measures_;
     
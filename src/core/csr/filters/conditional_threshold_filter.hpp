@@ -49,6 +49,10 @@ private:
     std::vector<bool> unique_filter_keys_;
     std::size_t num_chooser_measures_;
     
+    // The active thresholds depend on each call's chooser measures, so blocks
+    // cannot be classified column-wise
+    virtual bool has_uniform_thresholds() const noexcept override { return false; }
+
     virtual bool passes_all_hard_filters(const MeasureVector& measures) const override;
     virtual bool passes_all_soft_filters(const MeasureVector& measures) const override;
     virtual std::vector<std::string> get_failing_vcf_filter_keys(const MeasureVector& measures) const override;
@@ -32,7 +32,7 @@ void DoublePassVariantCallFilter::filter(const VcfReader& source, VcfWriter& des
     assert(dest.is_header_written());
     make_registration_pass(source, samples);
     prepare_for_classification(info_log_);
-    make_filter_pass(source, samples, dest);
+    make_filter_pass(samples, dest);
 }
 
 void DoublePassVariantCallFilter::log_registration_pass(Log& log) const
@@ -47,19 +47,26 @@ void DoublePassVariantCallFilter::make_registration_pass(const VcfReader& source
     if (progress_) progress_->start();
     std::size_t record_idx {0};
     if (can_measure_multiple_blocks()) {
-        for (auto p = source.iterate(); p.first != p.second;) {
-            const auto blocks = read_next_blocks(p.first, p.second, samples);
+        for (auto p = source.iterate(VcfReader::UnpackPolicy::lazy); p.first != p.second;) {
+            auto blocks = read_next_blocks(p.first, p.second, samples);
             record(blocks, record_idx, samples);
-            for (const auto& block : blocks) record_idx += block.size();
+            for (auto& block : blocks) {
+                record_idx += block.size();
+                utils::append(std::move(block), records_);
+            }
         }
     } else if (can_measure_single_call()) {
-        auto p = source.iterate();
-        std::for_each(std::move(p.first), std::move(p.second), [&] (const VcfRecord& call) { record(call, record_idx++, samples); });
+        auto p = source.iterate(VcfReader::UnpackPolicy::lazy);
+        std::for_each(std::move(p.first), std::move(p.second), [&] (const VcfRecord& call) {
+            records_.push_back(call);
+            record(records_.back(), record_idx++, samples);
+        });
     } else {
-        for (auto p = source.iterate(); p.first != p.second;) {
-            const auto block = read_next_block(p.first, p.second, samples);
+        for (auto p = source.iterate(VcfReader::UnpackPolicy::lazy); p.first != p.second;) {
+            auto block = read_next_block(p.first, p.second, samples);
             record(block, record_idx, samples);
             record_idx += block.size();
+            utils::append(std::move(block), records_);
         }
     }
     if (progress_) progress_->stop();
@@ -89,6 +96,7 @@ void DoublePassVariantCallFilter::record(const std::vector<CallBlock>& blocks, s
 void DoublePassVariantCallFilter::record(const VcfRecord& call, const MeasureVector& measures,
                                          const std::size_t record_idx, const SampleList& samples) const
 {
+    record_measures(measures);
     for (std::size_t sample_idx {0}; sample_idx < samples.size(); ++sample_idx) {
         this->record(record_idx, sample_idx, get_sample_values(measures, measures_, sample_idx));
     }
@@ -109,7 +117,7 @@ void DoublePassVariantCallFilter::log_filter_pass_start(Log& log) const
     log << "CSR: Starting filtering pass";
 }
 
-void DoublePassVariantCallFilter::make_filter_pass(const VcfReader& source, const SampleList& samples, VcfWriter& dest) const
+void DoublePassVariantCallFilter::make_filter_pass(const SampleList& samples, VcfWriter& dest) const
 {
     if (info_log_) log_filter_pass_start(*info_log_);
     if (progress_) {
@@ -117,9 +125,14 @@ void DoublePassVariantCallFilter::make_filter_pass(const VcfReader& source, cons
         progress_->set_max_tick_size(10);
         progress_->start();
     }
-    auto p = source.iterate();
+    // The records buffered by the registration pass save a full re-parse of the
+    // source here; columns that pass left packed are materialised on first use
     std::size_t idx {0};
-    std::for_each(std::move(p.first), std::move(p.second), [&] (const VcfRecord& call) { filter(call, idx++, samples, dest); });
+    for (const VcfRecord& call : records_) {
+        filter(call, idx++, samples, dest);
+    }
+    records_.clear();
+    records_.shrink_to_fit();
     if (progress_) progress_->stop();
 }
 
@@ -5,6 +5,7 @@
 #define double_variant_call_filter_hpp
 
 #include <vector>
+#include <deque>
 #include <cstddef>
 
 #include <boost/optional.hpp>
@@ -41,6 +42,9 @@ private:
     mutable boost::optional<Log> info_log_;
     mutable boost::optional<ProgressMeter&> progress_;
     mutable boost::optional<GenomicRegion::ContigName> current_contig_;
+    // The records read in the first pass, kept so the second pass does not need to
+    // re-parse the source; lazily read records stay packed until a column is used
+    mutable std::deque<VcfRecord> records_;
     
     virtual void log_registration_pass(Log& log) const;
     virtual void prepare_for_registration(const SampleList& samples) const {};
@@ -57,7 +61,7 @@ private:
     void record(const std::vector<CallBlock>& blocks, std::size_t record_idx, const SampleList& samples) const;
     void record(const VcfRecord& call, const MeasureVector& measures, std::size_t record_idx, const SampleList& samples) const;
     void record(const CallBlock& block, const MeasureBlock& measures, std::size_t record_idx, const SampleList& samples) const;
-    void make_filter_pass(const VcfReader& source, const SampleList& samples, VcfWriter& dest) const;
+    void make_filter_pass(const SampleList& samples, VcfWriter& dest) const;
     std::vector<Classification> classify(std::size_t call_idx, const SampleList& samples) const;
     void filter(const VcfRecord& call, std::size_t idx, const SampleList& samples, VcfWriter& dest) const;
     void log_progress(const GenomicRegion& region) const;
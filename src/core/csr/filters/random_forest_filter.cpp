@@ -15,6 +15,7 @@
 #include <boost/lexical_cast.hpp>
 
 #include "ranger/ForestProbability.h"
+#include "ranger/DataDouble.h"
 
 #include "basics/phred.hpp"
 
@@ -30,6 +31,7 @@ RandomForestFilter::RandomForestFilter(FacetFactory facet_factory,
 , forest_ {std::make_unique<ranger::ForestProbability>()}
 , ranger_forest_ {std::move(ranger_forest)}
 , temp_dir_ {std::move(temp_directory)}
+, data_ {}
 , num_records_ {0}
 , data_buffer_ {}
 {}
@@ -47,34 +49,9 @@ void RandomForestFilter::annotate(VcfHeader::Builder& header) const
     header.add_filter("RF", "Random Forest filtered");
 }
 
-namespace {
-
-template <typename T>
-static void write_line(const std::vector<T>& data, std::ostream& out)
-{
-    std::copy(std::cbegin(data), std::prev(std::cend(data)), std::ostream_iterator<T> {out, " "});
-    out << data.back() << '\n';
-}
-
-} // namespace
-
 void RandomForestFilter::prepare_for_registration(const SampleList& samples) const
 {
-    std::vector<std::string> data_header {};
-    data_header.reserve(measures_.size());
-    for (const auto& measure : measures_) {
-        data_header.push_back(measure.name());
-    }
-    data_header.push_back("TP");
-    data_.reserve(samples.size());
-    for (const auto& sample : samples) {
-        auto data_path = temp_dir_;
-        Path fname {"octopus_ranger_temp_forest_data_" + sample + ".dat"};
-        data_path /= fname;
-        data_.emplace_back(data_path.string(), data_path);
-        write_line(data_header, data_.back().handle);
-    }
-    data_buffer_.resize(samples.size());
+    data_.resize(samples.size());
 }
 
 namespace {
@@ -111,75 +88,63 @@ auto cast_to_double(const Measure::ResultType& value)
     return vis.result;
 }
 
-void skip_lines(std::istream& in, int n = 1)
-{
-    for (; n > 0; --n) in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-}
-
 } // namespace
 
 void RandomForestFilter::record(const std::size_t call_idx, std::size_t sample_idx, MeasureVector measures) const
 {
     assert(!measures.empty());
-    std::transform(std::cbegin(measures), std::cend(measures), std::back_inserter(data_buffer_[sample_idx]), cast_to_double);
-    data_buffer_[sample_idx].push_back(0); // dummy TP value
-    write_line(data_buffer_[sample_idx], data_[sample_idx].handle);
-    data_buffer_[sample_idx].clear();
+    auto& sample_data = data_[sample_idx];
+    std::transform(std::cbegin(measures), std::cend(measures), std::back_inserter(sample_data), cast_to_double);
+    sample_data.push_back(0); // dummy TP value
     if (call_idx >= num_records_) ++num_records_;
 }
 
-namespace {
-
-bool read_header(std::ifstream& prediction_file)
-{
-    skip_lines(prediction_file);
-    std::string order;
-    std::getline(prediction_file, order);
-    skip_lines(prediction_file);
-    return order.front() == '1';
-}
-
-static double get_prob_false(std::string& prediction_line, const bool tp_first)
-{
-    using std::cbegin; using std::cend;
-    if (tp_first) {
-        prediction_line.erase(cbegin(prediction_line), std::next(std::find(cbegin(prediction_line), cend(prediction_line), ' ')));
-        prediction_line.erase(std::find(cbegin(prediction_line), cend(prediction_line), ' '), cend(prediction_line));
-    } else {
-        prediction_line.erase(std::find(cbegin(prediction_line), cend(prediction_line), ' '), cend(prediction_line));
-    }
-    return boost::lexical_cast<double>(prediction_line);
-}
-
-} // namespace
-
 void RandomForestFilter::prepare_for_classification(boost::optional<Log>& log) const
 {
     const Path ranger_prefix {temp_dir_ / "octopus_ranger_temp"};
-    const Path ranger_prediction_fname {ranger_prefix.string() + ".prediction"};
+    std::vector<std::string> variable_names {};
+    variable_names.reserve(measures_.size() + 1);
+    for (const auto& measure : measures_) {
+        variable_names.push_back(measure.name());
+    }
+    variable_names.push_back("TP");
+    const auto num_cols = variable_names.size();
     data_buffer_.resize(num_records_);
-    for (auto& file : data_) {
-        file.handle.close();
-        std::vector<std::string> tmp {}, cat_vars {};
-        forest_->initCpp("TP", ranger::MemoryMode::MEM_DOUBLE, file.path.string(), 0, ranger_prefix.string(),
-                         1000, nullptr, 12, 1, ranger_forest_.string(), ranger::ImportanceMode::IMP_GINI, 1, "",
-                         tmp, "", true, cat_vars, false, ranger::SplitRule::LOGRANK, "", false, 1.0,
-                         ranger::DEFAULT_ALPHA, ranger::DEFAULT_MINPROP, false,
-                         ranger::PredictionType::RESPONSE, ranger::DEFAULT_NUM_RANDOM_SPLITS);
-        forest_->run(false);
-        forest_->writePredictionFile();
-        std::ifstream prediction_file {ranger_prediction_fname.string()};
-        const auto tp_first = read_header(prediction_file);
-        std::string line;
-        std::size_t record_idx {0};
-        while (std::getline(prediction_file, line)) {
-            if (!line.empty()) {
-                data_buffer_[record_idx++].push_back(get_prob_false(line, tp_first));
+    for (auto& sample_data : data_) {
+        assert(sample_data.size() == num_records_ * num_cols);
+        // The forest wants its data column major, which also makes each feature
+        // contiguous for the tree traversals
+        std::vector<double> columns(sample_data.size());
+        for (std::size_t row {0}; row < num_records_; ++row) {
+            for (std::size_t col {0}; col < num_cols; ++col) {
+                columns[col * num_records_ + row] = sample_data[row * num_cols + col];
             }
         }
-        boost::filesystem::remove(file.path);
+        sample_data.clear();
+        sample_data.shrink_to_fit();
+        auto prediction_data = std::make_unique<ranger::DataDouble>(std::move(columns), variable_names,
+                                                                    num_records_, num_cols);
+        std::vector<std::string> cat_vars {};
+        std::vector<double> sample_fraction {1.0};
+        forest_->init("TP", ranger::MemoryMode::MEM_DOUBLE, std::move(prediction_data), 0, ranger_prefix.string(),
+                      1000, 12, 1, ranger::ImportanceMode::IMP_GINI, 1, "", true, true, cat_vars, false,
+                      ranger::SplitRule::LOGRANK, false, sample_fraction,
+                      ranger::DEFAULT_ALPHA, ranger::DEFAULT_MINPROP, false,
+                      ranger::PredictionType::RESPONSE, ranger::DEFAULT_NUM_RANDOM_SPLITS, false);
+        forest_->loadFromFile(ranger_forest_.string());
+        forest_->run(false);
+        // The class column order is whatever the forest saw in training, so find
+        // the false (0) class rather than assuming a position
+        const auto& class_values = static_cast<const ranger::ForestProbability&>(*forest_).getClassValues();
+        const auto fp_col = static_cast<std::size_t>(std::distance(std::cbegin(class_values),
+                                                                   std::find(std::cbegin(class_values),
+                                                                             std::cend(class_values), 0.0)));
+        const auto& predictions = forest_->getPredictions();
+        assert(predictions.size() == 1 && predictions.front().size() == num_records_);
+        for (std::size_t record_idx {0}; record_idx < num_records_; ++record_idx) {
+            data_buffer_[record_idx].push_back(predictions.front()[record_idx][fp_col]);
+        }
     }
-    boost::filesystem::remove(ranger_prediction_fname);
     data_.clear();
     data_.shrink_to_fit();
 }
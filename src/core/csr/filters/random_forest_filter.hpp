@@ -7,7 +7,6 @@
 #include <vector>
 #include <cstddef>
 #include <memory>
-#include <fstream>
 
 #include <boost/optional.hpp>
 #include <boost/filesystem.hpp>
@@ -41,18 +40,11 @@ public:
     virtual ~RandomForestFilter() override = default;
 
 private:
-    struct File
-    {
-        std::ofstream handle;
-        Path path;
-        template <typename F, typename P>
-        File(F&& handle, P&& path) : handle {std::forward<F>(handle)}, path {std::forward<P>(path)} {};
-    };
-    
     std::unique_ptr<ranger::Forest> forest_;
     Path ranger_forest_, temp_dir_;
     
-    mutable std::vector<File> data_;
+    // One row-major measure matrix per sample, handed to the forest in one batch
+    mutable std::vector<std::vector<double>> data_;
     mutable std::size_t num_records_;
     mutable std::vector<std::vector<double>> data_buffer_;
     
@@ -67,14 +67,23 @@ void SinglePassVariantCallFilter::filter(const std::vector<CallBlock>& blocks, V
 void SinglePassVariantCallFilter::filter(const CallBlock& block, const MeasureBlock& measures, VcfWriter& dest, const SampleList& samples) const
 {
     assert(measures.size() == block.size());
-    for (auto tup : boost::combine(block, measures)) {
-        filter(tup.get<0>(), tup.get<1>(), dest, samples);
+    const auto block_classifications = classify(measures, samples);
+    assert(block_classifications.size() == block.size());
+    for (auto tup : boost::combine(block, measures, block_classifications)) {
+        filter(tup.get<0>(), tup.get<1>(), tup.get<2>(), dest, samples);
     }
 }
 
 void SinglePassVariantCallFilter::filter(const VcfRecord& call, const MeasureVector& measures, VcfWriter& dest, const SampleList& samples) const
 {
-    const auto sample_classifications = classify(measures, samples);
+    filter(call, measures, classify(measures, samples), dest, samples);
+}
+
+void SinglePassVariantCallFilter::filter(const VcfRecord& call, const MeasureVector& measures,
+                                         const ClassificationList& sample_classifications,
+                                         VcfWriter& dest, const SampleList& samples) const
+{
+    record_measures(measures);
     const auto call_classification = merge(sample_classifications, measures);
     if (annotate_measures_) {
         auto annotation_builder = VcfRecord::Builder {call};
@@ -87,6 +96,17 @@ void SinglePassVariantCallFilter::filter(const VcfRecord& call, const MeasureVec
     log_progress(mapped_region(call));
 }
 
+std::vector<VariantCallFilter::ClassificationList>
+SinglePassVariantCallFilter::classify(const MeasureBlock& block_measures, const SampleList& samples) const
+{
+    std::vector<ClassificationList> result {};
+    result.reserve(block_measures.size());
+    for (const auto& call_measures : block_measures) {
+        result.push_back(classify(call_measures, samples));
+    }
+    return result;
+}
+
 VariantCallFilter::ClassificationList
 SinglePassVariantCallFilter::classify(const MeasureVector& call_measures, const SampleList& samples) const
 {
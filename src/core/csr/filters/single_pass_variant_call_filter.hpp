@@ -35,6 +35,10 @@ public:
 protected:
     std::vector<std::string> measure_names_;
     
+    // Classifies a whole block of calls at once, so subclasses can evaluate
+    // measures column-wise; the default just classifies each call in turn
+    virtual std::vector<ClassificationList> classify(const MeasureBlock& block_measures, const SampleList& samples) const;
+    
 private:
     boost::optional<ProgressMeter&> progress_;
     mutable boost::optional<GenomicRegion::ContigName> current_contig_;
@@ -48,6 +52,8 @@ private:
     void filter(const std::vector<CallBlock>& blocks, VcfWriter& dest, const SampleList& samples) const;
     void filter(const CallBlock& block, const MeasureBlock & measures, VcfWriter& dest, const SampleList& samples) const;
     void filter(const VcfRecord& call, const MeasureVector& measures, VcfWriter& dest, const SampleList& samples) const;
+    void filter(const VcfRecord& call, const MeasureVector& measures, const ClassificationList& sample_classifications,
+                VcfWriter& dest, const SampleList& samples) const;
     ClassificationList classify(const MeasureVector& call_measures, const SampleList& samples) const;
     void log_progress(const GenomicRegion& region) const;
 };
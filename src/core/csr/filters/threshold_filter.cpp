@@ -8,6 +8,7 @@
 #include <functional>
 #include <iterator>
 #include <algorithm>
+#include <cstdint>
 
 #include "io/variant/vcf_header.hpp"
 #include "utils/append.hpp"
@@ -106,6 +107,70 @@ VariantCallFilter::Classification ThresholdVariantCallFilter::classify(const Mea
     }
 }
 
+std::vector<VariantCallFilter::ClassificationList>
+ThresholdVariantCallFilter::classify(const MeasureBlock& block_measures, const SampleList& samples) const
+{
+    if (!has_uniform_thresholds()) {
+        return SinglePassVariantCallFilter::classify(block_measures, samples);
+    }
+    const auto num_calls = block_measures.size();
+    std::vector<ClassificationList> result(num_calls, ClassificationList(samples.size()));
+    const auto num_words = (num_calls + 63) / 64;
+    std::vector<std::uint64_t> hard_verdicts(num_words);
+    std::vector<std::vector<std::uint64_t>> soft_fails(soft_thresholds_.size(), std::vector<std::uint64_t>(num_words));
+    std::vector<MeasureVector> sample_values(num_calls);
+    for (std::size_t sample_idx {0}; sample_idx < samples.size(); ++sample_idx) {
+        for (std::size_t call_idx {0}; call_idx < num_calls; ++call_idx) {
+            sample_values[call_idx] = get_sample_values(block_measures[call_idx], measures_, sample_idx);
+        }
+        // Sweeping one threshold down the whole block keeps its comparator's dispatch
+        // target and operand type fixed, so each verdict is a predictable test whose
+        // outcome is packed into a bitmap without branching on it
+        std::fill(std::begin(hard_verdicts), std::end(hard_verdicts), ~std::uint64_t {0});
+        for (std::size_t t {0}; t < hard_thresholds_.size(); ++t) {
+            const auto& threshold = hard_thresholds_[t];
+            for (std::size_t call_idx {0}; call_idx < num_calls; ++call_idx) {
+                const auto fail = static_cast<std::uint64_t>(!threshold(sample_values[call_idx][t]));
+                hard_verdicts[call_idx / 64] &= ~(fail << (call_idx % 64));
+            }
+        }
+        for (std::size_t t {0}; t < soft_thresholds_.size(); ++t) {
+            const auto& threshold = soft_thresholds_[t];
+            const auto measure_idx = hard_thresholds_.size() + t;
+            auto& fails = soft_fails[t];
+            std::fill(std::begin(fails), std::end(fails), std::uint64_t {0});
+            for (std::size_t call_idx {0}; call_idx < num_calls; ++call_idx) {
+                const auto fail = static_cast<std::uint64_t>(!threshold(sample_values[call_idx][measure_idx]));
+                fails[call_idx / 64] |= fail << (call_idx % 64);
+            }
+        }
+        for (std::size_t call_idx {0}; call_idx < num_calls; ++call_idx) {
+            auto& classification = result[call_idx][sample_idx];
+            if (!(hard_verdicts[call_idx / 64] >> (call_idx % 64) & 1)) {
+                classification = Classification {Classification::Category::hard_filtered};
+            } else {
+                std::vector<std::string> failing_keys {};
+                for (std::size_t t {0}; t < soft_thresholds_.size(); ++t) {
+                    if (soft_fails[t][call_idx / 64] >> (call_idx % 64) & 1) {
+                        failing_keys.push_back(vcf_filter_keys_[t]);
+                    }
+                }
+                if (failing_keys.empty()) {
+                    classification = Classification {Classification::Category::unfiltered};
+                } else {
+                    if (!all_unique_filter_keys_) {
+                        std::sort(std::begin(failing_keys), std::end(failing_keys));
+                        failing_keys.erase(std::unique(std::begin(failing_keys), std::end(failing_keys)),
+                                           std::end(failing_keys));
+                    }
+                    classification = Classification {Classification::Category::soft_filtered, std::move(failing_keys)};
+                }
+            }
+        }
+    }
+    return result;
+}
+
 bool ThresholdVariantCallFilter::passes_all_hard_filters(const MeasureVector& measures) const
 {
     return passes_all_filters(std::cbegin(measures), std::next(std::cbegin(measures), hard_thresholds_.size()),
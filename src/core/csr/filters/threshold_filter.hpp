@@ -88,6 +88,11 @@ protected:
 private:
     virtual void annotate(VcfHeader::Builder& header) const override;
     virtual Classification classify(const MeasureVector& measures) const override;
+    std::vector<ClassificationList> classify(const MeasureBlock& block_measures, const SampleList& samples) const override;
+    
+    // Whether the same thresholds apply to every call, which allows blocks to be
+    // classified one threshold at a time rather than one call at a time
+    virtual bool has_uniform_thresholds() const noexcept { return true; }
     
     virtual bool passes_all_hard_filters(const MeasureVector& measures) const;
     virtual bool passes_all_soft_filters(const MeasureVector& measures) const;
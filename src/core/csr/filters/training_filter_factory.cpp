@@ -23,8 +23,10 @@ std::vector<MeasureWrapper> parse_measures(const std::set<std::string>& measure_
 
 } // namespace
 
-TrainingFilterFactory::TrainingFilterFactory(const std::set<std::string>& measure_names)
+TrainingFilterFactory::TrainingFilterFactory(const std::set<std::string>& measure_names,
+                                             boost::optional<Path> measure_columns)
 : measures_ {parse_measures(measure_names)}
+, measure_columns_ {std::move(measure_columns)}
 {}
 
 std::unique_ptr<VariantCallFilterFactory> TrainingFilterFactory::do_clone() const
@@ -40,6 +42,9 @@ std::unique_ptr<VariantCallFilter> TrainingFilterFactory::do_make(FacetFactory f
     output_config.annotate_measures = true;
     output_config.clear_info = true;
     output_config.clear_existing_filters = true;
+    if (measure_columns_) {
+        output_config.measure_columns = *measure_columns_;
+    }
     return std::make_unique<PassingVariantCallFilter>(std::move(facet_factory), std::move(measures_),
                                                       output_config, threading, progress);
 }
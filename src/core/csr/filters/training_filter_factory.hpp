@@ -10,6 +10,7 @@
 #include <set>
 
 #include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
 
 #include "logging/progress_meter.hpp"
 #include "variant_call_filter_factory.hpp"
@@ -23,9 +24,12 @@ class FacetFactory;
 class TrainingFilterFactory : public VariantCallFilterFactory
 {
 public:
+    using Path = boost::filesystem::path;
+    
     TrainingFilterFactory() = default;
     
-    TrainingFilterFactory(const std::set<std::string>& measure_names);
+    TrainingFilterFactory(const std::set<std::string>& measure_names,
+                          boost::optional<Path> measure_columns = boost::none);
     
     TrainingFilterFactory(const TrainingFilterFactory&)            = default;
     TrainingFilterFactory& operator=(const TrainingFilterFactory&) = default;
@@ -36,6 +40,7 @@ public:
 
 private:
     std::vector<MeasureWrapper> measures_;
+    boost::optional<Path> measure_columns_;
     
     std::unique_ptr<VariantCallFilterFactory> do_clone() const override;
     std::unique_ptr<VariantCallFilter> do_make(FacetFactory facet_factory,
@@ -12,10 +12,12 @@
 #include <limits>
 #include <cmath>
 #include <thread>
+#include <future>
 
 #include <boost/range/combine.hpp>
 
 #include "config/common.hpp"
+#include "exceptions/malformed_file_error.hpp"
 #include "containers/mappable_flat_set.hpp"
 #include "containers/mappable_map.hpp"
 #include "core/types/variant.hpp"
@@ -26,7 +28,6 @@
 #include "utils/string_utils.hpp"
 #include "utils/genotype_reader.hpp"
 #include "utils/append.hpp"
-#include "utils/parallel_transform.hpp"
 #include "io/variant/vcf_writer.hpp"
 #include "io/variant/vcf_spec.hpp"
 
@@ -60,8 +61,27 @@ auto get_facets(const std::vector<MeasureWrapper>& measures)
     return result;
 }
 
+auto make_map(const std::vector<std::string>& names, std::vector<FacetWrapper>&& facets)
+{
+    assert(names.size() == facets.size());
+    Measure::FacetMap result {};
+    result.reserve(names.size());
+    for (auto tup : boost::combine(names, std::move(facets))) {
+        result.emplace(tup.get<0>(), std::move(tup.get<1>()));
+    }
+    return result;
+}
+
 } // namespace
 
+class MismatchedMeasureMatrix : public MalformedFileError
+{
+    std::string do_where() const override { return "VariantCallFilter"; }
+    std::string do_help() const override { return "make sure the sidecar was written with the same measures that the re-filter uses"; }
+public:
+    MismatchedMeasureMatrix(boost::filesystem::path file) : MalformedFileError {std::move(file), "measure matrix"} {}
+};
+
 // public methods
 
 VariantCallFilter::VariantCallFilter(FacetFactory facet_factory,
@@ -93,7 +113,31 @@ void VariantCallFilter::filter(const VcfReader& source, VcfWriter& dest) const
         dest << make_header(source);
     }
     const auto samples = source.fetch_header().samples();
+    if (output_config_.measure_sidecar) {
+        sidecar_writer_.emplace(*output_config_.measure_sidecar, measures_);
+    }
+    if (output_config_.measure_columns) {
+        column_writer_.emplace(*output_config_.measure_columns, measures_, samples.size());
+    }
     filter(source, dest, samples);
+    sidecar_writer_ = boost::none;
+    column_writer_ = boost::none;
+}
+
+void VariantCallFilter::filter(const VcfReader& source, VcfWriter& dest, const boost::filesystem::path& measure_sidecar) const
+{
+    measure_source_.emplace(measure_sidecar);
+    std::vector<std::string> measure_names {};
+    measure_names.reserve(measures_.size());
+    for (const auto& measure : measures_) {
+        measure_names.push_back(measure.name());
+    }
+    if (measure_source_->measure_names() != measure_names) {
+        measure_source_ = boost::none;
+        throw MismatchedMeasureMatrix {measure_sidecar};
+    }
+    filter(source, dest);
+    measure_source_ = boost::none;
 }
 
 // protected methods
@@ -227,6 +271,9 @@ VariantCallFilter::read_next_blocks(VcfIterator& first, const VcfIterator& last,
 
 VariantCallFilter::MeasureVector VariantCallFilter::measure(const VcfRecord& call) const
 {
+    if (measure_source_) {
+        return measure_source_->read_row();
+    }
     MeasureVector result(measures_.size());
     if (duplicate_measures_.empty()) {
         std::transform(std::cbegin(measures_), std::cend(measures_), std::begin(result),
@@ -252,6 +299,13 @@ VariantCallFilter::MeasureVector VariantCallFilter::measure(const VcfRecord& cal
 
 VariantCallFilter::MeasureBlock VariantCallFilter::measure(const CallBlock& block) const
 {
+    if (measure_source_) {
+        // Rows were written one per call in filter order, so a block is just the
+        // next block.size() rows
+        MeasureBlock result(block.size());
+        std::generate(std::begin(result), std::end(result), [this] () { return measure_source_->read_row(); });
+        return result;
+    }
     const auto facets = compute_facets(block);
     return measure(block, facets);
 }
@@ -260,15 +314,25 @@ std::vector<VariantCallFilter::MeasureBlock> VariantCallFilter::measure(const st
 {
     std::vector<MeasureBlock> result {};
     result.reserve(blocks.size());
-    if (is_multithreaded()) {
-        const auto facets = compute_facets(blocks);
+    if (is_multithreaded() && !measure_source_) {
         if (debug_log_) {
             stream(*debug_log_) << "Measuring " << blocks.size() << " blocks with " << workers_.size() << " threads";
         }
-        transform(std::cbegin(blocks), std::cend(blocks), std::cbegin(facets), std::back_inserter(result),
-                  [this] (const auto& block, const auto& block_facets) {
-                      return this->measure(block, block_facets);
-                  }, workers_);
+        // Each task makes a block's facets, measures the block with them, then drops
+        // them, so facet data is shared read-only within a block and only the blocks
+        // in flight have facets live at any time
+        std::vector<std::future<MeasureBlock>> futures {};
+        futures.reserve(blocks.size());
+        for (const CallBlock& block : blocks) {
+            auto data = facet_factory_.prefetch_block_data(facet_names_, block);
+            futures.push_back(workers_.push([this, &block, data {std::move(data)}] () mutable {
+                const auto facets = make_map(facet_names_, facet_factory_.make(facet_names_, block, std::move(data)));
+                return this->measure(block, facets);
+            }));
+        }
+        for (auto& fut : futures) {
+            result.push_back(fut.get());
+        }
     } else {
         for (const CallBlock& block : blocks) {
             result.push_back(measure(block));
@@ -298,6 +362,16 @@ void VariantCallFilter::write(const VcfRecord& call, const Classification& class
     }
 }
 
+void VariantCallFilter::record_measures(const MeasureVector& measures) const
+{
+    if (sidecar_writer_) {
+        sidecar_writer_->write(measures);
+    }
+    if (column_writer_) {
+        column_writer_->write(measures);
+    }
+}
+
 void VariantCallFilter::annotate(VcfRecord::Builder& call, const MeasureVector& measures) const
 {
     if (output_config_.clear_info) {
@@ -413,33 +487,11 @@ void VariantCallFilter::annotate(VcfRecord::Builder& call, const Classification
     }
 }
 
-auto make_map(const std::vector<std::string>& names, std::vector<FacetWrapper>&& facets)
-{
-    assert(names.size() == facets.size());
-    Measure::FacetMap result {};
-    result.reserve(names.size());
-    for (auto tup : boost::combine(names, std::move(facets))) {
-        result.emplace(tup.get<0>(), std::move(tup.get<1>()));
-    }
-    return result;
-}
-
 Measure::FacetMap VariantCallFilter::compute_facets(const CallBlock& block) const
 {
     return make_map(facet_names_, facet_factory_.make(facet_names_, block));
 }
 
-std::vector<Measure::FacetMap> VariantCallFilter::compute_facets(const std::vector<CallBlock>& blocks) const
-{
-    auto facets = facet_factory_.make(facet_names_, blocks, workers_);
-    std::vector<Measure::FacetMap> result {};
-    result.reserve(blocks.size());
-    for (auto& block : facets) {
-        result.push_back(make_map(facet_names_, std::move(block)));
-    }
-    return result;
-}
-
 VariantCallFilter::MeasureBlock VariantCallFilter::measure(const CallBlock& block, const Measure::FacetMap& facets) const
 {
     if (debug_log_ && !block.empty()) {
@@ -500,6 +552,11 @@ void VariantCallFilter::fail(VcfRecord::Builder& call, std::vector<std::string>
     }
 }
 
+ThreadPool& VariantCallFilter::workers() const noexcept
+{
+    return workers_;
+}
+
 bool VariantCallFilter::is_multithreaded() const noexcept
 {
     return !workers_.empty();
@@ -12,6 +12,7 @@
 #include <future>
 
 #include <boost/optional.hpp>
+#include <boost/filesystem.hpp>
 
 #include "config/common.hpp"
 #include "basics/phred.hpp"
@@ -25,6 +26,7 @@
 #include "../facets/facet.hpp"
 #include "../facets/facet_factory.hpp"
 #include "../measures/measure.hpp"
+#include "../measures/measure_matrix.hpp"
 
 namespace octopus {
 
@@ -42,6 +44,12 @@ public:
         bool clear_existing_filters = true;
         bool annotate_measures = false;
         bool clear_info = false;
+        // If set, the computed measure matrix is streamed to this sidecar so the
+        // call set can later be re-filtered without recomputing measures
+        boost::optional<boost::filesystem::path> measure_sidecar = boost::none;
+        // If set, measures are also streamed to this directory as one raw
+        // column of doubles per measure, for training tools to mmap directly
+        boost::optional<boost::filesystem::path> measure_columns = boost::none;
     };
     
     struct ConcurrencyPolicy
@@ -64,6 +72,9 @@ public:
     virtual ~VariantCallFilter() = default;
     
     void filter(const VcfReader& source, VcfWriter& dest) const;
+    // Re-filters from a measure matrix sidecar, so no measures are recomputed
+    // and no reads are touched
+    void filter(const VcfReader& source, VcfWriter& dest, const boost::filesystem::path& measure_sidecar) const;
     
 protected:
     using SampleList    = std::vector<SampleName>;
@@ -98,6 +109,8 @@ protected:
                const SampleList& samples, const ClassificationList& sample_classifications,
                VcfWriter& dest) const;
     void annotate(VcfRecord::Builder& call, const MeasureVector& measures) const;
+    void record_measures(const MeasureVector& measures) const;
+    ThreadPool& workers() const noexcept;
     
 private:
     using FacetNameSet = std::vector<std::string>;
@@ -108,6 +121,9 @@ private:
     std::vector<MeasureWrapper> duplicate_measures_;
     
     mutable ThreadPool workers_;
+    mutable boost::optional<MeasureMatrixWriter> sidecar_writer_;
+    mutable boost::optional<MeasureColumnWriter> column_writer_;
+    mutable boost::optional<MeasureMatrixReader> measure_source_;
     
     virtual void annotate(VcfHeader::Builder& header) const = 0;
     virtual void filter(const VcfReader& source, VcfWriter& dest, const SampleList& samples) const = 0;
@@ -117,7 +133,6 @@ private:
     
     VcfHeader make_header(const VcfReader& source) const;
     Measure::FacetMap compute_facets(const CallBlock& block) const;
-    std::vector<Measure::FacetMap> compute_facets(const std::vector<CallBlock>& blocks) const;
     MeasureBlock measure(const CallBlock& block, const Measure::FacetMap& facets) const;
     MeasureVector measure(const VcfRecord& call, const Measure::FacetMap& facets) const;
     VcfRecord::Builder construct_template(const VcfRecord& call) const;
@@ -53,5 +53,19 @@ void copy_denovos(VcfReader::Path source, VcfReader::Path dest)
     copy_denovos(src, dst);
 }
 
+void refilter_calls(const VcfReader& source, VcfWriter& dest, const VariantCallFilter& filter,
+                    const VcfReader::Path& measure_sidecar)
+{
+    filter.filter(source, dest, measure_sidecar);
+}
+
+void refilter_calls(VcfReader::Path source, VcfReader::Path dest, const VariantCallFilter& filter,
+                    const VcfReader::Path& measure_sidecar)
+{
+    VcfReader src {std::move(source)};
+    VcfWriter dst {std::move(dest)};
+    refilter_calls(src, dst, filter, measure_sidecar);
+}
+
 } // namespace csr
 } // namespace octopus
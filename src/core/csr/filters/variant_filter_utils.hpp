@@ -6,6 +6,7 @@
 
 #include "io/variant/vcf_reader.hpp"
 #include "io/variant/vcf_writer.hpp"
+#include "variant_call_filter.hpp"
 
 namespace octopus { namespace csr {
 
@@ -15,6 +16,14 @@ void copy_somatics(VcfReader::Path source, VcfReader::Path dest);
 void copy_denovos(const VcfReader& source, VcfWriter& dest);
 void copy_denovos(VcfReader::Path source, VcfReader::Path dest);
 
+// Re-applies a filter to previously filtered calls using the measure matrix
+// sidecar written by the original run, so no measures are recomputed and no
+// reads are touched
+void refilter_calls(const VcfReader& source, VcfWriter& dest, const VariantCallFilter& filter,
+                    const VcfReader::Path& measure_sidecar);
+void refilter_calls(VcfReader::Path source, VcfReader::Path dest, const VariantCallFilter& filter,
+                    const VcfReader::Path& measure_sidecar);
+
 } // namespace csr
 } // namespace octopus
 
@@ -8,7 +8,7 @@
 #include "io/variant/vcf_record.hpp"
 #include "io/variant/vcf_spec.hpp"
 #include "../facets/samples.hpp"
-#include "../facets/overlapping_reads.hpp"
+#include "../facets/pileups.hpp"
 
 namespace octopus { namespace csr {
 
@@ -30,8 +30,8 @@ Measure::ResultType Depth::do_evaluate(const VcfRecord& call, const FacetMap& fa
 {
     if (aggregate_) {
         if (recalculate_) {
-            const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
-            return static_cast<std::size_t>(count_overlapped(reads, call));
+            const auto& pileups = get_value<Pileups>(facets.at("Pileups"));
+            return count_overlapped(pileups, mapped_region(call));
         } else {
             return static_cast<std::size_t>(std::stoull(call.info_value(vcfspec::info::combinedReadDepth).front()));
         }
@@ -40,9 +40,9 @@ Measure::ResultType Depth::do_evaluate(const VcfRecord& call, const FacetMap& fa
         std::vector<std::size_t> result {};
         result.reserve(samples.size());
         if (recalculate_) {
-            const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
+            const auto& pileups = get_value<Pileups>(facets.at("Pileups"));
             for (const auto& sample : samples) {
-                result.push_back(count_overlapped(reads.at(sample), call));
+                result.push_back(pileups.at(sample).count_overlapped(mapped_region(call)));
             }
         } else {
             for (const auto& sample : samples) {
@@ -76,7 +76,7 @@ std::vector<std::string> Depth::do_requirements() const
 {
     std::vector<std::string> result {};
     if (!aggregate_) result.push_back("Samples");
-    if (recalculate_) result.push_back("OverlappingReads");
+    if (recalculate_) result.push_back("Pileups");
     return result;
 }
 
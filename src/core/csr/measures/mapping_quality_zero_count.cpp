@@ -6,8 +6,7 @@
 #include <boost/variant.hpp>
 
 #include "io/variant/vcf_record.hpp"
-#include "utils/read_stats.hpp"
-#include "../facets/overlapping_reads.hpp"
+#include "../facets/pileups.hpp"
 
 namespace octopus { namespace csr {
 
@@ -23,8 +22,8 @@ std::unique_ptr<Measure> MappingQualityZeroCount::do_clone() const
 Measure::ResultType MappingQualityZeroCount::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
 {
     if (recalculate_) {
-        const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
-        return count_mapq_zero(reads);
+        const auto& pileups = get_value<Pileups>(facets.at("Pileups"));
+        return count_mapq_zero(pileups);
     } else {
         return static_cast<std::size_t>(std::stoull(call.info_value("MQ0").front()));
     }
@@ -48,7 +47,7 @@ std::string MappingQualityZeroCount::do_describe() const
 std::vector<std::string> MappingQualityZeroCount::do_requirements() const
 {
     if (recalculate_) {
-        return {"OverlappingReads"};
+        return {"Pileups"};
     } else {
         return {};
     }
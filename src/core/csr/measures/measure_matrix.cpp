@@ -0,0 +1,338 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "measure_matrix.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "exceptions/missing_file_error.hpp"
+#include "exceptions/malformed_file_error.hpp"
+#include "exceptions/unwritable_file_error.hpp"
+
+namespace octopus { namespace csr {
+
+class MissingMeasureMatrix : public MissingFileError
+{
+    std::string do_where() const override { return "MeasureMatrixReader"; }
+public:
+    MissingMeasureMatrix(boost::filesystem::path file) : MissingFileError {std::move(file), "measure matrix"} {};
+};
+
+class MalformedMeasureMatrix : public MalformedFileError
+{
+    std::string do_where() const override { return "MeasureMatrixReader"; }
+    std::string do_help() const override { return "make sure the sidecar was written by the same version with the same measures"; }
+public:
+    MalformedMeasureMatrix(boost::filesystem::path file) : MalformedFileError {std::move(file), "measure matrix"} {}
+};
+
+class UnwritableMeasureMatrix : public UnwritableFileError
+{
+    std::string do_where() const override { return "MeasureMatrixWriter"; }
+public:
+    UnwritableMeasureMatrix(boost::filesystem::path file) : UnwritableFileError {std::move(file), "measure matrix"} {}
+};
+
+namespace {
+
+// Values are stored native-endian - the sidecar is a machine-local cache, not
+// an interchange format
+static constexpr char magic[] = "OCTMMX1";
+
+template <typename T>
+void write_bytes(std::ostream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T read_bytes(std::istream& in)
+{
+    T result;
+    in.read(reinterpret_cast<char*>(&result), sizeof(result));
+    return result;
+}
+
+// All overloads are declared up front so that nested values (e.g. the vector
+// inside boost::optional<std::vector<int>>) find the right one
+void write_value(std::ostream& out, bool value);
+template <typename T>
+void write_value(std::ostream& out, T value);
+template <typename T>
+void write_value(std::ostream& out, const boost::optional<T>& value);
+template <typename T>
+void write_value(std::ostream& out, const std::vector<T>& values);
+void write_value(std::ostream& out, const std::vector<bool>& values);
+
+void read_value(std::istream& in, bool& value);
+template <typename T>
+void read_value(std::istream& in, T& value);
+template <typename T>
+void read_value(std::istream& in, boost::optional<T>& value);
+template <typename T>
+void read_value(std::istream& in, std::vector<T>& values);
+void read_value(std::istream& in, std::vector<bool>& values);
+
+void write_value(std::ostream& out, const bool value)
+{
+    write_bytes(out, static_cast<std::uint8_t>(value));
+}
+
+template <typename T>
+void write_value(std::ostream& out, const T value)
+{
+    write_bytes(out, value);
+}
+
+template <typename T>
+void write_value(std::ostream& out, const boost::optional<T>& value)
+{
+    write_bytes(out, static_cast<std::uint8_t>(static_cast<bool>(value)));
+    if (value) write_value(out, *value);
+}
+
+template <typename T>
+void write_value(std::ostream& out, const std::vector<T>& values)
+{
+    write_bytes(out, static_cast<std::uint64_t>(values.size()));
+    for (const auto& value : values) write_value(out, value);
+}
+
+void write_value(std::ostream& out, const std::vector<bool>& values)
+{
+    write_bytes(out, static_cast<std::uint64_t>(values.size()));
+    for (const bool value : values) write_value(out, value);
+}
+
+void read_value(std::istream& in, bool& value)
+{
+    value = static_cast<bool>(read_bytes<std::uint8_t>(in));
+}
+
+template <typename T>
+void read_value(std::istream& in, T& value)
+{
+    value = read_bytes<T>(in);
+}
+
+template <typename T>
+void read_value(std::istream& in, boost::optional<T>& value)
+{
+    if (read_bytes<std::uint8_t>(in)) {
+        T tmp;
+        read_value(in, tmp);
+        value = std::move(tmp);
+    } else {
+        value = boost::none;
+    }
+}
+
+template <typename T>
+void read_value(std::istream& in, std::vector<T>& values)
+{
+    values.resize(read_bytes<std::uint64_t>(in));
+    for (auto& value : values) read_value(in, value);
+}
+
+void read_value(std::istream& in, std::vector<bool>& values)
+{
+    values.resize(read_bytes<std::uint64_t>(in));
+    for (std::size_t i {0}; i < values.size(); ++i) {
+        values[i] = static_cast<bool>(read_bytes<std::uint8_t>(in));
+    }
+}
+
+struct WriteValueVisitor : public boost::static_visitor<>
+{
+    explicit WriteValueVisitor(std::ostream& out) : out {out} {}
+    template <typename T>
+    void operator()(const T& value) const { write_value(out, value); }
+    void operator()(const boost::any&) const {} // opaque; restored empty
+    std::ostream& out;
+};
+
+// Each value is tagged with its index in Measure::ResultType, so the sidecar
+// format is tied to the order of alternatives there
+void write_result(std::ostream& out, const Measure::ResultType& value)
+{
+    write_bytes(out, static_cast<std::uint8_t>(value.which()));
+    boost::apply_visitor(WriteValueVisitor {out}, value);
+}
+
+template <typename T>
+Measure::ResultType read_typed(std::istream& in)
+{
+    T value;
+    read_value(in, value);
+    return Measure::ResultType {std::move(value)};
+}
+
+boost::optional<Measure::ResultType> read_result(std::istream& in)
+{
+    switch (read_bytes<std::uint8_t>(in)) {
+        case 0: return read_typed<double>(in);
+        case 1: return read_typed<boost::optional<double>>(in);
+        case 2: return read_typed<std::vector<double>>(in);
+        case 3: return read_typed<std::vector<boost::optional<double>>>(in);
+        case 4: return read_typed<int>(in);
+        case 5: return read_typed<boost::optional<int>>(in);
+        case 6: return read_typed<std::vector<int>>(in);
+        case 7: return read_typed<boost::optional<std::vector<int>>>(in);
+        case 8: return read_typed<std::vector<boost::optional<int>>>(in);
+        case 9: return read_typed<std::size_t>(in);
+        case 10: return read_typed<boost::optional<std::size_t>>(in);
+        case 11: return read_typed<std::vector<std::size_t>>(in);
+        case 12: return read_typed<std::vector<boost::optional<std::size_t>>>(in);
+        case 13: return read_typed<bool>(in);
+        case 14: return read_typed<std::vector<bool>>(in);
+        case 15: return Measure::ResultType {boost::any {}};
+        default: return boost::none;
+    }
+}
+
+void write_string(std::ostream& out, const std::string& str)
+{
+    write_bytes(out, static_cast<std::uint32_t>(str.size()));
+    out.write(str.data(), str.size());
+}
+
+std::string read_string(std::istream& in)
+{
+    std::string result(read_bytes<std::uint32_t>(in), '\0');
+    in.read(&result[0], result.size());
+    return result;
+}
+
+} // namespace
+
+MeasureMatrixWriter::MeasureMatrixWriter(Path sidecar, const std::vector<MeasureWrapper>& measures)
+: sidecar_ {std::move(sidecar)}
+, out_ {sidecar_.string(), std::ios::binary}
+, num_measures_ {measures.size()}
+{
+    if (!out_) {
+        throw UnwritableMeasureMatrix {sidecar_};
+    }
+    out_.write(magic, sizeof(magic));
+    write_bytes(out_, static_cast<std::uint32_t>(measures.size()));
+    for (const auto& measure : measures) {
+        write_string(out_, measure.name());
+    }
+}
+
+void MeasureMatrixWriter::write(const std::vector<Measure::ResultType>& row)
+{
+    assert(row.size() == num_measures_);
+    for (const auto& value : row) {
+        write_result(out_, value);
+    }
+    if (!out_) {
+        throw UnwritableMeasureMatrix {sidecar_};
+    }
+}
+
+namespace {
+
+struct ColumnValueVisitor : public boost::static_visitor<double>
+{
+    template <typename T>
+    double operator()(const T& value) const noexcept { return static_cast<double>(value); }
+    template <typename T>
+    double operator()(const boost::optional<T>& value) const noexcept
+    {
+        return value ? (*this)(*value) : -1;
+    }
+    template <typename T>
+    double operator()(const std::vector<T>&) const noexcept
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    double operator()(const boost::any&) const noexcept
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+};
+
+} // namespace
+
+MeasureColumnWriter::MeasureColumnWriter(Path directory, const std::vector<MeasureWrapper>& measures,
+                                         const std::size_t num_samples)
+: directory_ {std::move(directory)}
+, measures_ {measures}
+, num_samples_ {num_samples}
+, columns_ {}
+{
+    boost::filesystem::create_directories(directory_);
+    columns_.reserve(measures_.size());
+    for (const auto& measure : measures_) {
+        auto column_path = directory_;
+        column_path /= measure.name() + ".col";
+        columns_.emplace_back(column_path.string(), std::ios::binary | std::ios::app);
+        if (!columns_.back()) {
+            throw UnwritableMeasureMatrix {column_path};
+        }
+    }
+}
+
+void MeasureColumnWriter::write(const std::vector<Measure::ResultType>& row)
+{
+    assert(row.size() == measures_.size());
+    for (std::size_t sample_idx {0}; sample_idx < num_samples_; ++sample_idx) {
+        const auto sample_values = get_sample_values(row, measures_, sample_idx);
+        for (std::size_t measure_idx {0}; measure_idx < sample_values.size(); ++measure_idx) {
+            const auto value = boost::apply_visitor(ColumnValueVisitor {}, sample_values[measure_idx]);
+            write_bytes(columns_[measure_idx], value);
+        }
+    }
+}
+
+MeasureMatrixReader::MeasureMatrixReader(Path sidecar)
+: sidecar_ {std::move(sidecar)}
+, in_ {sidecar_.string(), std::ios::binary}
+, measure_names_ {}
+{
+    if (!boost::filesystem::exists(sidecar_)) {
+        throw MissingMeasureMatrix {sidecar_};
+    }
+    char file_magic[sizeof(magic)] {};
+    in_.read(file_magic, sizeof(file_magic));
+    if (!in_ || !std::equal(std::cbegin(magic), std::cend(magic), file_magic)) {
+        throw MalformedMeasureMatrix {sidecar_};
+    }
+    measure_names_.resize(read_bytes<std::uint32_t>(in_));
+    for (auto& name : measure_names_) {
+        name = read_string(in_);
+    }
+    if (!in_) {
+        throw MalformedMeasureMatrix {sidecar_};
+    }
+}
+
+const std::vector<std::string>& MeasureMatrixReader::measure_names() const noexcept
+{
+    return measure_names_;
+}
+
+std::vector<Measure::ResultType> MeasureMatrixReader::read_row()
+{
+    std::vector<Measure::ResultType> result {};
+    result.reserve(measure_names_.size());
+    for (std::size_t i {0}; i < measure_names_.size(); ++i) {
+        auto value = read_result(in_);
+        if (!value || !in_) {
+            throw MalformedMeasureMatrix {sidecar_};
+        }
+        result.push_back(std::move(*value));
+    }
+    return result;
+}
+
+} // namespace csr
+} // namespace octopus
@@ -0,0 +1,109 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef measure_matrix_hpp
+#define measure_matrix_hpp
+
+#include <vector>
+#include <string>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include "measure.hpp"
+
+namespace octopus { namespace csr {
+
+/**
+ Streams a measure matrix (call x measure) to a compact binary sidecar, one row
+ per call in filter order, so that the call set can later be re-filtered with
+ new thresholds or forests without recomputing any measures from reads.
+ */
+class MeasureMatrixWriter
+{
+public:
+    using Path = boost::filesystem::path;
+
+    MeasureMatrixWriter() = delete;
+
+    MeasureMatrixWriter(Path sidecar, const std::vector<MeasureWrapper>& measures);
+
+    MeasureMatrixWriter(const MeasureMatrixWriter&)            = delete;
+    MeasureMatrixWriter& operator=(const MeasureMatrixWriter&) = delete;
+    MeasureMatrixWriter(MeasureMatrixWriter&&)                 = default;
+    MeasureMatrixWriter& operator=(MeasureMatrixWriter&&)      = default;
+
+    ~MeasureMatrixWriter() = default;
+
+    void write(const std::vector<Measure::ResultType>& row);
+
+private:
+    Path sidecar_;
+    std::ofstream out_;
+    std::size_t num_measures_;
+};
+
+/**
+ Streams measures to one raw binary file per measure, each a flat array of
+ native-endian doubles with one value per (call, sample) in filter order -
+ sample-major within a call - so training tools can mmap columns directly.
+ Values follow the forest training-data conventions: missing values are
+ written as -1, and results that cannot be reduced to a single number for a
+ sample are written as NaN. Files are opened for append, so a training matrix
+ can be accumulated over several runs.
+ */
+class MeasureColumnWriter
+{
+public:
+    using Path = boost::filesystem::path;
+
+    MeasureColumnWriter() = delete;
+
+    MeasureColumnWriter(Path directory, const std::vector<MeasureWrapper>& measures, std::size_t num_samples);
+
+    MeasureColumnWriter(const MeasureColumnWriter&)            = delete;
+    MeasureColumnWriter& operator=(const MeasureColumnWriter&) = delete;
+    MeasureColumnWriter(MeasureColumnWriter&&)                 = default;
+    MeasureColumnWriter& operator=(MeasureColumnWriter&&)      = default;
+
+    ~MeasureColumnWriter() = default;
+
+    void write(const std::vector<Measure::ResultType>& row);
+
+private:
+    Path directory_;
+    std::vector<MeasureWrapper> measures_;
+    std::size_t num_samples_;
+    std::vector<std::ofstream> columns_;
+};
+
+class MeasureMatrixReader
+{
+public:
+    using Path = boost::filesystem::path;
+
+    MeasureMatrixReader() = delete;
+
+    MeasureMatrixReader(Path sidecar);
+
+    MeasureMatrixReader(const MeasureMatrixReader&)            = delete;
+    MeasureMatrixReader& operator=(const MeasureMatrixReader&) = delete;
+    MeasureMatrixReader(MeasureMatrixReader&&)                 = default;
+    MeasureMatrixReader& operator=(MeasureMatrixReader&&)      = default;
+
+    ~MeasureMatrixReader() = default;
+
+    const std::vector<std::string>& measure_names() const noexcept;
+
+    std::vector<Measure::ResultType> read_row();
+
+private:
+    Path sidecar_;
+    std::ifstream in_;
+    std::vector<std::string> measure_names_;
+};
+
+} // namespace csr
+} // namespace octopus
+
+#endif
@@ -3,21 +3,114 @@
 
 #include "error_model_factory.hpp"
 
-#include "hiseq_snv_error_model.hpp"
-#include "x10_snv_error_model.hpp"
-#include "hiseq_indel_error_model.hpp"
-#include "x10_indel_error_model.hpp"
+#include "repeat_based_snv_error_model.hpp"
+#include "repeat_based_indel_error_model.hpp"
 
 namespace octopus {
 
+// The profile tables live here rather than in model subclasses; the factory
+// bakes the selected profile into the shared table-driven models
+
+namespace {
+
+const RepeatBasedIndelErrorModel::Parameters hiseqIndelParameters
+{
+    // homopolymer errors
+    {{
+     60,60,50,45,41,36,30,25,22,20,19,17,16,15,14,13,12,11,11,10,
+     9,9,8,8,7,7,7,6,6,6,5,5,5,4,4,4,3,3,3,3,2,2,2,2,2,1,1,1,1,1
+     }},
+    // dinucleotide tandem repeat errors
+    {{
+     60,60,50,46,42,37,31,27,23,22,21,20,19,17,15,13,12,11,11,10,
+     9,9,8,8,7,7,7,6,6,6,5,5,5,4,4,4,3,3,3,3,2,2,2,2,2,1,1,1,1,1
+     }},
+    // trinucleotide tandem repeat errors
+    {{
+     60,60,50,48,46,44,40,38,35,31,28,25,22,20,16,14,13,12,12,11,
+     10,9,8,8,7,7,7,6,6,6,5,5,5,4,4,4,3,3,3,3,2,2,2,2,2,1,1,1,1,1
+     }},
+    // polynucleotide tandem repeat errors
+    {{
+     60,60,51,45,45,45,45,45,23,20,19,17,16,15,14,13,12,11,11,10,
+     9,9,8,8,7,7,7,6,6,6,5,5,5,4,4,4,3,3,3,3,2,2,2,2,2,1,1,1,1,1
+     }},
+    // default gap extension
+    3
+};
+
+const RepeatBasedIndelErrorModel::Parameters x10IndelParameters
+{
+    // homopolymer errors
+    {{
+     60,60,49,44,40,35,28,24,21,19,18,16,15,15,14,13,12,11,11,10,
+     9,9,8,8,7,7,7,6,6,6,5,5,5,4,4,4,3,3,3,3,2,2,2,2,2,1,1,1,1,1
+     }},
+    // dinucleotide tandem repeat errors
+    {{
+     60,59,49,45,41,36,30,26,22,21,20,19,18,17,15,13,12,11,11,10,
+     9,9,8,8,7,7,7,6,6,6,5,5,5,4,4,4,3,3,3,3,2,2,2,2,2,1,1,1,1,1
+     }},
+    // trinucleotide tandem repeat errors
+    {{
+     60,59,49,47,45,43,39,37,34,30,27,24,21,18,16,14,13,12,12,11,
+     10,9,8,8,7,7,7,6,6,6,5,5,5,4,4,4,3,3,3,3,2,2,2,2,2,1,1,1,1,1
+     }},
+    // polynucleotide tandem repeat errors
+    {{
+     60,60,50,44,44,44,44,44,22,19,18,16,16,15,14,13,12,11,11,10,
+     9,9,8,8,7,7,7,6,6,6,5,5,5,4,4,4,3,3,3,3,2,2,2,2,2,1,1,1,1,1
+     }},
+    // default gap extension
+    3
+};
+
+const RepeatBasedSnvErrorModel::Parameters hiseqSnvParameters
+{
+    {{
+     {
+     125, 125, 60, 55, 50, 30, 20, 15, 12, 12, 10, 10, 10, 10, 8, 7, 6, 6, 6, 6,
+     6, 6, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 4, 4, 4, 3, 3, 3, 3, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1
+     },
+     {
+     125, 125, 60, 60, 52, 52, 38, 38, 22, 22, 17, 17, 15, 15, 13, 13, 10, 10, 10, 10,
+     8, 8, 7, 6, 6, 6, 6, 6, 6, 5, 5, 5, 5, 4, 4, 4, 3, 3, 3, 3, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1
+     },
+     {
+     125, 125, 125, 55, 55, 55, 40, 40, 40, 25, 25, 25, 19, 19, 19, 11, 11, 11, 9, 9,
+     9, 7, 7, 6, 6, 6, 6, 6, 6, 5, 5, 5, 5, 4, 4, 4, 3, 3, 3, 3, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1
+     }
+     }}
+};
+
+const RepeatBasedSnvErrorModel::Parameters x10SnvParameters
+{
+    {{
+     {
+     125, 125, 60, 55, 38, 23, 16, 14, 11, 10, 9, 8, 7, 7, 6, 6, 6, 6, 6, 6,
+     6, 6, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 4, 4, 4, 3, 3, 3, 3, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1
+     },
+     {
+     125, 125, 60, 60, 52, 52, 38, 38, 22, 22, 17, 17, 15, 15, 13, 13, 10, 10, 10, 10,
+     8, 8, 7, 6, 6, 6, 6, 6, 6, 5, 5, 5, 5, 4, 4, 4, 3, 3, 3, 3, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1
+     },
+     {
+     125, 125, 125, 55, 55, 55, 40, 40, 40, 25, 25, 25, 19, 19, 19, 11, 11, 11, 9, 9,
+     9, 7, 7, 6, 6, 6, 6, 6, 6, 5, 5, 5, 5, 4, 4, 4, 3, 3, 3, 3, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1
+     }
+     }}
+};
+
+} // namespace
+
 std::unique_ptr<SnvErrorModel> make_snv_error_model()
 {
-    return std::make_unique<HiSeqSnvErrorModel>();
+    return std::make_unique<RepeatBasedSnvErrorModel>(hiseqSnvParameters);
 }
 
 std::unique_ptr<IndelErrorModel> make_indel_error_model()
 {
-    return std::make_unique<HiSeqIndelErrorModel>();
+    return std::make_unique<RepeatBasedIndelErrorModel>(hiseqIndelParameters);
 }
 
 bool is_xten(const std::string& sequencer) noexcept
@@ -28,17 +121,17 @@ bool is_xten(const std::string& sequencer) noexcept
 std::unique_ptr<SnvErrorModel> make_snv_error_model(const std::string& sequencer)
 {
     if (is_xten(sequencer)) {
-        return std::make_unique<X10SnvErrorModel>();
+        return std::make_unique<RepeatBasedSnvErrorModel>(x10SnvParameters);
     }
-    return std::make_unique<HiSeqSnvErrorModel>();
+    return std::make_unique<RepeatBasedSnvErrorModel>(hiseqSnvParameters);
 }
 
 std::unique_ptr<IndelErrorModel> make_indel_error_model(const std::string& sequencer)
 {
     if (is_xten(sequencer)) {
-        return std::make_unique<X10IndelErrorModel>();
+        return std::make_unique<RepeatBasedIndelErrorModel>(x10IndelParameters);
     }
-    return std::make_unique<HiSeqIndelErrorModel>();
+    return std::make_unique<RepeatBasedIndelErrorModel>(hiseqIndelParameters);
 }
     
 } // namespace octopus
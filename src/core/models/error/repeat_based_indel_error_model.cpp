@@ -1,10 +1,11 @@
 // Copyright (c) 2015-2018 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-#include "x10_indel_error_model.hpp"
+#include "repeat_based_indel_error_model.hpp"
 
 #include <algorithm>
 #include <iterator>
+#include <utility>
 
 #include "tandem/tandem.hpp"
 
@@ -12,15 +13,13 @@
 
 namespace octopus {
 
-constexpr decltype(X10IndelErrorModel::homopolymerErrors_) X10IndelErrorModel::homopolymerErrors_;
-constexpr decltype(X10IndelErrorModel::homopolymerErrors_) X10IndelErrorModel::diNucleotideTandemRepeatErrors_;
-constexpr decltype(X10IndelErrorModel::homopolymerErrors_) X10IndelErrorModel::triNucleotideTandemRepeatErrors_;
-constexpr decltype(X10IndelErrorModel::homopolymerErrors_) X10IndelErrorModel::polyNucleotideTandemRepeatErrors_;
-constexpr decltype(X10IndelErrorModel::defaultGapExtension_) X10IndelErrorModel::defaultGapExtension_;
+RepeatBasedIndelErrorModel::RepeatBasedIndelErrorModel(Parameters parameters)
+: parameters_ {std::move(parameters)}
+{}
 
-std::unique_ptr<IndelErrorModel> X10IndelErrorModel::do_clone() const
+std::unique_ptr<IndelErrorModel> RepeatBasedIndelErrorModel::do_clone() const
 {
-    return std::make_unique<X10IndelErrorModel>(*this);
+    return std::make_unique<RepeatBasedIndelErrorModel>(*this);
 }
 
 namespace {
@@ -50,25 +49,25 @@ auto fill_n_if_less(FordwardIt first, std::size_t n, const Tp& value)
 
 } // namespace
 
-X10IndelErrorModel::PenaltyType
-X10IndelErrorModel::do_evaluate(const Haplotype& haplotype, PenaltyVector& gap_open_penalities) const
+RepeatBasedIndelErrorModel::PenaltyType
+RepeatBasedIndelErrorModel::do_evaluate(const Haplotype& haplotype, PenaltyVector& gap_open_penalities) const
 {
     using std::begin; using std::end; using std::cbegin; using std::cend; using std::next;
     const auto repeats = extract_repeats(haplotype);
-    gap_open_penalities.assign(sequence_size(haplotype), homopolymerErrors_.front());
+    gap_open_penalities.assign(sequence_size(haplotype), parameters_.homopolymer_errors.front());
     tandem::Repeat max_repeat {};
     for (const auto& repeat : repeats) {
         std::int8_t e;
         switch (repeat.period) {
         case 1:
         {
-            e = get_penalty(homopolymerErrors_, repeat.length);
+            e = get_penalty(parameters_.homopolymer_errors, repeat.length);
             break;
         }
         case 2:
         {
             static constexpr std::array<char, 2> AC {'A', 'C'};
-            e = get_penalty(diNucleotideTandemRepeatErrors_, repeat.length / 2);
+            e = get_penalty(parameters_.dinucleotide_tandem_repeat_errors, repeat.length / 2);
             const auto it = next(cbegin(haplotype.sequence()), repeat.pos);
             if (e > 10 && std::equal(cbegin(AC), cend(AC), it)) {
                 e -= 2;
@@ -79,7 +78,7 @@ X10IndelErrorModel::do_evaluate(const Haplotype& haplotype, PenaltyVector& gap_o
         {
             static constexpr std::array<char, 3> GGC {'G', 'G', 'C'};
             static constexpr std::array<char, 3> GCC {'G', 'C', 'C'};
-            e = get_penalty(triNucleotideTandemRepeatErrors_, repeat.length / 3);
+            e = get_penalty(parameters_.trinucleotide_tandem_repeat_errors, repeat.length / 3);
             const auto it = next(cbegin(haplotype.sequence()), repeat.pos);
             if (e > 10 && std::equal(cbegin(GGC), cend(GGC), it)) {
                 e -= 2;
@@ -89,7 +88,7 @@ X10IndelErrorModel::do_evaluate(const Haplotype& haplotype, PenaltyVector& gap_o
             break;
         }
         default:
-            e = get_penalty(polyNucleotideTandemRepeatErrors_, repeat.length / repeat.period);
+            e = get_penalty(parameters_.polynucleotide_tandem_repeat_errors, repeat.length / repeat.period);
         }
         fill_n_if_less(next(begin(gap_open_penalities), repeat.pos), repeat.length, e);
         if (repeat.length > max_repeat.length) {
@@ -99,8 +98,8 @@ X10IndelErrorModel::do_evaluate(const Haplotype& haplotype, PenaltyVector& gap_o
     switch (max_repeat.period) {
         case 2:
         case 3: return 1;
-        default: return defaultGapExtension_;
+        default: return parameters_.default_gap_extension;
     }
 }
-    
+
 } // namespace octopus
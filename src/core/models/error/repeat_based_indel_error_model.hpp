@@ -0,0 +1,54 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef repeat_based_indel_error_model_hpp
+#define repeat_based_indel_error_model_hpp
+
+#include <array>
+
+#include "indel_error_model.hpp"
+
+namespace octopus {
+
+class Haplotype;
+
+// Sequencer profiles differ only in their penalty tables, so rather than one
+// subclass per profile the factory bakes the chosen profile's tables into
+// this single concrete model and the evaluation logic reads the flat arrays
+// directly
+class RepeatBasedIndelErrorModel final : public IndelErrorModel
+{
+public:
+    using IndelErrorModel::PenaltyType;
+    using IndelErrorModel::PenaltyVector;
+
+    using PenaltyArray = std::array<PenaltyType, 50>;
+
+    struct Parameters
+    {
+        PenaltyArray homopolymer_errors;
+        PenaltyArray dinucleotide_tandem_repeat_errors;
+        PenaltyArray trinucleotide_tandem_repeat_errors;
+        PenaltyArray polynucleotide_tandem_repeat_errors;
+        PenaltyType default_gap_extension;
+    };
+
+    RepeatBasedIndelErrorModel() = delete;
+
+    explicit RepeatBasedIndelErrorModel(Parameters parameters);
+
+    RepeatBasedIndelErrorModel(const RepeatBasedIndelErrorModel&)            = default;
+    RepeatBasedIndelErrorModel& operator=(const RepeatBasedIndelErrorModel&) = default;
+    RepeatBasedIndelErrorModel(RepeatBasedIndelErrorModel&&)                 = default;
+    RepeatBasedIndelErrorModel& operator=(RepeatBasedIndelErrorModel&&)      = default;
+
+private:
+    Parameters parameters_;
+
+    std::unique_ptr<IndelErrorModel> do_clone() const override;
+    PenaltyType do_evaluate(const Haplotype& haplotype, PenaltyVector& gap_open_penalties) const override;
+};
+
+} // namespace octopus
+
+#endif
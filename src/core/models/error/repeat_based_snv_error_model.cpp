@@ -1,23 +1,28 @@
 // Copyright (c) 2015-2018 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-#include "hiseq_snv_error_model.hpp"
+#include "repeat_based_snv_error_model.hpp"
 
 #include <iterator>
 #include <algorithm>
 #include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
 
-#include <tandem/tandem.hpp>
+#include "tandem/tandem.hpp"
 
-#include <core/types/haplotype.hpp>
+#include "core/types/haplotype.hpp"
 
 namespace octopus {
 
-constexpr decltype(HiSeqSnvErrorModel::maxQualities_) HiSeqSnvErrorModel::maxQualities_;
+RepeatBasedSnvErrorModel::RepeatBasedSnvErrorModel(Parameters parameters)
+: parameters_ {std::move(parameters)}
+{}
 
-std::unique_ptr<SnvErrorModel> HiSeqSnvErrorModel::do_clone() const
+std::unique_ptr<SnvErrorModel> RepeatBasedSnvErrorModel::do_clone() const
 {
-    return std::make_unique<HiSeqSnvErrorModel>(*this);
+    return std::make_unique<RepeatBasedSnvErrorModel>(*this);
 }
 
 namespace {
@@ -123,13 +128,14 @@ auto make_substitution_mask(const Haplotype& haplotype)
 
 } // namespace
 
-void HiSeqSnvErrorModel::do_evaluate(const Haplotype& haplotype,
-                                     MutationVector& forward_snv_mask, PenaltyVector& forward_snv_priors,
-                                     MutationVector& reverse_snv_mask, PenaltyVector& reverse_snv_priors) const
+void RepeatBasedSnvErrorModel::do_evaluate(const Haplotype& haplotype,
+                                           MutationVector& forward_snv_mask, PenaltyVector& forward_snv_priors,
+                                           MutationVector& reverse_snv_mask, PenaltyVector& reverse_snv_priors) const
 {
     using std::cbegin; using std::cend; using std::crbegin; using std::crend;
     using std::begin; using std::rbegin; using std::next;
-    constexpr auto Max_period = maxQualities_.size();
+    constexpr auto Max_period = std::tuple_size<MaxQualityArray>::value;
+    const auto& max_qualities = parameters_.max_qualities;
     const auto repeats = extract_repeats(haplotype, Max_period);
     const auto num_bases = sequence_size(haplotype);
     std::array<std::vector<std::int8_t>, Max_period> repeat_masks {};
@@ -137,7 +143,7 @@ void HiSeqSnvErrorModel::do_evaluate(const Haplotype& haplotype,
     for (const auto& repeat : repeats) {
         std::fill_n(next(begin(repeat_masks[repeat.period - 1]), repeat.pos), repeat.length, repeat_hash(haplotype, repeat));
     }
-    const auto max_quality = maxQualities_.front().front();
+    const auto max_quality = max_qualities.front().front();
     forward_snv_priors.assign(num_bases, max_quality);
     reverse_snv_priors.assign(num_bases, max_quality);
     std::vector<unsigned> runs(num_bases);
@@ -145,9 +151,9 @@ void HiSeqSnvErrorModel::do_evaluate(const Haplotype& haplotype,
         const auto max_gap = i + 2;
         const auto& repeat_mask = repeat_masks[i];
         count_runs(cbegin(repeat_mask), cend(repeat_mask), begin(runs), max_gap);
-        set_priors(runs, forward_snv_priors, maxQualities_[i]);
+        set_priors(runs, forward_snv_priors, max_qualities[i]);
         count_runs(crbegin(repeat_mask), crend(repeat_mask), rbegin(runs), max_gap);
-        set_priors(runs, reverse_snv_priors, maxQualities_[i]);
+        set_priors(runs, reverse_snv_priors, max_qualities[i]);
     }
     const auto substitution_mask = make_substitution_mask(haplotype);
     std::transform(std::cbegin(forward_snv_priors), std::cend(forward_snv_priors), std::cbegin(substitution_mask),
@@ -0,0 +1,53 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef repeat_based_snv_error_model_hpp
+#define repeat_based_snv_error_model_hpp
+
+#include <array>
+#include <cstdint>
+
+#include "snv_error_model.hpp"
+
+namespace octopus {
+
+class Haplotype;
+
+// The table-driven counterpart to RepeatBasedIndelErrorModel: one concrete
+// evaluation routine shared by every sequencer profile, consulting the
+// penalty tables baked in by the factory
+class RepeatBasedSnvErrorModel final : public SnvErrorModel
+{
+public:
+    using SnvErrorModel::MutationVector;
+    using SnvErrorModel::PenaltyType;
+    using SnvErrorModel::PenaltyVector;
+
+    using MaxQualityArray = std::array<std::array<PenaltyType, 51>, 3>;
+
+    struct Parameters
+    {
+        MaxQualityArray max_qualities;
+    };
+
+    RepeatBasedSnvErrorModel() = delete;
+
+    explicit RepeatBasedSnvErrorModel(Parameters parameters);
+
+    RepeatBasedSnvErrorModel(const RepeatBasedSnvErrorModel&)            = default;
+    RepeatBasedSnvErrorModel& operator=(const RepeatBasedSnvErrorModel&) = default;
+    RepeatBasedSnvErrorModel(RepeatBasedSnvErrorModel&&)                 = default;
+    RepeatBasedSnvErrorModel& operator=(RepeatBasedSnvErrorModel&&)      = default;
+
+private:
+    Parameters parameters_;
+
+    std::unique_ptr<SnvErrorModel> do_clone() const override;
+    void do_evaluate(const Haplotype& haplotype,
+                     MutationVector& forward_snv_mask, PenaltyVector& forward_snv_priors,
+                     MutationVector& reverse_snv_mask, PenaltyVector& reverse_snv_priors) const override;
+};
+
+} // namespace octopus
+
+#endif
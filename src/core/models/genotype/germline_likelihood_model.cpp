@@ -10,8 +10,11 @@
 #include <numeric>
 #include <array>
 #include <limits>
+#include <unordered_map>
 #include <cassert>
 
+#include <boost/optional.hpp>
+
 #include "utils/maths.hpp"
 
 namespace octopus { namespace model {
@@ -43,8 +46,6 @@ double GermlineLikelihoodModel::evaluate(const Genotype<Haplotype>& genotype) co
     }
 }
 
-// private methods
-
 namespace {
 
 template <typename T = double>
@@ -65,9 +66,148 @@ static constexpr auto ln(const unsigned n)
     };
     return lnLookup[n];
 }
-    
+
+// In raw pointer form so the compiler has a chance to vectorise over reads;
+// the ploidy normaliser is applied once outside the loop
+double sum_diploid_log_likelihoods(const double* a, const double* b, const std::size_t n) noexcept
+{
+    double result {0};
+    for (std::size_t i {0}; i < n; ++i) {
+        result += maths::log_sum_exp(a[i], b[i]);
+    }
+    return result - n * ln<>(2);
+}
+
+// Genotype sets share their haplotypes (by pointer), so each cache row, and
+// the row reduction that every genotype homozygous for the haplotype repeats,
+// is looked up at most once per batch
+class HaplotypeRowMemo
+{
+public:
+    struct Row
+    {
+        const double* data;
+        std::size_t size;
+        boost::optional<double> sum;
+    };
+
+    HaplotypeRowMemo(const HaplotypeLikelihoodCache& likelihoods, const std::size_t size_hint)
+    : likelihoods_ {likelihoods}
+    {
+        rows_.reserve(size_hint);
+    }
+
+    Row& operator[](const Haplotype& haplotype)
+    {
+        const auto itr = rows_.find(std::addressof(haplotype));
+        if (itr != std::end(rows_)) return itr->second;
+        const auto& log_likelihoods = likelihoods_[haplotype];
+        return rows_.emplace(std::addressof(haplotype),
+                             Row {log_likelihoods.data(), log_likelihoods.size(), boost::none}).first->second;
+    }
+
+    double sum(Row& row)
+    {
+        if (!row.sum) {
+            row.sum = std::accumulate(row.data, row.data + row.size, 0.0);
+        }
+        return *row.sum;
+    }
+
+private:
+    const HaplotypeLikelihoodCache& likelihoods_;
+    std::unordered_map<const Haplotype*, Row> rows_;
+};
+
 } // namespace
 
+std::vector<double> GermlineLikelihoodModel::evaluate_all(const std::vector<Genotype<Haplotype>>& genotypes) const
+{
+    assert(likelihoods_.is_primed());
+    HaplotypeRowMemo rows {likelihoods_, genotypes.size()};
+    std::vector<double> result(genotypes.size());
+    std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(result),
+                   [&] (const Genotype<Haplotype>& genotype) -> double {
+                       switch (genotype.ploidy()) {
+                           case 0: return 0.0;
+                           case 1: return rows.sum(rows[genotype[0]]);
+                           case 2: {
+                               auto& row1 = rows[genotype[0]];
+                               if (genotype.is_homozygous()) {
+                                   return rows.sum(row1);
+                               }
+                               const auto& row2 = rows[genotype[1]];
+                               return sum_diploid_log_likelihoods(row1.data, row2.data, row1.size);
+                           }
+                           default:
+                               if (genotype.zygosity() == 1) {
+                                   return rows.sum(rows[genotype[0]]);
+                               }
+                               return evaluate(genotype);
+                       }
+                   });
+    return result;
+}
+
+// Ploidy-specialised batch paths; as evaluate_all but with the kernel fixed
+// at compile time rather than selected per genotype
+
+template <>
+std::vector<double>
+GermlineLikelihoodModel::evaluate_all<1>(const std::vector<Genotype<Haplotype>>& genotypes) const
+{
+    assert(likelihoods_.is_primed());
+    HaplotypeRowMemo rows {likelihoods_, genotypes.size()};
+    std::vector<double> result(genotypes.size());
+    std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(result),
+                   [&] (const Genotype<Haplotype>& genotype) -> double {
+                       assert(genotype.ploidy() == 1);
+                       return rows.sum(rows[genotype[0]]);
+                   });
+    return result;
+}
+
+template <>
+std::vector<double>
+GermlineLikelihoodModel::evaluate_all<2>(const std::vector<Genotype<Haplotype>>& genotypes) const
+{
+    assert(likelihoods_.is_primed());
+    HaplotypeRowMemo rows {likelihoods_, genotypes.size()};
+    std::vector<double> result(genotypes.size());
+    std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(result),
+                   [&] (const Genotype<Haplotype>& genotype) -> double {
+                       assert(genotype.ploidy() == 2);
+                       auto& row1 = rows[genotype[0]];
+                       if (genotype.is_homozygous()) {
+                           return rows.sum(row1);
+                       }
+                       const auto& row2 = rows[genotype[1]];
+                       return sum_diploid_log_likelihoods(row1.data, row2.data, row1.size);
+                   });
+    return result;
+}
+
+template <>
+double GermlineLikelihoodModel::evaluate<1>(const Genotype<Haplotype>& genotype) const
+{
+    assert(genotype.ploidy() == 1);
+    return evaluate_haploid(genotype);
+}
+
+template <>
+double GermlineLikelihoodModel::evaluate<2>(const Genotype<Haplotype>& genotype) const
+{
+    assert(genotype.ploidy() == 2);
+    const auto& log_likelihoods1 = likelihoods_[genotype[0]];
+    if (genotype.is_homozygous()) {
+        return std::accumulate(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1), 0.0);
+    }
+    const auto& log_likelihoods2 = likelihoods_[genotype[1]];
+    return sum_diploid_log_likelihoods(log_likelihoods1.data(), log_likelihoods2.data(), log_likelihoods1.size());
+}
+
+// private methods
+
 double GermlineLikelihoodModel::evaluate_haploid(const Genotype<Haplotype>& genotype) const
 {
     const auto& log_likelihoods = likelihoods_[genotype[0]];
@@ -4,6 +4,8 @@
 #ifndef germline_likelihood_model_hpp
 #define germline_likelihood_model_hpp
 
+#include <vector>
+
 #include "core/types/haplotype.hpp"
 #include "core/types/genotype.hpp"
 #include "core/models/haplotype_likelihood_cache.hpp"
@@ -25,7 +27,26 @@ public:
     ~GermlineLikelihoodModel() = default;
     
     double evaluate(const Genotype<Haplotype>& genotype) const;
-    
+    // As evaluate over each genotype, but cache rows - and homozygote
+    // reductions, which genotype sets repeat many times - are fetched once
+    // per unique haplotype rather than once per genotype
+    std::vector<double> evaluate_all(const std::vector<Genotype<Haplotype>>& genotypes) const;
+
+    // Compile-time ploidy specialisations of the above for genotypes of
+    // exactly the given ploidy, so callers handling uniform-ploidy sets can
+    // dispatch to a fixed kernel once rather than per genotype. The generic
+    // templates fall back to the runtime-dispatched paths.
+    template <unsigned Ploidy>
+    double evaluate(const Genotype<Haplotype>& genotype) const
+    {
+        return evaluate(genotype);
+    }
+    template <unsigned Ploidy>
+    std::vector<double> evaluate_all(const std::vector<Genotype<Haplotype>>& genotypes) const
+    {
+        return evaluate_all(genotypes);
+    }
+
 private:
     const HaplotypeLikelihoodCache& likelihoods_;
     
@@ -37,6 +58,11 @@ private:
     double evaluate_polyploid(const Genotype<Haplotype>& genotype) const;
 };
 
+template <> double GermlineLikelihoodModel::evaluate<1>(const Genotype<Haplotype>& genotype) const;
+template <> double GermlineLikelihoodModel::evaluate<2>(const Genotype<Haplotype>& genotype) const;
+template <> std::vector<double> GermlineLikelihoodModel::evaluate_all<1>(const std::vector<Genotype<Haplotype>>& genotypes) const;
+template <> std::vector<double> GermlineLikelihoodModel::evaluate_all<2>(const std::vector<Genotype<Haplotype>>& genotypes) const;
+
 } // namespace model
 } // namespace octopus
 
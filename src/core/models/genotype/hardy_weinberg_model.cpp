@@ -5,6 +5,7 @@
 
 #include <utility>
 #include <numeric>
+#include <array>
 #include <algorithm>
 #include <iterator>
 #include <cmath>
@@ -71,6 +72,52 @@ HardyWeinbergModel::HaplotypeFrequencyVector& HardyWeinbergModel::index_frequenc
 
 namespace {
 
+// Genotype ploidies - and hence haplotype occurence counts - are tiny, so the
+// log factorials feeding the multinomial coefficients are taken from a table
+// computed once rather than from scratch on every genotype
+constexpr unsigned maxPrecomputedFactorial {64};
+
+const auto& log_factorial_table() noexcept
+{
+    static const auto result = [] () noexcept {
+        std::array<double, maxPrecomputedFactorial + 1> table {};
+        for (unsigned k {2}; k <= maxPrecomputedFactorial; ++k) {
+            table[k] = table[k - 1] + std::log(k);
+        }
+        return table;
+    }();
+    return result;
+}
+
+double log_factorial(const unsigned k)
+{
+    if (k <= maxPrecomputedFactorial) return log_factorial_table()[k];
+    return maths::log_factorial<double>(k);
+}
+
+double log_multinomial_coefficient(const std::vector<unsigned>& counts)
+{
+    unsigned n {0};
+    double denominator {0};
+    for (const auto k : counts) {
+        n += k;
+        denominator += log_factorial(k);
+    }
+    return log_factorial(n) - denominator;
+}
+
+template <typename Range>
+double log_multinomial_pdf(const std::vector<unsigned>& counts, const Range& probabilities)
+{
+    auto result = log_multinomial_coefficient(counts);
+    for (std::size_t i {0}; i < counts.size(); ++i) {
+        if (counts[i] > 0) {
+            result += counts[i] * std::log(probabilities[i]);
+        }
+    }
+    return result;
+}
+
 auto ln_hardy_weinberg_haploid(const Genotype<Haplotype>& genotype,
                                const HardyWeinbergModel::HaplotypeFrequencyMap& haplotype_frequencies)
 {
@@ -99,7 +146,7 @@ auto ln_hardy_weinberg_polyploid(const Genotype<Haplotype>& genotype,
         occurences.push_back(num_occurences);
         r += num_occurences * std::log(haplotype_frequencies.at(haplotype));
     }
-    return maths::log_multinomial_coefficient<double>(occurences) + r;
+    return log_multinomial_coefficient(occurences) + r;
 }
 
 auto ln_hardy_weinberg_haploid(const GenotypeIndex& genotype,
@@ -123,7 +170,7 @@ auto ln_hardy_weinberg_polyploid(const GenotypeIndex& genotype,
 {
     std::vector<unsigned> counts(haplotype_frequencies.size());
     for (auto idx : genotype) ++counts[idx];
-    return maths::log_multinomial_pdf<>(counts, haplotype_frequencies);
+    return log_multinomial_pdf(counts, haplotype_frequencies);
 }
 
 template <typename Range>
@@ -169,7 +216,7 @@ double HardyWeinbergModel::evaluate(const Genotype<Haplotype>& genotype) const
             counts.push_back(1);
         }
         auto probs = to_frequencies(counts);
-        return maths::log_multinomial_pdf(counts, probs);
+        return log_multinomial_pdf(counts, probs);
     }
 }
 
@@ -221,7 +268,7 @@ double HardyWeinbergModel::evaluate(const GenotypeIndex& genotype) const
             counts.push_back(1);
         }
         auto probs = to_frequencies(counts);
-        return maths::log_multinomial_pdf(counts, probs);
+        return log_multinomial_pdf(counts, probs);
     }
 }
 
@@ -333,4 +380,45 @@ double HardyWeinbergModel::evaluate(const GenotypeIndexReferenceVector& genotype
     }
 }
 
+namespace {
+
+template <typename Range>
+std::vector<double> evaluate_each_helper(const Range& genotypes, const HardyWeinbergModel& model)
+{
+    std::vector<double> result(genotypes.size());
+    std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(result),
+                   [&model] (const auto& genotype) { return model.evaluate(get(genotype)); });
+    return result;
+}
+
+} // namespace
+
+std::vector<double> HardyWeinbergModel::evaluate_each(const std::vector<Genotype<Haplotype>>& genotypes) const
+{
+    if (empirical_) {
+        return evaluate_each_helper(genotypes, *this);
+    } else {
+        fill_frequencies(genotypes, haplotype_frequencies_);
+        empirical_ = true;
+        auto result = evaluate_each_helper(genotypes, *this);
+        haplotype_frequencies_.clear();
+        empirical_ = false;
+        return result;
+    }
+}
+
+std::vector<double> HardyWeinbergModel::evaluate_each(const GenotypeIndexVector& genotypes) const
+{
+    if (empirical_) {
+        return evaluate_each_helper(genotypes, *this);
+    } else {
+        fill_frequencies(genotypes, haplotype_idx_frequencies_);
+        empirical_ = true;
+        auto result = evaluate_each_helper(genotypes, *this);
+        haplotype_idx_frequencies_.clear();
+        empirical_ = false;
+        return result;
+    }
+}
+
 } // namespace
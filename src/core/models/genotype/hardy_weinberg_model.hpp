@@ -54,7 +54,12 @@ public:
     double evaluate(const GenotypeReferenceVector& genotypes) const;
     double evaluate(const GenotypeIndexVector& genotypes) const;
     double evaluate(const GenotypeIndexReferenceVector& genotypes) const;
-    
+
+    // As the joint evaluate overloads but returning each genotype's log
+    // probability, sharing a single frequency setup across the batch
+    std::vector<double> evaluate_each(const std::vector<Genotype<Haplotype>>& genotypes) const;
+    std::vector<double> evaluate_each(const GenotypeIndexVector& genotypes) const;
+
 private:
     boost::optional<Haplotype> reference_;
     boost::optional<unsigned> reference_idx_;
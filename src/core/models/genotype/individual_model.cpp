@@ -5,6 +5,7 @@
 
 #include <utility>
 #include <algorithm>
+#include <numeric>
 #include <cmath>
 #include <cassert>
 #include <iostream>
@@ -57,12 +58,18 @@ auto compute_likelihoods(const std::vector<Genotype<Haplotype>>& genotypes,
 {
     assert(haplotype_likelihoods.is_primed());
     const GermlineLikelihoodModel likelihood_model {haplotype_likelihoods};
-    ProbabilityVector result(genotypes.size());
-    std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(result),
-                   [&likelihood_model] (const auto& genotype) {
-                       return likelihood_model.evaluate(genotype);
-                   });
-    return result;
+    // Candidate genotype sets are usually uniform ploidy, so the likelihood
+    // kernel can be dispatched once for the whole set rather than per genotype
+    const auto ploidy = genotypes.front().ploidy();
+    if (std::all_of(std::cbegin(genotypes), std::cend(genotypes),
+                    [ploidy] (const auto& genotype) { return genotype.ploidy() == ploidy; })) {
+        switch (ploidy) {
+            case 1: return likelihood_model.evaluate_all<1>(genotypes);
+            case 2: return likelihood_model.evaluate_all<2>(genotypes);
+            default: break;
+        }
+    }
+    return likelihood_model.evaluate_all(genotypes);
 }
 
 template <typename Container>
@@ -105,6 +112,27 @@ IndividualModel::evaluate(const std::vector<Genotype<Haplotype>>& genotypes,
     return {{std::move(result)}, log_evidence};
 }
 
+boost::optional<IndividualModel::InferredLatents>
+IndividualModel::downdate(const InferredLatents& latents,
+                          const std::vector<std::size_t>& surviving_genotype_indices) const
+{
+    const auto& posteriors = latents.posteriors.genotype_probabilities;
+    ProbabilityVector result(surviving_genotype_indices.size());
+    std::transform(std::cbegin(surviving_genotype_indices), std::cend(surviving_genotype_indices),
+                   std::begin(result), [&] (const auto genotype_idx) {
+                       assert(genotype_idx < posteriors.size());
+                       return posteriors[genotype_idx];
+                   });
+    const auto retained_mass = std::accumulate(std::cbegin(result), std::cend(result), 0.0);
+    // The restricted posterior is exact up to normalisation, and the evidence
+    // of the restricted model is just the retained share of the full evidence.
+    // If essentially no mass survives then the division is unreliable and the
+    // model needs to be re-evaluated from scratch.
+    if (!(retained_mass > 0)) return boost::none;
+    for (auto& p : result) p /= retained_mass;
+    return InferredLatents {{std::move(result)}, latents.log_evidence + std::log(retained_mass)};
+}
+
 namespace debug {
 
 using octopus::debug::print_variant_alleles;
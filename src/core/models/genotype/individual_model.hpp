@@ -52,7 +52,16 @@ public:
     InferredLatents evaluate(const std::vector<Genotype<Haplotype>>& genotypes,
                              const std::vector<GenotypeIndex>& genotype_indices,
                              const HaplotypeLikelihoodCache& haplotype_likelihoods) const;
-    
+
+    // Renormalises previously inferred latents over a subset of the evaluated
+    // genotypes - as evaluate would over the subset alone, but without
+    // recomputing any likelihoods. Valid whenever haplotypes have only been
+    // removed since the full evaluation; returns boost::none if the retained
+    // posterior mass is too small to renormalise reliably.
+    boost::optional<InferredLatents>
+    downdate(const InferredLatents& latents,
+             const std::vector<std::size_t>& surviving_genotype_indices) const;
+
 private:
     const GenotypePriorModel& genotype_prior_model_;
     
@@ -7,6 +7,7 @@
 #include <utility>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <limits>
 #include <cassert>
 
@@ -156,13 +157,8 @@ compute_genotype_log_likelihoods(const std::vector<SampleName>& samples,
     result.reserve(samples.size());
     std::transform(std::cbegin(samples), std::cend(samples), std::back_inserter(result),
                    [&genotypes, &haplotype_likelihoods, &likelihood_model] (const auto& sample) {
-                       GenotypeLogLikelihoodVector likelihoods(genotypes.size());
                        haplotype_likelihoods.prime(sample);
-                       std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(likelihoods),
-                                      [&likelihood_model] (const auto& genotype) {
-                                          return likelihood_model.evaluate(genotype);
-                                      });
-                       return likelihoods;
+                       return likelihood_model.evaluate_all(genotypes);
                    });
     return result;
 }
@@ -171,73 +167,130 @@ GenotypeLogMarginalVector
 init_genotype_log_marginals(const std::vector<Genotype<Haplotype>>& genotypes,
                             const HardyWeinbergModel& hw_model)
 {
+    const auto log_marginals = hw_model.evaluate_each(genotypes);
     GenotypeLogMarginalVector result {};
     result.reserve(genotypes.size());
+    std::size_t genotype_idx {0};
     for (const auto& genotype : genotypes) {
-        result.push_back({genotype, hw_model.evaluate(genotype)});
+        result.push_back({genotype, log_marginals[genotype_idx++]});
     }
     return result;
 }
 
-void update_genotype_log_marginals(GenotypeLogMarginalVector& current_log_marginals,
-                                   const HardyWeinbergModel& hw_model)
+// The set of genotypes still in play for one sample during EM, stored as
+// indices into the full genotype vector with a parallel compact posterior
+// vector; pruned genotypes carry no posterior mass and are skipped entirely
+// by subsequent sweeps
+struct SparseGenotypeSet
 {
-    std::for_each(std::begin(current_log_marginals), std::end(current_log_marginals),
-                  [&hw_model] (auto& p) { p.log_probability = hw_model.evaluate(p.genotype); });
-}
+    std::vector<std::uint32_t> genotype_indices;
+    GenotypeMarginalPosteriorVector posteriors;
+};
+using SparseGenotypeSetVector = std::vector<SparseGenotypeSet>; // one per sample
 
-GenotypeMarginalPosteriorMatrix
-init_genotype_posteriors(const GenotypeLogMarginalVector& genotype_log_marginals,
-                         const GenotypeLogLikelihoodMatrix& genotype_log_likilhoods)
+auto init_sparse_genotype_sets(const GenotypeLogMarginalVector& genotype_log_marginals,
+                               const GenotypeLogLikelihoodMatrix& genotype_log_likilhoods)
 {
-    GenotypeMarginalPosteriorMatrix result {};
+    SparseGenotypeSetVector result {};
     result.reserve(genotype_log_likilhoods.size());
+    const auto num_genotypes = genotype_log_marginals.size();
     for (const auto& sample_genotype_log_likilhoods : genotype_log_likilhoods) {
-        GenotypeMarginalPosteriorVector posteriors(genotype_log_marginals.size());
+        SparseGenotypeSet set {};
+        set.genotype_indices.resize(num_genotypes);
+        std::iota(std::begin(set.genotype_indices), std::end(set.genotype_indices), 0u);
+        set.posteriors.resize(num_genotypes);
         std::transform(std::cbegin(genotype_log_marginals), std::cend(genotype_log_marginals),
-                       std::cbegin(sample_genotype_log_likilhoods), std::begin(posteriors),
+                       std::cbegin(sample_genotype_log_likilhoods), std::begin(set.posteriors),
                        [] (const auto& genotype_log_marginal, const auto genotype_log_likilhood) {
                            return genotype_log_marginal.log_probability + genotype_log_likilhood;
                        });
-        maths::normalise_exp(posteriors);
-        result.emplace_back(std::move(posteriors));
+        maths::normalise_exp(set.posteriors);
+        result.push_back(std::move(set));
     }
     return result;
 }
 
-void update_genotype_posteriors(GenotypeMarginalPosteriorMatrix& current_genotype_posteriors,
-                                const GenotypeLogMarginalVector& genotype_log_marginals,
-                                const GenotypeLogLikelihoodMatrix& genotype_log_likilhoods)
+void update_sparse_genotype_posteriors(SparseGenotypeSetVector& genotype_sets,
+                                       const GenotypeLogMarginalVector& genotype_log_marginals,
+                                       const GenotypeLogLikelihoodMatrix& genotype_log_likilhoods)
 {
     auto likelihood_itr = std::cbegin(genotype_log_likilhoods);
-    for (auto& sample_genotype_posteriors : current_genotype_posteriors) {
-        std::transform(std::cbegin(genotype_log_marginals), std::cend(genotype_log_marginals),
-                       std::cbegin(*likelihood_itr++), std::begin(sample_genotype_posteriors),
-                       [] (const auto& log_marginal, const auto& log_likeilhood) {
-                           return log_marginal.log_probability + log_likeilhood;
+    for (auto& set : genotype_sets) {
+        const auto& sample_genotype_log_likilhoods = *likelihood_itr++;
+        std::transform(std::cbegin(set.genotype_indices), std::cend(set.genotype_indices), std::begin(set.posteriors),
+                       [&] (const auto genotype_idx) {
+                           return genotype_log_marginals[genotype_idx].log_probability
+                                  + sample_genotype_log_likilhoods[genotype_idx];
                        });
-        maths::normalise_exp(sample_genotype_posteriors);
+        maths::normalise_exp(set.posteriors);
+    }
+}
+
+void prune_sparse_genotype_sets(SparseGenotypeSetVector& genotype_sets, const double min_posterior)
+{
+    for (auto& set : genotype_sets) {
+        const auto num_active = set.genotype_indices.size();
+        std::size_t num_kept {0};
+        double kept_mass {0};
+        for (std::size_t i {0}; i < num_active; ++i) {
+            if (set.posteriors[i] >= min_posterior) {
+                set.genotype_indices[num_kept] = set.genotype_indices[i];
+                set.posteriors[num_kept] = set.posteriors[i];
+                kept_mass += set.posteriors[i];
+                ++num_kept;
+            }
+        }
+        // The threshold can only empty a set if it exceeds 1 / num_active; leave
+        // such sets alone rather than guess
+        if (num_kept > 0 && num_kept < num_active) {
+            set.genotype_indices.resize(num_kept);
+            set.posteriors.resize(num_kept);
+            for (auto& posterior : set.posteriors) posterior /= kept_mass;
+        }
+    }
+}
+
+auto flag_active_genotypes(const SparseGenotypeSetVector& genotype_sets, const std::size_t num_genotypes)
+{
+    std::vector<char> result(num_genotypes, 0);
+    for (const auto& set : genotype_sets) {
+        for (const auto genotype_idx : set.genotype_indices) {
+            result[genotype_idx] = 1;
+        }
+    }
+    return result;
+}
+
+void update_genotype_log_marginals(GenotypeLogMarginalVector& current_log_marginals,
+                                   const HardyWeinbergModel& hw_model,
+                                   const std::vector<char>& active_genotypes)
+{
+    for (std::size_t genotype_idx {0}; genotype_idx < current_log_marginals.size(); ++genotype_idx) {
+        if (active_genotypes[genotype_idx]) {
+            auto& marginal = current_log_marginals[genotype_idx];
+            marginal.log_probability = hw_model.evaluate(marginal.genotype);
+        }
     }
 }
 
-auto collapse_genotype_posteriors(const GenotypeMarginalPosteriorMatrix& genotype_posteriors)
+auto collapse_sparse_genotype_posteriors(const SparseGenotypeSetVector& genotype_sets,
+                                         const std::size_t num_genotypes)
 {
-    assert(!genotype_posteriors.empty());
-    std::vector<double> result(genotype_posteriors.front().size());
-    for (const auto& sample_posteriors : genotype_posteriors) {
-        std::transform(std::cbegin(result), std::cend(result), std::cbegin(sample_posteriors), std::begin(result),
-                       [] (const auto curr, const auto p) { return curr + p; });
+    std::vector<double> result(num_genotypes, 0.0);
+    for (const auto& set : genotype_sets) {
+        for (std::size_t i {0}; i < set.genotype_indices.size(); ++i) {
+            result[set.genotype_indices[i]] += set.posteriors[i];
+        }
     }
     return result;
 }
 
 double update_haplotype_frequencies(const std::vector<Haplotype>& haplotypes,
                                     HardyWeinbergModel& hw_model,
-                                    const GenotypeMarginalPosteriorMatrix& genotype_posteriors,
+                                    const std::vector<double>& collaped_posteriors,
                                     const InverseGenotypeTable& genotypes_containing_haplotypes,
                                     const double frequency_update_norm)
 {
-    const auto collaped_posteriors = collapse_genotype_posteriors(genotype_posteriors);
     double max_frequency_change {0};
     auto& current_haplotype_frequencies = hw_model.frequencies();
     for (std::size_t i {0}; i < haplotypes.size(); ++i) {
@@ -256,66 +309,94 @@ double update_haplotype_frequencies(const std::vector<Haplotype>& haplotypes,
     return max_frequency_change;
 }
 
-double do_em_iteration(GenotypeMarginalPosteriorMatrix& genotype_posteriors,
+double do_em_iteration(SparseGenotypeSetVector& genotype_sets,
                        HardyWeinbergModel& hw_model,
                        GenotypeLogMarginalVector& genotype_log_marginals,
-                       const ModelConstants& constants)
+                       const ModelConstants& constants,
+                       const double min_genotype_posterior)
 {
+    const auto collaped_posteriors = collapse_sparse_genotype_posteriors(genotype_sets, constants.genotypes.size());
     const auto max_change = update_haplotype_frequencies(constants.haplotypes,
                                                          hw_model,
-                                                         genotype_posteriors,
+                                                         collaped_posteriors,
                                                          constants.genotypes_containing_haplotypes,
                                                          constants.frequency_update_norm);
-    update_genotype_log_marginals(genotype_log_marginals, hw_model);
-    update_genotype_posteriors(genotype_posteriors, genotype_log_marginals, constants.genotype_log_likilhoods);
+    const auto active_genotypes = flag_active_genotypes(genotype_sets, constants.genotypes.size());
+    update_genotype_log_marginals(genotype_log_marginals, hw_model, active_genotypes);
+    update_sparse_genotype_posteriors(genotype_sets, genotype_log_marginals, constants.genotype_log_likilhoods);
+    prune_sparse_genotype_sets(genotype_sets, min_genotype_posterior);
     return max_change;
 }
 
-void run_em(GenotypeMarginalPosteriorMatrix& genotype_posteriors,
+void run_em(SparseGenotypeSetVector& genotype_sets,
             HardyWeinbergModel& hw_model,
             GenotypeLogMarginalVector& genotype_log_marginals,
             const ModelConstants& constants, const EMOptions options,
+            const double min_genotype_posterior,
             boost::optional<logging::TraceLogger> trace_log = boost::none)
 {
     for (unsigned n {1}; n <= options.max_iterations; ++n) {
-        const auto max_change = do_em_iteration(genotype_posteriors, hw_model, genotype_log_marginals,constants);
+        const auto max_change = do_em_iteration(genotype_sets, hw_model, genotype_log_marginals,
+                                                constants, min_genotype_posterior);
         if (max_change <= options.epsilon) break;
     }
 }
 
+auto expand_sparse_genotype_posteriors(const SparseGenotypeSetVector& genotype_sets,
+                                       const std::size_t num_genotypes)
+{
+    GenotypeMarginalPosteriorMatrix result {};
+    result.reserve(genotype_sets.size());
+    for (const auto& set : genotype_sets) {
+        GenotypeMarginalPosteriorVector posteriors(num_genotypes, 0.0);
+        for (std::size_t i {0}; i < set.genotype_indices.size(); ++i) {
+            posteriors[set.genotype_indices[i]] = set.posteriors[i];
+        }
+        result.push_back(std::move(posteriors));
+    }
+    return result;
+}
+
+auto compute_approx_genotype_marginal_posteriors(const ModelConstants& constants,
+                                                 const EMOptions options,
+                                                 const double min_genotype_posterior)
+{
+    auto hw_model = make_hardy_weinberg_model(constants);
+    auto genotype_log_marginals = init_genotype_log_marginals(constants.genotypes, hw_model);
+    auto genotype_sets = init_sparse_genotype_sets(genotype_log_marginals, constants.genotype_log_likilhoods);
+    run_em(genotype_sets, hw_model, genotype_log_marginals, constants, options, min_genotype_posterior);
+    return expand_sparse_genotype_posteriors(genotype_sets, constants.genotypes.size());
+}
+
 auto compute_approx_genotype_marginal_posteriors(const std::vector<Haplotype>& haplotypes,
                                                  const std::vector<Genotype<Haplotype>>& genotypes,
                                                  const GenotypeLogLikelihoodMatrix& genotype_likelihoods,
-                                                 const EMOptions options)
+                                                 const EMOptions options,
+                                                 const double min_genotype_posterior)
 {
     const ModelConstants constants {haplotypes, genotypes, genotype_likelihoods};
-    auto hw_model = make_hardy_weinberg_model(constants);
-    auto genotype_log_marginals = init_genotype_log_marginals(genotypes, hw_model);
-    auto result = init_genotype_posteriors(genotype_log_marginals, genotype_likelihoods);
-    run_em(result, hw_model, genotype_log_marginals, constants, options);
-    return result;
+    return compute_approx_genotype_marginal_posteriors(constants, options, min_genotype_posterior);
 }
 
 auto compute_approx_genotype_marginal_posteriors(const std::vector<Haplotype>& haplotypes,
                                                  const std::vector<Genotype<Haplotype>>& genotypes,
                                                  const std::vector<GenotypeIndex>& genotype_indices,
                                                  const GenotypeLogLikelihoodMatrix& genotype_likelihoods,
-                                                 const EMOptions options)
+                                                 const EMOptions options,
+                                                 const double min_genotype_posterior)
 {
     const ModelConstants constants {haplotypes, genotypes, genotype_indices, genotype_likelihoods};
-    auto hw_model = make_hardy_weinberg_model(constants);
-    auto genotype_log_marginals = init_genotype_log_marginals(genotypes, hw_model);
-    auto result = init_genotype_posteriors(genotype_log_marginals, genotype_likelihoods);
-    run_em(result, hw_model, genotype_log_marginals, constants, options);
-    return result;
+    return compute_approx_genotype_marginal_posteriors(constants, options, min_genotype_posterior);
 }
 
 auto compute_approx_genotype_marginal_posteriors(const std::vector<Genotype<Haplotype>>& genotypes,
                                                  const GenotypeLogLikelihoodMatrix& genotype_likelihoods,
-                                                 const EMOptions options)
+                                                 const EMOptions options,
+                                                 const double min_genotype_posterior)
 {
     const auto haplotypes = extract_unique_elements(genotypes);
-    return compute_approx_genotype_marginal_posteriors(haplotypes, genotypes, genotype_likelihoods, options);
+    return compute_approx_genotype_marginal_posteriors(haplotypes, genotypes, genotype_likelihoods,
+                                                       options, min_genotype_posterior);
 }
 
 using GenotypeCombinationVector = std::vector<std::size_t>;
@@ -426,9 +507,166 @@ select_top_k_genotypes(const std::vector<Genotype<Haplotype>>& genotypes,
     }
 }
 
-auto propose_joint_genotypes(const std::vector<Genotype<Haplotype>>& genotypes,
+boost::optional<std::size_t> find_sample_idx(const SampleName& sample, const PopulationModel::SampleVector& samples)
+{
+    const auto itr = std::find(std::cbegin(samples), std::cend(samples), sample);
+    if (itr != std::cend(samples)) {
+        return static_cast<std::size_t>(std::distance(std::cbegin(samples), itr));
+    } else {
+        return boost::none;
+    }
+}
+
+struct ParentIndicesPair
+{
+    boost::optional<std::size_t> maternal, paternal;
+};
+
+auto find_parent_indices(const SampleName& sample, const PopulationModel::SampleVector& samples,
+                         const Pedigree& pedigree)
+{
+    ParentIndicesPair result {};
+    const auto mother = pedigree.mother_of(sample);
+    if (mother) result.maternal = find_sample_idx(*mother, samples);
+    const auto father = pedigree.father_of(sample);
+    if (father) result.paternal = find_sample_idx(*father, samples);
+    return result;
+}
+
+bool has_trio_factor(const PopulationModel::SampleVector& samples, const Pedigree& pedigree)
+{
+    return std::any_of(std::cbegin(samples), std::cend(samples),
+                       [&] (const auto& sample) {
+                           const auto parents = find_parent_indices(sample, samples, pedigree);
+                           return parents.maternal && parents.paternal;
+                       });
+}
+
+bool can_use_pedigree_factorisation(const PopulationModel::SampleVector& samples, const Pedigree& pedigree)
+{
+    if (samples.size() < 3) return false;
+    const auto is_member = [&] (const auto& sample) { return pedigree.is_member(sample); };
+    return std::all_of(std::cbegin(samples), std::cend(samples), is_member)
+           && has_trio_factor(samples, pedigree);
+}
+
+// Topological order over the pedigree restricted to the calling samples, so each
+// sample is visited after any parents it couples to
+auto pedigree_evaluation_order(const PopulationModel::SampleVector& samples, const Pedigree& pedigree)
+{
+    std::vector<std::size_t> result {};
+    result.reserve(samples.size());
+    std::vector<bool> ordered(samples.size(), false);
+    while (result.size() < samples.size()) {
+        for (std::size_t s {0}; s < samples.size(); ++s) {
+            if (!ordered[s]) {
+                const auto parents = find_parent_indices(samples[s], samples, pedigree);
+                if ((!parents.maternal || ordered[*parents.maternal])
+                    && (!parents.paternal || ordered[*parents.paternal])) {
+                    result.push_back(s);
+                    ordered[s] = true;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+bool is_mendelian_consistent(const Genotype<Haplotype>& child,
+                             const Genotype<Haplotype>& mother,
+                             const Genotype<Haplotype>& father)
+{
+    if (child.ploidy() != 2) return true;
+    return (mother.contains(child[0]) && father.contains(child[1]))
+           || (mother.contains(child[1]) && father.contains(child[0]));
+}
+
+auto select_top_genotypes_per_sample(const GenotypeMarginalPosteriorMatrix& em_genotype_marginals,
+                                     const std::size_t k)
+{
+    std::vector<std::vector<std::pair<double, unsigned>>> result {};
+    result.reserve(em_genotype_marginals.size());
+    for (const auto& marginals : em_genotype_marginals) {
+        auto indexed = zip_index(marginals);
+        if (indexed.size() > k) {
+            std::partial_sort(std::begin(indexed), std::next(std::begin(indexed), k), std::end(indexed),
+                              std::greater<> {});
+            indexed.resize(k);
+        } else {
+            std::sort(std::begin(indexed), std::end(indexed), std::greater<> {});
+        }
+        result.push_back(std::move(indexed));
+    }
+    return result;
+}
+
+// Proposes joint genotype combinations by sweeping the samples in pedigree order
+// with a beam of partial combinations, extending each by the strongest per-sample
+// marginals and scoring parent-offspring triples with a trio-sized Mendelian
+// factor. Only factors of the tree that is actually being extended are evaluated,
+// so the sweep stays linear in the number of samples rather than exponential
+auto propose_pedigree_joint_genotypes(const PopulationModel::SampleVector& samples,
+                                      const std::vector<Genotype<Haplotype>>& genotypes,
+                                      const GenotypeMarginalPosteriorMatrix& em_genotype_marginals,
+                                      const Pedigree& pedigree,
+                                      const std::size_t max_joint_genotypes)
+{
+    constexpr std::size_t maxGenotypesPerSample {50};
+    // Inconsistent assignments are kept in the running - de novo mutations do
+    // happen - but only when no Mendelian explanation scores comparably
+    constexpr double denovoLogPenalty {-20.0};
+    const auto order = pedigree_evaluation_order(samples, pedigree);
+    const auto sample_genotype_candidates = select_top_genotypes_per_sample(em_genotype_marginals, maxGenotypesPerSample);
+    using ScoredCombination = std::pair<GenotypeCombinationVector, double>;
+    std::vector<ScoredCombination> beam {{GenotypeCombinationVector(samples.size()), 0.0}};
+    std::vector<ScoredCombination> expanded_beam {};
+    for (const auto sample_idx : order) {
+        const auto& candidates = sample_genotype_candidates[sample_idx];
+        const auto parents = find_parent_indices(samples[sample_idx], samples, pedigree);
+        const bool has_both_parents {parents.maternal && parents.paternal};
+        expanded_beam.clear();
+        expanded_beam.reserve(beam.size() * candidates.size());
+        for (const auto& partial : beam) {
+            for (const auto& candidate : candidates) {
+                auto score = partial.second + std::log(candidate.first);
+                if (has_both_parents
+                    && !is_mendelian_consistent(genotypes[candidate.second],
+                                                genotypes[partial.first[*parents.maternal]],
+                                                genotypes[partial.first[*parents.paternal]])) {
+                    score += denovoLogPenalty;
+                }
+                expanded_beam.emplace_back(partial.first, score);
+                expanded_beam.back().first[sample_idx] = candidate.second;
+            }
+        }
+        if (expanded_beam.size() > max_joint_genotypes) {
+            std::nth_element(std::begin(expanded_beam), std::next(std::begin(expanded_beam), max_joint_genotypes),
+                             std::end(expanded_beam),
+                             [] (const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+            expanded_beam.resize(max_joint_genotypes);
+        }
+        std::swap(beam, expanded_beam);
+    }
+    GenotypeCombinationMatrix result {};
+    result.reserve(beam.size());
+    for (auto& combination : beam) {
+        result.push_back(std::move(combination.first));
+    }
+    const auto hom_ref_idx = find_hom_ref_idx(genotypes);
+    if (hom_ref_idx) {
+        std::vector<std::size_t> ref_indices(samples.size(), *hom_ref_idx);
+        if (std::find(std::cbegin(result), std::cend(result), ref_indices) == std::cend(result)) {
+            result.back() = std::move(ref_indices);
+        }
+    }
+    return result;
+}
+
+auto propose_joint_genotypes(const PopulationModel::SampleVector& samples,
+                             const std::vector<Genotype<Haplotype>>& genotypes,
                              const GenotypeMarginalPosteriorMatrix& em_genotype_marginals,
-                             const std::size_t max_joint_genotypes)
+                             const std::size_t max_joint_genotypes,
+                             const boost::optional<Pedigree>& pedigree)
 {
     const auto num_samples = em_genotype_marginals.size();
     assert(max_joint_genotypes >= num_samples * genotypes.size());
@@ -436,6 +674,10 @@ auto propose_joint_genotypes(const std::vector<Genotype<Haplotype>>& genotypes,
     if (num_joint_genotypes <= max_joint_genotypes) {
         return generate_all_genotype_combinations(genotypes.size(), num_samples);
     }
+    if (pedigree && can_use_pedigree_factorisation(samples, *pedigree)) {
+        return propose_pedigree_joint_genotypes(samples, genotypes, em_genotype_marginals,
+                                                *pedigree, max_joint_genotypes);
+    }
     auto result = select_top_k_tuples(em_genotype_marginals, max_joint_genotypes);
     const auto top_k_genotype_indices = select_top_k_genotypes(genotypes, em_genotype_marginals, num_samples / 2);
     for (const auto genotype_idx : top_k_genotype_indices) {
@@ -566,8 +808,10 @@ PopulationModel::evaluate(const SampleVector& samples, const GenotypeVector& gen
         calculate_posterior_marginals(genotypes, joint_genotypes, genotype_log_likelihoods, prior_model_, result);
     } else {
         const EMOptions em_options {options_.max_em_iterations, options_.em_epsilon};
-        const auto em_genotype_marginals = compute_approx_genotype_marginal_posteriors(genotypes, genotype_log_likelihoods, em_options);
-        const auto joint_genotypes = propose_joint_genotypes(genotypes, em_genotype_marginals, options_.max_joint_genotypes);
+        const auto em_genotype_marginals = compute_approx_genotype_marginal_posteriors(genotypes, genotype_log_likelihoods, em_options,
+                                                                                       options_.em_genotype_pruning_threshold);
+        const auto joint_genotypes = propose_joint_genotypes(samples, genotypes, em_genotype_marginals,
+                                                             options_.max_joint_genotypes, options_.pedigree);
         calculate_posterior_marginals(genotypes, joint_genotypes, genotype_log_likelihoods, prior_model_, result);
     }
     return result;
@@ -590,8 +834,10 @@ PopulationModel::evaluate(const SampleVector& samples,
     } else {
         const EMOptions em_options {options_.max_em_iterations, options_.em_epsilon};
         const auto em_genotype_marginals = compute_approx_genotype_marginal_posteriors(haplotypes, genotypes, genotype_indices,
-                                                                                       genotype_log_likelihoods, em_options);
-        const auto joint_genotypes = propose_joint_genotypes(genotypes, em_genotype_marginals, options_.max_joint_genotypes);
+                                                                                       genotype_log_likelihoods, em_options,
+                                                                                       options_.em_genotype_pruning_threshold);
+        const auto joint_genotypes = propose_joint_genotypes(samples, genotypes, em_genotype_marginals,
+                                                             options_.max_joint_genotypes, options_.pedigree);
         calculate_posterior_marginals(genotype_indices, joint_genotypes, genotype_log_likelihoods, prior_model_, result);
     }
     return result;
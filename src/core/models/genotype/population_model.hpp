@@ -10,6 +10,7 @@
 #include <boost/optional.hpp>
 
 #include "config/common.hpp"
+#include "basics/pedigree.hpp"
 #include "core/types/haplotype.hpp"
 #include "core/types/genotype.hpp"
 #include "population_prior_model.hpp"
@@ -27,6 +28,15 @@ public:
         std::size_t max_joint_genotypes = 1'000'000;
         unsigned max_em_iterations = 100;
         double em_epsilon = 0.001;
+        // Genotypes whose per-sample posterior mass falls below this threshold are
+        // pruned from that sample's active set after each EM iteration, so later
+        // iterations only sweep the genotypes still in play
+        double em_genotype_pruning_threshold = 1e-10;
+        // If given, and the samples form at least one parent-offspring factor, joint
+        // genotype combinations are proposed by passing messages along the pedigree
+        // with trio-sized Mendelian factors, rather than by ranking products of
+        // independent sample marginals
+        boost::optional<Pedigree> pedigree = boost::none;
     };
     struct Latents
     {
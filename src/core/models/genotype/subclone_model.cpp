@@ -33,15 +33,28 @@ const SubcloneModel::Priors& SubcloneModel::priors() const noexcept
     return priors_;
 }
 
+void SubcloneModel::prime_mixture_weights(Latents::GenotypeMixturesDirichletAlphaMap weights)
+{
+    primed_mixture_weights_ = std::move(weights);
+}
+
+void SubcloneModel::clear_primed_mixture_weights() noexcept
+{
+    primed_mixture_weights_ = boost::none;
+}
+
 namespace {
 
+using InitialMixtures = boost::optional<SubcloneModel::Latents::GenotypeMixturesDirichletAlphaMap>;
+
 template <std::size_t K>
 SubcloneModel::InferredLatents
 run_variational_bayes(const std::vector<SampleName>& samples,
                       const std::vector<Genotype<Haplotype>>& genotypes,
                       const SubcloneModel::Priors& priors,
                       const HaplotypeLikelihoodCache& haplotype_log_likelihoods,
-                      const VariationalBayesParameters& params);
+                      const VariationalBayesParameters& params,
+                      const InitialMixtures& initial_mixtures);
 
 template <std::size_t K>
 SubcloneModel::InferredLatents
@@ -50,7 +63,8 @@ run_variational_bayes(const std::vector<SampleName>& samples,
                       const std::vector<GenotypeIndex>& genotype_indices,
                       const SubcloneModel::Priors& priors,
                       const HaplotypeLikelihoodCache& haplotype_log_likelihoods,
-                      const VariationalBayesParameters& params);
+                      const VariationalBayesParameters& params,
+                      const InitialMixtures& initial_mixtures);
 
 } // namespace
 
@@ -64,11 +78,11 @@ SubcloneModel::evaluate(const std::vector<Genotype<Haplotype>>& genotypes,
     const VariationalBayesParameters vb_params {parameters_.epsilon, parameters_.max_iterations};
     switch (ploidy) {
         case 1: return run_variational_bayes<1>(samples_, genotypes, priors_,
-                                                haplotype_likelihoods, vb_params);
+                                                haplotype_likelihoods, vb_params, primed_mixture_weights_);
         case 2: return run_variational_bayes<2>(samples_, genotypes, priors_,
-                                                haplotype_likelihoods, vb_params);
+                                                haplotype_likelihoods, vb_params, primed_mixture_weights_);
         default: return run_variational_bayes<3>(samples_, genotypes, priors_,
-                                                 haplotype_likelihoods, vb_params);
+                                                 haplotype_likelihoods, vb_params, primed_mixture_weights_);
     }
 }
 
@@ -83,11 +97,11 @@ SubcloneModel::evaluate(const std::vector<Genotype<Haplotype>>& genotypes,
     const VariationalBayesParameters vb_params {parameters_.epsilon, parameters_.max_iterations};
     switch (ploidy) {
         case 1: return run_variational_bayes<1>(samples_, genotypes, genotype_indices,  priors_,
-                                                haplotype_likelihoods, vb_params);
+                                                haplotype_likelihoods, vb_params, primed_mixture_weights_);
         case 2: return run_variational_bayes<2>(samples_, genotypes, genotype_indices, priors_,
-                                                haplotype_likelihoods, vb_params);
+                                                haplotype_likelihoods, vb_params, primed_mixture_weights_);
         default: return run_variational_bayes<3>(samples_, genotypes, genotype_indices, priors_,
-                                                 haplotype_likelihoods, vb_params);
+                                                 haplotype_likelihoods, vb_params, primed_mixture_weights_);
     }
 }
 
@@ -223,6 +237,23 @@ auto generate_seeds(const std::vector<SampleName>& samples,
     return result;
 }
 
+// The primed mixture weights can only seed iteration if they match the
+// mixture dimensions being optimised; anything else (e.g. a posterior from a
+// fit with different clonality) is silently ignored
+template <std::size_t K>
+boost::optional<VBAlphaVector<K>>
+flatten_initial_mixtures(const InitialMixtures& initial_mixtures, const std::vector<SampleName>& samples)
+{
+    if (!initial_mixtures) return boost::none;
+    const auto is_valid = std::all_of(std::cbegin(samples), std::cend(samples),
+                                      [&] (const auto& sample) {
+                                          const auto itr = initial_mixtures->find(sample);
+                                          return itr != std::cend(*initial_mixtures) && itr->second.size() == K;
+                                      });
+    if (!is_valid) return boost::none;
+    return flatten<K>(*initial_mixtures, samples);
+}
+
 template <std::size_t K>
 SubcloneModel::InferredLatents
 run_variational_bayes(const std::vector<SampleName>& samples,
@@ -231,11 +262,13 @@ run_variational_bayes(const std::vector<SampleName>& samples,
                       const std::vector<double>& genotype_log_priors,
                       const HaplotypeLikelihoodCache& haplotype_log_likelihoods,
                       const VariationalBayesParameters& params,
-                      std::vector<std::vector<double>>&& seeds)
+                      std::vector<std::vector<double>>&& seeds,
+                      const InitialMixtures& initial_mixtures)
 {
     const auto vb_prior_alphas = flatten<K>(prior_alphas, samples);
     const auto log_likelihoods = flatten<K>(genotypes, samples, haplotype_log_likelihoods);
-    auto p = run_variational_bayes(vb_prior_alphas, genotype_log_priors, log_likelihoods, params, std::move(seeds));
+    auto p = run_variational_bayes(vb_prior_alphas, genotype_log_priors, log_likelihoods, params, std::move(seeds),
+                                   flatten_initial_mixtures<K>(initial_mixtures, samples));
     return expand(samples, std::move(p.first), p.second);
 }
 
@@ -247,12 +280,13 @@ run_variational_bayes(const std::vector<SampleName>& samples,
                       const std::vector<Genotype<Haplotype>>& genotypes,
                       const SubcloneModel::Priors& priors,
                       const HaplotypeLikelihoodCache& haplotype_log_likelihoods,
-                      const VariationalBayesParameters& params)
+                      const VariationalBayesParameters& params,
+                      const InitialMixtures& initial_mixtures)
 {
     const auto genotype_log_priors = calculate_log_priors(genotypes, priors.genotype_prior_model);
     auto seeds = generate_seeds(samples, genotypes, genotype_log_priors, priors, haplotype_log_likelihoods);
     return run_variational_bayes<K>(samples, genotypes, priors.alphas, genotype_log_priors,
-                                    haplotype_log_likelihoods, params, std::move(seeds));
+                                    haplotype_log_likelihoods, params, std::move(seeds), initial_mixtures);
 }
 
 template <std::size_t K>
@@ -262,12 +296,13 @@ run_variational_bayes(const std::vector<SampleName>& samples,
                       const std::vector<GenotypeIndex>& genotype_indices,
                       const SubcloneModel::Priors& priors,
                       const HaplotypeLikelihoodCache& haplotype_log_likelihoods,
-                      const VariationalBayesParameters& params)
+                      const VariationalBayesParameters& params,
+                      const InitialMixtures& initial_mixtures)
 {
     const auto genotype_log_priors = calculate_log_priors(genotype_indices, priors.genotype_prior_model);
     auto seeds = generate_seeds(samples, genotypes, genotype_log_priors, priors, haplotype_log_likelihoods, genotype_indices);
     return run_variational_bayes<K>(samples, genotypes, priors.alphas, genotype_log_priors,
-                                    haplotype_log_likelihoods, params, std::move(seeds));
+                                    haplotype_log_likelihoods, params, std::move(seeds), initial_mixtures);
 }
 
 } // namespace
@@ -8,6 +8,8 @@
 #include <unordered_map>
 #include <utility>
 
+#include <boost/optional.hpp>
+
 #include "config/common.hpp"
 #include "core/types/haplotype.hpp"
 #include "core/types/genotype.hpp"
@@ -63,7 +65,14 @@ public:
     ~SubcloneModel() = default;
     
     const Priors& priors() const noexcept;
-    
+
+    // Warm-starts the mixture weight optimisation from a previously converged
+    // posterior, e.g. from an adjacent active region that shares clonal
+    // composition. Only where iteration begins changes, not the model; the
+    // hint is ignored for samples with mismatched mixture dimensions.
+    void prime_mixture_weights(Latents::GenotypeMixturesDirichletAlphaMap weights);
+    void clear_primed_mixture_weights() noexcept;
+
     InferredLatents evaluate(const std::vector<Genotype<Haplotype>>& genotypes,
                              const HaplotypeLikelihoodCache& haplotype_likelihoods) const;
     
@@ -75,6 +84,7 @@ private:
     std::vector<SampleName> samples_;
     Priors priors_;
     AlgorithmParameters parameters_;
+    boost::optional<Latents::GenotypeMixturesDirichletAlphaMap> primed_mixture_weights_;
 };
     
 } // namespace model
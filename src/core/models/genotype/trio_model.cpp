@@ -6,12 +6,17 @@
 #include <iterator>
 #include <algorithm>
 #include <cmath>
+#include <exception>
+#include <future>
 #include <random>
 #include <utility>
+#include <unordered_map>
 #include <cassert>
 #include <string>
 #include <iostream>
 
+#include <boost/functional/hash.hpp>
+
 #include "utils/maths.hpp"
 #include "germline_likelihood_model.hpp"
 
@@ -41,6 +46,16 @@ const PopulationPriorModel& TrioModel::prior_model() const noexcept
     return prior_model_;
 }
 
+void TrioModel::enable_parallel_evaluation(ThreadPool& workers) noexcept
+{
+    workers_ = std::addressof(workers);
+}
+
+void TrioModel::disable_parallel_evaluation() noexcept
+{
+    workers_ = nullptr;
+}
+
 namespace {
 
 template <typename Container>
@@ -129,13 +144,47 @@ bool operator>(const ParentsProbabilityPair& lhs, const ParentsProbabilityPair&
 }
 
 auto compute_likelihoods(const std::vector<Genotype<Haplotype>>& genotypes,
-                         const GermlineLikelihoodModel& model)
-{
+                         const GermlineLikelihoodModel& model,
+                         ThreadPool* workers = nullptr)
+{
+    std::vector<double> likelihoods(genotypes.size());
+    const auto num_workers = workers ? workers->size() : std::size_t {0};
+    if (num_workers > 1 && genotypes.size() > 1) {
+        // The primed likelihood cache is only read during genotype evaluation,
+        // so contiguous chunks of genotypes are sharded across the pool with
+        // each task writing its own slice of the result
+        const auto num_chunks = std::min(num_workers, genotypes.size());
+        std::vector<std::future<void>> chunk_futures {};
+        chunk_futures.reserve(num_chunks);
+        for (std::size_t chunk {0}; chunk < num_chunks; ++chunk) {
+            const auto first = chunk * genotypes.size() / num_chunks;
+            const auto last  = (chunk + 1) * genotypes.size() / num_chunks;
+            chunk_futures.push_back(workers->push([&, first, last] () {
+                for (auto g = first; g < last; ++g) {
+                    likelihoods[g] = model.evaluate(genotypes[g]);
+                }
+            }));
+        }
+        // Every chunk must finish before any exception can propagate as the
+        // tasks reference this frame
+        std::exception_ptr chunk_exception {nullptr};
+        for (auto& chunk_future : chunk_futures) {
+            try {
+                chunk_future.get();
+            } catch (...) {
+                if (!chunk_exception) chunk_exception = std::current_exception();
+            }
+        }
+        if (chunk_exception) std::rethrow_exception(chunk_exception);
+    } else {
+        std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(likelihoods),
+                       [&model] (const auto& genotype) { return model.evaluate(genotype); });
+    }
     std::vector<GenotypeRefProbabilityPair> result {};
     result.reserve(genotypes.size());
-    std::transform(std::cbegin(genotypes), std::cend(genotypes), std::back_inserter(result),
-                   [&model] (const auto& genotype) {
-                       return GenotypeRefProbabilityPair {genotype, model.evaluate(genotype)};
+    std::transform(std::cbegin(genotypes), std::cend(genotypes), std::cbegin(likelihoods), std::back_inserter(result),
+                   [] (const auto& genotype, const auto likelihood) {
+                       return GenotypeRefProbabilityPair {genotype, likelihood};
                    });
     return result;
 }
@@ -379,16 +428,6 @@ double joint_probability(const GenotypeIndiceVector& mother, const GenotypeIndic
     return model.evaluate(parental_genotypes);
 }
 
-double joint_probability(const GenotypeRefProbabilityPair& mother, const GenotypeRefProbabilityPair& father,
-                         const PopulationPriorModel& model)
-{
-    if (mother.indices && father.indices) {
-        return mother.probability + father.probability + joint_probability(*mother.indices, *father.indices, model);
-    } else {
-        return mother.probability + father.probability + joint_probability(mother.genotype, father.genotype, model);
-    }
-}
-
 template <typename T1, typename T2>
 auto join_size(const ReducedVectorMap<T1>& first, const ReducedVectorMap<T2>& second) noexcept
 {
@@ -406,21 +445,42 @@ auto join(const ReducedVectorMap<GenotypeRefProbabilityPair>& maternal,
 {
     std::vector<ParentsProbabilityPair> result {};
     result.reserve(join_size(maternal, paternal));
+    // The prior model is exchangeable in the parents, so when both parents draw
+    // on the same genotype pool - always the case when the parental priors are
+    // uninformative - each unordered genotype pair need only be evaluated once,
+    // with the cached value reused for the swapped ordering
+    using GenotypeAddressPair = std::pair<const Genotype<Haplotype>*, const Genotype<Haplotype>*>;
+    std::unordered_map<GenotypeAddressPair, double, boost::hash<GenotypeAddressPair>> prior_cache {};
+    prior_cache.reserve(join_size(maternal, paternal) / 2);
+    const auto cached_prior = [&] (const GenotypeRefProbabilityPair& m, const GenotypeRefProbabilityPair& p) {
+        auto key = std::make_pair(std::addressof(m.genotype.get()), std::addressof(p.genotype.get()));
+        if (key.second < key.first) std::swap(key.first, key.second);
+        const auto itr = prior_cache.find(key);
+        if (itr != std::cend(prior_cache)) return itr->second;
+        double prior;
+        if (m.indices && p.indices) {
+            prior = joint_probability(*m.indices, *p.indices, model);
+        } else {
+            prior = joint_probability(m.genotype, p.genotype, model);
+        }
+        prior_cache.emplace(key, prior);
+        return prior;
+    };
     std::for_each(maternal.first, maternal.last_to_join, [&] (const auto& m) {
         std::for_each(paternal.first, paternal.last_to_join, [&] (const auto& p) {
-            result.push_back({m.genotype, p.genotype, joint_probability(m, p, model),
+            result.push_back({m.genotype, p.genotype, m.probability + p.probability + cached_prior(m, p),
                               m.probability, m.probability, m.indices, p.indices});
         });
     });
     std::for_each(maternal.last_to_join, maternal.last, [&] (const auto& m) {
         std::for_each(paternal.first, paternal.last_to_partially_join, [&] (const auto& p) {
-            result.push_back({m.genotype, p.genotype, joint_probability(m, p, model),
+            result.push_back({m.genotype, p.genotype, m.probability + p.probability + cached_prior(m, p),
                               m.probability, m.probability, m.indices, p.indices});
         });
     });
     std::for_each(paternal.last_to_join, paternal.last, [&] (const auto& p) {
         std::for_each(maternal.first, maternal.last_to_partially_join, [&] (const auto& m) {
-            result.push_back({m.genotype, p.genotype, joint_probability(m, p, model),
+            result.push_back({m.genotype, p.genotype, m.probability + p.probability + cached_prior(m, p),
                               m.probability, m.probability, m.indices, p.indices});
         });
     });
@@ -711,11 +771,11 @@ TrioModel::evaluate(const GenotypeVector& maternal_genotypes,
     assert(!maternal_genotypes.empty() && !paternal_genotypes.empty() && !child_genotypes.empty());
     const GermlineLikelihoodModel likelihood_model {haplotype_likelihoods};
     haplotype_likelihoods.prime(trio_.mother());
-    auto maternal_likelihoods = compute_likelihoods(maternal_genotypes, likelihood_model);
+    auto maternal_likelihoods = compute_likelihoods(maternal_genotypes, likelihood_model, workers_);
     haplotype_likelihoods.prime(trio_.father());
-    auto paternal_likelihoods = compute_likelihoods(paternal_genotypes, likelihood_model);
+    auto paternal_likelihoods = compute_likelihoods(paternal_genotypes, likelihood_model, workers_);
     haplotype_likelihoods.prime(trio_.child());
-    auto child_likelihoods = compute_likelihoods(child_genotypes, likelihood_model);
+    auto child_likelihoods = compute_likelihoods(child_genotypes, likelihood_model, workers_);
     if (debug_log_) {
         debug::print(stream(*debug_log_), "maternal", maternal_likelihoods);
         debug::print(stream(*debug_log_), "paternal", paternal_likelihoods);
@@ -746,11 +806,11 @@ TrioModel::evaluate(const GenotypeVector& genotypes, std::vector<GenotypeIndex>&
     assert(prior_model_.is_primed() && mutation_model_.is_primed());
     const GermlineLikelihoodModel likelihood_model {haplotype_likelihoods};
     haplotype_likelihoods.prime(trio_.mother());
-    auto maternal_likelihoods = compute_likelihoods(genotypes, likelihood_model);
+    auto maternal_likelihoods = compute_likelihoods(genotypes, likelihood_model, workers_);
     haplotype_likelihoods.prime(trio_.father());
-    auto paternal_likelihoods = compute_likelihoods(genotypes, likelihood_model);
+    auto paternal_likelihoods = compute_likelihoods(genotypes, likelihood_model, workers_);
     haplotype_likelihoods.prime(trio_.child());
-    auto child_likelihoods = compute_likelihoods(genotypes, likelihood_model);
+    auto child_likelihoods = compute_likelihoods(genotypes, likelihood_model, workers_);
     for (std::size_t i {0}; i < genotypes.size(); ++i) {
         maternal_likelihoods[i].indices = &genotype_indices[i];
         paternal_likelihoods[i].indices = &genotype_indices[i];
@@ -823,11 +883,11 @@ TrioModel::evaluate_allosome(const GenotypeVector& parent_genotypes,
     assert(!parent_genotypes.empty() && child_genotypes.empty());
     const GermlineLikelihoodModel likelihood_model {haplotype_likelihoods};
     assert(haplotype_likelihoods.is_primed());
-    auto parent_likelihoods = compute_likelihoods(parent_genotypes, likelihood_model);
+    auto parent_likelihoods = compute_likelihoods(parent_genotypes, likelihood_model, workers_);
     if (debug_log_) debug::print(stream(*debug_log_), "parent", parent_likelihoods);
     const auto reduced_parent_likelihoods = reduce(parent_likelihoods, prior_model_, options_);
     haplotype_likelihoods.prime(trio_.child());
-    auto child_likelihoods = compute_likelihoods(child_genotypes, likelihood_model);
+    auto child_likelihoods = compute_likelihoods(child_genotypes, likelihood_model, workers_);
     if (debug_log_) debug::print(stream(*debug_log_), "child", child_likelihoods);
     const auto reduced_child_likelihoods = reduce(child_likelihoods, prior_model_, options_);
     auto joint_likelihoods = join(reduced_parent_likelihoods, reduced_child_likelihoods, mutation_model_);
@@ -17,6 +17,7 @@
 #include "core/models/haplotype_likelihood_cache.hpp"
 #include "core/types/genotype.hpp"
 #include "logging/logging.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace octopus { namespace model {
 
@@ -67,7 +68,13 @@ public:
     static unsigned max_ploidy() noexcept;
     
     const PopulationPriorModel& prior_model() const noexcept;
-    
+
+    // Shards per-sample genotype likelihood evaluation between the pool's
+    // threads. The pool must outlive the model; evaluation stays serial while
+    // the pool has no workers.
+    void enable_parallel_evaluation(ThreadPool& workers) noexcept;
+    void disable_parallel_evaluation() noexcept;
+
     InferredLatents evaluate(const GenotypeVector& maternal_genotypes,
                              const GenotypeVector& paternal_genotypes,
                              const GenotypeVector& child_genotypes,
@@ -87,7 +94,8 @@ private:
     const DeNovoModel& mutation_model_;
     Options options_;
     mutable boost::optional<logging::DebugLogger> debug_log_;
-    
+    ThreadPool* workers_ = nullptr;
+
     InferredLatents evaluate_allosome(const GenotypeVector& parent_genotypes,
                                       const GenotypeVector& child_genotypes,
                                       const HaplotypeLikelihoodCache& haplotype_likelihoods) const;
@@ -34,14 +34,38 @@ const TumourModel::Priors& TumourModel::priors() const noexcept
     return priors_;
 }
 
+void TumourModel::prime_mixture_weights(Latents::GenotypeMixturesDirichletAlphaMap weights)
+{
+    primed_mixture_weights_ = std::move(weights);
+}
+
+void TumourModel::clear_primed_mixture_weights() noexcept
+{
+    primed_mixture_weights_ = boost::none;
+}
+
+void TumourModel::enable_parallel_evaluation(ThreadPool& workers) noexcept
+{
+    workers_ = std::addressof(workers);
+}
+
+void TumourModel::disable_parallel_evaluation() noexcept
+{
+    workers_ = nullptr;
+}
+
 namespace {
 
+using InitialMixtures = boost::optional<TumourModel::Latents::GenotypeMixturesDirichletAlphaMap>;
+
 TumourModel::InferredLatents
 run_variational_bayes(const std::vector<SampleName>& samples,
                       const std::vector<CancerGenotype<Haplotype>>& genotypes,
                       const TumourModel::Priors& priors,
                       const HaplotypeLikelihoodCache& haplotype_log_likelihoods,
-                      const VariationalBayesParameters& params);
+                      const VariationalBayesParameters& params,
+                      const InitialMixtures& initial_mixtures,
+                      ThreadPool* workers);
 
 TumourModel::InferredLatents
 run_variational_bayes(const std::vector<SampleName>& samples,
@@ -49,7 +73,9 @@ run_variational_bayes(const std::vector<SampleName>& samples,
                       const std::vector<CancerGenotypeIndex>& genotype_indices,
                       const TumourModel::Priors& priors,
                       const HaplotypeLikelihoodCache& haplotype_log_likelihoods,
-                      const VariationalBayesParameters& params);
+                      const VariationalBayesParameters& params,
+                      const InitialMixtures& initial_mixtures,
+                      ThreadPool* workers);
 
 } // namespace
 
@@ -59,7 +85,7 @@ TumourModel::evaluate(const std::vector<CancerGenotype<Haplotype>>& genotypes,
 {
     assert(!genotypes.empty());
     const VariationalBayesParameters vb_params {parameters_.epsilon, parameters_.max_iterations};
-    return run_variational_bayes(samples_, genotypes, priors_, haplotype_likelihoods, vb_params);
+    return run_variational_bayes(samples_, genotypes, priors_, haplotype_likelihoods, vb_params, primed_mixture_weights_, workers_);
 }
 
 TumourModel::InferredLatents
@@ -70,7 +96,7 @@ TumourModel::evaluate(const std::vector<CancerGenotype<Haplotype>>& genotypes,
     assert(!genotypes.empty());
     assert(genotypes.size() == genotype_indices.size());
     const VariationalBayesParameters vb_params {parameters_.epsilon, parameters_.max_iterations};
-    return run_variational_bayes(samples_, genotypes, genotype_indices, priors_, haplotype_likelihoods, vb_params);
+    return run_variational_bayes(samples_, genotypes, genotype_indices, priors_, haplotype_likelihoods, vb_params, primed_mixture_weights_, workers_);
 }
 
 namespace {
@@ -336,6 +362,23 @@ auto generate_seeds(const std::vector<SampleName>& samples,
     }
 }
 
+// The primed mixture weights can only seed iteration if they match the
+// mixture dimensions being optimised; anything else (e.g. a posterior from a
+// fit with different somatic ploidy) is silently ignored
+template <std::size_t K>
+boost::optional<VBAlphaVector<K>>
+flatten_initial_mixtures(const InitialMixtures& initial_mixtures, const std::vector<SampleName>& samples)
+{
+    if (!initial_mixtures) return boost::none;
+    const auto is_valid = std::all_of(std::cbegin(samples), std::cend(samples),
+                                      [&] (const auto& sample) {
+                                          const auto itr = initial_mixtures->find(sample);
+                                          return itr != std::cend(*initial_mixtures) && itr->second.size() == K;
+                                      });
+    if (!is_valid) return boost::none;
+    return flatten<K>(*initial_mixtures, samples);
+}
+
 template <std::size_t K>
 TumourModel::InferredLatents
 run_variational_bayes(const std::vector<SampleName>& samples,
@@ -344,11 +387,14 @@ run_variational_bayes(const std::vector<SampleName>& samples,
                       std::vector<double> genotype_log_priors,
                       const HaplotypeLikelihoodCache& haplotype_log_likelihoods,
                       const VariationalBayesParameters& params,
-                      std::vector<std::vector<double>>&& seeds)
+                      std::vector<std::vector<double>>&& seeds,
+                      const InitialMixtures& initial_mixtures,
+                      ThreadPool* workers)
 {
     const auto vb_prior_alphas = flatten<K>(prior_alphas, samples);
     const auto log_likelihoods = flatten<K>(genotypes, samples, haplotype_log_likelihoods);
-    auto p = run_variational_bayes(vb_prior_alphas, genotype_log_priors, log_likelihoods, params, std::move(seeds));
+    auto p = run_variational_bayes(vb_prior_alphas, genotype_log_priors, log_likelihoods, params, std::move(seeds),
+                                   flatten_initial_mixtures<K>(initial_mixtures, samples), workers);
     return expand(samples, std::move(p.first), std::move(genotype_log_priors), p.second);
 }
 
@@ -359,24 +405,26 @@ run_variational_bayes_helper(const std::vector<SampleName>& samples,
                              std::vector<double> genotype_log_priors,
                              const HaplotypeLikelihoodCache& haplotype_log_likelihoods,
                              const VariationalBayesParameters& params,
-                             std::vector<std::vector<double>>&& seeds)
+                             std::vector<std::vector<double>>&& seeds,
+                             const InitialMixtures& initial_mixtures,
+                             ThreadPool* workers)
 {
     using std::move;
     switch (genotypes.front().ploidy()) {
         case 2: return run_variational_bayes<2>(samples, genotypes, prior_alphas, move(genotype_log_priors),
-                                                haplotype_log_likelihoods, params, move(seeds));
+                                                haplotype_log_likelihoods, params, move(seeds), initial_mixtures, workers);
         case 3: return run_variational_bayes<3>(samples, genotypes, prior_alphas, move(genotype_log_priors),
-                                                haplotype_log_likelihoods, params, move(seeds));
+                                                haplotype_log_likelihoods, params, move(seeds), initial_mixtures, workers);
         case 4: return run_variational_bayes<4>(samples, genotypes, prior_alphas, move(genotype_log_priors),
-                                                haplotype_log_likelihoods, params, move(seeds));
+                                                haplotype_log_likelihoods, params, move(seeds), initial_mixtures, workers);
         case 5: return run_variational_bayes<5>(samples, genotypes, prior_alphas, move(genotype_log_priors),
-                                                haplotype_log_likelihoods, params, move(seeds));
+                                                haplotype_log_likelihoods, params, move(seeds), initial_mixtures, workers);
         case 6: return run_variational_bayes<6>(samples, genotypes, prior_alphas, move(genotype_log_priors),
-                                                haplotype_log_likelihoods, params, move(seeds));
+                                                haplotype_log_likelihoods, params, move(seeds), initial_mixtures, workers);
         case 7: return run_variational_bayes<7>(samples, genotypes, prior_alphas, move(genotype_log_priors),
-                                                haplotype_log_likelihoods, params, move(seeds));
+                                                haplotype_log_likelihoods, params, move(seeds), initial_mixtures, workers);
         case 8: return run_variational_bayes<8>(samples, genotypes, prior_alphas, move(genotype_log_priors),
-                                                haplotype_log_likelihoods, params, move(seeds));
+                                                haplotype_log_likelihoods, params, move(seeds), initial_mixtures, workers);
         default: throw UnimplementedFeatureError {"tumour model ploidies above 8", "TumourModel"};
     }
 }
@@ -388,12 +436,14 @@ run_variational_bayes(const std::vector<SampleName>& samples,
                       const std::vector<CancerGenotype<Haplotype>>& genotypes,
                       const TumourModel::Priors& priors,
                       const HaplotypeLikelihoodCache& haplotype_log_likelihoods,
-                      const VariationalBayesParameters& params)
+                      const VariationalBayesParameters& params,
+                      const InitialMixtures& initial_mixtures,
+                      ThreadPool* workers)
 {
     auto genotype_log_priors = calculate_log_priors(genotypes, priors.genotype_prior_model);
     auto seeds = generate_seeds(samples, genotypes, genotype_log_priors, haplotype_log_likelihoods, priors);
     return run_variational_bayes_helper(samples, genotypes, priors.alphas, std::move(genotype_log_priors),
-                                        haplotype_log_likelihoods, params, std::move(seeds));
+                                        haplotype_log_likelihoods, params, std::move(seeds), initial_mixtures, workers);
 }
 
 TumourModel::InferredLatents
@@ -402,12 +452,14 @@ run_variational_bayes(const std::vector<SampleName>& samples,
                       const std::vector<CancerGenotypeIndex>& genotype_indices,
                       const TumourModel::Priors& priors,
                       const HaplotypeLikelihoodCache& haplotype_log_likelihoods,
-                      const VariationalBayesParameters& params)
+                      const VariationalBayesParameters& params,
+                      const InitialMixtures& initial_mixtures,
+                      ThreadPool* workers)
 {
     auto genotype_log_priors = calculate_log_priors(genotype_indices, priors.genotype_prior_model);
     auto seeds = generate_seeds(samples, genotypes, genotype_log_priors, haplotype_log_likelihoods, priors);
     return run_variational_bayes_helper(samples, genotypes, priors.alphas, std::move(genotype_log_priors),
-                                        haplotype_log_likelihoods, params, std::move(seeds));
+                                        haplotype_log_likelihoods, params, std::move(seeds), initial_mixtures, workers);
 }
 
 } // namespace
@@ -8,8 +8,11 @@
 #include <unordered_map>
 #include <utility>
 
+#include <boost/optional.hpp>
+
 #include "cancer_genotype_prior_model.hpp"
 #include "config/common.hpp"
+#include "utils/thread_pool.hpp"
 #include "core/types/haplotype.hpp"
 #include "core/models/haplotype_likelihood_cache.hpp"
 #include "core/types/cancer_genotype.hpp"
@@ -63,7 +66,19 @@ public:
     TumourModel& operator=(TumourModel&&)      = default;
     
     const Priors& priors() const noexcept;
-    
+
+    // Warm-starts the mixture weight optimisation from a previously converged
+    // posterior, e.g. from an adjacent active region that shares clonal
+    // composition. Only where iteration begins changes, not the model; the
+    // hint is ignored for samples with mismatched mixture dimensions.
+    void prime_mixture_weights(Latents::GenotypeMixturesDirichletAlphaMap weights);
+    void clear_primed_mixture_weights() noexcept;
+
+    // Shards the independent VB seed restarts between the pool's threads. The
+    // pool must outlive the model; evaluation stays serial while unset.
+    void enable_parallel_evaluation(ThreadPool& workers) noexcept;
+    void disable_parallel_evaluation() noexcept;
+
     InferredLatents evaluate(const std::vector<CancerGenotype<Haplotype>>& genotypes,
                              const HaplotypeLikelihoodCache& haplotype_likelihoods) const;
     
@@ -75,6 +90,8 @@ private:
     std::vector<SampleName> samples_;
     Priors priors_;
     AlgorithmParameters parameters_;
+    boost::optional<Latents::GenotypeMixturesDirichletAlphaMap> primed_mixture_weights_;
+    ThreadPool* workers_ = nullptr;
 };
 
 } // namespace model
@@ -13,11 +13,14 @@
 #include <utility>
 #include <cassert>
 #include <limits>
+#include <future>
+#include <exception>
 
 #include <boost/optional.hpp>
 #include <boost/math/special_functions/digamma.hpp>
 
 #include "utils/maths.hpp"
+#include "utils/thread_pool.hpp"
 #include "core/models/haplotype_likelihood_cache.hpp"
 
 /**
@@ -96,20 +99,48 @@ struct VBLatents
 
 // Main VB method
 
+// The optional initial alphas warm-start the mixture weight optimisation,
+// e.g. from a previously converged posterior; they do not change the model,
+// only where iteration begins. When unset iteration starts from the priors.
+// Seed restarts are independent and are sharded between the given pool's
+// threads when one is provided.
 template <std::size_t K>
 std::pair<VBLatents<K>, double>
 run_variational_bayes(const VBAlphaVector<K>& prior_alphas,
                       const LogProbabilityVector& genotype_log_priors,
                       const VBReadLikelihoodMatrix<K>& log_likelihoods,
                       const VariationalBayesParameters& params,
-                      std::vector<LogProbabilityVector> seeds);
+                      std::vector<LogProbabilityVector> seeds,
+                      boost::optional<VBAlphaVector<K>> initial_alphas = boost::none,
+                      ThreadPool* workers = nullptr);
 
 namespace detail {
 
-using VBInverseLikelihood = std::vector<double>; // One element per genotype
-using VBInverseGenotype = std::vector<VBInverseLikelihood>; // One element per read
+// The inverse likelihoods are an iteration-only copy streamed over once per
+// read per VB update, so they are stored single precision to halve their
+// footprint; all accumulations over them, and the posteriors, remain double.
+// Each matrix is one contiguous allocation with the genotypes of a read
+// adjacent, so the responsability updates reduce to dense matrix-vector
+// products over sequential memory.
+class VBInverseGenotypeMatrix // [read][genotype], row-major
+{
+public:
+    VBInverseGenotypeMatrix() = default;
+    VBInverseGenotypeMatrix(const std::size_t num_reads, const std::size_t num_genotypes)
+    : data_(num_reads * num_genotypes), num_genotypes_ {num_genotypes} {}
+
+    std::size_t num_reads() const noexcept { return num_genotypes_ > 0 ? data_.size() / num_genotypes_ : 0; }
+    std::size_t num_genotypes() const noexcept { return num_genotypes_; }
+    float* row(const std::size_t n) noexcept { return data_.data() + n * num_genotypes_; }
+    const float* row(const std::size_t n) const noexcept { return data_.data() + n * num_genotypes_; }
+
+private:
+    std::vector<float> data_;
+    std::size_t num_genotypes_ = 0;
+};
+
 template <std::size_t K>
-using VBInverseGenotypeVector = std::array<VBInverseGenotype, K>; // One element per haplotype in genotype
+using VBInverseGenotypeVector = std::array<VBInverseGenotypeMatrix, K>; // One element per haplotype in genotype
 template <std::size_t K>
 using VBInverseReadLikelihoodMatrix = std::vector<VBInverseGenotypeVector<K>>; // One element per sample
 
@@ -122,10 +153,11 @@ auto invert(const VBGenotypeVector<K>& likelihoods)
     const auto num_reads = likelihoods.front().front().size();
     VBInverseGenotypeVector<K> result {};
     for (std::size_t k {0}; k < K; ++k) {
-        result[k] = VBInverseGenotype(num_reads, VBInverseLikelihood(num_genotypes));
+        result[k] = VBInverseGenotypeMatrix {num_reads, num_genotypes};
         for (std::size_t n {0}; n < num_reads; ++n) {
+            const auto row = result[k].row(n);
             for (std::size_t g {0}; g < num_genotypes; ++g) {
-                result[k][n][g] = likelihoods[g][k][n];
+                row[g] = likelihoods[g][k][n];
             }
         }
     }
@@ -211,7 +243,20 @@ auto count_reads(const VBGenotypeVector<K>& likelihoods) noexcept
 template <std::size_t K>
 auto count_reads(const VBInverseGenotypeVector<K>& likelihoods) noexcept
 {
-    return likelihoods[0].size();
+    return likelihoods[0].num_reads();
+}
+
+// A plain indexed reduction over contiguous rows that the compiler can
+// unroll and vectorise; the iterator-pair std::inner_product form is not
+// reliably turned into packed multiply-adds
+template <typename T>
+auto dot(const double* lhs, const T* rhs, const std::size_t n) noexcept
+{
+    double result {0};
+    for (std::size_t i {0}; i < n; ++i) {
+        result += lhs[i] * rhs[i];
+    }
+    return result;
 }
 
 template <std::size_t K>
@@ -225,37 +270,32 @@ auto marginalise(const ProbabilityVector& distribution, const VBGenotypeVector<K
                               });
 }
 
-template <typename T1, typename T2>
-auto inner_product(const T1& lhs, const T2& rhs) noexcept
-{
-    assert(std::distance(std::cbegin(lhs), std::cend(lhs)) == std::distance(std::cbegin(rhs), std::cend(rhs)));
-    using T = typename T1::value_type;
-    return std::inner_product(std::cbegin(lhs), std::cend(lhs), std::cbegin(rhs), T {0});
-}
-
 template <std::size_t K>
 auto marginalise(const ProbabilityVector& distribution, const VBInverseGenotypeVector<K>& likelihoods,
                  const unsigned k, const std::size_t n) noexcept
 {
-    return inner_product(distribution, likelihoods[k][n]);
+    return dot(distribution.data(), likelihoods[k].row(n), likelihoods[k].num_genotypes());
 }
 
-template <std::size_t K, typename VBLikelihoodVector_>
-VBResponsabilityVector<K>
-init_responsabilities(const VBAlpha<K>& prior_alphas,
-                      const ProbabilityVector& genotype_probabilities,
-                      const VBLikelihoodVector_& read_likelihoods)
+template <std::size_t K>
+std::array<double, K> digamma_diffs(const VBAlpha<K>& alphas)
 {
-    using T = typename VBAlpha<K>::value_type;
-    std::array<T, K> al; // no need to keep recomputing this
-    const auto a0 = sum(prior_alphas);
+    std::array<double, K> result; // no need to keep recomputing this
+    const auto a0 = sum(alphas);
     for (unsigned k {0}; k < K; ++k) {
-        al[k] = digamma_diff(prior_alphas[k], a0);
+        result[k] = digamma_diff(alphas[k], a0);
     }
+    return result;
+}
+
+template <std::size_t K>
+void compute_responsabilities(VBResponsabilityVector<K>& result,
+                              const std::array<double, K>& al,
+                              const ProbabilityVector& genotype_probabilities,
+                              const VBGenotypeVector<K>& read_likelihoods)
+{
     const auto N = count_reads(read_likelihoods);
-    VBResponsabilityVector<K> result {};
-    for (auto& tau : result) tau.resize(N);
-    std::array<T, K> ln_rho;
+    std::array<double, K> ln_rho;
     for (std::size_t n {0}; n < N; ++n) {
         for (unsigned k {0}; k < K; ++k) {
             ln_rho[k] = al[k] + marginalise(genotype_probabilities, read_likelihoods, k, n);
@@ -265,6 +305,48 @@ init_responsabilities(const VBAlpha<K>& prior_alphas,
             result[k][n] = std::exp(ln_rho[k] - ln_rho_norm);
         }
     }
+}
+
+template <std::size_t K>
+void compute_responsabilities(VBResponsabilityVector<K>& result,
+                              const std::array<double, K>& al,
+                              const ProbabilityVector& genotype_probabilities,
+                              const VBInverseGenotypeVector<K>& read_likelihoods)
+{
+    const auto N = count_reads(read_likelihoods);
+    const auto G = genotype_probabilities.size();
+    // First pass: K dense matrix-vector products, each streaming one contiguous
+    // likelihood matrix against the genotype probabilities, buffering the
+    // un-normalised log responsabilities in the result
+    for (unsigned k {0}; k < K; ++k) {
+        const auto& likelihoods = read_likelihoods[k];
+        for (std::size_t n {0}; n < N; ++n) {
+            result[k][n] = al[k] + dot(genotype_probabilities.data(), likelihoods.row(n), G);
+        }
+    }
+    // Second pass: normalise each read's K log responsabilities in place
+    std::array<double, K> ln_rho;
+    for (std::size_t n {0}; n < N; ++n) {
+        for (unsigned k {0}; k < K; ++k) {
+            ln_rho[k] = result[k][n];
+        }
+        const auto ln_rho_norm = log_sum_exp(ln_rho);
+        for (unsigned k {0}; k < K; ++k) {
+            result[k][n] = std::exp(ln_rho[k] - ln_rho_norm);
+        }
+    }
+}
+
+template <std::size_t K, typename VBLikelihoodVector_>
+VBResponsabilityVector<K>
+init_responsabilities(const VBAlpha<K>& prior_alphas,
+                      const ProbabilityVector& genotype_probabilities,
+                      const VBLikelihoodVector_& read_likelihoods)
+{
+    const auto al = digamma_diffs(prior_alphas);
+    VBResponsabilityVector<K> result {};
+    for (auto& tau : result) tau.resize(count_reads(read_likelihoods));
+    compute_responsabilities(result, al, genotype_probabilities, read_likelihoods);
     return result;
 }
 
@@ -289,23 +371,8 @@ void update_responsabilities(VBResponsabilityVector<K>& result,
                              const ProbabilityVector& genotype_probabilities,
                              const VBLikelihoodVector_& read_likelihoods)
 {
-    using T = typename VBAlpha<K>::value_type;
-    std::array<T, K> al;
-    const auto a0 = sum(posterior_alphas);
-    for (unsigned k {0}; k < K; ++k) {
-        al[k] = digamma_diff(posterior_alphas[k], a0);
-    }
-    const auto N = count_reads(read_likelihoods);
-    std::array<T, K> ln_rho;
-    for (std::size_t n {0}; n < N; ++n) {
-        for (unsigned k {0}; k < K; ++k) {
-            ln_rho[k] = al[k] + marginalise(genotype_probabilities, read_likelihoods, k, n);
-        }
-        const auto ln_rho_norm = log_sum_exp(ln_rho);
-        for (unsigned k {0}; k < K; ++k) {
-            result[k][n] = std::exp(ln_rho[k] - ln_rho_norm);
-        }
-    }
+    const auto al = digamma_diffs(posterior_alphas);
+    compute_responsabilities(result, al, genotype_probabilities, read_likelihoods);
 }
 
 // same as init_responsabilities but in-place
@@ -350,7 +417,7 @@ void update_alphas(VBAlphaVector<K>& alphas, const VBAlphaVector<K>& prior_alpha
 inline auto marginalise(const VBTau& responsabilities, const VBReadLikelihoodArray& likelihoods) noexcept
 {
     assert(responsabilities.size() == likelihoods.size()); // num reads
-    return inner_product(responsabilities, likelihoods);
+    return dot(responsabilities.data(), likelihoods.begin(), responsabilities.size());
 }
 
 template <std::size_t K>
@@ -444,17 +511,19 @@ run_variational_bayes(const VBAlphaVector<K>& prior_alphas,
                       const VBLikelihoodMatrix1& log_likelihoods1,
                       const VBLikelihoodMatrix2& log_likelihoods2,
                       LogProbabilityVector genotype_log_posteriors,
-                      const VariationalBayesParameters& params)
+                      const VariationalBayesParameters& params,
+                      const VBAlphaVector<K>& initial_alphas)
 {
     assert(!prior_alphas.empty());
     assert(!genotype_log_priors.empty());
     assert(!log_likelihoods1.empty());
     assert(log_likelihoods1.size() == log_likelihoods2.size());
     assert(prior_alphas.size() == log_likelihoods1.size()); // num samples
+    assert(initial_alphas.size() == prior_alphas.size());
     assert(log_likelihoods1.front().size() == genotype_log_priors.size()); // num genotypes
     assert(params.max_iterations > 0);
     auto genotype_posteriors = exp(genotype_log_posteriors);
-    auto posterior_alphas = prior_alphas;
+    auto posterior_alphas = initial_alphas;
     auto responsabilities = init_responsabilities<K>(posterior_alphas, genotype_posteriors, log_likelihoods2);
     assert(responsabilities.size() == log_likelihoods1.size()); // num samples
     auto prev_evidence = std::numeric_limits<double>::lowest();
@@ -482,10 +551,12 @@ run_variational_bayes(const VBAlphaVector<K>& prior_alphas,
                       const LogProbabilityVector& genotype_log_priors,
                       const VBReadLikelihoodMatrix<K>& log_likelihoods,
                       LogProbabilityVector genotype_log_posteriors,
-                      const VariationalBayesParameters& params)
+                      const VariationalBayesParameters& params,
+                      const VBAlphaVector<K>& initial_alphas)
 {
-    return run_variational_bayes(prior_alphas, genotype_log_posteriors, log_likelihoods,
-                                 log_likelihoods, genotype_log_posteriors, params);
+    return run_variational_bayes(prior_alphas, genotype_log_priors, log_likelihoods,
+                                 log_likelihoods, std::move(genotype_log_posteriors), params,
+                                 initial_alphas);
 }
 
 // Main algorithm - multiple seed
@@ -504,22 +575,51 @@ run_variational_bayes(const VBAlphaVector<K>& prior_alphas,
                       const LogProbabilityVector& genotype_log_priors,
                       const VBReadLikelihoodMatrix<K>& log_likelihoods,
                       const VariationalBayesParameters& params,
-                      std::vector<LogProbabilityVector>&& seeds)
+                      std::vector<LogProbabilityVector>&& seeds,
+                      const VBAlphaVector<K>& initial_alphas,
+                      ThreadPool* workers)
 {
     std::vector<VBLatents<K>> result {};
-    result.reserve(seeds.size());
     if (run_vb_with_matrix_inversion(log_likelihoods, params, seeds)) {
         const auto inverted_log_likelihoods = invert(log_likelihoods);
-        for (auto& seed : seeds) {
-            result.push_back(detail::run_variational_bayes(prior_alphas, genotype_log_priors,
-                                                           log_likelihoods, inverted_log_likelihoods,
-                                                           std::move(seed), params));
+        const auto num_workers = workers ? workers->size() : 0;
+        if (num_workers > 1 && seeds.size() > 1) {
+            // Restarts only read the shared model inputs and write disjoint
+            // result slots, so they can run lock free on the pool
+            result.resize(seeds.size());
+            std::vector<std::future<void>> restarts {};
+            restarts.reserve(seeds.size());
+            for (std::size_t seed_idx {0}; seed_idx < seeds.size(); ++seed_idx) {
+                restarts.push_back(workers->push([&, seed_idx] () {
+                    result[seed_idx] = detail::run_variational_bayes(prior_alphas, genotype_log_priors,
+                                                                     log_likelihoods, inverted_log_likelihoods,
+                                                                     std::move(seeds[seed_idx]), params, initial_alphas);
+                }));
+            }
+            // Every restart must finish before any exception can propagate
+            std::exception_ptr error {nullptr};
+            for (auto& restart : restarts) {
+                try {
+                    restart.get();
+                } catch (...) {
+                    if (!error) error = std::current_exception();
+                }
+            }
+            if (error) std::rethrow_exception(error);
+        } else {
+            result.reserve(seeds.size());
+            for (auto& seed : seeds) {
+                result.push_back(detail::run_variational_bayes(prior_alphas, genotype_log_priors,
+                                                               log_likelihoods, inverted_log_likelihoods,
+                                                               std::move(seed), params, initial_alphas));
+            }
         }
     } else {
+        result.reserve(seeds.size());
         for (auto& seed : seeds) {
             result.push_back(detail::run_variational_bayes(prior_alphas, genotype_log_priors,
                                                            log_likelihoods,
-                                                           std::move(seed), params));
+                                                           std::move(seed), params, initial_alphas));
         }
     }
     return result;
@@ -549,20 +649,17 @@ void check_normalisation(VBLatents<K>& latents)
 }
 
 template <std::size_t K>
-std::pair<VBLatents<K>, double>
-get_max_evidence_latents(const VBAlphaVector<K>& prior_alphas,
-                         const LogProbabilityVector& genotype_log_priors,
-                         const VBReadLikelihoodMatrix<K>& log_likelihoods,
-                         std::vector<VBLatents<K>>&& latents)
+auto calculate_seed_evidences(const VBAlphaVector<K>& prior_alphas,
+                              const LogProbabilityVector& genotype_log_priors,
+                              const VBReadLikelihoodMatrix<K>& log_likelihoods,
+                              const std::vector<VBLatents<K>>& latents)
 {
-    std::vector<double> seed_evidences(latents.size());
-    std::transform(std::cbegin(latents), std::cend(latents), std::begin(seed_evidences),
+    std::vector<double> result(latents.size());
+    std::transform(std::cbegin(latents), std::cend(latents), std::begin(result),
                    [&] (const auto& seed_latents) {
                        return calculate_evidence_lower_bound(prior_alphas, genotype_log_priors, log_likelihoods, seed_latents);
                    });
-    const auto max_itr = std::max_element(std::cbegin(seed_evidences), std::cend(seed_evidences));
-    const auto max_idx = std::distance(std::cbegin(seed_evidences), max_itr);
-    return std::make_pair(std::move(latents[max_idx]), *max_itr);
+    return result;
 }
 
 } // namespace detail
@@ -573,11 +670,43 @@ run_variational_bayes(const VBAlphaVector<K>& prior_alphas,
                       const LogProbabilityVector& genotype_log_priors,
                       const VBReadLikelihoodMatrix<K>& log_likelihoods,
                       const VariationalBayesParameters& params,
-                      std::vector<LogProbabilityVector> seeds)
+                      std::vector<LogProbabilityVector> seeds,
+                      boost::optional<VBAlphaVector<K>> initial_alphas,
+                      ThreadPool* workers)
 {
     assert(!seeds.empty());
-    auto latents = detail::run_variational_bayes(prior_alphas, genotype_log_priors, log_likelihoods, params, std::move(seeds));
-    auto result = detail::get_max_evidence_latents(prior_alphas, genotype_log_priors, log_likelihoods, std::move(latents));
+    const VBAlphaVector<K>& start_alphas = initial_alphas ? *initial_alphas : prior_alphas;
+    // Most regions converge to the same optimum from every seed, so an initial
+    // pair of restarts is run first and the remaining seeds only on evidence of
+    // multimodality
+    constexpr std::size_t initialRestartBatchSize {2};
+    std::vector<LogProbabilityVector> deferred_seeds {};
+    if (seeds.size() > initialRestartBatchSize) {
+        deferred_seeds.assign(std::make_move_iterator(std::next(std::begin(seeds), initialRestartBatchSize)),
+                              std::make_move_iterator(std::end(seeds)));
+        seeds.resize(initialRestartBatchSize);
+    }
+    auto latents = detail::run_variational_bayes(prior_alphas, genotype_log_priors, log_likelihoods, params,
+                                                 std::move(seeds), start_alphas, workers);
+    auto evidences = detail::calculate_seed_evidences(prior_alphas, genotype_log_priors, log_likelihoods, latents);
+    if (!deferred_seeds.empty()) {
+        // Each restart stops iterating within epsilon of its plateau, so restarts
+        // that found the same optimum agree to within about twice that; wider
+        // disagreement means the remaining seeds are worth their cost
+        const auto minmax_evidence = std::minmax_element(std::cbegin(evidences), std::cend(evidences));
+        if (*minmax_evidence.second - *minmax_evidence.first > 2 * params.epsilon) {
+            auto deferred_latents = detail::run_variational_bayes(prior_alphas, genotype_log_priors, log_likelihoods, params,
+                                                                  std::move(deferred_seeds), start_alphas, workers);
+            auto deferred_evidences = detail::calculate_seed_evidences(prior_alphas, genotype_log_priors,
+                                                                       log_likelihoods, deferred_latents);
+            latents.insert(std::end(latents),
+                           std::make_move_iterator(std::begin(deferred_latents)),
+                           std::make_move_iterator(std::end(deferred_latents)));
+            evidences.insert(std::end(evidences), std::cbegin(deferred_evidences), std::cend(deferred_evidences));
+        }
+    }
+    const auto max_itr = std::max_element(std::cbegin(evidences), std::cend(evidences));
+    auto result = std::make_pair(std::move(latents[std::distance(std::cbegin(evidences), max_itr)]), *max_itr);
     detail::check_normalisation(result.first);
     return result;
 }
@@ -4,8 +4,17 @@
 #include "haplotype_likelihood_cache.hpp"
 
 #include <utility>
+#include <functional>
+#include <unordered_map>
+#include <numeric>
+#include <limits>
+#include <future>
+#include <exception>
 #include <cassert>
 
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
 #include <iostream> // DEBUG
 #include <iomanip>  // DEBUG
 
@@ -15,20 +24,53 @@ namespace octopus {
 
 HaplotypeLikelihoodCache::HaplotypeLikelihoodCache(const unsigned max_haplotypes,
                                                    const std::vector<SampleName>& samples)
-: cache_ {max_haplotypes}
+: haplotype_indices_ {max_haplotypes}
 , sample_indices_ {samples.size()}
-{
-    mapping_positions_.resize(maxMappingPositions);
-}
+{}
 
 HaplotypeLikelihoodCache::HaplotypeLikelihoodCache(HaplotypeLikelihoodModel likelihood_model,
                                                    unsigned max_haplotypes,
                                                    const std::vector<SampleName>& samples)
 : likelihood_model_ {std::move(likelihood_model)}
-, cache_ {max_haplotypes}
+, haplotype_indices_ {max_haplotypes}
 , sample_indices_ {samples.size()}
+{}
+
+HaplotypeLikelihoodCache::HaplotypeLikelihoodCache(const HaplotypeLikelihoodCache& other)
+: likelihood_model_ {other.likelihood_model_}
+, haplotype_indices_ {other.haplotype_indices_}
+, sample_indices_ {other.sample_indices_}
+, likelihood_matrices_ {other.likelihood_matrices_}
+, likelihood_rows_ {other.likelihood_rows_}
+, primed_sample_ {other.primed_sample_}
+, read_iterators_ {other.read_iterators_}
+, workers_ {other.workers_}
+, memory_budget_ {other.memory_budget_}
+, spill_directory_ {other.spill_directory_}
 {
-    mapping_positions_.resize(maxMappingPositions);
+    for (std::size_t s {0}; s < likelihood_rows_.size(); ++s) {
+        reset_row_views(s);
+    }
+}
+
+HaplotypeLikelihoodCache& HaplotypeLikelihoodCache::operator=(const HaplotypeLikelihoodCache& other)
+{
+    if (this != &other) {
+        likelihood_model_    = other.likelihood_model_;
+        haplotype_indices_   = other.haplotype_indices_;
+        sample_indices_      = other.sample_indices_;
+        likelihood_matrices_ = other.likelihood_matrices_;
+        likelihood_rows_     = other.likelihood_rows_;
+        primed_sample_       = other.primed_sample_;
+        read_iterators_      = other.read_iterators_;
+        workers_             = other.workers_;
+        memory_budget_       = other.memory_budget_;
+        spill_directory_     = other.spill_directory_;
+        for (std::size_t s {0}; s < likelihood_rows_.size(); ++s) {
+            reset_row_views(s);
+        }
+    }
+    return *this;
 }
 
 HaplotypeLikelihoodCache::ReadPacket::ReadPacket(Iterator first, Iterator last)
@@ -37,52 +79,439 @@ HaplotypeLikelihoodCache::ReadPacket::ReadPacket(Iterator first, Iterator last)
 , num_reads {static_cast<std::size_t>(std::distance(first, last))}
 {}
 
+struct HaplotypeLikelihoodCache::LikelihoodMatrix::SpillFile
+{
+    SpillFile(boost::filesystem::path file_path, std::size_t num_bytes)
+    : path {std::move(file_path)}
+    {
+        boost::iostreams::mapped_file_params params {path.string()};
+        params.new_file_size = static_cast<boost::iostreams::stream_offset>(num_bytes);
+        params.flags = boost::iostreams::mapped_file::readwrite;
+        file.open(params);
+    }
+    ~SpillFile()
+    {
+        file.close();
+        boost::system::error_code ec {};
+        boost::filesystem::remove(path, ec); // best effort; the temp directory is removed on exit
+    }
+    boost::iostreams::mapped_file file;
+    boost::filesystem::path path;
+};
+
+HaplotypeLikelihoodCache::LikelihoodMatrix::LikelihoodMatrix() noexcept
+: heap_ {}, spill_ {}, data_ {nullptr}, size_ {0}
+{}
+
+HaplotypeLikelihoodCache::LikelihoodMatrix::LikelihoodMatrix(const LikelihoodMatrix& other)
+: heap_ {other.data_, other.data_ + other.size_}
+, spill_ {}
+, data_ {heap_.data()}
+, size_ {heap_.size()}
+{}
+
+HaplotypeLikelihoodCache::LikelihoodMatrix&
+HaplotypeLikelihoodCache::LikelihoodMatrix::operator=(const LikelihoodMatrix& other)
+{
+    if (this != &other) {
+        heap_.assign(other.data_, other.data_ + other.size_);
+        spill_.reset();
+        data_ = heap_.data();
+        size_ = heap_.size();
+    }
+    return *this;
+}
+
+HaplotypeLikelihoodCache::LikelihoodMatrix::LikelihoodMatrix(LikelihoodMatrix&&) noexcept = default;
+HaplotypeLikelihoodCache::LikelihoodMatrix& HaplotypeLikelihoodCache::LikelihoodMatrix::operator=(LikelihoodMatrix&&) noexcept = default;
+HaplotypeLikelihoodCache::LikelihoodMatrix::~LikelihoodMatrix() = default;
+
+void HaplotypeLikelihoodCache::LikelihoodMatrix::resize(const std::size_t size)
+{
+    spill_.reset();
+    heap_.resize(size);
+    data_ = heap_.data();
+    size_ = size;
+}
+
+void HaplotypeLikelihoodCache::LikelihoodMatrix::resize(const std::size_t size, boost::filesystem::path spill_file)
+{
+    if (size == 0) {
+        resize(size);
+        return;
+    }
+    heap_.clear();
+    heap_.shrink_to_fit();
+    spill_ = std::make_unique<SpillFile>(std::move(spill_file), size * sizeof(double));
+    data_ = reinterpret_cast<double*>(spill_->file.data());
+    size_ = size;
+}
+
+void HaplotypeLikelihoodCache::LikelihoodMatrix::materialise()
+{
+    if (spill_) {
+        heap_.assign(data_, data_ + size_);
+        spill_.reset();
+        data_ = heap_.data();
+    }
+}
+
+namespace {
+
+// Reads that compare equal and are mapped to the same strand are
+// indistinguishable to the likelihood model
+struct IsLikelihoodEquivalent
+{
+    bool operator()(const AlignedRead& lhs, const AlignedRead& rhs) const noexcept
+    {
+        return lhs == rhs && lhs.is_marked_reverse_mapped() == rhs.is_marked_reverse_mapped();
+    }
+};
+
+} // namespace
+
 void HaplotypeLikelihoodCache::populate(const ReadMap& reads,
                                         const std::vector<Haplotype>& haplotypes,
                                         boost::optional<FlankState> flank_state)
 {
     // This code is not very pretty because it is a bottleneck for the entire application.
     // We want to try a minimise memory allocations for the mapping.
-    cache_.clear();
-    if (cache_.bucket_count() < haplotypes.size()) {
-        cache_.rehash(haplotypes.size());
+    haplotype_indices_.clear();
+    if (haplotype_indices_.bucket_count() < haplotypes.size()) {
+        haplotype_indices_.rehash(haplotypes.size());
+    }
+    set_read_iterators_and_sample_indices(reads);
+    assert(reads.size() == read_iterators_.size());
+    const auto num_samples = reads.size();
+    const auto num_haplotypes = haplotypes.size();
+    // The matrices can be sized exactly up front, so the row views are stable
+    // while they are filled
+    likelihood_matrices_.resize(num_samples);
+    likelihood_rows_.resize(num_samples);
+    std::size_t total_likelihoods {0};
+    for (std::size_t s {0}; s < num_samples; ++s) {
+        total_likelihoods += num_haplotypes * read_iterators_[s].num_reads;
+    }
+    const bool spill {requires_spilling(total_likelihoods)};
+    for (std::size_t s {0}; s < num_samples; ++s) {
+        const auto num_reads = read_iterators_[s].num_reads;
+        if (spill) {
+            likelihood_matrices_[s].resize(num_haplotypes * num_reads, make_spill_file_path());
+        } else {
+            likelihood_matrices_[s].resize(num_haplotypes * num_reads);
+        }
+        likelihood_rows_[s].resize(num_haplotypes);
+        const auto* data = likelihood_matrices_[s].data();
+        for (std::size_t row {0}; row < num_haplotypes; ++row) {
+            likelihood_rows_[s][row] = LikelihoodVector {data + row * num_reads, num_reads};
+        }
+    }
+    std::vector<HaplotypeRef> target_haplotypes {};
+    target_haplotypes.reserve(num_haplotypes);
+    std::size_t row_idx {0};
+    for (const auto& haplotype : haplotypes) {
+        haplotype_indices_.emplace(haplotype, row_idx++);
+        target_haplotypes.emplace_back(haplotype);
+    }
+    std::vector<std::size_t> target_rows(num_haplotypes);
+    std::iota(std::begin(target_rows), std::end(target_rows), std::size_t {0});
+    evaluate_rows(target_haplotypes, target_rows, {}, flank_state);
+}
+
+void HaplotypeLikelihoodCache::update(const ReadMap& reads,
+                                      const std::vector<Haplotype>& haplotypes,
+                                      boost::optional<FlankState> flank_state)
+{
+    if (is_empty()) {
+        populate(reads, haplotypes, std::move(flank_state));
+        return;
+    }
+    const auto old_indices  = std::move(haplotype_indices_);
+    const auto old_matrices = std::move(likelihood_matrices_);
+    const auto old_rows     = std::move(likelihood_rows_);
+    haplotype_indices_.clear();
+    likelihood_matrices_.clear();
+    likelihood_rows_.clear();
+    if (haplotype_indices_.bucket_count() < haplotypes.size()) {
+        haplotype_indices_.rehash(haplotypes.size());
     }
     set_read_iterators_and_sample_indices(reads);
     assert(reads.size() == read_iterators_.size());
     const auto num_samples = reads.size();
-    // Precompute all read hashes so we don't have to recompute for each haplotype
+    const auto num_haplotypes = haplotypes.size();
+    likelihood_matrices_.resize(num_samples);
+    likelihood_rows_.resize(num_samples);
+    std::size_t total_likelihoods {0};
+    for (std::size_t s {0}; s < num_samples; ++s) {
+        total_likelihoods += num_haplotypes * read_iterators_[s].num_reads;
+    }
+    const bool spill {requires_spilling(total_likelihoods)};
+    for (std::size_t s {0}; s < num_samples; ++s) {
+        const auto num_reads = read_iterators_[s].num_reads;
+        if (spill) {
+            likelihood_matrices_[s].resize(num_haplotypes * num_reads, make_spill_file_path());
+        } else {
+            likelihood_matrices_[s].resize(num_haplotypes * num_reads);
+        }
+        likelihood_rows_[s].resize(num_haplotypes);
+        const auto* data = likelihood_matrices_[s].data();
+        for (std::size_t row {0}; row < num_haplotypes; ++row) {
+            likelihood_rows_[s][row] = LikelihoodVector {data + row * num_reads, num_reads};
+        }
+    }
+    // The old likelihoods can only be trusted if the read layout is unchanged
+    bool reusable {old_matrices.size() == num_samples && old_rows.size() == num_samples};
+    if (reusable) {
+        for (std::size_t s {0}; s < num_samples; ++s) {
+            if (old_rows[s].empty() || old_rows[s].front().size() != read_iterators_[s].num_reads) {
+                reusable = false;
+                break;
+            }
+        }
+    }
+    std::vector<HaplotypeRef> new_haplotypes {};
+    std::vector<std::size_t> new_rows {}, retained_rows {};
+    std::size_t row_idx {0};
+    for (const auto& haplotype : haplotypes) {
+        haplotype_indices_.emplace(haplotype, row_idx);
+        const auto old_itr = reusable ? old_indices.find(haplotype) : std::cend(old_indices);
+        if (old_itr != std::cend(old_indices)) {
+            for (std::size_t s {0}; s < num_samples; ++s) {
+                const auto& old_row = old_rows[s][old_itr->second];
+                std::copy(std::cbegin(old_row), std::cend(old_row),
+                          likelihood_matrices_[s].data() + row_idx * read_iterators_[s].num_reads);
+            }
+            retained_rows.push_back(row_idx);
+        } else {
+            new_haplotypes.emplace_back(haplotype);
+            new_rows.push_back(row_idx);
+        }
+        ++row_idx;
+    }
+    if (!new_haplotypes.empty()) {
+        evaluate_rows(new_haplotypes, new_rows, retained_rows, flank_state);
+    } else {
+        read_iterators_.clear();
+    }
+}
+
+void HaplotypeLikelihoodCache::enable_parallel_evaluation(ThreadPool& workers) noexcept
+{
+    workers_ = std::addressof(workers);
+}
+
+void HaplotypeLikelihoodCache::disable_parallel_evaluation() noexcept
+{
+    workers_ = nullptr;
+}
+
+void HaplotypeLikelihoodCache::set_memory_budget(const MemoryFootprint budget, boost::filesystem::path spill_directory)
+{
+    memory_budget_ = budget;
+    spill_directory_ = std::move(spill_directory);
+}
+
+void HaplotypeLikelihoodCache::unset_memory_budget() noexcept
+{
+    memory_budget_ = boost::none;
+    spill_directory_.clear();
+}
+
+bool HaplotypeLikelihoodCache::requires_spilling(const std::size_t num_likelihoods) const noexcept
+{
+    return memory_budget_ && !spill_directory_.empty()
+           && num_likelihoods * sizeof(double) > memory_budget_->num_bytes();
+}
+
+boost::filesystem::path HaplotypeLikelihoodCache::make_spill_file_path() const
+{
+    return spill_directory_ / boost::filesystem::unique_path("octopus-likelihoods-%%%%-%%%%-%%%%.bin");
+}
+
+void HaplotypeLikelihoodCache::evaluate_rows(const std::vector<HaplotypeRef>& haplotypes,
+                                             const std::vector<std::size_t>& rows,
+                                             const std::vector<std::size_t>& seeded_rows,
+                                             const boost::optional<FlankState>& flank_state)
+{
+    const auto num_samples = read_iterators_.size();
+    // Duplicate evaluations are memoised: reads that are equivalent for the likelihood
+    // model (e.g. copies of overlapping mates or surviving PCR duplicates) share one
+    // HMM evaluation, so hashes and likelihoods are only computed for the first copy
+    std::vector<std::vector<std::reference_wrapper<const AlignedRead>>> unique_reads(num_samples);
+    std::vector<std::vector<std::size_t>> unique_positions(num_samples);
+    {
+        std::unordered_map<std::reference_wrapper<const AlignedRead>, std::size_t,
+                           std::hash<std::reference_wrapper<const AlignedRead>>,
+                           IsLikelihoodEquivalent> read_memo {};
+        for (std::size_t s {0}; s < num_samples; ++s) {
+            const auto& t = read_iterators_[s];
+            read_memo.clear();
+            if (read_memo.bucket_count() < t.num_reads) {
+                read_memo.rehash(t.num_reads);
+            }
+            unique_reads[s].reserve(t.num_reads);
+            unique_positions[s].reserve(t.num_reads);
+            std::for_each(t.first, t.last, [&] (const AlignedRead& read) {
+                const auto p = read_memo.emplace(read, unique_reads[s].size());
+                if (p.second) unique_reads[s].emplace_back(read);
+                unique_positions[s].push_back(p.first->second);
+            });
+        }
+    }
+    // Precompute the unique read hashes so we don't have to recompute for each haplotype
     std::vector<std::vector<KmerPerfectHashes>> read_hashes {};
     read_hashes.reserve(num_samples);
-    for (const auto& t : read_iterators_) {
+    for (const auto& sample_unique_reads : unique_reads) {
         std::vector<KmerPerfectHashes> sample_read_hashes {};
-        sample_read_hashes.reserve(t.num_reads);
-        std::transform(t.first, t.last, std::back_inserter(sample_read_hashes),
+        sample_read_hashes.reserve(sample_unique_reads.size());
+        std::transform(std::cbegin(sample_unique_reads), std::cend(sample_unique_reads),
+                       std::back_inserter(sample_read_hashes),
                        [] (const AlignedRead& read) { return compute_kmer_hashes<mapperKmerSize>(read.sequence()); });
         read_hashes.emplace_back(std::move(sample_read_hashes));
     }
-    auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
-    const auto first_mapping_position = std::begin(mapping_positions_);
-    for (const auto& haplotype : haplotypes) {
-        populate_kmer_hash_table<mapperKmerSize>(haplotype.sequence(), haplotype_hashes);
-        auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
-        auto itr = std::begin(cache_.emplace(std::piecewise_construct,
-                                             std::forward_as_tuple(haplotype),
-                                             std::forward_as_tuple(num_samples)).first->second);
-        likelihood_model_.reset(haplotype, flank_state);
+    // Likelihoods more than this far (in log probability; ~ phred 300) below a read's
+    // best against any haplotype seen so far cannot meaningfully change anything
+    // computed from the cache, so the model is allowed to truncate them early
+    constexpr double likelihoodFloorOffset {-69.0};
+    constexpr auto lowest = std::numeric_limits<double>::lowest();
+    // Per-read running best likelihood, indexed like the unique reads
+    std::vector<std::vector<double>> best_likelihoods(num_samples);
+    for (std::size_t s {0}; s < num_samples; ++s) {
+        best_likelihoods[s].assign(unique_reads[s].size(), lowest);
+    }
+    // Rows already in the cache seed the floors
+    for (std::size_t s {0}; s < num_samples; ++s) {
+        const auto num_reads = read_iterators_[s].num_reads;
+        auto& sample_best_likelihoods = best_likelihoods[s];
+        for (const auto row : seeded_rows) {
+            const auto* row_data = likelihood_matrices_[s].data() + row * num_reads;
+            for (std::size_t n {0}; n < num_reads; ++n) {
+                auto& best = sample_best_likelihoods[unique_positions[s][n]];
+                best = std::max(best, row_data[n]);
+            }
+        }
+    }
+    // Alignment scores are shared between haplotypes that match over the window
+    // the HMM reads; each sample's unique reads get a distinct range of memo ids
+    std::vector<std::size_t> memo_offsets(num_samples);
+    std::size_t total_unique_reads {0};
+    for (std::size_t s {0}; s < num_samples; ++s) {
+        memo_offsets[s] = total_unique_reads;
+        total_unique_reads += unique_reads[s].size();
+    }
+    // Everything the evaluation of one row needs that cannot be shared between
+    // threads: the model buffers per-haplotype state, the memo is unguarded,
+    // and the floors are read and written per alignment
+    struct EvaluationContext
+    {
+        HaplotypeLikelihoodModel model;
+        HaplotypeLikelihoodModel::AlignmentMemo memo;
+        std::vector<std::size_t> mapping_positions;
+        std::vector<std::vector<double>> best_likelihoods;
+        std::vector<double> unique_likelihoods;
+        MappedIndexCounts haplotype_mapping_counts;
+        const std::string* prev_haplotype_sequence;
+    };
+    const auto evaluate_row = [&] (const std::size_t target_idx, EvaluationContext& ctx,
+                                   KmerHashTable& haplotype_hashes) {
+        const Haplotype& haplotype {haplotypes[target_idx]};
+        const auto row_idx = rows[target_idx];
+        // Consecutive haplotypes mostly share sequence, so the previous row's
+        // index is patched rather than rebuilt when only a few sites changed
+        if (ctx.prev_haplotype_sequence) {
+            update_kmer_hash_table<mapperKmerSize>(*ctx.prev_haplotype_sequence, haplotype.sequence(),
+                                                   haplotype_hashes);
+        } else {
+            populate_kmer_hash_table<mapperKmerSize>(haplotype.sequence(), haplotype_hashes);
+        }
+        ctx.prev_haplotype_sequence = std::addressof(haplotype.sequence());
+        ctx.haplotype_mapping_counts.assign(haplotype_hashes.second, 0);
+        ctx.model.reset(haplotype, flank_state);
+        const auto first_mapping_position = std::begin(ctx.mapping_positions);
         auto read_hash_itr = std::cbegin(read_hashes);
+        std::size_t sample_idx {0};
         for (const auto& t : read_iterators_) { // for each sample
-            *itr = std::vector<double>(t.num_reads);
-            std::transform(t.first, t.last, std::cbegin(*read_hash_itr), std::begin(*itr),
-                           [&] (const AlignedRead& read, const auto& read_hashes) {
-                               const auto last_mapping_position = map_query_to_target(read_hashes, haplotype_hashes,
-                                                                                      haplotype_mapping_counts,
-                                                                                      first_mapping_position,
-                                                                                      maxMappingPositions);
-                               reset_mapping_counts(haplotype_mapping_counts);
-                               return likelihood_model_.evaluate(read, first_mapping_position, last_mapping_position);
-                           });
+            auto* const row_data = likelihood_matrices_[sample_idx].data() + row_idx * t.num_reads;
+            const auto& sample_read_hashes = *read_hash_itr;
+            const auto& sample_unique_reads = unique_reads[sample_idx];
+            auto& sample_best_likelihoods = ctx.best_likelihoods[sample_idx];
+            const bool has_duplicates {sample_unique_reads.size() < t.num_reads};
+            if (has_duplicates) {
+                ctx.unique_likelihoods.resize(sample_unique_reads.size());
+            }
+            ctx.model.set_alignment_memo(ctx.memo, memo_offsets[sample_idx]);
+            ctx.model.evaluate(std::cbegin(sample_unique_reads), std::cend(sample_unique_reads),
+                               [&] (const std::size_t read_idx, const AlignedRead&) {
+                                   const auto last_mapping_position = map_query_to_target(sample_read_hashes[read_idx],
+                                                                                          haplotype_hashes,
+                                                                                          ctx.haplotype_mapping_counts,
+                                                                                          first_mapping_position,
+                                                                                          maxMappingPositions);
+                                   reset_mapping_counts(ctx.haplotype_mapping_counts);
+                                   return std::make_pair(first_mapping_position, last_mapping_position);
+                               },
+                               [&] (const std::size_t read_idx) {
+                                   const auto best = sample_best_likelihoods[read_idx];
+                                   return best == lowest ? lowest : best + likelihoodFloorOffset;
+                               },
+                               has_duplicates ? ctx.unique_likelihoods.data() : row_data);
+            const auto* const evaluated_likelihoods = has_duplicates ? ctx.unique_likelihoods.data() : row_data;
+            if (has_duplicates) {
+                std::transform(std::cbegin(unique_positions[sample_idx]), std::cend(unique_positions[sample_idx]),
+                               row_data,
+                               [&] (const std::size_t unique_idx) { return ctx.unique_likelihoods[unique_idx]; });
+            }
+            std::transform(evaluated_likelihoods, evaluated_likelihoods + sample_unique_reads.size(),
+                           std::cbegin(sample_best_likelihoods), std::begin(sample_best_likelihoods),
+                           [] (const double curr, const double best) { return std::max(curr, best); });
             ++read_hash_itr;
-            ++itr;
+            ++sample_idx;
+        }
+    };
+    const auto num_workers = workers_ ? workers_->size() : std::size_t {0};
+    if (num_workers > 1 && haplotypes.size() > 1) {
+        // Contiguous chunks of rows are sharded across the pool. Each chunk
+        // gets its own context, so truncation floors and memoised alignments
+        // are only shared within a chunk - a weaker floor is still a floor
+        const auto num_chunks = std::min(num_workers, haplotypes.size());
+        std::vector<EvaluationContext> contexts {};
+        contexts.reserve(num_chunks);
+        for (std::size_t chunk {0}; chunk < num_chunks; ++chunk) {
+            contexts.push_back({likelihood_model_, {}, std::vector<std::size_t>(maxMappingPositions),
+                                best_likelihoods, {}, {}, nullptr});
+            contexts.back().memo.prepare(total_unique_reads);
+        }
+        std::vector<std::future<void>> chunk_futures {};
+        chunk_futures.reserve(num_chunks);
+        for (std::size_t chunk {0}; chunk < num_chunks; ++chunk) {
+            const auto first_row = chunk * haplotypes.size() / num_chunks;
+            const auto last_row  = (chunk + 1) * haplotypes.size() / num_chunks;
+            chunk_futures.push_back(workers_->push([&, first_row, last_row, chunk] () {
+                auto& haplotype_hashes = thread_local_kmer_hash_table<mapperKmerSize>();
+                for (auto target_idx = first_row; target_idx < last_row; ++target_idx) {
+                    evaluate_row(target_idx, contexts[chunk], haplotype_hashes);
+                }
+                clear_kmer_hash_table(haplotype_hashes);
+            }));
+        }
+        // Every chunk must finish before any exception can propagate as the
+        // tasks reference this frame
+        std::exception_ptr error {};
+        for (auto& chunk_future : chunk_futures) {
+            try {
+                chunk_future.get();
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+        if (error) std::rethrow_exception(error);
+    } else {
+        EvaluationContext ctx {likelihood_model_, {}, std::vector<std::size_t>(maxMappingPositions),
+                               std::move(best_likelihoods), {}, {}, nullptr};
+        ctx.memo.prepare(total_unique_reads);
+        auto& haplotype_hashes = thread_local_kmer_hash_table<mapperKmerSize>();
+        for (std::size_t target_idx {0}; target_idx < haplotypes.size(); ++target_idx) {
+            evaluate_row(target_idx, ctx, haplotype_hashes);
         }
         clear_kmer_hash_table(haplotype_hashes);
     }
@@ -92,45 +521,47 @@ void HaplotypeLikelihoodCache::populate(const ReadMap& reads,
 
 std::size_t HaplotypeLikelihoodCache::num_likelihoods(const SampleName& sample) const
 {
-    return std::cbegin(cache_)->second.at(sample_indices_.at(sample)).size();
+    return likelihood_rows_.at(sample_indices_.at(sample)).front().size();
 }
 
 const HaplotypeLikelihoodCache::LikelihoodVector&
 HaplotypeLikelihoodCache::operator()(const SampleName& sample, const Haplotype& haplotype) const
 {
-    return cache_.at(haplotype)[sample_indices_.at(sample)];
+    return likelihood_rows_[sample_indices_.at(sample)][haplotype_indices_.at(haplotype)];
 }
 
 const HaplotypeLikelihoodCache::LikelihoodVector&
 HaplotypeLikelihoodCache::operator[](const Haplotype& haplotype) const
 {
-    return cache_.at(haplotype)[*primed_sample_];
+    return likelihood_rows_[*primed_sample_][haplotype_indices_.at(haplotype)];
 }
 
 HaplotypeLikelihoodCache::SampleLikelihoodMap
 HaplotypeLikelihoodCache::extract_sample(const SampleName& sample) const
 {
-    const auto sample_index = sample_indices_.at(sample);
-    SampleLikelihoodMap result {cache_.size()};
-    for (const auto& p : cache_) {
-        result.emplace(p.first, p.second[sample_index]);
+    const auto& rows = likelihood_rows_.at(sample_indices_.at(sample));
+    SampleLikelihoodMap result {haplotype_indices_.size()};
+    for (const auto& p : haplotype_indices_) {
+        result.emplace(p.first, rows[p.second]);
     }
     return result;
 }
 
 bool HaplotypeLikelihoodCache::contains(const Haplotype& haplotype) const noexcept
 {
-    return cache_.count(haplotype) == 1;
+    return haplotype_indices_.count(haplotype) == 1;
 }
 
 bool HaplotypeLikelihoodCache::is_empty() const noexcept
 {
-    return cache_.empty();
+    return haplotype_indices_.empty();
 }
 
 void HaplotypeLikelihoodCache::clear() noexcept
 {
-    cache_.clear();
+    haplotype_indices_.clear();
+    likelihood_matrices_.clear();
+    likelihood_rows_.clear();
     sample_indices_.clear();
     unprime();
 }
@@ -170,6 +601,15 @@ void HaplotypeLikelihoodCache::set_read_iterators_and_sample_indices(const ReadM
     }
 }
 
+void HaplotypeLikelihoodCache::reset_row_views(const std::size_t sample_idx) noexcept
+{
+    const auto* itr = likelihood_matrices_[sample_idx].data();
+    for (auto& row : likelihood_rows_[sample_idx]) {
+        row = LikelihoodVector {itr, row.size()};
+        itr += row.size();
+    }
+}
+
 // non-member methods
 
 HaplotypeLikelihoodCache merge_samples(const std::vector<SampleName>& samples,
@@ -178,14 +618,14 @@ HaplotypeLikelihoodCache merge_samples(const std::vector<SampleName>& samples,
                                        const HaplotypeLikelihoodCache& haplotype_likelihoods)
 {
     HaplotypeLikelihoodCache result {static_cast<unsigned>(haplotypes.size()), {new_sample}};
+    std::vector<double> likelihoods {};
     for (const auto& haplotype : haplotypes) {
-        HaplotypeLikelihoodCache::LikelihoodVector likelihoods {};
+        likelihoods.clear();
         for (const auto& sample : samples) {
             const auto& m = haplotype_likelihoods(sample, haplotype);
             likelihoods.insert(std::end(likelihoods), std::cbegin(m), std::cend(m));
         }
-        likelihoods.shrink_to_fit();
-        result.insert(new_sample, haplotype, std::move(likelihoods));
+        result.insert(new_sample, haplotype, likelihoods);
     }
     return result;
 }
@@ -8,13 +8,20 @@
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <cstddef>
 
 #include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
 
 #include "config/common.hpp"
+#include "containers/huge_page_allocator.hpp"
 #include "core/types/haplotype.hpp"
 #include "basics/aligned_read.hpp"
 #include "utils/kmer_mapper.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/memory_footprint.hpp"
 #include "haplotype_likelihood_model.hpp"
 
 namespace octopus {
@@ -22,16 +29,48 @@ namespace octopus {
 /*
     HaplotypeLikelihoodCache is essentially a matrix of haplotype likelihoods, i.e.
     p(read | haplotype) for a given set of AlignedReads and Haplotypes.
- 
+
     The matrix can be efficiently populated as the read mapping and alignment are
     done internally which allows minimal memory allocation.
+
+    The likelihoods are stored as one contiguous [haplotype x read] matrix per
+    sample, so reductions over the rows of a genotype's haplotypes - the hot
+    loop of the genotype likelihood models - scan adjacent memory.
  */
 class HaplotypeLikelihoodCache
 {
 public:
     using FlankState = HaplotypeLikelihoodModel::FlankState;
-    
-    using LikelihoodVector     = std::vector<double>;
+
+    // A read-only view of one row (haplotype) of a sample's likelihood matrix
+    class LikelihoodVector
+    {
+    public:
+        using value_type     = double;
+        using size_type      = std::size_t;
+        using const_iterator = const double*;
+        using iterator       = const_iterator;
+
+        LikelihoodVector() = default;
+        LikelihoodVector(const double* data, std::size_t size) noexcept
+        : data_ {data}, size_ {size} {}
+
+        const double* data() const noexcept { return data_; }
+        std::size_t size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+        const_iterator begin() const noexcept { return data_; }
+        const_iterator end() const noexcept { return data_ + size_; }
+        const_iterator cbegin() const noexcept { return data_; }
+        const_iterator cend() const noexcept { return data_ + size_; }
+        double operator[](const std::size_t n) const noexcept { return data_[n]; }
+        double front() const noexcept { return *data_; }
+        double back() const noexcept { return data_[size_ - 1]; }
+
+    private:
+        const double* data_ = nullptr;
+        std::size_t size_ = 0;
+    };
+
     using LikelihoodVectorRef  = std::reference_wrapper<const LikelihoodVector>;
     using HaplotypeRef         = std::reference_wrapper<const Haplotype>;
     using SampleLikelihoodMap  = std::unordered_map<HaplotypeRef, LikelihoodVectorRef>;
@@ -44,8 +83,10 @@ public:
                              unsigned max_haplotypes,
                              const std::vector<SampleName>& samples);
     
-    HaplotypeLikelihoodCache(const HaplotypeLikelihoodCache&)            = default;
-    HaplotypeLikelihoodCache& operator=(const HaplotypeLikelihoodCache&) = default;
+    // The row views point into this cache's likelihood matrices, so copying
+    // must rebase them onto the copied storage
+    HaplotypeLikelihoodCache(const HaplotypeLikelihoodCache&);
+    HaplotypeLikelihoodCache& operator=(const HaplotypeLikelihoodCache&);
     HaplotypeLikelihoodCache(HaplotypeLikelihoodCache&&)                 = default;
     HaplotypeLikelihoodCache& operator=(HaplotypeLikelihoodCache&&)      = default;
     
@@ -53,7 +94,28 @@ public:
     
     void populate(const ReadMap& reads, const std::vector<Haplotype>& haplotypes,
                   boost::optional<FlankState> flank_state = boost::none);
-    
+
+    // As populate, but likelihoods of haplotypes already in the cache are kept
+    // rather than recomputed - haplotype generation frequently re-emits
+    // haplotypes scored in a previous pass. The caller must ensure the reads
+    // (and hence the flank state, given any haplotype survives) are unchanged
+    // since the cache was last populated.
+    void update(const ReadMap& reads, const std::vector<Haplotype>& haplotypes,
+                boost::optional<FlankState> flank_state = boost::none);
+
+    // Shards likelihood evaluation between the pool's threads - population is
+    // the dominant serial section of a calling task. The pool must outlive the
+    // cache; evaluation stays serial while the pool has no workers.
+    void enable_parallel_evaluation(ThreadPool& workers) noexcept;
+    void disable_parallel_evaluation() noexcept;
+
+    // Matrices populated beyond the given footprint are backed by memory
+    // mapped files in the given directory rather than the heap, so the kernel
+    // can page cold rows out instead of the process exhausting memory in
+    // mega-depth regions. The directory must outlive the cache.
+    void set_memory_budget(MemoryFootprint budget, boost::filesystem::path spill_directory);
+    void unset_memory_budget() noexcept;
+
     std::size_t num_likelihoods(const SampleName& sample) const;
     
     const LikelihoodVector& operator()(const SampleName& sample, const Haplotype& haplotype) const;
@@ -79,9 +141,48 @@ public:
 private:
     static constexpr unsigned char mapperKmerSize {6};
     static constexpr std::size_t maxMappingPositions {10};
-    
+
+    // Storage for one sample's likelihood matrix; heap allocated unless
+    // resized onto a spill file. Copies always land on the heap, and growing
+    // a spilled matrix first moves it back there.
+    class LikelihoodMatrix
+    {
+    public:
+        LikelihoodMatrix() noexcept;
+        LikelihoodMatrix(const LikelihoodMatrix&);
+        LikelihoodMatrix& operator=(const LikelihoodMatrix&);
+        LikelihoodMatrix(LikelihoodMatrix&&) noexcept;
+        LikelihoodMatrix& operator=(LikelihoodMatrix&&) noexcept;
+        ~LikelihoodMatrix();
+
+        double* data() noexcept { return data_; }
+        const double* data() const noexcept { return data_; }
+        std::size_t size() const noexcept { return size_; }
+
+        void resize(std::size_t size);
+        void resize(std::size_t size, boost::filesystem::path spill_file);
+        template <typename InputIt>
+        void append(InputIt first, InputIt last)
+        {
+            materialise();
+            heap_.insert(std::end(heap_), first, last);
+            data_ = heap_.data();
+            size_ = heap_.size();
+        }
+
+    private:
+        struct SpillFile;
+
+        std::vector<double, HugePageAllocator<double>> heap_;
+        std::unique_ptr<SpillFile> spill_;
+        double* data_;
+        std::size_t size_;
+
+        void materialise();
+    };
+
     HaplotypeLikelihoodModel likelihood_model_;
-    
+
     struct ReadPacket
     {
         using Iterator = ReadMap::mapped_type::const_iterator;
@@ -90,31 +191,57 @@ private:
         std::size_t num_reads;
     };
     
-    std::unordered_map<Haplotype, std::vector<LikelihoodVector>, HaplotypeHash> cache_;
+    std::unordered_map<Haplotype, std::size_t, HaplotypeHash> haplotype_indices_;
     std::unordered_map<SampleName, std::size_t> sample_indices_;
-    
+    std::vector<LikelihoodMatrix> likelihood_matrices_; // One contiguous [haplotype x read] matrix per sample
+    std::vector<std::vector<LikelihoodVector>> likelihood_rows_; // Views into the matrices, indexed like haplotype_indices_
+
     mutable boost::optional<std::size_t> primed_sample_;
-    
+
     // Just to optimise population
     std::vector<ReadPacket> read_iterators_;
-    std::vector<std::size_t> mapping_positions_;
-    
+    ThreadPool* workers_ = nullptr;
+    boost::optional<MemoryFootprint> memory_budget_;
+    boost::filesystem::path spill_directory_;
+
     void set_read_iterators_and_sample_indices(const ReadMap& reads);
+    bool requires_spilling(std::size_t num_likelihoods) const noexcept;
+    boost::filesystem::path make_spill_file_path() const;
+    void reset_row_views(std::size_t sample_idx) noexcept;
+    void evaluate_rows(const std::vector<HaplotypeRef>& haplotypes,
+                       const std::vector<std::size_t>& rows,
+                       const std::vector<std::size_t>& seeded_rows,
+                       const boost::optional<FlankState>& flank_state);
 };
 
 template <typename S, typename Container>
 void HaplotypeLikelihoodCache::insert(S&& sample, const Haplotype& haplotype,
                                       Container&& likelihoods)
 {
-    sample_indices_.emplace(std::forward<S>(sample), sample_indices_.size());
-    cache_[haplotype].emplace_back(std::forward<Container>(likelihoods));
+    const auto sample_idx = sample_indices_.emplace(std::forward<S>(sample), sample_indices_.size()).first->second;
+    if (sample_idx >= likelihood_matrices_.size()) {
+        likelihood_matrices_.resize(sample_idx + 1);
+        likelihood_rows_.resize(sample_idx + 1);
+    }
+    const auto row = haplotype_indices_.emplace(haplotype, haplotype_indices_.size()).first->second;
+    auto& matrix = likelihood_matrices_[sample_idx];
+    auto& rows = likelihood_rows_[sample_idx];
+    if (row >= rows.size()) {
+        rows.resize(row + 1);
+    }
+    const auto num_likelihoods = static_cast<std::size_t>(std::distance(std::cbegin(likelihoods), std::cend(likelihoods)));
+    matrix.append(std::cbegin(likelihoods), std::cend(likelihoods));
+    rows[row] = LikelihoodVector {nullptr, num_likelihoods};
+    reset_row_views(sample_idx); // appending may have reallocated the matrix
 }
 
 template <typename Container>
 void HaplotypeLikelihoodCache::erase(const Container& haplotypes)
 {
+    // Only the rows' index entries are removed; their storage is reclaimed by
+    // the next populate
     for (const auto& haplotype : haplotypes) {
-        cache_.erase(haplotype);
+        haplotype_indices_.erase(haplotype);
     }
 }
 
@@ -0,0 +1,223 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "haplotype_likelihood_checkpoint.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+
+#include <boost/functional/hash.hpp>
+
+#include "basics/aligned_read.hpp"
+
+namespace octopus {
+
+namespace {
+
+// All integers are stored fixed-width; doubles and strings are stored raw.
+// The format is host endian - checkpoints are scratch files for re-calling on
+// the machine that wrote them, not an interchange format.
+constexpr char checkpointMagic[] {"OCTLHC02"};
+constexpr std::size_t magicSize {sizeof(checkpointMagic) - 1};
+
+void write_uint(std::ostream& out, const std::uint64_t value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::uint64_t read_uint(std::istream& in)
+{
+    std::uint64_t result {0};
+    in.read(reinterpret_cast<char*>(&result), sizeof(result));
+    return result;
+}
+
+void write_string(std::ostream& out, const std::string& str)
+{
+    write_uint(out, str.size());
+    out.write(str.data(), str.size());
+}
+
+std::string read_string(std::istream& in)
+{
+    std::string result(read_uint(in), '\0');
+    in.read(&result[0], result.size());
+    return result;
+}
+
+auto fingerprint(const std::vector<Haplotype>& haplotypes)
+{
+    auto result = haplotypes.size();
+    for (const auto& haplotype : haplotypes) {
+        boost::hash_combine(result, haplotype.get_hash());
+    }
+    return result;
+}
+
+auto fingerprint(const ReadMap::mapped_type& reads)
+{
+    auto result = reads.size();
+    for (const auto& read : reads) {
+        boost::hash_combine(result, ReadHash {}(read));
+    }
+    return result;
+}
+
+auto fingerprint(const boost::optional<HaplotypeLikelihoodCache::FlankState>& flank_state)
+{
+    std::size_t result {0};
+    if (flank_state) {
+        result = 1;
+        boost::hash_combine(result, flank_state->lhs_flank);
+        boost::hash_combine(result, flank_state->rhs_flank);
+    }
+    return result;
+}
+
+auto make_region_key(const GenomicRegion& region)
+{
+    return region.contig_name() + ':' + std::to_string(region.begin()) + '-' + std::to_string(region.end());
+}
+
+} // namespace
+
+HaplotypeLikelihoodCheckpoint::HaplotypeLikelihoodCheckpoint(Path file, const Mode mode)
+: file_ {std::move(file)}
+, mode_ {mode}
+, index_ {}
+, out_ {}
+, mutex_ {}
+{
+    if (mode_ == Mode::record) {
+        out_.open(file_.string(), std::ios::binary | std::ios::trunc);
+        if (!out_) {
+            throw std::runtime_error {"HaplotypeLikelihoodCheckpoint: could not open " + file_.string() + " for writing"};
+        }
+        out_.write(checkpointMagic, magicSize);
+    } else {
+        build_index();
+    }
+}
+
+HaplotypeLikelihoodCheckpoint::Mode HaplotypeLikelihoodCheckpoint::mode() const noexcept
+{
+    return mode_;
+}
+
+void HaplotypeLikelihoodCheckpoint::save(const GenomicRegion& region, const std::vector<Haplotype>& haplotypes,
+                                         const ReadMap& reads, const boost::optional<FlankState>& flank_state,
+                                         const HaplotypeLikelihoodCache& cache)
+{
+    if (mode_ != Mode::record) return;
+    std::lock_guard<std::mutex> lock {mutex_};
+    write_string(out_, region.contig_name());
+    write_uint(out_, region.begin());
+    write_uint(out_, region.end());
+    write_uint(out_, fingerprint(haplotypes));
+    write_uint(out_, fingerprint(flank_state));
+    write_uint(out_, haplotypes.size());
+    write_uint(out_, reads.size());
+    for (const auto& p : reads) {
+        write_string(out_, p.first);
+        write_uint(out_, fingerprint(p.second));
+        write_uint(out_, p.second.size());
+        for (const auto& haplotype : haplotypes) {
+            const auto& likelihoods = cache(p.first, haplotype);
+            out_.write(reinterpret_cast<const char*>(likelihoods.data()), likelihoods.size() * sizeof(double));
+        }
+    }
+    out_.flush();
+}
+
+bool HaplotypeLikelihoodCheckpoint::load(const GenomicRegion& region, const std::vector<Haplotype>& haplotypes,
+                                         const ReadMap& reads, const boost::optional<FlankState>& flank_state,
+                                         HaplotypeLikelihoodCache& cache) const
+{
+    if (mode_ != Mode::replay) return false;
+    const auto candidates = index_.equal_range(make_region_key(region));
+    const auto haplotypes_fingerprint = fingerprint(haplotypes);
+    const auto flank_fingerprint = fingerprint(flank_state);
+    std::vector<std::pair<SampleName, std::size_t>> sample_fingerprints {};
+    sample_fingerprints.reserve(reads.size());
+    for (const auto& p : reads) {
+        sample_fingerprints.emplace_back(p.first, fingerprint(p.second));
+    }
+    // Samples match individually, so a record written with more samples - e.g.
+    // by a joint run covering this run's subject - can still serve a replay
+    const auto record_itr = std::find_if(candidates.first, candidates.second, [&] (const auto& p) {
+        if (p.second.haplotypes_fingerprint != haplotypes_fingerprint
+            || p.second.flank_fingerprint != flank_fingerprint) return false;
+        return std::all_of(std::cbegin(sample_fingerprints), std::cend(sample_fingerprints), [&] (const auto& s) {
+            const auto sample_itr = p.second.samples.find(s.first);
+            return sample_itr != std::cend(p.second.samples) && sample_itr->second.reads_fingerprint == s.second;
+        });
+    });
+    if (record_itr == candidates.second) return false;
+    std::ifstream in {file_.string(), std::ios::binary};
+    // The requested samples are buffered before touching the cache so a
+    // truncated file cannot leave it half filled
+    std::vector<std::pair<SampleName, std::vector<double>>> samples {};
+    samples.reserve(reads.size());
+    for (const auto& p : reads) {
+        const auto& sample_record = record_itr->second.samples.at(p.first);
+        in.seekg(sample_record.payload_offset);
+        samples.emplace_back(p.first, std::vector<double>(haplotypes.size() * sample_record.num_reads));
+        in.read(reinterpret_cast<char*>(samples.back().second.data()), samples.back().second.size() * sizeof(double));
+    }
+    if (!in) return false;
+    cache.clear();
+    for (auto& sample : samples) {
+        const auto num_reads = sample.second.size() / haplotypes.size();
+        std::vector<double> row(num_reads);
+        for (std::size_t i {0}; i < haplotypes.size(); ++i) {
+            const auto first = std::next(std::cbegin(sample.second), i * num_reads);
+            row.assign(first, std::next(first, num_reads));
+            cache.insert(sample.first, haplotypes[i], row);
+        }
+    }
+    return true;
+}
+
+// private methods
+
+void HaplotypeLikelihoodCheckpoint::build_index()
+{
+    std::ifstream in {file_.string(), std::ios::binary};
+    if (!in) {
+        throw std::runtime_error {"HaplotypeLikelihoodCheckpoint: could not open " + file_.string() + " for reading"};
+    }
+    std::string magic(magicSize, '\0');
+    in.read(&magic[0], magicSize);
+    if (!in || magic != checkpointMagic) {
+        throw std::runtime_error {"HaplotypeLikelihoodCheckpoint: " + file_.string() + " is not a likelihood checkpoint"};
+    }
+    while (in.peek() != std::ifstream::traits_type::eof()) {
+        const auto contig = read_string(in);
+        const auto begin = read_uint(in);
+        const auto end = read_uint(in);
+        Record record {};
+        record.haplotypes_fingerprint = read_uint(in);
+        record.flank_fingerprint = read_uint(in);
+        const auto num_haplotypes = read_uint(in);
+        const auto num_samples = read_uint(in);
+        record.samples.reserve(num_samples);
+        for (std::uint64_t s {0}; s < num_samples; ++s) {
+            auto sample = read_string(in);
+            SampleRecord sample_record {};
+            sample_record.reads_fingerprint = read_uint(in);
+            sample_record.num_reads = read_uint(in);
+            sample_record.payload_offset = static_cast<std::streamoff>(in.tellg());
+            in.seekg(num_haplotypes * sample_record.num_reads * sizeof(double), std::ios::cur);
+            record.samples.emplace(std::move(sample), sample_record);
+        }
+        if (!in) {
+            throw std::runtime_error {"HaplotypeLikelihoodCheckpoint: " + file_.string() + " is truncated"};
+        }
+        index_.emplace(contig + ':' + std::to_string(begin) + '-' + std::to_string(end), std::move(record));
+    }
+}
+
+} // namespace octopus
@@ -0,0 +1,98 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef haplotype_likelihood_checkpoint_hpp
+#define haplotype_likelihood_checkpoint_hpp
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "core/types/haplotype.hpp"
+#include "haplotype_likelihood_cache.hpp"
+
+namespace octopus {
+
+/*
+    HaplotypeLikelihoodCheckpoint persists HaplotypeLikelihoodCache contents
+    per active region to a binary sidecar file, so re-calling runs that only
+    change downstream parameters (priors, filters) can replay HMM scores
+    instead of recomputing them.
+
+    Records are fingerprinted on the haplotypes, per-sample reads, and flank
+    state that produced them; replay only succeeds when every fingerprint
+    matches the current evaluation request, and callers fall back to normal
+    evaluation otherwise. Samples match individually, so a record written by a
+    run with more samples - e.g. a trio run covering a subject later re-called
+    individually - serves any run over a subset of them, provided the
+    haplotype set is the same. A region may have several records as haplotype
+    generation revisits it with different haplotype sets.
+*/
+class HaplotypeLikelihoodCheckpoint
+{
+public:
+    enum class Mode { record, replay };
+
+    using Path       = boost::filesystem::path;
+    using FlankState = HaplotypeLikelihoodCache::FlankState;
+
+    HaplotypeLikelihoodCheckpoint() = delete;
+
+    // Throws std::runtime_error if the file cannot be opened, or - in replay
+    // mode - is not a checkpoint file
+    HaplotypeLikelihoodCheckpoint(Path file, Mode mode);
+
+    HaplotypeLikelihoodCheckpoint(const HaplotypeLikelihoodCheckpoint&)            = delete;
+    HaplotypeLikelihoodCheckpoint& operator=(const HaplotypeLikelihoodCheckpoint&) = delete;
+    HaplotypeLikelihoodCheckpoint(HaplotypeLikelihoodCheckpoint&&)                 = delete;
+    HaplotypeLikelihoodCheckpoint& operator=(HaplotypeLikelihoodCheckpoint&&)      = delete;
+
+    ~HaplotypeLikelihoodCheckpoint() = default;
+
+    Mode mode() const noexcept;
+
+    // Appends a record for the given evaluation; thread safe
+    void save(const GenomicRegion& region, const std::vector<Haplotype>& haplotypes,
+              const ReadMap& reads, const boost::optional<FlankState>& flank_state,
+              const HaplotypeLikelihoodCache& cache);
+
+    // Fills the cache from a record matching the given evaluation, returning
+    // false - and leaving the cache untouched - if there is none; thread safe
+    bool load(const GenomicRegion& region, const std::vector<Haplotype>& haplotypes,
+              const ReadMap& reads, const boost::optional<FlankState>& flank_state,
+              HaplotypeLikelihoodCache& cache) const;
+
+private:
+    struct SampleRecord
+    {
+        std::size_t reads_fingerprint;
+        std::uint64_t num_reads;
+        std::streamoff payload_offset;
+    };
+    struct Record
+    {
+        std::size_t haplotypes_fingerprint, flank_fingerprint;
+        std::unordered_map<SampleName, SampleRecord> samples;
+    };
+
+    Path file_;
+    Mode mode_;
+    std::unordered_multimap<std::string, Record> index_;
+    std::ofstream out_;
+    mutable std::mutex mutex_;
+
+    void build_index();
+};
+
+} // namespace octopus
+
+#endif
@@ -11,6 +11,7 @@
 #include "core/models/error/error_model_factory.hpp"
 #include "concepts/mappable.hpp"
 #include "utils/maths.hpp"
+#include "utils/kmer_mapper.hpp"
 
 namespace octopus {
 
@@ -39,9 +40,41 @@ unsigned HaplotypeLikelihoodModel::pad_requirement() noexcept
     return hmm::min_flank_pad();
 }
 
+namespace {
+
+// Reads containing a candidate indel only stay on the banded SIMD path if the
+// band can absorb the coordinate shift the indel induces, so pick the band from
+// the haplotype's net indel size - the widest kernel the host offers caps it
+auto calculate_flank_pad(const Haplotype& haplotype) noexcept
+{
+    const auto ref_span = static_cast<std::size_t>(region_size(haplotype));
+    const auto seq_size = sequence_size(haplotype);
+    const auto net_indel_size = seq_size >= ref_span ? seq_size - ref_span : ref_span - seq_size;
+    auto result = hmm::min_flank_pad();
+    const auto max_pad = hmm::max_flank_pad();
+    while (result < net_indel_size + 2 && 2 * result <= max_pad) {
+        result *= 2;
+    }
+    return result;
+}
+
+} // namespace
+
 void HaplotypeLikelihoodModel::reset(const Haplotype& haplotype, boost::optional<FlankState> flank_state)
 {
+    // The error model penalties are a pure function of the haplotype, so when
+    // an equal haplotype is already buffered only the flank state needs
+    // refreshing - read assignment and realignment reset to the same few
+    // haplotypes over and over along a phase block
+    if (buffered_haplotype_region_
+        && *buffered_haplotype_region_ == mapped_region(haplotype)
+        && buffered_haplotype_sequence_ == haplotype.sequence()) {
+        haplotype_ = std::addressof(haplotype);
+        haplotype_flank_state_ = std::move(flank_state);
+        return;
+    }
     haplotype_ = std::addressof(haplotype);
+    haplotype_flank_pad_ = calculate_flank_pad(haplotype);
     haplotype_flank_state_ = std::move(flank_state);
     if (snv_error_model_) {
         snv_error_model_->evaluate(haplotype,
@@ -57,6 +90,8 @@ void HaplotypeLikelihoodModel::reset(const Haplotype& haplotype, boost::optional
     if (indel_error_model_) {
         haplotype_gap_extension_penalty_ = indel_error_model_->evaluate(haplotype, haplotype_gap_open_penalities_);
     }
+    buffered_haplotype_region_ = mapped_region(haplotype);
+    buffered_haplotype_sequence_ = haplotype.sequence();
 }
 
 void HaplotypeLikelihoodModel::clear() noexcept
@@ -65,6 +100,18 @@ void HaplotypeLikelihoodModel::clear() noexcept
     haplotype_flank_state_ = boost::none;
 }
 
+void HaplotypeLikelihoodModel::set_alignment_memo(AlignmentMemo& memo, const std::size_t read_offset) noexcept
+{
+    alignment_memo_ = std::addressof(memo);
+    alignment_memo_read_offset_ = read_offset;
+}
+
+void HaplotypeLikelihoodModel::unset_alignment_memo() noexcept
+{
+    alignment_memo_ = nullptr;
+    alignment_memo_read_offset_ = 0;
+}
+
 HaplotypeLikelihoodModel::HaplotypeLikelihoodModel()
 : HaplotypeLikelihoodModel {make_snv_error_model(), make_indel_error_model(), Config {}} {}
 
@@ -111,7 +158,12 @@ HaplotypeLikelihoodModel::HaplotypeLikelihoodModel(const HaplotypeLikelihoodMode
     haplotype_snv_reverse_priors_ = other.haplotype_snv_reverse_priors_;
     haplotype_gap_open_penalities_ = other.haplotype_gap_open_penalities_;
     haplotype_gap_extension_penalty_ = other.haplotype_gap_extension_penalty_;
+    buffered_haplotype_region_ = other.buffered_haplotype_region_;
+    buffered_haplotype_sequence_ = other.buffered_haplotype_sequence_;
+    haplotype_flank_pad_ = other.haplotype_flank_pad_;
     config_ = other.config_;
+    alignment_memo_ = other.alignment_memo_;
+    alignment_memo_read_offset_ = other.alignment_memo_read_offset_;
 }
 
 HaplotypeLikelihoodModel& HaplotypeLikelihoodModel::operator=(const HaplotypeLikelihoodModel& other)
@@ -136,7 +188,12 @@ void swap(HaplotypeLikelihoodModel& lhs, HaplotypeLikelihoodModel& rhs) noexcept
     swap(lhs.haplotype_snv_reverse_priors_, rhs.haplotype_snv_reverse_priors_);
     swap(lhs.haplotype_gap_open_penalities_, rhs.haplotype_gap_open_penalities_);
     swap(lhs.haplotype_gap_extension_penalty_, rhs.haplotype_gap_extension_penalty_);
+    swap(lhs.buffered_haplotype_region_, rhs.buffered_haplotype_region_);
+    swap(lhs.buffered_haplotype_sequence_, rhs.buffered_haplotype_sequence_);
+    swap(lhs.haplotype_flank_pad_, rhs.haplotype_flank_pad_);
     swap(lhs.config_, rhs.config_);
+    swap(lhs.alignment_memo_, rhs.alignment_memo_);
+    swap(lhs.alignment_memo_read_offset_, rhs.alignment_memo_read_offset_);
 }
 
 bool HaplotypeLikelihoodModel::can_use_flank_state() const noexcept
@@ -158,12 +215,13 @@ double HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
 
 namespace {
 
-int num_out_of_range_bases(const std::size_t mapping_position, const AlignedRead& read, const Haplotype& haplotype) noexcept
+int num_out_of_range_bases(const std::size_t mapping_position, const AlignedRead& read, const Haplotype& haplotype,
+                           const unsigned flank_pad) noexcept
 {
-    if (mapping_position < hmm::min_flank_pad()) {
-        return hmm::min_flank_pad() - mapping_position;
+    if (mapping_position < flank_pad) {
+        return flank_pad - mapping_position;
     }
-    const auto mapping_end = mapping_position + sequence_size(read) + hmm::min_flank_pad();
+    const auto mapping_end = mapping_position + sequence_size(read) + flank_pad;
     if (mapping_end > sequence_size(haplotype)) {
         return static_cast<int>(sequence_size(haplotype)) - static_cast<int>(mapping_end);
     } else {
@@ -171,9 +229,147 @@ int num_out_of_range_bases(const std::size_t mapping_position, const AlignedRead
     }
 }
 
-bool is_in_range(const std::size_t mapping_position, const AlignedRead& read, const Haplotype& haplotype) noexcept
+bool is_in_range(const std::size_t mapping_position, const AlignedRead& read, const Haplotype& haplotype,
+                 const unsigned flank_pad) noexcept
+{
+    return num_out_of_range_bases(mapping_position, read, haplotype, flank_pad) == 0;
+}
+
+// An alignment score is a pure function of the windows of the truth sequence
+// and penalty arrays the HMM reads, where the flanks cut that window, and a few
+// scalars; serialising them gives a key shared by every haplotype that looks
+// identical around the read's mapping position. An empty key means the window
+// is not memoisable.
+std::string make_alignment_memo_key(const std::string& truth, const std::string& target,
+                                    const std::size_t target_offset, const hmm::MutationModel& model)
 {
-    return num_out_of_range_bases(mapping_position, read, haplotype) == 0;
+    const auto pad = static_cast<int>(model.flank_pad);
+    const auto truth_size = static_cast<int>(truth.size());
+    const auto target_size = static_cast<int>(target.size());
+    const auto window_size = target_size + 2 * pad - 1;
+    const auto window_offset = std::max(0, static_cast<int>(target_offset) - pad);
+    if (window_offset + window_size > truth_size) {
+        return {}; // the window runs off the haplotype
+    }
+    // The flanks only matter through where they cut the window
+    auto lhs_flank = static_cast<int>(model.lhs_flank_size) - window_offset;
+    lhs_flank = std::max(std::min(lhs_flank, window_size), 0);
+    auto rhs_flank = static_cast<int>(model.rhs_flank_size) - (truth_size - (window_offset + window_size));
+    rhs_flank = std::max(std::min(rhs_flank, window_size), 0);
+    std::string result {};
+    result.reserve(4 * window_size + 9);
+    result.append(truth, window_offset, window_size);
+    result.append(std::next(std::cbegin(model.snv_mask), window_offset),
+                  std::next(std::cbegin(model.snv_mask), window_offset + window_size));
+    result.append(std::next(std::cbegin(model.snv_priors), window_offset),
+                  std::next(std::cbegin(model.snv_priors), window_offset + window_size));
+    result.append(std::next(std::cbegin(model.gap_open), window_offset),
+                  std::next(std::cbegin(model.gap_open), window_offset + window_size));
+    result.push_back(static_cast<char>(target_offset - window_offset)); // where the target sits in the window
+    result.push_back(static_cast<char>(model.gap_extend));
+    result.push_back(static_cast<char>(model.gap_extend >> 8));
+    result.push_back(static_cast<char>(model.nuc_prior));
+    result.push_back(static_cast<char>(model.nuc_prior >> 8));
+    result.push_back(static_cast<char>(lhs_flank));
+    result.push_back(static_cast<char>(lhs_flank >> 8));
+    result.push_back(static_cast<char>(rhs_flank));
+    result.push_back(static_cast<char>(rhs_flank >> 8));
+    return result;
+}
+
+// Long-read support: targets much longer than the alignment band accumulate
+// more indel drift than the band can absorb, so aligning them in one banded
+// pass truncates likelihoods and pushes the band (and so the kernel width) up.
+// Long targets are instead aligned in chunks: each chunk after the first is
+// re-anchored against the haplotype by kmer mapping around where the previous
+// chunks left off, aligned in its own narrow band, and the chunk
+// log likelihoods summed. Alignments straddling a chunk boundary are scored as
+// two independent pieces, a small accuracy cost for linear time in read length
+constexpr std::size_t maxUnchunkedTargetLength {1'500};
+constexpr std::size_t targetChunkLength {1'000};
+constexpr unsigned char chunkAnchorKmerSize {6};
+
+double evaluate_chunked(const AlignedRead& read, const Haplotype& haplotype,
+                        const std::size_t mapping_position, const hmm::MutationModel& model,
+                        const double min_ln_probability)
+{
+    const auto& target = read.sequence();
+    const auto& target_qualities = read.base_qualities();
+    const auto& truth = haplotype.sequence();
+    const auto num_chunks = (target.size() + targetChunkLength - 1) / targetChunkLength;
+    const auto pad = static_cast<long>(model.flank_pad);
+    thread_local std::string chunk_sequence {};
+    thread_local std::vector<std::uint8_t> chunk_qualities {};
+    double result {0};
+    long drift {0}; // net indel shift carried over from already-aligned chunks
+    for (std::size_t i {0}; i < num_chunks; ++i) {
+        const auto chunk_begin = i * target.size() / num_chunks;
+        const auto chunk_end = (i + 1) * target.size() / num_chunks;
+        const auto chunk_size = chunk_end - chunk_begin;
+        chunk_sequence.assign(target, chunk_begin, chunk_size);
+        chunk_qualities.assign(std::next(std::cbegin(target_qualities), chunk_begin),
+                               std::next(std::cbegin(target_qualities), chunk_end));
+        auto expected_offset = static_cast<long>(mapping_position + chunk_begin) + drift;
+        if (i > 0) {
+            // Re-anchor by seeding the chunk against a haplotype window around
+            // the expected offset, so drift does not have to fit in the band
+            const auto window_pad = 4 * pad;
+            const auto window_begin = std::max(long {0}, expected_offset - window_pad);
+            const auto window_size = std::min(static_cast<long>(truth.size()) - window_begin,
+                                              static_cast<long>(chunk_size) + 2 * window_pad);
+            if (window_size >= static_cast<long>(chunk_size)) {
+                auto& seed_table = thread_local_kmer_hash_table<chunkAnchorKmerSize>();
+                populate_kmer_hash_table<chunkAnchorKmerSize>(truth.substr(window_begin, window_size), seed_table);
+                auto seed_counts = init_mapping_counts(seed_table);
+                const auto seeds = map_query_to_target(compute_kmer_hashes<chunkAnchorKmerSize>(chunk_sequence),
+                                                       seed_table, seed_counts);
+                if (!seeds.empty()) {
+                    const auto anchored_offset = window_begin + static_cast<long>(seeds.front());
+                    drift += anchored_offset - expected_offset;
+                    expected_offset = anchored_offset;
+                }
+            }
+        }
+        // The chunk and its band must stay on the haplotype
+        const auto max_offset = static_cast<long>(truth.size()) - static_cast<long>(chunk_size) - pad;
+        if (max_offset < pad) return min_ln_probability;
+        const auto offset = std::max(pad, std::min(expected_offset, max_offset));
+        const auto chunk_floor = min_ln_probability == std::numeric_limits<double>::lowest()
+                                 ? min_ln_probability : min_ln_probability - result;
+        result += hmm::evaluate(chunk_sequence, truth, chunk_qualities,
+                                static_cast<std::size_t>(offset), model, chunk_floor);
+        if (result <= min_ln_probability) return min_ln_probability;
+    }
+    return result;
+}
+
+double evaluate_memoised(const AlignedRead& read, const Haplotype& haplotype,
+                         const std::size_t mapping_position, const hmm::MutationModel& model,
+                         const double min_ln_probability,
+                         HaplotypeLikelihoodModel::AlignmentMemo* memo, const std::size_t memo_read_idx)
+{
+    if (read.sequence().size() > maxUnchunkedTargetLength) {
+        // Not memoised: long-read windows would dominate the memo's budget and
+        // rarely repeat exactly
+        return evaluate_chunked(read, haplotype, mapping_position, model, min_ln_probability);
+    }
+    if (memo) {
+        auto window = make_alignment_memo_key(haplotype.sequence(), read.sequence(), mapping_position, model);
+        if (!window.empty()) {
+            const auto* hit = memo->find(memo_read_idx, window);
+            // A memoised score equal to its floor may have been truncated, so it
+            // can only be reused under an equal or higher floor
+            if (hit && (hit->value > hit->floor || hit->floor <= min_ln_probability)) {
+                return std::max(hit->value, min_ln_probability);
+            }
+            const auto result = hmm::evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(),
+                                              mapping_position, model, min_ln_probability);
+            memo->store(memo_read_idx, std::move(window), {result, min_ln_probability});
+            return result;
+        }
+    }
+    return hmm::evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(),
+                         mapping_position, model, min_ln_probability);
 }
 
 } // namespace
@@ -181,7 +377,10 @@ bool is_in_range(const std::size_t mapping_position, const AlignedRead& read, co
 template <typename InputIt>
 double max_score(const AlignedRead& read, const Haplotype& haplotype,
                  InputIt first_mapping_position, InputIt last_mapping_position,
-                 const hmm::MutationModel& model)
+                 const hmm::MutationModel& model,
+                 const double min_ln_probability = std::numeric_limits<double>::lowest(),
+                 HaplotypeLikelihoodModel::AlignmentMemo* memo = nullptr,
+                 const std::size_t memo_read_idx = 0)
 {
     assert(contains(haplotype, read));
     using PositionType = typename std::iterator_traits<InputIt>::value_type;
@@ -192,24 +391,28 @@ double max_score(const AlignedRead& read, const Haplotype& haplotype,
         if (position == original_mapping_position) {
             is_original_position_mapped = true;
         }
-        if (is_in_range(position, read, haplotype)) {
+        if (is_in_range(position, read, haplotype, model.flank_pad)) {
             has_in_range_mapping_position = true;
-            auto p = hmm::evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(), position, model);
+            // The running maximum also floors later alignments; anything below it is discarded anyway
+            auto p = evaluate_memoised(read, haplotype, position, model,
+                                       std::max(min_ln_probability, max_log_probability),
+                                       memo, memo_read_idx);
             max_log_probability = std::max(p, max_log_probability);
         }
     });
-    if (!is_original_position_mapped && is_in_range(original_mapping_position, read, haplotype)) {
+    if (!is_original_position_mapped && is_in_range(original_mapping_position, read, haplotype, model.flank_pad)) {
         has_in_range_mapping_position = true;
-        auto p = hmm::evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(),
-                               original_mapping_position, model);
+        auto p = evaluate_memoised(read, haplotype, original_mapping_position, model,
+                                   std::max(min_ln_probability, max_log_probability),
+                                   memo, memo_read_idx);
         max_log_probability = std::max(p, max_log_probability);
     }
     if (!has_in_range_mapping_position) {
-        const auto min_shift = num_out_of_range_bases(original_mapping_position, read, haplotype);
+        const auto min_shift = num_out_of_range_bases(original_mapping_position, read, haplotype, model.flank_pad);
         auto final_mapping_position = original_mapping_position;
         if (min_shift > 0) {
             final_mapping_position += min_shift;
-            if (!is_in_range(final_mapping_position, read, haplotype)) {
+            if (!is_in_range(final_mapping_position, read, haplotype, model.flank_pad)) {
                 throw HaplotypeLikelihoodModel::ShortHaplotypeError {haplotype, static_cast<unsigned>(min_shift)};
             }
         } else {
@@ -221,35 +424,52 @@ double max_score(const AlignedRead& read, const Haplotype& haplotype,
                 throw HaplotypeLikelihoodModel::ShortHaplotypeError {haplotype, required_extension};
             }
         }
-        max_log_probability = hmm::evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(),
-                                            final_mapping_position, model);
+        max_log_probability = evaluate_memoised(read, haplotype, final_mapping_position, model,
+                                                min_ln_probability, memo, memo_read_idx);
     }
     assert(max_log_probability > std::numeric_limits<double>::lowest() && max_log_probability <= 0);
     return max_log_probability;
 }
 
-double HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
-                                          MappingPositionItr first_mapping_position,
-                                          MappingPositionItr last_mapping_position) const
+hmm::MutationModel HaplotypeLikelihoodModel::make_hmm_model(const bool is_forward_strand) const noexcept
 {
-    if (haplotype_ == nullptr) {
-        throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
-    }
-    const auto is_forward = !read.is_marked_reverse_mapped();
-    hmm::MutationModel model {
-        is_forward ? haplotype_snv_forward_mask_ : haplotype_snv_reverse_mask_,
-        is_forward ? haplotype_snv_forward_priors_ : haplotype_snv_reverse_priors_,
+    hmm::MutationModel result {
+        is_forward_strand ? haplotype_snv_forward_mask_ : haplotype_snv_reverse_mask_,
+        is_forward_strand ? haplotype_snv_forward_priors_ : haplotype_snv_reverse_priors_,
         haplotype_gap_open_penalities_,
         haplotype_gap_extension_penalty_
     };
+    result.flank_pad = haplotype_flank_pad_;
     if (haplotype_flank_state_) {
-        model.lhs_flank_size = haplotype_flank_state_->lhs_flank;
-        model.rhs_flank_size = haplotype_flank_state_->rhs_flank;
+        result.lhs_flank_size = haplotype_flank_state_->lhs_flank;
+        result.rhs_flank_size = haplotype_flank_state_->rhs_flank;
     } else {
-        model.lhs_flank_size = 0;
-        model.rhs_flank_size = 0;
+        result.lhs_flank_size = 0;
+        result.rhs_flank_size = 0;
     }
-    const auto ln_prob_given_mapped = max_score(read, *haplotype_, first_mapping_position, last_mapping_position, model);
+    return result;
+}
+
+double HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
+                                          MappingPositionItr first_mapping_position,
+                                          MappingPositionItr last_mapping_position) const
+{
+    if (haplotype_ == nullptr) {
+        throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
+    }
+    return this->evaluate(read, first_mapping_position, last_mapping_position,
+                          make_hmm_model(!read.is_marked_reverse_mapped()));
+}
+
+double HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
+                                          MappingPositionItr first_mapping_position,
+                                          MappingPositionItr last_mapping_position,
+                                          const hmm::MutationModel& model,
+                                          const double min_ln_likelihood,
+                                          AlignmentMemo* memo, const std::size_t memo_read_idx) const
+{
+    const auto ln_prob_given_mapped = max_score(read, *haplotype_, first_mapping_position, last_mapping_position,
+                                                model, min_ln_likelihood, memo, memo_read_idx);
     if (config_.use_mapping_quality) {
         // This calculation is approximately
         // p(read | hap) = p(read missmapped) p(read | hap, missmapped)
@@ -261,9 +481,8 @@ double HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
         if (config_.mapping_quality_cap_trigger && mapping_quality >= *config_.mapping_quality_cap_trigger) {
             mapping_quality = config_.mapping_quality_cap;
         }
-        using octopus::maths::constants::ln10Div10;
-        const auto ln_prob_missmapped = -ln10Div10<> * mapping_quality;
-        const auto ln_prob_mapped = std::log(1.0 - std::exp(ln_prob_missmapped));
+        const auto ln_prob_missmapped = maths::phred_to_ln_error_probability(mapping_quality);
+        const auto ln_prob_mapped = std::log1p(-maths::phred_to_error_probability(mapping_quality));
         const auto result = maths::log_sum_exp(ln_prob_mapped + ln_prob_given_mapped, ln_prob_missmapped);
         return result > -1e-15 ? 0.0 : result;
     } else {
@@ -300,7 +519,7 @@ compute_optimal_alignment(const AlignedRead& read, const Haplotype& haplotype,
         if (position == original_mapping_position) {
             is_original_position_mapped = true;
         }
-        if (is_in_range(position, read, haplotype)) {
+        if (is_in_range(position, read, haplotype, model.flank_pad)) {
             has_in_range_mapping_position = true;
             auto alignment = hmm::align(read.sequence(), haplotype.sequence(), read.base_qualities(), position, model);
             if (alignment.likelihood > result.likelihood) {
@@ -310,7 +529,7 @@ compute_optimal_alignment(const AlignedRead& read, const Haplotype& haplotype,
             }
         }
     });
-    if (!is_original_position_mapped && is_in_range(original_mapping_position, read, haplotype)) {
+    if (!is_original_position_mapped && is_in_range(original_mapping_position, read, haplotype, model.flank_pad)) {
         has_in_range_mapping_position = true;
         auto alignment = hmm::align(read.sequence(), haplotype.sequence(), read.base_qualities(),
                                     original_mapping_position, model);
@@ -321,11 +540,11 @@ compute_optimal_alignment(const AlignedRead& read, const Haplotype& haplotype,
         }
     }
     if (!has_in_range_mapping_position) {
-        const auto min_shift = num_out_of_range_bases(original_mapping_position, read, haplotype);
+        const auto min_shift = num_out_of_range_bases(original_mapping_position, read, haplotype, model.flank_pad);
         auto final_mapping_position = original_mapping_position;
         if (min_shift > 0) {
             final_mapping_position += min_shift;
-            if (!is_in_range(final_mapping_position, read, haplotype)) {
+            if (!is_in_range(final_mapping_position, read, haplotype, model.flank_pad)) {
                 throw HaplotypeLikelihoodModel::ShortHaplotypeError {haplotype, static_cast<unsigned>(min_shift)};
             }
         } else {
@@ -353,26 +572,15 @@ HaplotypeLikelihoodModel::align(const AlignedRead& read, MappingPositionItr firs
     if (haplotype_ == nullptr) {
         throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
     }
-    const auto is_forward = !read.is_marked_reverse_mapped();
-    hmm::MutationModel model {is_forward ? haplotype_snv_forward_mask_ : haplotype_snv_reverse_mask_,
-                              is_forward ? haplotype_snv_forward_priors_ : haplotype_snv_reverse_priors_,
-                              haplotype_gap_open_penalities_, haplotype_gap_extension_penalty_};
-    if (haplotype_flank_state_) {
-        model.lhs_flank_size = haplotype_flank_state_->lhs_flank;
-        model.rhs_flank_size = haplotype_flank_state_->rhs_flank;
-    } else {
-        model.lhs_flank_size = 0;
-        model.rhs_flank_size = 0;
-    }
+    const auto model = make_hmm_model(!read.is_marked_reverse_mapped());
     auto result = compute_optimal_alignment(read, *haplotype_, first_mapping_position, last_mapping_position, model);
     if (config_.use_mapping_quality) {
         auto mapping_quality = read.mapping_quality();
         if (config_.mapping_quality_cap_trigger && mapping_quality >= *config_.mapping_quality_cap_trigger) {
             mapping_quality = config_.mapping_quality_cap;
         }
-        using octopus::maths::constants::ln10Div10;
-        const auto ln_prob_missmapped = -ln10Div10<> * mapping_quality;
-        const auto ln_prob_mapped = std::log(1.0 - std::exp(ln_prob_missmapped));
+        const auto ln_prob_missmapped = maths::phred_to_ln_error_probability(mapping_quality);
+        const auto ln_prob_mapped = std::log1p(-maths::phred_to_error_probability(mapping_quality));
         result.likelihood = maths::log_sum_exp(ln_prob_mapped + result.likelihood, ln_prob_missmapped);
         result.likelihood = result.likelihood > -1e-15 ? 0.0 : result.likelihood;
     } else {
@@ -11,6 +11,10 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <limits>
 #include <stdexcept>
 
 #include <boost/optional.hpp>
@@ -47,7 +51,53 @@ public:
     };
     
     class ShortHaplotypeError;
-    
+
+    // Memoises read alignment scores keyed on the exact windows of haplotype
+    // sequence and penalties the HMM reads. Haplotypes extracted from one tree
+    // differ only at a few sites, so across a set most reads present the HMM
+    // with a window it has already aligned for an earlier haplotype.
+    class AlignmentMemo
+    {
+    public:
+        struct Score
+        {
+            double value, floor;
+        };
+
+        void prepare(const std::size_t num_reads)
+        {
+            memos_.clear();
+            memos_.resize(num_reads);
+            stored_bytes_ = 0;
+        }
+        void clear() noexcept
+        {
+            memos_.clear();
+            memos_.shrink_to_fit();
+            stored_bytes_ = 0;
+        }
+        Score* find(const std::size_t read_idx, const std::string& window)
+        {
+            auto& memo = memos_[read_idx];
+            const auto itr = memo.find(window);
+            return itr != std::end(memo) ? std::addressof(itr->second) : nullptr;
+        }
+        void store(const std::size_t read_idx, std::string window, const Score score)
+        {
+            // In the worst case - no sharing between haplotypes - every alignment
+            // would add an entry, so give up storing rather than grow unbounded
+            if (stored_bytes_ > maxStoredBytes) return;
+            stored_bytes_ += window.size() + sizeof(Score);
+            memos_[read_idx][std::move(window)] = score;
+        }
+
+    private:
+        static constexpr std::size_t maxStoredBytes {std::size_t {1} << 26};
+
+        std::vector<std::unordered_map<std::string, Score>> memos_;
+        std::size_t stored_bytes_ = 0;
+    };
+
     using MappingPosition       = std::size_t;
     using MappingPositionVector = std::vector<MappingPosition>;
     using MappingPositionItr    = MappingPositionVector::const_iterator;
@@ -81,14 +131,38 @@ public:
     bool can_use_flank_state() const noexcept;
     
     void reset(const Haplotype& haplotype, boost::optional<FlankState> flank_state = boost::none);
-    
+
     void clear() noexcept;
+
+    // Scores computed by the batch evaluate overloads are shared through the
+    // memo across haplotypes until unset; read i of a batch is identified to
+    // the memo as read_offset + i
+    void set_alignment_memo(AlignmentMemo& memo, std::size_t read_offset = 0) noexcept;
+    void unset_alignment_memo() noexcept;
     
     // ln p(read | haplotype, model)
     double evaluate(const AlignedRead& read) const;
     double evaluate(const AlignedRead& read, const MappingPositionVector& mapping_positions) const;
     double evaluate(const AlignedRead& read, MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position) const;
-    
+
+    // ln p(read | haplotype, model) for each read in [first, last)
+    //
+    // Evaluates a whole batch of reads against the buffered haplotype in one call,
+    // so the HMM model setup is paid once per batch rather than once per read.
+    // get_mapping_positions(i, read) is called with the batch index and read and
+    // must return the candidate mapping positions for that read as a
+    // (MappingPositionItr, MappingPositionItr) pair.
+    template <typename ReadItr, typename MappingPositionGetter, typename OutputItr>
+    OutputItr evaluate(ReadItr first, ReadItr last, MappingPositionGetter get_mapping_positions, OutputItr result) const;
+
+    // As above, but each read's likelihood may be truncated at the value
+    // returned by get_min_likelihood(i), which lets the HMM terminate
+    // alignments that are guaranteed to fall below it - for example ones that
+    // cannot approach the read's best likelihood against another haplotype.
+    template <typename ReadItr, typename MappingPositionGetter, typename MinLikelihoodGetter, typename OutputItr>
+    OutputItr evaluate(ReadItr first, ReadItr last, MappingPositionGetter get_mapping_positions,
+                       MinLikelihoodGetter get_min_likelihood, OutputItr result) const;
+
     Alignment align(const AlignedRead& read) const;
     Alignment align(const AlignedRead& read, const MappingPositionVector& mapping_positions) const;
     Alignment align(const AlignedRead& read, MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position) const;
@@ -106,9 +180,68 @@ private:
     
     std::vector<Penalty> haplotype_gap_open_penalities_;
     Penalty haplotype_gap_extension_penalty_;
+    // Identifies the haplotype the buffered penalties were computed for, held
+    // by value as haplotype_ may be left dangling between resets
+    boost::optional<GenomicRegion> buffered_haplotype_region_;
+    Haplotype::NucleotideSequence buffered_haplotype_sequence_;
+    unsigned haplotype_flank_pad_ = hmm::min_flank_pad();
     Config config_;
+    AlignmentMemo* alignment_memo_ = nullptr;
+    std::size_t alignment_memo_read_offset_ = 0;
+
+    hmm::MutationModel make_hmm_model(bool is_forward_strand) const noexcept;
+    double evaluate(const AlignedRead& read,
+                    MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position,
+                    const hmm::MutationModel& model,
+                    double min_ln_likelihood = std::numeric_limits<double>::lowest(),
+                    AlignmentMemo* memo = nullptr, std::size_t memo_read_idx = 0) const;
 };
 
+template <typename ReadItr, typename MappingPositionGetter, typename OutputItr>
+OutputItr HaplotypeLikelihoodModel::evaluate(ReadItr first, ReadItr last,
+                                             MappingPositionGetter get_mapping_positions,
+                                             OutputItr result) const
+{
+    if (haplotype_ == nullptr) {
+        throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
+    }
+    const auto forward_model = make_hmm_model(true);
+    const auto reverse_model = make_hmm_model(false);
+    std::size_t read_idx {0};
+    for (; first != last; ++first, ++read_idx) {
+        const AlignedRead& read {*first};
+        const auto mapping_positions = get_mapping_positions(read_idx, read);
+        *result++ = this->evaluate(read, mapping_positions.first, mapping_positions.second,
+                                   read.is_marked_reverse_mapped() ? reverse_model : forward_model,
+                                   std::numeric_limits<double>::lowest(),
+                                   alignment_memo_, alignment_memo_read_offset_ + read_idx);
+    }
+    return result;
+}
+
+template <typename ReadItr, typename MappingPositionGetter, typename MinLikelihoodGetter, typename OutputItr>
+OutputItr HaplotypeLikelihoodModel::evaluate(ReadItr first, ReadItr last,
+                                             MappingPositionGetter get_mapping_positions,
+                                             MinLikelihoodGetter get_min_likelihood,
+                                             OutputItr result) const
+{
+    if (haplotype_ == nullptr) {
+        throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
+    }
+    const auto forward_model = make_hmm_model(true);
+    const auto reverse_model = make_hmm_model(false);
+    std::size_t read_idx {0};
+    for (; first != last; ++first, ++read_idx) {
+        const AlignedRead& read {*first};
+        const auto mapping_positions = get_mapping_positions(read_idx, read);
+        *result++ = this->evaluate(read, mapping_positions.first, mapping_positions.second,
+                                   read.is_marked_reverse_mapped() ? reverse_model : forward_model,
+                                   get_min_likelihood(read_idx),
+                                   alignment_memo_, alignment_memo_read_offset_ + read_idx);
+    }
+    return result;
+}
+
 class HaplotypeLikelihoodModel::ShortHaplotypeError : public std::runtime_error
 {
 public:
@@ -39,7 +39,30 @@ CoalescentModel::CoalescentModel(Haplotype reference, Parameters params,
                                         std::forward_as_tuple(reference_),
                                         std::forward_as_tuple());
     }
-    k_indel_pos_result_cache_.reserve(2 * num_haplotyes_hint);
+}
+
+CoalescentModel::SitePatternResultCache::SitePatternResultCache(const std::size_t max_size)
+: max_size_ {max_size}
+{
+    results_.reserve(max_size_);
+}
+
+boost::optional<double> CoalescentModel::SitePatternResultCache::find(const SiteCountIndelTuple& pattern)
+{
+    const auto itr = results_.find(pattern);
+    if (itr == std::cend(results_)) return boost::none;
+    recency_.splice(std::cbegin(recency_), recency_, itr->second.recency);
+    return itr->second.result;
+}
+
+void CoalescentModel::SitePatternResultCache::insert(const SiteCountIndelTuple& pattern, const double result)
+{
+    if (results_.size() >= max_size_) {
+        results_.erase(recency_.back());
+        recency_.pop_back();
+    }
+    recency_.push_front(pattern);
+    results_.emplace(pattern, Entry {result, std::begin(recency_)});
 }
 
 void CoalescentModel::set_reference(Haplotype reference)
@@ -202,12 +225,11 @@ double CoalescentModel::evaluate(const unsigned k_snp, const unsigned k_indel, c
 {
     const auto indel_heterozygosity = calculate_buffered_indel_heterozygosity();
     const auto t = std::make_tuple(k_snp, k_indel, n, maths::round_sf(indel_heterozygosity, 6));
-    auto itr = k_indel_pos_result_cache_.find(t);
-    if (itr != std::cend(k_indel_pos_result_cache_)) {
-        return itr->second;
+    if (const auto cached = k_indel_pos_result_cache_.find(t)) {
+        return *cached;
     }
     const auto result = coalescent(n, k_snp, k_indel, params_.snp_heterozygosity, indel_heterozygosity);
-    k_indel_pos_result_cache_.emplace(t, result);
+    k_indel_pos_result_cache_.insert(t, result);
     return result;
 }
 
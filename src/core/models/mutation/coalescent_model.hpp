@@ -12,6 +12,7 @@
 #include <iterator>
 #include <algorithm>
 #include <cstddef>
+#include <list>
 #include <tuple>
 #include <cassert>
 
@@ -72,7 +73,43 @@ private:
             return boost::hash_value(t);
         }
     };
-    
+
+    // A bounded memo of coalescent likelihoods keyed by site-frequency pattern;
+    // the least recently used patterns are evicted once capacity is reached.
+    // Copies start cold as the stored entries reference the source recency list.
+    class SitePatternResultCache
+    {
+    public:
+        SitePatternResultCache() = default;
+        explicit SitePatternResultCache(std::size_t max_size);
+
+        SitePatternResultCache(const SitePatternResultCache& other) : max_size_ {other.max_size_} {}
+        SitePatternResultCache& operator=(const SitePatternResultCache& other)
+        {
+            max_size_ = other.max_size_;
+            return *this;
+        }
+        SitePatternResultCache(SitePatternResultCache&&)            = default;
+        SitePatternResultCache& operator=(SitePatternResultCache&&) = default;
+
+        ~SitePatternResultCache() = default;
+
+        boost::optional<double> find(const SiteCountIndelTuple& pattern);
+        void insert(const SiteCountIndelTuple& pattern, double result);
+
+    private:
+        using RecencyList = std::list<SiteCountIndelTuple>;
+        struct Entry
+        {
+            double result;
+            RecencyList::iterator recency;
+        };
+
+        std::size_t max_size_ = 65'536;
+        RecencyList recency_;
+        std::unordered_map<SiteCountIndelTuple, Entry, SiteCountTupleHash> results_;
+    };
+
     Haplotype reference_;
     IndelMutationModel::ContextIndelModel indel_heterozygosity_model_;
     Parameters params_;
@@ -85,7 +122,7 @@ private:
     mutable std::vector<boost::optional<std::vector<Variant>>> index_cache_;
     mutable std::vector<bool> index_flag_buffer_;
     mutable std::vector<std::vector<boost::optional<double>>> k_indel_zero_result_cache_;
-    mutable std::unordered_map<SiteCountIndelTuple, double, SiteCountTupleHash> k_indel_pos_result_cache_;
+    mutable SitePatternResultCache k_indel_pos_result_cache_;
     
     double evaluate(const SiteCountTuple& t) const;
     double evaluate(unsigned k_snp, unsigned n) const;
@@ -81,6 +81,11 @@ void DeNovoModel::prime(std::vector<Haplotype> haplotypes)
 
 void DeNovoModel::unprime() noexcept
 {
+    // The address and value caches key on haplotypes from the current active
+    // region, so they cannot be trusted after it; only the sequence-pair cache
+    // carries over
+    value_cache_.clear();
+    address_cache_.clear();
     haplotypes_.clear();
     haplotypes_.shrink_to_fit();
     gap_open_penalties_.clear();
@@ -212,6 +217,15 @@ void set_penalties(const IndelMutationModel::ContextIndelModel::ProbabilityVecto
 
 void DeNovoModel::set_gap_penalties(const Haplotype& given) const
 {
+    // Walking the given haplotype's indel context is the expensive part of a
+    // cache-missed evaluation, and each given is scored against many targets,
+    // so the penalties are kept per sequence and looked up thereafter
+    const auto cache_itr = gap_model_sequence_cache_.find(given.sequence());
+    if (cache_itr != std::cend(gap_model_sequence_cache_)) {
+        gap_open_penalties_   = cache_itr->second.first;
+        gap_extend_penalties_ = cache_itr->second.second;
+        return;
+    }
     const auto contextual_indel_model = indel_model_.evaluate(given);
     const auto num_bases = sequence_size(given);
     assert(contextual_indel_model.gap_open.size() == num_bases);
@@ -220,6 +234,11 @@ void DeNovoModel::set_gap_penalties(const Haplotype& given) const
     assert(contextual_indel_model.gap_extend.size() == num_bases);
     gap_extend_penalties_.resize(num_bases);
     set_penalties(contextual_indel_model.gap_extend, gap_extend_penalties_);
+    constexpr std::size_t maxGapModelSequenceCacheSize {10'000};
+    if (gap_model_sequence_cache_.size() < maxGapModelSequenceCacheSize) {
+        gap_model_sequence_cache_.emplace(given.sequence(),
+                                          std::make_pair(gap_open_penalties_, gap_extend_penalties_));
+    }
 }
 
 void DeNovoModel::set_gap_penalties(const unsigned given) const
@@ -242,6 +261,11 @@ hmm::VariableGapExtendMutationModel DeNovoModel::make_hmm_model_from_cache() con
 
 double DeNovoModel::evaluate_uncached(const Haplotype& target, const Haplotype& given, const bool gap_penalties_cached) const
 {
+    auto cache_key = std::make_pair(target.sequence(), given.sequence());
+    const auto cache_itr = sequence_pair_cache_.find(cache_key);
+    if (cache_itr != std::cend(sequence_pair_cache_)) {
+        return cache_itr->second;
+    }
     if (!gap_penalties_cached) set_gap_penalties(given);
     const auto mutation_model = make_hmm_model_from_cache();
     double result;
@@ -255,7 +279,15 @@ double DeNovoModel::evaluate_uncached(const Haplotype& target, const Haplotype&
     } else {
         result = approx_align(target, given, mutation_model);
     }
-    return min_ln_probability_ ? std::max(result, *min_ln_probability_) : result;
+    if (min_ln_probability_) result = std::max(result, *min_ln_probability_);
+    // Bound the cache rather than evict; a run of unique pairs should not be
+    // able to displace the common ones
+    constexpr std::size_t maxSequencePairCacheBytes {std::size_t {1} << 26};
+    if (sequence_pair_cache_bytes_ <= maxSequencePairCacheBytes) {
+        sequence_pair_cache_bytes_ += cache_key.first.size() + cache_key.second.size() + sizeof(double);
+        sequence_pair_cache_.emplace(std::move(cache_key), result);
+    }
+    return result;
 }
 
 double DeNovoModel::evaluate_uncached(const unsigned target_idx, const unsigned given_idx) const
@@ -60,6 +60,18 @@ private:
         }
     };
     
+    using NucleotideSequence = Haplotype::NucleotideSequence;
+    
+    struct SequencePairHash
+    {
+        std::size_t operator()(const std::pair<NucleotideSequence, NucleotideSequence>& p) const noexcept
+        {
+            auto result = boost::hash_value(p.first);
+            boost::hash_combine(result, p.second);
+            return result;
+        }
+    };
+    
     using PenaltyVector   = hmm::VariableGapOpenMutationModel::PenaltyVector;
     using GapPenaltyModel = std::pair<PenaltyVector, PenaltyVector>;
     
@@ -78,6 +90,12 @@ private:
     mutable std::vector<std::vector<double>> unguarded_index_cache_;
     mutable std::string padded_given_;
     mutable bool use_unguarded_;
+    // Scores depend only on the pair of sequences, so they outlive priming and
+    // the other caches - neighbouring active regions mostly re-present the
+    // same sequence pairs. The model is conditional, so pairs are kept ordered.
+    mutable std::unordered_map<std::pair<NucleotideSequence, NucleotideSequence>, double, SequencePairHash> sequence_pair_cache_;
+    mutable std::size_t sequence_pair_cache_bytes_ = 0;
+    mutable std::unordered_map<NucleotideSequence, GapPenaltyModel> gap_model_sequence_cache_;
     
     void set_gap_penalties(const Haplotype& given) const;
     void set_gap_penalties(unsigned given) const;
@@ -0,0 +1,107 @@
+// Copyright (c) 2015-2018 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef avx2_pair_hmm_impl_hpp
+#define avx2_pair_hmm_impl_hpp
+
+#ifdef __AVX2__
+
+#if __GNUC__ >= 6
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+#include <array>
+
+#include <immintrin.h>
+
+namespace octopus { namespace hmm { namespace simd {
+
+struct AVX2InstructionSet
+{
+    using VectorType = __m256i;
+    using ScoreType  = short;
+
+    constexpr static int band_size = 16;
+
+    static VectorType vectorise(const ScoreType x) noexcept
+    {
+        return _mm256_set1_epi16(x);
+    }
+    static VectorType vectorise(const char* sequence) noexcept
+    {
+        return _mm256_set_epi16(sequence[15], sequence[14], sequence[13], sequence[12],
+                                sequence[11], sequence[10], sequence[9],  sequence[8],
+                                sequence[7],  sequence[6],  sequence[5],  sequence[4],
+                                sequence[3],  sequence[2],  sequence[1],  sequence[0]);
+    }
+    static VectorType vectorise_zero_set_last(const ScoreType x) noexcept
+    {
+        return _mm256_set_epi16(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,x);
+    }
+    static ScoreType extract(const VectorType a, const int n) noexcept
+    {
+        alignas(VectorType) std::array<ScoreType, band_size> buffer;
+        _mm256_store_si256(reinterpret_cast<VectorType*>(buffer.data()), a);
+        return buffer[n];
+    }
+    static VectorType insert_bottom(const VectorType a, const ScoreType x) noexcept
+    {
+        return _mm256_insert_epi16(a, x, 0);
+    }
+    static VectorType insert_top(const VectorType a, const ScoreType x) noexcept
+    {
+        return _mm256_insert_epi16(a, x, band_size - 1);
+    }
+    static VectorType add(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm256_add_epi16(lhs, rhs);
+    }
+    static VectorType and_(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm256_and_si256(lhs, rhs);
+    }
+    static VectorType andnot(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm256_andnot_si256(lhs, rhs);
+    }
+    static VectorType or_(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm256_or_si256(lhs, rhs);
+    }
+    static VectorType cmpeq(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm256_cmpeq_epi16(lhs, rhs);
+    }
+    static VectorType min(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm256_min_epi16(lhs, rhs);
+    }
+    static VectorType left_shift_word(const VectorType a) noexcept
+    {
+        // _mm256_slli_si256 shifts the two 128-bit lanes independently, so the
+        // word crossing the lane boundary must be carried over explicitly
+        return _mm256_alignr_epi8(a, _mm256_permute2x128_si256(a, a, _MM_SHUFFLE(0, 0, 2, 0)), 16 - 2);
+    }
+    static VectorType right_shift_word(const VectorType a) noexcept
+    {
+        return _mm256_alignr_epi8(_mm256_permute2x128_si256(a, a, _MM_SHUFFLE(2, 0, 0, 1)), a, 2);
+    }
+    template <int n>
+    static VectorType left_shift_bits(const VectorType a) noexcept
+    {
+        return _mm256_slli_epi16(a, n);
+    }
+    template <int n>
+    static VectorType right_shift_bits(const VectorType a) noexcept
+    {
+        return _mm256_srli_epi16(a, n);
+    }
+};
+
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
+
+#endif // __AVX2__
+
+#endif
@@ -0,0 +1,114 @@
+// Copyright (c) 2015-2018 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef avx512_pair_hmm_impl_hpp
+#define avx512_pair_hmm_impl_hpp
+
+#ifdef __AVX512BW__
+
+#if __GNUC__ >= 6
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+    // GCC's avx512fintrin.h trips this via _mm512_undefined_epi32
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+#include <array>
+
+#include <immintrin.h>
+
+namespace octopus { namespace hmm { namespace simd {
+
+struct AVX512InstructionSet
+{
+    using VectorType = __m512i;
+    using ScoreType  = short;
+
+    constexpr static int band_size = 32;
+
+    static VectorType vectorise(const ScoreType x) noexcept
+    {
+        return _mm512_set1_epi16(x);
+    }
+    static VectorType vectorise(const char* sequence) noexcept
+    {
+        alignas(VectorType) std::array<ScoreType, band_size> buffer;
+        for (int i {0}; i < band_size; ++i) {
+            buffer[i] = sequence[i];
+        }
+        return _mm512_load_si512(buffer.data());
+    }
+    static VectorType vectorise_zero_set_last(const ScoreType x) noexcept
+    {
+        return _mm512_maskz_set1_epi16(__mmask32 {1}, x);
+    }
+    static ScoreType extract(const VectorType a, const int n) noexcept
+    {
+        alignas(VectorType) std::array<ScoreType, band_size> buffer;
+        _mm512_store_si512(buffer.data(), a);
+        return buffer[n];
+    }
+    static VectorType insert_bottom(const VectorType a, const ScoreType x) noexcept
+    {
+        return _mm512_mask_set1_epi16(a, __mmask32 {1}, x);
+    }
+    static VectorType insert_top(const VectorType a, const ScoreType x) noexcept
+    {
+        return _mm512_mask_set1_epi16(a, __mmask32 {1} << (band_size - 1), x);
+    }
+    static VectorType add(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm512_add_epi16(lhs, rhs);
+    }
+    static VectorType and_(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm512_and_si512(lhs, rhs);
+    }
+    static VectorType andnot(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm512_andnot_si512(lhs, rhs);
+    }
+    static VectorType or_(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm512_or_si512(lhs, rhs);
+    }
+    static VectorType cmpeq(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm512_movm_epi16(_mm512_cmpeq_epi16_mask(lhs, rhs));
+    }
+    static VectorType min(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm512_min_epi16(lhs, rhs);
+    }
+    static VectorType left_shift_word(const VectorType a) noexcept
+    {
+        // no full-width byte shifts in AVX512; do a lane rotation and zero the new word
+        static const auto indices = _mm512_set_epi16(30,29,28,27,26,25,24,23,22,21,20,19,18,17,16,15,
+                                                     14,13,12,11,10,9,8,7,6,5,4,3,2,1,0,0);
+        return _mm512_maskz_permutexvar_epi16(__mmask32 {0xFFFFFFFEu}, indices, a);
+    }
+    static VectorType right_shift_word(const VectorType a) noexcept
+    {
+        static const auto indices = _mm512_set_epi16(31,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17,
+                                                     16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1);
+        return _mm512_maskz_permutexvar_epi16(__mmask32 {0x7FFFFFFFu}, indices, a);
+    }
+    template <int n>
+    static VectorType left_shift_bits(const VectorType a) noexcept
+    {
+        return _mm512_slli_epi16(a, n);
+    }
+    template <int n>
+    static VectorType right_shift_bits(const VectorType a) noexcept
+    {
+        return _mm512_srli_epi16(a, n);
+    }
+};
+
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
+
+#endif // __AVX512BW__
+
+#endif
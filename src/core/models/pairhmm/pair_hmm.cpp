@@ -28,27 +28,16 @@ constexpr auto num_values() noexcept
     return std::numeric_limits<T>::max() - std::numeric_limits<T>::min() + 1;
 }
 
-template <std::size_t N>
-constexpr auto make_phred_to_ln_prob_lookup() noexcept
-{
-    std::array<double, N> result {};
-    for (std::size_t i {0}; i < N; ++i) {
-        // This const_cast mess is because std::array::operator[] is not marked constexpr (until C++17)
-        const_cast<double&>(static_cast<std::array<double, N> const&>(result)[i]) = -ln10Div10<> * i;
-    }
-    return result;
-}
-
 template <typename T>
 constexpr auto make_phred_to_ln_prob_lookup() noexcept
 {
-    return make_phred_to_ln_prob_lookup<num_values<T>()>();
+    return maths::detail::make_phred_to_ln_error_probability_lookup<num_values<T>()>();
 }
 
 bool target_overlaps_truth_flank(const std::string& truth, const std::string& target, const std::size_t target_offset,
                                  const MutationModel& model) noexcept
 {
-    constexpr auto pad = simd::min_flank_pad();
+    const auto pad = model.flank_pad;
     return target_offset < (model.lhs_flank_size + pad)
            || (target_offset + target.size() + pad) > (truth.size() - model.rhs_flank_size);
 }
@@ -114,9 +103,10 @@ auto make_cigar(const std::vector<char>& align1, const std::vector<char>& align2
 auto simd_align(const std::string& truth, const std::string& target,
                 const std::vector<std::uint8_t>& target_qualities,
                 const std::size_t target_offset,
-                const MutationModel& model) noexcept
+                const MutationModel& model,
+                const int score_ceiling = std::numeric_limits<int>::max()) noexcept
 {
-    constexpr auto pad = simd::min_flank_pad();
+    const auto pad = static_cast<int>(model.flank_pad);
     const auto truth_size  = static_cast<int>(truth.size());
     const auto target_size = static_cast<int>(target.size());
     const auto truth_alignment_size = static_cast<int>(target_size + 2 * pad - 1);
@@ -134,7 +124,8 @@ auto simd_align(const std::string& truth, const std::string& target,
                                        model.snv_mask.data() + alignment_offset,
                                        model.snv_priors.data() + alignment_offset,
                                        model.gap_open.data() + alignment_offset,
-                                       model.gap_extend, model.nuc_prior);
+                                       model.gap_extend, model.nuc_prior,
+                                       score_ceiling);
         return -ln10Div10<> * static_cast<double>(score);
     } else {
         thread_local std::vector<char> align1 {}, align2 {};
@@ -198,7 +189,7 @@ Alignment simd_align_with_cigar(const std::string& truth, const std::string& tar
                                 const std::size_t target_offset,
                                 const MutationModel& model) noexcept
 {
-    constexpr auto pad = simd::min_flank_pad();
+    const auto pad = static_cast<int>(model.flank_pad);
     const auto truth_size  = static_cast<int>(truth.size());
     const auto target_size = static_cast<int>(target.size());
     const auto truth_alignment_size = static_cast<int>(target_size + 2 * pad - 1);
@@ -270,6 +261,11 @@ unsigned min_flank_pad() noexcept
     return simd::min_flank_pad();
 }
 
+unsigned max_flank_pad() noexcept
+{
+    return static_cast<unsigned>(simd::max_band_size());
+}
+
 void validate(const std::string& truth, const std::string& target,
               const std::vector<std::uint8_t>& target_qualities,
               const std::size_t target_offset,
@@ -292,7 +288,8 @@ void validate(const std::string& truth, const std::string& target,
 double evaluate(const std::string& target, const std::string& truth,
                 const std::vector<std::uint8_t>& target_qualities,
                 const std::size_t target_offset,
-                const MutationModel& model)
+                const MutationModel& model,
+                const double min_ln_probability)
 {
     using std::cbegin; using std::cend; using std::next; using std::distance;
     static constexpr auto lnProbability = make_phred_to_ln_prob_lookup<std::uint8_t>();
@@ -334,7 +331,17 @@ double evaluate(const std::string& target, const std::string& truth,
         }
     }
     // TODO: we should be able to optimise the alignment based of the first mismatch postition
-    return simd_align(truth, target, target_qualities, target_offset, model);
+    if (min_ln_probability == std::numeric_limits<double>::lowest()) {
+        return simd_align(truth, target, target_qualities, target_offset, model);
+    }
+    // Flank adjusted alignments subtract the flank score after the fact, so a ceiling
+    // can only be applied to the unadjusted path
+    int score_ceiling {std::numeric_limits<int>::max()};
+    if (!use_adjusted_alignment_score(truth, target, target_offset, model)) {
+        score_ceiling = static_cast<int>(min_ln_probability / -ln10Div10<>) + 1;
+    }
+    const auto result = simd_align(truth, target, target_qualities, target_offset, model, score_ceiling);
+    return std::max(result, min_ln_probability);
 }
 
 Alignment align(const std::string& target, const std::string& truth,
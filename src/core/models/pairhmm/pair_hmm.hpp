@@ -8,6 +8,7 @@
 #include <vector>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <utility>
 
 #include "basics/cigar_string.hpp"
@@ -18,6 +19,10 @@ namespace octopus { namespace hmm {
 // the mapped position
 unsigned min_flank_pad() noexcept;
 
+// The widest flank pad - and so alignment band - usable on this host; wider pads
+// are dispatched to wider SIMD kernels
+unsigned max_flank_pad() noexcept;
+
 struct MutationModel
 {
     using Penalty = std::int8_t;
@@ -27,6 +32,10 @@ struct MutationModel
     short gap_extend;
     short nuc_prior = 2;
     std::size_t lhs_flank_size = 0, rhs_flank_size = 0;
+    // The band used to align each read; must be between min_flank_pad() and
+    // max_flank_pad(), and the truth must contain the target by this many bases
+    // either side of the mapped position
+    unsigned flank_pad = min_flank_pad();
 };
 
 struct VariableGapExtendMutationModel
@@ -65,12 +74,17 @@ struct Alignment
 
 // p(target | truth, target_qualities, target_offset, model)
 //
+// If min_ln_probability is given then the alignment may terminate early once
+// the result is guaranteed to fall below it, and the returned likelihood is
+// clamped at min_ln_probability.
+//
 // Warning: The target must be contained by the truth by at least
 // min_flank_pad() on either side.
 double evaluate(const std::string& target, const std::string& truth,
                 const std::vector<std::uint8_t>& target_qualities,
                 std::size_t target_offset,
-                const MutationModel& model);
+                const MutationModel& model,
+                double min_ln_probability = std::numeric_limits<double>::lowest());
 
 Alignment align(const std::string& target, const std::string& truth,
                 const std::vector<std::uint8_t>& target_qualities,
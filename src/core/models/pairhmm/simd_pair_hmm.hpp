@@ -5,28 +5,38 @@
 #define simd_pair_hmm_hpp
 
 #include <cstdint>
+#include <limits>
 
 namespace octopus { namespace hmm { namespace simd {
 
 constexpr int min_flank_pad() noexcept { return 8; }
 
+// The widest diagonal band (and so flank pad) the host CPU can run; alignments
+// padded for a wider band than min_flank_pad() are dispatched to the matching
+// AVX2 or AVX512 kernels
+int max_band_size() noexcept;
+
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           int truth_len, int target_len,
-          short gap_open, short gap_extend, short nuc_prior) noexcept;
+          short gap_open, short gap_extend, short nuc_prior,
+          int score_ceiling = std::numeric_limits<int>::max()) noexcept;
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           int truth_len, int target_len,
-          const std::int8_t* gap_open, short gap_extend, short nuc_prior) noexcept;
+          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          int score_ceiling = std::numeric_limits<int>::max()) noexcept;
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           int truth_len, int target_len,
           const std::int8_t* gap_open, const std::int8_t* gap_extend,
-          short nuc_prior) noexcept;
+          short nuc_prior,
+          int score_ceiling = std::numeric_limits<int>::max()) noexcept;
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           int truth_len, int target_len,
           const char* snv_mask, const std::int8_t* snv_prior,
-          const std::int8_t* gap_open, short gap_extend, short nuc_prior) noexcept;
+          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          int score_ceiling = std::numeric_limits<int>::max()) noexcept;
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           int truth_len, int target_len,
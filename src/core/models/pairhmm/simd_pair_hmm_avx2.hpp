@@ -0,0 +1,56 @@
+// Copyright (c) 2015-2018 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef simd_pair_hmm_avx2_hpp
+#define simd_pair_hmm_avx2_hpp
+
+#include <cstdint>
+#include <limits>
+
+namespace octopus { namespace hmm { namespace simd { namespace avx2 {
+
+// 16-wide banded aligners; the translation unit defining these is the only one
+// compiled with AVX2 enabled, so they must not be called unless the runtime
+// CPU reports AVX2 support
+
+constexpr int band_size() noexcept { return 16; }
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          int truth_len, int target_len,
+          short gap_open, short gap_extend, short nuc_prior,
+          int score_ceiling = std::numeric_limits<int>::max()) noexcept;
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          int truth_len, int target_len,
+          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          int score_ceiling = std::numeric_limits<int>::max()) noexcept;
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          int truth_len, int target_len,
+          const std::int8_t* gap_open, const std::int8_t* gap_extend,
+          short nuc_prior,
+          int score_ceiling = std::numeric_limits<int>::max()) noexcept;
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          int truth_len, int target_len,
+          const char* snv_mask, const std::int8_t* snv_prior,
+          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          int score_ceiling = std::numeric_limits<int>::max()) noexcept;
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          int truth_len, int target_len,
+          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          int& first_pos, char* aln1, char* aln2) noexcept;
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          int truth_len, int target_len,
+          const char* snv_mask, const std::int8_t* snv_prior,
+          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          char* aln1, char* aln2, int& first_pos) noexcept;
+
+} // namespace avx2
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
+
+#endif
@@ -0,0 +1,76 @@
+// Copyright (c) 2015-2018 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "simd_pair_hmm_avx512.hpp"
+
+#ifdef __AVX512BW__
+
+#include "avx512_pair_hmm_impl.hpp"
+#include "simd_pair_hmm_impl.hpp"
+
+namespace octopus { namespace hmm { namespace simd { namespace avx512 {
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          const short gap_open, const short gap_extend, const short nuc_prior,
+          const int score_ceiling) noexcept
+{
+    return simd::align<AVX512InstructionSet>(truth, target, qualities, truth_len, target_len,
+                                           gap_open, gap_extend, nuc_prior, score_ceiling);
+}
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          const std::int8_t* gap_open, const short gap_extend, const short nuc_prior,
+          const int score_ceiling) noexcept
+{
+    return simd::align<AVX512InstructionSet>(truth, target, qualities, truth_len, target_len,
+                                           gap_open, gap_extend, nuc_prior, score_ceiling);
+}
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          const std::int8_t* gap_open, const std::int8_t* gap_extend,
+          const short nuc_prior,
+          const int score_ceiling) noexcept
+{
+    return simd::align<AVX512InstructionSet>(truth, target, qualities, truth_len, target_len,
+                                           gap_open, gap_extend, nuc_prior, score_ceiling);
+}
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          const char* snv_mask, const std::int8_t* snv_prior,
+          const std::int8_t* gap_open, const short gap_extend, const short nuc_prior,
+          const int score_ceiling) noexcept
+{
+    return simd::align<AVX512InstructionSet>(truth, target, qualities, truth_len, target_len,
+                                           snv_mask, snv_prior, gap_open, gap_extend, nuc_prior, score_ceiling);
+}
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          const std::int8_t* gap_open, const short gap_extend, const short nuc_prior,
+          int& first_pos, char* aln1, char* aln2) noexcept
+{
+    return simd::align<AVX512InstructionSet>(truth, target, qualities, truth_len, target_len,
+                                           gap_open, gap_extend, nuc_prior, first_pos, aln1, aln2);
+}
+
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          const char* snv_mask, const std::int8_t* snv_prior,
+          const std::int8_t* gap_open, const short gap_extend, const short nuc_prior,
+          char* aln1, char* aln2, int& first_pos) noexcept
+{
+    return simd::align<AVX512InstructionSet>(truth, target, qualities, truth_len, target_len,
+                                           snv_mask, snv_prior, gap_open, gap_extend, nuc_prior,
+                                           aln1, aln2, first_pos);
+}
+
+} // namespace avx512
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
+
+#endif // __AVX512BW__
@@ -0,0 +1,945 @@
+// Copyright (c) 2015-2018 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef simd_pair_hmm_impl_hpp
+#define simd_pair_hmm_impl_hpp
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+#include <boost/container/small_vector.hpp>
+#include <boost/align/aligned_allocator.hpp>
+
+namespace octopus { namespace hmm { namespace simd {
+
+// The aligners in this file are templated on an InstructionSet policy that wraps
+// the raw vector intrinsics. Each policy exposes a 16-bit integer lane model; the
+// number of lanes fixes the diagonal band size of the alignment, so wider
+// instruction sets (AVX2, AVX512) buy wider bands rather than more alignments
+// per call. The required policy interface is (all static):
+//
+//     using VectorType; using ScoreType;
+//     constexpr static int band_size;
+//     VectorType vectorise(ScoreType x);                 // broadcast
+//     VectorType vectorise(const char* sequence);        // first band_size chars -> lanes
+//     VectorType vectorise_zero_set_last(ScoreType x);   // {x, 0, 0, ...}
+//     ScoreType extract(VectorType a, int n);            // read lane n
+//     VectorType insert_bottom(VectorType a, ScoreType); // write lane 0
+//     VectorType insert_top(VectorType a, ScoreType);    // write lane band_size - 1
+//     VectorType add(VectorType, VectorType);
+//     VectorType and_(VectorType, VectorType);
+//     VectorType andnot(VectorType, VectorType);
+//     VectorType or_(VectorType, VectorType);
+//     VectorType cmpeq(VectorType, VectorType);          // lanewise -1 / 0
+//     VectorType min(VectorType, VectorType);
+//     VectorType left_shift_word(VectorType);            // whole register, one lane
+//     VectorType right_shift_word(VectorType);
+//     template <int N> VectorType left_shift_bits(VectorType);  // lanewise
+//     template <int N> VectorType right_shift_bits(VectorType);
+
+constexpr short nScore {2 << 2};
+constexpr short infinity {0x7800};
+constexpr char gapLabel {'-'};
+
+constexpr std::size_t staticBackpointerCapacityBytes {160000};
+
+template <typename T>
+using SmallVector = boost::container::small_vector<T, staticBackpointerCapacityBytes / sizeof(T),
+                                                   boost::alignment::aligned_allocator<T, alignof(T)>>;
+
+namespace detail {
+
+template <typename InstructionSet>
+auto vectorise_penalties(const std::int8_t* values) noexcept
+{
+    // The lower two bits of each score are reserved for back tracing
+    alignas(typename InstructionSet::VectorType) char buffer[InstructionSet::band_size];
+    std::copy_n(values, InstructionSet::band_size, buffer);
+    return InstructionSet::template left_shift_bits<2>(InstructionSet::vectorise(buffer));
+}
+
+template <typename InstructionSet>
+auto make_truth_nqual(const typename InstructionSet::VectorType truthwin) noexcept
+{
+    // if N, make nScore; if != N, make infinity
+    using IS = InstructionSet;
+    return IS::add(IS::and_(IS::cmpeq(truthwin, IS::vectorise('N')), IS::vectorise(nScore - infinity)),
+                   IS::vectorise(infinity));
+}
+
+template <typename InstructionSet>
+auto horizontal_min(const typename InstructionSet::VectorType a) noexcept
+{
+    auto result = InstructionSet::extract(a, 0);
+    for (int i {1}; i < InstructionSet::band_size; ++i) {
+        result = std::min(result, InstructionSet::extract(a, i));
+    }
+    return result;
+}
+
+} // namespace detail
+
+template <typename InstructionSet>
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          short gap_open, short gap_extend, short nuc_prior,
+          const int score_ceiling = std::numeric_limits<int>::max()) noexcept
+{
+    using IS = InstructionSet;
+    using SimdInt = typename IS::VectorType;
+    constexpr int bandSize {IS::band_size};
+
+    // target is the read; the shorter of the sequences
+    // no checks for overflow are done
+    //
+    // the bottom-left and top-right corners of the DP table are just
+    // included at the extreme ends of the diagonal, which measures
+    // band_size entries diagonally across.  This fixes the length of the
+    // longer (horizontal) sequence to 2 * band_size - 1 more than the shorter
+    //
+    // the << 2's are because the lower two bits are reserved for back tracing
+
+    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
+
+    gap_open <<= 2;
+    gap_extend <<= 2;
+    nuc_prior <<= 2;
+
+    SimdInt _m1 {IS::vectorise(infinity)};
+    auto _i1 = _m1;
+    auto _d1 = _m1;
+    auto _m2 = _m1;
+    auto _i2 = _m1;
+    auto _d2 = _m1;
+
+    const SimdInt _gap_open {IS::vectorise(gap_open)};
+    const SimdInt _gap_extend {IS::vectorise(gap_extend)};
+    const SimdInt _nuc_prior  {IS::vectorise(nuc_prior)};
+
+    SimdInt _initmask  {IS::vectorise_zero_set_last(-1)};
+    SimdInt _initmask2 {IS::vectorise_zero_set_last(-0x8000)};
+
+    // truth is initialized with the band-long prefix, in forward direction
+    // target is initialized as empty; reverse direction
+    SimdInt _truthwin  {IS::vectorise(truth)};
+    SimdInt _targetwin {_m1};
+    SimdInt _qualitieswin {IS::vectorise(64 << 2)};
+
+    SimdInt _truthnqual {detail::make_truth_nqual<IS>(_truthwin)};
+
+    short minscore {infinity};
+
+    for (int s {0}; s <= 2 * (target_len + bandSize); s += 2) {
+        // truth is current; target needs updating
+        _targetwin    = IS::left_shift_word(_targetwin);
+        _qualitieswin = IS::left_shift_word(_qualitieswin);
+
+        if (s / 2 < target_len) {
+            _targetwin    = IS::insert_bottom(_targetwin, target[s / 2]);
+            _qualitieswin = IS::insert_bottom(_qualitieswin, qualities[s / 2] << 2);
+        } else {
+            _targetwin    = IS::insert_bottom(_targetwin, '0');
+            _qualitieswin = IS::insert_bottom(_qualitieswin, 64 << 2);
+        }
+
+        // S even
+
+        _m1 = IS::or_(_initmask2, IS::andnot(_initmask, _m1));
+        _m2 = IS::or_(_initmask2, IS::andnot(_initmask, _m2));
+        _m1 = IS::min(_m1, IS::min(_i1, _d1));
+
+        // Scores only grow along a path, so the minimum over the live states
+        // bounds any score still reachable; once that bound (and any final
+        // score seen so far) beats the ceiling the caller cannot use the
+        // result and the remaining diagonals are skipped
+        if (score_ceiling != std::numeric_limits<int>::max()
+            && s > 2 * bandSize && (s & (2 * bandSize - 1)) == 0) {
+            const auto bound = std::min(std::min(detail::horizontal_min<IS>(_m1),
+                                                 detail::horizontal_min<IS>(IS::min(_m2, IS::min(_i2, _d2)))),
+                                        minscore);
+            const auto bound_score = (bound + 0x8000) >> 2;
+            if (bound_score > score_ceiling) return bound_score;
+        }
+
+        if (s / 2 >= target_len) {
+            minscore = std::min(static_cast<short>(IS::extract(_m1, s / 2 - target_len)), minscore);
+        }
+
+        _m1 = IS::add(_m1, IS::min(IS::andnot(IS::cmpeq(_targetwin, _truthwin), _qualitieswin), _truthnqual));
+        _d1 = IS::min(IS::add(_d2, _gap_extend),
+                      IS::add(IS::min(_m2, _i2), IS::right_shift_word(_gap_open))); // allow I->D
+        _d1 = IS::insert_bottom(IS::left_shift_word(_d1), infinity);
+        _i1 = IS::add(IS::min(IS::add(_i2, _gap_extend), IS::add(_m2, _gap_open)), _nuc_prior);
+
+        // S odd
+        // truth needs updating; target is current
+        const auto pos = bandSize + s / 2;
+        const char base {(pos < truth_len) ? truth[pos] : 'N'};
+
+        _truthwin   = IS::insert_top(IS::right_shift_word(_truthwin), base);
+        _truthnqual = IS::insert_top(IS::right_shift_word(_truthnqual), base == 'N' ? nScore : infinity);
+
+        _initmask  = IS::left_shift_word(_initmask);
+        _initmask2 = IS::left_shift_word(_initmask2);
+        _m2 = IS::min(_m2, IS::min(_i2, _d2));
+
+        if (s / 2 >= target_len) {
+            minscore = std::min(static_cast<short>(IS::extract(_m2, s / 2 - target_len)), minscore);
+        }
+
+        _m2 = IS::add(_m2, IS::min(IS::andnot(IS::cmpeq(_targetwin, _truthwin), _qualitieswin), _truthnqual));
+        _d2 = IS::min(IS::add(_d1, _gap_extend),
+                      IS::add(IS::min(_m1, _i1), _gap_open)); // allow I->D
+        _i2 = IS::insert_top(IS::add(IS::min(IS::add(IS::right_shift_word(_i1), _gap_extend),
+                                             IS::add(IS::right_shift_word(_m1), _gap_open)),
+                                     _nuc_prior), infinity);
+    }
+
+    return (minscore + 0x8000) >> 2;
+}
+
+template <typename InstructionSet>
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          const int score_ceiling = std::numeric_limits<int>::max()) noexcept
+{
+    using IS = InstructionSet;
+    using SimdInt = typename IS::VectorType;
+    constexpr int bandSize {IS::band_size};
+
+    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
+
+    gap_extend <<= 2;
+    nuc_prior <<= 2;
+
+    SimdInt _m1 {IS::vectorise(infinity)};
+    auto _i1 = _m1;
+    auto _d1 = _m1;
+    auto _m2 = _m1;
+    auto _i2 = _m1;
+    auto _d2 = _m1;
+
+    const SimdInt _gap_extend {IS::vectorise(gap_extend)};
+    const SimdInt _nuc_prior  {IS::vectorise(nuc_prior)};
+
+    SimdInt _initmask  {IS::vectorise_zero_set_last(-1)};
+    SimdInt _initmask2 {IS::vectorise_zero_set_last(-0x8000)};
+
+    // truth is initialized with the band-long prefix, in forward direction
+    // target is initialized as empty; reverse direction
+    SimdInt _truthwin  {IS::vectorise(truth)};
+    SimdInt _targetwin {_m1};
+    SimdInt _qualitieswin {IS::vectorise(64 << 2)};
+
+    SimdInt _truthnqual {detail::make_truth_nqual<IS>(_truthwin)};
+    SimdInt _gap_open {detail::vectorise_penalties<IS>(gap_open)};
+
+    short minscore {infinity};
+
+    for (int s {0}; s <= 2 * (target_len + bandSize); s += 2) {
+        // truth is current; target needs updating
+        _targetwin    = IS::left_shift_word(_targetwin);
+        _qualitieswin = IS::left_shift_word(_qualitieswin);
+
+        if (s / 2 < target_len) {
+            _targetwin    = IS::insert_bottom(_targetwin, target[s / 2]);
+            _qualitieswin = IS::insert_bottom(_qualitieswin, qualities[s / 2] << 2);
+        } else {
+            _targetwin    = IS::insert_bottom(_targetwin, '0');
+            _qualitieswin = IS::insert_bottom(_qualitieswin, 64 << 2);
+        }
+
+        // S even
+
+        _m1 = IS::or_(_initmask2, IS::andnot(_initmask, _m1));
+        _m2 = IS::or_(_initmask2, IS::andnot(_initmask, _m2));
+        _m1 = IS::min(_m1, IS::min(_i1, _d1));
+
+        // Scores only grow along a path, so the minimum over the live states
+        // bounds any score still reachable; once that bound (and any final
+        // score seen so far) beats the ceiling the caller cannot use the
+        // result and the remaining diagonals are skipped
+        if (score_ceiling != std::numeric_limits<int>::max()
+            && s > 2 * bandSize && (s & (2 * bandSize - 1)) == 0) {
+            const auto bound = std::min(std::min(detail::horizontal_min<IS>(_m1),
+                                                 detail::horizontal_min<IS>(IS::min(_m2, IS::min(_i2, _d2)))),
+                                        minscore);
+            const auto bound_score = (bound + 0x8000) >> 2;
+            if (bound_score > score_ceiling) return bound_score;
+        }
+
+        if (s / 2 >= target_len) {
+            minscore = std::min(static_cast<short>(IS::extract(_m1, s / 2 - target_len)), minscore);
+        }
+
+        _m1 = IS::add(_m1, IS::min(IS::andnot(IS::cmpeq(_targetwin, _truthwin), _qualitieswin), _truthnqual));
+        _d1 = IS::min(IS::add(_d2, _gap_extend),
+                      IS::add(IS::min(_m2, _i2), IS::right_shift_word(_gap_open))); // allow I->D
+        _d1 = IS::insert_bottom(IS::left_shift_word(_d1), infinity);
+        _i1 = IS::add(IS::min(IS::add(_i2, _gap_extend), IS::add(_m2, _gap_open)), _nuc_prior);
+
+        // S odd
+        // truth needs updating; target is current
+        const auto pos = bandSize + s / 2;
+        const char base {(pos < truth_len) ? truth[pos] : 'N'};
+
+        _truthwin   = IS::insert_top(IS::right_shift_word(_truthwin), base);
+        _truthnqual = IS::insert_top(IS::right_shift_word(_truthnqual), base == 'N' ? nScore : infinity);
+        _gap_open   = IS::insert_top(IS::right_shift_word(_gap_open),
+                                     gap_open[pos < truth_len ? pos : truth_len - 1] << 2);
+
+        _initmask  = IS::left_shift_word(_initmask);
+        _initmask2 = IS::left_shift_word(_initmask2);
+
+        _m2 = IS::min(_m2, IS::min(_i2, _d2));
+
+        if (s / 2 >= target_len) {
+            minscore = std::min(static_cast<short>(IS::extract(_m2, s / 2 - target_len)), minscore);
+        }
+
+        _m2 = IS::add(_m2, IS::min(IS::andnot(IS::cmpeq(_targetwin, _truthwin), _qualitieswin), _truthnqual));
+        _d2 = IS::min(IS::add(_d1, _gap_extend),
+                      IS::add(IS::min(_m1, _i1), _gap_open)); // allow I->D
+        _i2 = IS::insert_top(IS::add(IS::min(IS::add(IS::right_shift_word(_i1), _gap_extend),
+                                             IS::add(IS::right_shift_word(_m1), _gap_open)),
+                                     _nuc_prior), infinity);
+    }
+
+    return (minscore + 0x8000) >> 2;
+}
+
+template <typename InstructionSet>
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          const std::int8_t* gap_open, const std::int8_t* gap_extend,
+          short nuc_prior,
+          const int score_ceiling = std::numeric_limits<int>::max()) noexcept
+{
+    using IS = InstructionSet;
+    using SimdInt = typename IS::VectorType;
+    constexpr int bandSize {IS::band_size};
+
+    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
+
+    nuc_prior <<= 2;
+
+    SimdInt _m1 {IS::vectorise(infinity)};
+    auto _i1 = _m1;
+    auto _d1 = _m1;
+    auto _m2 = _m1;
+    auto _i2 = _m1;
+    auto _d2 = _m1;
+
+    const SimdInt _nuc_prior {IS::vectorise(nuc_prior)};
+
+    SimdInt _initmask  {IS::vectorise_zero_set_last(-1)};
+    SimdInt _initmask2 {IS::vectorise_zero_set_last(-0x8000)};
+
+    // truth is initialized with the band-long prefix, in forward direction
+    // target is initialized as empty; reverse direction
+    SimdInt _truthwin  {IS::vectorise(truth)};
+    SimdInt _targetwin {_m1};
+    SimdInt _qualitieswin {IS::vectorise(64 << 2)};
+
+    SimdInt _truthnqual {detail::make_truth_nqual<IS>(_truthwin)};
+    SimdInt _gap_open   {detail::vectorise_penalties<IS>(gap_open)};
+    SimdInt _gap_extend {detail::vectorise_penalties<IS>(gap_extend)};
+
+    short minscore {infinity};
+
+    for (int s {0}; s <= 2 * (target_len + bandSize); s += 2) {
+        // truth is current; target needs updating
+        _targetwin    = IS::left_shift_word(_targetwin);
+        _qualitieswin = IS::left_shift_word(_qualitieswin);
+
+        if (s / 2 < target_len) {
+            _targetwin    = IS::insert_bottom(_targetwin, target[s / 2]);
+            _qualitieswin = IS::insert_bottom(_qualitieswin, qualities[s / 2] << 2);
+        } else {
+            _targetwin    = IS::insert_bottom(_targetwin, '0');
+            _qualitieswin = IS::insert_bottom(_qualitieswin, 64 << 2);
+        }
+
+        // S even
+        _m1 = IS::or_(_initmask2, IS::andnot(_initmask, _m1));
+        _m2 = IS::or_(_initmask2, IS::andnot(_initmask, _m2));
+        _m1 = IS::min(_m1, IS::min(_i1, _d1));
+
+        // Scores only grow along a path, so the minimum over the live states
+        // bounds any score still reachable; once that bound (and any final
+        // score seen so far) beats the ceiling the caller cannot use the
+        // result and the remaining diagonals are skipped
+        if (score_ceiling != std::numeric_limits<int>::max()
+            && s > 2 * bandSize && (s & (2 * bandSize - 1)) == 0) {
+            const auto bound = std::min(std::min(detail::horizontal_min<IS>(_m1),
+                                                 detail::horizontal_min<IS>(IS::min(_m2, IS::min(_i2, _d2)))),
+                                        minscore);
+            const auto bound_score = (bound + 0x8000) >> 2;
+            if (bound_score > score_ceiling) return bound_score;
+        }
+
+        if (s / 2 >= target_len) {
+            minscore = std::min(static_cast<short>(IS::extract(_m1, s / 2 - target_len)), minscore);
+        }
+
+        _m1 = IS::add(_m1, IS::min(IS::andnot(IS::cmpeq(_targetwin, _truthwin), _qualitieswin), _truthnqual));
+        _d1 = IS::min(IS::add(_d2, _gap_extend),
+                      IS::add(IS::min(_m2, _i2), IS::right_shift_word(_gap_open))); // allow I->D
+        _d1 = IS::insert_bottom(IS::left_shift_word(_d1), infinity);
+        _i1 = IS::add(IS::min(IS::add(_i2, _gap_extend), IS::add(_m2, _gap_open)), _nuc_prior);
+
+        // S odd; truth needs updating; target is current
+        const auto pos = bandSize + s / 2;
+        const char base {(pos < truth_len) ? truth[pos] : 'N'};
+        _truthwin   = IS::insert_top(IS::right_shift_word(_truthwin), base);
+        _truthnqual = IS::insert_top(IS::right_shift_word(_truthnqual), base == 'N' ? nScore : infinity);
+        const auto gap_idx = pos < truth_len ? pos : truth_len - 1;
+        _gap_open   = IS::insert_top(IS::right_shift_word(_gap_open), gap_open[gap_idx] << 2);
+        _gap_extend = IS::insert_top(IS::right_shift_word(_gap_extend), gap_extend[gap_idx] << 2);
+
+        _initmask  = IS::left_shift_word(_initmask);
+        _initmask2 = IS::left_shift_word(_initmask2);
+
+        _m2 = IS::min(_m2, IS::min(_i2, _d2));
+
+        if (s / 2 >= target_len) {
+            minscore = std::min(static_cast<short>(IS::extract(_m2, s / 2 - target_len)), minscore);
+        }
+
+        _m2 = IS::add(_m2, IS::min(IS::andnot(IS::cmpeq(_targetwin, _truthwin), _qualitieswin), _truthnqual));
+        _d2 = IS::min(IS::add(_d1, _gap_extend),
+                      IS::add(IS::min(_m1, _i1), _gap_open)); // allow I->D
+        _i2 = IS::insert_top(IS::add(IS::min(IS::add(IS::right_shift_word(_i1), _gap_extend),
+                                             IS::add(IS::right_shift_word(_m1), _gap_open)),
+                                     _nuc_prior), infinity);
+    }
+
+    return (minscore + 0x8000) >> 2;
+}
+
+template <typename InstructionSet>
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          const char* snv_mask, const std::int8_t* snv_prior,
+          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          const int score_ceiling = std::numeric_limits<int>::max()) noexcept
+{
+    using IS = InstructionSet;
+    using SimdInt = typename IS::VectorType;
+    constexpr int bandSize {IS::band_size};
+
+    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
+
+    gap_extend <<= 2;
+    nuc_prior <<= 2;
+
+    SimdInt _m1 {IS::vectorise(infinity)};
+    auto _i1 = _m1;
+    auto _d1 = _m1;
+    auto _m2 = _m1;
+    auto _i2 = _m1;
+    auto _d2 = _m1;
+
+    const SimdInt _gap_extend {IS::vectorise(gap_extend)};
+    const SimdInt _nuc_prior  {IS::vectorise(nuc_prior)};
+    SimdInt _initmask  {IS::vectorise_zero_set_last(-1)};
+    SimdInt _initmask2 {IS::vectorise_zero_set_last(-0x8000)};
+
+    SimdInt _truthwin  {IS::vectorise(truth)};
+    SimdInt _targetwin {_m1};
+    SimdInt _qualitieswin {IS::vectorise(64 << 2)};
+
+    SimdInt _snvmaskwin   {IS::vectorise(snv_mask)};
+    SimdInt _snv_priorwin {detail::vectorise_penalties<IS>(snv_prior)};
+
+    SimdInt _snvmask;
+
+    SimdInt _truthnqual {detail::make_truth_nqual<IS>(_truthwin)};
+    SimdInt _gap_open   {detail::vectorise_penalties<IS>(gap_open)};
+
+    short minscore {infinity};
+
+    for (int s {0}; s <= 2 * (target_len + bandSize); s += 2) {
+        // truth is current; target needs updating
+        _targetwin    = IS::left_shift_word(_targetwin);
+        _qualitieswin = IS::left_shift_word(_qualitieswin);
+
+        if (s / 2 < target_len) {
+            _targetwin    = IS::insert_bottom(_targetwin, target[s / 2]);
+            _qualitieswin = IS::insert_bottom(_qualitieswin, qualities[s / 2] << 2);
+        } else {
+            _targetwin    = IS::insert_bottom(_targetwin, '0');
+            _qualitieswin = IS::insert_bottom(_qualitieswin, 64 << 2);
+        }
+
+        // S even
+
+        _m1 = IS::or_(_initmask2, IS::andnot(_initmask, _m1));
+        _m2 = IS::or_(_initmask2, IS::andnot(_initmask, _m2));
+        _m1 = IS::min(_m1, IS::min(_i1, _d1));
+
+        // Scores only grow along a path, so the minimum over the live states
+        // bounds any score still reachable; once that bound (and any final
+        // score seen so far) beats the ceiling the caller cannot use the
+        // result and the remaining diagonals are skipped
+        if (score_ceiling != std::numeric_limits<int>::max()
+            && s > 2 * bandSize && (s & (2 * bandSize - 1)) == 0) {
+            const auto bound = std::min(std::min(detail::horizontal_min<IS>(_m1),
+                                                 detail::horizontal_min<IS>(IS::min(_m2, IS::min(_i2, _d2)))),
+                                        minscore);
+            const auto bound_score = (bound + 0x8000) >> 2;
+            if (bound_score > score_ceiling) return bound_score;
+        }
+
+        if (s / 2 >= target_len) {
+            minscore = std::min(static_cast<short>(IS::extract(_m1, s / 2 - target_len)), minscore);
+        }
+
+        _snvmask = IS::cmpeq(_targetwin, _snvmaskwin);
+
+        _m1 = IS::add(_m1, IS::min(IS::andnot(IS::cmpeq(_targetwin, _truthwin),
+                                              IS::min(_qualitieswin,
+                                                      IS::or_(IS::and_(_snvmask, _snv_priorwin),
+                                                              IS::andnot(_snvmask, _qualitieswin)))),
+                                   _truthnqual));
+        _d1 = IS::min(IS::add(_d2, _gap_extend),
+                      IS::add(IS::min(_m2, _i2), IS::right_shift_word(_gap_open))); // allow I->D
+        _d1 = IS::insert_bottom(IS::left_shift_word(_d1), infinity);
+        _i1 = IS::add(IS::min(IS::add(_i2, _gap_extend), IS::add(_m2, _gap_open)), _nuc_prior);
+
+        // S odd
+        // truth needs updating; target is current
+        const auto pos = bandSize + s / 2;
+        const char base {pos < truth_len ? truth[pos] : 'N'};
+
+        _truthwin     = IS::insert_top(IS::right_shift_word(_truthwin), base);
+        _truthnqual   = IS::insert_top(IS::right_shift_word(_truthnqual), base == 'N' ? nScore : infinity);
+        _snvmaskwin   = IS::insert_top(IS::right_shift_word(_snvmaskwin), pos < truth_len ? snv_mask[pos] : 'N');
+        _snv_priorwin = IS::insert_top(IS::right_shift_word(_snv_priorwin),
+                                       (pos < truth_len ? snv_prior[pos] : infinity) << 2);
+        _gap_open     = IS::insert_top(IS::right_shift_word(_gap_open),
+                                       gap_open[pos < truth_len ? pos : truth_len - 1] << 2);
+
+        _initmask  = IS::left_shift_word(_initmask);
+        _initmask2 = IS::left_shift_word(_initmask2);
+
+        _m2 = IS::min(_m2, IS::min(_i2, _d2));
+
+        if (s / 2 >= target_len) {
+            minscore = std::min(static_cast<short>(IS::extract(_m2, s / 2 - target_len)), minscore);
+        }
+
+        _snvmask = IS::cmpeq(_targetwin, _snvmaskwin);
+
+        _m2 = IS::add(_m2, IS::min(IS::andnot(IS::cmpeq(_targetwin, _truthwin),
+                                              IS::min(_qualitieswin,
+                                                      IS::or_(IS::and_(_snvmask, _snv_priorwin),
+                                                              IS::andnot(_snvmask, _qualitieswin)))),
+                                   _truthnqual));
+        _d2 = IS::min(IS::add(_d1, _gap_extend),
+                      IS::add(IS::min(_m1, _i1), _gap_open)); // allow I->D
+        _i2 = IS::insert_top(IS::add(IS::min(IS::add(IS::right_shift_word(_i1), _gap_extend),
+                                             IS::add(IS::right_shift_word(_m1), _gap_open)),
+                                     _nuc_prior), infinity);
+    }
+
+    return (minscore + 0x8000) >> 2;
+}
+
+template <typename InstructionSet>
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          int& first_pos, char* aln1, char* aln2) noexcept
+{
+    using IS = InstructionSet;
+    using SimdInt = typename IS::VectorType;
+    constexpr int bandSize {IS::band_size};
+
+    // target is the read; the shorter of the sequences
+    // no checks for overflow are done
+
+    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
+    assert(aln1 != nullptr && aln2 != nullptr);
+
+    gap_extend <<= 2;
+    nuc_prior <<= 2;
+
+    constexpr int matchLabel  {0};
+    constexpr int insertLabel {1};
+    constexpr int deleteLabel {3};
+
+    SimdInt _m1 {IS::vectorise(infinity)};
+    auto _i1 = _m1;
+    auto _d1 = _m1;
+    auto _m2 = _m1;
+    auto _i2 = _m1;
+    auto _d2 = _m1;
+
+    const SimdInt _gap_extend {IS::vectorise(gap_extend)};
+    const SimdInt _nuc_prior  {IS::vectorise(nuc_prior)};
+    SimdInt _initmask  {IS::vectorise_zero_set_last(-1)};
+    SimdInt _initmask2 {IS::vectorise_zero_set_last(-0x8000)};
+
+    const SimdInt _three {IS::vectorise(3)};
+    SmallVector<SimdInt> _backpointers(2 * (truth_len + bandSize));
+
+    // sequence 1 is initialized with the band-long prefix, in forward direction
+    // sequence 2 is initialized as empty; reverse direction
+    SimdInt _truthwin  {IS::vectorise(truth)};
+    SimdInt _targetwin {_m1};
+    SimdInt _qualitieswin {IS::vectorise(64 << 2)};
+
+    SimdInt _truthnqual {detail::make_truth_nqual<IS>(_truthwin)};
+    SimdInt _gap_open   {detail::vectorise_penalties<IS>(gap_open)};
+
+    short cur_score {0}, minscore {infinity}, minscoreidx {-1};
+
+    // main loop.  Do one extra iteration, with nucs from sequence 2 just moved out
+    // of the targetwin/qual arrays, to simplify getting back pointers
+    int s;
+    for (s = 0; s <= 2 * (target_len + bandSize); s += 2) {
+        // truth is current; target needs updating
+        _targetwin    = IS::left_shift_word(_targetwin);
+        _qualitieswin = IS::left_shift_word(_qualitieswin);
+
+        if (s / 2 < target_len) {
+            _targetwin    = IS::insert_bottom(_targetwin, target[s / 2]);
+            _qualitieswin = IS::insert_bottom(_qualitieswin, qualities[s / 2] << 2);
+        } else {
+            _targetwin    = IS::insert_bottom(_targetwin, '0');
+            _qualitieswin = IS::insert_bottom(_qualitieswin, 64 << 2);
+        }
+
+        // S even
+        _m1 = IS::or_(_initmask2, IS::andnot(_initmask, _m1));
+        _m2 = IS::or_(_initmask2, IS::andnot(_initmask, _m2));
+        _m1 = IS::min(_m1, IS::min(_i1, _d1));
+
+        if (s / 2 >= target_len) {
+            cur_score = IS::extract(_m1, s / 2 - target_len);
+            if (cur_score < minscore) {
+                minscore = cur_score;
+                minscoreidx = s;     // point back to the match state at this entry, so as not to
+            }                        // have to store the state at s-2
+        }
+
+        _m1 = IS::add(_m1, IS::min(IS::andnot(IS::cmpeq(_targetwin, _truthwin), _qualitieswin), _truthnqual));
+        _d1 = IS::min(IS::add(_d2, _gap_extend),
+                      IS::add(IS::min(_m2, _i2), IS::right_shift_word(_gap_open))); // allow I->D
+        _d1 = IS::insert_bottom(IS::left_shift_word(_d1), infinity);
+        _i1 = IS::add(IS::min(IS::add(_i2, _gap_extend), IS::add(_m2, _gap_open)), _nuc_prior);
+
+        _backpointers[s] = IS::or_(IS::or_(IS::and_(_three, _m1),
+                                           IS::template left_shift_bits<2 * insertLabel>(IS::and_(_three, _i1))),
+                                   IS::template left_shift_bits<2 * deleteLabel>(IS::and_(_three, _d1)));
+
+        // set state labels
+        _m1 = IS::andnot(_three, _m1);
+        _i1 = IS::or_(IS::andnot(_three, _i1), IS::template right_shift_bits<1>(_three));
+        _d1 = IS::or_(IS::andnot(_three, _d1), _three);
+
+        // S odd
+
+        // truth needs updating; target is current
+        const char c {(bandSize + s / 2 < truth_len) ? truth[bandSize + (s / 2)] : 'N'};
+
+        _truthwin   = IS::insert_top(IS::right_shift_word(_truthwin), c);
+        _truthnqual = IS::insert_top(IS::right_shift_word(_truthnqual), (c == 'N') ? nScore : infinity);
+        _gap_open   = IS::insert_top(IS::right_shift_word(_gap_open),
+                                     gap_open[bandSize + s / 2 < truth_len ? bandSize + s / 2 : truth_len - 1] << 2);
+        _initmask  = IS::left_shift_word(_initmask);
+        _initmask2 = IS::left_shift_word(_initmask2);
+        _m2 = IS::min(_m2, IS::min(_i2, _d2));
+
+        // at this point, extract minimum score.  Referred-to position must
+        // be y==target_len-1, so that current position has y==target_len; i==0 so d=0 and y=s/2
+        if (s / 2 >= target_len) {
+            cur_score = IS::extract(_m2, s / 2 - target_len);
+            if (cur_score < minscore) {
+                minscore = cur_score;
+                minscoreidx = s + 1;
+            }
+        }
+
+        _m2 = IS::add(_m2, IS::min(IS::andnot(IS::cmpeq(_targetwin, _truthwin), _qualitieswin), _truthnqual));
+        _d2 = IS::min(IS::add(_d1, _gap_extend),
+                      IS::add(IS::min(_m1, _i1),  // allow I->D
+                              _gap_open));
+        _i2 = IS::insert_top(IS::add(IS::min(IS::add(IS::right_shift_word(_i1), _gap_extend),
+                                             IS::add(IS::right_shift_word(_m1), _gap_open)),
+                                     _nuc_prior), infinity);
+        _backpointers[s + 1] = IS::or_(IS::or_(IS::and_(_three, _m2),
+                                               IS::template left_shift_bits<2 * insertLabel>(IS::and_(_three, _i2))),
+                                       IS::template left_shift_bits<2 * deleteLabel>(IS::and_(_three, _d2)));
+
+        // set state labels
+        _m2 = IS::andnot(_three, _m2);
+        _i2 = IS::or_(IS::andnot(_three, _i2), IS::template right_shift_bits<1>(_three));
+        _d2 = IS::or_(IS::andnot(_three, _d2), _three);
+    }
+
+    s = minscoreidx;    // point to the dummy match transition
+
+    auto i      = s / 2 - target_len;
+    auto y      = target_len;
+    auto x      = s - y;
+    auto alnidx = 0;
+    auto state = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * matchLabel)) & 3;
+
+    s -= 2;
+
+    // this is 2*y (s even) or 2*y+1 (s odd)
+    while (y > 0) {
+        const auto new_state = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * state)) & 3;
+
+        if (state == matchLabel) {
+            s -= 2;
+            aln1[alnidx] = truth[--x];
+            aln2[alnidx] = target[--y];
+        } else if (state == insertLabel) {
+            i += s & 1;
+            s -= 1;
+            aln1[alnidx] = gapLabel;
+            aln2[alnidx] = target[--y];
+        } else {
+            s -= 1;
+            i -= s & 1;
+            aln1[alnidx] = truth[--x];
+            aln2[alnidx] = gapLabel;
+        }
+        state = new_state;
+        alnidx++;
+    }
+
+    aln1[alnidx] = 0;
+    aln2[alnidx] = 0;
+
+    first_pos = x;
+
+    // reverse them
+    for (int j {alnidx - 1}, i = 0; i < j; ++i, j--) {
+        x = aln1[i];
+        y = aln2[i];
+        aln1[i] = aln1[j];
+        aln2[i] = aln2[j];
+        aln1[j] = x;
+        aln2[j] = y;
+    }
+
+    return (minscore + 0x8000) >> 2;
+}
+
+template <typename InstructionSet>
+int align(const char* truth, const char* target, const std::int8_t* qualities,
+          const int truth_len, const int target_len,
+          const char* snv_mask, const std::int8_t* snv_prior,
+          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          char* aln1, char* aln2, int& first_pos) noexcept
+{
+    using IS = InstructionSet;
+    using SimdInt = typename IS::VectorType;
+    constexpr int bandSize {IS::band_size};
+
+    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
+    assert(aln1 != nullptr && aln2 != nullptr);
+
+    gap_extend <<= 2;
+    nuc_prior <<= 2;
+
+    constexpr int matchLabel  {0};
+    constexpr int insertLabel {1};
+    constexpr int deleteLabel {3};
+
+    SimdInt _m1 {IS::vectorise(infinity)};
+    auto _i1 = _m1;
+    auto _d1 = _m1;
+    auto _m2 = _m1;
+    auto _i2 = _m1;
+    auto _d2 = _m1;
+
+    const SimdInt _gap_extend {IS::vectorise(gap_extend)};
+    const SimdInt _nuc_prior  {IS::vectorise(nuc_prior)};
+    SimdInt _initmask  {IS::vectorise_zero_set_last(-1)};
+    SimdInt _initmask2 {IS::vectorise_zero_set_last(-0x8000)};
+
+    const SimdInt _three {IS::vectorise(3)};
+    SmallVector<SimdInt> _backpointers(2 * (truth_len + bandSize));
+
+    SimdInt _truthwin  {IS::vectorise(truth)};
+    SimdInt _targetwin {_m1};
+    SimdInt _qualitieswin {IS::vectorise(64 << 2)};
+
+    SimdInt _snvmaskwin   {IS::vectorise(snv_mask)};
+    SimdInt _snv_priorwin {detail::vectorise_penalties<IS>(snv_prior)};
+
+    SimdInt _snvmask;
+
+    SimdInt _truthnqual {detail::make_truth_nqual<IS>(_truthwin)};
+    SimdInt _gap_open   {detail::vectorise_penalties<IS>(gap_open)};
+
+    short cur_score {0}, minscore {infinity}, minscoreidx {-1};
+
+    int s;
+    for (s = 0; s <= 2 * (target_len + bandSize); s += 2) {
+        // truth is current; target needs updating
+        _targetwin    = IS::left_shift_word(_targetwin);
+        _qualitieswin = IS::left_shift_word(_qualitieswin);
+
+        if (s / 2 < target_len) {
+            _targetwin    = IS::insert_bottom(_targetwin, target[s / 2]);
+            _qualitieswin = IS::insert_bottom(_qualitieswin, qualities[s / 2] << 2);
+        } else {
+            _targetwin    = IS::insert_bottom(_targetwin, '0');
+            _qualitieswin = IS::insert_bottom(_qualitieswin, 64 << 2);
+        }
+
+        // S even
+
+        // initialize to -0x8000
+        _m1 = IS::or_(_initmask2, IS::andnot(_initmask, _m1));
+        _m2 = IS::or_(_initmask2, IS::andnot(_initmask, _m2));
+        _m1 = IS::min(_m1, IS::min(_i1, _d1));
+
+        // at this point, extract minimum score.  Referred-to position must
+        // be y==target_len-1, so that current position has y==target_len; i==0 so d=0 and y=s/2
+
+        if (s / 2 >= target_len) {
+            cur_score = IS::extract(_m1, s / 2 - target_len);
+            if (cur_score < minscore) {
+                minscore = cur_score;
+                minscoreidx = s;     // point back to the match state at this entry, so as not to
+            }                        // have to store the state at s-2
+        }
+
+        _snvmask = IS::cmpeq(_targetwin, _snvmaskwin);
+        _m1 = IS::add(_m1, IS::min(IS::andnot(IS::cmpeq(_targetwin, _truthwin),
+                                              IS::min(_qualitieswin,
+                                                      IS::or_(IS::and_(_snvmask, _snv_priorwin),
+                                                              IS::andnot(_snvmask, _qualitieswin)))),
+                                   _truthnqual));
+        _d1 = IS::min(IS::add(_d2, _gap_extend),
+                      IS::add(IS::min(_m2, _i2), IS::right_shift_word(_gap_open))); // allow I->D
+        _d1 = IS::insert_bottom(IS::left_shift_word(_d1), infinity);
+        _i1 = IS::add(IS::min(IS::add(_i2, _gap_extend), IS::add(_m2, _gap_open)), _nuc_prior);
+
+        _backpointers[s] = IS::or_(IS::or_(IS::and_(_three, _m1),
+                                           IS::template left_shift_bits<2 * insertLabel>(IS::and_(_three, _i1))),
+                                   IS::template left_shift_bits<2 * deleteLabel>(IS::and_(_three, _d1)));
+
+        // set state labels
+        _m1 = IS::andnot(_three, _m1);
+        _i1 = IS::or_(IS::andnot(_three, _i1), IS::template right_shift_bits<1>(_three));
+        _d1 = IS::or_(IS::andnot(_three, _d1), _three);
+
+        // S odd
+
+        // truth needs updating; target is current
+        const auto pos = bandSize + s / 2;
+        const char base {(pos < truth_len) ? truth[pos] : 'N'};
+
+        _truthwin     = IS::insert_top(IS::right_shift_word(_truthwin), base);
+        _truthnqual   = IS::insert_top(IS::right_shift_word(_truthnqual), (base == 'N') ? nScore : infinity);
+        _snvmaskwin   = IS::insert_top(IS::right_shift_word(_snvmaskwin), pos < truth_len ? snv_mask[pos] : 'N');
+        _snv_priorwin = IS::insert_top(IS::right_shift_word(_snv_priorwin),
+                                       (pos < truth_len ? snv_prior[pos] : infinity) << 2);
+        _gap_open     = IS::insert_top(IS::right_shift_word(_gap_open),
+                                       gap_open[pos < truth_len ? pos : truth_len - 1] << 2);
+
+        _initmask  = IS::left_shift_word(_initmask);
+        _initmask2 = IS::left_shift_word(_initmask2);
+
+        _m2 = IS::min(_m2, IS::min(_i2, _d2));
+
+        // at this point, extract minimum score.  Referred-to position must
+        // be y==target_len-1, so that current position has y==target_len; i==0 so d=0 and y=s/2
+        if (s / 2 >= target_len) {
+            cur_score = IS::extract(_m2, s / 2 - target_len);
+            if (cur_score < minscore) {
+                minscore = cur_score;
+                minscoreidx = s + 1;
+            }
+        }
+
+        _snvmask = IS::cmpeq(_targetwin, _snvmaskwin);
+
+        _m2 = IS::add(_m2, IS::min(IS::andnot(IS::cmpeq(_targetwin, _truthwin),
+                                              IS::min(_qualitieswin,
+                                                      IS::or_(IS::and_(_snvmask, _snv_priorwin),
+                                                              IS::andnot(_snvmask, _qualitieswin)))),
+                                   _truthnqual));
+        _d2 = IS::min(IS::add(_d1, _gap_extend),
+                      IS::add(IS::min(_m1, _i1),  // allow I->D
+                              _gap_open));
+        _i2 = IS::insert_top(IS::add(IS::min(IS::add(IS::right_shift_word(_i1), _gap_extend),
+                                             IS::add(IS::right_shift_word(_m1), _gap_open)),
+                                     _nuc_prior), infinity);
+        _backpointers[s + 1] = IS::or_(IS::or_(IS::and_(_three, _m2),
+                                               IS::template left_shift_bits<2 * insertLabel>(IS::and_(_three, _i2))),
+                                       IS::template left_shift_bits<2 * deleteLabel>(IS::and_(_three, _d2)));
+
+        // set state labels
+        _m2 = IS::andnot(_three, _m2);
+        _i2 = IS::or_(IS::andnot(_three, _i2), IS::template right_shift_bits<1>(_three));
+        _d2 = IS::or_(IS::andnot(_three, _d2), _three);
+    }
+
+    s = minscoreidx;    // point to the dummy match transition
+
+    auto i      = s / 2 - target_len;
+    auto y      = target_len;
+    auto x      = s - y;
+    auto alnidx = 0;
+    auto state  = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * matchLabel)) & 3;
+
+    s -= 2;
+
+    // this is 2*y (s even) or 2*y+1 (s odd)
+    while (y > 0) {
+        const auto new_state = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * state)) & 3;
+
+        if (state == matchLabel) {
+            s -= 2;
+            aln1[alnidx] = truth[--x];
+            aln2[alnidx] = target[--y];
+        } else if (state == insertLabel) {
+            i += s & 1;
+            s -= 1;
+            aln1[alnidx] = gapLabel;
+            aln2[alnidx] = target[--y];
+        } else {
+            s -= 1;
+            i -= s & 1;
+            aln1[alnidx] = truth[--x];
+            aln2[alnidx] = gapLabel;
+        }
+        state = new_state;
+        alnidx++;
+    }
+
+    aln1[alnidx] = 0;
+    aln2[alnidx] = 0;
+    first_pos = x;
+
+    // reverse them
+    for (int j {alnidx - 1}, i = 0; i < j; ++i, j--) {
+        x = aln1[i];
+        y = aln2[i];
+        aln1[i] = aln1[j];
+        aln2[i] = aln2[j];
+        aln1[j] = x;
+        aln2[j] = y;
+    }
+
+    return (minscore + 0x8000) >> 2;
+}
+
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
+
+#endif
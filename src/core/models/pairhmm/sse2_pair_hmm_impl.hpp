@@ -0,0 +1,104 @@
+// Copyright (c) 2015-2018 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef sse2_pair_hmm_impl_hpp
+#define sse2_pair_hmm_impl_hpp
+
+#if __GNUC__ >= 6
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+#include <emmintrin.h>
+
+namespace octopus { namespace hmm { namespace simd {
+
+struct SSE2InstructionSet
+{
+    using VectorType = __m128i;
+    using ScoreType  = short;
+
+    constexpr static int band_size = 8;
+
+    static VectorType vectorise(const ScoreType x) noexcept
+    {
+        return _mm_set1_epi16(x);
+    }
+    static VectorType vectorise(const char* sequence) noexcept
+    {
+        return _mm_set_epi16(sequence[7], sequence[6], sequence[5], sequence[4],
+                             sequence[3], sequence[2], sequence[1], sequence[0]);
+    }
+    static VectorType vectorise_zero_set_last(const ScoreType x) noexcept
+    {
+        return _mm_set_epi16(0,0,0,0,0,0,0,x);
+    }
+    static ScoreType extract(const VectorType a, const int n) noexcept
+    {
+        switch (n) {
+            case 0:  return _mm_extract_epi16(a, 0);
+            case 1:  return _mm_extract_epi16(a, 1);
+            case 2:  return _mm_extract_epi16(a, 2);
+            case 3:  return _mm_extract_epi16(a, 3);
+            case 4:  return _mm_extract_epi16(a, 4);
+            case 5:  return _mm_extract_epi16(a, 5);
+            case 6:  return _mm_extract_epi16(a, 6);
+            default: return _mm_extract_epi16(a, 7);
+        }
+    }
+    static VectorType insert_bottom(const VectorType a, const ScoreType x) noexcept
+    {
+        return _mm_insert_epi16(a, x, 0);
+    }
+    static VectorType insert_top(const VectorType a, const ScoreType x) noexcept
+    {
+        return _mm_insert_epi16(a, x, band_size - 1);
+    }
+    static VectorType add(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm_add_epi16(lhs, rhs);
+    }
+    static VectorType and_(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm_and_si128(lhs, rhs);
+    }
+    static VectorType andnot(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm_andnot_si128(lhs, rhs);
+    }
+    static VectorType or_(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm_or_si128(lhs, rhs);
+    }
+    static VectorType cmpeq(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm_cmpeq_epi16(lhs, rhs);
+    }
+    static VectorType min(const VectorType lhs, const VectorType rhs) noexcept
+    {
+        return _mm_min_epi16(lhs, rhs);
+    }
+    static VectorType left_shift_word(const VectorType a) noexcept
+    {
+        return _mm_slli_si128(a, 2);
+    }
+    static VectorType right_shift_word(const VectorType a) noexcept
+    {
+        return _mm_srli_si128(a, 2);
+    }
+    template <int n>
+    static VectorType left_shift_bits(const VectorType a) noexcept
+    {
+        return _mm_slli_epi16(a, n);
+    }
+    template <int n>
+    static VectorType right_shift_bits(const VectorType a) noexcept
+    {
+        return _mm_srli_epi16(a, n);
+    }
+};
+
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
+
+#endif
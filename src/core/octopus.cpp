@@ -8,11 +8,13 @@
 #include <queue>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <algorithm>
 #include <numeric>
 #include <memory>
 #include <functional>
 #include <cstddef>
+#include <cstdint>
 #include <typeinfo>
 #include <thread>
 #include <future>
@@ -21,9 +23,14 @@
 #include <atomic>
 #include <chrono>
 #include <sstream>
+#include <fstream>
 #include <iostream>
 #include <cassert>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include <boost/optional.hpp>
 
 #include "config/common.hpp"
@@ -49,6 +56,8 @@
 #include "core/tools/vcf_header_factory.hpp"
 #include "io/variant/vcf.hpp"
 #include "utils/timing.hpp"
+#include "utils/system_utils.hpp"
+#include "utils/memory_footprint.hpp"
 #include "exceptions/program_error.hpp"
 #include "csr/filters/variant_call_filter.hpp"
 #include "csr/filters/variant_call_filter_factory.hpp"
@@ -56,6 +65,7 @@
 #include "core/tools/bam_realigner.hpp"
 
 #include "timers.hpp" // BENCHMARK
+#include "allocation_profiler.hpp" // PROFILE_ALLOCATIONS
 
 namespace octopus {
 
@@ -224,14 +234,15 @@ void write_calls(std::deque<VcfRecord>&& calls, VcfWriter& out)
 }
 
 auto find_max_window(const ContigCallingComponents& components,
-                     const GenomicRegion& remaining_call_region)
+                     const GenomicRegion& remaining_call_region,
+                     boost::optional<std::size_t> read_budget = boost::none)
 {
     const auto& rm = components.read_manager.get();
     if (!rm.has_reads(components.samples.get(), remaining_call_region)) {
         return remaining_call_region;
     }
     auto result = rm.find_covered_subregion(components.samples, remaining_call_region,
-                                            components.read_buffer_size);
+                                            read_budget ? *read_budget : components.read_buffer_size);
     if (ends_before(result, remaining_call_region)) {
         auto rest = right_overhang_region(remaining_call_region, result);
         if (!rm.has_reads(components.samples.get(), rest)) {
@@ -243,12 +254,13 @@ auto find_max_window(const ContigCallingComponents& components,
 
 auto propose_call_subregion(const ContigCallingComponents& components,
                             const GenomicRegion& remaining_call_region,
-                            boost::optional<GenomicRegion::Size> min_size = boost::none)
+                            boost::optional<GenomicRegion::Size> min_size = boost::none,
+                            boost::optional<std::size_t> read_budget = boost::none)
 {
     if (is_empty(remaining_call_region)) {
         return remaining_call_region;
     }
-    const auto max_window = find_max_window(components, remaining_call_region);
+    const auto max_window = find_max_window(components, remaining_call_region, read_budget);
     if (ends_before(remaining_call_region, max_window)) {
         return remaining_call_region;
     }
@@ -264,38 +276,11 @@ auto propose_call_subregion(const ContigCallingComponents& components,
 auto propose_call_subregion(const ContigCallingComponents& components,
                             const GenomicRegion& current_subregion,
                             const GenomicRegion& input_region,
-                            boost::optional<GenomicRegion::Size> min_size = boost::none)
+                            boost::optional<GenomicRegion::Size> min_size = boost::none,
+                            boost::optional<std::size_t> read_budget = boost::none)
 {
     assert(contains(input_region, current_subregion));
-    return propose_call_subregion(components, right_overhang_region(input_region, current_subregion), min_size);
-}
-
-void buffer_connecting_calls(std::deque<VcfRecord>& calls,
-                             const GenomicRegion& next_calling_region,
-                             std::vector<VcfRecord>& buffer)
-{
-    const auto it = std::find_if(std::begin(calls), std::end(calls),
-                                 [&next_calling_region] (const auto& call) {
-                                     return mapped_end(call) > next_calling_region.begin();
-                                 });
-    buffer.insert(std::end(buffer),
-                  std::make_move_iterator(it),
-                  std::make_move_iterator(std::end(calls)));
-    calls.erase(it, std::end(calls));
-}
-
-void buffer_connecting_calls(const GenomicRegion& buffered_region,
-                             std::deque<VcfRecord>& calls,
-                             std::vector<VcfRecord>& buffer)
-{
-    const auto it = std::find_if_not(std::begin(calls), std::end(calls),
-                                     [&buffered_region] (const auto& call) {
-                                         return mapped_begin(call) < buffered_region.end();
-                                     });
-    buffer.insert(std::end(buffer),
-                  std::make_move_iterator(std::begin(calls)),
-                  std::make_move_iterator(it));
-    calls.erase(std::begin(calls), it);
+    return propose_call_subregion(components, right_overhang_region(input_region, current_subregion), min_size, read_budget);
 }
 
 bool is_consistent(const std::deque<VcfRecord>& merged_calls)
@@ -303,138 +288,149 @@ bool is_consistent(const std::deque<VcfRecord>& merged_calls)
     return true; // TODO
 }
 
-void resolve_connecting_calls(std::vector<VcfRecord>& old_connecting_calls,
-                              std::deque<VcfRecord>& calls,
-                              const ContigCallingComponents& components)
+using TempVcfWriterMap = std::unordered_map<ContigName, VcfWriter>;
+
+auto checkpoint_log_path(const GenomeCallingComponents& components)
 {
-    using std::begin; using std::end; using std::make_move_iterator;
-    
-    if (!old_connecting_calls.empty()) {
-        std::vector<VcfRecord> new_connecting_calls {};
-        const auto old_connecting_calls_region = encompassing_region(old_connecting_calls);
-        buffer_connecting_calls(old_connecting_calls_region, calls, new_connecting_calls);
-        std::deque<VcfRecord> merged_calls {};
-        std::set_union(begin(old_connecting_calls), end(old_connecting_calls),
-                       begin(new_connecting_calls), end(new_connecting_calls),
-                       std::back_inserter(merged_calls));
-        old_connecting_calls.clear();
-        old_connecting_calls.shrink_to_fit();
-        new_connecting_calls.clear();
-        new_connecting_calls.shrink_to_fit();
-        if (is_consistent(merged_calls)) {
-            calls.insert(begin(calls),
-                         make_move_iterator(begin(merged_calls)),
-                         make_move_iterator(end(merged_calls)));
-        } else {
-            const auto unresolved_region = encompassing_region(merged_calls);
-            merged_calls.clear();
-            merged_calls.shrink_to_fit();
-            auto new_calls = components.caller->call(unresolved_region, components.progress_meter);
-            // TODO: we need to make sure the new calls don't contain any calls
-            // outside the unresolved_region, and also possibly adjust phase regions
-            // in calls past unresolved_region.
-            calls.insert(begin(calls),
-                         make_move_iterator(begin(new_calls)),
-                         make_move_iterator(end(new_calls)));
-        }
-    }
+    assert(components.temp_directory());
+    return *components.temp_directory() / "octopus-checkpoint.log";
 }
 
-void run_octopus_on_contig(ContigCallingComponents&& components)
+// Completed tasks are written to per-contig segment files that are periodically
+// closed and recorded in a checkpoint log; only closed segments are durable, so
+// a resumed run can trust every region the log mentions
+struct TempVcfSegments
 {
-    // TODO: refactor to use connection resolution developed for multithreaded version
-    static auto debug_log = get_debug_log();
-    
-    assert(!components.regions.empty());
-    
-    std::deque<VcfRecord> calls;
-    std::vector<VcfRecord> connecting_calls {};
-    auto input_region = components.regions.front();
-    auto subregion    = propose_call_subregion(components, input_region);
-    auto first_input_region      = std::cbegin(components.regions);
-    const auto last_input_region = std::cend(components.regions);
-    
-    while (first_input_region != last_input_region && !is_empty(subregion)) {
-        if (debug_log) stream(*debug_log) << "Processing subregion " << subregion;
-        
-        try {
-            calls = components.caller->call(subregion, components.progress_meter);
-        } catch(...) {
-            // TODO: which exceptions can we recover from?
-            throw;
-        }
-        resolve_connecting_calls(connecting_calls, calls, components);
-        
-        auto next_subregion = propose_call_subregion(components, subregion, input_region);
-        
-        if (is_empty(next_subregion)) {
-            ++first_input_region;
-            if (first_input_region != last_input_region) {
-                input_region = *first_input_region;
-                next_subregion = propose_call_subregion(components, input_region);
-            }
-        }
-        assert(connecting_calls.empty());
-        
-        buffer_connecting_calls(calls, next_subregion, connecting_calls);
-        try {
-            write_calls(std::move(calls), components.output);
-        } catch(...) {
-            // TODO: which exceptions can we recover from?
-            throw;
-        }
-        subregion = std::move(next_subregion);
-    }
-}
+    std::reference_wrapper<const GenomeCallingComponents> components;
+    TempVcfWriterMap open_segments;
+    std::unordered_map<ContigName, unsigned> segment_counters;
+    std::unordered_map<ContigName, std::vector<GenomicRegion>> pending_regions;
+    std::unordered_map<ContigName, std::chrono::system_clock::time_point> segment_open_times;
+    std::vector<GenomeCallingComponents::Path> closed_segment_paths;
+    std::ofstream checkpoint_log;
+};
 
-void run_octopus_single_threaded(GenomeCallingComponents& components)
+TempVcfSegments make_temp_vcf_segments(const GenomeCallingComponents& components)
 {
-    #ifdef BENCHMARK
-    init_timers();
-    #endif
-    components.progress_meter().start();
-    for (const auto& contig : components.contigs()) {
-        run_octopus_on_contig(ContigCallingComponents {contig, components});
+    if (!components.temp_directory()) {
+        throw std::runtime_error {"Could not make temp writers"};
     }
-    components.progress_meter().stop();
-    #ifdef BENCHMARK
-        print_all_timers();
-    #endif
+    TempVcfSegments result {std::ref(components), {}, {}, {}, {}, {}, {}};
+    result.checkpoint_log.open(checkpoint_log_path(components).string(), std::ios_base::app);
+    return result;
 }
 
-VcfWriter create_unique_temp_output_file(const GenomicRegion& region,
-                                         const GenomeCallingComponents& components)
+VcfWriter& segment_writer(TempVcfSegments& segments, const ContigName& contig)
 {
+    const auto itr = segments.open_segments.find(contig);
+    if (itr != std::end(segments.open_segments)) return itr->second;
+    const auto& components = segments.components.get();
+    auto& segment_number = segments.segment_counters[contig];
     auto path = *components.temp_directory();
-    const auto& contig = region.contig_name();
-    const auto begin   = std::to_string(region.begin());
-    const auto end     = std::to_string(region.end());
-    boost::filesystem::path file_name {contig + "_" + begin + "-" + end + "_temp.bcf"};
-    path /= file_name;
-    const auto call_types = get_call_types(components, {region.contig_name()});
+    path /= boost::filesystem::path {contig + "_seg-" + std::to_string(segment_number) + "_temp.bcf"};
+    while (boost::filesystem::exists(path)) {
+        ++segment_number;
+        path = *components.temp_directory();
+        path /= boost::filesystem::path {contig + "_seg-" + std::to_string(segment_number) + "_temp.bcf"};
+    }
+    const auto call_types = get_call_types(components, {contig});
     auto header = make_vcf_header(components.samples(), contig, components.reference(), call_types,
                                   "octopus-internal");
-    return VcfWriter {std::move(path), std::move(header)};
-}
-
-VcfWriter create_unique_temp_output_file(const GenomicRegion::ContigName& contig,
-                                         const GenomeCallingComponents& components)
-{
-    return create_unique_temp_output_file(components.reference().contig_region(contig),
-                                          components);
+    // Temp segments are written as uncompressed BCF; they only ever feed the
+    // intra-run merge, so BGZF and index building would be wasted work
+    auto p = segments.open_segments.emplace(contig, VcfWriter {std::move(path), std::move(header),
+                                                               VcfWriter::Compression::none});
+    segments.segment_open_times[contig] = std::chrono::system_clock::now();
+    return p.first->second;
+}
+
+void checkpoint_segment(TempVcfSegments& segments, const ContigName& contig)
+{
+    const auto itr = segments.open_segments.find(contig);
+    if (itr == std::end(segments.open_segments)) return;
+    const auto path = itr->second.path();
+    itr->second.close();
+    segments.open_segments.erase(itr);
+    assert(path);
+    for (const auto& region : segments.pending_regions[contig]) {
+        segments.checkpoint_log << path->filename().string() << '\t' << region.contig_name()
+                                << '\t' << region.begin() << '\t' << region.end() << '\n';
+    }
+    segments.checkpoint_log.flush();
+    segments.pending_regions.erase(contig);
+    segments.segment_open_times.erase(contig);
+    segments.closed_segment_paths.push_back(*path);
+    ++segments.segment_counters[contig];
+}
+
+void checkpoint_stale_segments(TempVcfSegments& segments)
+{
+    // Closing a segment bounds the work a preemption can lose to roughly this period
+    static constexpr std::chrono::minutes maxSegmentAge {5};
+    const auto now = std::chrono::system_clock::now();
+    std::vector<ContigName> stale {};
+    for (const auto& p : segments.segment_open_times) {
+        if (now - p.second >= maxSegmentAge) stale.push_back(p.first);
+    }
+    for (const auto& contig : stale) checkpoint_segment(segments, contig);
+}
+
+void checkpoint_all_segments(TempVcfSegments& segments)
+{
+    std::vector<ContigName> open_contigs {};
+    open_contigs.reserve(segments.open_segments.size());
+    for (const auto& p : segments.open_segments) open_contigs.push_back(p.first);
+    for (const auto& contig : open_contigs) checkpoint_segment(segments, contig);
+}
+
+using CompletedRegionMap = std::map<ContigName, std::vector<GenomicRegion>>;
+
+auto load_checkpoint(const GenomeCallingComponents& components)
+{
+    std::pair<CompletedRegionMap, std::vector<GenomeCallingComponents::Path>> result {};
+    const auto log_path = checkpoint_log_path(components);
+    if (!boost::filesystem::exists(log_path)) return result;
+    std::ifstream log {log_path.string()};
+    std::string filename, contig;
+    GenomicRegion::Position begin, end;
+    std::set<std::string> seen_segments {};
+    while (log >> filename >> contig >> begin >> end) {
+        auto segment_path = *components.temp_directory() / filename;
+        // Only trust regions whose closed segment file survived the interruption
+        if (boost::filesystem::exists(segment_path)) {
+            if (seen_segments.insert(filename).second) {
+                result.second.push_back(std::move(segment_path));
+            }
+            result.first[contig].emplace_back(contig, begin, end);
+        }
+    }
+    for (auto& p : result.first) {
+        std::sort(std::begin(p.second), std::end(p.second));
+    }
+    return result;
 }
 
-using TempVcfWriterMap = std::unordered_map<ContigName, VcfWriter>;
-
-TempVcfWriterMap make_temp_vcf_writers(const GenomeCallingComponents& components)
+auto remove_completed_regions(const InputRegionMap::mapped_type& regions, const std::vector<GenomicRegion>& completed)
 {
-    if (!components.temp_directory()) {
-        throw std::runtime_error {"Could not make temp writers"};
-    }
-    TempVcfWriterMap result {};
-    result.reserve(components.contigs().size());
-    for (const auto& contig : components.contigs()) {
-        result.emplace(contig, create_unique_temp_output_file(contig, components));
+    std::vector<GenomicRegion> result {};
+    result.reserve(regions.size());
+    for (const auto& region : regions) {
+        auto remainder = region;
+        bool consumed {false};
+        for (const auto& done : completed) {
+            if (overlaps(remainder, done)) {
+                if (begins_before(remainder, done)) {
+                    result.push_back(left_overhang_region(remainder, done));
+                }
+                if (ends_before(done, remainder)) {
+                    remainder = right_overhang_region(remainder, done);
+                } else {
+                    consumed = true;
+                    break;
+                }
+            }
+        }
+        if (!consumed && !is_empty(remainder)) result.push_back(remainder);
     }
     return result;
 }
@@ -492,7 +488,10 @@ auto count_tasks(const TaskMap& tasks) noexcept
 
 struct TaskMakerSyncPacket
 {
-    TaskMakerSyncPacket() : batch_size_hint {1}, waiting {true}, num_tasks {0}, finished {}, all_done {false} {}
+    TaskMakerSyncPacket()
+    : batch_size_hint {1}, waiting {true}, num_tasks {0}, finished {}, all_done {false}
+    , num_completed_tasks {0}, total_task_time_ms {0}, last_task_time_ms {0}
+    , baseline_rss_bytes {0} {}
     std::condition_variable cv;
     std::mutex mutex;
     bool ready = true;
@@ -501,14 +500,72 @@ struct TaskMakerSyncPacket
     std::atomic_uint num_tasks;
     std::unordered_map<ContigName, bool> finished;
     std::atomic_bool all_done;
+    // Wall time feedback from completed tasks, written by the runner and read
+    // by the task maker to shrink task spans in expensive neighbourhoods
+    std::atomic<std::uint64_t> num_completed_tasks;
+    std::atomic<std::uint64_t> total_task_time_ms;
+    std::atomic<std::uint64_t> last_task_time_ms;
+    // RSS observed before the first task was proposed; reference sequence,
+    // buffered reads, and other fixed state. Set once by the task maker
+    std::atomic<std::uint64_t> baseline_rss_bytes;
 };
 
+static constexpr std::size_t minTaskReadBudget {1'000};
+
+std::size_t scale_read_budget_for_memory_pressure(std::size_t read_budget,
+                                                  const ContigCallingComponents& components,
+                                                  TaskMakerSyncPacket& sync)
+{
+    // Read count is only a proxy for memory; the haplotype trees and likelihood
+    // matrices built over the buffered reads dominate the real footprint and vary
+    // wildly between regions. Feed the observed RSS back into the task read budget
+    // so the process converges towards the requested buffer footprint rather than
+    // needing worst case provisioning.
+    const auto rss = get_current_resident_set_size();
+    if (!rss) return read_budget; // platform doesn't expose RSS
+    auto baseline = sync.baseline_rss_bytes.load();
+    if (baseline == 0) {
+        sync.baseline_rss_bytes.compare_exchange_strong(baseline, rss->num_bytes());
+        return read_budget;
+    }
+    const auto target_growth = components.target_read_buffer_footprint.num_bytes();
+    if (target_growth == 0 || rss->num_bytes() <= baseline) return read_budget;
+    const auto growth = rss->num_bytes() - baseline;
+    if (growth > target_growth) {
+        // Proportional control: shrink the budget by the overshoot so subsequent
+        // tasks pull the footprint back towards target
+        read_budget = std::max(static_cast<std::size_t>(read_budget * (static_cast<double>(target_growth) / growth)),
+                               minTaskReadBudget);
+    }
+    return read_budget;
+}
+
+std::size_t propose_task_read_budget(const ContigCallingComponents& components, TaskMakerSyncPacket& sync)
+{
+    // Tasks are bounded by read count, which tracks depth but not cost per read;
+    // dense pileups can be orders of magnitude slower per read than quiet regions.
+    // Halve the budget for each doubling of the last completed task's wall time
+    // over the run mean, so stragglers get subdivided rather than repeated.
+    auto result = components.read_buffer_size;
+    const auto num_completed = sync.num_completed_tasks.load();
+    if (num_completed > 0) {
+        const auto mean_task_time_ms = sync.total_task_time_ms.load() / num_completed;
+        auto last_task_time_ms = sync.last_task_time_ms.load();
+        while (mean_task_time_ms > 0 && last_task_time_ms > 2 * mean_task_time_ms
+               && result / 2 >= minTaskReadBudget) {
+            result /= 2;
+            last_task_time_ms /= 2;
+        }
+    }
+    return scale_read_budget_for_memory_pressure(result, components, sync);
+}
+
 void make_region_tasks(const GenomicRegion& region, const ContigCallingComponents& components, const ExecutionPolicy policy,
                        TaskQueue& result, TaskMakerSyncPacket& sync, const bool last_region_in_contig, const bool last_contig)
 {
     static constexpr GenomicRegion::Size minTaskSize {5'000};
     std::unique_lock<std::mutex> lock {sync.mutex, std::defer_lock};
-    auto subregion = propose_call_subregion(components, region, minTaskSize);
+    auto subregion = propose_call_subregion(components, region, minTaskSize, propose_task_read_budget(components, sync));
     if (ends_equal(subregion, region)) {
         lock.lock();
         sync.cv.wait(lock, [&] () { return sync.ready; });
@@ -526,7 +583,8 @@ void make_region_tasks(const GenomicRegion& region, const ContigCallingComponent
         bool done {false};
         while (true) {
             while (batch.size() < std::max(sync.batch_size_hint.load(), 1u) || !sync.waiting) {
-                subregion = propose_call_subregion(components, subregion, region, minTaskSize);
+                subregion = propose_call_subregion(components, subregion, region, minTaskSize,
+                                                   propose_task_read_budget(components, sync));
                 batch.push_back(subregion);
                 assert(!ends_before(region, subregion));
                 if (ends_equal(subregion, region)) {
@@ -559,14 +617,14 @@ void make_region_tasks(const GenomicRegion& region, const ContigCallingComponent
     }
 }
 
-void make_contig_tasks(const ContigCallingComponents& components, const ExecutionPolicy policy,
-                       TaskQueue& result, TaskMakerSyncPacket& sync, const bool last_contig)
+void make_contig_tasks(const ContigCallingComponents& components, const std::vector<GenomicRegion>& regions,
+                       const ExecutionPolicy policy, TaskQueue& result, TaskMakerSyncPacket& sync, const bool last_contig)
 {
-    if (components.regions.empty()) return;
-    std::for_each(std::cbegin(components.regions), std::prev(std::cend(components.regions)), [&] (const auto& region) {
+    if (regions.empty()) return;
+    std::for_each(std::cbegin(regions), std::prev(std::cend(regions)), [&] (const auto& region) {
         make_region_tasks(region, components, policy, result, sync, false, last_contig);
     });
-    make_region_tasks(components.regions.back(), components, policy, result, sync, true, last_contig);
+    make_region_tasks(regions.back(), components, policy, result, sync, true, last_contig);
 }
 
 ExecutionPolicy make_execution_policy(const GenomeCallingComponents& components)
@@ -584,7 +642,8 @@ auto make_contig_components(const ContigName& contig, GenomeCallingComponents& c
     return result;
 }
 
-void make_tasks_helper(TaskMap& tasks, std::vector<ContigName> contigs, GenomeCallingComponents& components,
+void make_tasks_helper(TaskMap& tasks, std::vector<ContigName> contigs, CompletedRegionMap completed_regions,
+                       GenomeCallingComponents& components,
                        const unsigned num_threads, ExecutionPolicy execution_policy, TaskMakerSyncPacket& sync)
 {
     try {
@@ -592,9 +651,25 @@ void make_tasks_helper(TaskMap& tasks, std::vector<ContigName> contigs, GenomeCa
         if (debug_log) stream(*debug_log) << "Making tasks for " << contigs.size() << " contigs";
         for (std::size_t i {0}; i < contigs.size(); ++i) {
             const auto& contig = contigs[i];
+            const bool last_contig {i == contigs.size() - 1};
             if (debug_log) stream(*debug_log) << "Making tasks for contig " << contig;
             auto contig_components = make_contig_components(contig, components, num_threads);
-            make_contig_tasks(contig_components, execution_policy, tasks[contig], sync, i == contigs.size() - 1);
+            std::vector<GenomicRegion> call_regions {std::cbegin(contig_components.regions), std::cend(contig_components.regions)};
+            const auto completed_itr = completed_regions.find(contig);
+            if (completed_itr != std::cend(completed_regions)) {
+                call_regions = remove_completed_regions(contig_components.regions, completed_itr->second);
+            }
+            if (call_regions.empty()) {
+                // Everything in this contig was checkpointed by the interrupted run
+                std::unique_lock<std::mutex> lock {sync.mutex};
+                sync.cv.wait(lock, [&] () { return sync.ready; });
+                sync.finished.at(contig) = true;
+                if (last_contig) sync.all_done = true;
+                lock.unlock();
+                sync.cv.notify_one();
+            } else {
+                make_contig_tasks(contig_components, call_regions, execution_policy, tasks[contig], sync, last_contig);
+            }
             if (debug_log) stream(*debug_log) << "Finished making tasks for contig " << contig;
         }
         if (debug_log) *debug_log << "Finished making tasks";
@@ -615,10 +690,9 @@ void make_tasks_helper(TaskMap& tasks, std::vector<ContigName> contigs, GenomeCa
     }
 }
 
-std::thread make_task_maker_thread(TaskMap& tasks, GenomeCallingComponents& components, const unsigned num_threads,
-                                   TaskMakerSyncPacket& sync)
+std::thread make_task_maker_thread(TaskMap& tasks, GenomeCallingComponents& components, std::vector<ContigName> contigs,
+                                   const unsigned num_threads, CompletedRegionMap completed_regions, TaskMakerSyncPacket& sync)
 {
-    auto contigs = components.contigs();
     if (contigs.empty()) {
         sync.all_done = true;
         return std::thread {};
@@ -627,8 +701,8 @@ std::thread make_task_maker_thread(TaskMap& tasks, GenomeCallingComponents& comp
     for (const auto& contig : contigs) {
         sync.finished.emplace(contig, false);
     }
-    return std::thread {make_tasks_helper, std::ref(tasks), std::move(contigs), std::ref(components),
-                        num_threads, make_execution_policy(components), std::ref(sync)};
+    return std::thread {make_tasks_helper, std::ref(tasks), std::move(contigs), std::move(completed_regions),
+                        std::ref(components), num_threads, make_execution_policy(components), std::ref(sync)};
 }
 
 void log_num_cores(const unsigned num_cores)
@@ -660,6 +734,101 @@ unsigned calculate_num_task_threads(const GenomeCallingComponents& components)
     }
 }
 
+using NumaNodeCpuSet    = std::vector<unsigned>;
+using NumaNodeCpuSets   = std::vector<NumaNodeCpuSet>;
+using ContigNumaNodeMap = std::unordered_map<ContigName, NumaNodeCpuSet>;
+
+NumaNodeCpuSets read_numa_node_cpu_sets()
+{
+    NumaNodeCpuSets result {};
+#if defined(__linux__)
+    for (unsigned node {0}; ; ++node) {
+        std::ifstream cpulist {"/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"};
+        if (!cpulist) break;
+        NumaNodeCpuSet cpus {};
+        std::string token {};
+        while (std::getline(cpulist, token, ',')) {
+            const auto dash_pos = token.find('-');
+            if (dash_pos == std::string::npos) {
+                cpus.push_back(static_cast<unsigned>(std::stoul(token)));
+            } else {
+                const auto first = static_cast<unsigned>(std::stoul(token.substr(0, dash_pos)));
+                const auto last  = static_cast<unsigned>(std::stoul(token.substr(dash_pos + 1)));
+                for (auto cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+        if (!cpus.empty()) result.push_back(std::move(cpus));
+    }
+#endif
+    return result;
+}
+
+void pin_current_thread(const NumaNodeCpuSet& cpus) noexcept
+{
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (const auto cpu : cpus) {
+        CPU_SET(cpu, &cpu_set);
+    }
+    sched_setaffinity(0, sizeof(cpu_set_t), &cpu_set);
+#endif
+}
+
+ContigNumaNodeMap assign_contigs_to_numa_nodes(const std::vector<ContigName>& contigs)
+{
+    static auto debug_log = get_debug_log();
+    ContigNumaNodeMap result {};
+    auto node_cpu_sets = read_numa_node_cpu_sets();
+    if (node_cpu_sets.size() > 1) {
+        // Each contig - and therefore every task spawned for it - sticks to one
+        // node, so a task's read buffer and caches are first touched, and stay,
+        // in node local memory
+        result.reserve(contigs.size());
+        std::size_t next_node {0};
+        for (const auto& contig : contigs) {
+            result.emplace(contig, node_cpu_sets[next_node++ % node_cpu_sets.size()]);
+        }
+        if (debug_log) stream(*debug_log) << "Assigned " << contigs.size() << " contigs to "
+                                          << node_cpu_sets.size() << " NUMA nodes";
+    } else {
+        logging::WarningLogger warn_log {};
+        warn_log << "NUMA aware mode was requested but no NUMA topology was detected - ignoring";
+    }
+    return result;
+}
+
+using ContigJobMap = std::unordered_map<ContigName, unsigned>;
+
+ContigJobMap assign_contigs_to_distributed_jobs(const std::vector<ContigName>& contigs,
+                                                const ReferenceGenome& reference,
+                                                const unsigned num_jobs)
+{
+    // Longest-processing-time assignment over contig sizes; deterministic
+    // given the reference, so every job computes the same partition without
+    // any communication. Stitching never crosses contigs, so contig grained
+    // shards keep phasing at shard edges exact
+    auto sorted_contigs = contigs;
+    std::sort(std::begin(sorted_contigs), std::end(sorted_contigs),
+              [&reference] (const auto& lhs, const auto& rhs) {
+                  const auto lhs_size = reference.contig_size(lhs);
+                  const auto rhs_size = reference.contig_size(rhs);
+                  return lhs_size == rhs_size ? lhs < rhs : lhs_size > rhs_size;
+              });
+    ContigJobMap result {};
+    result.reserve(contigs.size());
+    std::vector<std::uint64_t> job_loads(num_jobs, 0);
+    for (const auto& contig : sorted_contigs) {
+        const auto min_load_itr = std::min_element(std::cbegin(job_loads), std::cend(job_loads));
+        const auto job = static_cast<unsigned>(std::distance(std::cbegin(job_loads), min_load_itr));
+        result.emplace(contig, job);
+        job_loads[job] += reference.contig_size(contig);
+    }
+    return result;
+}
+
 Task pop(TaskMap& tasks, TaskMakerSyncPacket& sync)
 {
     assert(!tasks.empty());
@@ -716,12 +885,16 @@ bool is_ready(const std::future<R>& f)
     return f.valid() && f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
 }
 
-auto run(Task task, ContigCallingComponents components, CallerSyncPacket& sync)
+auto run(Task task, ContigCallingComponents components, CallerSyncPacket& sync,
+         const NumaNodeCpuSet* numa_cpus = nullptr)
 {
     static auto debug_log = get_debug_log();
     if (debug_log) stream(*debug_log) << "Spawning task " << task;
-    return std::async(std::launch::async, [task = std::move(task), components = std::move(components), &sync] () {
+    return std::async(std::launch::async, [task = std::move(task), components = std::move(components), &sync, numa_cpus] () {
         try {
+            // Pin before any calling work so the task's buffers are first
+            // touched on, and therefore allocated from, the assigned node
+            if (numa_cpus) pin_current_thread(*numa_cpus);
             CompletedTask result {task};
             result.runtime.start = std::chrono::system_clock::now();
             result.calls = components.caller->call(task.region, components.progress_meter);
@@ -867,28 +1040,109 @@ void resolve_connecting_calls(std::deque<CompletedTask>& adjacent_tasks,
                   [&] (auto& rhs) { resolve_connecting_calls(*lhs++, rhs, calling_components); });
 }
 
+void run_octopus_on_contig(ContigCallingComponents&& components, const ContigCallingComponentFactory& calling_components)
+{
+    static auto debug_log = get_debug_log();
+    assert(!components.regions.empty());
+    boost::optional<CompletedTask> buffered_task {};
+    auto input_region = components.regions.front();
+    auto subregion    = propose_call_subregion(components, input_region);
+    auto first_input_region      = std::cbegin(components.regions);
+    const auto last_input_region = std::cend(components.regions);
+    boost::optional<Caller::CallingPrelude> prelude {};
+    if (first_input_region != last_input_region && !is_empty(subregion)) {
+        prelude.emplace(components.caller->prepare_to_call(subregion));
+    }
+    while (first_input_region != last_input_region && !is_empty(subregion)) {
+        if (debug_log) stream(*debug_log) << "Processing subregion " << subregion;
+        // The next subregion proposal depends only on read counts, not on this
+        // subregion's calls, so it can be made now and its prelude (read fetch
+        // and candidate generation) prepared on a second thread while this
+        // subregion's model is fitted. One prelude in flight bounds the extra
+        // read buffering to a single window
+        auto next_subregion = propose_call_subregion(components, subregion, input_region);
+        if (is_empty(next_subregion)) {
+            ++first_input_region;
+            if (first_input_region != last_input_region) {
+                input_region = *first_input_region;
+                next_subregion = propose_call_subregion(components, input_region);
+            }
+        }
+        std::future<Caller::CallingPrelude> next_prelude {};
+        if (first_input_region != last_input_region && !is_empty(next_subregion)) {
+            next_prelude = std::async(std::launch::async, [&components, next_subregion] () {
+                return components.caller->prepare_to_call(next_subregion);
+            });
+        }
+        CompletedTask task {Task {subregion}};
+        task.runtime.start = std::chrono::system_clock::now();
+        task.calls = components.caller->call(std::move(*prelude), components.progress_meter);
+        task.runtime.end = std::chrono::system_clock::now();
+        if (next_prelude.valid()) {
+            prelude.emplace(next_prelude.get());
+            // The prelude's clock started while this subregion was still being
+            // called; restart it so the replay bundle threshold only sees time
+            // spent on its own subregion
+            prelude->start_time = std::chrono::steady_clock::now();
+        }
+        if (buffered_task) {
+            resolve_connecting_calls(*buffered_task, task, calling_components);
+            write_calls(std::move(buffered_task->calls), components.output);
+        }
+        // Keep the last task buffered to enable connection resolution with the next one
+        buffered_task = std::move(task);
+        subregion = std::move(next_subregion);
+    }
+    if (buffered_task) {
+        write_calls(std::move(buffered_task->calls), components.output);
+    }
+}
+
+void run_octopus_single_threaded(GenomeCallingComponents& components)
+{
+    #ifdef BENCHMARK
+    init_timers();
+    #endif
+    components.progress_meter().start();
+    for (const auto& contig : components.contigs()) {
+        const auto calling_components = [&components, contig] () -> ContigCallingComponents
+                                        { return ContigCallingComponents {contig, components}; };
+        run_octopus_on_contig(ContigCallingComponents {contig, components}, calling_components);
+    }
+    components.progress_meter().stop();
+    #ifdef BENCHMARK
+        print_all_timers();
+    #endif
+}
+
 struct TaskWriterSyncPacket
 {
     std::condition_variable cv;
     std::mutex mutex;
     std::deque<CompletedTask> tasks = {};
+    // Bounds the handoff queue so call buffers cannot pile up without limit
+    // when bgzf compression falls behind the callers
+    std::size_t max_buffered_tasks = 128;
     bool done = false;
 };
 
-void write(std::deque<CompletedTask>& tasks, TempVcfWriterMap& writers)
+void write(std::deque<CompletedTask>& tasks, TempVcfSegments& segments)
 {
     static auto debug_log = get_debug_log();
     for (auto&& task : tasks) {
         if (debug_log) {
             stream(*debug_log) << "Writing completed task " << task << " that finished in " << duration(task);
         }
-        auto& writer = writers.at(contig_name(task));
+        const auto& contig = contig_name(task);
+        auto& writer = segment_writer(segments, contig);
+        segments.pending_regions[contig].push_back(task.region);
         write_calls(std::move(task.calls), writer);
     }
     tasks.clear();
+    checkpoint_stale_segments(segments);
 }
 
-void write_temp_vcf_helper(TempVcfWriterMap& writers, TaskWriterSyncPacket& sync)
+void write_temp_vcf_helper(TempVcfSegments& writers, TaskWriterSyncPacket& sync)
 {
     try {
         std::unique_lock<std::mutex> lock {sync.mutex, std::defer_lock};
@@ -921,23 +1175,27 @@ void write_temp_vcf_helper(TempVcfWriterMap& writers, TaskWriterSyncPacket& sync
     }
 }
 
-std::thread make_task_writer_thread(TempVcfWriterMap& temp_writers, TaskWriterSyncPacket& writer_sync)
+std::thread make_task_writer_thread(TempVcfSegments& temp_writers, TaskWriterSyncPacket& writer_sync)
 {
     return std::thread {write_temp_vcf_helper, std::ref(temp_writers), std::ref(writer_sync)};
 }
 
-void write(std::deque<CompletedTask>&& tasks, VcfWriter& temp_vcf)
+void write(std::deque<CompletedTask>&& tasks, TempVcfSegments& segments, const ContigName& contig)
 {
     static auto debug_log = get_debug_log();
     for (auto&& task : tasks) {
         if (debug_log) stream(*debug_log) << "Writing completed task " << task << " that finished in " << duration(task);
-        write_calls(std::move(task.calls), temp_vcf);
+        segments.pending_regions[contig].push_back(task.region);
+        write_calls(std::move(task.calls), segment_writer(segments, contig));
     }
 }
 
 void write(std::deque<CompletedTask>&& tasks, TaskWriterSyncPacket& sync)
 {
     std::unique_lock<std::mutex> lock {sync.mutex};
+    // Only the scheduling thread ever waits here, and never while the writer
+    // holds tasks, so the shared condition variable cannot be starved
+    sync.cv.wait(lock, [&] () { return sync.tasks.size() < sync.max_buffered_tasks; });
     utils::append(std::move(tasks), sync.tasks);
     lock.unlock();
     sync.cv.notify_one();
@@ -1029,14 +1287,14 @@ void resolve_connecting_calls(RemainingTaskMap& remaining_tasks,
     }
 }
 
-void write(RemainingTaskMap&& remaining_tasks, TempVcfWriterMap& temp_vcfs)
+void write(RemainingTaskMap&& remaining_tasks, TempVcfSegments& temp_vcfs)
 {
     for (auto& p : remaining_tasks) {
-        write(std::move(p.second), temp_vcfs.at(p.first));
+        write(std::move(p.second), temp_vcfs, p.first);
     }
 }
 
-void write_remaining_tasks(FutureCompletedTasks& futures, CompletedTaskMap& buffered_tasks, TempVcfWriterMap& temp_vcfs,
+void write_remaining_tasks(FutureCompletedTasks& futures, CompletedTaskMap& buffered_tasks, TempVcfSegments& temp_vcfs,
                            const ContigCallingComponentFactoryMap& calling_components)
 {
     static auto debug_log = get_debug_log();
@@ -1057,19 +1315,72 @@ auto extract_writers(TempVcfWriterMap&& vcfs)
     return result;
 }
 
-auto extract_as_readers(TempVcfWriterMap&& vcfs)
+auto extract_as_readers(TempVcfSegments&& segments, const std::vector<GenomeCallingComponents::Path>& resumed_paths)
 {
-    return writers_to_readers(extract_writers(std::move(vcfs)));
+    auto result = writers_to_readers(extract_writers(std::move(segments.open_segments)));
+    for (const auto& path : segments.closed_segment_paths) {
+        result.emplace_back(path);
+    }
+    for (const auto& path : resumed_paths) {
+        result.emplace_back(path);
+    }
+    return result;
 }
 
-void merge(TempVcfWriterMap&& temp_vcf_writers, GenomeCallingComponents& components)
+void merge(TempVcfSegments&& temp_vcf_segments, const std::vector<GenomeCallingComponents::Path>& resumed_paths,
+           GenomeCallingComponents& components)
 {
     static auto debug_log = get_debug_log();
-    if (debug_log) stream(*debug_log) << "Merging " << temp_vcf_writers.size() << " temporary VCF files";
-    auto temp_readers = extract_as_readers(std::move(temp_vcf_writers));
+    auto temp_readers = extract_as_readers(std::move(temp_vcf_segments), resumed_paths);
+    if (debug_log) stream(*debug_log) << "Merging " << temp_readers.size() << " temporary VCF files";
     merge(temp_readers, components.output(), components.contigs());
 }
 
+auto distributed_job_done_marker_path(const GenomeCallingComponents& components, const unsigned job_id)
+{
+    assert(components.temp_directory());
+    return *components.temp_directory() / ("octopus-job-" + std::to_string(job_id) + ".done");
+}
+
+bool try_claim_distributed_merge(const GenomeCallingComponents& components)
+{
+    // Directory creation is atomic, so exactly one of the racing jobs wins
+    boost::system::error_code ec {};
+    return boost::filesystem::create_directory(*components.temp_directory() / "octopus-merge-claim", ec) && !ec;
+}
+
+void finish_distributed_job(TempVcfSegments&& temp_vcf_segments, GenomeCallingComponents& components)
+{
+    // All of this job's segments must be closed and logged before the done
+    // marker appears, so whichever job performs the merge sees only durable data
+    checkpoint_all_segments(temp_vcf_segments);
+    const auto num_jobs = components.distributed_jobs();
+    const auto job_id = components.distributed_job_id();
+    std::ofstream {distributed_job_done_marker_path(components, job_id).string()};
+    bool all_jobs_done {true};
+    for (unsigned id {0}; id < num_jobs; ++id) {
+        if (!boost::filesystem::exists(distributed_job_done_marker_path(components, id))) {
+            all_jobs_done = false;
+            break;
+        }
+    }
+    logging::InfoLogger info_log {};
+    if (all_jobs_done && try_claim_distributed_merge(components)) {
+        const auto segment_paths = load_checkpoint(components).second;
+        std::vector<VcfReader> segment_readers {};
+        segment_readers.reserve(segment_paths.size());
+        for (const auto& path : segment_paths) {
+            segment_readers.emplace_back(path);
+        }
+        stream(info_log) << "All " << num_jobs << " distributed jobs are done; merging "
+                         << segment_readers.size() << " temporary VCF files";
+        merge(segment_readers, components.output(), components.contigs());
+    } else {
+        stream(info_log) << "Distributed job " << job_id << " has finished its contigs;"
+                         " the last job to finish will write the final output";
+    }
+}
+
 void run_octopus_multi_threaded(GenomeCallingComponents& components)
 {
     using namespace std::chrono_literals;
@@ -1077,11 +1388,58 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     
     const auto num_task_threads = calculate_num_task_threads(components);
     
+    CompletedRegionMap completed_regions {};
+    std::vector<GenomeCallingComponents::Path> resumed_segment_paths {};
+    if (components.resume()) {
+        auto checkpoint = load_checkpoint(components);
+        completed_regions = std::move(checkpoint.first);
+        resumed_segment_paths = std::move(checkpoint.second);
+        if (!resumed_segment_paths.empty()) {
+            logging::InfoLogger info_log {};
+            stream(info_log) << "Resuming from checkpoint; reusing " << resumed_segment_paths.size()
+                             << " completed temporary VCF files";
+            for (const auto& p : completed_regions) {
+                for (const auto& region : p.second) {
+                    components.progress_meter().log_completed(region);
+                }
+            }
+        }
+    }
+    
+    const auto num_distributed_jobs = components.distributed_jobs();
+    const bool distributed {num_distributed_jobs > 1};
+    auto job_contigs = components.contigs();
+    if (distributed) {
+        const auto contig_jobs = assign_contigs_to_distributed_jobs(job_contigs, components.reference(), num_distributed_jobs);
+        const auto job_id = components.distributed_job_id();
+        job_contigs.erase(std::remove_if(std::begin(job_contigs), std::end(job_contigs),
+                                         [&] (const auto& contig) { return contig_jobs.at(contig) != job_id; }),
+                          std::end(job_contigs));
+        logging::InfoLogger info_log {};
+        stream(info_log) << "Distributed job " << job_id << " of " << num_distributed_jobs
+                         << " calling " << job_contigs.size() << " of " << components.contigs().size() << " contigs";
+        // Mark the other jobs' contigs done so this job's progress can reach 100%
+        for (const auto& contig : components.contigs()) {
+            if (contig_jobs.at(contig) != job_id) {
+                for (const auto& region : components.search_regions().at(contig)) {
+                    components.progress_meter().log_completed(region);
+                }
+            }
+        }
+        if (job_contigs.empty()) {
+            stream(info_log) << "Distributed job " << job_id << " has no contigs assigned";
+            auto temp_writers = make_temp_vcf_segments(components);
+            finish_distributed_job(std::move(temp_writers), components);
+            return;
+        }
+    }
+
     TaskMap pending_tasks {components.contigs()};
     TaskMakerSyncPacket task_maker_sync {};
     task_maker_sync.batch_size_hint = 2 * num_task_threads;
     std::unique_lock<std::mutex> pending_task_lock {task_maker_sync.mutex, std::defer_lock};
-    auto task_maker_thread = make_task_maker_thread(pending_tasks, components, num_task_threads, task_maker_sync);
+    auto task_maker_thread = make_task_maker_thread(pending_tasks, components, std::move(job_contigs),
+                                                    num_task_threads, std::move(completed_regions), task_maker_sync);
     if (!task_maker_thread.joinable()) {
         logging::FatalLogger fatal_log {};
         fatal_log << "Unable to make task maker thread";
@@ -1102,9 +1460,11 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     
     CallerSyncPacket caller_sync {};
     const auto calling_components = make_contig_calling_component_factory_map(components);
+    const auto contig_numa_nodes = components.numa_aware() ? assign_contigs_to_numa_nodes(components.contigs())
+                                                           : ContigNumaNodeMap {};
     unsigned num_idle_futures {0};
     
-    auto temp_writers = make_temp_vcf_writers(components);
+    auto temp_writers = make_temp_vcf_segments(components);
     TaskWriterSyncPacket task_writer_sync {};
     auto task_writer_thread = make_task_writer_thread(temp_writers, task_writer_sync);
     if (!task_writer_thread.joinable()) {
@@ -1114,9 +1474,9 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     }
     task_writer_thread.detach();
     
-    // Wait for the first task to be made
-    const auto tasks_available = [&] () noexcept { return task_maker_sync.num_tasks > 0; };
-    while(task_maker_sync.num_tasks == 0) {
+    // Wait for the first task to be made (a fully checkpointed resume makes none)
+    const auto tasks_available = [&] () noexcept { return task_maker_sync.num_tasks > 0 || task_maker_sync.all_done; };
+    while (task_maker_sync.num_tasks == 0 && !task_maker_sync.all_done) {
         pending_task_lock.lock();
         task_maker_sync.cv.wait(pending_task_lock, tasks_available);
         pending_task_lock.unlock();
@@ -1146,6 +1506,10 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
         for (auto& future : futures) {
             if (is_ready(future)) {
                 auto completed_task = future.get();
+                const auto task_time_ms = utils::duration<std::chrono::milliseconds>(completed_task.runtime).count();
+                task_maker_sync.total_task_time_ms += task_time_ms;
+                task_maker_sync.last_task_time_ms = task_time_ms;
+                ++task_maker_sync.num_completed_tasks;
                 const auto& contig = contig_name(completed_task.region);
                 write_or_buffer(std::move(completed_task), buffered_tasks.at(contig),
                                 running_tasks.at(contig), holdbacks.at(contig),
@@ -1157,7 +1521,9 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
                 if (task_maker_sync.num_tasks > 0) {
                     pending_task_lock.unlock(); // As pop will need to lock the mutex too == deadlock
                     auto task = pop(pending_tasks, task_maker_sync);
-                    future = run(task, calling_components.at(contig_name(task))(), caller_sync);
+                    const auto numa_itr = contig_numa_nodes.find(contig_name(task));
+                    const auto numa_cpus = numa_itr != std::cend(contig_numa_nodes) ? &numa_itr->second : nullptr;
+                    future = run(task, calling_components.at(contig_name(task))(), caller_sync, numa_cpus);
                     running_tasks.at(contig_name(task)).push(std::move(task));
                 } else {
                     pending_task_lock.unlock();
@@ -1184,7 +1550,11 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     wait_until_finished(task_writer_sync);
     write_remaining_tasks(futures, buffered_tasks, temp_writers, calling_components);
     components.progress_meter().stop();
-    merge(std::move(temp_writers), components);
+    if (distributed) {
+        finish_distributed_job(std::move(temp_writers), components);
+    } else {
+        merge(std::move(temp_writers), resumed_segment_paths, components);
+    }
 }
 
 } // namespace
@@ -1194,6 +1564,28 @@ bool is_multithreaded(const GenomeCallingComponents& components)
     return !components.num_threads() || *components.num_threads() > 1;
 }
 
+void log_stage_profile()
+{
+    auto debug_log = get_debug_log();
+    if (debug_log && !stage_profiler.empty()) {
+        std::ostringstream ss {};
+        ss << "Per-stage wall clock profile:\n";
+        stage_profiler.write_report(ss);
+        *debug_log << ss.str();
+    }
+}
+
+void log_allocation_profile()
+{
+    if (allocation_profiling_enabled()) {
+        std::ostringstream ss {};
+        ss << "Per-subsystem allocation profile:\n";
+        write_allocation_report(ss);
+        logging::InfoLogger log {};
+        log << ss.str();
+    }
+}
+
 void run_calling(GenomeCallingComponents& components)
 {
     if (is_multithreaded(components)) {
@@ -1203,8 +1595,18 @@ void run_calling(GenomeCallingComponents& components)
         }
         run_octopus_multi_threaded(components);
     } else {
+        if (components.resume()) {
+            logging::WarningLogger warn_log {};
+            warn_log << "Resume is only supported for multithreaded runs and will be ignored";
+        }
+        if (components.distributed_jobs() > 1) {
+            logging::WarningLogger warn_log {};
+            warn_log << "Distributed mode is only supported for multithreaded runs and will be ignored";
+        }
         run_octopus_single_threaded(components);
     }
+    log_stage_profile();
+    log_allocation_profile();
 }
 
 void destroy(VcfWriter& writer)
@@ -1273,8 +1675,19 @@ void run_csr(GenomeCallingComponents& components)
         }
         assert(input_path); // cannot be stdout
         BufferedReadPipe::Config buffer_config {components.read_buffer_size()};
+        const auto rss = get_current_resident_set_size();
+        const auto buffer_target = components.target_read_buffer_footprint();
+        if (rss && buffer_target.num_bytes() > 0 && rss->num_bytes() > buffer_target.num_bytes()) {
+            // Memory retained from the calling phase eats into the read buffer
+            // budget; shrink the filtering buffer rather than stacking a full
+            // one on top of it
+            const auto scale = static_cast<double>(buffer_target.num_bytes()) / rss->num_bytes();
+            buffer_config.max_buffer_size = std::max(static_cast<std::size_t>(buffer_config.max_buffer_size * scale),
+                                                     minTaskReadBudget);
+        }
         buffer_config.fetch_expansion = 100;
         buffer_config.max_hint_gap = 5'000;
+        buffer_config.prefetch = true; // calls are filtered left to right
         BufferedReadPipe buffered_rp {filter_read_pipe, buffer_config};
         if (use_unfiltered_call_region_hints_for_filtering(components)) {
             buffered_rp.hint(extract_call_regions(*input_path));
@@ -8,6 +8,8 @@
 #include <algorithm>
 #include <utility>
 #include <thread>
+#include <future>
+#include <queue>
 #include <cassert>
 
 #include "basics/genomic_region.hpp"
@@ -82,11 +84,12 @@ auto assign_and_realign(const std::vector<AlignedRead>& reads, const Genotype<Ha
             utils::append(safe_realign_to_reference(reads, genotype[0]), result);
         } else {
             std::deque<AlignedRead> unassigned_reads {};
-            auto support = compute_haplotype_support(genotype, reads, unassigned_reads);
+            SupportAlignmentMap support_alignments {};
+            auto support = compute_haplotype_support(genotype, reads, unassigned_reads, support_alignments);
             for (auto& p : support) {
                 if (!p.second.empty()) {
                     report.n_reads_assigned += p.second.size();
-                    safe_realign_to_reference(p.second, p.first);
+                    safe_realign_to_reference(p.second, p.first, support_alignments);
                     utils::append(std::move(p.second), result);
                 }
             }
@@ -107,12 +110,120 @@ auto move_merge(Container& src, std::vector<AlignedRead>& dst)
     std::inplace_merge(std::begin(dst), itr, std::end(dst));
 }
 
+// Buffers realigned reads as coordinate-sorted runs - each run sorted on the
+// worker pool - and merge-writes a contig's runs when the walk leaves it, so
+// the output BAM comes out coordinate sorted, and therefore indexable, without
+// an external sort pass. Realignment can shift reads between batches within a
+// contig, which is why runs are only safe to merge once the contig is done.
+class SortedRunWriter
+{
+public:
+    SortedRunWriter() = delete;
+
+    SortedRunWriter(io::ReadWriter& dst, ThreadPool& workers)
+    : dst_ {dst}
+    , workers_ {workers}
+    {}
+
+    SortedRunWriter(const SortedRunWriter&)            = delete;
+    SortedRunWriter& operator=(const SortedRunWriter&) = delete;
+    SortedRunWriter(SortedRunWriter&&)                 = default;
+    SortedRunWriter& operator=(SortedRunWriter&&)      = delete;
+
+    ~SortedRunWriter() = default;
+
+    void push(std::vector<AlignedRead> run)
+    {
+        if (run.empty()) return;
+        const auto& run_contig = contig_name(run.front());
+        if (contig_ && *contig_ != run_contig) {
+            flush();
+        }
+        contig_ = run_contig;
+        if (!workers_.get().empty()) {
+            runs_.push_back(workers_.get().push([run = std::move(run)] () mutable {
+                std::sort(std::begin(run), std::end(run));
+                return std::move(run);
+            }));
+        } else {
+            std::sort(std::begin(run), std::end(run));
+            std::promise<std::vector<AlignedRead>> sorted {};
+            sorted.set_value(std::move(run));
+            runs_.push_back(sorted.get_future());
+        }
+    }
+
+    void flush()
+    {
+        std::vector<std::vector<AlignedRead>> runs {};
+        runs.reserve(runs_.size());
+        for (auto& run : runs_) runs.push_back(run.get());
+        runs_.clear();
+        using RunIterator = std::vector<AlignedRead>::iterator;
+        using Cursor = std::pair<RunIterator, RunIterator>;
+        const auto cursor_greater = [] (const Cursor& lhs, const Cursor& rhs) { return *rhs.first < *lhs.first; };
+        std::priority_queue<Cursor, std::vector<Cursor>, decltype(cursor_greater)> merge_queue {cursor_greater};
+        for (auto& run : runs) {
+            if (!run.empty()) merge_queue.push({std::begin(run), std::end(run)});
+        }
+        // The merge output is batched, with each batch converted to htslib
+        // records on the pool while the previous batch is being written, so
+        // the writing thread only encodes and never converts
+        constexpr std::size_t batchSize {4096};
+        const auto convert = [&dst = dst_.get()] (std::vector<AlignedRead> reads) {
+            std::vector<io::ReadWriter::BamRecord> records {};
+            records.reserve(reads.size());
+            for (const auto& read : reads) {
+                records.push_back(dst.make_record(read));
+            }
+            return records;
+        };
+        std::vector<AlignedRead> batch {};
+        batch.reserve(batchSize);
+        std::future<std::vector<io::ReadWriter::BamRecord>> pending_records {};
+        const auto submit_batch = [&] () {
+            if (batch.empty()) return;
+            if (!workers_.get().empty()) {
+                auto next_records = workers_.get().push(convert, std::move(batch));
+                if (pending_records.valid()) {
+                    dst_.get().write(pending_records.get());
+                }
+                pending_records = std::move(next_records);
+            } else {
+                dst_.get().write(convert(std::move(batch)));
+            }
+            batch = std::vector<AlignedRead> {};
+            batch.reserve(batchSize);
+        };
+        while (!merge_queue.empty()) {
+            auto cursor = merge_queue.top();
+            merge_queue.pop();
+            batch.push_back(std::move(*cursor.first));
+            if (batch.size() == batchSize) submit_batch();
+            if (++cursor.first != cursor.second) {
+                merge_queue.push(cursor);
+            }
+        }
+        submit_batch();
+        if (pending_records.valid()) {
+            dst_.get().write(pending_records.get());
+        }
+    }
+
+private:
+    std::reference_wrapper<io::ReadWriter> dst_;
+    std::reference_wrapper<ThreadPool> workers_;
+    std::deque<std::future<std::vector<AlignedRead>>> runs_;
+    boost::optional<GenomicRegion::ContigName> contig_;
+};
+
 } // namespace
 
 BAMRealigner::Report BAMRealigner::realign(ReadReader& src, VcfReader& variants, ReadWriter& dst,
                                            const ReferenceGenome& reference, SampleList samples) const
 {
     Report report {};
+    SortedRunWriter sorted_dst {dst, workers_};
     boost::optional<GenomicRegion> batch_region {};
     for (auto p = variants.iterate(); p.first != p.second; ) {
         auto batch = read_next_batch(p.first, p.second, src, reference, samples, batch_region);
@@ -132,10 +243,11 @@ BAMRealigner::Report BAMRealigner::realign(ReadReader& src, VcfReader& variants,
                 utils::append(std::move(realignments), realigned_reads);
             }
             move_merge(realigned_reads, sample.reads);
-            dst << sample.reads;
+            sorted_dst.push(std::move(sample.reads));
         }
         batch_region = encompassing_region(batch.front().genotypes);
     }
+    sorted_dst.flush();
     return report;
 }
 
@@ -157,7 +269,8 @@ auto split_and_realign(const std::vector<AlignedRead>& reads, const Genotype<Hap
             result.back() = safe_realign_to_reference(reads, genotype[0]);
         } else {
             std::deque<AlignedRead> unassigned_reads {};
-            auto support = compute_haplotype_support(genotype, reads, unassigned_reads);
+            SupportAlignmentMap support_alignments {};
+            auto support = compute_haplotype_support(genotype, reads, unassigned_reads, support_alignments);
             std::size_t result_idx {0};
             for (const auto& haplotype : genotype) {
                 auto support_itr = support.find(haplotype);
@@ -165,7 +278,7 @@ auto split_and_realign(const std::vector<AlignedRead>& reads, const Genotype<Hap
                     auto& haplotype_support = support_itr->second;
                     if (!haplotype_support.empty()) {
                         report.n_reads_assigned += haplotype_support.size();
-                        safe_realign_to_reference(haplotype_support, haplotype);
+                        safe_realign_to_reference(haplotype_support, haplotype, support_alignments);
                         result[result_idx] = std::move(haplotype_support);
                         ++result_idx;
                     }
@@ -189,6 +302,9 @@ BAMRealigner::Report BAMRealigner::realign(ReadReader& src, VcfReader& variants,
 {
     if (dsts.size() == 1) return realign(src, variants, dsts.front(), reference, samples);
     Report report {};
+    std::vector<SortedRunWriter> sorted_dsts {};
+    sorted_dsts.reserve(dsts.size());
+    for (auto& dst : dsts) sorted_dsts.emplace_back(dst, workers_);
     boost::optional<GenomicRegion> batch_region {};
     for (auto p = variants.iterate(); p.first != p.second; ) {
         auto batch = read_next_batch(p.first, p.second, src, reference, samples, batch_region);
@@ -206,15 +322,16 @@ BAMRealigner::Report BAMRealigner::realign(ReadReader& src, VcfReader& variants,
                 move_merge(bad_reads, realignments.back());
                 assert(realignments.size() <= dsts.size());
                 for (unsigned i {0}; i < realignments.size() - 1; ++i) {
-                    dsts[i] <<  realignments[i];
+                    sorted_dsts[i].push(std::move(realignments[i]));
                 }
                 utils::append(std::move(realignments.back()), unassigned_realigned_reads); // end is always unassigned, but ploidy can change
             }
             move_merge(unassigned_realigned_reads, sample.reads);
-            dsts.back() << sample.reads;
+            sorted_dsts.back().push(std::move(sample.reads));
         }
         batch_region = encompassing_region(batch.front().genotypes);
     }
+    for (auto& sorted_dst : sorted_dsts) sorted_dst.flush();
     return report;
 }
 
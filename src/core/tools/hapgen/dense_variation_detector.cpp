@@ -20,6 +20,7 @@
 #include "containers/mappable_map.hpp"
 #include "utils/mappable_algorithms.hpp"
 #include "utils/read_stats.hpp"
+#include "utils/coverage_tracker.hpp"
 #include "utils/maths.hpp"
 
 #include <iostream>
@@ -101,7 +102,7 @@ auto compute_median(std::vector<AlignedRead::MappingQuality>& mapping_qualities)
     }
 }
 
-auto compute_positional_median_mapping_qualities(const MappableFlatMultiSet<AlignedRead>& reads, const GenomicRegion& region)
+auto compute_positional_median_mapping_qualities(const ReadContainer& reads, const GenomicRegion& region)
 {
     const auto num_positions = size(region);
     std::vector<AlignedRead::MappingQuality> result(num_positions);
@@ -227,6 +228,140 @@ auto find_dense_regions(const MappableFlatSet<Variant>& variants, const ReadMap&
     return result;
 }
 
+// Interval-count columns over a set of possibly-empty regions: sorted begin
+// and end positions with prefix sums of a per-interval weight. The number of
+// intervals overlapping a query and their total weight then come from two
+// binary searches; the rare empty intervals are checked linearly to keep the
+// overlap semantics exact at query boundaries.
+class OverlapIndex
+{
+public:
+    struct Summary
+    {
+        std::size_t count;
+        double weight;
+    };
+
+    void add(const ContigRegion& region, const double weight = 0.0)
+    {
+        if (is_empty(region)) {
+            empty_intervals_.push_back({region.begin(), weight});
+        } else {
+            begin_positions_.push_back(region.begin());
+            end_positions_.push_back(region.end());
+            begin_weights_.push_back(weight);
+            end_weights_.push_back(weight);
+        }
+    }
+    void finalise()
+    {
+        sort_columns(begin_positions_, begin_weights_);
+        sort_columns(end_positions_, end_weights_);
+        accumulate_weights(begin_weights_);
+        accumulate_weights(end_weights_);
+    }
+    Summary overlapped(const ContigRegion& query) const
+    {
+        std::size_t num_admitted, num_excluded;
+        if (!is_empty(query)) {
+            num_admitted = std::lower_bound(std::cbegin(begin_positions_), std::cend(begin_positions_), query.end())
+                           - std::cbegin(begin_positions_);
+            num_excluded = std::upper_bound(std::cbegin(end_positions_), std::cend(end_positions_), query.begin())
+                           - std::cbegin(end_positions_);
+        } else {
+            num_admitted = std::upper_bound(std::cbegin(begin_positions_), std::cend(begin_positions_), query.begin())
+                           - std::cbegin(begin_positions_);
+            num_excluded = std::lower_bound(std::cbegin(end_positions_), std::cend(end_positions_), query.begin())
+                           - std::cbegin(end_positions_);
+        }
+        Summary result {num_admitted - num_excluded, begin_weights_[num_admitted] - end_weights_[num_excluded]};
+        for (const auto& interval : empty_intervals_) {
+            if (query.begin() <= interval.position && interval.position <= query.end()) {
+                ++result.count;
+                result.weight += interval.weight;
+            }
+        }
+        return result;
+    }
+
+private:
+    struct EmptyInterval
+    {
+        ContigRegion::Position position;
+        double weight;
+    };
+
+    std::vector<ContigRegion::Position> begin_positions_, end_positions_;
+    std::vector<double> begin_weights_, end_weights_;
+    std::vector<EmptyInterval> empty_intervals_;
+
+    static void sort_columns(std::vector<ContigRegion::Position>& positions, std::vector<double>& weights)
+    {
+        assert(positions.size() == weights.size());
+        std::vector<std::size_t> order(positions.size());
+        std::iota(std::begin(order), std::end(order), 0);
+        std::sort(std::begin(order), std::end(order),
+                  [&] (const auto lhs, const auto rhs) { return positions[lhs] < positions[rhs]; });
+        std::vector<ContigRegion::Position> sorted_positions(positions.size());
+        std::vector<double> sorted_weights(weights.size());
+        for (std::size_t i {0}; i < order.size(); ++i) {
+            sorted_positions[i] = positions[order[i]];
+            sorted_weights[i] = weights[order[i]];
+        }
+        positions = std::move(sorted_positions);
+        weights = std::move(sorted_weights);
+    }
+    static void accumulate_weights(std::vector<double>& weights)
+    {
+        weights.insert(std::cbegin(weights), 0.0);
+        std::partial_sum(std::cbegin(weights), std::cend(weights), std::begin(weights));
+    }
+};
+
+// Positional summaries of the candidates and reads built once per detection
+// pass, so the per-region statistics the joining heuristics repeatedly ask
+// for are answered from prefix sums rather than fresh scans
+class DetectionIndex
+{
+public:
+    DetectionIndex(const MappableFlatSet<Variant>& variants, const ReadMap& reads)
+    : num_samples_ {reads.size()}
+    {
+        for (const auto& variant : variants) {
+            variant_counts_.add(contig_region(variant));
+        }
+        variant_counts_.finalise();
+        for (const auto& p : reads) {
+            for (const AlignedRead& read : p.second) {
+                depth_tracker_.add(contig_region(read));
+                const auto mapping_quality = static_cast<double>(read.mapping_quality());
+                read_mapping_qualities_.add(contig_region(read), mapping_quality * mapping_quality);
+            }
+        }
+        read_mapping_qualities_.finalise();
+    }
+
+    double mean_read_depth(const GenomicRegion& region) const
+    {
+        if (num_samples_ == 0 || is_empty_region(region)) return 0.0;
+        return static_cast<double>(depth_tracker_.sum(region.contig_region())) / (size(region) * num_samples_);
+    }
+    double rmq_mapping_quality(const GenomicRegion& region) const
+    {
+        const auto overlapped = read_mapping_qualities_.overlapped(region.contig_region());
+        return overlapped.count > 0 ? std::sqrt(overlapped.weight / overlapped.count) : 0.0;
+    }
+    unsigned count_overlapped_variants(const GenomicRegion& region) const
+    {
+        return variant_counts_.overlapped(region.contig_region()).count;
+    }
+
+private:
+    CoverageTracker<ContigRegion> depth_tracker_;
+    OverlapIndex variant_counts_, read_mapping_qualities_;
+    std::size_t num_samples_;
+};
+
 struct RegionState
 {
     GenomicRegion region;
@@ -236,23 +371,23 @@ struct RegionState
     double rmq_mapping_quality;
 };
 
-auto compute_state(const GenomicRegion& region, const MappableFlatSet<Variant>& variants, const ReadMap& reads)
+auto compute_state(const GenomicRegion& region, const DetectionIndex& index)
 {
     RegionState result {};
     result.region = region;
-    result.rmq_mapping_quality = rmq_mapping_quality(reads, region);
-    result.mean_read_depth = mean_coverage(reads, region) / reads.size();
-    result.variant_count = count_overlapped(variants, region);
+    result.rmq_mapping_quality = index.rmq_mapping_quality(region);
+    result.mean_read_depth = index.mean_read_depth(region);
+    result.variant_count = index.count_overlapped_variants(region);
     result.variant_density = static_cast<double>(result.variant_count) / size(region);
     return result;
 }
 
-auto compute_states(const MappableFlatSet<GenomicRegion>& regions, const MappableFlatSet<Variant>& variants, const ReadMap& reads)
+auto compute_states(const MappableFlatSet<GenomicRegion>& regions, const DetectionIndex& index)
 {
     std::vector<RegionState> result {};
     result.reserve(regions.size());
     for (const auto& region : regions) {
-        result.push_back(compute_state(region, variants, reads));
+        result.push_back(compute_state(region, index));
     }
     return result;
 }
@@ -275,16 +410,16 @@ bool should_join(const RegionState& lhs_state, const RegionState& connecting_sta
 }
 
 auto join_dense_regions(const MappableFlatSet<GenomicRegion>& dense_regions,
-                        const MappableFlatSet<Variant>& variants, const ReadMap& reads)
+                        const DetectionIndex& index)
 {
     if (dense_regions.size() > 1) {
         std::vector<GenomicRegion> final_regions {};
         final_regions.reserve(dense_regions.size());
-        const auto dense_states = compute_states(dense_regions, variants, reads);
+        const auto dense_states = compute_states(dense_regions, index);
         final_regions.push_back(dense_regions.front());
         for (std::size_t i {1}; i < dense_regions.size(); ++i) {
             const auto connecting_region = *intervening_region(dense_regions[i - 1], dense_regions[i]);
-            const auto connecting_state = compute_state(connecting_region, variants, reads);
+            const auto connecting_state = compute_state(connecting_region, index);
             if (should_join(dense_states[i - 1], connecting_state, dense_states[i])) {
                 final_regions.push_back(connecting_region);
             }
@@ -306,7 +441,8 @@ DenseVariationDetector::detect(const MappableFlatSet<Variant>& variants, const R
     const auto dense_zone_log_count_threshold = expected_log_count * mean_read_size;
     auto dense_regions = find_dense_regions(variants, reads, dense_zone_log_count_threshold, 1);
     if (dense_regions.empty()) return {};
-    auto joined_dense_regions = join_dense_regions(dense_regions, variants, reads);
+    const DetectionIndex index {variants, reads};
+    auto joined_dense_regions = join_dense_regions(dense_regions, index);
     std::vector<DenseRegion> result {};
     result.reserve(joined_dense_regions.size());
     double max_expected_coverage {};
@@ -316,7 +452,7 @@ DenseVariationDetector::detect(const MappableFlatSet<Variant>& variants, const R
         max_expected_coverage = 2 * mean_coverage(reads);
     }
     for (const auto& region : joined_dense_regions) {
-        const auto state = compute_state(region, variants, reads);
+        const auto state = compute_state(region, index);
         if (state.variant_count > 100 && size(state.region) > 3 * mean_read_size && state.mean_read_depth > max_expected_coverage) {
             result.push_back({region, DenseRegion::RecommendedAction::skip});
         }
@@ -25,6 +25,19 @@ GenomeWalker::GenomeWalker(unsigned max_included,
 , extension_policy_ {extension_policy}
 {}
 
+const ReadSkipIndex& GenomeWalker::read_index(const ReadMap& reads) const
+{
+    // Walks are repeatedly made over the same read set, so the index is built
+    // lazily and kept until the reads change
+    const auto num_reads = count_mappables(reads);
+    if (indexed_reads_ != std::addressof(reads) || indexed_read_count_ != num_reads) {
+        read_index_ = ReadSkipIndex {reads};
+        indexed_reads_ = std::addressof(reads);
+        indexed_read_count_ = num_reads;
+    }
+    return read_index_;
+}
+
 GenomicRegion GenomeWalker::walk(const GenomicRegion::ContigName& contig,
                                  const ReadMap& reads,
                                  const AlleleSet& alleles) const
@@ -117,16 +130,16 @@ bool is_close(const BidirIt proposed_included, const BidirIt first_excluded)
 }
 
 template <typename BidirIt>
-bool increases_density(const BidirIt proposed_included, const BidirIt last, const ReadMap& reads,
+bool increases_density(const BidirIt proposed_included, const BidirIt last, const ReadSkipIndex& reads,
                        const unsigned max_density_increase)
 {
-    return max_count_if_shared_with_first(reads, proposed_included, last) >= max_density_increase;
+    return reads.max_count_if_shared_with_first(proposed_included, last) >= max_density_increase;
 }
 
 template <typename BidirIt>
 bool is_optimal_to_extend(const BidirIt first_included, const BidirIt proposed_included,
                           const BidirIt first_excluded, const BidirIt last,
-                          const ReadMap& reads, const unsigned max_density_increase)
+                          const ReadSkipIndex& reads, const unsigned max_density_increase)
 {
     if (proposed_included == last) return false;
     if (first_excluded == last) return true;
@@ -157,13 +170,14 @@ GenomicRegion GenomeWalker::walk(const GenomicRegion& previous_region,
             return previous_region;
         }
     }
+    const auto& shared_read_index = read_index(reads);
     unsigned num_indicators {0};
     switch (indicator_policy_) {
         case IndicatorPolicy::includeNone: break;
         case IndicatorPolicy::includeIfSharedWithNovelRegion:
         {
             if (distance(first_previous_itr, included_itr) > 0) {
-                auto it = find_first_shared(reads, first_previous_itr, included_itr, *included_itr);
+                auto it = shared_read_index.find_first_shared(first_previous_itr, included_itr, *included_itr);
                 if (it != included_itr) {
                     auto expanded_leftmost = mapped_region(*it);
                     std::for_each(it, included_itr, [&] (const auto& allele) {
@@ -187,7 +201,7 @@ GenomicRegion GenomeWalker::walk(const GenomicRegion& previous_region,
             if (distance(first_previous_itr, included_itr) > 0) {
                 auto it = included_itr;
                 while (true) {
-                    const auto it2 = find_first_shared(reads, first_previous_itr, it, *it);
+                    const auto it2 = shared_read_index.find_first_shared(first_previous_itr, it, *it);
                     if (it2 == it) {
                         it = it2;
                         break;
@@ -208,7 +222,7 @@ GenomicRegion GenomeWalker::walk(const GenomicRegion& previous_region,
     unsigned num_excluded_alleles {0};
     auto num_included = max_included_;
     if (extension_policy_ == ExtensionPolicy::includeIfWithinReadLengthOfFirstIncluded) {
-        auto max_alleles_within_read_length = static_cast<unsigned>(max_count_if_shared_with_first(reads, first_included_itr, last_allele_itr));
+        auto max_alleles_within_read_length = static_cast<unsigned>(shared_read_index.max_count_if_shared_with_first(first_included_itr, last_allele_itr));
         num_included = min({num_included, num_remaining_alleles, max_alleles_within_read_length + 1});
         num_excluded_alleles = max_alleles_within_read_length - num_included;
     } else {
@@ -217,12 +231,12 @@ GenomicRegion GenomeWalker::walk(const GenomicRegion& previous_region,
     assert(num_included > 0);
     auto first_excluded_itr = next(included_itr, num_included);
     while (--num_included > 0 && is_optimal_to_extend(first_included_itr, next(included_itr), first_excluded_itr,
-                                                      last_allele_itr, reads, num_included + num_excluded_alleles)) {
+                                                      last_allele_itr, shared_read_index, num_included + num_excluded_alleles)) {
         if (extension_policy_ == ExtensionPolicy::includeIfAllSamplesSharedWithFrontier
-            && !all_shared(reads, *included_itr, *next(included_itr))) {
+            && !shared_read_index.all_shared(mapped_region(*included_itr), mapped_region(*next(included_itr)))) {
             break;
         } else if (extension_policy_ == ExtensionPolicy::includeIfAnySampleSharedWithFrontier
-            && !has_shared(reads, *included_itr, *next(included_itr))) {
+            && !shared_read_index.has_shared(mapped_region(*included_itr), mapped_region(*next(included_itr)))) {
             break;
         }
         ++included_itr;
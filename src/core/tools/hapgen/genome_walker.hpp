@@ -4,12 +4,14 @@
 #ifndef genome_walker_hpp
 #define genome_walker_hpp
 
+#include <cstddef>
 #include <functional>
 
 #include "config/common.hpp"
 #include "concepts/mappable.hpp"
 #include "core/types/allele.hpp"
 #include "containers/mappable_flat_set.hpp"
+#include "read_skip_index.hpp"
 
 namespace octopus {
 
@@ -62,6 +64,12 @@ private:
     unsigned max_included_;
     IndicatorPolicy indicator_policy_;
     ExtensionPolicy extension_policy_;
+
+    mutable ReadSkipIndex read_index_;
+    mutable const ReadMap* indexed_reads_ = nullptr;
+    mutable std::size_t indexed_read_count_ = 0;
+
+    const ReadSkipIndex& read_index(const ReadMap& reads) const;
 };
 
 } // namespace coretools
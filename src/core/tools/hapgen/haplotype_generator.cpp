@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <future>
 #include <iterator>
 #include <numeric>
 #include <cmath>
@@ -12,11 +13,13 @@
 
 #include <boost/range/iterator_range.hpp>
 
+#include "basics/aligned_read.hpp"
 #include "core/types/variant.hpp"
 #include "core/types/haplotype.hpp"
 #include "concepts/mappable.hpp"
 #include "utils/mappable_algorithms.hpp"
 #include "utils/append.hpp"
+#include "utils/thread_pool.hpp"
 
 #include <iostream> // DEBUG
 #include "timers.hpp"
@@ -155,17 +158,26 @@ HaplotypeGenerator::HaplotypeGenerator(const ReferenceGenome& reference,
 {
     assert(!candidates.empty());
     if (!all_empty(reads_)) {
+        std::vector<GenomicRegion> skip_regions {};
         for (const auto& dense : dense_variation_detector.detect(candidates, reads)) {
             if (dense.action == DenseVariationDetector::DenseRegion::RecommendedAction::skip) {
                 if (debug_log_) {
                     stream(*debug_log_) << "Erasing " << count_contained(alleles_, dense.region)
                                         << " alleles in dense region " << dense.region;
                 }
-                alleles_.erase_contained(dense.region);
+                skip_regions.push_back(dense.region);
             } else if (is_lagging_enabled()) {
                 lagging_exclusion_zones_.insert(dense.region);
             }
         }
+        if (!skip_regions.empty()) {
+            // Erasing all skipped regions in one pass means each surviving allele
+            // is moved at most once, rather than once per dense region
+            alleles_.erase_all([&skip_regions] (const Allele& allele) {
+                return std::any_of(std::cbegin(skip_regions), std::cend(skip_regions),
+                                   [&allele] (const auto& region) { return contains(region, allele); });
+            });
+        }
         if (!lagging_exclusion_zones_.empty() && debug_log_) {
             auto log = stream(*debug_log_);
             log << "Found lagging exclusion zones: ";
@@ -282,6 +294,11 @@ unsigned HaplotypeGenerator::max_removal_impact() const
     return cur_num_haplotypes;
 }
 
+void HaplotypeGenerator::enable_parallel_holdout_search(ThreadPool& workers) noexcept
+{
+    holdout_workers_ = std::addressof(workers);
+}
+
 // private methods
 
 bool HaplotypeGenerator::is_lagging_enabled() const noexcept
@@ -923,7 +940,7 @@ void HaplotypeGenerator::populate_tree_with_novel_alleles()
         const auto novel_region_before_holdout = novel_active_region;
         auto next_holdout_region = novel_active_region;
         while (last_added_novel_itr != std::cend(novel_active_alleles) && can_try_extracting_holdouts(next_holdout_region)) {
-            if (!try_extract_holdouts(next_holdout_region)) {
+            if (!try_extract_holdouts(next_holdout_region, novel_active_region)) {
                 break;
             }
             tree_.clear(novel_active_region);
@@ -1060,19 +1077,58 @@ struct ContainmentCount
 {
     GenomicRegion region;
     std::size_t count;
+    std::size_t minor_support;
 };
 
-auto get_containment_counts(const MappableFlatSet<Allele>& alleles)
+std::size_t count_matching_observations(const ReadMap& reads, const Allele& allele)
+{
+    std::size_t result {0};
+    for (const auto& p : reads) {
+        for (const auto& read : overlap_range(p.second, allele)) {
+            if (contains(read, allele) && copy_sequence(read, mapped_region(allele)) == allele.sequence()) {
+                ++result;
+            }
+        }
+    }
+    return result;
+}
+
+// Observed support for a candidate region's non-dominant alleles. The dominant
+// allele is almost always the reference, so a low result means the remaining
+// alleles are weakly supported - singletons and sequencing noise - making the
+// region a cheap holdout, while a region with a well-supported alternative
+// keeps its place in the tree
+std::size_t minor_allele_support(const MappableFlatSet<Allele>& alleles, const GenomicRegion& region,
+                                 const ReadMap& reads)
+{
+    std::size_t total {0}, dominant {0};
+    for (const auto& allele : contained_range(alleles, region)) {
+        if (is_same_region(allele, region)) {
+            const auto observations = count_matching_observations(reads, allele);
+            total += observations;
+            dominant = std::max(dominant, observations);
+        }
+    }
+    return total - dominant;
+}
+
+auto get_containment_counts(const MappableFlatSet<Allele>& alleles, const ReadMap& reads)
 {
     const auto allele_regions = extract_unique_regions(alleles);
     std::vector<ContainmentCount> result {};
-    result.reserve(result.size());
+    result.reserve(allele_regions.size());
     std::transform(std::cbegin(allele_regions), std::cend(allele_regions), std::back_inserter(result),
-                   [&alleles] (const auto& region) -> ContainmentCount {
-                       return {region, count_fully_contained(alleles, region)};
+                   [&] (const auto& region) -> ContainmentCount {
+                       return {region, count_fully_contained(alleles, region),
+                               minor_allele_support(alleles, region, reads)};
                    });
     std::sort(std::begin(result), std::end(result),
               [] (const auto& lhs, const auto& rhs) {
+                  // Weakly supported regions make the best holdouts; the tree
+                  // budget then goes to well-supported alleles first
+                  if (lhs.minor_support != rhs.minor_support) {
+                      return lhs.minor_support < rhs.minor_support;
+                  }
                   if (lhs.count == rhs.count) {
                       // Prefer holding out larger regions
                       return size(lhs.region) > size(rhs.region);
@@ -1124,10 +1180,40 @@ void log_new_holdouts(const std::deque<Allele>& holdouts, boost::optional<loggin
 
 } // namespace debug
 
-bool HaplotypeGenerator::try_extract_holdouts(GenomicRegion region)
+bool HaplotypeGenerator::try_extract_holdouts(GenomicRegion region, const GenomicRegion& novel_region)
 {
-    auto new_holdout_set = propose_new_holdout_set(std::move(region));
-    if (new_holdout_set) {
+    // Each trial regrows a copy of the tree, so concurrent candidates are
+    // bounded to keep the memory footprint at a few times the serial case
+    constexpr std::size_t maxConcurrentHoldoutTrials {4};
+    const auto max_candidates = holdout_workers_ && !holdout_workers_->empty() ? maxConcurrentHoldoutTrials : 1;
+    auto candidates = propose_holdout_candidates(std::move(region), max_candidates);
+    if (!candidates.empty()) {
+        auto chosen_itr = std::begin(candidates);
+        if (candidates.size() > 1) {
+            // Trial the candidates concurrently on tree copies and commit to the
+            // first viable one, rather than discovering a bad choice only after
+            // the serial regrow overflows again
+            std::vector<std::future<bool>> trials {};
+            trials.reserve(candidates.size());
+            for (const auto& candidate : candidates) {
+                trials.push_back(holdout_workers_->push([this, &candidate, &novel_region] () {
+                    return is_viable_holdout_choice(candidate, novel_region);
+                }));
+            }
+            // Candidates are in preference order, so committing to the first
+            // viable one keeps the choice deterministic regardless of which
+            // trial finishes first. If none are viable the preferred candidate
+            // is kept and deeper holdout extraction proceeds as before.
+            bool chosen {false};
+            for (std::size_t i {0}; i < trials.size(); ++i) {
+                const auto is_viable = trials[i].get();
+                if (is_viable && !chosen) {
+                    chosen_itr = std::next(std::begin(candidates), i);
+                    chosen = true;
+                }
+            }
+        }
+        auto new_holdout_set = boost::make_optional(std::move(*chosen_itr));
         std::deque<Allele> new_holdout_alleles {};
         auto new_holdout_regions = demote_all(extract_mutually_exclusive_regions(new_holdout_set->alleles));
         if (previous_holdout_regions_.count(new_holdout_regions) == 0) {
@@ -1154,19 +1240,23 @@ bool HaplotypeGenerator::try_extract_holdouts(GenomicRegion region)
     }
 }
 
-boost::optional<HaplotypeGenerator::HoldoutSet> HaplotypeGenerator::propose_new_holdout_set(GenomicRegion region) const
+std::vector<HaplotypeGenerator::HoldoutSet>
+HaplotypeGenerator::propose_holdout_candidates(GenomicRegion region, const std::size_t max_candidates) const
 {
     assert(can_try_extracting_holdouts(region));
     const auto active_alleles = copy_overlapped(alleles_, region);
     assert(!active_alleles.empty());
-    auto containment_counts = get_containment_counts(active_alleles);
-    auto last_viable_holdout = std::upper_bound(std::begin(containment_counts), std::end(containment_counts),
-                                                3u, [] (auto lhs, const auto& rhs) { return lhs > rhs.count; });
+    auto containment_counts = get_containment_counts(active_alleles, reads_);
+    // Regions too small to relieve tree pressure are not worth holding out,
+    // whatever their support
+    auto last_viable_holdout = std::stable_partition(std::begin(containment_counts), std::end(containment_counts),
+                                              [] (const auto& c) { return c.count > 3u; });
+    std::vector<HoldoutSet> result {};
     if (last_viable_holdout != std::end(containment_counts)) {
         last_viable_holdout = std::remove_if(std::begin(containment_counts), last_viable_holdout,
                                              [] (const auto& c) { return size(c.region) < 2; });
         const auto num_viable_holdouts = std::distance(std::begin(containment_counts), last_viable_holdout);
-        if (num_viable_holdouts == 0) return boost::none;
+        if (num_viable_holdouts == 0) return result;
         auto holdout_itr = std::begin(containment_counts);
         if (num_viable_holdouts > 1) {
             const auto good_count = std::log2(policies_.haplotype_limits.holdout);
@@ -1176,12 +1266,34 @@ boost::optional<HaplotypeGenerator::HoldoutSet> HaplotypeGenerator::propose_new_
                                     });
             if (itr != last_viable_holdout) holdout_itr = itr;
         }
-        const auto holdouts = get_holdout_range(active_alleles, holdout_itr->region);
-        assert(!holdouts.empty());
-        return HoldoutSet {std::cbegin(holdouts), std::cend(holdouts), holdout_itr->region};
-    } else {
-        return boost::none;
+        // The preferred candidate always comes first; any alternates follow in
+        // containment order
+        result.reserve(std::min(static_cast<std::size_t>(num_viable_holdouts), max_candidates));
+        const auto add_candidate = [&] (const auto& count) {
+            const auto holdouts = get_holdout_range(active_alleles, count.region);
+            assert(!holdouts.empty());
+            result.emplace_back(std::cbegin(holdouts), std::cend(holdouts), count.region);
+        };
+        add_candidate(*holdout_itr);
+        for (auto itr = std::begin(containment_counts);
+             itr != last_viable_holdout && result.size() < max_candidates; ++itr) {
+            if (itr != holdout_itr) add_candidate(*itr);
+        }
     }
+    return result;
+}
+
+bool HaplotypeGenerator::is_viable_holdout_choice(const HoldoutSet& holdouts, const GenomicRegion& novel_region) const
+{
+    HaplotypeTree trial_tree {tree_};
+    trial_tree.clear(novel_region);
+    const auto novel_alleles = overlap_range(alleles_, novel_region);
+    std::vector<Allele> remaining_alleles {};
+    remaining_alleles.reserve(base_size(novel_alleles));
+    std::copy_if(std::cbegin(novel_alleles), std::cend(novel_alleles), std::back_inserter(remaining_alleles),
+                 [&holdouts] (const auto& allele) { return !is_same_region(allele, holdouts.region); });
+    const auto last_added = extend_tree_until(remaining_alleles, trial_tree, policies_.haplotype_limits.holdout);
+    return last_added == std::cend(remaining_alleles);
 }
 
 bool HaplotypeGenerator::can_reintroduce_holdouts() const noexcept
@@ -27,6 +27,7 @@ namespace octopus {
 
 class Variant;
 class Haplotype;
+class ThreadPool;
 
 namespace coretools {
 
@@ -102,7 +103,13 @@ public:
     // Discards any equivilant haplotypes that are not in the given set of
     // haplotypes.
     template <typename Container> void collapse(const Container& haplotypes);
-    
+
+    // Trials alternative holdout sets concurrently on copies of the haplotype
+    // tree when the generator overflows and must backtrack, committing to the
+    // first viable set rather than discovering failures serially. The pool
+    // must outlive the generator.
+    void enable_parallel_holdout_search(ThreadPool& workers) noexcept;
+
 private:
     struct HoldoutSet
     {
@@ -133,6 +140,7 @@ private:
     std::stack<HoldoutSet> active_holdouts_;
     boost::optional<GenomicRegion> holdout_region_;
     std::set<std::vector<ContigRegion>> previous_holdout_regions_;
+    ThreadPool* holdout_workers_ = nullptr;
     
     Allele rightmost_allele_;
     
@@ -153,8 +161,9 @@ private:
     bool in_holdout_mode() const noexcept;
     const GenomicRegion& top_holdout_region() const;
     bool can_try_extracting_holdouts(const GenomicRegion& region) const noexcept;
-    bool try_extract_holdouts(GenomicRegion region);
-    boost::optional<HoldoutSet> propose_new_holdout_set(GenomicRegion region) const;
+    bool try_extract_holdouts(GenomicRegion region, const GenomicRegion& novel_region);
+    std::vector<HoldoutSet> propose_holdout_candidates(GenomicRegion region, std::size_t max_candidates) const;
+    bool is_viable_holdout_choice(const HoldoutSet& holdouts, const GenomicRegion& novel_region) const;
     bool can_reintroduce_holdouts() const noexcept;
     void reintroduce_holdouts();
     void clear_holdouts() noexcept;
@@ -20,6 +20,44 @@
 
 namespace octopus { namespace coretools {
 
+// Walks the alleles on a branch from a leaf back towards the root, stepping
+// through path-compressed runs one allele at a time
+class HaplotypeTree::AlleleWalker
+{
+public:
+    AlleleWalker() = delete;
+
+    AlleleWalker(const HaplotypeTree& tree, Vertex leaf)
+    : tree_ {tree}
+    , vertex_ {leaf}
+    , offset_ {0}
+    {}
+
+    bool at_root() const noexcept
+    {
+        return vertex_ == tree_.get().root_;
+    }
+
+    const ContigAllele& allele() const noexcept
+    {
+        const auto& run = tree_.get().tree_[vertex_].alleles;
+        return *std::next(std::crbegin(run), offset_);
+    }
+
+    void advance()
+    {
+        if (++offset_ == tree_.get().tree_[vertex_].alleles.size()) {
+            vertex_ = tree_.get().get_previous_allele(vertex_);
+            offset_ = 0;
+        }
+    }
+
+private:
+    std::reference_wrapper<const HaplotypeTree> tree_;
+    Vertex vertex_;
+    std::size_t offset_;
+};
+
 HaplotypeTree::HaplotypeTree(const GenomicRegion::ContigName& contig, const ReferenceGenome& reference)
 : reference_ {reference}
 , tree_ {}
@@ -189,7 +227,7 @@ struct Splicer : public boost::default_dfs_visitor
     {
         if (!candidate_splice_sites_.empty() && v == candidate_splice_sites_.top()) {
             candidate_splice_sites_.pop();
-            if (v == root_ || is_after(allele_.get(), tree[v])) {
+            if (v == root_ || is_after(allele_.get(), tree[v].alleles.front())) {
                 splice_sites_.push_back(v);
             } else {
                 const auto u = *boost::inv_adjacent_vertices(v, tree).first;
@@ -217,9 +255,10 @@ template <typename V, typename G>
 bool is_possible_splice_site(const ContigAllele& allele, const V& v, const G& tree)
 {
     // Can allele go before v in the tree?
-    return begins_before(allele, tree[v])
-           || (boost::out_degree(v, tree) == 0 && overlaps(allele, tree[v]))
-           || (begins_equal(allele, tree[v]) && (!is_empty_region(tree[v]) || (is_insertion(tree[v]) && is_deletion(allele))));
+    const auto& vertex_allele = tree[v].alleles.front();
+    return begins_before(allele, vertex_allele)
+           || (boost::out_degree(v, tree) == 0 && overlaps(allele, vertex_allele))
+           || (begins_equal(allele, vertex_allele) && (!is_empty_region(vertex_allele) || (is_insertion(vertex_allele) && is_deletion(allele))));
 }
 
 bool is_deletion_and_insertion(const ContigAllele& new_allele, const ContigAllele& leaf)
@@ -238,6 +277,7 @@ void HaplotypeTree::splice(const ContigAllele& allele)
         extend(allele);
         return;
     }
+    expand_all(); // splicing can branch anywhere, so all compressed runs must be expanded
     std::unordered_map<Vertex, boost::default_color_type> colours {};
     colours.reserve(boost::num_vertices(tree_));
     std::deque<Vertex> splice_sites {};
@@ -262,8 +302,8 @@ void HaplotypeTree::splice(const ContigAllele& allele)
                              });
     assert(candidate_splice_sites.empty());
     for (const auto v : splice_sites) {
-        if (can_add_to_branch(allele, tree_[v])) {
-            const auto spliced = boost::add_vertex(allele, tree_);
+        if (v == root_ || can_add_to_branch(allele, tree_[v].alleles.back())) {
+            const auto spliced = boost::add_vertex(AlleleRun {{allele}}, tree_);
             boost::add_edge(v, spliced, tree_);
             haplotype_leafs_.push_back(spliced);
         }
@@ -288,13 +328,13 @@ GenomicRegion HaplotypeTree::encompassing_region() const
     const auto p = boost::adjacent_vertices(root_, tree_);
     const auto leftmost = *std::min_element(p.first, p.second,
                                             [this] (const auto& lhs, const auto& rhs) {
-                                                return begins_before(tree_[lhs], tree_[rhs]);
+                                                return begins_before(tree_[lhs].alleles.front(), tree_[rhs].alleles.front());
                                             });
     const auto rightmost = *std::max_element(std::cbegin(haplotype_leafs_), std::cend(haplotype_leafs_),
                                              [this] (const auto& lhs, const auto& rhs) {
-                                                 return ends_before(tree_[lhs], tree_[rhs]);
+                                                 return ends_before(tree_[lhs].alleles.back(), tree_[rhs].alleles.back());
                                              });
-    tree_region_ = GenomicRegion {contig_, octopus::encompassing_region(tree_[leftmost], tree_[rightmost])};
+    tree_region_ = GenomicRegion {contig_, octopus::encompassing_region(tree_[leftmost].alleles.front(), tree_[rightmost].alleles.back())};
     return *tree_region_;
 }
 
@@ -314,14 +354,43 @@ std::vector<Haplotype> HaplotypeTree::extract_haplotypes(const GenomicRegion& re
     std::vector<Haplotype> result {};
     if (is_empty() || !overlaps(region, encompassing_region())) return result;
     result.reserve(num_haplotypes());
-    for (const auto leaf : haplotype_leafs_) {
-        auto haplotype = extract_haplotype(leaf, region);
+    // Haplotypes are built root-down so branches that share a prefix share its
+    // construction (in particular the intervening reference alleles), rather
+    // than each leaf rebuilding its full branch from scratch
+    extract_haplotypes(root_, Haplotype::Builder {region, reference_}, region, result);
+    return result;
+}
+
+void HaplotypeTree::extract_haplotypes(const Vertex v, Haplotype::Builder builder, const GenomicRegion& region,
+                                       std::vector<Haplotype>& result) const
+{
+    if (v != root_) {
+        using octopus::contains;
+        for (const auto& allele : tree_[v].alleles) {
+            if (contains(region.contig_region(), allele)) {
+                builder.push_back(allele);
+            }
+        }
+    }
+    if (boost::out_degree(v, tree_) == 0) {
+        auto haplotype = builder.build();
         // recently retreived haplotypes are added to the cache as it is likely these
         // are the haplotypes that will be pruned next
-        haplotype_leaf_cache_.emplace(haplotype, leaf);
+        haplotype_leaf_cache_.emplace(haplotype, v);
         result.push_back(std::move(haplotype));
+    } else {
+        const auto p = boost::adjacent_vertices(v, tree_);
+        for (auto it = p.first; it != p.second; ++it) {
+            const auto next = std::next(it);
+            if (next == p.second) {
+                // the last child can take the prefix built so far by move
+                extract_haplotypes(*it, std::move(builder), region, result);
+                break;
+            } else {
+                extract_haplotypes(*it, builder, region, result);
+            }
+        }
     }
-    return result;
 }
 
 std::vector<HaplotypeTree::HaplotypeLength> HaplotypeTree::extract_haplotype_lengths() const
@@ -458,6 +527,68 @@ HaplotypeTree::Vertex HaplotypeTree::get_previous_allele(const Vertex allele) co
     return *p.first;
 }
 
+// Expands a path-compressed vertex into a chain of single-allele vertices.
+// v keeps the last allele of its run, along with its children and any external
+// references to it (leaf list and cache entries), and the vertex holding the
+// first allele of the run is returned
+HaplotypeTree::Vertex HaplotypeTree::expand(const Vertex v)
+{
+    auto& run = tree_[v].alleles;
+    if (run.size() < 2) return v;
+    const auto p = boost::inv_adjacent_vertices(v, tree_);
+    boost::optional<Vertex> parent {};
+    if (p.first != p.second) {
+        parent = *p.first;
+        boost::remove_edge(*parent, v, tree_);
+    }
+    boost::optional<Vertex> head {}, prev {};
+    for (std::size_t i {0}; i + 1 < run.size(); ++i) {
+        const auto u = boost::add_vertex(AlleleRun {{std::move(run[i])}}, tree_);
+        if (prev) {
+            boost::add_edge(*prev, u, tree_);
+        } else {
+            head = u;
+        }
+        prev = u;
+    }
+    run.front() = std::move(run.back());
+    run.resize(1);
+    if (parent) boost::add_edge(*parent, *head, tree_);
+    boost::add_edge(*prev, v, tree_);
+    return *head;
+}
+
+// Expands any compressed runs on the branch ending at leaf that overlap region,
+// so that subsequent per-allele logic over the region sees single-allele vertices
+void HaplotypeTree::expand_overlapped(const Vertex leaf, const ContigRegion& region)
+{
+    auto v = leaf;
+    while (v != root_) {
+        const auto& run = tree_[v].alleles;
+        const auto run_region = octopus::encompassing_region(run.front(), run.back());
+        // The boundary alleles must be checked individually as an empty allele
+        // abutting the region overlaps it even though the run region does not
+        if (overlaps(region, run_region) || overlaps(region, run.front()) || overlaps(region, run.back())) {
+            v = expand(v);
+        } else if (!is_after(run_region, region)) {
+            break; // everything closer to the root is before the region
+        }
+        v = get_previous_allele(v);
+    }
+}
+
+void HaplotypeTree::expand_all()
+{
+    std::vector<Vertex> compressed {};
+    const auto p = boost::vertices(tree_);
+    std::for_each(p.first, p.second, [this, &compressed] (const Vertex v) {
+        if (tree_[v].alleles.size() > 1) compressed.push_back(v);
+    });
+    for (const auto v : compressed) {
+        expand(v);
+    }
+}
+
 bool HaplotypeTree::is_bifurcating(const Vertex v) const
 {
     return boost::out_degree(v, tree_) > 1;
@@ -486,14 +617,15 @@ bool HaplotypeTree::allele_exists(Vertex leaf, const ContigAllele& allele) const
     const auto vertex_range = boost::adjacent_vertices(leaf, tree_);
     return std::any_of(vertex_range.first, vertex_range.second,
                        [this, &allele] (const Vertex vertex) {
-                           return tree_[vertex] == allele;
+                           return tree_[vertex].alleles.front() == allele;
                        });
 }
 
 HaplotypeTree::Vertex HaplotypeTree::find_allele_before(Vertex v, const ContigAllele& allele) const
 {
-    while (v != root_ && overlaps(allele, tree_[v])) {
-        if (is_same_region(allele, tree_[v])) { // for insertions
+    // Vertices overlapping allele have been expanded, so hold a single allele each
+    while (v != root_ && overlaps(allele, tree_[v].alleles.back())) {
+        if (is_same_region(allele, tree_[v].alleles.back())) { // for insertions
             v = get_previous_allele(v);
             break;
         }
@@ -506,23 +638,24 @@ HaplotypeTree::LeafIterator
 HaplotypeTree::extend_haplotype(LeafIterator leaf_itr, const ContigAllele& new_allele)
 {
     if (*leaf_itr == root_) {
-        const auto new_leaf = boost::add_vertex(new_allele, tree_);
+        const auto new_leaf = boost::add_vertex(AlleleRun {{new_allele}}, tree_);
         boost::add_edge(*leaf_itr, new_leaf, tree_);
         leaf_itr = haplotype_leafs_.erase(leaf_itr);
         return haplotype_leafs_.insert(leaf_itr, new_leaf);
     }
-    const auto& leaf_allele = tree_[*leaf_itr];
+    const auto& leaf_allele = tree_[*leaf_itr].alleles.back();
     if (can_add_to_branch(new_allele, leaf_allele)) {
         if (is_after(new_allele, leaf_allele)) {
-            const auto new_leaf = boost::add_vertex(new_allele, tree_);
-            boost::add_edge(*leaf_itr, new_leaf, tree_);
-            leaf_itr = haplotype_leafs_.erase(leaf_itr);
-            leaf_itr = haplotype_leafs_.insert(leaf_itr, new_leaf);
-        } else if (overlaps(new_allele, tree_[*leaf_itr])) {
+            // A leaf can only grow linearly, so the new allele joins the leaf's
+            // run rather than becoming a vertex of its own
+            assert(boost::out_degree(*leaf_itr, tree_) == 0);
+            tree_[*leaf_itr].alleles.push_back(new_allele);
+        } else if (overlaps(new_allele, leaf_allele)) {
+            expand_overlapped(*leaf_itr, contig_region(new_allele));
             const auto branch_point = find_allele_before(*leaf_itr, new_allele);
-            if ((branch_point == root_ || can_add_to_branch(new_allele, tree_[branch_point]))
+            if ((branch_point == root_ || can_add_to_branch(new_allele, tree_[branch_point].alleles.back()))
                 && !allele_exists(branch_point, new_allele)) {
-                const auto new_leaf = boost::add_vertex(new_allele, tree_);
+                const auto new_leaf = boost::add_vertex(AlleleRun {{new_allele}}, tree_);
                 boost::add_edge(branch_point, new_leaf, tree_);
                 haplotype_leafs_.insert(leaf_itr, new_leaf);
             }
@@ -535,13 +668,14 @@ Haplotype HaplotypeTree::extract_haplotype(Vertex leaf, const GenomicRegion& reg
 {
     const auto& contig_region = region.contig_region();
     using octopus::contains;
-    while (leaf != root_ && !contains(contig_region, tree_[leaf])) {
-        leaf = get_previous_allele(leaf);
+    AlleleWalker walker {*this, leaf};
+    while (!walker.at_root() && !contains(contig_region, walker.allele())) {
+        walker.advance();
     }
     Haplotype::Builder result {region, reference_};
-    while (leaf != root_ && contains(contig_region, tree_[leaf])) {
-        result.push_front(tree_[leaf]);
-        leaf = get_previous_allele(leaf);
+    while (!walker.at_root() && contains(contig_region, walker.allele())) {
+        result.push_front(walker.allele());
+        walker.advance();
     }
     return result.build();
 }
@@ -550,25 +684,26 @@ HaplotypeTree::HaplotypeLength HaplotypeTree::extract_haplotype_length(Vertex le
 {
     const auto& contig_region = region.contig_region();
     using octopus::contains;
-    while (leaf != root_ && !contains(contig_region, tree_[leaf])) {
-        leaf = get_previous_allele(leaf);
+    AlleleWalker walker {*this, leaf};
+    while (!walker.at_root() && !contains(contig_region, walker.allele())) {
+        walker.advance();
     }
-    if (leaf == root_) {
+    if (walker.at_root()) {
         return size(contig_region);
     }
-    HaplotypeLength result {right_overhang_size(contig_region, tree_[leaf])};
-    auto prev_node = leaf;
+    HaplotypeLength result {right_overhang_size(contig_region, walker.allele())};
+    ContigAllele prev_allele {walker.allele()};
     while (true) {
-        result += sequence_size(tree_[leaf]);
-        prev_node = leaf;
-        leaf = get_previous_allele(leaf);
-        if (leaf != root_ && contains(contig_region, tree_[leaf])) {
-            result += inner_distance(tree_[leaf], tree_[prev_node]);
+        result += sequence_size(walker.allele());
+        prev_allele = walker.allele();
+        walker.advance();
+        if (!walker.at_root() && contains(contig_region, walker.allele())) {
+            result += inner_distance(walker.allele(), prev_allele);
         } else {
             break;
         }
     }
-    result += left_overhang_size(contig_region, tree_[prev_node]);
+    result += left_overhang_size(contig_region, prev_allele);
     return result;
 }
 
@@ -577,24 +712,26 @@ bool HaplotypeTree::define_same_haplotype(Vertex leaf1, Vertex leaf2) const
     if (leaf1 == leaf2) {
         return true;
     }
-    while (leaf1 != root_) {
-        if (leaf2 == root_ || tree_[leaf1] != tree_[leaf2]) return false;
-        leaf1 = get_previous_allele(leaf1);
-        leaf2 = get_previous_allele(leaf2);
+    AlleleWalker lhs {*this, leaf1}, rhs {*this, leaf2};
+    while (!lhs.at_root()) {
+        if (rhs.at_root() || lhs.allele() != rhs.allele()) return false;
+        lhs.advance();
+        rhs.advance();
     }
-    return leaf2 == root_;
+    return rhs.at_root();
 }
 
-bool HaplotypeTree::is_branch_exact_haplotype(Vertex leaf, const Haplotype& haplotype) const
+bool HaplotypeTree::is_branch_exact_haplotype(const Vertex leaf, const Haplotype& haplotype) const
 {
-    if (leaf == root_ || !overlaps(tree_[leaf], contig_region(haplotype))) {
+    if (leaf == root_ || !overlaps(tree_[leaf].alleles.back(), contig_region(haplotype))) {
         return false;
     }
-    while (leaf != root_) {
-        if (!haplotype.includes(tree_[leaf])) {
+    AlleleWalker walker {*this, leaf};
+    while (!walker.at_root()) {
+        if (!haplotype.includes(walker.allele())) {
             return false;
         }
-        leaf = get_previous_allele(leaf);
+        walker.advance();
     }
     return true;
 }
@@ -602,7 +739,7 @@ bool HaplotypeTree::is_branch_exact_haplotype(Vertex leaf, const Haplotype& hapl
 bool HaplotypeTree::is_branch_equal_haplotype(const Vertex leaf, const Haplotype& haplotype) const
 {
     // TODO: check if this is quicker than calling Haplotype::contains for each ContigAllele
-    return leaf != root_ && overlaps(contig_region(haplotype), tree_[leaf])
+    return leaf != root_ && overlaps(contig_region(haplotype), tree_[leaf].alleles.back())
             && extract_haplotype(leaf, haplotype.mapped_region()) == haplotype;
 }
 
@@ -629,7 +766,10 @@ HaplotypeTree::find_equal_haplotype_leaf(const LeafIterator first, const LeafIte
 std::pair<HaplotypeTree::Vertex, bool>
 HaplotypeTree::clear(const Vertex leaf, const ContigRegion& region)
 {
-    if (overlaps(region, tree_[leaf])) {
+    // Clearing can cut a branch anywhere in the region, so any compressed runs
+    // the region overlaps must be expanded first
+    expand_overlapped(leaf, region);
+    if (overlaps(region, tree_[leaf].alleles.back())) {
         return clear_external(leaf, region);
     } else {
         return clear_internal(leaf, region);
@@ -643,7 +783,7 @@ HaplotypeTree::clear_external(Vertex leaf, const ContigRegion& region)
     while (leaf != root_) {
         if (boost::out_degree(leaf, tree_) > 0) {
             return std::make_pair(leaf, false);
-        } else if (begins_before(tree_[leaf], region)) {
+        } else if (begins_before(tree_[leaf].alleles.front(), region)) {
             return std::make_pair(leaf, true);
         } else {
             leaf = remove_backward(leaf);
@@ -657,7 +797,7 @@ std::pair<HaplotypeTree::Vertex, bool>
 HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
 {
     // TODO: we can optimise this for cases where region overlaps the leftmost alleles in the tree
-    if (leaf == root_ || is_after(region, tree_[leaf])) {
+    if (leaf == root_ || is_after(region, tree_[leaf].alleles.back())) {
         return std::make_pair(leaf, true);
     }
     Vertex current_allele {leaf}, allele_to_move {leaf};
@@ -665,7 +805,7 @@ HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
     bool is_bifurcating_branch {false};
     while (true) {
         current_allele = get_previous_allele(current_allele);
-        if (current_allele == root_ || overlaps(tree_[current_allele], region)) {
+        if (current_allele == root_ || overlaps(tree_[current_allele].alleles.back(), region)) {
             break;
         }
         is_bifurcating_branch = is_bifurcating_branch || is_bifurcating(current_allele);
@@ -681,7 +821,8 @@ HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
         assert(alleles_to_copy.back() != allele_to_move);
         boost::remove_edge(alleles_to_copy.back(), allele_to_move, tree_);
     }
-    while (current_allele != root_ && overlaps(region, tree_[current_allele])) {
+    // Vertices overlapping region have been expanded, so each holds a single allele
+    while (current_allele != root_ && overlaps(region, tree_[current_allele].alleles.back())) {
         const auto previous_allele = get_previous_allele(current_allele);
         is_bifurcating_branch = is_bifurcating_branch || boost::out_degree(current_allele, tree_) > 0;
         if (!is_bifurcating_branch) {
@@ -701,20 +842,25 @@ HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
     alleles_to_copy.clear();
     alleles_to_copy.shrink_to_fit();
     auto allele_to_move_to = current_allele;
-    // Now avoid duplicate branches
+    // Now avoid duplicate branches. Equal haplotype suffixes can be chunked into
+    // runs differently on different branches, so both sides of each comparison
+    // are expanded and compared one allele at a time
     while (true) {
+        if (tree_[allele_to_move].alleles.size() > 1) {
+            allele_to_move = expand(allele_to_move);
+        }
         const auto vertex_range = boost::adjacent_vertices(allele_to_move_to, tree_);
         const auto it = std::find_if(vertex_range.first, vertex_range.second,
                                      [this, allele_to_move] (const Vertex allele) {
-                                         return tree_[allele] == tree_[allele_to_move];
+                                         return tree_[allele].alleles.front() == tree_[allele_to_move].alleles.front();
                                      });
         if (it == vertex_range.second) break;
-        allele_to_move_to = *it; // i.e. move forward
+        allele_to_move_to = expand(*it); // i.e. move forward
         if (boost::out_degree(allele_to_move, tree_) == 0) break;
         // Safe to remove forward as we made this branch earlier via copies
         allele_to_move = remove_forward(allele_to_move);
     }
-    if (allele_to_move_to == root_ || tree_[allele_to_move_to] != tree_[allele_to_move]) {
+    if (allele_to_move_to == root_ || tree_[allele_to_move_to].alleles != tree_[allele_to_move].alleles) {
         boost::add_edge(allele_to_move_to, allele_to_move, tree_);
         return std::make_pair(leaf, true);
     } else {
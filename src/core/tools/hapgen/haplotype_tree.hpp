@@ -86,12 +86,24 @@ public:
     void clear() noexcept;
     
 private:
+    // Runs of non-branching alleles are path compressed into a single vertex
+    // holding the run in genomic order, so the number of vertices scales with
+    // the number of branch points rather than the number of alleles. The root
+    // holds an empty run. Compressed vertices are expanded lazily when an
+    // operation needs to branch or cut inside a run.
+    struct AlleleRun
+    {
+        std::vector<ContigAllele> alleles;
+    };
+
     using Tree = boost::adjacency_list<
-        boost::listS, boost::listS, boost::bidirectionalS, ContigAllele, boost::no_property
+        boost::listS, boost::listS, boost::bidirectionalS, AlleleRun, boost::no_property
     >;
-    
+
     using Vertex = boost::graph_traits<Tree>::vertex_descriptor;
     using Edge   = boost::graph_traits<Tree>::edge_descriptor;
+
+    class AlleleWalker;
     
     using HaplotypeVertexMultiMap = std::unordered_multimap<Haplotype, Vertex>;
     
@@ -111,10 +123,15 @@ private:
     Vertex remove_forward(Vertex u);
     Vertex remove_backward(Vertex v);
     Vertex get_previous_allele(Vertex allele) const;
+    Vertex expand(Vertex v);
+    void expand_overlapped(Vertex leaf, const ContigRegion& region);
+    void expand_all();
     Vertex find_allele_before(Vertex v, const ContigAllele& allele) const;
     bool allele_exists(Vertex leaf, const ContigAllele& allele) const;
     LeafIterator extend_haplotype(LeafIterator leaf, const ContigAllele& new_allele);
     Haplotype extract_haplotype(Vertex leaf, const GenomicRegion& region) const;
+    void extract_haplotypes(Vertex v, Haplotype::Builder builder, const GenomicRegion& region,
+                            std::vector<Haplotype>& result) const;
     HaplotypeLength extract_haplotype_length(Vertex leaf, const GenomicRegion& region) const;
     bool define_same_haplotype(Vertex leaf1, Vertex leaf2) const;
     bool is_branch_exact_haplotype(Vertex branch_vertex, const Haplotype& haplotype) const;
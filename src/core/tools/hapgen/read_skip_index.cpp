@@ -0,0 +1,104 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "read_skip_index.hpp"
+
+#include "basics/aligned_read.hpp"
+
+namespace octopus { namespace coretools {
+
+ReadSkipIndex::ReadSkipIndex(const ReadMap& reads)
+{
+    samples_.reserve(reads.size());
+    for (const auto& p : reads) {
+        SampleIndex sample_index {};
+        ContigIndex* contig_index {nullptr};
+        GenomicRegion::ContigName current_contig {};
+        for (const auto& read : p.second) {
+            if (!contig_index || contig_name(read) != current_contig) {
+                current_contig = contig_name(read);
+                contig_index = &sample_index[current_contig];
+            }
+            const auto& read_region = contig_region(read);
+            contig_index->begins.push_back(read_region.begin());
+            if (contig_index->rightmost.empty()) {
+                contig_index->rightmost.push_back(read_region);
+            } else {
+                const auto& prev_rightmost = contig_index->rightmost.back();
+                if (ends_before(prev_rightmost, read_region)
+                    || (ends_equal(prev_rightmost, read_region) && begins_before(prev_rightmost, read_region))) {
+                    contig_index->rightmost.push_back(read_region);
+                } else {
+                    contig_index->rightmost.push_back(prev_rightmost);
+                }
+            }
+        }
+        samples_.push_back(std::move(sample_index));
+    }
+}
+
+namespace {
+
+// The number of reads that begin early enough to overlap the given region. An
+// empty region is overlapped by a read beginning exactly at it, matching the
+// overlap convention for empty regions.
+std::size_t count_possible_overlapped(const std::vector<ContigRegion::Position>& begins,
+                                      const ContigRegion& region)
+{
+    const auto itr = is_empty(region) ? std::upper_bound(std::cbegin(begins), std::cend(begins), region.begin())
+                                      : std::lower_bound(std::cbegin(begins), std::cend(begins), region.end());
+    return static_cast<std::size_t>(std::distance(std::cbegin(begins), itr));
+}
+
+// Checks whether a read with the given extent reaches far enough right to
+// overlap the given region
+bool reaches(const ContigRegion& read_extent, const ContigRegion& region) noexcept
+{
+    return is_empty(region) ? read_extent.end() >= region.begin() : read_extent.end() > region.begin();
+}
+
+} // namespace
+
+bool ReadSkipIndex::has_shared(const GenomicRegion& lhs, const GenomicRegion& rhs) const
+{
+    return std::any_of(std::cbegin(samples_), std::cend(samples_),
+                       [this, &lhs, &rhs] (const auto& sample) { return has_shared(sample, lhs, rhs); });
+}
+
+bool ReadSkipIndex::all_shared(const GenomicRegion& lhs, const GenomicRegion& rhs) const
+{
+    return std::all_of(std::cbegin(samples_), std::cend(samples_),
+                       [this, &lhs, &rhs] (const auto& sample) { return has_shared(sample, lhs, rhs); });
+}
+
+bool ReadSkipIndex::has_shared(const SampleIndex& sample, const GenomicRegion& lhs, const GenomicRegion& rhs) const
+{
+    if (!is_same_contig(lhs, rhs)) return false;
+    const auto contig_itr = sample.find(lhs.contig_name());
+    if (contig_itr == std::cend(sample)) return false;
+    const auto& contig_index = contig_itr->second;
+    // A read overlaps both regions iff it begins before the leftmost end and
+    // reaches past the rightmost begin, so only the rightmost extent amongst
+    // the reads beginning early enough needs checking
+    const auto num_candidates = std::min(count_possible_overlapped(contig_index.begins, lhs.contig_region()),
+                                         count_possible_overlapped(contig_index.begins, rhs.contig_region()));
+    if (num_candidates == 0) return false;
+    const auto& extent = contig_index.rightmost[num_candidates - 1];
+    return reaches(extent, lhs.contig_region()) && reaches(extent, rhs.contig_region());
+}
+
+boost::optional<GenomicRegion>
+ReadSkipIndex::rightmost_overlapped(const SampleIndex& sample, const GenomicRegion& region) const
+{
+    const auto contig_itr = sample.find(region.contig_name());
+    if (contig_itr == std::cend(sample)) return boost::none;
+    const auto& contig_index = contig_itr->second;
+    const auto num_candidates = count_possible_overlapped(contig_index.begins, region.contig_region());
+    if (num_candidates == 0) return boost::none;
+    const auto& extent = contig_index.rightmost[num_candidates - 1];
+    if (!reaches(extent, region.contig_region())) return boost::none;
+    return GenomicRegion {region.contig_name(), extent};
+}
+
+} // namespace coretools
+} // namespace octopus
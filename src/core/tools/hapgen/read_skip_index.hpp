@@ -0,0 +1,99 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef read_skip_index_hpp
+#define read_skip_index_hpp
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+
+#include <boost/optional.hpp>
+
+#include "config/common.hpp"
+#include "basics/contig_region.hpp"
+#include "basics/genomic_region.hpp"
+#include "concepts/mappable.hpp"
+#include "utils/mappable_algorithms.hpp"
+
+namespace octopus { namespace coretools {
+
+/**
+    ReadSkipIndex is a per-contig skip index over a fixed set of reads. For each
+    sample it records cumulative read counts by start position and the rightmost
+    read extent at each breakpoint, so the shared-read queries used for region
+    boundary decisions become binary searches rather than scans over the read
+    container.
+ */
+class ReadSkipIndex
+{
+public:
+    ReadSkipIndex() = default;
+
+    explicit ReadSkipIndex(const ReadMap& reads);
+
+    ReadSkipIndex(const ReadSkipIndex&)            = default;
+    ReadSkipIndex& operator=(const ReadSkipIndex&) = default;
+    ReadSkipIndex(ReadSkipIndex&&)                 = default;
+    ReadSkipIndex& operator=(ReadSkipIndex&&)      = default;
+
+    ~ReadSkipIndex() = default;
+
+    // Returns true if any sample has a read overlapping both regions
+    bool has_shared(const GenomicRegion& lhs, const GenomicRegion& rhs) const;
+
+    // Returns true if every sample has a read overlapping both regions
+    bool all_shared(const GenomicRegion& lhs, const GenomicRegion& rhs) const;
+
+    // Returns the first element in [first, last) that shares a read with mappable
+    // in any sample, or last if there are none
+    template <typename ForwardIt, typename MappableType>
+    ForwardIt find_first_shared(ForwardIt first, ForwardIt last, const MappableType& mappable) const;
+
+    // Returns the maximum over samples of the number of elements in [first + 1, last)
+    // that share a read with first
+    template <typename BidirIt>
+    std::size_t max_count_if_shared_with_first(BidirIt first, BidirIt last) const;
+
+private:
+    struct ContigIndex
+    {
+        std::vector<ContigRegion::Position> begins;
+        std::vector<ContigRegion> rightmost;
+    };
+    using SampleIndex = std::unordered_map<GenomicRegion::ContigName, ContigIndex>;
+
+    std::vector<SampleIndex> samples_;
+
+    bool has_shared(const SampleIndex& sample, const GenomicRegion& lhs, const GenomicRegion& rhs) const;
+    boost::optional<GenomicRegion> rightmost_overlapped(const SampleIndex& sample, const GenomicRegion& region) const;
+};
+
+template <typename ForwardIt, typename MappableType>
+ForwardIt ReadSkipIndex::find_first_shared(ForwardIt first, ForwardIt last, const MappableType& mappable) const
+{
+    return std::find_if(first, last, [this, &mappable] (const auto& m) {
+                            return has_shared(mapped_region(m), mapped_region(mappable));
+                        });
+}
+
+template <typename BidirIt>
+std::size_t ReadSkipIndex::max_count_if_shared_with_first(BidirIt first, BidirIt last) const
+{
+    std::size_t result {0};
+    if (first == last) return result;
+    for (const auto& sample : samples_) {
+        const auto rightmost = rightmost_overlapped(sample, mapped_region(*first));
+        if (rightmost) {
+            result = std::max(result, count_overlapped(std::next(first), last, *rightmost));
+        }
+    }
+    return result;
+}
+
+} // namespace coretools
+} // namespace octopus
+
+#endif
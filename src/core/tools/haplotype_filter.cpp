@@ -12,6 +12,7 @@
 #include <limits>
 #include <cassert>
 
+#include <boost/functional/hash.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 
 #include "config/common.hpp"
@@ -422,4 +423,92 @@ extract_removable(const std::vector<Haplotype>& haplotypes,
     return result;
 }
 
+namespace {
+
+using HaplotypeSketch = std::vector<std::size_t>;
+
+constexpr std::size_t sketchSize {32};
+constexpr std::size_t sketchKmerSize {15};
+
+HaplotypeSketch make_sketch(const Haplotype& haplotype)
+{
+    const auto& sequence = haplotype.sequence();
+    if (sequence.size() < sketchKmerSize) return {};
+    HaplotypeSketch hashes(sequence.size() - sketchKmerSize + 1);
+    const auto first_kmer_itr = std::cbegin(sequence);
+    for (std::size_t i {0}; i < hashes.size(); ++i) {
+        hashes[i] = boost::hash_range(std::next(first_kmer_itr, i), std::next(first_kmer_itr, i + sketchKmerSize));
+    }
+    // bottom-s sketch: the s smallest distinct k-mer hashes
+    std::sort(std::begin(hashes), std::end(hashes));
+    hashes.erase(std::unique(std::begin(hashes), std::end(hashes)), std::end(hashes));
+    if (hashes.size() > sketchSize) hashes.resize(sketchSize);
+    return hashes;
+}
+
+std::size_t count_shared(const HaplotypeSketch& lhs, const HaplotypeSketch& rhs)
+{
+    std::size_t result {0};
+    auto lhs_itr = std::cbegin(lhs);
+    auto rhs_itr = std::cbegin(rhs);
+    while (lhs_itr != std::cend(lhs) && rhs_itr != std::cend(rhs)) {
+        if (*lhs_itr < *rhs_itr) {
+            ++lhs_itr;
+        } else if (*rhs_itr < *lhs_itr) {
+            ++rhs_itr;
+        } else {
+            ++result;
+            ++lhs_itr;
+            ++rhs_itr;
+        }
+    }
+    return result;
+}
+
+bool are_near_duplicates(const HaplotypeSketch& lhs, const HaplotypeSketch& rhs,
+                         const std::size_t max_sketch_differences)
+{
+    const auto sketch_size = std::min(lhs.size(), rhs.size());
+    return sketch_size > 0 && count_shared(lhs, rhs) + max_sketch_differences >= sketch_size;
+}
+
+} // namespace
+
+std::size_t collapse_near_duplicates(std::vector<Haplotype>& haplotypes, const IsLessComplex& cmp,
+                                     const std::size_t max_sketch_differences)
+{
+    if (haplotypes.size() < 2) return 0;
+    std::vector<HaplotypeSketch> sketches(haplotypes.size());
+    std::transform(std::cbegin(haplotypes), std::cend(haplotypes), std::begin(sketches), make_sketch);
+    std::vector<std::size_t> order(haplotypes.size());
+    std::iota(std::begin(order), std::end(order), std::size_t {0});
+    std::sort(std::begin(order), std::end(order),
+              [&] (const auto lhs, const auto rhs) { return cmp(haplotypes[lhs], haplotypes[rhs]); });
+    std::vector<std::size_t> representatives {};
+    representatives.reserve(haplotypes.size());
+    std::vector<bool> remove(haplotypes.size(), false);
+    for (const auto idx : order) {
+        const auto cluster_itr = std::find_if(std::cbegin(representatives), std::cend(representatives),
+                                              [&] (const auto representative) {
+                                                  return are_near_duplicates(sketches[idx], sketches[representative],
+                                                                             max_sketch_differences);
+                                              });
+        if (cluster_itr == std::cend(representatives)) {
+            representatives.push_back(idx);
+        } else {
+            remove[idx] = true;
+        }
+    }
+    std::size_t num_kept {0};
+    for (std::size_t idx {0}; idx < haplotypes.size(); ++idx) {
+        if (!remove[idx]) {
+            if (num_kept != idx) haplotypes[num_kept] = std::move(haplotypes[idx]);
+            ++num_kept;
+        }
+    }
+    const auto result = haplotypes.size() - num_kept;
+    haplotypes.erase(std::next(std::begin(haplotypes), num_kept), std::end(haplotypes));
+    return result;
+}
+
 } // namespace octopus
@@ -30,6 +30,15 @@ extract_removable(const std::vector<Haplotype>& haplotypes,
                   const HaplotypeLikelihoodCache& haplotype_likelihoods,
                   std::size_t max_to_remove, double min_posterior);
 
+// Collapses near-duplicate haplotypes before any likelihoods are computed.
+// Each haplotype is reduced to a bottom-s MinHash sketch of its k-mer hashes;
+// haplotypes are greedily clustered with the representatives seen so far, and
+// a haplotype whose sketch differs from a representative's in no more than
+// max_sketch_differences slots is removed. Visiting in complexity order means
+// each cluster keeps its least complex member w.r.t cmp for HMM scoring.
+std::size_t collapse_near_duplicates(std::vector<Haplotype>& haplotypes, const IsLessComplex& cmp,
+                                     std::size_t max_sketch_differences = 2);
+
 } // namespace octopus
 
 #endif
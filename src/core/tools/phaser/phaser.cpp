@@ -9,6 +9,8 @@
 #include <cstddef>
 #include <cmath>
 #include <utility>
+#include <memory>
+#include <future>
 #include <iostream>
 
 #include <boost/functional/hash.hpp>
@@ -111,9 +113,8 @@ double maximum_entropy(const std::size_t num_elements)
 }
 
 template <typename Map>
-double calculate_entropy(const PhaseComplementSet& phase_set, const Map& genotype_posteriors)
+double calculate_entropy(const PhaseComplementSet& phase_set, const Map& genotype_posteriors, const double norm)
 {
-    const auto norm = marginalise(phase_set, genotype_posteriors);
     if (norm <= 0.0) {
         // if norm ~= 0 then every element in the phase must must have probability ~= 0, so it
         // just looks like a uniform distirbution
@@ -127,16 +128,17 @@ double calculate_entropy(const PhaseComplementSet& phase_set, const Map& genotyp
 }
 
 template <typename Map>
-double calculate_relative_entropy(const PhaseComplementSet& phase_set, const Map& genotype_posteriors)
+double calculate_relative_entropy(const PhaseComplementSet& phase_set, const Map& genotype_posteriors, const double norm)
 {
     if (phase_set.size() < 2) return 1.0;
-    return 1.0 - calculate_entropy(phase_set, genotype_posteriors) / maximum_entropy(phase_set.size());
+    return 1.0 - calculate_entropy(phase_set, genotype_posteriors, norm) / maximum_entropy(phase_set.size());
 }
 
 template <typename Map>
 auto calculate_phase_score(const PhaseComplementSet& phase_set, const Map& genotype_posteriors)
 {
-    return marginalise(phase_set, genotype_posteriors) * calculate_relative_entropy(phase_set, genotype_posteriors);
+    const auto norm = marginalise(phase_set, genotype_posteriors);
+    return norm * calculate_relative_entropy(phase_set, genotype_posteriors, norm);
 }
 
 template <typename Map>
@@ -150,6 +152,26 @@ Phred<double> calculate_phase_score(const PhaseComplementSets& phase_sets, const
     }};
 }
 
+template <typename Map>
+boost::optional<Phred<double>>
+calculate_phase_score(const PhaseComplementSets& phase_sets, const Map& genotype_posteriors,
+                      const Phred<double> min_score)
+{
+    const auto required_score = 1.0 - min_score.probability_false();
+    double score {0.0}, scored_mass {0.0};
+    for (const auto& phase_set : phase_sets) {
+        const auto marginal = marginalise(phase_set, genotype_posteriors);
+        score += marginal * calculate_relative_entropy(phase_set, genotype_posteriors, marginal);
+        scored_mass += marginal;
+        // Each remaining set can contribute at most its marginal mass (when its entropy
+        // is zero), so stop as soon as even that bound cannot reach the required score
+        if (score + std::max(0.0, 1.0 - scored_mass) < required_score) {
+            return boost::none;
+        }
+    }
+    return Phred<double> {Phred<double>::Probability {std::max(0.0, 1.0 - score)}};
+}
+
 auto min_phase_score(const double p)
 {
     if (maths::almost_one(p)) {
@@ -210,9 +232,9 @@ force_phase_sample(const GenomicRegion& region,
     auto first_partition = std::cbegin(partitions);
     auto last_partition  = std::cend(partitions);
     auto phase_set = generate_phase_complement_sets(genotypes, first_partition, last_partition);
-    auto phase_score = calculate_phase_score(phase_set, genotype_posteriors);
-    if (phase_score >= min_phase_score) {
-        return {Phaser::PhaseSet::PhaseRegion {region, phase_score}};
+    auto phase_score = calculate_phase_score(phase_set, genotype_posteriors, min_phase_score);
+    if (phase_score && *phase_score >= min_phase_score) {
+        return {Phaser::PhaseSet::PhaseRegion {region, *phase_score}};
     }
     Phaser::PhaseSet::SamplePhaseRegions result {};
     --last_partition;
@@ -222,9 +244,11 @@ force_phase_sample(const GenomicRegion& region,
         auto curr_region = encompassing_region(first_partition, last_partition);
         std::tie(chunks, chunk_posteriors) = copy_and_marginalise(genotypes, genotype_posteriors, curr_region);
         phase_set = generate_phase_complement_sets(chunks, first_partition, last_partition);
-        phase_score = calculate_phase_score(phase_set, chunk_posteriors);
-        if (phase_score >= min_phase_score || std::distance(first_partition, last_partition) == 1) {
-            result.emplace_back(encompassing_region(first_partition, last_partition), phase_score);
+        const bool forced {std::distance(first_partition, last_partition) == 1};
+        phase_score = forced ? calculate_phase_score(phase_set, chunk_posteriors)
+                             : calculate_phase_score(phase_set, chunk_posteriors, min_phase_score);
+        if (forced || (phase_score && *phase_score >= min_phase_score)) {
+            result.emplace_back(encompassing_region(first_partition, last_partition), *phase_score);
             first_partition = last_partition;
             last_partition  = std::cend(partitions);
         } else {
@@ -260,9 +284,17 @@ Phaser::force_phase(const std::vector<Haplotype>& haplotypes,
         }
         return result;
     }
+    std::vector<std::pair<std::reference_wrapper<const SampleName>, std::future<PhaseSet::SamplePhaseRegions>>> phase_futures {};
     for (const auto& p : genotype_posteriors) {
         if (genotype_calls && max_phase_score_ && min_phase_score(genotype_calls->at(p.first), p.second) >= *max_phase_score_) {
             result.phase_regions[p.first].emplace_back(haplotype_region, *max_phase_score_);
+        } else if (phasing_workers_ && !phasing_workers_->empty() && genotype_posteriors.size1() > 1) {
+            // Samples phase independently, so their partition scoring can run concurrently
+            phase_futures.emplace_back(std::cref(p.first),
+                                       phasing_workers_->push([&haplotype_region, &partitions, &genotypes,
+                                                               &sample_posteriors = p.second, min_score = min_phase_score_] () {
+                                           return force_phase_sample(haplotype_region, partitions, genotypes, sample_posteriors, min_score);
+                                       }));
         } else {
             auto phases = force_phase_sample(haplotype_region, partitions, genotypes, p.second, min_phase_score_);
             if (max_phase_score_) {
@@ -271,9 +303,21 @@ Phaser::force_phase(const std::vector<Haplotype>& haplotypes,
             result.phase_regions.emplace(p.first, std::move(phases));
         }
     }
+    for (auto& p : phase_futures) {
+        auto phases = p.second.get();
+        if (max_phase_score_) {
+            for (auto& phase : phases) phase.score = std::min(phase.score, *max_phase_score_);
+        }
+        result.phase_regions.emplace(p.first.get(), std::move(phases));
+    }
     return result;
 }
 
+void Phaser::enable_parallel_phasing(ThreadPool& workers) noexcept
+{
+    phasing_workers_ = std::addressof(workers);
+}
+
 // non-member methods
 
 bool is_split_phasing(const Phaser::PhaseSet& phase)
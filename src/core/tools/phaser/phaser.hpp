@@ -18,6 +18,7 @@
 #include "concepts/mappable.hpp"
 #include "concepts/mappable_range.hpp"
 #include "utils/mappable_algorithms.hpp"
+#include "utils/thread_pool.hpp"
 #include "core/types/haplotype.hpp"
 #include "core/types/genotype.hpp"
 #include "basics/phred.hpp"
@@ -53,9 +54,12 @@ public:
                          const std::vector<GenomicRegion>& regions,
                          boost::optional<GenotypeCallMap> genotype_calls = boost::none) const;
     
+    void enable_parallel_phasing(ThreadPool& workers) noexcept;
+    
 private:
     Phred<double> min_phase_score_;
     boost::optional<Phred<double>> max_phase_score_ = Phred<double> {100};
+    ThreadPool* phasing_workers_ = nullptr;
 };
 
 struct Phaser::PhaseSet
@@ -16,6 +16,7 @@
 #include "utils/maths.hpp"
 #include "utils/kmer_mapper.hpp"
 #include "core/models/haplotype_likelihood_model.hpp"
+#include "core/models/haplotype_likelihood_cache.hpp"
 #include "core/models/error/error_model_factory.hpp"
 
 namespace octopus {
@@ -174,7 +175,7 @@ auto calculate_likelihoods(const std::vector<Haplotype>& haplotypes, const std::
     const auto reads_region = encompassing_region(reads);
     const auto read_hashes = compute_read_hashes(reads);
     static constexpr unsigned char mapperKmerSize {6};
-    auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
+    auto& haplotype_hashes = thread_local_kmer_hash_table<mapperKmerSize>();
     HaplotypeLikelihoods result {};
     result.reserve(haplotypes.size());
     const auto max_indel_size = estimate_max_indel_size(haplotypes);
@@ -196,8 +197,179 @@ auto calculate_likelihoods(const std::vector<Haplotype>& haplotypes, const std::
     return result;
 }
 
+// Likelihoods for (read, haplotype) pairs the cache has scored are copied
+// straight out of it; only the remaining pairs are mapped and realigned
+auto calculate_likelihoods(const std::vector<Haplotype>& haplotypes, const std::vector<AlignedRead>& reads,
+                           const CachedHaplotypeLikelihoods& cached_likelihoods,
+                           HaplotypeLikelihoodModel& model)
+{
+    assert(!haplotypes.empty());
+    HaplotypeLikelihoods result(haplotypes.size(), std::vector<double>(reads.size()));
+    std::vector<std::vector<unsigned>> uncached_columns(haplotypes.size());
+    bool has_uncached {false};
+    for (std::size_t k {0}; k < haplotypes.size(); ++k) {
+        for (unsigned i {0}; i < reads.size(); ++i) {
+            const auto cached = cached_likelihoods(reads[i], haplotypes[k]);
+            if (cached) {
+                result[k][i] = *cached;
+            } else {
+                uncached_columns[k].push_back(i);
+                has_uncached = true;
+            }
+        }
+    }
+    if (!has_uncached) return result;
+    const auto reads_region = encompassing_region(reads);
+    const auto read_hashes = compute_read_hashes(reads);
+    static constexpr unsigned char mapperKmerSize {6};
+    auto& haplotype_hashes = thread_local_kmer_hash_table<mapperKmerSize>();
+    const auto max_indel_size = estimate_max_indel_size(haplotypes);
+    for (std::size_t k {0}; k < haplotypes.size(); ++k) {
+        if (uncached_columns[k].empty()) continue;
+        const auto expanded_haplotype = expand_for_alignment(haplotypes[k], reads_region, max_indel_size);
+        populate_kmer_hash_table<mapperKmerSize>(expanded_haplotype.sequence(), haplotype_hashes);
+        auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
+        model.reset(expanded_haplotype);
+        for (const auto i : uncached_columns[k]) {
+            auto mapping_positions = map_query_to_target(read_hashes[i], haplotype_hashes, haplotype_mapping_counts);
+            reset_mapping_counts(haplotype_mapping_counts);
+            result[k][i] = model.evaluate(reads[i], mapping_positions);
+        }
+        clear_kmer_hash_table(haplotype_hashes);
+    }
+    return result;
+}
+
+using HaplotypeAlignments = std::vector<std::vector<HaplotypeLikelihoodModel::Alignment>>;
+
+// As calculate_likelihoods, but keeps the full HMM tracebacks so the chosen
+// alignments can be handed straight to the realigner. expanded_begins is
+// filled with the mapped begin of each haplotype's alignment expansion, which
+// the alignment mapping positions are relative to.
+auto calculate_alignments(const std::vector<Haplotype>& haplotypes, const std::vector<AlignedRead>& reads,
+                          HaplotypeLikelihoodModel& model,
+                          std::vector<GenomicRegion::Position>& expanded_begins)
+{
+    assert(!haplotypes.empty());
+    const auto reads_region = encompassing_region(reads);
+    const auto read_hashes = compute_read_hashes(reads);
+    static constexpr unsigned char mapperKmerSize {6};
+    auto& haplotype_hashes = thread_local_kmer_hash_table<mapperKmerSize>();
+    HaplotypeAlignments result {};
+    result.reserve(haplotypes.size());
+    expanded_begins.clear();
+    expanded_begins.reserve(haplotypes.size());
+    const auto max_indel_size = estimate_max_indel_size(haplotypes);
+    for (const auto& haplotype : haplotypes) {
+        const auto expanded_haplotype = expand_for_alignment(haplotype, reads_region, max_indel_size);
+        expanded_begins.push_back(mapped_begin(expanded_haplotype));
+        populate_kmer_hash_table<mapperKmerSize>(expanded_haplotype.sequence(), haplotype_hashes);
+        auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
+        model.reset(expanded_haplotype);
+        std::vector<HaplotypeLikelihoodModel::Alignment> alignments {};
+        alignments.reserve(reads.size());
+        std::transform(std::cbegin(reads), std::cend(reads), std::cbegin(read_hashes), std::back_inserter(alignments),
+                       [&] (const auto& read, const auto& read_hash) {
+                           auto mapping_positions = map_query_to_target(read_hash, haplotype_hashes, haplotype_mapping_counts);
+                           reset_mapping_counts(haplotype_mapping_counts);
+                           return model.align(read, mapping_positions);
+                       });
+        clear_kmer_hash_table(haplotype_hashes);
+        result.push_back(std::move(alignments));
+    }
+    return result;
+}
+
+auto extract_likelihoods(const HaplotypeAlignments& alignments)
+{
+    HaplotypeLikelihoods result {};
+    result.reserve(alignments.size());
+    for (const auto& haplotype_alignments : alignments) {
+        std::vector<double> likelihoods(haplotype_alignments.size());
+        std::transform(std::cbegin(haplotype_alignments), std::cend(haplotype_alignments), std::begin(likelihoods),
+                       [] (const auto& alignment) { return alignment.likelihood; });
+        result.push_back(std::move(likelihoods));
+    }
+    return result;
+}
+
+auto make_support_alignment(const AlignedRead& read, const HaplotypeLikelihoodModel::Alignment& alignment,
+                            const GenomicRegion::Position expanded_begin)
+{
+    const auto realigned_begin = static_cast<GenomicRegion::Position>(expanded_begin + alignment.mapping_position);
+    GenomicRegion region {contig_name(read), realigned_begin, realigned_begin + reference_size(alignment.cigar)};
+    return SupportAlignment {std::move(region), alignment.cigar};
+}
+
+auto calculate_support(const std::vector<Haplotype>& haplotypes,
+                       const std::vector<AlignedRead>& reads,
+                       const std::vector<double>& log_priors,
+                       const HaplotypeAlignments& alignments,
+                       const std::vector<GenomicRegion::Position>& expanded_begins,
+                       boost::optional<std::deque<AlignedRead>&> ambiguous,
+                       SupportAlignmentMap& support_alignments,
+                       const AssignmentConfig& config)
+{
+    const auto likelihoods = extract_likelihoods(alignments);
+    HaplotypeSupportMap result {};
+    std::vector<unsigned> top {};
+    top.reserve(haplotypes.size());
+    for (unsigned i {0}; i < reads.size(); ++i) {
+        find_map_haplotypes(haplotypes, i, likelihoods, log_priors, top);
+        if (top.size() == 1) {
+            const auto k = top.front();
+            result[haplotypes[k]].push_back(reads[i]);
+            support_alignments.emplace(reads[i], make_support_alignment(reads[i], alignments[k][i], expanded_begins[k]));
+        } else {
+            using UA = AssignmentConfig::AmbiguousAction;
+            switch (config.ambiguous_action) {
+                case UA::first:
+                    result[haplotypes[top.front()]].push_back(reads[i]);
+                    break;
+                case UA::all: {
+                    for (auto idx : top) result[haplotypes[idx]].push_back(reads[i]);
+                    break;
+                }
+                case UA::random: {
+                    result[haplotypes[random_select(top)]].push_back(reads[i]);
+                    break;
+                }
+                case UA::drop:
+                default:
+                    break;
+            }
+            if (ambiguous) ambiguous->push_back(reads[i]);
+        }
+        top.clear();
+    }
+    return result;
+}
+
 } // namespace
 
+CachedHaplotypeLikelihoods::CachedHaplotypeLikelihoods(const HaplotypeLikelihoodCache& likelihoods,
+                                                       const SampleName& sample,
+                                                       const ReadContainer& reads)
+: likelihoods_ {likelihoods}
+, sample_ {sample}
+, read_indices_ {}
+{
+    read_indices_.reserve(reads.size());
+    std::size_t idx {0};
+    for (const AlignedRead& read : reads) {
+        read_indices_.emplace(read, idx++);
+    }
+}
+
+boost::optional<double>
+CachedHaplotypeLikelihoods::operator()(const AlignedRead& read, const Haplotype& haplotype) const
+{
+    if (!likelihoods_.get().contains(haplotype)) return boost::none;
+    const auto idx_itr = read_indices_.find(read);
+    if (idx_itr == std::cend(read_indices_)) return boost::none;
+    return likelihoods_.get()(sample_, haplotype)[idx_itr->second];
+}
+
 HaplotypeSupportMap
 compute_haplotype_support(const Genotype<Haplotype>& genotype,
                           const std::vector<AlignedRead>& reads,
@@ -309,6 +481,55 @@ compute_haplotype_support(const Genotype<Haplotype>& genotype,
     return compute_haplotype_support(genotype, reads, std::move(model), ambiguous, config);
 }
 
+HaplotypeSupportMap
+compute_haplotype_support(const Genotype<Haplotype>& genotype,
+                          const std::vector<AlignedRead>& reads,
+                          const CachedHaplotypeLikelihoods& cached_likelihoods,
+                          AssignmentConfig config)
+{
+    if (!reads.empty()) {
+        if (!genotype.is_homozygous()) {
+            const auto unique_haplotypes = genotype.copy_unique();
+            assert(unique_haplotypes.size() > 1);
+            const auto priors = get_priors(unique_haplotypes, {});
+            auto model = make_default_haplotype_likelihood_model();
+            const auto likelihoods = calculate_likelihoods(unique_haplotypes, reads, cached_likelihoods, model);
+            return calculate_support(unique_haplotypes, reads, priors, likelihoods, boost::none, config);
+        } else if (config.ambiguous_action != AssignmentConfig::AmbiguousAction::drop) {
+            HaplotypeSupportMap result {};
+            result.emplace(genotype[0], reads);
+            return result;
+        }
+    }
+    return {};
+}
+
+HaplotypeSupportMap
+compute_haplotype_support(const Genotype<Haplotype>& genotype,
+                          const std::vector<AlignedRead>& reads,
+                          std::deque<AlignedRead>& ambiguous,
+                          SupportAlignmentMap& support_alignments,
+                          AssignmentConfig config)
+{
+    if (!reads.empty()) {
+        if (!genotype.is_homozygous()) {
+            const auto unique_haplotypes = genotype.copy_unique();
+            assert(unique_haplotypes.size() > 1);
+            const auto priors = get_priors(unique_haplotypes, {});
+            auto model = make_default_haplotype_likelihood_model();
+            std::vector<GenomicRegion::Position> expanded_begins {};
+            const auto alignments = calculate_alignments(unique_haplotypes, reads, model, expanded_begins);
+            return calculate_support(unique_haplotypes, reads, priors, alignments, expanded_begins,
+                                     ambiguous, support_alignments, config);
+        } else if (config.ambiguous_action != AssignmentConfig::AmbiguousAction::drop) {
+            HaplotypeSupportMap result {};
+            result.emplace(genotype[0], reads);
+            return result;
+        }
+    }
+    return {};
+}
+
 AlleleSupportMap
 compute_allele_support(const std::vector<Allele>& alleles, const HaplotypeSupportMap& haplotype_support)
 {
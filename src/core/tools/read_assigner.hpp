@@ -10,6 +10,9 @@
 #include <functional>
 #include <iosfwd>
 
+#include <boost/optional.hpp>
+
+#include "config/common.hpp"
 #include "core/types/haplotype.hpp"
 #include "basics/aligned_read.hpp"
 #include "basics/cigar_string.hpp"
@@ -19,6 +22,7 @@
 namespace octopus {
 
 class HaplotypeLikelihoodModel;
+class HaplotypeLikelihoodCache;
 
 using HaplotypeProbabilityMap = std::unordered_map<Haplotype, double>;
 using ReadSupportSet = std::vector<AlignedRead>;
@@ -31,6 +35,43 @@ struct AssignmentConfig
     enum class AmbiguousAction { drop, first, random, all } ambiguous_action = AmbiguousAction::drop;
 };
 
+// Realigned mapping of a read against the haplotype it was assigned to,
+// extracted from the HMM tracebacks paid for during assignment so that
+// evidence BAM realignment never aligns the same (read, haplotype) pair twice
+struct SupportAlignment
+{
+    GenomicRegion region;
+    CigarString cigar;
+};
+using SupportAlignmentMap = std::unordered_map<AlignedRead, SupportAlignment>;
+
+// A read-to-column index into one sample of a caller's HaplotypeLikelihoodCache,
+// letting read assignment reuse existing p(read | haplotype) scores and realign
+// only the pairs the cache has not scored. The reads must be those the cache was
+// populated with, in container order.
+class CachedHaplotypeLikelihoods
+{
+public:
+    CachedHaplotypeLikelihoods() = delete;
+
+    CachedHaplotypeLikelihoods(const HaplotypeLikelihoodCache& likelihoods, const SampleName& sample,
+                               const ReadContainer& reads);
+
+    CachedHaplotypeLikelihoods(const CachedHaplotypeLikelihoods&)            = default;
+    CachedHaplotypeLikelihoods& operator=(const CachedHaplotypeLikelihoods&) = default;
+    CachedHaplotypeLikelihoods(CachedHaplotypeLikelihoods&&)                 = default;
+    CachedHaplotypeLikelihoods& operator=(CachedHaplotypeLikelihoods&&)      = default;
+
+    ~CachedHaplotypeLikelihoods() = default;
+
+    boost::optional<double> operator()(const AlignedRead& read, const Haplotype& haplotype) const;
+
+private:
+    std::reference_wrapper<const HaplotypeLikelihoodCache> likelihoods_;
+    SampleName sample_;
+    std::unordered_map<AlignedRead, std::size_t> read_indices_;
+};
+
 HaplotypeSupportMap
 compute_haplotype_support(const Genotype<Haplotype>& genotype,
                           const std::vector<AlignedRead>& reads,
@@ -76,6 +117,21 @@ compute_haplotype_support(const Genotype<Haplotype>& genotype,
                           HaplotypeLikelihoodModel model,
                           AssignmentConfig config = AssignmentConfig {});
 
+HaplotypeSupportMap
+compute_haplotype_support(const Genotype<Haplotype>& genotype,
+                          const std::vector<AlignedRead>& reads,
+                          const CachedHaplotypeLikelihoods& cached_likelihoods,
+                          AssignmentConfig config = AssignmentConfig {});
+
+// As above, but also fills support_alignments with the optimal alignment of
+// each unambiguously assigned read against its assigned haplotype
+HaplotypeSupportMap
+compute_haplotype_support(const Genotype<Haplotype>& genotype,
+                          const std::vector<AlignedRead>& reads,
+                          std::deque<AlignedRead>& ambiguous,
+                          SupportAlignmentMap& support_alignments,
+                          AssignmentConfig config = AssignmentConfig {});
+
 template <typename BinaryPredicate>
 AlleleSupportMap
 compute_allele_support(const std::vector<Allele>& alleles,
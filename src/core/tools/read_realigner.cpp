@@ -102,7 +102,7 @@ void realign(std::vector<AlignedRead>& reads, const Haplotype& haplotype, Haplot
 {
     const auto read_hashes = compute_read_hashes(reads);
     static constexpr unsigned char mapperKmerSize {6};
-    auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
+    auto& haplotype_hashes = thread_local_kmer_hash_table<mapperKmerSize>();
     populate_kmer_hash_table<mapperKmerSize>(haplotype.sequence(), haplotype_hashes);
     auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
     model.reset(haplotype);
@@ -137,6 +137,49 @@ void safe_realign(std::vector<AlignedRead>& reads, const Haplotype& haplotype)
     }
 }
 
+namespace {
+
+// Applies cached assignment-time alignments and moves reads without one to the
+// back of the container, returning an iterator to the first such read
+auto apply_support_alignments(std::vector<AlignedRead>& reads, const SupportAlignmentMap& alignments)
+{
+    const auto has_alignment = [&alignments] (const auto& read) { return alignments.count(read) == 1; };
+    const auto first_unaligned_itr = std::stable_partition(std::begin(reads), std::end(reads), has_alignment);
+    std::for_each(std::begin(reads), first_unaligned_itr, [&alignments] (AlignedRead& read) {
+        const auto& alignment = alignments.at(read);
+        read.realign(alignment.region, alignment.cigar);
+    });
+    return first_unaligned_itr;
+}
+
+template <typename UnaryFunction>
+void realign_remainder(std::vector<AlignedRead>& reads, std::vector<AlignedRead>::iterator first_unaligned_itr,
+                       UnaryFunction realigner)
+{
+    if (first_unaligned_itr != std::end(reads)) {
+        std::vector<AlignedRead> unaligned {std::make_move_iterator(first_unaligned_itr),
+                                            std::make_move_iterator(std::end(reads))};
+        realigner(unaligned);
+        std::move(std::begin(unaligned), std::end(unaligned), first_unaligned_itr);
+    }
+}
+
+} // namespace
+
+void realign(std::vector<AlignedRead>& reads, const Haplotype& haplotype, const SupportAlignmentMap& alignments)
+{
+    const auto first_unaligned_itr = apply_support_alignments(reads, alignments);
+    realign_remainder(reads, first_unaligned_itr,
+                      [&] (std::vector<AlignedRead>& unaligned) { realign(unaligned, haplotype); });
+}
+
+void safe_realign(std::vector<AlignedRead>& reads, const Haplotype& haplotype, const SupportAlignmentMap& alignments)
+{
+    const auto first_unaligned_itr = apply_support_alignments(reads, alignments);
+    realign_remainder(reads, first_unaligned_itr,
+                      [&] (std::vector<AlignedRead>& unaligned) { safe_realign(unaligned, haplotype); });
+}
+
 std::vector<AlignedRead> safe_realign(const std::vector<AlignedRead>& reads, const Haplotype& haplotype)
 {
     auto result = reads;
@@ -490,6 +533,13 @@ void safe_realign_to_reference(std::vector<AlignedRead>& reads, const Haplotype&
     rebase(reads, haplotype);
 }
 
+void safe_realign_to_reference(std::vector<AlignedRead>& reads, const Haplotype& haplotype,
+                               const SupportAlignmentMap& alignments)
+{
+    safe_realign(reads, haplotype, alignments);
+    rebase(reads, haplotype);
+}
+
 std::vector<AlignedRead> safe_realign_to_reference(const std::vector<AlignedRead>& reads, const Haplotype& haplotype)
 {
     auto result = safe_realign(reads, haplotype);
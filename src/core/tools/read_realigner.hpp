@@ -10,6 +10,7 @@
 #include "basics/cigar_string.hpp"
 #include "core/types/haplotype.hpp"
 #include "core/models/haplotype_likelihood_model.hpp"
+#include "read_assigner.hpp"
 
 namespace octopus {
 
@@ -24,6 +25,11 @@ std::vector<AlignedRead> realign(const std::vector<AlignedRead>& reads, const Ha
 void safe_realign(std::vector<AlignedRead>& reads, const Haplotype& haplotype);
 std::vector<AlignedRead> safe_realign(const std::vector<AlignedRead>& reads, const Haplotype& haplotype);
 
+// Overloads taking alignments computed during read assignment; reads with an
+// entry are placed directly from it and only the rest are aligned
+void realign(std::vector<AlignedRead>& reads, const Haplotype& haplotype, const SupportAlignmentMap& alignments);
+void safe_realign(std::vector<AlignedRead>& reads, const Haplotype& haplotype, const SupportAlignmentMap& alignments);
+
 CigarString rebase(const CigarString& read_to_haplotype, const CigarString& haplotype_to_reference);
 void rebase(std::vector<AlignedRead>& reads, const Haplotype& haplotype);
 
@@ -32,6 +38,8 @@ std::vector<AlignedRead> realign_to_reference(const std::vector<AlignedRead>& re
 
 void safe_realign_to_reference(std::vector<AlignedRead>& reads, const Haplotype& haplotype);
 std::vector<AlignedRead> safe_realign_to_reference(const std::vector<AlignedRead>& reads, const Haplotype& haplotype);
+void safe_realign_to_reference(std::vector<AlignedRead>& reads, const Haplotype& haplotype,
+                               const SupportAlignmentMap& alignments);
 
 } // namespace
 
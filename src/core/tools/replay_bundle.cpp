@@ -0,0 +1,160 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "replay_bundle.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "basics/aligned_read.hpp"
+#include "io/read/read_writer.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "io/variant/vcf_header.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_writer.hpp"
+
+namespace octopus {
+
+ReplayBundleWriter::ReplayBundleWriter(Path bundle_directory, double threshold_seconds)
+: directory_ {std::move(bundle_directory)}
+, threshold_seconds_ {threshold_seconds}
+, mutex_ {}
+{}
+
+double ReplayBundleWriter::threshold_seconds() const noexcept
+{
+    return threshold_seconds_;
+}
+
+namespace {
+
+auto bundle_name(const GenomicRegion& region)
+{
+    std::ostringstream ss {};
+    ss << region.contig_name() << '_' << region.begin() << '-' << region.end();
+    return ss.str();
+}
+
+void write_reads(const ReadMap& reads, const ReplayBundleWriter::Path& path,
+                 const ReplayBundleWriter::Path& template_path)
+{
+    // The facade indexes the result on destruction, so the bundle BAM opens
+    // like any other input, provided the reads go in coordinate sorted
+    std::vector<AlignedRead> sorted_reads {};
+    for (const auto& p : reads) {
+        sorted_reads.insert(std::cend(sorted_reads), std::cbegin(p.second), std::cend(p.second));
+    }
+    std::sort(std::begin(sorted_reads), std::end(sorted_reads));
+    io::ReadWriter writer {path, template_path};
+    writer << sorted_reads;
+}
+
+auto make_candidate_record(const Variant& variant, const ReferenceGenome& reference)
+{
+    const auto& region = mapped_region(variant);
+    auto pos = region.begin() + 1; // VCF positions are 1-based
+    auto ref = ref_sequence(variant);
+    auto alt = alt_sequence(variant);
+    if ((ref.empty() || alt.empty()) && region.begin() > 0) {
+        // anchor indels on the preceding reference base, as VCF requires
+        const GenomicRegion anchor_region {region.contig_name(), region.begin() - 1, region.begin()};
+        const auto anchor = reference.fetch_sequence(anchor_region);
+        ref.insert(0, anchor);
+        alt.insert(0, anchor);
+        --pos;
+    }
+    return VcfRecord {region.contig_name(), pos, ".", std::move(ref), std::move(alt),
+                      boost::none, std::vector<VcfRecord::KeyType> {}, VcfRecord::ValueMap {}};
+}
+
+void write_candidates(const MappableFlatSet<Variant>& candidates, const GenomicRegion& region,
+                      const ReferenceGenome& reference, const ReplayBundleWriter::Path& path)
+{
+    auto header = VcfHeader::Builder {}
+        .set_file_format("VCFv4.2")
+        .add_contig(region.contig_name(), {{"length", std::to_string(reference.contig_size(region.contig_name()))}})
+        .build_once();
+    VcfWriter writer {path, header};
+    for (const auto& candidate : candidates) {
+        writer << make_candidate_record(candidate, reference);
+    }
+}
+
+auto reference_slice_region(const GenomicRegion& region, const ReferenceGenome& reference)
+{
+    // generous padding so reads and haplotype flanks stay inside the slice
+    constexpr GenomicRegion::Size padding {50000};
+    const auto contig = reference.contig_region(region.contig_name());
+    const auto begin = region.begin() >= padding ? region.begin() - padding : 0;
+    const auto end = std::min(region.end() + padding, contig.end());
+    return GenomicRegion {region.contig_name(), begin, end};
+}
+
+void write_reference_slice(const GenomicRegion& slice, const ReferenceGenome& reference,
+                           const ReplayBundleWriter::Path& path)
+{
+    constexpr std::size_t lineLength {60};
+    const auto sequence = reference.fetch_sequence(slice);
+    std::ofstream fasta {path.string()};
+    fasta << '>' << slice.contig_name() << '\n';
+    // N-pad from the contig start so replay coordinates match the originals
+    const auto slice_begin = static_cast<std::size_t>(slice.begin());
+    const auto total = static_cast<std::size_t>(slice.end());
+    for (std::size_t written {0}; written < total;) {
+        const auto line_bases = std::min(lineLength, total - written);
+        for (std::size_t i {0}; i < line_bases; ++i, ++written) {
+            fasta.put(written < slice_begin ? 'N' : sequence[written - slice_begin]);
+        }
+        fasta.put('\n');
+    }
+    // matching index so the bundle opens without external tools
+    std::ofstream index {path.string() + ".fai"};
+    const auto sequence_offset = slice.contig_name().size() + 2;
+    index << slice.contig_name() << '\t' << total << '\t' << sequence_offset
+          << '\t' << lineLength << '\t' << (lineLength + 1) << '\n';
+}
+
+void write_replay_config(const ReplayBundleWriter::Path& bundle_directory, const GenomicRegion& region)
+{
+    std::ofstream config {(bundle_directory / "replay.config").string()};
+    config << "reference = " << (bundle_directory / "reference.fa").string() << '\n';
+    config << "reads = " << (bundle_directory / "reads.bam").string() << '\n';
+    config << "regions = " << to_string(region) << '\n';
+    // the template BAM header names contigs outside the bundled slice
+    config << "ignore-unmapped-contigs = true" << '\n';
+    // uncomment to call from the captured candidates instead of regenerating
+    // them from the bundled reads
+    config << "# source-candidates = " << (bundle_directory / "candidates.vcf").string() << '\n';
+}
+
+} // namespace
+
+ReplayBundleWriter::Path
+ReplayBundleWriter::write(const GenomicRegion& region, const ReadMap& reads,
+                          const MappableFlatSet<Variant>& candidates,
+                          const ReferenceGenome& reference, const Path& read_template)
+{
+    const auto bundle_directory = directory_ / bundle_name(region);
+    {
+        // Concurrent callers may breach simultaneously; serialise directory
+        // creation and let the first writer of a region win
+        std::lock_guard<std::mutex> lock {mutex_};
+        if (boost::filesystem::exists(bundle_directory)) {
+            return bundle_directory;
+        }
+        boost::filesystem::create_directories(bundle_directory);
+    }
+    write_reads(reads, bundle_directory / "reads.bam", read_template);
+    write_candidates(candidates, region, reference, bundle_directory / "candidates.vcf");
+    write_reference_slice(reference_slice_region(region, reference), reference, bundle_directory / "reference.fa");
+    write_replay_config(bundle_directory, region);
+    return bundle_directory;
+}
+
+} // namespace octopus
@@ -0,0 +1,59 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef replay_bundle_hpp
+#define replay_bundle_hpp
+
+#include <mutex>
+
+#include <boost/filesystem/path.hpp>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "containers/mappable_flat_set.hpp"
+#include "core/types/variant.hpp"
+
+namespace octopus {
+
+class ReferenceGenome;
+
+// Captures the inputs of a slow calling task into a self-contained bundle
+// that can be replayed without the original read set. A bundle directory
+// holds the post-pipe reads as an indexed BAM, the candidate variants as a
+// VCF, a coordinate-preserving reference slice (the contig is N-padded up to
+// the slice so positions match the originals), and a replay.config that
+// 'octopus --replay <bundle>' feeds back through the usual option parsing,
+// reproducing the task in Caller::call with only the bundled inputs
+class ReplayBundleWriter
+{
+public:
+    using Path = boost::filesystem::path;
+
+    ReplayBundleWriter() = delete;
+
+    ReplayBundleWriter(Path bundle_directory, double threshold_seconds);
+
+    ReplayBundleWriter(const ReplayBundleWriter&)            = delete;
+    ReplayBundleWriter& operator=(const ReplayBundleWriter&) = delete;
+    ReplayBundleWriter(ReplayBundleWriter&&)                 = delete;
+    ReplayBundleWriter& operator=(ReplayBundleWriter&&)      = delete;
+
+    ~ReplayBundleWriter() = default;
+
+    double threshold_seconds() const noexcept;
+
+    // Writes the bundle for the given region and returns its directory.
+    // read_template is an existing input BAM used for the output header
+    Path write(const GenomicRegion& region, const ReadMap& reads,
+               const MappableFlatSet<Variant>& candidates,
+               const ReferenceGenome& reference, const Path& read_template);
+
+private:
+    Path directory_;
+    double threshold_seconds_;
+    std::mutex mutex_;
+};
+
+} // namespace octopus
+
+#endif
@@ -7,6 +7,10 @@
 #include <algorithm>
 #include <numeric>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include <boost/iterator/zip_iterator.hpp>
 #include <boost/tuple/tuple.hpp>
 
@@ -63,8 +67,7 @@ double ln_probability_read_correctly_aligned(const double misalign_penalty, cons
     if (k == 0) {
         return 0;
     } else {
-        const auto ln_prob_missmapped = -maths::constants::ln10Div10<> * read.mapping_quality();
-        const auto ln_prob_mapped = std::log(1.0 - std::exp(ln_prob_missmapped));
+        const auto ln_prob_mapped = std::log1p(-maths::phred_to_error_probability(read.mapping_quality()));
         const auto mu = max_expected_mutation_rate * region_size(read);
         auto ln_prob_given_mapped = maths::log_poisson_sf(k, mu);
         return ln_prob_mapped + ln_prob_given_mapped;
@@ -169,13 +172,42 @@ void CigarScanner::add_read(const SampleName& sample, const AlignedRead& read,
         sample_coverage_tracker.add(read);
     }
     if (!is_likely_misaligned(read, misalignment_penalty)) {
-        utils::append(std::move(buffer_), candidates_);
+        if (options_.use_streamed_candidate_bucketing) {
+            bucket_buffered_candidates();
+        } else {
+            utils::append(std::move(buffer_), candidates_);
+        }
     } else {
-        utils::append(std::move(buffer_), likely_misaligned_candidates_);
+        if (options_.use_streamed_candidate_bucketing) {
+            for (const Candidate& candidate : buffer_) {
+                misaligned_bucket_variants_.push_back(candidate.variant);
+            }
+        } else {
+            utils::append(std::move(buffer_), likely_misaligned_candidates_);
+        }
         misaligned_tracker_.add(clipped_mapped_region(read));
     }
 }
 
+void CigarScanner::bucket_buffered_candidates()
+{
+    for (const Candidate& candidate : buffer_) {
+        auto& bucket = observation_buckets_[candidate.variant];
+        auto counts_itr = std::find_if(std::begin(bucket.sample_counts), std::end(bucket.sample_counts),
+                                       [&] (const auto& counts) { return counts.sample.get() == candidate.origin.get(); });
+        if (counts_itr == std::end(bucket.sample_counts)) {
+            bucket.sample_counts.push_back({candidate.origin, {}, {}, 0});
+            counts_itr = std::prev(std::end(bucket.sample_counts));
+        }
+        counts_itr->observed_base_qualities.push_back(sum_base_qualities(candidate));
+        counts_itr->observed_mapping_qualities.push_back(candidate.source.get().mapping_quality());
+        if (candidate.source.get().direction() == AlignedRead::Direction::forward) {
+            ++counts_itr->num_fwd_observations;
+        }
+    }
+    buffer_.clear();
+}
+
 void CigarScanner::do_add_reads(const SampleName& sample, ReadVectorIterator first, ReadVectorIterator last)
 {
     auto& sample_coverage_tracker = sample_read_coverage_tracker_[sample];
@@ -245,11 +277,25 @@ void choose_push_back(Variant candidate, std::vector<Variant>& final_candidates,
 
 std::vector<Variant> CigarScanner::do_generate(const RegionSet& regions) const
 {
-    std::sort(std::begin(candidates_), std::end(candidates_));
-    std::sort(std::begin(likely_misaligned_candidates_), std::end(likely_misaligned_candidates_));
+    if (options_.use_streamed_candidate_bucketing) {
+        bucket_index_.clear();
+        bucket_index_.reserve(observation_buckets_.size());
+        for (const auto& p : observation_buckets_) {
+            bucket_index_.emplace_back(p.first, p.second);
+        }
+        std::sort(std::begin(bucket_index_), std::end(bucket_index_));
+        std::sort(std::begin(misaligned_bucket_variants_), std::end(misaligned_bucket_variants_));
+    } else {
+        std::sort(std::begin(candidates_), std::end(candidates_));
+        std::sort(std::begin(likely_misaligned_candidates_), std::end(likely_misaligned_candidates_));
+    }
     std::vector<Variant> result {};
     for (const auto& region : regions) {
-        generate(region, result);
+        if (options_.use_streamed_candidate_bucketing) {
+            generate_from_buckets(region, result);
+        } else {
+            generate(region, result);
+        }
     }
     return result;
 }
@@ -262,6 +308,11 @@ void CigarScanner::do_clear() noexcept
     candidates_.shrink_to_fit();
     likely_misaligned_candidates_.clear();
     likely_misaligned_candidates_.shrink_to_fit();
+    observation_buckets_.clear();
+    misaligned_bucket_variants_.clear();
+    misaligned_bucket_variants_.shrink_to_fit();
+    bucket_index_.clear();
+    bucket_index_.shrink_to_fit();
     read_coverage_tracker_.clear();
     misaligned_tracker_.clear();
     max_seen_candidate_size_ = 0;
@@ -274,22 +325,50 @@ std::string CigarScanner::name() const
 
 // private methods
 
+namespace {
+
+// Calls op with the offset of every mismatch between two equal-length
+// sequences. On clean data almost every base matches, so blocks of 16 bases
+// are compared at once and only blocks containing a mismatch are inspected
+template <typename UnaryOp>
+void for_each_mismatch(const char* ref, const char* read, const std::size_t size, UnaryOp&& op)
+{
+    std::size_t i {0};
+#ifdef __SSE2__
+    for (; i + 16 <= size; i += 16) {
+        const auto ref_block  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ref + i));
+        const auto read_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(read + i));
+        auto mismatches = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(ref_block, read_block))) ^ 0xFFFFu;
+        while (mismatches != 0) {
+            op(i + __builtin_ctz(mismatches));
+            mismatches &= mismatches - 1;
+        }
+    }
+#endif // __SSE2__
+    for (; i < size; ++i) {
+        if (ref[i] != read[i]) op(i);
+    }
+}
+
+} // namespace
+
 double CigarScanner::add_snvs_in_match_range(const GenomicRegion& region, const AlignedRead& read,
-                                             std::size_t read_index, const SampleName& origin)
+                                             const std::size_t read_index, const SampleName& origin)
 {
     const NucleotideSequence ref_segment {reference_.get().fetch_sequence(region)};
     double misalignment_penalty {0};
-    for (std::size_t ref_index {0}; ref_index < ref_segment.size(); ++ref_index, ++read_index) {
-        const char ref_base {ref_segment[ref_index]}, read_base {read.sequence()[read_index]};
-        if (ref_base != read_base && ref_base != 'N' && read_base != 'N') {
-            const auto begin_pos = region.begin() + static_cast<GenomicRegion::Position>(ref_index);
+    for_each_mismatch(ref_segment.data(), read.sequence().data() + read_index, ref_segment.size(),
+                      [&] (const std::size_t mismatch_index) {
+        const char ref_base {ref_segment[mismatch_index]}, read_base {read.sequence()[read_index + mismatch_index]};
+        if (ref_base != 'N' && read_base != 'N') {
+            const auto begin_pos = region.begin() + static_cast<GenomicRegion::Position>(mismatch_index);
             add_candidate(GenomicRegion {region.contig_name(), begin_pos, begin_pos + 1},
-                          ref_base, read_base, read, read_index, origin);
-            if (read.base_qualities()[read_index] >= options_.misalignment_parameters.snv_threshold) {
+                          ref_base, read_base, read, read_index + mismatch_index, origin);
+            if (read.base_qualities()[read_index + mismatch_index] >= options_.misalignment_parameters.snv_threshold) {
                 misalignment_penalty += options_.misalignment_parameters.snv_penalty;
             }
         }
-    }
+    });
     return misalignment_penalty;
 }
 
@@ -335,6 +414,39 @@ void CigarScanner::generate(const GenomicRegion& region, std::vector<Variant>& r
     }
 }
 
+void CigarScanner::generate_from_buckets(const GenomicRegion& region, std::vector<Variant>& result) const
+{
+    using std::begin; using std::end; using std::cbegin; using std::cend; using std::next;
+    assert(std::is_sorted(std::cbegin(bucket_index_), std::cend(bucket_index_)));
+    auto viable_buckets = overlap_range(bucket_index_, region, max_seen_candidate_size_);
+    if (empty(viable_buckets)) return;
+    result.reserve(result.size() + size(viable_buckets, BidirectionallySortedTag {})); // maximum possible
+    const auto last_viable_bucket_itr = cend(viable_buckets);
+    while (!viable_buckets.empty()) {
+        const BucketEntry& entry {viable_buckets.front()};
+        const auto next_bucket_itr = std::find_if_not(next(cbegin(viable_buckets)), last_viable_bucket_itr,
+                                                      [this, &entry] (const BucketEntry& e) {
+                                                          return options_.match(e.variant, entry.variant);
+                                                      });
+        const auto num_matches = std::distance(cbegin(viable_buckets), next_bucket_itr);
+        const auto observation = make_observation(cbegin(viable_buckets), next_bucket_itr);
+        if (options_.include(observation)) {
+            // Bucket entries are already unique variants
+            std::for_each(cbegin(viable_buckets), next_bucket_itr,
+                          [&] (const BucketEntry& e) { result.push_back(e.variant); });
+        }
+        viable_buckets.advance_begin(num_matches);
+    }
+    if (debug_log_ && !misaligned_bucket_variants_.empty()) {
+        const auto novel_unique_misaligned_variants = get_novel_likely_misaligned_candidates(result);
+        if (!novel_unique_misaligned_variants.empty()) {
+            stream(*debug_log_) << "DynamicCigarScanner: ignoring "
+                                << count_overlapped(novel_unique_misaligned_variants, region)
+                                << " unique candidates in " << region;
+        }
+    }
+}
+
 unsigned CigarScanner::sum_base_qualities(const Candidate& candidate) const noexcept
 {
     const auto first_base_qual_itr = std::next(std::cbegin(candidate.source.get().base_qualities()), candidate.offset);
@@ -387,19 +499,53 @@ CigarScanner::make_observation(const CandidateIterator first_match, const Candid
     return result;
 }
 
+CigarScanner::ObservedVariant
+CigarScanner::make_observation(const BucketIterator first_match, const BucketIterator last_match) const
+{
+    assert(first_match != last_match);
+    const Variant& variant {first_match->variant};
+    ObservedVariant result {};
+    result.variant = variant;
+    result.total_depth = get_min_depth(variant, read_coverage_tracker_);
+    for (auto match_itr = first_match; match_itr != last_match; ++match_itr) {
+        for (const auto& counts : match_itr->bucket.get().sample_counts) {
+            auto observation_itr = std::find_if(std::begin(result.sample_observations), std::end(result.sample_observations),
+                                                [&] (const auto& observation) { return observation.sample.get() == counts.sample.get(); });
+            if (observation_itr == std::end(result.sample_observations)) {
+                const auto depth = get_min_depth(variant, sample_read_coverage_tracker_.at(counts.sample));
+                result.sample_observations.push_back({counts.sample, depth, {}, {}, 0});
+                observation_itr = std::prev(std::end(result.sample_observations));
+            }
+            utils::append(counts.observed_base_qualities, observation_itr->observed_base_qualities);
+            utils::append(counts.observed_mapping_qualities, observation_itr->observed_mapping_qualities);
+            observation_itr->num_fwd_observations += counts.num_fwd_observations;
+        }
+    }
+    std::sort(std::begin(result.sample_observations), std::end(result.sample_observations),
+              [] (const auto& lhs, const auto& rhs) { return lhs.sample.get() < rhs.sample.get(); });
+    return result;
+}
+
 std::vector<Variant>
 CigarScanner::get_novel_likely_misaligned_candidates(const std::vector<Variant>& current_candidates) const
 {
-    std::is_sorted(std::cbegin(likely_misaligned_candidates_), std::cend(likely_misaligned_candidates_));
-    std::vector<Candidate> unique_misaligned_candidates {};
-    unique_misaligned_candidates.reserve(likely_misaligned_candidates_.size());
-    std::unique_copy(std::cbegin(likely_misaligned_candidates_), std::cend(likely_misaligned_candidates_),
-                     std::back_inserter(unique_misaligned_candidates));
     std::vector<Variant> unique_misaligned_variants {};
-    unique_misaligned_variants.reserve(unique_misaligned_candidates.size());
-    std::transform(std::cbegin(unique_misaligned_candidates), std::cend(unique_misaligned_candidates),
-                   std::back_inserter(unique_misaligned_variants),
-                   [] (const Candidate& candidate) { return candidate.variant; });
+    if (options_.use_streamed_candidate_bucketing) {
+        assert(std::is_sorted(std::cbegin(misaligned_bucket_variants_), std::cend(misaligned_bucket_variants_)));
+        unique_misaligned_variants.reserve(misaligned_bucket_variants_.size());
+        std::unique_copy(std::cbegin(misaligned_bucket_variants_), std::cend(misaligned_bucket_variants_),
+                         std::back_inserter(unique_misaligned_variants));
+    } else {
+        std::is_sorted(std::cbegin(likely_misaligned_candidates_), std::cend(likely_misaligned_candidates_));
+        std::vector<Candidate> unique_misaligned_candidates {};
+        unique_misaligned_candidates.reserve(likely_misaligned_candidates_.size());
+        std::unique_copy(std::cbegin(likely_misaligned_candidates_), std::cend(likely_misaligned_candidates_),
+                         std::back_inserter(unique_misaligned_candidates));
+        unique_misaligned_variants.reserve(unique_misaligned_candidates.size());
+        std::transform(std::cbegin(unique_misaligned_candidates), std::cend(unique_misaligned_candidates),
+                       std::back_inserter(unique_misaligned_variants),
+                       [] (const Candidate& candidate) { return candidate.variant; });
+    }
     std::vector<Variant> result {};
     result.reserve(unique_misaligned_variants.size());
     assert(std::is_sorted(std::cbegin(current_candidates), std::cend(current_candidates)));
@@ -16,6 +16,7 @@
 #include "concepts/mappable.hpp"
 #include "concepts/comparable.hpp"
 #include "basics/aligned_read.hpp"
+#include "containers/flat_hash_map.hpp"
 #include "core/types/variant.hpp"
 #include "utils/coverage_tracker.hpp"
 #include "variant_generator.hpp"
@@ -62,6 +63,10 @@ public:
         InclusionPredicate include;
         MatchPredicate match = std::equal_to<> {};
         bool use_clipped_coverage_tracking = false;
+        // When set, each read's observations are folded into a variant-keyed
+        // bucket hash as the read is added, so generation only has to sort the
+        // unique variants seen rather than every observation
+        bool use_streamed_candidate_bucketing = true;
         Variant::MappingDomain::Size max_variant_size = 2000;
         MisalignmentParameters misalignment_parameters = MisalignmentParameters {};
     };
@@ -109,6 +114,35 @@ private:
         friend bool operator<(const Candidate& lhs, const Candidate& rhs) noexcept { return lhs.variant < rhs.variant; }
     };
     
+    // Streamed bucketing folds each read's observations into a variant-keyed
+    // hash as the read is added, keeping only per-sample observation counts,
+    // so no references into the read buffers are retained
+    struct ObservationBucket
+    {
+        struct SampleCounts
+        {
+            std::reference_wrapper<const SampleName> sample;
+            std::vector<unsigned> observed_base_qualities;
+            std::vector<AlignedRead::MappingQuality> observed_mapping_qualities;
+            unsigned num_fwd_observations;
+        };
+        std::vector<SampleCounts> sample_counts;
+    };
+    
+    struct BucketEntry : public Comparable<BucketEntry>, public Mappable<BucketEntry>
+    {
+        BucketEntry(const Variant& variant, const ObservationBucket& bucket)
+        : variant {variant}, bucket {bucket} {}
+        
+        std::reference_wrapper<const Variant> variant;
+        std::reference_wrapper<const ObservationBucket> bucket;
+        
+        const GenomicRegion& mapped_region() const noexcept { return variant.get().mapped_region(); }
+        
+        friend bool operator==(const BucketEntry& lhs, const BucketEntry& rhs) noexcept { return lhs.variant.get() == rhs.variant.get(); }
+        friend bool operator<(const BucketEntry& lhs, const BucketEntry& rhs) noexcept { return lhs.variant.get() < rhs.variant.get(); }
+    };
+    
     using NucleotideSequence = AlignedRead::NucleotideSequence;
     using SequenceIterator   = NucleotideSequence::const_iterator;
     
@@ -119,18 +153,25 @@ private:
     Variant::MappingDomain::Size max_seen_candidate_size_;
     CoverageTracker<GenomicRegion> read_coverage_tracker_, misaligned_tracker_;
     std::unordered_map<SampleName, CoverageTracker<GenomicRegion>> sample_read_coverage_tracker_;
+    FlatHashMap<Variant, ObservationBucket> observation_buckets_;
+    mutable std::deque<Variant> misaligned_bucket_variants_;
+    mutable std::vector<BucketEntry> bucket_index_;
     
     using CandidateIterator = OverlapIterator<decltype(candidates_)::const_iterator>;
+    using BucketIterator    = OverlapIterator<decltype(bucket_index_)::const_iterator>;
     
     template <typename T1, typename T2, typename T3>
     void add_candidate(T1&& region, T2&& sequence_removed, T3&& sequence_added,
                        const AlignedRead& read, std::size_t offset, const SampleName& sample);
     double add_snvs_in_match_range(const GenomicRegion& region, const AlignedRead& read,
                                    std::size_t read_index, const SampleName& origin);
+    void bucket_buffered_candidates();
     void generate(const GenomicRegion& region, std::vector<Variant>& result) const;
+    void generate_from_buckets(const GenomicRegion& region, std::vector<Variant>& result) const;
     unsigned sum_base_qualities(const Candidate& candidate) const noexcept;
     bool is_likely_misaligned(const AlignedRead& read, double penalty) const;
     ObservedVariant make_observation(CandidateIterator first_match, CandidateIterator last_match) const;
+    ObservedVariant make_observation(BucketIterator first_match, BucketIterator last_match) const;
     std::vector<Variant> get_novel_likely_misaligned_candidates(const std::vector<Variant>& current_candidates) const;
 };
 
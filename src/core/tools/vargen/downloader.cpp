@@ -20,6 +20,25 @@ std::unique_ptr<VariantGenerator> Downloader::do_clone() const
 }
 
 std::vector<Variant> Downloader::do_generate(const RegionSet& regions) const
+{
+    std::vector<Variant> result {};
+    for (const auto& region : regions) {
+        const auto& region_result = fetch(region);
+        result.insert(std::cend(result), std::cbegin(region_result), std::cend(region_result));
+    }
+    return result;
+}
+
+const std::vector<Variant>& Downloader::fetch(const GenomicRegion& region) const
+{
+    auto itr = cache_.find(region);
+    if (itr == std::cend(cache_)) {
+        itr = cache_.emplace(region, fetch_remote(region)).first;
+    }
+    return itr->second;
+}
+
+std::vector<Variant> Downloader::fetch_remote(const GenomicRegion& region) const
 {
     //namespace http = boost::network::http;
     
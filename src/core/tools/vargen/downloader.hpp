@@ -7,13 +7,14 @@
 #include <vector>
 #include <functional>
 #include <memory>
+#include <unordered_map>
 
+#include "basics/genomic_region.hpp"
 #include "core/types/variant.hpp"
 #include "variant_generator.hpp"
 
 namespace octopus {
 
-class GenomicRegion;
 class ReferenceGenome;
 class AlignedRead;
 
@@ -41,10 +42,16 @@ public:
 private:
     std::reference_wrapper<const ReferenceGenome> reference_;
     Options options_;
+    // Responses are memoised per region so that regions queried again - e.g.
+    // by a retried or re-batched task - do not go back to the remote source
+    mutable std::unordered_map<GenomicRegion, std::vector<Variant>> cache_;
     
     std::unique_ptr<VariantGenerator> do_clone() const override;
     std::vector<Variant> do_generate(const RegionSet& regions) const override;
     std::string name() const override;
+    
+    const std::vector<Variant>& fetch(const GenomicRegion& region) const;
+    std::vector<Variant> fetch_remote(const GenomicRegion& region) const;
 };
 
 } // namespace coretools
@@ -20,6 +20,7 @@
 #include "utils/mappable_algorithms.hpp"
 #include "utils/sequence_utils.hpp"
 #include "utils/append.hpp"
+#include "utils/thread_pool.hpp"
 #include "io/reference/reference_genome.hpp"
 #include "logging/logging.hpp"
 #include "utils/global_aligner.hpp"
@@ -343,6 +344,27 @@ std::vector<Variant> LocalReassembler::do_generate(const RegionSet& regions) con
             }
             bin.clear();
         }
+    } else if (assembly_workers_ && !assembly_workers_->empty()) {
+        // Each bin assembles independently, so all bins can be dispatched at once and
+        // the proposals merged in bin order, keeping the result deterministic
+        std::vector<std::future<std::deque<Variant>>> bin_futures {};
+        bin_futures.reserve(bins.size());
+        for (auto& bin : bins) {
+            if (debug_log_) {
+                stream(*debug_log_) << "Assembling " << bin.read_sequences.size()
+                                    << " reads in bin " << mapped_region(bin);
+            }
+            bin_futures.push_back(assembly_workers_->push([this, &bin] () {
+                std::deque<Variant> result {};
+                const auto num_default_failures = try_assemble_with_defaults(bin, result);
+                if (num_default_failures == default_kmer_sizes_.size()) {
+                    try_assemble_with_fallbacks(bin, result);
+                }
+                bin.clear();
+                return result;
+            }));
+        }
+        for (auto& f : bin_futures) utils::append(f.get(), candidates);
     } else {
         const std::size_t num_threads {4};
         std::vector<std::future<std::deque<Variant>>> bin_futures(std::min(bins.size(), num_threads));
@@ -378,6 +400,16 @@ void LocalReassembler::do_clear() noexcept
     read_buffer_.clear();
 }
 
+void LocalReassembler::do_enable_parallel_generation(ThreadPool& workers) noexcept
+{
+    assembly_workers_ = std::addressof(workers);
+}
+
+bool LocalReassembler::do_dispatches_generation_subtasks() const noexcept
+{
+    return assembly_workers_ != nullptr && !assembly_workers_->empty();
+}
+
 std::string LocalReassembler::name() const
 {
     return "LocalReassembler";
@@ -471,9 +503,15 @@ void log_failure(L& log, const char* type, const unsigned k)
 
 unsigned LocalReassembler::try_assemble_with_defaults(const Bin& bin, std::deque<Variant>& result) const
 {
+    // One streaming pass over the bin's reads counts kmers for the whole default
+    // ladder, rather than re-tokenising the reads for every kmer size
+    KmerCounter kmer_counter {default_kmer_sizes_};
+    for (const auto& sequence : bin.read_sequences) {
+        kmer_counter.add(sequence);
+    }
     unsigned num_failures {0};
     for (const auto k : default_kmer_sizes_) {
-        const auto status = assemble_bin(k, bin, result);
+        const auto status = assemble_bin(k, bin, kmer_counter.counts(k), result);
         switch (status) {
             case AssemblerStatus::success:
                 log_success(debug_log_, "Default", k);
@@ -543,7 +581,10 @@ LocalReassembler::assemble_bin(const unsigned kmer_size, const Bin& bin, std::de
     if (size(assemble_region) < kmer_size) return AssemblerStatus::failed;
     const auto reference_sequence = reference_.get().fetch_sequence(assemble_region);
     if (!utils::is_canonical_dna(reference_sequence)) return AssemblerStatus::failed;
-    Assembler assembler {kmer_size, reference_sequence};
+    // Each worker thread keeps an Assembler between bins so that graph and cache
+    // storage allocated for one assembly is reused by the next
+    thread_local Assembler assembler {kmer_size};
+    assembler.reset(kmer_size, reference_sequence);
     if (assembler.is_unique_reference()) {
         for (const auto& sequence : bin.read_sequences) {
             assembler.insert_read(sequence);
@@ -554,6 +595,25 @@ LocalReassembler::assemble_bin(const unsigned kmer_size, const Bin& bin, std::de
     }
 }
 
+LocalReassembler::AssemblerStatus
+LocalReassembler::assemble_bin(const unsigned kmer_size, const Bin& bin, const KmerCounter::Counts& kmer_counts,
+                               std::deque<Variant>& result) const
+{
+    if (bin.empty()) return AssemblerStatus::success;
+    const auto assemble_region = propose_assembler_region(bin.region, kmer_size);
+    if (size(assemble_region) < kmer_size) return AssemblerStatus::failed;
+    const auto reference_sequence = reference_.get().fetch_sequence(assemble_region);
+    if (!utils::is_canonical_dna(reference_sequence)) return AssemblerStatus::failed;
+    thread_local Assembler assembler {kmer_size};
+    assembler.reset(kmer_size, reference_sequence);
+    if (assembler.is_unique_reference()) {
+        assembler.insert_read_kmers(kmer_counts);
+        return try_assemble_region(assembler, reference_sequence, assemble_region, result);
+    } else {
+        return AssemblerStatus::failed;
+    }
+}
+
 bool is_inversion(const Assembler::Variant& v) noexcept
 {
     return v.ref.size() > 2
@@ -975,7 +1035,7 @@ LocalReassembler::try_assemble_region(Assembler& assembler, const NucleotideSequ
         return status;
     }
     auto variants = assembler.extract_variants(max_bubbles_, min_bubble_score_);
-    assembler.clear();
+    assembler.reset();
     if (!variants.empty()) {
         trim_reference(variants);
         std::sort(std::begin(variants), std::end(variants), VariantLess {});
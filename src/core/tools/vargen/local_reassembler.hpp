@@ -21,6 +21,7 @@
 #include "core/types/variant.hpp"
 #include "variant_generator.hpp"
 #include "utils/assembler.hpp"
+#include "utils/kmer_counter.hpp"
 
 namespace octopus {
 
@@ -72,7 +73,9 @@ private:
     std::vector<Variant> do_generate(const RegionSet& regions) const override;
     
     void do_clear() noexcept override;
-    
+    void do_enable_parallel_generation(ThreadPool& workers) noexcept override;
+    bool do_dispatches_generation_subtasks() const noexcept override;
+
     std::string name() const override;
     
     using NucleotideSequence = AlignedRead::NucleotideSequence;
@@ -103,6 +106,7 @@ private:
     enum class AssemblerStatus { success, partial_success, failed };
     
     ExecutionPolicy execution_policy_;
+    ThreadPool* assembly_workers_ = nullptr;
     std::reference_wrapper<const ReferenceGenome> reference_;
     std::vector<unsigned> default_kmer_sizes_, fallback_kmer_sizes_;
     ReadBufferMap read_buffer_;
@@ -120,6 +124,8 @@ private:
     void try_assemble_with_fallbacks(const Bin& bin, std::deque<Variant>& result) const;
     GenomicRegion propose_assembler_region(const GenomicRegion& input_region, unsigned kmer_size) const;
     AssemblerStatus assemble_bin(unsigned kmer_size, const Bin& bin, std::deque<Variant>& result) const;
+    AssemblerStatus assemble_bin(unsigned kmer_size, const Bin& bin, const KmerCounter::Counts& kmer_counts,
+                                 std::deque<Variant>& result) const;
     AssemblerStatus try_assemble_region(Assembler& assembler, const NucleotideSequence& reference_sequence,
                                         const GenomicRegion& reference_region, std::deque<Variant>& result) const;
 };
@@ -69,6 +69,8 @@ Assembler::Assembler(const unsigned kmer_size)
 , reference_kmers_ {}
 , reference_head_position_ {0}
 , reference_vertices_ {}
+, possibly_cyclic_ {false}
+, next_topological_rank_ {0}
 {}
 
 Assembler::Assembler(const unsigned kmer_size, const NucleotideSequence& reference)
@@ -76,6 +78,8 @@ Assembler::Assembler(const unsigned kmer_size, const NucleotideSequence& referen
 , reference_kmers_ {}
 , reference_head_position_ {0}
 , reference_vertices_ {}
+, possibly_cyclic_ {false}
+, next_topological_rank_ {0}
 {
     insert_reference_into_empty_graph(reference);
 }
@@ -200,6 +204,35 @@ void Assembler::insert_read(const NucleotideSequence& sequence)
     }
 }
 
+void Assembler::insert_read_kmers(const KmerCounter::Counts& counts)
+{
+    vertex_cache_.reserve(vertex_cache_.size() + counts.kmers.size());
+    // The kmers and transitions are given in first appearance order, so vertex
+    // indices and adjacency orderings come out exactly as they would had the
+    // counted reads been inserted individually
+    for (const auto kmer_itr : counts.kmers) {
+        const Kmer kmer {kmer_itr, std::next(kmer_itr, k_)};
+        if (!contains_kmer(kmer)) {
+            add_vertex(kmer);
+        }
+    }
+    for (const auto& transition : counts.transitions) {
+        const Kmer u_kmer {transition.itr, std::next(transition.itr, k_)};
+        const Kmer v_kmer {std::next(transition.itr), std::next(transition.itr, k_ + 1)};
+        const auto u_itr = vertex_cache_.find(u_kmer);
+        const auto v_itr = vertex_cache_.find(v_kmer);
+        if (u_itr != std::cend(vertex_cache_) && v_itr != std::cend(vertex_cache_)) {
+            Edge e; bool e_in_graph;
+            std::tie(e, e_in_graph) = boost::edge(u_itr->second, v_itr->second, graph_);
+            if (e_in_graph) {
+                increment_weight(e, transition.count);
+            } else {
+                add_edge(u_itr->second, v_itr->second, transition.count);
+            }
+        }
+    }
+}
+
 std::size_t Assembler::num_kmers() const noexcept
 {
     return vertex_cache_.size();
@@ -212,6 +245,9 @@ bool Assembler::is_empty() const noexcept
 
 bool Assembler::is_acyclic() const
 {
+    // Edge insertions repair a topological ordering as they go; if one has
+    // been maintained all along then no cycle can have been created
+    if (!possibly_cyclic_) return true;
     return !(graph_has_trivial_cycle() || graph_has_nontrivial_cycle());
 }
 
@@ -314,6 +350,29 @@ void Assembler::clear()
     reference_vertices_.shrink_to_fit();
     reference_edges_.clear();
     reference_edges_.shrink_to_fit();
+    topological_ranks_.clear();
+    possibly_cyclic_ = false;
+    next_topological_rank_ = 0;
+}
+
+void Assembler::reset()
+{
+    graph_.clear();
+    vertex_cache_.clear();
+    reference_kmers_.clear();
+    reference_vertices_.clear();
+    reference_edges_.clear();
+    reference_head_position_ = 0;
+    topological_ranks_.clear();
+    possibly_cyclic_ = false;
+    next_topological_rank_ = 0;
+}
+
+void Assembler::reset(const unsigned kmer_size, const NucleotideSequence& reference)
+{
+    reset();
+    k_ = kmer_size;
+    insert_reference_into_empty_graph(reference);
 }
 
 bool operator<(const Assembler::Variant& lhs, const Assembler::Variant& rhs) noexcept
@@ -365,11 +424,41 @@ void Assembler::write_dot(std::ostream& out) const
 }
 
 // Kmer
+namespace {
+
+constexpr std::size_t maxPackableBases {32};
+
+// A < C < G < T numerically, so packing bases most significant first keeps
+// integer comparisons consistent with lexicographic sequence comparisons
+const std::array<std::uint8_t, 256> baseCodes = [] () noexcept {
+    std::array<std::uint8_t, 256> result {};
+    result.fill(255);
+    result['A'] = 0; result['C'] = 1; result['G'] = 2; result['T'] = 3;
+    return result;
+}();
+
+} // namespace
+
 Assembler::Kmer::Kmer(SequenceIterator first, SequenceIterator last) noexcept
 : first_ {first}
 , last_ {last}
-, hash_ {boost::hash_range(first_, last_)}
-{}
+, packed_ {0}
+, hash_ {0}
+, is_packed_ {false}
+{
+    if (static_cast<std::size_t>(std::distance(first_, last_)) <= maxPackableBases) {
+        is_packed_ = true;
+        for (auto itr = first_; itr != last_; ++itr) {
+            const auto code = baseCodes[static_cast<unsigned char>(*itr)];
+            if (code > 3) {
+                is_packed_ = false;
+                break;
+            }
+            packed_ = (packed_ << 2) | code;
+        }
+    }
+    hash_ = is_packed_ ? boost::hash<std::uint64_t> {}(packed_) : boost::hash_range(first_, last_);
+}
 
 char Assembler::Kmer::front() const noexcept
 {
@@ -403,11 +492,13 @@ std::size_t Assembler::Kmer::hash() const noexcept
 
 bool operator==(const Assembler::Kmer& lhs, const Assembler::Kmer& rhs) noexcept
 {
+    if (lhs.is_packed_ && rhs.is_packed_) return lhs.packed_ == rhs.packed_;
     return std::equal(lhs.first_, lhs.last_, rhs.first_);
 }
 
 bool operator<(const Assembler::Kmer& lhs, const Assembler::Kmer& rhs) noexcept
 {
+    if (lhs.is_packed_ && rhs.is_packed_) return lhs.packed_ < rhs.packed_;
     return std::lexicographical_compare(lhs.first_, lhs.last_, rhs.first_, rhs.last_);
 }
 //
@@ -568,6 +659,8 @@ boost::optional<Assembler::Vertex> Assembler::add_vertex(const Kmer& kmer, const
     if (!utils::is_canonical_dna(kmer)) return boost::none;
     const auto u = boost::add_vertex({boost::num_vertices(graph_), kmer, is_reference}, graph_);
     vertex_cache_.emplace(kmer, u);
+    // Assignment rather than emplace as removed vertex descriptors can be reused
+    if (!possibly_cyclic_) topological_ranks_[u] = next_topological_rank_++;
     return u;
 }
 
@@ -588,7 +681,7 @@ void Assembler::clear_and_remove_vertex(const Vertex v)
     boost::remove_vertex(v, graph_);
 }
 
-void Assembler::clear_and_remove_all(const std::unordered_set<Vertex>& vertices)
+void Assembler::clear_and_remove_all(const FlatHashSet<Vertex>& vertices)
 {
     for (const Vertex v : vertices) {
         clear_and_remove_vertex(v);
@@ -599,6 +692,9 @@ Assembler::Edge Assembler::add_edge(const Vertex u, const Vertex v,
                                     const GraphEdge::WeightType weight,
                                     const bool is_reference, const bool is_artificial)
 {
+    if (!possibly_cyclic_ && !try_update_topological_ranks(u, v)) {
+        possibly_cyclic_ = true;
+    }
     return boost::add_edge(u, v, {weight, is_reference, is_artificial}, graph_).first;
 }
 
@@ -622,6 +718,11 @@ void Assembler::increment_weight(const Edge e)
     ++graph_[e].weight;
 }
 
+void Assembler::increment_weight(const Edge e, const GraphEdge::WeightType n)
+{
+    graph_[e].weight += n;
+}
+
 void Assembler::set_vertex_reference(const Vertex v)
 {
     graph_[v].is_reference = true;
@@ -899,6 +1000,78 @@ protected:
     
 } // namespace
 
+namespace {
+
+// Edge traversals allowed when repairing the topological ordering after one
+// edge insertion; almost all repairs are local, and one over the budget just
+// means the ordering is abandoned for this graph
+constexpr std::size_t maxTopologicalRepairSteps {64};
+
+} // namespace
+
+// Pearce-Kelly repair of the topological ordering for the new edge (u, v):
+// vertices reachable from v and vertices reaching u within the disturbed rank
+// window are found by bounded DFS and have their ranks permuted so that all
+// edges point up rank order again. Returns false if the edge would create a
+// cycle or if the repair exceeds the search budget, in which case the
+// ordering is abandoned and the whole-graph cycle pass decides
+bool Assembler::try_update_topological_ranks(const Vertex u, const Vertex v)
+{
+    if (u == v) return false;
+    const auto u_rank = topological_ranks_.at(u);
+    const auto v_rank = topological_ranks_.at(v);
+    if (u_rank < v_rank) return true;
+    // Ranks strictly increase along any path, so a path from v back to u lies
+    // entirely within [v_rank, u_rank] and the forward search must find it
+    std::vector<Vertex> forward {}, backward {}, stack {v};
+    FlatHashSet<Vertex> visited {};
+    visited.insert(v);
+    std::size_t num_steps {0};
+    while (!stack.empty()) {
+        const auto w = stack.back();
+        stack.pop_back();
+        forward.push_back(w);
+        for (auto p = boost::out_edges(w, graph_); p.first != p.second; ++p.first) {
+            if (++num_steps > maxTopologicalRepairSteps) return false;
+            const auto x = boost::target(*p.first, graph_);
+            if (x == u) return false;
+            if (topological_ranks_.at(x) <= u_rank && visited.count(x) == 0) {
+                visited.insert(x);
+                stack.push_back(x);
+            }
+        }
+    }
+    stack.push_back(u);
+    visited.insert(u);
+    while (!stack.empty()) {
+        const auto w = stack.back();
+        stack.pop_back();
+        backward.push_back(w);
+        for (auto p = boost::in_edges(w, graph_); p.first != p.second; ++p.first) {
+            if (++num_steps > maxTopologicalRepairSteps) return false;
+            const auto x = boost::source(*p.first, graph_);
+            if (topological_ranks_.at(x) >= v_rank && visited.count(x) == 0) {
+                visited.insert(x);
+                stack.push_back(x);
+            }
+        }
+    }
+    const auto rank_less = [this] (const Vertex lhs, const Vertex rhs) {
+        return topological_ranks_.at(lhs) < topological_ranks_.at(rhs);
+    };
+    std::sort(std::begin(forward), std::end(forward), rank_less);
+    std::sort(std::begin(backward), std::end(backward), rank_less);
+    std::vector<std::uint64_t> rank_pool {};
+    rank_pool.reserve(forward.size() + backward.size());
+    for (const auto w : backward) rank_pool.push_back(topological_ranks_.at(w));
+    for (const auto w : forward) rank_pool.push_back(topological_ranks_.at(w));
+    std::sort(std::begin(rank_pool), std::end(rank_pool));
+    auto rank_itr = std::cbegin(rank_pool);
+    for (const auto w : backward) topological_ranks_.at(w) = *rank_itr++;
+    for (const auto w : forward) topological_ranks_.at(w) = *rank_itr++;
+    return true;
+}
+
 bool Assembler::is_trivial_cycle(const Edge e) const
 {
     return boost::source(e, graph_) == boost::target(e, graph_);
@@ -946,7 +1119,7 @@ void Assembler::remove_all_nonreference_cycles(const bool break_chains)
     CyclicEdgeDetector<decltype(cyclic_edges)> vis {cyclic_edges};
     boost::depth_first_search(graph_, boost::visitor(vis).root_vertex(reference_head()).vertex_index_map(index_map));
     if (cyclic_edges.empty()) return;
-    std::unordered_set<Vertex> bad_kmers {}, reference_origins {}, reference_sinks {};
+    FlatHashSet<Vertex> bad_kmers {}, reference_origins {}, reference_sinks {};
     std::deque<std::pair<Vertex, Vertex>> cyclic_reference_segments {};
     if (break_chains) {
         bad_kmers.reserve(std::min(2 * cyclic_edges.size(), num_kmers()));
@@ -1234,9 +1407,9 @@ void Assembler::remove_disconnected_vertices()
     }
 }
 
-std::unordered_set<Assembler::Vertex> Assembler::find_reachable_kmers(const Vertex from) const
+FlatHashSet<Assembler::Vertex> Assembler::find_reachable_kmers(const Vertex from) const
 {
-    std::unordered_set<Vertex> result {};
+    FlatHashSet<Vertex> result {};
     result.reserve(boost::num_vertices(graph_));
     auto vis = boost::make_bfs_visitor(boost::write_property(boost::typed_identity_property_map<Vertex>(),
                                                              std::inserter(result, std::begin(result)),
@@ -1267,7 +1440,7 @@ void Assembler::remove_vertices_that_cant_reach(const Vertex v)
     if (!is_reference_empty()) {
         const auto transpose = boost::make_reverse_graph(graph_);
         const auto index_map = boost::get(&GraphNode::index, transpose);
-        std::unordered_set<Vertex> reachables {};
+        FlatHashSet<Vertex> reachables {};
         auto vis = boost::make_bfs_visitor(boost::write_property(boost::typed_identity_property_map<Vertex>(),
                                                                  std::inserter(reachables, std::begin(reachables)),
                                                                  boost::on_discover_vertex()));
@@ -1299,7 +1472,7 @@ void Assembler::remove_vertices_past(const Vertex v)
         // We can check reachable back edges as the links from v were cut previously
         const auto transpose = boost::make_reverse_graph(graph_);
         const auto index_map = boost::get(&GraphNode::index, transpose);
-        std::unordered_set<Vertex> back_reachables {};
+        FlatHashSet<Vertex> back_reachables {};
         auto vis = boost::make_bfs_visitor(boost::write_property(boost::typed_identity_property_map<Vertex>(),
                                                                  std::inserter(back_reachables, std::begin(back_reachables)),
                                                                  boost::on_discover_vertex()));
@@ -1395,15 +1568,15 @@ Assembler::build_dominator_tree(const Vertex from) const
     return result;
 }
 
-std::unordered_set<Assembler::Vertex> Assembler::extract_nondominants(const Vertex from) const
+FlatHashSet<Assembler::Vertex> Assembler::extract_nondominants(const Vertex from) const
 {
     const auto dom_tree = build_dominator_tree(from);
-    std::unordered_set<Vertex> dominators {};
+    FlatHashSet<Vertex> dominators {};
     dominators.reserve(dom_tree.size());
     for (const auto& p : dom_tree) {
         dominators.emplace(p.second);
     }
-    std::unordered_set<Vertex> result {};
+    FlatHashSet<Vertex> result {};
     result.reserve(dom_tree.size());
     for (const auto& p : dom_tree) {
         if (dominators.count(p.first) == 0) {
@@ -1415,7 +1588,7 @@ std::unordered_set<Assembler::Vertex> Assembler::extract_nondominants(const Vert
 
 std::deque<Assembler::Vertex> Assembler::extract_nondominant_reference(const DominatorMap& dominator_tree) const
 {
-    std::unordered_set<Vertex> dominators {};
+    FlatHashSet<Vertex> dominators {};
     dominators.reserve(dominator_tree.size());
     for (const auto& p : dominator_tree) {
         dominators.emplace(p.second);
@@ -10,6 +10,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <tuple>
 #include <stdexcept>
@@ -20,6 +21,8 @@
 
 #include "concepts/equitable.hpp"
 #include "concepts/comparable.hpp"
+#include "containers/flat_hash_map.hpp"
+#include "kmer_counter.hpp"
 
 namespace octopus { namespace coretools { class Assembler; }}
 
@@ -61,6 +64,10 @@ public:
     
     // Threads the given read sequence into the graph
     void insert_read(const NucleotideSequence& sequence);
+
+    // Threads precomputed read kmer counts into the graph; equivalent to, but
+    // cheaper than, inserting each of the counted read sequences individually
+    void insert_read_kmers(const KmerCounter::Counts& counts);
     
     // Returns the current number of unique kmers in the graph
     std::size_t num_kmers() const noexcept;
@@ -82,7 +89,12 @@ public:
     void cleanup();
     
     void clear();
-    
+
+    // Empties the graph like clear, but keeps allocated storage so the instance
+    // can be cheaply re-seeded for another assembly
+    void reset();
+    void reset(unsigned kmer_size, const NucleotideSequence& reference);
+
     std::deque<Variant> extract_variants(unsigned max_bubbles, double min_bubble_score);
     
     void write_dot(std::ostream& out) const;
@@ -118,7 +130,9 @@ private:
         friend bool operator<(const Kmer& lhs, const Kmer& rhs) noexcept;
     private:
         SequenceIterator first_, last_;
+        std::uint64_t packed_; // 2 bit encoding, for canonical kmers of up to 32 bases
         std::size_t hash_;
+        bool is_packed_;
     };
     
     friend bool operator==(const Kmer& lhs, const Kmer& rhs) noexcept;
@@ -171,10 +185,17 @@ private:
     
     KmerGraph graph_;
     
-    std::unordered_map<Kmer, Vertex, KmerHash> vertex_cache_;
+    FlatHashMap<Kmer, Vertex, KmerHash> vertex_cache_;
     Path reference_vertices_;
     std::deque<Edge> reference_edges_;
     
+    // Incremental cycle bookkeeping: edge insertions repair a topological
+    // ordering of the graph while each repair fits a small search budget, so
+    // graphs that stay provably acyclic can skip the whole-graph cycle pass
+    bool possibly_cyclic_;
+    std::uint64_t next_topological_rank_;
+    FlatHashMap<Vertex, std::uint64_t> topological_ranks_;
+    
     // methods
     
     void insert_reference_into_empty_graph(const NucleotideSequence& reference);
@@ -188,12 +209,13 @@ private:
     boost::optional<Vertex> add_vertex(const Kmer& kmer, bool is_reference = false);
     void remove_vertex(Vertex v);
     void clear_and_remove_vertex(Vertex v);
-    void clear_and_remove_all(const std::unordered_set<Vertex>& vertices);
+    void clear_and_remove_all(const FlatHashSet<Vertex>& vertices);
     Edge add_edge(Vertex u, Vertex v, GraphEdge::WeightType weight, bool is_reference = false, bool is_artificial = false);
     Edge add_reference_edge(Vertex u, Vertex v);
     void remove_edge(Vertex u, Vertex v);
     void remove_edge(Edge e);
     void increment_weight(Edge e);
+    void increment_weight(Edge e, GraphEdge::WeightType n);
     void set_vertex_reference(Vertex v);
     void set_vertex_reference(const Kmer& kmer);
     void set_edge_reference(Edge e);
@@ -227,6 +249,7 @@ private:
     std::pair<bool, Vertex> is_bridge_to_reference(Vertex from) const;
     bool joins_reference_only(Vertex v) const;
     bool joins_reference_only(Path::const_iterator first, Path::const_iterator last) const;
+    bool try_update_topological_ranks(Vertex u, Vertex v);
     bool is_trivial_cycle(Edge e) const;
     bool graph_has_trivial_cycle() const;
     bool graph_has_nontrivial_cycle() const;
@@ -252,7 +275,7 @@ private:
     bool is_low_weight(Vertex v, unsigned min_weight) const;
     void remove_low_weight_edges(unsigned min_weight);
     void remove_disconnected_vertices();
-    std::unordered_set<Vertex> find_reachable_kmers(Vertex from) const;
+    FlatHashSet<Vertex> find_reachable_kmers(Vertex from) const;
     std::deque<Vertex> remove_vertices_that_cant_be_reached_from(Vertex v);
     void remove_vertices_that_cant_reach(Vertex v);
     void remove_vertices_past(Vertex v);
@@ -262,7 +285,7 @@ private:
     void prune_reference_flanks();
     std::pair<Vertex, unsigned> find_bifurcation(Vertex from, Vertex to) const;
     DominatorMap build_dominator_tree(Vertex from) const;
-    std::unordered_set<Vertex> extract_nondominants(Vertex from) const;
+    FlatHashSet<Vertex> extract_nondominants(Vertex from) const;
     std::deque<Vertex> extract_nondominant_reference(const DominatorMap&) const;
     void set_out_edge_transition_scores(Vertex v);
     void set_all_edge_transition_scores_from(Vertex src);
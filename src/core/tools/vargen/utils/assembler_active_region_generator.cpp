@@ -217,11 +217,49 @@ auto get_interesting_hotspots(const GenomicRegion& region,
     return get_interesting_hotspots(region, interesting_coverages, coverages);
 }
 
-void merge(std::vector<GenomicRegion>&& src, std::vector<GenomicRegion>& dst)
+// Unions region proposals with one sweep over sorted breakpoints: every
+// region opens at its begin and closes at its end, and the maximal spans with
+// positive open depth are the union. A single sort when the union is taken
+// replaces a merge pass per contributing detector or sample
+class RegionUnionAccumulator
 {
-    const auto itr = utils::append(std::move(src), dst);
-    std::inplace_merge(std::begin(dst), itr, std::end(dst));
-}
+public:
+    void add(const GenomicRegion& region)
+    {
+        if (breakpoints_.empty()) contig_ = region.contig_name();
+        assert(region.contig_name() == contig_);
+        breakpoints_.emplace_back(region.begin(), false);
+        breakpoints_.emplace_back(region.end(), true);
+    }
+    template <typename Range>
+    void add(const Range& regions)
+    {
+        for (const auto& region : regions) add(region);
+    }
+    std::vector<GenomicRegion> extract_union()
+    {
+        std::vector<GenomicRegion> result {};
+        if (breakpoints_.empty()) return result;
+        // Opens sort before closes at the same position, so abutting spans
+        // coalesce rather than close and immediately reopen
+        std::sort(std::begin(breakpoints_), std::end(breakpoints_));
+        int depth {0};
+        GenomicRegion::Position span_begin {0};
+        for (const auto& breakpoint : breakpoints_) {
+            if (!breakpoint.second) {
+                if (depth++ == 0) span_begin = breakpoint.first;
+            } else if (--depth == 0) {
+                result.emplace_back(contig_, span_begin, breakpoint.first);
+            }
+        }
+        breakpoints_.clear();
+        return result;
+    }
+
+private:
+    std::vector<std::pair<GenomicRegion::Position, bool>> breakpoints_ {};
+    GenomicRegion::ContigName contig_ {};
+};
 
 std::vector<GenomicRegion>
 get_interesting_hotspots(const GenomicRegion& region,
@@ -260,24 +298,59 @@ get_interesting_hotspots(const GenomicRegion& region,
         auto pooled_hotspots = get_interesting_hotspots(region, pooled_interesting_coverage, pooled_coverage);
         auto best_sample_hotspots = get_interesting_hotspots(region, best_sample_interesting_coverage, best_sample_coverage);
         if (!best_sample_hotspots.empty() && best_sample_hotspots != pooled_hotspots) {
-            merge(std::move(best_sample_hotspots), pooled_hotspots);
-            return extract_covered_regions(pooled_hotspots);
+            RegionUnionAccumulator hotspots {};
+            hotspots.add(pooled_hotspots);
+            hotspots.add(best_sample_hotspots);
+            return hotspots.extract_union();
         } else {
             return pooled_hotspots;
         }
     }
 }
 
+constexpr GenomicRegion::Size preScreenBlockSize {4096};
+
+// Bases outside interesting read coverage can never become hotspots, so blocks
+// where no sample saw an interesting read are skipped without the per-base
+// inspection. The block scan is a plain find over the coverage counts
+std::vector<GenomicRegion>
+find_flagged_spans(const GenomicRegion& region,
+                   const std::unordered_map<SampleName, CoverageTracker<GenomicRegion>>& interesting_read_coverages)
+{
+    std::vector<GenomicRegion> result {};
+    if (interesting_read_coverages.empty()) return result;
+    bool in_span {false};
+    GenomicRegion::Position span_begin {0};
+    for (auto block_begin = region.begin(); block_begin < region.end(); ) {
+        const auto block_end = std::min(block_begin + preScreenBlockSize, region.end());
+        const GenomicRegion block {region.contig_name(), block_begin, block_end};
+        const auto flagged = std::any_of(std::cbegin(interesting_read_coverages), std::cend(interesting_read_coverages),
+                                         [&block] (const auto& p) { return p.second.any(block); });
+        if (flagged && !in_span) {
+            span_begin = block_begin;
+            in_span = true;
+        } else if (!flagged && in_span) {
+            result.emplace_back(region.contig_name(), span_begin, block_begin);
+            in_span = false;
+        }
+        block_begin = block_end;
+    }
+    if (in_span) result.emplace_back(region.contig_name(), span_begin, region.end());
+    return result;
+}
+
 std::vector<GenomicRegion> AssemblerActiveRegionGenerator::generate(const GenomicRegion& region) const
 {
-    auto interesting_regions = get_interesting_hotspots(region, interesting_read_coverages_, coverage_tracker_);
+    RegionUnionAccumulator interesting_regions {};
+    for (const auto& span : find_flagged_spans(region, interesting_read_coverages_)) {
+        interesting_regions.add(get_interesting_hotspots(span, interesting_read_coverages_, coverage_tracker_));
+    }
     if (structual_interesting_) {
         for (const auto& p : clipped_coverage_tracker_) {
-            auto deletion_regions = get_deletion_hotspots(region, p.second);
-            merge(std::move(deletion_regions), interesting_regions);
+            interesting_regions.add(get_deletion_hotspots(region, p.second));
         }
     }
-    return join(extract_covered_regions(interesting_regions), 30);
+    return join(interesting_regions.extract_union(), 30);
 }
 
 void AssemblerActiveRegionGenerator::clear() noexcept
@@ -331,6 +404,25 @@ bool AssemblerActiveRegionGenerator::is_interesting(const AlignedRead& read) con
 {
     using std::cbegin; using std::next; using std::move;
     using Flag = CigarOperation::Flag;
+    // A cheap pass over the cigar alone settles most reads: indels always
+    // trigger, and a read with no operation that could trigger is dismissed
+    // without touching the reference
+    bool needs_inspection {false};
+    for (const auto& cigar_operation : read.cigar()) {
+        switch (cigar_operation.flag()) {
+            case Flag::insertion:
+            case Flag::deletion: return true;
+            case Flag::alignmentMatch:
+            case Flag::substitution:
+                if (snvs_interesting_) needs_inspection = true;
+                break;
+            case Flag::softClipped:
+                if (indels_interesting_ || structual_interesting_) needs_inspection = true;
+                break;
+            default: break;
+        }
+    }
+    if (!needs_inspection) return false;
     const auto& read_sequence = read.sequence();
     auto sequence_itr = cbegin(read_sequence);
     auto base_quality_itr = cbegin(read.base_qualities());
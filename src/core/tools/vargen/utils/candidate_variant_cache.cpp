@@ -0,0 +1,309 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "candidate_variant_cache.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <cmath>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "basics/genomic_region.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_spec.hpp"
+
+namespace octopus { namespace coretools {
+
+namespace {
+
+constexpr char cacheMagic[8] {'O', 'C', 'T', 'O', 'C', 'A', 'N', 'D'};
+constexpr std::uint32_t cacheVersion {1};
+constexpr std::size_t cacheBlockAlignment {8};
+
+struct CacheHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t num_contigs;
+    std::uint64_t index_offset;
+};
+
+static_assert(sizeof(CacheHeader) == 24, "CacheHeader is not packed as expected");
+
+} // namespace
+
+CandidateVariantCache::CandidateVariantCache(Path cache_path)
+: path_ {std::move(cache_path)}
+{
+    static_assert(sizeof(Record) == 24, "cache Record is not packed as expected");
+    map_and_index();
+}
+
+CandidateVariantCache::CandidateVariantCache(const CandidateVariantCache& other)
+: path_ {other.path_}
+{
+    map_and_index();
+}
+
+CandidateVariantCache& CandidateVariantCache::operator=(CandidateVariantCache other)
+{
+    using std::swap;
+    swap(path_, other.path_);
+    swap(data_, other.data_);
+    swap(size_, other.size_);
+    swap(contigs_, other.contigs_);
+    return *this;
+}
+
+CandidateVariantCache::CandidateVariantCache(CandidateVariantCache&& other) noexcept
+: path_ {std::move(other.path_)}
+, data_ {other.data_}
+, size_ {other.size_}
+, contigs_ {std::move(other.contigs_)}
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+CandidateVariantCache& CandidateVariantCache::operator=(CandidateVariantCache&& other) noexcept
+{
+    using std::swap;
+    swap(path_, other.path_);
+    swap(data_, other.data_);
+    swap(size_, other.size_);
+    swap(contigs_, other.contigs_);
+    return *this;
+}
+
+CandidateVariantCache::~CandidateVariantCache() noexcept
+{
+    unmap();
+}
+
+const CandidateVariantCache::Path& CandidateVariantCache::path() const noexcept
+{
+    return path_;
+}
+
+std::vector<CandidateVariantCache::Candidate>
+CandidateVariantCache::fetch_overlapped(const GenomicRegion& region) const
+{
+    std::vector<Candidate> result {};
+    const auto contig_itr = contigs_.find(region.contig_name());
+    if (contig_itr == std::cend(contigs_)) return result;
+    const auto& contig = contig_itr->second;
+    const auto region_begin = static_cast<std::uint64_t>(region.begin());
+    const auto region_end   = static_cast<std::uint64_t>(region.end());
+    // A record at 1-based pos spans [pos - 1, pos - 1 + ref_length), so no record
+    // before this position can reach back into the requested region
+    const auto min_pos = region_begin + 1 > contig.max_ref_length
+                         ? region_begin + 1 - contig.max_ref_length : 0;
+    auto record_itr = std::lower_bound(contig.records, contig.records + contig.num_records, min_pos,
+                                       [] (const Record& record, const std::uint64_t pos) {
+                                           return record.pos < pos;
+                                       });
+    for (; record_itr != contig.records + contig.num_records; ++record_itr) {
+        const std::uint64_t record_begin {record_itr->pos - 1u};
+        if (record_begin >= region_end) break;
+        if (record_begin + record_itr->ref_length > region_begin) {
+            const char* sequences {contig.sequences + record_itr->sequence_offset};
+            boost::optional<float> quality {};
+            if (!std::isnan(record_itr->quality)) quality = record_itr->quality;
+            result.push_back({record_itr->pos,
+                              sequences, record_itr->ref_length,
+                              sequences + record_itr->ref_length, record_itr->alt_length,
+                              quality, (record_itr->flags & 1u) != 0});
+        }
+    }
+    return result;
+}
+
+void CandidateVariantCache::map_and_index()
+{
+    const auto fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error {"CandidateVariantCache: could not open " + path_.string()};
+    }
+    struct ::stat file_stats;
+    if (::fstat(fd, &file_stats) < 0 || file_stats.st_size < static_cast<off_t>(sizeof(CacheHeader))) {
+        ::close(fd);
+        throw std::runtime_error {"CandidateVariantCache: could not read " + path_.string()};
+    }
+    size_ = static_cast<std::size_t>(file_stats.st_size);
+    const auto mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        size_ = 0;
+        throw std::runtime_error {"CandidateVariantCache: could not map " + path_.string()};
+    }
+    data_ = static_cast<const char*>(mapping);
+    CacheHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (!std::equal(std::cbegin(cacheMagic), std::cend(cacheMagic), header.magic)
+        || header.version != cacheVersion
+        || header.index_offset == 0 || header.index_offset > size_) {
+        unmap();
+        throw std::runtime_error {path_.string() + " is not a valid candidate variant cache"};
+    }
+    const char* index_itr {data_ + header.index_offset};
+    contigs_.reserve(header.num_contigs);
+    for (std::uint32_t i {0}; i < header.num_contigs; ++i) {
+        std::uint32_t name_length;
+        std::memcpy(&name_length, index_itr, sizeof(name_length));
+        index_itr += sizeof(name_length);
+        std::string name {index_itr, index_itr + name_length};
+        index_itr += name_length;
+        std::uint64_t records_offset, num_records, sequences_offset;
+        std::uint32_t max_ref_length;
+        std::memcpy(&records_offset, index_itr, sizeof(records_offset));
+        index_itr += sizeof(records_offset);
+        std::memcpy(&num_records, index_itr, sizeof(num_records));
+        index_itr += sizeof(num_records);
+        std::memcpy(&sequences_offset, index_itr, sizeof(sequences_offset));
+        index_itr += sizeof(sequences_offset);
+        std::memcpy(&max_ref_length, index_itr, sizeof(max_ref_length));
+        index_itr += sizeof(max_ref_length);
+        contigs_.emplace(std::move(name),
+                         ContigIndex {reinterpret_cast<const Record*>(data_ + records_offset),
+                                      num_records, data_ + sequences_offset, max_ref_length});
+    }
+}
+
+void CandidateVariantCache::unmap() noexcept
+{
+    if (data_) {
+        ::munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+CandidateVariantCache::Path candidate_variant_cache_path(const CandidateVariantCache::Path& source_path)
+{
+    return source_path.string() + ".occ";
+}
+
+namespace {
+
+bool is_canonical(const VcfRecord::NucleotideSequence& allele)
+{
+    return allele != vcfspec::missingValue
+           && std::none_of(std::cbegin(allele), std::cend(allele),
+                           [] (const auto base) { return base == vcfspec::deletedBase; });
+}
+
+struct IndexEntry
+{
+    std::string name;
+    std::uint64_t records_offset, num_records, sequences_offset;
+    std::uint32_t max_ref_length;
+};
+
+template <typename T>
+void write_value(std::ofstream& cache, const T& value)
+{
+    cache.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+void build_candidate_variant_cache(const VcfReader& source, const CandidateVariantCache::Path& cache_path)
+{
+    using Record = CandidateVariantCache::Record;
+    std::ofstream cache {cache_path.string(), std::ios::binary | std::ios::trunc};
+    if (!cache) {
+        throw std::runtime_error {"could not write candidate variant cache " + cache_path.string()};
+    }
+    CacheHeader header {};
+    std::copy(std::cbegin(cacheMagic), std::cend(cacheMagic), header.magic);
+    header.version = cacheVersion;
+    cache.write(reinterpret_cast<const char*>(&header), sizeof(header)); // index_offset patched below
+    std::vector<IndexEntry> index {};
+    std::vector<Record> records {};
+    std::string sequences {};
+    std::uint32_t max_ref_length {0};
+    std::uint64_t block_offset {sizeof(CacheHeader)};
+    const auto flush_contig = [&] (const std::string& contig) {
+        IndexEntry entry {};
+        entry.name           = contig;
+        entry.records_offset = block_offset;
+        entry.num_records    = records.size();
+        entry.max_ref_length = max_ref_length;
+        cache.write(reinterpret_cast<const char*>(records.data()),
+                    static_cast<std::streamsize>(records.size() * sizeof(Record)));
+        block_offset += records.size() * sizeof(Record);
+        entry.sequences_offset = block_offset;
+        sequences.resize((sequences.size() + cacheBlockAlignment - 1)
+                         / cacheBlockAlignment * cacheBlockAlignment, '\0');
+        cache.write(sequences.data(), static_cast<std::streamsize>(sequences.size()));
+        block_offset += sequences.size();
+        index.push_back(std::move(entry));
+        records.clear();
+        sequences.clear();
+        max_ref_length = 0;
+    };
+    std::string current_contig {};
+    for (auto p = source.iterate(VcfReader::UnpackPolicy::sites); p.first != p.second; ++p.first) {
+        const VcfRecord& record {*p.first};
+        if (record.chrom() != current_contig) {
+            if (std::any_of(std::cbegin(index), std::cend(index),
+                            [&] (const auto& entry) { return entry.name == record.chrom(); })) {
+                throw std::runtime_error {source.path().string() + " is not sorted; cannot cache candidates"};
+            }
+            if (!current_contig.empty()) flush_contig(current_contig);
+            current_contig = record.chrom();
+        }
+        if (!records.empty() && record.pos() < records.back().pos) {
+            throw std::runtime_error {source.path().string() + " is not sorted; cannot cache candidates"};
+        }
+        const auto& ref_allele = record.ref();
+        if (!is_canonical(ref_allele)
+            || ref_allele.size() > std::numeric_limits<std::uint16_t>::max()) {
+            continue;
+        }
+        for (const auto& alt_allele : record.alt()) {
+            if (!is_canonical(alt_allele)
+                || alt_allele.size() > std::numeric_limits<std::uint16_t>::max()) {
+                continue;
+            }
+            Record cached {};
+            cached.sequence_offset = sequences.size();
+            cached.quality         = record.qual() ? *record.qual() : std::numeric_limits<float>::quiet_NaN();
+            cached.pos             = static_cast<std::uint32_t>(record.pos());
+            cached.ref_length      = static_cast<std::uint16_t>(ref_allele.size());
+            cached.alt_length      = static_cast<std::uint16_t>(alt_allele.size());
+            if (is_filtered(record)) cached.flags |= 1u;
+            sequences.append(ref_allele);
+            sequences.append(alt_allele);
+            records.push_back(cached);
+            max_ref_length = std::max(max_ref_length, static_cast<std::uint32_t>(ref_allele.size()));
+        }
+    }
+    if (!current_contig.empty()) flush_contig(current_contig);
+    header.index_offset = block_offset;
+    header.num_contigs  = static_cast<std::uint32_t>(index.size());
+    for (const auto& entry : index) {
+        write_value(cache, static_cast<std::uint32_t>(entry.name.size()));
+        cache.write(entry.name.data(), static_cast<std::streamsize>(entry.name.size()));
+        write_value(cache, entry.records_offset);
+        write_value(cache, entry.num_records);
+        write_value(cache, entry.sequences_offset);
+        write_value(cache, entry.max_ref_length);
+    }
+    cache.seekp(0);
+    cache.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!cache) {
+        throw std::runtime_error {"could not write candidate variant cache " + cache_path.string()};
+    }
+}
+
+} // namespace coretools
+} // namespace octopus
@@ -0,0 +1,105 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef candidate_variant_cache_hpp
+#define candidate_variant_cache_hpp
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+
+#include "io/variant/vcf_reader.hpp"
+
+namespace octopus {
+
+class GenomicRegion;
+
+namespace coretools {
+
+/*
+ CandidateVariantCache is a binary, region-indexed sidecar for source candidate
+ VCFs. It stores each canonical allele of every record as a fixed size,
+ position sorted entry per contig, with the allele sequences packed in a blob
+ alongside. The cache is mapped rather than read, so repeated extraction from
+ large panels costs a binary search plus pointer arithmetic instead of
+ re-parsing VCF text. The format is host endian; caches are machine local and
+ rebuilt when older than their source.
+ */
+class CandidateVariantCache
+{
+public:
+    using Path = boost::filesystem::path;
+
+    struct Candidate
+    {
+        std::uint32_t pos; // 1-based, as in the source VCF
+        const char* ref;
+        std::uint16_t ref_length;
+        const char* alt;
+        std::uint16_t alt_length;
+        boost::optional<float> quality;
+        bool is_filtered;
+    };
+
+    CandidateVariantCache() = delete;
+
+    CandidateVariantCache(Path cache_path);
+
+    CandidateVariantCache(const CandidateVariantCache&);
+    CandidateVariantCache& operator=(CandidateVariantCache);
+    CandidateVariantCache(CandidateVariantCache&&) noexcept;
+    CandidateVariantCache& operator=(CandidateVariantCache&&) noexcept;
+
+    ~CandidateVariantCache() noexcept;
+
+    const Path& path() const noexcept;
+
+    // All candidates whose reference span overlaps the given region, in position order
+    std::vector<Candidate> fetch_overlapped(const GenomicRegion& region) const;
+
+private:
+    struct Record
+    {
+        std::uint64_t sequence_offset; // ref bases then alt bases
+        float quality;                 // NaN when missing
+        std::uint32_t pos;             // 1-based
+        std::uint16_t ref_length;
+        std::uint16_t alt_length;
+        std::uint32_t flags;
+    };
+
+    struct ContigIndex
+    {
+        const Record* records;
+        std::size_t num_records;
+        const char* sequences;
+        std::uint32_t max_ref_length;
+    };
+
+    Path path_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::unordered_map<std::string, ContigIndex> contigs_;
+
+    void map_and_index();
+    void unmap() noexcept;
+
+    friend void build_candidate_variant_cache(const VcfReader& source, const Path& cache_path);
+};
+
+// The sidecar path used for a given source VCF
+CandidateVariantCache::Path candidate_variant_cache_path(const CandidateVariantCache::Path& source_path);
+
+// Converts a source VCF into a cache in one streaming pass. The source must be
+// sorted; alleles longer than the record field width (65,535 bases) are dropped.
+void build_candidate_variant_cache(const VcfReader& source, const CandidateVariantCache::Path& cache_path);
+
+} // namespace coretools
+} // namespace octopus
+
+#endif
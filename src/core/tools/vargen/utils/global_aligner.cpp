@@ -9,8 +9,13 @@
 #include <algorithm>
 #include <iterator>
 #include <functional>
+#include <memory>
 #include <cassert>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace octopus { namespace coretools {
 
 namespace {
@@ -20,76 +25,159 @@ struct Cell
     int match = 0, insertion = 0, deletion = 0;
 };
 
-using DPMatrix = std::vector<std::vector<Cell>>;
+// The three score planes are kept as separate contiguous arrays so that rows
+// can be filled with vector loads and stores. The arrays are left uninitialised
+// as every cell is written before it is read.
+struct DPMatrix
+{
+    std::unique_ptr<int[]> match, insertion, deletion;
+    std::size_t num_cols, num_rows;
+
+    std::size_t index(const std::size_t i, const std::size_t j) const noexcept
+    {
+        return i * num_rows + j;
+    }
+};
 
 auto ncols(const DPMatrix& matrix) noexcept
 {
-    return matrix.size();
+    return matrix.num_cols;
 }
 
 auto nrows(const DPMatrix& matrix) noexcept
 {
-    return matrix.front().size();
+    return matrix.num_rows;
+}
+
+Cell cell(const DPMatrix& matrix, const std::size_t i, const std::size_t j) noexcept
+{
+    const auto idx = matrix.index(i, j);
+    return {matrix.match[idx], matrix.insertion[idx], matrix.deletion[idx]};
 }
 
 auto init_dp_matrix(const std::string& target, const std::string& query, const Model& model)
 {
     assert(!(target.empty() || query.empty()));
-    DPMatrix result(target.size() + 1, DPMatrix::value_type(query.size() + 1));
-    result[0][0] = Cell {};
+    DPMatrix result {};
+    result.num_cols = target.size() + 1;
+    result.num_rows = query.size() + 1;
+    const auto num_cells = result.num_cols * result.num_rows;
+    result.match.reset(new int[num_cells]);
+    result.insertion.reset(new int[num_cells]);
+    result.deletion.reset(new int[num_cells]);
+    result.match[0] = result.insertion[0] = result.deletion[0] = 0;
     using S = decltype(Cell::match);
     const auto min_score = std::min({model.mismatch, model.gap_open});
-    const auto inf = min_score * std::max(ncols(result), nrows(result));
+    const auto inf = min_score * static_cast<int>(std::max(ncols(result), nrows(result)));
     for (std::size_t i {1}; i < ncols(result); ++i) {
-        result[i][0].match     = inf;
-        result[i][0].insertion = inf;
-        result[i][0].deletion  = model.gap_open + static_cast<S>(i - 1) * model.gap_extend;
+        const auto idx = result.index(i, 0);
+        result.match[idx]     = inf;
+        result.insertion[idx] = inf;
+        result.deletion[idx]  = model.gap_open + static_cast<S>(i - 1) * model.gap_extend;
     }
     for (std::size_t j {1}; j < nrows(result); ++j) {
-        result[0][j].match     = inf;
-        result[0][j].insertion = model.gap_open + static_cast<S>(j - 1) * model.gap_extend;
-        result[0][j].deletion  = inf;
+        result.match[j]     = inf;
+        result.insertion[j] = model.gap_open + static_cast<S>(j - 1) * model.gap_extend;
+        result.deletion[j]  = inf;
     }
     return result;
 }
 
-auto match(const std::string& target, const std::string& query,
-           const DPMatrix& matrix, const std::size_t i, const std::size_t j,
-           const Model& model) noexcept
+#ifdef __SSE2__
+
+auto max_epi32(const __m128i lhs, const __m128i rhs) noexcept
 {
-    const auto penalty = target[i - 1] == query[j - 1] ? model.match : model.mismatch;
-    const auto& prev = matrix[i - 1][j - 1];
-    return std::max({prev.match, prev.insertion, prev.deletion}) + penalty;
+    const auto mask = _mm_cmpgt_epi32(lhs, rhs);
+    return _mm_or_si128(_mm_and_si128(mask, lhs), _mm_andnot_si128(mask, rhs));
 }
 
-auto insertion(const DPMatrix& matrix, const std::size_t i, const std::size_t j, const Model& model) noexcept
+#endif
+
+constexpr const char dnaBases[] {'A', 'C', 'G', 'T'};
+
+// One penalty row per base, so that row fills read penalties with plain vector
+// loads rather than comparing base pairs lane by lane
+struct QueryProfile
+{
+    std::vector<int> penalties; // 4 rows, one per base in dnaBases order
+    std::size_t num_rows;
+};
+
+auto make_query_profile(const std::string& query, const Model& model)
 {
-    const auto& prev = matrix[i][j - 1];
-    return std::max(prev.insertion + model.gap_extend, prev.match + model.gap_open);
+    QueryProfile result {};
+    result.num_rows = query.size() + 1;
+    result.penalties.resize(4 * result.num_rows);
+    for (std::size_t b {0}; b < 4; ++b) {
+        const auto row = result.penalties.data() + b * result.num_rows;
+        for (std::size_t j {1}; j < result.num_rows; ++j) {
+            row[j] = query[j - 1] == dnaBases[b] ? model.match : model.mismatch;
+        }
+    }
+    return result;
 }
 
-auto deletion(const DPMatrix& matrix, const std::size_t i, const std::size_t j, const Model& model) noexcept
+const int* find_penalty_row(const QueryProfile& profile, const char target_base) noexcept
 {
-    const auto& prev = matrix[i - 1][j];
-    return std::max(prev.deletion + model.gap_extend, prev.match + model.gap_open);
+    for (std::size_t b {0}; b < 4; ++b) {
+        if (target_base == dnaBases[b]) {
+            return profile.penalties.data() + b * profile.num_rows;
+        }
+    }
+    return nullptr;
 }
 
-void fill(const std::string& target, const std::string& query,
-          DPMatrix& matrix, const std::size_t i, const std::size_t j,
-          const Model& model) noexcept
+// Fills row i given row i - 1. The match and deletion planes depend only on the
+// previous row, so they vectorise; the insertion plane recurs along the row and
+// is filled with a scalar scan afterwards.
+void fill_row(DPMatrix& matrix, const std::string& target, const std::string& query,
+              const QueryProfile& profile, const std::size_t i, const Model& model) noexcept
 {
-    auto& curr = matrix[i][j];
-    curr.match     = match(target, query, matrix, i, j, model);
-    curr.insertion = insertion(matrix, i, j, model);
-    curr.deletion  = deletion(matrix, i, j, model);
+    const auto row = matrix.index(i, 0);
+    const auto* prev_match     = matrix.match.get()     + row - nrows(matrix);
+    const auto* prev_insertion = matrix.insertion.get() + row - nrows(matrix);
+    const auto* prev_deletion  = matrix.deletion.get()  + row - nrows(matrix);
+    auto* curr_match     = matrix.match.get()     + row;
+    auto* curr_insertion = matrix.insertion.get() + row;
+    auto* curr_deletion  = matrix.deletion.get()  + row;
+    const auto target_base = target[i - 1];
+    const auto* penalty_row = find_penalty_row(profile, target_base);
+    std::size_t j {1};
+#ifdef __SSE2__
+    if (penalty_row) {
+        const auto gap_open   = _mm_set1_epi32(model.gap_open);
+        const auto gap_extend = _mm_set1_epi32(model.gap_extend);
+        for (; j + 4 <= nrows(matrix); j += 4) {
+            const auto diag_match     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev_match + j - 1));
+            const auto diag_insertion = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev_insertion + j - 1));
+            const auto diag_deletion  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev_deletion + j - 1));
+            const auto penalties      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(penalty_row + j));
+            const auto best = max_epi32(diag_match, max_epi32(diag_insertion, diag_deletion));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(curr_match + j), _mm_add_epi32(best, penalties));
+            const auto up_match    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev_match + j));
+            const auto up_deletion = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev_deletion + j));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(curr_deletion + j),
+                             max_epi32(_mm_add_epi32(up_deletion, gap_extend),
+                                       _mm_add_epi32(up_match, gap_open)));
+        }
+    }
+#endif
+    for (; j < nrows(matrix); ++j) {
+        const auto penalty = target_base == query[j - 1] ? model.match : model.mismatch;
+        curr_match[j]    = std::max({prev_match[j - 1], prev_insertion[j - 1], prev_deletion[j - 1]}) + penalty;
+        curr_deletion[j] = std::max(prev_deletion[j] + model.gap_extend, prev_match[j] + model.gap_open);
+    }
+    for (j = 1; j < nrows(matrix); ++j) {
+        curr_insertion[j] = std::max(curr_insertion[j - 1] + model.gap_extend,
+                                     curr_match[j - 1] + model.gap_open);
+    }
 }
 
-void fill(DPMatrix& matrix, const std::string& target, const std::string& query, const Model& model) noexcept
+void fill(DPMatrix& matrix, const std::string& target, const std::string& query, const Model& model)
 {
+    const auto profile = make_query_profile(query, model);
     for (std::size_t i {1}; i < ncols(matrix); ++i) {
-        for (std::size_t j {1}; j < nrows(matrix); ++j) {
-            fill(target, query, matrix, i, j, model);
-        }
+        fill_row(matrix, target, query, profile, i, model);
     }
 }
 
@@ -103,7 +191,7 @@ auto build_dp_matrix(const std::string& target, const std::string& query, const
 char traceback(const std::string& target, const std::string& query, const DPMatrix& matrix,
                const std::size_t i, const std::size_t j, const Model& model, const char prev_state) noexcept
 {
-    const auto& curr = matrix[i][j];
+    const auto curr = cell(matrix, i, j);
     if (prev_state == '$') {
         if (curr.match >= curr.deletion) {
             if (curr.match >= curr.insertion) {
@@ -126,7 +214,7 @@ char traceback(const std::string& target, const std::string& query, const DPMatr
                 return curr.deletion >= curr.insertion ? 'D' : 'I';
             }
         } else if (prev_state == 'D') {
-            const auto& prev = matrix[i + 1][j];
+            const auto prev = cell(matrix, i + 1, j);
             if (prev.deletion == curr.match + model.gap_open) {
                 return target[i - 1] == query[j - 1] ? '=' : 'X';
             } else {
@@ -134,7 +222,7 @@ char traceback(const std::string& target, const std::string& query, const DPMatr
             }
         } else {
             assert(prev_state == 'I');
-            const auto& prev = matrix[i][j + 1];
+            const auto prev = cell(matrix, i, j + 1);
             if (prev.insertion == curr.match + model.gap_open) {
                 return target[i - 1] == query[j - 1] ? '=' : 'X';
             } else {
@@ -210,7 +298,7 @@ auto extract_alignment(const std::string& target, const std::string& query, cons
 
 auto score(const DPMatrix& matrix) noexcept
 {
-    const auto& last = matrix.back().back();
+    const auto last = cell(matrix, ncols(matrix) - 1, nrows(matrix) - 1);
     return std::max({last.match, last.insertion, last.deletion});
 }
 
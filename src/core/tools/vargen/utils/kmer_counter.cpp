@@ -0,0 +1,112 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "kmer_counter.hpp"
+
+#include <iterator>
+#include <cassert>
+
+namespace octopus { namespace coretools {
+
+namespace {
+
+constexpr std::uint64_t hashBase {1099511628211ull};
+
+auto power(const std::uint64_t base, const unsigned exponent) noexcept
+{
+    std::uint64_t result {1};
+    for (unsigned i {0}; i < exponent; ++i) {
+        result *= base;
+    }
+    return result;
+}
+
+bool is_canonical_base(const char b) noexcept
+{
+    return b == 'A' || b == 'C' || b == 'G' || b == 'T';
+}
+
+} // namespace
+
+KmerCounter::SizeCounter::SizeCounter(const unsigned kmer_size)
+: kmer_size {kmer_size}
+, kmer_pow {power(hashBase, kmer_size)}
+, transition_pow {power(hashBase, kmer_size + 1)}
+, kmer_hash {0}
+, transition_hash {0}
+, counts {}
+, seen_kmers {0, KmerWindowHash {}, KmerWindowEqual {kmer_size}}
+, seen_transitions {0, KmerWindowHash {}, KmerWindowEqual {kmer_size + 1}}
+{}
+
+KmerCounter::KmerCounter(const std::vector<unsigned>& kmer_sizes)
+: counters_ {}
+{
+    counters_.reserve(kmer_sizes.size());
+    for (const auto kmer_size : kmer_sizes) {
+        counters_.emplace_back(kmer_size);
+    }
+}
+
+void KmerCounter::add(const NucleotideSequence& sequence)
+{
+    const auto num_bases = sequence.size();
+    if (counters_.empty() || num_bases == 0) return;
+    const auto first_itr = std::cbegin(sequence);
+    for (auto& counter : counters_) {
+        counter.kmer_hash = 0;
+        counter.transition_hash = 0;
+    }
+    std::size_t last_noncanonical {0};
+    bool seen_noncanonical {false};
+    for (std::size_t i {0}; i < num_bases; ++i) {
+        const auto base = static_cast<std::uint64_t>(static_cast<unsigned char>(sequence[i]));
+        if (!is_canonical_base(sequence[i])) {
+            seen_noncanonical = true;
+            last_noncanonical = i;
+        }
+        for (auto& counter : counters_) {
+            const auto k = counter.kmer_size;
+            counter.kmer_hash = counter.kmer_hash * hashBase + base;
+            if (i >= k) {
+                counter.kmer_hash -= static_cast<std::uint64_t>(static_cast<unsigned char>(sequence[i - k])) * counter.kmer_pow;
+            }
+            counter.transition_hash = counter.transition_hash * hashBase + base;
+            if (i > k) {
+                counter.transition_hash -= static_cast<std::uint64_t>(static_cast<unsigned char>(sequence[i - k - 1])) * counter.transition_pow;
+            }
+            if (i + 1 >= k) {
+                const auto window_begin = i + 1 - k;
+                if (!seen_noncanonical || last_noncanonical < window_begin) {
+                    const KmerWindow window {std::next(first_itr, window_begin), counter.kmer_hash};
+                    if (counter.seen_kmers.insert(window).second) {
+                        counter.counts.kmers.push_back(window.itr);
+                    }
+                }
+            }
+            if (i >= k) {
+                const auto window_begin = i - k;
+                if (!seen_noncanonical || last_noncanonical < window_begin) {
+                    const KmerWindow window {std::next(first_itr, window_begin), counter.transition_hash};
+                    const auto p = counter.seen_transitions.emplace(window, counter.counts.transitions.size());
+                    if (p.second) {
+                        counter.counts.transitions.push_back({window.itr, 1});
+                    } else {
+                        ++counter.counts.transitions[p.first->second].count;
+                    }
+                }
+            }
+        }
+    }
+}
+
+const KmerCounter::Counts& KmerCounter::counts(const unsigned kmer_size) const
+{
+    const auto itr = std::find_if(std::cbegin(counters_), std::cend(counters_),
+                                  [kmer_size] (const auto& counter) { return counter.kmer_size == kmer_size; });
+    assert(itr != std::cend(counters_));
+    return itr->counts;
+}
+
+} // namespace coretools
+} // namespace octopus
@@ -0,0 +1,103 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef kmer_counter_hpp
+#define kmer_counter_hpp
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace octopus { namespace coretools {
+
+/**
+    KmerCounter makes a single streaming pass over a set of read sequences,
+    recording for each configured kmer size the distinct kmers and kmer
+    transitions, with occurrence counts, in first appearance order. Window
+    hashes are maintained with rolling updates so all sizes are counted in
+    one scan. The recorded iterators stay valid for as long as the scanned
+    sequences, so the counts can seed an Assembler without re-tokenising
+    the reads for every kmer size.
+ */
+class KmerCounter
+{
+public:
+    using NucleotideSequence = std::string;
+    using SequenceIterator   = NucleotideSequence::const_iterator;
+
+    struct TransitionCount
+    {
+        SequenceIterator itr; // the first base of the (kmer size + 1) length window
+        unsigned count;
+    };
+    struct Counts
+    {
+        std::vector<SequenceIterator> kmers;
+        std::vector<TransitionCount> transitions;
+    };
+
+    KmerCounter() = delete;
+
+    explicit KmerCounter(const std::vector<unsigned>& kmer_sizes);
+
+    KmerCounter(const KmerCounter&)            = default;
+    KmerCounter& operator=(const KmerCounter&) = default;
+    KmerCounter(KmerCounter&&)                 = default;
+    KmerCounter& operator=(KmerCounter&&)      = default;
+
+    ~KmerCounter() = default;
+
+    // Counts all canonical kmers and kmer transitions in the given sequence
+    void add(const NucleotideSequence& sequence);
+
+    const Counts& counts(unsigned kmer_size) const;
+
+private:
+    struct KmerWindow
+    {
+        SequenceIterator itr;
+        std::uint64_t hash;
+    };
+    struct KmerWindowHash
+    {
+        std::size_t operator()(const KmerWindow& window) const noexcept
+        {
+            return static_cast<std::size_t>(window.hash);
+        }
+    };
+    class KmerWindowEqual
+    {
+    public:
+        explicit KmerWindowEqual(unsigned length) noexcept : length_ {length} {}
+        bool operator()(const KmerWindow& lhs, const KmerWindow& rhs) const noexcept
+        {
+            return std::equal(lhs.itr, std::next(lhs.itr, length_), rhs.itr);
+        }
+    private:
+        unsigned length_;
+    };
+    using KmerWindowSet = std::unordered_set<KmerWindow, KmerWindowHash, KmerWindowEqual>;
+    using KmerWindowMap = std::unordered_map<KmerWindow, std::size_t, KmerWindowHash, KmerWindowEqual>;
+
+    struct SizeCounter
+    {
+        explicit SizeCounter(unsigned kmer_size);
+        unsigned kmer_size;
+        std::uint64_t kmer_pow, transition_pow;
+        std::uint64_t kmer_hash, transition_hash;
+        Counts counts;
+        KmerWindowSet seen_kmers;
+        KmerWindowMap seen_transitions;
+    };
+
+    std::vector<SizeCounter> counters_;
+};
+
+} // namespace coretools
+} // namespace octopus
+
+#endif
@@ -86,8 +86,7 @@ double ln_probability_read_correctly_aligned(const double misalign_penalty, cons
     if (k == 0) {
         return 0;
     } else {
-        const auto ln_prob_missmapped = -maths::constants::ln10Div10<> * read.mapping_quality();
-        const auto ln_prob_mapped = std::log(1.0 - std::exp(ln_prob_missmapped));
+        const auto ln_prob_mapped = std::log1p(-maths::phred_to_error_probability(read.mapping_quality()));
         const auto mu = max_expected_mutation_rate * region_size(read);
         auto ln_prob_given_mapped = maths::log_poisson_sf(k, mu);
         return ln_prob_mapped + ln_prob_given_mapped;
@@ -5,8 +5,13 @@
 
 #include <algorithm>
 #include <cassert>
+#include <future>
+#include <memory>
+#include <unordered_set>
 
 #include "utils/append.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/parallel_sort.hpp"
 
 namespace octopus { namespace coretools {
 
@@ -29,11 +34,13 @@ VariantGenerator::VariantGenerator(const VariantGenerator& other)
         variant_generators_.push_back(generator->clone());
     }
     active_region_generator_ = other.active_region_generator_;
+    generation_workers_ = other.generation_workers_;
 }
 
 VariantGenerator& VariantGenerator::operator=(VariantGenerator other)
 {
     std::swap(variant_generators_, other.variant_generators_);
+    std::swap(generation_workers_, other.generation_workers_);
     return *this;
 }
 
@@ -84,21 +91,98 @@ void log_candidates(const std::vector<Variant>& candidates, const std::string& g
 
 } // namespace debug
 
+namespace {
+
+struct VariantRefHash
+{
+    std::size_t operator()(const std::reference_wrapper<const Variant> variant) const
+    {
+        return std::hash<Variant>()(variant.get());
+    }
+};
+
+struct VariantRefEqual
+{
+    bool operator()(const std::reference_wrapper<const Variant> lhs,
+                    const std::reference_wrapper<const Variant> rhs) const
+    {
+        return lhs.get() == rhs.get();
+    }
+};
+
+} // namespace
+
 std::vector<Variant> VariantGenerator::generate(const GenomicRegion& region) const
 {
-    std::vector<Variant> result {};
-    for (auto& generator : variant_generators_) {
-        const auto active_regions = generate_active_regions(region, *generator);
-        debug::log_active_regions(active_regions, generator->name(), debug_log_);
-        auto generator_result = generator->do_generate(active_regions);
-        debug::log_candidates(generator_result, generator->name(), debug_log_);
-        assert(std::is_sorted(std::cbegin(generator_result), std::cend(generator_result)));
-        auto itr = utils::append(std::move(generator_result), result);
-        std::inplace_merge(std::begin(result), itr, std::end(result));
+    std::vector<std::vector<Variant>> generator_results(variant_generators_.size());
+    if (generation_workers_ && !generation_workers_->empty() && variant_generators_.size() > 1) {
+        // The generators propose candidates independently, so each can run as a
+        // parallel subtask; merging the sorted outputs in registration order
+        // keeps the result identical to sequential generation. Generators that
+        // dispatch subtasks of their own are run on this thread instead
+        std::vector<RegionSet> active_regions {};
+        active_regions.reserve(variant_generators_.size());
+        for (const auto& generator : variant_generators_) {
+            active_regions.push_back(generate_active_regions(region, *generator));
+            debug::log_active_regions(active_regions.back(), generator->name(), debug_log_);
+        }
+        std::vector<std::future<std::vector<Variant>>> generator_futures(variant_generators_.size());
+        for (std::size_t i {0}; i < variant_generators_.size(); ++i) {
+            if (!variant_generators_[i]->do_dispatches_generation_subtasks()) {
+                generator_futures[i] = generation_workers_->push([this, i, &active_regions] () {
+                    return variant_generators_[i]->do_generate(active_regions[i]);
+                });
+            }
+        }
+        for (std::size_t i {0}; i < variant_generators_.size(); ++i) {
+            generator_results[i] = generator_futures[i].valid()
+                                   ? generator_futures[i].get()
+                                   : variant_generators_[i]->do_generate(active_regions[i]);
+        }
+    } else {
+        for (std::size_t i {0}; i < variant_generators_.size(); ++i) {
+            const auto active_regions = generate_active_regions(region, *variant_generators_[i]);
+            debug::log_active_regions(active_regions, variant_generators_[i]->name(), debug_log_);
+            generator_results[i] = variant_generators_[i]->do_generate(active_regions);
+        }
+    }
+    std::size_t num_candidates {0};
+    for (std::size_t i {0}; i < variant_generators_.size(); ++i) {
+        debug::log_candidates(generator_results[i], variant_generators_[i]->name(), debug_log_);
+        assert(std::is_sorted(std::cbegin(generator_results[i]), std::cend(generator_results[i])));
+        num_candidates += generator_results[i].size();
     }
     // Each generator is guaranteed to return unique variants, but two generators can still
-    // propose the same variants independently.
-    remove_duplicates(result);
+    // propose the same variants independently. These are filtered with a hash set before
+    // the merge rather than uniqued after it, so duplicates never take part in the merge.
+    // The set compares variants on hash collision, so distinct candidates cannot be dropped
+    std::unordered_set<std::reference_wrapper<const Variant>, VariantRefHash, VariantRefEqual> seen_candidates {};
+    seen_candidates.reserve(num_candidates);
+    for (auto& generator_result : generator_results) {
+        generator_result.erase(std::remove_if(std::begin(generator_result), std::end(generator_result),
+                                              [&seen_candidates] (const Variant& candidate) {
+                                                  return seen_candidates.count(std::cref(candidate)) == 1;
+                                              }), std::end(generator_result));
+        for (const Variant& candidate : generator_result) seen_candidates.emplace(candidate);
+    }
+    std::vector<Variant> result {};
+    result.reserve(num_candidates);
+    if (generation_workers_ && !generation_workers_->empty() && generator_results.size() > 2) {
+        // The reserve above guarantees appends don't reallocate, so run boundaries stay valid
+        std::vector<std::vector<Variant>::iterator> run_bounds {};
+        run_bounds.reserve(generator_results.size() + 1);
+        run_bounds.push_back(std::begin(result));
+        for (auto& generator_result : generator_results) {
+            utils::append(std::move(generator_result), result);
+            run_bounds.push_back(std::end(result));
+        }
+        parallel_merge_runs(std::move(run_bounds), std::less<Variant> {}, *generation_workers_);
+    } else {
+        for (auto& generator_result : generator_results) {
+            auto itr = utils::append(std::move(generator_result), result);
+            std::inplace_merge(std::begin(result), itr, std::end(result));
+        }
+    }
     return result;
 }
 
@@ -114,6 +198,13 @@ void VariantGenerator::add_read(const SampleName& sample, const AlignedRead& rea
     for (auto& generator : variant_generators_) generator->do_add_read(sample, read);
 }
 
+void VariantGenerator::enable_parallel_generation(ThreadPool& workers) noexcept
+{
+    generation_workers_ = std::addressof(workers);
+    do_enable_parallel_generation(workers);
+    for (auto& generator : variant_generators_) generator->enable_parallel_generation(workers);
+}
+
 void VariantGenerator::clear() noexcept
 {
     if (active_region_generator_) active_region_generator_->clear();
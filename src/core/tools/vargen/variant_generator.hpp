@@ -22,7 +22,11 @@
 #include "containers/mappable_flat_multi_set.hpp"
 #include "active_region_generator.hpp"
 
-namespace octopus { namespace coretools {
+namespace octopus {
+
+class ThreadPool;
+
+namespace coretools {
 
 class VariantGenerator
 {
@@ -52,10 +56,13 @@ public:
     void add_reads(const SampleName& sample, InputIt first, InputIt last);
     
     void clear() noexcept;
-    
+
+    // The pool must outlive the generator and any clones made after the call
+    void enable_parallel_generation(ThreadPool& workers) noexcept;
+
 protected:
     using ReadVectorIterator  = std::vector<AlignedRead>::const_iterator;
-    using ReadFlatSetIterator = MappableFlatMultiSet<AlignedRead>::const_iterator;
+    using ReadFlatSetIterator = ReadContainer::const_iterator;
     
     using RegionSet = std::vector<GenomicRegion>;
     
@@ -65,6 +72,7 @@ protected:
 private:
     std::vector<std::unique_ptr<VariantGenerator>> variant_generators_;
     boost::optional<ActiveRegionGenerator> active_region_generator_;
+    ThreadPool* generation_workers_ = nullptr;
     
     virtual std::unique_ptr<VariantGenerator> do_clone() const;
     virtual std::vector<Variant> do_generate(const RegionSet& regions) const { return {}; };
@@ -79,6 +87,11 @@ private:
     virtual void do_add_reads(const SampleName& sample, ReadVectorIterator first, ReadVectorIterator last) {};
     virtual void do_add_reads(const SampleName& sample, ReadFlatSetIterator first, ReadFlatSetIterator last) {};
     virtual void do_clear() noexcept {};
+    virtual void do_enable_parallel_generation(ThreadPool& workers) noexcept {};
+    // Generators that dispatch subtasks of their own to the pool must run on
+    // the calling thread, as a pool task that blocks on further pool tasks can
+    // deadlock the pool
+    virtual bool do_dispatches_generation_subtasks() const noexcept { return false; };
     
     virtual std::string name() const { return "VariantGenerator"; }
     
@@ -8,6 +8,9 @@
 #include <iterator>
 #include <utility>
 
+#include <boost/filesystem/operations.hpp>
+#include <boost/range/iterator_range.hpp>
+
 #include "io/variant/vcf_spec.hpp"
 #include "io/variant/vcf_record.hpp"
 #include "utils/sequence_utils.hpp"
@@ -22,7 +25,18 @@ VcfExtractor::VcfExtractor(std::unique_ptr<const VcfReader> reader)
 VcfExtractor::VcfExtractor(std::unique_ptr<const VcfReader> reader, Options options)
 : reader_ {std::move(reader)}
 , options_ {options}
-{}
+{
+    try {
+        using boost::filesystem::exists;
+        using boost::filesystem::last_write_time;
+        const auto cache_path = candidate_variant_cache_path(reader_->path());
+        if (exists(cache_path) && last_write_time(cache_path) >= last_write_time(reader_->path())) {
+            cache_ = std::make_shared<CandidateVariantCache>(cache_path);
+        }
+    } catch (...) {
+        cache_.reset(); // fall back to parsing the source VCF
+    }
+}
 
 std::unique_ptr<VariantGenerator> VcfExtractor::do_clone() const
 {
@@ -46,41 +60,45 @@ auto make_allele(const Iterator first_base, const Iterator last_base)
     return result;
 }
 
+template <typename Sequence, typename Container>
+void decompose(const std::string& contig, VcfRecord::NucleotideSequence::size_type begin,
+               const Sequence& ref_allele, const Sequence& alt_allele, Container& result)
+{
+    if (ref_allele.size() != alt_allele.size()) {
+        const auto p = std::mismatch(std::cbegin(ref_allele), std::cend(ref_allele),
+                                     std::cbegin(alt_allele), std::cend(alt_allele));
+        if (p.first != std::cend(ref_allele) && alt_allele.size() > ref_allele.size()) {
+            // Split non-reference padded insertions into snv (or mnv) and insertion with empty
+            // reference (e.g. A -> TT makes two variants A -> T and -> T).
+            const auto ref_pad_size = std::distance(std::cbegin(ref_allele), p.first);
+            begin += ref_pad_size;
+            const auto remaining_ref_size = ref_allele.size() - ref_pad_size;
+            const auto first_alt_end = std::next(p.second, remaining_ref_size);
+            result.emplace_back(contig, begin - 1,
+                                make_allele(p.first, std::cend(ref_allele)),
+                                make_allele(p.second, first_alt_end));
+            begin += remaining_ref_size;
+            result.emplace_back(contig, begin - 1, "",
+                                make_allele(first_alt_end, std::cend(alt_allele)));
+        } else {
+            begin += std::distance(std::cbegin(ref_allele), p.first);
+            result.emplace_back(contig, begin - 1,
+                                make_allele(p.first, std::cend(ref_allele)),
+                                make_allele(p.second, std::cend(alt_allele)));
+        }
+    } else {
+        result.emplace_back(contig, begin - 1,
+                            make_allele(std::cbegin(ref_allele), std::cend(ref_allele)),
+                            make_allele(std::cbegin(alt_allele), std::cend(alt_allele)));
+    }
+}
+
 template <typename Container>
 void extract_variants(const VcfRecord& record, Container& result)
 {
     for (const auto& alt_allele : record.alt()) {
         if (is_canonical(alt_allele)) {
-            const auto& ref_allele = record.ref();
-            if (ref_allele.size() != alt_allele.size()) {
-                auto begin = record.pos();
-                const auto p = std::mismatch(std::cbegin(ref_allele), std::cend(ref_allele),
-                                             std::cbegin(alt_allele), std::cend(alt_allele));
-                if (p.first != std::cend(ref_allele) && alt_allele.size() > ref_allele.size()) {
-                    // Split non-reference padded insertions into snv (or mnv) and insertion with empty
-                    // reference (e.g. A -> TT makes two variants A -> T and -> T).
-                    const auto ref_pad_size = std::distance(std::cbegin(ref_allele), p.first);
-                    begin += ref_pad_size;
-                    const auto remaining_ref_size = ref_allele.size() - ref_pad_size;
-                    const auto first_alt_end = std::next(p.second, remaining_ref_size);
-                    result.emplace_back(record.chrom(), begin - 1,
-                                        make_allele(p.first, std::cend(ref_allele)),
-                                        make_allele(p.second, first_alt_end));
-                    begin += remaining_ref_size;
-                    result.emplace_back(record.chrom(), begin - 1, "",
-                                        make_allele(first_alt_end, std::cend(alt_allele)));
-                } else {
-                    begin += std::distance(std::cbegin(ref_allele), p.first);
-                    result.emplace_back(record.chrom(), begin - 1,
-                                        make_allele(p.first, std::cend(ref_allele)),
-                                        make_allele(p.second, std::cend(alt_allele)));
-                }
-            } else {
-                using utils::capitalise_copy;
-                result.emplace_back(record.chrom(), record.pos() - 1,
-                                    capitalise_copy(record.ref()),
-                                    capitalise_copy(alt_allele));
-            }
+            decompose(record.chrom(), record.pos(), record.ref(), alt_allele, result);
         }
     }
 }
@@ -104,9 +122,20 @@ std::string VcfExtractor::name() const
 std::vector<Variant> VcfExtractor::fetch_variants(const GenomicRegion& region) const
 {
   std::deque<Variant> variants {};
-    for (auto p = reader_->iterate(region, VcfReader::UnpackPolicy::sites); p.first != p.second; ++p.first) {
-        if (is_good(*p.first)) {
-            extract_variants(*p.first, variants);
+    if (cache_) {
+        for (const auto& candidate : cache_->fetch_overlapped(region)) {
+            if (is_good(candidate)) {
+                decompose(region.contig_name(), candidate.pos,
+                          boost::make_iterator_range(candidate.ref, candidate.ref + candidate.ref_length),
+                          boost::make_iterator_range(candidate.alt, candidate.alt + candidate.alt_length),
+                          variants);
+            }
+        }
+    } else {
+        for (auto p = reader_->iterate(region, VcfReader::UnpackPolicy::sites); p.first != p.second; ++p.first) {
+            if (is_good(*p.first)) {
+                extract_variants(*p.first, variants);
+            }
         }
     }
     std::vector<Variant> result {std::make_move_iterator(std::begin(variants)),
@@ -122,5 +151,11 @@ bool VcfExtractor::is_good(const VcfRecord& record) const
     return !options_.min_quality || (record.qual() && *record.qual() >= *options_.min_quality);
 }
 
+bool VcfExtractor::is_good(const CandidateVariantCache::Candidate& candidate) const noexcept
+{
+    if (!options_.extract_filtered && candidate.is_filtered) return false;
+    return !options_.min_quality || (candidate.quality && *candidate.quality >= *options_.min_quality);
+}
+
 } // namespace coretools
 } // namespace octopus
@@ -13,6 +13,7 @@
 #include "io/variant/vcf.hpp"
 #include "core/types/variant.hpp"
 #include "variant_generator.hpp"
+#include "utils/candidate_variant_cache.hpp"
 
 namespace octopus {
 
@@ -48,10 +49,12 @@ private:
     std::string name() const override;
     
     std::shared_ptr<const VcfReader> reader_;
+    std::shared_ptr<const CandidateVariantCache> cache_;
     Options options_;
-    
+
     std::vector<Variant> fetch_variants(const GenomicRegion& region) const;
     bool is_good(const VcfRecord& record) const;
+    bool is_good(const CandidateVariantCache::Candidate& candidate) const noexcept;
 };
 
 } // namespace coretools
@@ -4,6 +4,8 @@
 #include "vcf_record_factory.hpp"
 
 #include <string>
+#include <array>
+#include <cstdint>
 #include <unordered_set>
 #include <set>
 #include <unordered_map>
@@ -14,12 +16,15 @@
 #include <sstream>
 #include <iostream>
 
+#include <future>
+
 #include <boost/optional.hpp>
 
 #include "concepts/equitable.hpp"
 #include "concepts/mappable.hpp"
 #include "basics/genomic_region.hpp"
 #include "basics/mappable_reference_wrapper.hpp"
+#include "basics/phred.hpp"
 #include "core/types/allele.hpp"
 #include "core/types/calls/variant_call.hpp"
 #include "utils/mappable_algorithms.hpp"
@@ -27,6 +32,7 @@
 #include "utils/string_utils.hpp"
 #include "utils/maths.hpp"
 #include "utils/append.hpp"
+#include "utils/thread_pool.hpp"
 #include "exceptions/program_error.hpp"
 #include "io/variant/vcf_spec.hpp"
 #include "config/octopus_vcf.hpp"
@@ -50,10 +56,24 @@ VcfRecordFactory::VcfRecordFactory(const ReferenceGenome& reference, const ReadM
 , sites_only_ {sites_only}
 {}
 
+void VcfRecordFactory::enable_parallel_conversion(ThreadPool& workers) noexcept
+{
+    conversion_workers_ = std::addressof(workers);
+}
+
 namespace {
 
 using CallWrapperReference = MappableReferenceWrapper<CallWrapper>;
 
+// A unit of record finalization: either a lone call, or one begin/end segment
+// of a block of interacting calls. Representation resolution has to walk the
+// calls in order, but formatting the resolved units is independent
+struct FinalizationUnit
+{
+    std::vector<std::unique_ptr<Call>> calls;
+    bool is_segment;
+};
+
 bool are_in_phase(const Call::GenotypeCall& lhs, const Call::GenotypeCall& rhs)
 {
     return lhs.phase && overlaps(lhs.phase->region(), rhs.genotype);
@@ -247,17 +267,19 @@ std::vector<VcfRecord> VcfRecordFactory::make(std::vector<CallWrapper>&& calls)
     assert(std::is_sorted(std::cbegin(calls), std::cend(calls)));
     resolve_indel_genotypes(calls, samples_);
     pad_indels(calls, samples_);
-    std::vector<VcfRecord> result {};
-    result.reserve(calls.size());
+    if (!calls.empty()) {
+        reference_context_ = reference_.fetch_slice(encompassing_region(calls));
+    }
+    std::vector<FinalizationUnit> units {};
+    units.reserve(calls.size());
     for (auto call_itr = begin(calls); call_itr != end(calls);) {
         const auto block_begin_itr = adjacent_overlap_find(call_itr, end(calls));
-        transform(std::make_move_iterator(call_itr), std::make_move_iterator(block_begin_itr), std::back_inserter(result),
-                  [this] (CallWrapper&& call) {
-                      call->replace(dummy_base, reference_.fetch_sequence(head_position(call)).front());
-                      // We may still have uncalled genotyped alleles here if the called genotype
-                      // did not have a high posterior
-                      call->replace_uncalled_genotype_alleles(Allele {call->mapped_region(), vcfspec::missingValue}, 'N');
-                      return this->make(move(call.call));
+        transform(std::make_move_iterator(call_itr), std::make_move_iterator(block_begin_itr), std::back_inserter(units),
+                  [] (CallWrapper&& call) {
+                      FinalizationUnit unit {};
+                      unit.calls.push_back(move(call.call));
+                      unit.is_segment = false;
+                      return unit;
                   });
         if (block_begin_itr == end(calls)) break;
         auto block_end_itr = find_next_mutually_exclusive(block_begin_itr, end(calls));
@@ -278,7 +300,7 @@ std::vector<VcfRecord> VcfRecordFactory::make(std::vector<CallWrapper>&& calls)
         for_each(block_begin_itr, block_head_end_itr, [this, base, &duplicates] (auto& call) {
             assert(!call->reference().sequence().empty());
             if (call->reference().sequence().front() == dummy_base) {
-                const auto actual_reference_base = reference_.fetch_sequence(head_position(call)).front();
+                const auto actual_reference_base = reference_base(head_position(call));
                 auto new_sequence = call->reference().sequence();
                 new_sequence.front() = actual_reference_base;
                 Allele new_allele {mapped_region(call), move(new_sequence)};
@@ -377,7 +399,7 @@ std::vector<VcfRecord> VcfRecordFactory::make(std::vector<CallWrapper>&& calls)
             std::unordered_map<Allele, Allele> replacements {};
             assert(!curr_call->reference().sequence().empty());
             if (curr_call->reference().sequence().front() == dummy_base) {
-                const auto actual_reference_base = reference_.fetch_sequence(head_position(curr_call)).front();
+                const auto actual_reference_base = reference_base(head_position(curr_call));
                 auto new_ref_sequence = curr_call->reference().sequence();
                 new_ref_sequence.front() = actual_reference_base;
                 Allele new_ref_allele {mapped_region(curr_call), move(new_ref_sequence)};
@@ -493,11 +515,49 @@ std::vector<VcfRecord> VcfRecordFactory::make(std::vector<CallWrapper>&& calls)
                 transform(std::make_move_iterator(begin(new_segment)), std::make_move_iterator(end(new_segment)),
                           std::back_inserter(final_segment),
                           [] (auto&& call) -> std::unique_ptr<Call>&& { return move(call.call); });
-                result.emplace_back(this->make_segment(move(final_segment)));
+                units.push_back(FinalizationUnit {move(final_segment), true});
             }
         }
         call_itr = block_end_itr;
     }
+    const auto finalize = [this] (FinalizationUnit& unit) {
+        if (unit.is_segment) {
+            return this->make_segment(std::move(unit.calls));
+        }
+        auto& call = unit.calls.front();
+        call->replace(dummy_base, this->reference_base(head_position(call->mapped_region())));
+        // We may still have uncalled genotyped alleles here if the called genotype
+        // did not have a high posterior
+        call->replace_uncalled_genotype_alleles(Allele {call->mapped_region(), vcfspec::missingValue}, 'N');
+        return this->make(std::move(call));
+    };
+    std::vector<VcfRecord> result {};
+    result.reserve(units.size());
+    if (conversion_workers_ && !conversion_workers_->empty() && units.size() > 1) {
+        // Units only touch their own calls, so they can be formatted in
+        // parallel chunks and emitted in order
+        const auto chunk_size = std::max(units.size() / (4 * conversion_workers_->size()), std::size_t {1});
+        std::vector<std::future<std::vector<VcfRecord>>> chunk_futures {};
+        chunk_futures.reserve((units.size() + chunk_size - 1) / chunk_size);
+        for (std::size_t chunk_begin {0}; chunk_begin < units.size(); chunk_begin += chunk_size) {
+            const auto chunk_end = std::min(chunk_begin + chunk_size, units.size());
+            chunk_futures.push_back(conversion_workers_->push([&units, &finalize, chunk_begin, chunk_end] () {
+                std::vector<VcfRecord> chunk_records {};
+                chunk_records.reserve(chunk_end - chunk_begin);
+                for (auto i = chunk_begin; i < chunk_end; ++i) {
+                    chunk_records.push_back(finalize(units[i]));
+                }
+                return chunk_records;
+            }));
+        }
+        for (auto& chunk_future : chunk_futures) {
+            utils::append(chunk_future.get(), result);
+        }
+    } else {
+        for (auto& unit : units) {
+            result.push_back(finalize(unit));
+        }
+    }
     return result;
 }
 
@@ -606,6 +666,46 @@ void set_allele_counts(const Call& call, const std::vector<SampleName>& samples,
     result.set_info("AN", std::get<2>(t));
 }
 
+char VcfRecordFactory::reference_base(const GenomicRegion& position) const
+{
+    if (reference_context_.contains(position)) {
+        return reference_context_.view(position).front();
+    }
+    return reference_.fetch_sequence(position).front();
+}
+
+namespace {
+
+// Every emitted quality gets rounded and clamped, which is hot enough over a
+// large callset for the std::pow hidden in maths::round to show. Rounding the
+// fixed-point milli-phred score instead makes these pure integer operations
+auto round_to_centi(const Phred<double> quality) noexcept
+{
+    return static_cast<double>((quality.milli_score() + 5) / 10) / 100;
+}
+
+auto to_qual(const Phred<double> quality, const double max_qual) noexcept
+{
+    return std::min(max_qual, round_to_centi(quality));
+}
+
+// GQ is clamped to 999 and PQ to 99, so every integer quality string the
+// factory can emit is formatted once and then reused
+std::string to_quality_string(const Phred<double> quality, const std::int64_t max)
+{
+    const static auto preformattedScores = [] {
+        std::array<std::string, 1000> result {};
+        for (std::size_t score {0}; score < result.size(); ++score) {
+            result[score] = std::to_string(score);
+        }
+        return result;
+    }();
+    const auto score = std::min((quality.milli_score() + 500) / 1000, max);
+    return preformattedScores[score];
+}
+
+} // namespace
+
 VcfRecord VcfRecordFactory::make(std::unique_ptr<Call> call) const
 {
     auto result = VcfRecord::Builder {};
@@ -624,7 +724,7 @@ VcfRecord VcfRecordFactory::make(std::unique_ptr<Call> call) const
     result.set_pos(mapped_begin(region) + 1);
     result.set_ref(call->reference().sequence());
     result.set_alt(std::move(alts));
-    result.set_qual(std::min(max_qual, maths::round(call->quality().score(), 2)));
+    result.set_qual(to_qual(call->quality(), max_qual));
     const auto call_reads = copy_overlapped(reads_, region);
     result.set_info("NS",  count_samples_with_coverage(call_reads));
     result.set_info("DP",  sum_max_coverages(call_reads));
@@ -633,7 +733,7 @@ VcfRecord VcfRecordFactory::make(std::unique_ptr<Call> call) const
     set_allele_counts(*call, samples_, result);
     
     if (call->model_posterior()) {
-        result.set_info("MP",  maths::round(call->model_posterior()->score(), 2));
+        result.set_info("MP",  round_to_centi(*call->model_posterior()));
     }
     
     if (!sites_only_) {
@@ -644,16 +744,14 @@ VcfRecord VcfRecordFactory::make(std::unique_ptr<Call> call) const
         }
         for (const auto& sample : samples_) {
             const auto& genotype_call = call->get_genotype_call(sample);
-            auto gq = std::min(999, static_cast<int>(std::round(genotype_call.posterior.score())));
             set_vcf_genotype(sample, genotype_call, result, has_non_ref);
-            result.set_format(sample, "GQ", std::to_string(gq));
+            result.set_format(sample, "GQ", to_quality_string(genotype_call.posterior, 999));
             result.set_format(sample, "DP", max_coverage(call_reads.at(sample)));
             result.set_format(sample, "MQ", static_cast<unsigned>(rmq_mapping_quality(call_reads.at(sample))));
             if (call->is_phased(sample)) {
                 const auto& phase = *genotype_call.phase;
-                auto pq = std::min(99, static_cast<int>(std::round(phase.score().score())));
                 result.set_format(sample, "PS", mapped_begin(phase.region()) + 1);
-                result.set_format(sample, "PQ", std::to_string(pq));
+                result.set_format(sample, "PQ", to_quality_string(phase.score(), 99));
             }
         }
     }
@@ -664,19 +762,16 @@ VcfRecord VcfRecordFactory::make(std::unique_ptr<Call> call) const
 
 namespace {
 
-boost::optional<double> get_model_posterior(const std::vector<std::unique_ptr<Call>>& calls)
+boost::optional<Phred<double>> get_model_posterior(const std::vector<std::unique_ptr<Call>>& calls)
 {
-    std::vector<double> model_posteriors {};
-    model_posteriors.reserve(calls.size());
+    boost::optional<Phred<double>> result {};
     for (const auto& call : calls) {
         const auto call_model_posterior = call->model_posterior();
-        if (call_model_posterior) model_posteriors.push_back(call_model_posterior->score());
-    }
-    if (model_posteriors.empty()) {
-        return boost::none;
-    } else {
-        return *std::max_element(std::cbegin(model_posteriors), std::cend(model_posteriors));
+        if (call_model_posterior && (!result || *result < *call_model_posterior)) {
+            result = *call_model_posterior;
+        }
     }
+    return result;
 }
 
 auto get_allele_counts(const std::vector<VcfRecord::NucleotideSequence>& alt_alleles,
@@ -772,7 +867,7 @@ VcfRecord VcfRecordFactory::make_segment(std::vector<std::unique_ptr<Call>>&& ca
     result.set_alt(std::move(alt_alleles));
     auto q = std::min_element(std::cbegin(calls), std::cend(calls),
                               [] (const auto& lhs, const auto& rhs) { return lhs->quality() < rhs->quality(); });
-    result.set_qual(std::min(max_qual, maths::round(q->get()->quality().score(), 2)));
+    result.set_qual(to_qual(q->get()->quality(), max_qual));
     result.set_info("NS",  count_samples_with_coverage(reads_, region));
     result.set_info("DP",  sum_max_coverages(reads_, region));
     result.set_info("MQ",  static_cast<unsigned>(rmq_mapping_quality(reads_, region)));
@@ -780,7 +875,7 @@ VcfRecord VcfRecordFactory::make_segment(std::vector<std::unique_ptr<Call>>&& ca
     
     const auto mp = get_model_posterior(calls);
     if (mp) {
-        result.set_info("MP", maths::round(*mp, 2));
+        result.set_info("MP", round_to_centi(*mp));
     }
     if (!sites_only_) {
         if (calls.front()->all_phased()) {
@@ -792,21 +887,19 @@ VcfRecord VcfRecordFactory::make_segment(std::vector<std::unique_ptr<Call>>&& ca
         auto sample_itr = std::begin(resolved_genotypes);
         for (const auto& sample : samples_) {
             const auto posterior = calls.front()->get_genotype_call(sample).posterior;
-            auto gq = std::min(999, static_cast<int>(std::round(posterior.score())));
             auto& genotype_call = *sample_itr++;
             if (has_non_ref) {
                 std::replace(std::begin(genotype_call), std::end(genotype_call),
                              std::string {vcfspec::missingValue}, std::string {vcf::spec::allele::nonref});
             }
             result.set_genotype(sample, genotype_call, VcfRecord::Builder::Phasing::phased);
-            result.set_format(sample, "GQ", std::to_string(gq));
+            result.set_format(sample, "GQ", to_quality_string(posterior, 999));
             result.set_format(sample, "DP", max_coverage(reads_.at(sample), region));
             result.set_format(sample, "MQ", static_cast<unsigned>(rmq_mapping_quality(reads_.at(sample), region)));
             if (calls.front()->is_phased(sample)) {
                 const auto phase = *calls.front()->get_genotype_call(sample).phase;
-                auto pq = std::min(99, static_cast<int>(std::round(phase.score().score())));
                 result.set_format(sample, "PS", mapped_begin(phase.region()) + 1);
-                result.set_format(sample, "PQ", std::to_string(pq));
+                result.set_format(sample, "PQ", to_quality_string(phase.score(), 99));
             }
         }
     }
@@ -15,6 +15,8 @@
 
 namespace octopus {
 
+class ThreadPool;
+
 class VcfRecordFactory
 {
 public:
@@ -32,15 +34,24 @@ public:
     
     std::vector<VcfRecord> make(std::vector<CallWrapper>&& calls) const;
     
+    // The pool must outlive the factory
+    void enable_parallel_conversion(ThreadPool& workers) noexcept;
+    
 private:
     const ReferenceGenome& reference_;
     const ReadMap& reads_;
     std::vector<SampleName> samples_;
     bool sites_only_;
     double max_qual = 10000;
+    ThreadPool* conversion_workers_ = nullptr;
+    // One shared slice covering the calls being converted, so the repeated
+    // single-base lookups during finalisation do not each round-trip the
+    // reference reader. Set at the top of make, before any parallel work
+    mutable ReferenceSlice reference_context_;
     
     VcfRecord make(std::unique_ptr<Call> call) const;
     VcfRecord make_segment(std::vector<std::unique_ptr<Call>>&& calls) const;
+    char reference_base(const GenomicRegion& position) const;
 };
 
 } // namespace octopus
@@ -143,17 +143,17 @@ bool Genotype<Haplotype>::HaplotypePtrLess::operator()(const HaplotypePtr& lhs,
 
 bool Genotype<Haplotype>::HaplotypePtrEqual::operator()(const HaplotypePtr& lhs, const HaplotypePtr& rhs) const
 {
-    return *lhs == *rhs;
+    return lhs == rhs || (lhs->get_hash() == rhs->get_hash() && *lhs == *rhs);
 }
 
 bool Genotype<Haplotype>::HaplotypePtrEqual::operator()(const Haplotype& lhs, const HaplotypePtr& rhs) const
 {
-    return lhs == *rhs;
+    return lhs.get_hash() == rhs->get_hash() && lhs == *rhs;
 }
 
 bool Genotype<Haplotype>::HaplotypePtrEqual::operator()(const HaplotypePtr& lhs, const Haplotype& rhs) const
 {
-    return *lhs == rhs;
+    return lhs->get_hash() == rhs.get_hash() && *lhs == rhs;
 }
 
 Genotype<Haplotype>::Iterator::Iterator(BaseIterator it) : BaseIterator {it} {}
@@ -185,6 +185,16 @@ typename Genotype<Haplotype>::Iterator Genotype<Haplotype>::cend() const noexcep
 
 // non-member methods
 
+bool operator==(const Genotype<Haplotype>& lhs, const Genotype<Haplotype>& rhs)
+{
+    return lhs.ploidy() == rhs.ploidy()
+           && std::equal(std::cbegin(lhs.haplotypes_), std::cend(lhs.haplotypes_), std::cbegin(rhs.haplotypes_),
+                         [] (const auto& lhs_ptr, const auto& rhs_ptr) {
+                             return lhs_ptr == rhs_ptr
+                                    || (lhs_ptr->get_hash() == rhs_ptr->get_hash() && *lhs_ptr == *rhs_ptr);
+                         });
+}
+
 bool contains(const Genotype<Haplotype>& genotype, const Allele& allele)
 {
     return std::any_of(std::cbegin(genotype), std::cend(genotype),
@@ -124,6 +124,7 @@ public:
     std::vector<Haplotype> copy_unique() const;
     std::vector<std::reference_wrapper<const Haplotype>> copy_unique_ref() const;
     std::vector<unsigned> unique_counts() const;
+    friend bool operator==(const Genotype<Haplotype>& lhs, const Genotype<Haplotype>& rhs);
     
 private:
     using HaplotypePtr  = std::shared_ptr<Haplotype>;
@@ -541,6 +542,11 @@ bool operator==(const Genotype<MappableType>& lhs, const Genotype<MappableType>&
     return lhs.ploidy() == rhs.ploidy() && std::equal(std::cbegin(lhs), std::cend(lhs), std::cbegin(rhs));
 }
 
+// Haplotypes are shared flyweight-style between genotypes built from the same
+// pool, so handle identity - and failing that the cached sequence hashes -
+// settles almost all comparisons without touching the sequences themselves
+bool operator==(const Genotype<Haplotype>& lhs, const Genotype<Haplotype>& rhs);
+
 struct GenotypeLess
 {
     template <typename T>
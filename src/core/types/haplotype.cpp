@@ -109,14 +109,14 @@ bool Haplotype::includes(const ContigAllele& allele) const
             return false;
         } else if (is_after(allele, explicit_allele_region_)) {
             if (is_indel(allele)) return false;
-            const auto ref_ritr = std::next(std::crbegin(sequence_), end_distance(allele, region_.contig_region()));
-            assert(static_cast<std::size_t>(std::distance(ref_ritr, std::crend(sequence_))) >= allele.sequence().size());
+            const auto ref_ritr = std::next(std::crbegin(*sequence_), end_distance(allele, region_.contig_region()));
+            assert(static_cast<std::size_t>(std::distance(ref_ritr, std::crend(*sequence_))) >= allele.sequence().size());
             return std::equal(std::crbegin(allele.sequence()), std::crend(allele.sequence()), ref_ritr);
         }
     }
     if (is_indel(allele)) return false;
-    const auto ref_itr = std::next(std::cbegin(sequence_), begin_distance(region_.contig_region(), allele));
-    assert(static_cast<std::size_t>(std::distance(ref_itr, std::cend(sequence_))) >= allele.sequence().size());
+    const auto ref_itr = std::next(std::cbegin(*sequence_), begin_distance(region_.contig_region(), allele));
+    assert(static_cast<std::size_t>(std::distance(ref_itr, std::cend(*sequence_))) >= allele.sequence().size());
     return std::equal(std::cbegin(allele.sequence()), std::cend(allele.sequence()), ref_itr);
 }
 
@@ -148,7 +148,7 @@ Haplotype::NucleotideSequence Haplotype::sequence(const ContigRegion& region) co
         throw std::out_of_range {"Haplotype: attempting to sequence from region not contained by Haplotype region"};
     }
     if (explicit_alleles_.empty()) {
-        return sequence_.substr(begin_distance(region_.contig_region(), region), region_size(region));
+        return sequence_->substr(begin_distance(region_.contig_region(), region), region_size(region));
     }
     if (is_in_reference_flank(region, explicit_allele_region_, explicit_alleles_)) {
         return fetch_reference_sequence(region);
@@ -202,7 +202,7 @@ Haplotype::NucleotideSequence Haplotype::sequence(const GenomicRegion& region) c
 
 const Haplotype::NucleotideSequence& Haplotype::sequence() const noexcept
 {
-    return sequence_;
+    return *sequence_;
 }
 
 Haplotype::NucleotideSequence::size_type Haplotype::sequence_size(const ContigRegion& region) const
@@ -325,7 +325,7 @@ CigarString Haplotype::cigar() const
     } else {
         result.emplace_back(size(region_), Flag::sequenceMatch);
     }
-    assert(octopus::sequence_size(result) == sequence_.size());
+    assert(octopus::sequence_size(result) == sequence_->size());
     assert(reference_size(result) == size(region_));
     return result;
 }
@@ -351,11 +351,11 @@ void Haplotype::append_reference(NucleotideSequence& result, const ContigRegion&
 {
     if (is_before(region, explicit_allele_region_)) {
         const auto offset = begin_distance(region_.contig_region(), region);
-        const auto it = std::next(std::cbegin(sequence_), offset);
+        const auto it = std::next(std::cbegin(*sequence_), offset);
         result.append(it, std::next(it, region_size(region)));
     } else {
         const auto offset = end_distance(region, region_.contig_region());
-        const auto it = std::prev(std::cend(sequence_), offset);
+        const auto it = std::prev(std::cend(*sequence_), offset);
         result.append(std::prev(it, region_size(region)), it);
     }
 }
@@ -447,7 +447,7 @@ void Haplotype::Builder::push_back(const Allele& allele)
     if (!is_same_contig(allele, region_)) {
         throw std::domain_error {"Haplotype::push_back called with Allele on different contig"};
     }
-    push_back(ContigAllele {contig_region(allele), allele.sequence()});
+    push_back(demote(allele));
 }
 
 void Haplotype::Builder::push_front(const Allele& allele)
@@ -455,7 +455,7 @@ void Haplotype::Builder::push_front(const Allele& allele)
     if (!is_same_contig(allele, region_)) {
         throw std::domain_error {"Haplotype::push_front called with Allele on different contig"};
     }
-    push_front(ContigAllele {contig_region(allele), allele.sequence()});
+    push_front(demote(allele));
 }
 
 void Haplotype::Builder::push_back(Allele&& allele)
@@ -463,7 +463,7 @@ void Haplotype::Builder::push_back(Allele&& allele)
     if (!is_same_contig(allele, region_)) {
         throw std::domain_error {"Haplotype::push_back called with Allele on different contig"};
     }
-    push_back(ContigAllele {contig_region(allele), allele.sequence()});
+    push_back(demote(std::move(allele)));
 }
 
 void Haplotype::Builder::push_front(Allele&& allele)
@@ -471,7 +471,7 @@ void Haplotype::Builder::push_front(Allele&& allele)
     if (!is_same_contig(allele, region_)) {
         throw std::domain_error {"Haplotype::push_front called with Allele on different contig"};
     }
-    push_front(ContigAllele {contig_region(allele), allele.sequence()});
+    push_front(demote(std::move(allele)));
 }
 
 Haplotype Haplotype::Builder::build()
@@ -7,6 +7,7 @@
 #include <deque>
 #include <cstddef>
 #include <functional>
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include <numeric>
@@ -110,7 +111,9 @@ private:
     GenomicRegion region_;
     std::vector<ContigAllele> explicit_alleles_;
     ContigRegion explicit_allele_region_;
-    NucleotideSequence sequence_;
+    // The sequence is immutable once built, so copies share one buffer rather
+    // than duplicating kilobases of bases
+    std::shared_ptr<const NucleotideSequence> sequence_;
     std::size_t cached_hash_;
     std::reference_wrapper<const ReferenceGenome> reference_;
     
@@ -127,8 +130,8 @@ Haplotype::Haplotype(R&& region, const ReferenceGenome& reference)
 : region_ {std::forward<R>(region)}
 , explicit_alleles_ {}
 , explicit_allele_region_ {}
-, sequence_ {reference.fetch_sequence(region_)}
-, cached_hash_ {std::hash<NucleotideSequence>()(sequence_)}
+, sequence_ {std::make_shared<const NucleotideSequence>(reference.fetch_sequence(region_))}
+, cached_hash_ {std::hash<NucleotideSequence>()(*sequence_)}
 , reference_ {reference}
 {}
 
@@ -137,12 +140,12 @@ Haplotype::Haplotype(R&& region, S&& sequence, const ReferenceGenome& reference)
 : region_ {std::forward<R>(region)}
 , explicit_alleles_ {}
 , explicit_allele_region_ {region_.contig_region()}
-, sequence_ {std::forward<S>(sequence)}
-, cached_hash_ {std::hash<NucleotideSequence>()(sequence_)}
+, sequence_ {std::make_shared<const NucleotideSequence>(std::forward<S>(sequence))}
+, cached_hash_ {std::hash<NucleotideSequence>()(*sequence_)}
 , reference_ {reference}
 {
     explicit_alleles_.reserve(1);
-    explicit_alleles_.emplace_back(explicit_allele_region_, sequence_);
+    explicit_alleles_.emplace_back(explicit_allele_region_, *sequence_);
 }
 
 namespace detail {
@@ -165,6 +168,7 @@ Haplotype::Haplotype(R&& region, ForwardIt first_allele, ForwardIt last_allele,
 , cached_hash_ {0}
 , reference_ {reference}
 {
+    NucleotideSequence sequence {};
     if (!explicit_alleles_.empty()) {
         explicit_allele_region_ = encompassing_region(explicit_alleles_.front(), explicit_alleles_.back());
         auto num_bases = std::accumulate(std::cbegin(explicit_alleles_), std::cend(explicit_alleles_),
@@ -176,20 +180,21 @@ Haplotype::Haplotype(R&& region, ForwardIt first_allele, ForwardIt last_allele,
         const auto rhs_reference_region = right_overhang_region(region_.contig_region(),
                                                                 explicit_allele_region_);
         num_bases += region_size(lhs_reference_region) + region_size(rhs_reference_region);
-        
-        sequence_.reserve(num_bases);
+
+        sequence.reserve(num_bases);
         const auto& contig = region_.contig_name();
         if (!is_empty(lhs_reference_region)) {
-            detail::append(sequence_, reference, contig, lhs_reference_region);
+            detail::append(sequence, reference, contig, lhs_reference_region);
         }
-        append(sequence_, std::cbegin(explicit_alleles_), std::cend(explicit_alleles_));
+        append(sequence, std::cbegin(explicit_alleles_), std::cend(explicit_alleles_));
         if (!is_empty(rhs_reference_region)) {
-            detail::append(sequence_, reference, contig, rhs_reference_region);
+            detail::append(sequence, reference, contig, rhs_reference_region);
         }
     } else {
-        sequence_ = reference.fetch_sequence(region_);
+        sequence = reference.fetch_sequence(region_);
     }
-    cached_hash_ = std::hash<NucleotideSequence>()(sequence_);
+    sequence_ = std::make_shared<const NucleotideSequence>(std::move(sequence));
+    cached_hash_ = std::hash<NucleotideSequence>()(*sequence_);
 }
 
 class Haplotype::Builder
@@ -11,8 +11,13 @@
 #include <sstream>
 #include <cassert>
 
+#include <mutex>
+
 #include <boost/filesystem/operations.hpp>
+#include <boost/optional.hpp>
 #include <htslib/sam.h>
+#include <htslib/cram.h>
+#include <htslib/thread_pool.h>
 
 #include "basics/cigar_string.hpp"
 #include "basics/genomic_region.hpp"
@@ -166,13 +171,116 @@ bool is_cram(const boost::filesystem::path& file)
     return file.extension().string() == ".cram";
 }
 
+// All open CRAM readers decode through one htslib reference cache; the cache
+// itself is refcounted by each file handle sharing it, so the registry only
+// needs to know when the last holder has gone
+std::mutex cramRefsMutex {};
+boost::optional<boost::filesystem::path> cramReferencePath {};
+refs_t* sharedCramRefs {nullptr};
+unsigned numSharedCramRefHolders {0};
+
+// One pool of decode workers serves every open hts file; files queue block
+// decompression jobs here instead of inflating on the fetching thread
+std::mutex decodePoolMutex {};
+struct SharedDecodePool
+{
+    htsThreadPool pool {nullptr, 0};
+    ~SharedDecodePool() noexcept { if (pool.pool) hts_tpool_destroy(pool.pool); }
+};
+SharedDecodePool sharedDecodePool {};
+
+// Reopened read files always present the same header and index, so the parsed
+// forms are kept for the life of the process: loaded indices are shared while
+// any handle wants them, and the header-derived maps are copied into facades
+// reopening a known path, leaving the fd as the only per-reopen cost
+std::mutex metadataCacheMutex {};
+
+struct HeaderMetadata
+{
+    std::unordered_map<GenomicRegion::ContigName, std::int32_t> hts_targets;
+    std::unordered_map<std::int32_t, GenomicRegion::ContigName> contig_names;
+    std::unordered_map<HtslibSamFacade::ReadGroupIdType, HtslibSamFacade::SampleName> sample_names;
+    std::vector<HtslibSamFacade::SampleName> samples;
+};
+
+std::unordered_map<std::string, HeaderMetadata> headerMetadataCache {};
+std::unordered_map<std::string, std::weak_ptr<hts_idx_t>> htsIndexCache {};
+
+std::shared_ptr<hts_idx_t> load_hts_index(htsFile* file, const boost::filesystem::path& path)
+{
+    std::lock_guard<std::mutex> lock {metadataCacheMutex};
+    auto& cached = htsIndexCache[path.string()];
+    auto result = cached.lock();
+    if (!result) {
+        auto raw_index = sam_index_load(file, path.c_str());
+        if (raw_index) {
+            result = std::shared_ptr<hts_idx_t> {raw_index, hts_idx_destroy};
+            cached = result;
+        }
+    }
+    return result;
+}
+
 } // namespace
 
+void HtslibSamFacade::set_cram_reference(Path reference_path)
+{
+    std::lock_guard<std::mutex> lock {cramRefsMutex};
+    cramReferencePath = std::move(reference_path);
+}
+
+void HtslibSamFacade::set_decode_thread_pool(const unsigned num_threads)
+{
+    std::lock_guard<std::mutex> lock {decodePoolMutex};
+    if (!sharedDecodePool.pool.pool && num_threads > 1) {
+        sharedDecodePool.pool.pool = hts_tpool_init(static_cast<int>(num_threads));
+    }
+}
+
+void HtslibSamFacade::attach_decode_thread_pool()
+{
+    if (!hts_file_) return;
+    std::lock_guard<std::mutex> lock {decodePoolMutex};
+    if (sharedDecodePool.pool.pool) {
+        hts_set_opt(hts_file_.get(), HTS_OPT_THREAD_POOL, &sharedDecodePool.pool);
+    }
+}
+
+void HtslibSamFacade::share_cram_reference()
+{
+    if (!hts_file_ || !hts_file_->is_cram) return;
+    std::lock_guard<std::mutex> lock {cramRefsMutex};
+    if (cramReferencePath) {
+        hts_set_fai_filename(hts_file_.get(), cramReferencePath->c_str());
+    }
+    if (sharedCramRefs) {
+        if (hts_set_opt(hts_file_.get(), CRAM_OPT_SHARED_REF, sharedCramRefs) != 0) {
+            return; // this reader falls back to its own reference cache
+        }
+    } else {
+        sharedCramRefs = cram_get_refs(hts_file_.get());
+        if (!sharedCramRefs) return;
+    }
+    holds_shared_cram_ref_ = true;
+    ++numSharedCramRefHolders;
+}
+
+void HtslibSamFacade::release_cram_reference()
+{
+    // A moved-from facade keeps the flag but loses its file handle, so check both
+    if (!holds_shared_cram_ref_ || !hts_file_) return;
+    std::lock_guard<std::mutex> lock {cramRefsMutex};
+    if (--numSharedCramRefHolders == 0) {
+        sharedCramRefs = nullptr; // freed by the last sharing handle
+    }
+    holds_shared_cram_ref_ = false;
+}
+
 HtslibSamFacade::HtslibSamFacade(Path file_path)
 : file_path_ {std::move(file_path)}
 , hts_file_ {open_hts_file(file_path_), HtsFileDeleter {}}
 , hts_header_ {(hts_file_) ? sam_hdr_read(hts_file_.get()) : nullptr, HtsHeaderDeleter {}}
-, hts_index_ {(hts_file_) ? sam_index_load(hts_file_.get(), file_path_.c_str()) : nullptr, HtsIndexDeleter {}}
+, hts_index_ {(hts_file_) ? load_hts_index(hts_file_.get(), file_path_) : nullptr}
 , hts_targets_ {}
 , contig_names_ {}
 , sample_names_ {}
@@ -201,19 +309,43 @@ HtslibSamFacade::HtslibSamFacade(Path file_path)
             throw MissingBAMIndex {file_path_};
         }
     }
-    try {
-        init_maps();
-    } catch(...) {
-        close();
-        throw;
-    }
-    for (const auto& pair : sample_names_) {
-        if (std::find(std::cbegin(samples_), std::cend(samples_), pair.second) == std::cend(samples_)) {
-            samples_.emplace_back(pair.second);
+    share_cram_reference();
+    attach_decode_thread_pool();
+    if (!try_load_cached_metadata()) {
+        try {
+            init_maps();
+        } catch(...) {
+            close();
+            throw;
+        }
+        for (const auto& pair : sample_names_) {
+            if (std::find(std::cbegin(samples_), std::cend(samples_), pair.second) == std::cend(samples_)) {
+                samples_.emplace_back(pair.second);
+            }
         }
+        samples_.shrink_to_fit();
+        std::sort(std::begin(samples_), std::end(samples_));
+        cache_metadata();
     }
-    samples_.shrink_to_fit();
-    std::sort(std::begin(samples_), std::end(samples_));
+}
+
+bool HtslibSamFacade::try_load_cached_metadata()
+{
+    std::lock_guard<std::mutex> lock {metadataCacheMutex};
+    const auto itr = headerMetadataCache.find(file_path_.string());
+    if (itr == std::cend(headerMetadataCache)) return false;
+    hts_targets_  = itr->second.hts_targets;
+    contig_names_ = itr->second.contig_names;
+    sample_names_ = itr->second.sample_names;
+    samples_      = itr->second.samples;
+    return true;
+}
+
+void HtslibSamFacade::cache_metadata() const
+{
+    std::lock_guard<std::mutex> lock {metadataCacheMutex};
+    headerMetadataCache.emplace(file_path_.string(),
+                                HeaderMetadata {hts_targets_, contig_names_, sample_names_, samples_});
 }
 
 auto open_hts_writable_file(const boost::filesystem::path& path)
@@ -230,11 +362,13 @@ HtslibSamFacade::HtslibSamFacade(Path sam_out, Path sam_template)
 : HtslibSamFacade {std::move(sam_template)}
 {
     file_path_ = std::move(sam_out);
+    release_cram_reference();
     hts_file_.reset(open_hts_writable_file(file_path_));
     if (!hts_file_) {
         throw UnwritableBAM {std::move(file_path_)};
     }
     hts_index_ = nullptr;
+    attach_decode_thread_pool();
     if (sam_hdr_write(hts_file_.get(), hts_header_.get()) < 0) {
         throw UnwritableBAM {std::move(file_path_)};
     }
@@ -242,6 +376,7 @@ HtslibSamFacade::HtslibSamFacade(Path sam_out, Path sam_template)
 
 HtslibSamFacade::~HtslibSamFacade()
 {
+    release_cram_reference();
     if (!hts_index_) {
         hts_header_.reset(nullptr);
         hts_file_.reset(nullptr);
@@ -261,15 +396,18 @@ void HtslibSamFacade::open()
     hts_file_.reset(sam_open(file_path_.string().c_str(), "r"));
     if (hts_file_) {
         hts_header_.reset(sam_hdr_read(hts_file_.get()));
-        hts_index_.reset(sam_index_load(hts_file_.get(), file_path_.c_str()));
+        hts_index_ = load_hts_index(hts_file_.get(), file_path_);
+        share_cram_reference();
+        attach_decode_thread_pool();
     }
 }
 
 void HtslibSamFacade::close()
 {
+    release_cram_reference();
     hts_file_.reset(nullptr);
     hts_header_.reset(nullptr);
-    hts_index_.reset(nullptr);
+    hts_index_.reset();
 }
 
 GenomicRegion::Size HtslibSamFacade::reference_size(const GenomicRegion::ContigName& contig) const
@@ -375,7 +513,7 @@ bool HtslibSamFacade::has_reads(const SampleName& sample, const GenomicRegion& r
 {
     if (samples_.size() == 1 && samples_.front() == sample) return has_reads(region);
     HtslibIterator it {*this, region};
-    while (++it) if (sample_names_.at(it.read_group()) == sample) return true;
+    while (++it) if (it.sample() == sample) return true;
     return false;
 }
 
@@ -388,7 +526,7 @@ bool HtslibSamFacade::has_reads(const std::vector<SampleName>& samples, const Ge
     HtslibIterator it {*this, region};
     while (++it) {
         if (std::binary_search(std::cbegin(readable_samples), std::cend(readable_samples),
-                               sample_names_.at(it.read_group()))) {
+                               it.sample())) {
             return true;
         }
     }
@@ -410,7 +548,7 @@ std::size_t HtslibSamFacade::count_reads(const SampleName& sample, const Genomic
     if (samples_.size() == 1 && samples_.front() == sample) return count_reads(region);
     HtslibIterator it {*this, region};
     std::size_t result {0};
-    while (++it && sample_names_.at(it.read_group()) == sample) ++result;
+    while (++it && it.sample() == sample) ++result;
     return result;
 }
 
@@ -423,7 +561,7 @@ std::size_t HtslibSamFacade::count_reads(const std::vector<SampleName>& samples,
     HtslibIterator it {*this, region};
     std::size_t result {0};
     while (++it && std::binary_search(std::cbegin(readable_samples), std::cend(readable_samples),
-                                      sample_names_.at(it.read_group()))) {
+                                      it.sample())) {
         ++result;
     }
     return result;
@@ -459,7 +597,7 @@ HtslibSamFacade::extract_read_positions(const SampleName& sample, const GenomicR
     result.reserve(max_coverage);
     HtslibIterator it {*this, region};
     while (max_coverage > 0 && ++it) {
-        if (sample == sample_names_.at(it.read_group())) {
+        if (sample == it.sample()) {
             result.push_back(it.begin());
             --max_coverage;
         }
@@ -478,7 +616,7 @@ HtslibSamFacade::extract_read_positions(const std::vector<SampleName>& samples,
     result.reserve(max_coverage);
     HtslibIterator it {*this, region};
     while (max_coverage > 0 && ++it) {
-        if (contains(samples, sample_names_.at(it.read_group()))) {
+        if (contains(samples, it.sample())) {
             result.push_back(it.begin());
             --max_coverage;
         }
@@ -519,7 +657,7 @@ HtslibSamFacade::SampleReadMap HtslibSamFacade::fetch_reads(const GenomicRegion&
     }
     while (++it) {
         try {
-            result.at(sample_names_.at(it.read_group())).emplace_back(*it);
+            result.at(it.sample()).emplace_back(*it);
         } catch (InvalidBamRecord& e) {
             // TODO: Just ignore? Could log or something.
             //std::clog << "Warning: " << e.what() << std::endl;
@@ -538,7 +676,7 @@ HtslibSamFacade::ReadContainer HtslibSamFacade::fetch_reads(const SampleName& sa
     ReadContainer result {};
     try_reserve(result, defaultReserve_, defaultReserve_ / 10);
     while (++it) {
-        if (sample_names_.at(it.read_group()) == sample) {
+        if (it.sample() == sample) {
             try {
                 result.emplace_back(*it);
             } catch (InvalidBamRecord& e) {
@@ -570,10 +708,169 @@ HtslibSamFacade::SampleReadMap HtslibSamFacade::fetch_reads(const std::vector<Sa
     }
     if (result.empty()) return result; // no matching samples
     while (++it) {
-        const auto& sample = sample_names_.at(it.read_group());
+        const auto& sample = it.sample();
         if (result.count(sample) == 1) {
             try {
-                result.at(sample_names_.at(it.read_group())).emplace_back(*it);
+                result.at(it.sample()).emplace_back(*it);
+            } catch (InvalidBamRecord& e) {
+                // TODO
+            } catch (...) {
+                throw;
+            }
+        }
+    }
+    return result;
+}
+
+namespace {
+
+// Regions separated by less than this are cheaper to serve by reading through
+// the gap on one iterator than by seeking a new one
+constexpr GenomicRegion::Position maxFetchJoinGap {10'000};
+
+using RegionBatch = std::pair<std::size_t, std::size_t>;
+
+auto batch_sorted_regions(const std::vector<GenomicRegion>& regions)
+{
+    std::vector<RegionBatch> result {};
+    if (regions.empty()) return result;
+    std::size_t batch_begin {0};
+    for (std::size_t i {1}; i < regions.size(); ++i) {
+        const auto& prev = regions[i - 1];
+        const auto& curr = regions[i];
+        assert(!is_same_contig(prev, curr) || prev.begin() <= curr.begin());
+        if (!is_same_contig(prev, curr) || curr.begin() > prev.end() + maxFetchJoinGap) {
+            result.emplace_back(batch_begin, i);
+            batch_begin = i;
+        }
+    }
+    result.emplace_back(batch_begin, regions.size());
+    return result;
+}
+
+auto encompassing_batch_region(const std::vector<GenomicRegion>& regions, const RegionBatch& batch)
+{
+    auto max_end = regions[batch.first].end();
+    for (auto i = batch.first + 1; i < batch.second; ++i) {
+        max_end = std::max(max_end, regions[i].end());
+    }
+    return GenomicRegion {regions[batch.first].contig_name(), regions[batch.first].begin(), max_end};
+}
+
+} // namespace
+
+std::vector<HtslibSamFacade::SampleReadMap>
+HtslibSamFacade::fetch_reads(const std::vector<GenomicRegion>& regions) const
+{
+    std::vector<SampleReadMap> result(regions.size());
+    for (auto& reads : result) {
+        reads.reserve(samples_.size());
+        for (const auto& sample : samples_) {
+            reads.emplace(std::piecewise_construct, std::forward_as_tuple(sample), std::forward_as_tuple());
+        }
+    }
+    for (const auto& batch : batch_sorted_regions(regions)) {
+        HtslibIterator it {*this, encompassing_batch_region(regions, batch)};
+        auto front = batch.first;
+        while (++it) {
+            try {
+                const auto& sample = it.sample();
+                const AlignedRead read {*it};
+                const auto read_begin = mapped_begin(read);
+                const auto read_end = mapped_end(read);
+                // Reads arrive coordinate sorted so regions ending before this
+                // read cannot overlap anything that follows
+                while (front < batch.second && regions[front].end() <= read_begin) ++front;
+                for (auto r = front; r < batch.second && regions[r].begin() < read_end; ++r) {
+                    if (read_begin < regions[r].end()) {
+                        result[r].at(sample).push_back(read);
+                    }
+                }
+            } catch (InvalidBamRecord& e) {
+                // TODO: Just ignore? Could log or something.
+            } catch (...) {
+                throw;
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<HtslibSamFacade::ReadContainer>
+HtslibSamFacade::fetch_reads(const SampleName& sample, const std::vector<GenomicRegion>& regions) const
+{
+    std::vector<ReadContainer> result(regions.size());
+    if (!contains(samples_, sample)) return result;
+    const bool fetch_all {samples_.size() == 1};
+    for (const auto& batch : batch_sorted_regions(regions)) {
+        HtslibIterator it {*this, encompassing_batch_region(regions, batch)};
+        auto front = batch.first;
+        while (++it) {
+            try {
+                if (!fetch_all && it.sample() != sample) continue;
+                const AlignedRead read {*it};
+                const auto read_begin = mapped_begin(read);
+                const auto read_end = mapped_end(read);
+                while (front < batch.second && regions[front].end() <= read_begin) ++front;
+                for (auto r = front; r < batch.second && regions[r].begin() < read_end; ++r) {
+                    if (read_begin < regions[r].end()) {
+                        result[r].push_back(read);
+                    }
+                }
+            } catch (InvalidBamRecord& e) {
+                // TODO
+            } catch (...) {
+                throw;
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<HtslibSamFacade::SampleReadMap>
+HtslibSamFacade::fetch_reads(const std::vector<SampleName>& samples, const std::vector<GenomicRegion>& regions) const
+{
+    if (samples.size() == 1) {
+        auto reads = fetch_reads(samples.front(), regions);
+        std::vector<SampleReadMap> result {};
+        result.reserve(regions.size());
+        for (auto& region_reads : reads) {
+            SampleReadMap region_result {1};
+            region_result.emplace(samples.front(), std::move(region_reads));
+            result.push_back(std::move(region_result));
+        }
+        return result;
+    }
+    if (is_subset(samples_, samples)) return fetch_reads(regions);
+    std::vector<SampleName> shared_samples {};
+    shared_samples.reserve(samples.size());
+    for (const auto& sample : samples) {
+        if (contains(samples_, sample)) shared_samples.push_back(sample);
+    }
+    std::vector<SampleReadMap> result(regions.size());
+    if (shared_samples.empty()) return result; // no matching samples
+    for (auto& reads : result) {
+        reads.reserve(shared_samples.size());
+        for (const auto& sample : shared_samples) {
+            reads.emplace(std::piecewise_construct, std::forward_as_tuple(sample), std::forward_as_tuple());
+        }
+    }
+    for (const auto& batch : batch_sorted_regions(regions)) {
+        HtslibIterator it {*this, encompassing_batch_region(regions, batch)};
+        auto front = batch.first;
+        while (++it) {
+            try {
+                const auto& sample = it.sample();
+                if (!contains(shared_samples, sample)) continue;
+                const AlignedRead read {*it};
+                const auto read_begin = mapped_begin(read);
+                const auto read_end = mapped_end(read);
+                while (front < batch.second && regions[front].end() <= read_begin) ++front;
+                for (auto r = front; r < batch.second && regions[r].begin() < read_end; ++r) {
+                    if (read_begin < regions[r].end()) {
+                        result[r].at(sample).push_back(read);
+                    }
+                }
             } catch (InvalidBamRecord& e) {
                 // TODO
             } catch (...) {
@@ -610,18 +907,36 @@ boost::optional<std::vector<GenomicRegion::ContigName>> HtslibSamFacade::mapped_
 }
 
 void HtslibSamFacade::write(const AlignedRead& read)
+{
+    const auto record = make_record(read);
+    if (sam_write1(hts_file_.get(), hts_header_.get(), record.get()) < 0) {
+        throw UnwritableBAM {file_path_};
+    }
+}
+
+HtslibSamFacade::BamRecord HtslibSamFacade::make_record(const AlignedRead& read) const
 {
     if (!hts_file_ || !hts_header_) {
         throw UnwritableBAM {file_path_};
     }
-    std::unique_ptr<bam1_t, HtsBam1Deleter> record {bam_init1(), HtsBam1Deleter {}};
-    if (!record) {
+    BamRecord result {bam_init1(), HtsBam1Deleter {}};
+    if (!result) {
         throw UnwritableBAM {file_path_};
     }
-    write(read, record.get());
-    if (sam_write1(hts_file_.get(), hts_header_.get(), record.get()) < 0) {
+    write(read, result.get());
+    return result;
+}
+
+void HtslibSamFacade::write(const std::vector<BamRecord>& records)
+{
+    if (!hts_file_ || !hts_header_) {
         throw UnwritableBAM {file_path_};
     }
+    for (const auto& record : records) {
+        if (sam_write1(hts_file_.get(), hts_header_.get(), record.get()) < 0) {
+            throw UnwritableBAM {file_path_};
+        }
+    }
 }
 
 // private methods
@@ -914,13 +1229,27 @@ AlignedRead HtslibSamFacade::HtslibIterator::operator*() const
     }
 }
 
-HtslibSamFacade::ReadGroupIdType HtslibSamFacade::HtslibIterator::read_group() const
+const HtslibSamFacade::ReadGroupIdType& HtslibSamFacade::HtslibIterator::read_group() const
 {
     const auto ptr = bam_aux_get(hts_bam1_.get(), readGroupTag.c_str());
     if (ptr == nullptr) {
         throw InvalidBamRecord {hts_facade_.file_path_, extract_read_name(hts_bam1_.get()), "no read group"};
     }
-    return HtslibSamFacade::ReadGroupIdType {bam_aux2Z(ptr)};
+    const char* raw_read_group {bam_aux2Z(ptr)};
+    if (!cached_sample_ || cached_read_group_ != raw_read_group) {
+        // Resolve the sample before updating the cache so a record with an
+        // unknown read group leaves it coherent
+        const auto& sample = hts_facade_.sample_names_.at(HtslibSamFacade::ReadGroupIdType {raw_read_group});
+        cached_read_group_ = raw_read_group;
+        cached_sample_ = &sample;
+    }
+    return cached_read_group_;
+}
+
+const HtslibSamFacade::SampleName& HtslibSamFacade::HtslibIterator::sample() const
+{
+    read_group();
+    return *cached_sample_;
 }
 
 bool HtslibSamFacade::HtslibIterator::is_good() const noexcept
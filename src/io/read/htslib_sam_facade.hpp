@@ -42,8 +42,19 @@ public:
     
     using ReadGroupIdType = std::string;
     
+    // Points htslib's CRAM reference machinery at the given FASTA; all open
+    // CRAM readers then share one reference cache so each slice is decoded
+    // once per process rather than once per file
+    static void set_cram_reference(Path reference_path);
+
+    // Creates the decode thread pool shared by every open SAM/BAM/CRAM file,
+    // moving BGZF inflation and CRAM decoding off the fetching threads. Must
+    // be called before files are opened; has no effect with fewer than two
+    // threads or once the pool exists
+    static void set_decode_thread_pool(unsigned num_threads);
+
     HtslibSamFacade() = delete;
-    
+
     HtslibSamFacade(Path file_path);
     HtslibSamFacade(Path sam_out, Path sam_template);
     
@@ -87,12 +98,30 @@ public:
                               const GenomicRegion& region) const override;
     SampleReadMap fetch_reads(const std::vector<SampleName>& samples,
                               const GenomicRegion& region) const override;
-    
+
+    // Batched fetches walk a single iterator over each run of nearby regions,
+    // avoiding repeated seeks into the same compressed blocks
+    std::vector<SampleReadMap> fetch_reads(const std::vector<GenomicRegion>& regions) const override;
+    std::vector<ReadContainer> fetch_reads(const SampleName& sample,
+                                           const std::vector<GenomicRegion>& regions) const override;
+    std::vector<SampleReadMap> fetch_reads(const std::vector<SampleName>& samples,
+                                           const std::vector<GenomicRegion>& regions) const override;
+
     GenomicRegion::Size reference_size(const GenomicRegion::ContigName& contig) const override;
     std::vector<GenomicRegion::ContigName> reference_contigs() const override;
     boost::optional<std::vector<GenomicRegion::ContigName>> mapped_contigs() const override;
     
+    struct HtsBam1Deleter
+    {
+        void operator()(bam1_t* b) const { bam_destroy1(b); }
+    };
+    using BamRecord = std::unique_ptr<bam1_t, HtsBam1Deleter>;
+    
     void write(const AlignedRead& read);
+    // Record conversion only reads the facade, so records can be built on any
+    // thread and handed to the writing thread in batches
+    BamRecord make_record(const AlignedRead& read) const;
+    void write(const std::vector<BamRecord>& records);
     
 private:
     using HtsTid = std::int32_t;
@@ -107,15 +136,6 @@ private:
     {
         void operator()(bam_hdr_t* header) const { bam_hdr_destroy(header); }
     };
-    struct HtsIndexDeleter
-    {
-        void operator()(hts_idx_t* index) const { hts_idx_destroy(index); }
-    };
-    struct HtsBam1Deleter
-    {
-        void operator()(bam1_t* b) const { bam_destroy1(b); }
-    };
-    
     class HtslibIterator
     {
     public:
@@ -131,12 +151,15 @@ private:
         
         bool operator++();
         AlignedRead operator*() const;
-        
-        HtslibSamFacade::ReadGroupIdType read_group() const;
-        
+
+        // Records from the same read group arrive in long runs, so the current
+        // group and its sample are cached rather than re-extracted per record
+        const HtslibSamFacade::ReadGroupIdType& read_group() const;
+        const HtslibSamFacade::SampleName& sample() const;
+
         bool is_good() const noexcept;
         std::size_t begin() const noexcept;
-    
+
     private:
         struct HtsIteratorDeleter
         {
@@ -151,20 +174,30 @@ private:
         
         std::unique_ptr<hts_itr_t, HtsIteratorDeleter> hts_iterator_;
         std::unique_ptr<bam1_t, HtsBam1Deleter> hts_bam1_;
+
+        mutable HtslibSamFacade::ReadGroupIdType cached_read_group_;
+        mutable const HtslibSamFacade::SampleName* cached_sample_ = nullptr;
     };
     
     Path file_path_;
     
     std::unique_ptr<htsFile, HtsFileDeleter> hts_file_;
     std::unique_ptr<bam_hdr_t, HtsHeaderDeleter> hts_header_;
-    std::unique_ptr<hts_idx_t, HtsIndexDeleter> hts_index_;
+    std::shared_ptr<hts_idx_t> hts_index_;
     
     std::unordered_map<GenomicRegion::ContigName, HtsTid> hts_targets_;
     std::unordered_map<HtsTid, GenomicRegion::ContigName> contig_names_;
     std::unordered_map<ReadGroupIdType, SampleName> sample_names_;
     
     std::vector<SampleName> samples_;
-    
+
+    bool holds_shared_cram_ref_ = false;
+
+    void share_cram_reference();
+    void release_cram_reference();
+    void attach_decode_thread_pool();
+    bool try_load_cached_metadata();
+    void cache_metadata() const;
     void init_maps();
     HtsTid get_htslib_target(const GenomicRegion::ContigName& contig) const;
     const GenomicRegion::ContigName& get_contig_name(HtsTid target) const;
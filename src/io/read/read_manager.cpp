@@ -8,6 +8,8 @@
 #include <utility>
 #include <deque>
 #include <numeric>
+#include <future>
+#include <thread>
 #include <cassert>
 
 #include <boost/filesystem/operations.hpp>
@@ -212,6 +214,15 @@ bool ReadManager::has_reads(const GenomicRegion& region) const
     }
 }
 
+bool ReadManager::could_contain_reads(const std::vector<SampleName>& samples, const GenomicRegion& region) const
+{
+    const auto reader_paths = get_reader_paths_containing_samples(samples);
+    return std::any_of(std::cbegin(reader_paths), std::cend(reader_paths),
+                       [this, &region] (const auto& reader_path) {
+                           return could_reader_contain_region(reader_path, region);
+                       });
+}
+
 std::size_t ReadManager::count_reads(const SampleName& sample, const GenomicRegion& region) const
 {
     if (all_readers_are_open()) {
@@ -355,24 +366,63 @@ void merge_insert(Container&& src, Container& dst)
     std::inplace_merge(std::begin(dst), itr, std::end(dst));
 }
 
+// Each reader has its own file handle and internal lock, so distinct readers
+// can be fetched concurrently; results come back in reader order so merging
+// stays deterministic
+template <typename Fetch>
+auto parallel_fetch(const std::vector<const ReadReader*>& readers, const Fetch& fetch)
+{
+    using FetchResult = decltype(fetch(*readers.front()));
+    std::vector<FetchResult> result(readers.size());
+    const auto num_workers = std::min(static_cast<std::size_t>(std::thread::hardware_concurrency()), readers.size());
+    if (num_workers > 1) {
+        std::vector<std::future<void>> fetches {};
+        fetches.reserve(num_workers);
+        for (std::size_t w {0}; w < num_workers; ++w) {
+            fetches.push_back(std::async(std::launch::async, [&, w] () {
+                for (auto r = w; r < readers.size(); r += num_workers) {
+                    result[r] = fetch(*readers[r]);
+                }
+            }));
+        }
+        for (auto& f : fetches) f.get();
+    } else {
+        for (std::size_t r {0}; r < readers.size(); ++r) {
+            result[r] = fetch(*readers[r]);
+        }
+    }
+    return result;
+}
+
 } // namespace
 
 ReadManager::ReadContainer ReadManager::fetch_reads(const SampleName& sample, const GenomicRegion& region) const
 {
     ReadContainer result {};
+    const auto fetch = [&sample, &region] (const ReadReader& reader) { return reader.fetch_reads(sample, region); };
     if (all_readers_are_open()) {
+        std::vector<const ReadReader*> readers {};
+        readers.reserve(open_readers_.size());
         for (const auto& p : open_readers_) {
-            merge_insert(p.second.fetch_reads(sample, region), result);
+            readers.push_back(&p.second);
+        }
+        for (auto& reads : parallel_fetch(readers, fetch)) {
+            merge_insert(std::move(reads), result);
         }
     } else {
         std::lock_guard<std::mutex> lock {mutex_};
         auto reader_paths = get_possible_reader_paths({sample}, region);
         auto reader_itr = partition_open(reader_paths);
         while (!reader_paths.empty()) {
-            using std::begin; using std::end; using std::make_move_iterator; using std::for_each;
+            using std::begin; using std::end; using std::for_each;
+            std::vector<const ReadReader*> readers {};
+            readers.reserve(std::distance(reader_itr, end(reader_paths)));
             for_each(reader_itr, end(reader_paths), [&] (const auto& reader_path) {
-                merge_insert(open_readers_.at(reader_path).fetch_reads(sample, region), result);
+                readers.push_back(&open_readers_.at(reader_path));
             });
+            for (auto& reads : parallel_fetch(readers, fetch)) {
+                merge_insert(std::move(reads), result);
+            }
             reader_paths.erase(reader_itr, end(reader_paths));
             reader_itr = open_readers(begin(reader_paths), end(reader_paths));
         }
@@ -387,29 +437,35 @@ ReadManager::SampleReadMap ReadManager::fetch_reads(const std::vector<SampleName
     for (const auto& sample : samples) {
         result.emplace(std::piecewise_construct, std::forward_as_tuple(sample), std::forward_as_tuple());
     }
-    if (all_readers_are_open()) {
-        for (const auto& p : open_readers_) {
-            auto reads = p.second.fetch_reads(samples, region);
+    const auto fetch = [&samples, &region] (const ReadReader& reader) { return reader.fetch_reads(samples, region); };
+    const auto merge = [&result] (std::vector<SampleReadMap>&& reader_reads) {
+        for (auto& reads : reader_reads) {
             for (auto&& r : reads) {
                 merge_insert(std::move(r.second), result.at(r.first));
                 r.second.clear();
                 r.second.shrink_to_fit();
             }
         }
+    };
+    if (all_readers_are_open()) {
+        std::vector<const ReadReader*> readers {};
+        readers.reserve(open_readers_.size());
+        for (const auto& p : open_readers_) {
+            readers.push_back(&p.second);
+        }
+        merge(parallel_fetch(readers, fetch));
     } else {
         std::lock_guard<std::mutex> lock {mutex_};
         auto reader_paths = get_possible_reader_paths(samples, region);
         auto reader_itr = partition_open(reader_paths);
         while (!reader_paths.empty()) {
-            using std::begin; using std::end; using std::make_move_iterator; using std::for_each;
+            using std::begin; using std::end; using std::for_each;
+            std::vector<const ReadReader*> readers {};
+            readers.reserve(std::distance(reader_itr, end(reader_paths)));
             for_each(reader_itr, end(reader_paths), [&] (const auto& reader_path) {
-                auto reads = open_readers_.at(reader_path).fetch_reads(samples, region);
-                for (auto&& r : reads) {
-                    merge_insert(std::move(r.second), result.at(r.first));
-                    r.second.clear();
-                    r.second.shrink_to_fit();
-                }
+                readers.push_back(&open_readers_.at(reader_path));
             });
+            merge(parallel_fetch(readers, fetch));
             reader_paths.erase(reader_itr, end(reader_paths));
             reader_itr = open_readers(begin(reader_paths), end(reader_paths));
         }
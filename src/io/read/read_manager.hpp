@@ -62,6 +62,11 @@ public:
     bool has_reads(const std::vector<SampleName>& samples, const GenomicRegion& region) const;
     bool has_reads(const GenomicRegion& region) const;
     
+    // Answers from the index metadata gathered at construction, so never touches
+    // a file; may report true for a region with no reads, but never false for
+    // one with reads
+    bool could_contain_reads(const std::vector<SampleName>& samples, const GenomicRegion& region) const;
+    
     std::size_t count_reads(const SampleName& sample, const GenomicRegion& region) const;
     std::size_t count_reads(const std::vector<SampleName>& samples, const GenomicRegion& region) const;
     std::size_t count_reads(const GenomicRegion& region) const;
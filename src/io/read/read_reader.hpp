@@ -91,7 +91,15 @@ public:
                               const GenomicRegion& region) const;
     SampleReadMap fetch_reads(const std::vector<SampleName>& samples,
                               const GenomicRegion& region) const;
-    
+
+    // Batched fetches; regions must be grouped by contig and position sorted
+    // within each contig
+    std::vector<SampleReadMap> fetch_reads(const std::vector<GenomicRegion>& regions) const;
+    std::vector<ReadContainer> fetch_reads(const SampleName& sample,
+                                           const std::vector<GenomicRegion>& regions) const;
+    std::vector<SampleReadMap> fetch_reads(const std::vector<SampleName>& samples,
+                                           const std::vector<GenomicRegion>& regions) const;
+
 private:
     Path file_path_;
     std::unique_ptr<IReadReaderImpl> impl_;
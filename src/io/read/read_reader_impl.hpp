@@ -60,6 +60,33 @@ public:
                                       const GenomicRegion& region) const = 0;
     virtual SampleReadMap fetch_reads(const std::vector<SampleName>& samples,
                                       const GenomicRegion& region) const = 0;
+
+    // Batched overloads; regions must be grouped by contig and position sorted
+    // within each contig. Implementations may walk one iterator over nearby
+    // regions rather than seeking per region
+    virtual std::vector<SampleReadMap> fetch_reads(const std::vector<GenomicRegion>& regions) const
+    {
+        std::vector<SampleReadMap> result {};
+        result.reserve(regions.size());
+        for (const auto& region : regions) result.push_back(fetch_reads(region));
+        return result;
+    }
+    virtual std::vector<ReadContainer> fetch_reads(const SampleName& sample,
+                                                   const std::vector<GenomicRegion>& regions) const
+    {
+        std::vector<ReadContainer> result {};
+        result.reserve(regions.size());
+        for (const auto& region : regions) result.push_back(fetch_reads(sample, region));
+        return result;
+    }
+    virtual std::vector<SampleReadMap> fetch_reads(const std::vector<SampleName>& samples,
+                                                   const std::vector<GenomicRegion>& regions) const
+    {
+        std::vector<SampleReadMap> result {};
+        result.reserve(regions.size());
+        for (const auto& region : regions) result.push_back(fetch_reads(samples, region));
+        return result;
+    }
     
     virtual std::vector<GenomicRegion::ContigName> reference_contigs() const = 0;
     virtual GenomicRegion::Size reference_size(const GenomicRegion::ContigName& contig) const = 0;
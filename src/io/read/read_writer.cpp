@@ -40,6 +40,17 @@ void ReadWriter::write(const AlignedRead& read)
     impl_->write(read);
 }
 
+ReadWriter::BamRecord ReadWriter::make_record(const AlignedRead& read) const
+{
+    return impl_->make_record(read);
+}
+
+void ReadWriter::write(const std::vector<BamRecord>& records)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    impl_->write(records);
+}
+
 ReadWriter& operator<<(ReadWriter& dst, const AlignedRead& read)
 {
     dst.write(read);
@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <boost/filesystem/path.hpp>
 
@@ -36,9 +37,15 @@ public:
     
     friend void swap(ReadWriter& lhs, ReadWriter& rhs) noexcept;
     
+    using BamRecord = HtslibSamFacade::BamRecord;
+    
     const Path& path() const noexcept;
     
     void write(const AlignedRead& read);
+    // Converting on the caller's thread and writing whole batches takes the
+    // writer mutex once per batch rather than once per record
+    BamRecord make_record(const AlignedRead& read) const;
+    void write(const std::vector<BamRecord>& records);
     
 private:
     Path path_;
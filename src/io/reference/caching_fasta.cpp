@@ -161,6 +161,17 @@ CachingFasta::GeneticSequence CachingFasta::do_fetch_sequence(const GenomicRegio
     return result;
 }
 
+void CachingFasta::do_hint_next_fetch_region(const GenomicRegion& region) const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    if (size(region) <= max_cache_size_) {
+        pinned_region_ = region;
+    } else {
+        // Oversized windows bypass the cache entirely, so there is nothing to pin
+        pinned_region_ = boost::none;
+    }
+}
+
 // non-virtual private methods
 
 void CachingFasta::setup_cache()
@@ -366,6 +377,17 @@ void CachingFasta::recache_overlapped_regions(const GeneticSequence& sequence, c
 
 void CachingFasta::reduce_cache(const std::size_t target_size) const
 {
+    // First spare chunks under the pinned frontier window; recency has no say
+    // over sequence the walker is about to request again
+    auto itr = std::end(recently_used_regions_);
+    while (current_cache_size_ > target_size && itr != std::begin(recently_used_regions_)) {
+        --itr;
+        if (pinned_region_ && overlaps(*itr, *pinned_region_)) continue;
+        remove_from_sequence_cache(*itr);
+        current_cache_size_ -= size(*itr);
+        itr = recently_used_regions_.erase(itr);
+    }
+    // The cache budget is hard, so pinned chunks go too if they are all that remain
     while (current_cache_size_ > target_size) {
         assert(!recently_used_regions_.empty());
         remove_from_sequence_cache(recently_used_regions_.back());
@@ -40,6 +40,10 @@ namespace io {
  
        - forward bias: the probability the next request region will be to the right hand side of
                        the current request region.
+ 
+ The calling frontier can additionally hint its next fetch window; cached
+ chunks under the hinted window are pinned so recency-based eviction does not
+ throw away sequence the walker is about to request again after a long jump.
  */
 
 class CachingFasta : public ReferenceReader
@@ -77,6 +81,7 @@ private:
     GenomicSize max_cache_size_;
     mutable GenomicSize current_cache_size_;
     double locality_bias_, forward_bias_;
+    mutable boost::optional<GenomicRegion> pinned_region_;
     mutable std::mutex mutex_;
     
     std::unique_ptr<ReferenceReader> do_clone() const override;
@@ -85,6 +90,7 @@ private:
     std::vector<ContigName> do_fetch_contig_names() const override;
     GenomicSize do_fetch_contig_size(const ContigName& contig) const override;
     GeneticSequence do_fetch_sequence(const GenomicRegion& region) const override;
+    void do_hint_next_fetch_region(const GenomicRegion& region) const override;
     
     void setup_cache();
     GenomicSize get_remaining_cache_size() const;
@@ -0,0 +1,66 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "local_reference_cache.hpp"
+
+#include <utility>
+
+namespace octopus {
+namespace io {
+
+namespace {
+
+// Task windows are normally well under this; a window over the limit (e.g. a
+// whole contig in a single threaded run, where there is no contention to
+// avoid anyway) is served by fall through rather than buffered wholesale
+constexpr GenomicRegion::Size maxSnapshotBases {10'000'000};
+
+} // namespace
+
+LocalReferenceCache::LocalReferenceCache(const ReferenceGenome& reference, const GenomicRegion& window)
+: reference_ {reference}
+, window_ {}
+{
+    if (reference.has_contig(window.contig_name()) && size(window) <= maxSnapshotBases) {
+        const auto clamped_window = overlapped_region(window, reference.contig_region(window.contig_name()));
+        if (clamped_window) {
+            window_ = reference.fetch_slice(*clamped_window);
+        }
+    }
+}
+
+std::unique_ptr<ReferenceReader> LocalReferenceCache::do_clone() const
+{
+    return std::make_unique<LocalReferenceCache>(*this);
+}
+
+bool LocalReferenceCache::do_is_open() const noexcept
+{
+    return true;
+}
+
+std::string LocalReferenceCache::do_fetch_reference_name() const
+{
+    return reference_.get().name();
+}
+
+std::vector<LocalReferenceCache::ContigName> LocalReferenceCache::do_fetch_contig_names() const
+{
+    return reference_.get().contig_names();
+}
+
+LocalReferenceCache::GenomicSize LocalReferenceCache::do_fetch_contig_size(const ContigName& contig) const
+{
+    return reference_.get().contig_size(contig);
+}
+
+LocalReferenceCache::GeneticSequence LocalReferenceCache::do_fetch_sequence(const GenomicRegion& region) const
+{
+    if (window_.contains(region)) {
+        return window_.copy(region);
+    }
+    return reference_.get().fetch_sequence(region);
+}
+
+} // namespace io
+} // namespace octopus
@@ -0,0 +1,68 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef local_reference_cache_hpp
+#define local_reference_cache_hpp
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+
+#include <boost/optional.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "reference_reader.hpp"
+#include "reference_genome.hpp"
+#include "reference_slice.hpp"
+
+namespace octopus {
+namespace io {
+
+/*
+ LocalReferenceCache snapshots one window of a shared ReferenceGenome so a
+ task can serve its reference lookups from local memory. The window is read
+ once on construction - a single fetch through the shared reader - and
+ requests inside it are answered by substring copy; requests outside the
+ window fall through to the shared reference. The snapshot is immutable
+ after construction, so fetches need no synchronisation however many
+ threads the owning task fans out to.
+
+ Windows larger than the snapshot limit are not buffered and every fetch
+ falls through, so callers can pass their working region unconditionally.
+ */
+class LocalReferenceCache : public ReferenceReader
+{
+public:
+    using ContigName      = ReferenceReader::ContigName;
+    using GenomicSize     = ReferenceReader::GenomicSize;
+    using GeneticSequence = ReferenceReader::GeneticSequence;
+
+    LocalReferenceCache() = delete;
+
+    // The shared reference must outlive the cache and anything cloned from it
+    LocalReferenceCache(const ReferenceGenome& reference, const GenomicRegion& window);
+
+    LocalReferenceCache(const LocalReferenceCache&)            = default;
+    LocalReferenceCache& operator=(const LocalReferenceCache&) = default;
+    LocalReferenceCache(LocalReferenceCache&&)                 = default;
+    LocalReferenceCache& operator=(LocalReferenceCache&&)      = default;
+
+private:
+    std::reference_wrapper<const ReferenceGenome> reference_;
+    // Shared immutable buffer, so clones of the cache do not duplicate the
+    // window bytes
+    ReferenceSlice window_;
+
+    std::unique_ptr<ReferenceReader> do_clone() const override;
+    bool do_is_open() const noexcept override;
+    std::string do_fetch_reference_name() const override;
+    std::vector<ContigName> do_fetch_contig_names() const override;
+    GenomicSize do_fetch_contig_size(const ContigName& contig) const override;
+    GeneticSequence do_fetch_sequence(const GenomicRegion& region) const override;
+};
+
+} // namespace io
+} // namespace octopus
+
+#endif
@@ -0,0 +1,262 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "mmapped_fasta.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "utils/sequence_utils.hpp"
+#include "exceptions/missing_file_error.hpp"
+#include "exceptions/missing_index_error.hpp"
+#include "exceptions/malformed_file_error.hpp"
+#include "exceptions/program_error.hpp"
+
+namespace octopus { namespace io {
+
+class MissingMmappedFasta : public MissingFileError
+{
+    std::string do_where() const override
+    {
+        return "MmappedFasta";
+    }
+public:
+    MissingMmappedFasta(MmappedFasta::Path file) : MissingFileError {std::move(file), "fasta"} {}
+};
+
+class MalformedMmappedFasta : public MalformedFileError
+{
+    std::string do_where() const override
+    {
+        return "MmappedFasta";
+    }
+public:
+    MalformedMmappedFasta(MmappedFasta::Path file) : MalformedFileError {std::move(file), "fasta"} {}
+};
+
+class MissingMmappedFastaIndex : public MissingIndexError
+{
+    std::string do_where() const override
+    {
+        return "MmappedFasta";
+    }
+
+    std::string do_help() const override
+    {
+        return "ensure that a valid fasta index (.fai) exists in the same directory as the given "
+        "fasta file. You can make one with the 'samtools faidx' command";
+    }
+public:
+    MissingMmappedFastaIndex(MmappedFasta::Path file) : MissingIndexError {std::move(file), "fasta"} {}
+};
+
+class MalformedMmappedFastaIndex : public MalformedFileError
+{
+    std::string do_where() const override
+    {
+        return "MmappedFasta";
+    }
+public:
+    MalformedMmappedFastaIndex(MmappedFasta::Path file) : MalformedFileError {std::move(file), "fasta"} {}
+};
+
+MmappedFasta::Mapping::Mapping(const Path& path)
+{
+    const auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error {"MmappedFasta: could not open " + path.string()};
+    }
+    struct ::stat file_stats;
+    if (::fstat(fd, &file_stats) < 0 || file_stats.st_size <= 0) {
+        ::close(fd);
+        throw std::runtime_error {"MmappedFasta: could not stat " + path.string()};
+    }
+    size = static_cast<std::size_t>(file_stats.st_size);
+    const auto result = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps its own reference to the file
+    if (result == MAP_FAILED) {
+        throw std::runtime_error {"MmappedFasta: could not map " + path.string()};
+    }
+    data = static_cast<const char*>(result);
+}
+
+MmappedFasta::Mapping::Mapping(Mapping&& other) noexcept
+: data {other.data}
+, size {other.size}
+{
+    other.data = nullptr;
+    other.size = 0;
+}
+
+MmappedFasta::Mapping& MmappedFasta::Mapping::operator=(Mapping&& other) noexcept
+{
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+    return *this;
+}
+
+MmappedFasta::Mapping::~Mapping() noexcept
+{
+    if (data) {
+        ::munmap(const_cast<char*>(data), size);
+    }
+}
+
+MmappedFasta::MmappedFasta(Path fasta_path)
+: MmappedFasta {fasta_path, fasta_path.string() + ".fai", Options {}}
+{}
+
+MmappedFasta::MmappedFasta(Path fasta_path, Options options)
+: MmappedFasta {fasta_path, fasta_path.string() + ".fai", options}
+{}
+
+MmappedFasta::MmappedFasta(Path fasta_path, Path fasta_index_path)
+: MmappedFasta {std::move(fasta_path), std::move(fasta_index_path), Options {}}
+{}
+
+MmappedFasta::MmappedFasta(Path fasta_path, Path fasta_index_path, Options options)
+: path_ {std::move(fasta_path)}
+, index_path_ {std::move(fasta_index_path)}
+, options_ {options}
+{
+    using boost::filesystem::exists;
+    if (!exists(path_)) {
+        throw MissingMmappedFasta {path_};
+    }
+    const auto extension = path_.extension().string();
+    if (extension != ".fa" && extension != ".fasta") {
+        throw MalformedMmappedFasta {path_}; // compressed references cannot be mapped
+    }
+    if (!exists(index_path_)) {
+        index_path_ = path_;
+        index_path_.replace_extension("fai");
+        if (!exists(index_path_)) {
+            throw MissingMmappedFastaIndex {path_};
+        }
+    }
+    if (index_path_.extension().string() != ".fai") {
+        throw MalformedMmappedFastaIndex {index_path_};
+    }
+    fasta_index_ = bioio::read_fasta_index(index_path_.string());
+    mapping_ = Mapping {path_};
+}
+
+MmappedFasta::MmappedFasta(const MmappedFasta& other)
+: path_ {other.path_}
+, index_path_ {other.index_path_}
+, fasta_index_ {other.fasta_index_}
+, mapping_ {path_}
+, options_ {other.options_}
+{}
+
+MmappedFasta& MmappedFasta::operator=(MmappedFasta other)
+{
+    using std::swap;
+    swap(path_, other.path_);
+    swap(index_path_, other.index_path_);
+    swap(fasta_index_, other.fasta_index_);
+    swap(mapping_, other.mapping_);
+    swap(options_, other.options_);
+    return *this;
+}
+
+// virtual private methods
+
+std::unique_ptr<ReferenceReader> MmappedFasta::do_clone() const
+{
+    return std::make_unique<MmappedFasta>(*this);
+}
+
+bool MmappedFasta::do_is_open() const noexcept
+{
+    return mapping_.data != nullptr;
+}
+
+std::string MmappedFasta::do_fetch_reference_name() const
+{
+    return path_.stem().string();
+}
+
+std::vector<MmappedFasta::ContigName> MmappedFasta::do_fetch_contig_names() const
+{
+    return bioio::read_fasta_index_contig_names(index_path_.string());
+}
+
+MmappedFasta::GenomicSize MmappedFasta::do_fetch_contig_size(const ContigName& contig) const
+{
+    if (fasta_index_.count(contig) == 0) {
+        throw std::runtime_error {"contig \"" + contig +
+            "\" not found in fasta index \"" + index_path_.string() + "\""};
+    }
+    return static_cast<GenomicSize>(fasta_index_.at(contig).length);
+}
+
+class BadMmappedReferenceRequestRegion : public ProgramError
+{
+    GenomicRegion region;
+
+    std::string do_why() const override
+    {
+        return "Requested bad reference region " + to_string(region);
+    }
+    std::string do_help() const override
+    {
+        return "Send a debug report";
+    }
+    std::string do_where() const override
+    {
+        return "MmappedFasta";
+    }
+public:
+    BadMmappedReferenceRequestRegion(GenomicRegion region) : region {std::move(region)} {}
+};
+
+MmappedFasta::GeneticSequence MmappedFasta::do_fetch_sequence(const GenomicRegion& region) const
+{
+    const auto& contig_index = fasta_index_.at(contig_name(region));
+    const auto begin = static_cast<std::size_t>(mapped_begin(region));
+    GeneticSequence result {};
+    result.reserve(size(region));
+    if (begin < contig_index.length) {
+        auto remaining = std::min(static_cast<std::size_t>(size(region)), contig_index.length - begin);
+        auto column = bioio::detail::line_offset(contig_index, begin);
+        const char* src {mapping_.data + bioio::detail::region_offset(contig_index, begin)};
+        const auto line_terminator_length = contig_index.line_byte_length - contig_index.line_length;
+        while (remaining > 0) {
+            const auto chunk = std::min(contig_index.line_length - column, remaining);
+            result.append(src, chunk);
+            remaining -= chunk;
+            src += chunk + line_terminator_length;
+            column = 0;
+        }
+    }
+    if (is_capitalisation_requested()) {
+        utils::capitalise(result);
+    }
+    if (result.size() < size(region)) {
+        if (options_.base_fill_policy == Options::BaseFillPolicy::throw_exception) {
+            throw BadMmappedReferenceRequestRegion {region};
+        }
+        if (options_.base_fill_policy == Options::BaseFillPolicy::fill_with_ns) {
+            result.resize(size(region), 'N');
+        }
+    }
+    return result;
+}
+
+bool MmappedFasta::is_capitalisation_requested() const noexcept
+{
+    return options_.base_transform_policy == Options::BaseTransformPolicy::capitalise;
+}
+
+} // namespace io
+} // namespace octopus
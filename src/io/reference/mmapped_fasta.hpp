@@ -0,0 +1,94 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef mmapped_fasta_hpp
+#define mmapped_fasta_hpp
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <memory>
+
+#include <boost/filesystem/path.hpp>
+
+#include "bioio.hpp"
+
+#include "fasta.hpp"
+#include "reference_reader.hpp"
+
+namespace octopus {
+
+class GenomicRegion;
+
+namespace io {
+
+/*
+ MmappedFasta maps the uncompressed FASTA into the address space once and
+ serves fetch_sequence straight from the mapped pages, so a fetch costs one
+ output allocation and no read system calls. The mapped pages are shared by
+ the OS between processes reading the same reference. Fetches touch no
+ mutable state so the reader can be shared between threads without the
+ ThreadsafeFasta wrapper.
+ */
+class MmappedFasta : public ReferenceReader
+{
+public:
+    using Path = boost::filesystem::path;
+
+    using ContigName      = ReferenceReader::ContigName;
+    using GenomicSize     = ReferenceReader::GenomicSize;
+    using GeneticSequence = ReferenceReader::GeneticSequence;
+
+    using Options = Fasta::Options;
+
+    MmappedFasta() = delete;
+
+    MmappedFasta(Path fasta_path);
+    MmappedFasta(Path fasta_path, Options options);
+    MmappedFasta(Path fasta_path, Path fasta_index_path);
+    MmappedFasta(Path fasta_path, Path fasta_index_path, Options options);
+
+    MmappedFasta(const MmappedFasta&);
+    MmappedFasta& operator=(MmappedFasta);
+    MmappedFasta(MmappedFasta&&)            = default;
+    MmappedFasta& operator=(MmappedFasta&&) = default;
+
+private:
+    struct Mapping
+    {
+        Mapping() = default;
+        Mapping(const Path& path);
+
+        Mapping(const Mapping&)            = delete;
+        Mapping& operator=(const Mapping&) = delete;
+        Mapping(Mapping&& other) noexcept;
+        Mapping& operator=(Mapping&& other) noexcept;
+
+        ~Mapping() noexcept;
+
+        const char* data = nullptr;
+        std::size_t size = 0;
+    };
+
+    Path path_;
+    Path index_path_;
+
+    bioio::FastaIndex fasta_index_;
+    Mapping mapping_;
+
+    Options options_;
+
+    std::unique_ptr<ReferenceReader> do_clone() const override;
+    bool do_is_open() const noexcept override;
+    std::string do_fetch_reference_name() const override;
+    std::vector<ContigName> do_fetch_contig_names() const override;
+    GenomicSize do_fetch_contig_size(const ContigName& contig) const override;
+    GeneticSequence do_fetch_sequence(const GenomicRegion& region) const override;
+
+    bool is_capitalisation_requested() const noexcept;
+};
+
+} // namespace io
+} // namespace octopus
+
+#endif
@@ -8,7 +8,11 @@
 #include <utility>
 #include <numeric>
 
+#include <boost/filesystem/operations.hpp>
+
+#include "utils/reference_repeat_index.hpp"
 #include "fasta.hpp"
+#include "mmapped_fasta.hpp"
 #include "threadsafe_fasta.hpp"
 #include "caching_fasta.hpp"
 
@@ -40,6 +44,7 @@ ReferenceGenome::ReferenceGenome(const ReferenceGenome& other)
 , name_ {other.name_}
 , contig_sizes_ {other.contig_sizes_}
 , ordered_contigs_ {other.ordered_contigs_}
+, repeat_index_ {other.repeat_index_}
 {}
 
 ReferenceGenome& ReferenceGenome::operator=(ReferenceGenome other)
@@ -49,6 +54,7 @@ ReferenceGenome& ReferenceGenome::operator=(ReferenceGenome other)
     swap(name_,            other.name_);
     swap(contig_sizes_,    other.contig_sizes_);
     swap(ordered_contigs_, other.ordered_contigs_);
+    swap(repeat_index_,    other.repeat_index_);
     return *this;
 }
 
@@ -92,6 +98,26 @@ ReferenceGenome::GeneticSequence ReferenceGenome::fetch_sequence(const GenomicRe
     return impl_->fetch_sequence(region);
 }
 
+ReferenceSlice ReferenceGenome::fetch_slice(const GenomicRegion& region) const
+{
+    return ReferenceSlice {region, fetch_sequence(region)};
+}
+
+void ReferenceGenome::hint_next_fetch_region(const GenomicRegion& region) const
+{
+    impl_->hint_next_fetch_region(region);
+}
+
+void ReferenceGenome::attach_repeat_index(std::shared_ptr<const ReferenceRepeatIndex> index) noexcept
+{
+    repeat_index_ = std::move(index);
+}
+
+const ReferenceRepeatIndex* ReferenceGenome::repeat_index() const noexcept
+{
+    return repeat_index_.get();
+}
+
 // non-member functions
 
 ReferenceGenome make_reference(boost::filesystem::path reference_path,
@@ -100,25 +126,43 @@ ReferenceGenome make_reference(boost::filesystem::path reference_path,
                                bool capitalise_bases)
 {
     using namespace io;
+    std::shared_ptr<const ReferenceRepeatIndex> repeat_index {};
+    try {
+        using boost::filesystem::exists;
+        using boost::filesystem::last_write_time;
+        const auto repeat_index_path = reference_repeat_index_path(reference_path);
+        if (exists(repeat_index_path) && last_write_time(repeat_index_path) >= last_write_time(reference_path)) {
+            repeat_index = std::make_shared<ReferenceRepeatIndex>(repeat_index_path);
+        }
+    } catch (...) {
+        repeat_index.reset(); // fall back to on-the-fly repeat detection
+    }
     std::unique_ptr<ReferenceReader> impl_ {};
     Fasta::Options options {};
     if (capitalise_bases) {
         options.base_transform_policy = Fasta::Options::BaseTransformPolicy::capitalise;
     }
     options.base_fill_policy = Fasta::Options::BaseFillPolicy::fill_with_ns;
-    if (is_threaded) {
-        impl_ = std::make_unique<ThreadsafeFasta>(std::make_unique<Fasta>(reference_path, options));
-    } else {
-        impl_ = std::make_unique<Fasta>(std::move(reference_path), options);
+    try {
+        // MmappedFasta fetches touch no mutable state, so it needs no ThreadsafeFasta wrapper
+        impl_ = std::make_unique<MmappedFasta>(reference_path, options);
+    } catch (...) {
+        // fall back to streamed reading so any problem with the files is reported from here.
+        // Always guarded: even unthreaded runs overlap the next window's candidate
+        // generation with the current fit, so the shared reader sees two threads
+        impl_ = std::make_unique<ThreadsafeFasta>(std::make_unique<Fasta>(std::move(reference_path), options));
     }
     if (max_cache_size.num_bytes() > 0) {
         double locality_bias {0.99}, forward_bias {0.99};
         if (is_threaded) locality_bias = 0.25;
-        return ReferenceGenome {std::make_unique<CachingFasta>(std::move(impl_), max_cache_size.num_bytes(),
-                                                               locality_bias, forward_bias)};
-    } else {
-        return ReferenceGenome {std::move(impl_)};
+        impl_ = std::make_unique<CachingFasta>(std::move(impl_), max_cache_size.num_bytes(),
+                                               locality_bias, forward_bias);
     }
+    ReferenceGenome result {std::move(impl_)};
+    if (repeat_index) {
+        result.attach_repeat_index(std::move(repeat_index));
+    }
+    return result;
 }
 
 std::vector<GenomicRegion> get_all_contig_regions(const ReferenceGenome& reference)
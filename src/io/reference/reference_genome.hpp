@@ -15,9 +15,12 @@
 #include "basics/genomic_region.hpp"
 #include "utils/memory_footprint.hpp"
 #include "reference_reader.hpp"
+#include "reference_slice.hpp"
 
 namespace octopus {
 
+class ReferenceRepeatIndex;
+
 class ReferenceGenome
 {
 public:
@@ -46,12 +49,26 @@ public:
     bool contains(const GenomicRegion& region) const noexcept;
     
     GeneticSequence fetch_sequence(const GenomicRegion& region) const;
+
+    // Like fetch_sequence, but returns the window as a shared immutable slice
+    // so consumers that take overlapping sub-windows can share one buffer
+    ReferenceSlice fetch_slice(const GenomicRegion& region) const;
+
+    // Advises the reader that the calling frontier is about to fetch from the
+    // given region; caching readers pin the window so it survives eviction
+    void hint_next_fetch_region(const GenomicRegion& region) const;
+    
+    // A pre-computed tandem repeat index for this reference, when one is
+    // available; repeat detection falls back to on-the-fly scanning otherwise
+    void attach_repeat_index(std::shared_ptr<const ReferenceRepeatIndex> index) noexcept;
+    const ReferenceRepeatIndex* repeat_index() const noexcept;
     
 private:
     std::unique_ptr<io::ReferenceReader> impl_;
     std::string name_;
     std::unordered_map<ContigName, ContigRegion::Size> contig_sizes_;
     std::vector<ContigName> ordered_contigs_;
+    std::shared_ptr<const ReferenceRepeatIndex> repeat_index_;
 };
 
 // non-member functions
@@ -52,6 +52,14 @@ public:
         return do_fetch_sequence(region);
     }
     
+    // Advises the reader that the calling frontier is about to fetch from the
+    // given region. Purely an optimisation hint - caching readers can pin the
+    // window ahead of recency - and readers without a cache ignore it
+    void hint_next_fetch_region(const GenomicRegion& region) const
+    {
+        do_hint_next_fetch_region(region);
+    }
+    
 private:
     virtual std::unique_ptr<ReferenceReader> do_clone() const = 0;
     virtual bool do_is_open() const noexcept = 0;
@@ -59,6 +67,7 @@ private:
     virtual std::vector<ContigName> do_fetch_contig_names() const = 0;
     virtual GenomicSize do_fetch_contig_size(const ContigName& contig) const = 0;
     virtual GeneticSequence do_fetch_sequence(const GenomicRegion& region) const = 0;
+    virtual void do_hint_next_fetch_region(const GenomicRegion&) const {}
 };
 
 } // namespace io
@@ -0,0 +1,53 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "reference_slice.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace octopus {
+
+ReferenceSlice::ReferenceSlice(GenomicRegion region, GeneticSequence sequence)
+: region_ {std::move(region)}
+, sequence_ {std::make_shared<const GeneticSequence>(std::move(sequence))}
+{
+    assert(sequence_->size() == size(region_));
+}
+
+const GenomicRegion& ReferenceSlice::mapped_region() const noexcept
+{
+    return region_;
+}
+
+bool ReferenceSlice::empty() const noexcept
+{
+    return sequence_ == nullptr;
+}
+
+bool ReferenceSlice::contains(const GenomicRegion& region) const noexcept
+{
+    return sequence_ && is_same_contig(region, region_)
+           && region.begin() >= region_.begin() && region.end() <= region_.end();
+}
+
+const ReferenceSlice::GeneticSequence& ReferenceSlice::sequence() const noexcept
+{
+    assert(sequence_);
+    return *sequence_;
+}
+
+boost::string_ref ReferenceSlice::view(const GenomicRegion& region) const
+{
+    assert(contains(region));
+    const auto offset = static_cast<GeneticSequence::size_type>(begin_distance(region_, region));
+    return {sequence_->data() + offset, size(region)};
+}
+
+ReferenceSlice::GeneticSequence ReferenceSlice::copy(const GenomicRegion& region) const
+{
+    const auto result = view(region);
+    return {result.data(), result.size()};
+}
+
+} // namespace octopus
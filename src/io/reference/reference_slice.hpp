@@ -0,0 +1,58 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef reference_slice_hpp
+#define reference_slice_hpp
+
+#include <memory>
+#include <string>
+
+#include <boost/utility/string_ref.hpp>
+
+#include "concepts/mappable.hpp"
+#include "basics/genomic_region.hpp"
+
+namespace octopus {
+
+// An immutable window of reference sequence with its mapped region. The bases
+// live in one shared buffer, so slices copy and subdivide by reference count
+// rather than by duplicating sequence; lookups inside the window are served
+// as views or substring copies without touching the reference reader again
+class ReferenceSlice : public Mappable<ReferenceSlice>
+{
+public:
+    using GeneticSequence = std::string;
+
+    ReferenceSlice() = default;
+
+    ReferenceSlice(GenomicRegion region, GeneticSequence sequence);
+
+    ReferenceSlice(const ReferenceSlice&)            = default;
+    ReferenceSlice& operator=(const ReferenceSlice&) = default;
+    ReferenceSlice(ReferenceSlice&&)                 = default;
+    ReferenceSlice& operator=(ReferenceSlice&&)      = default;
+
+    ~ReferenceSlice() = default;
+
+    const GenomicRegion& mapped_region() const noexcept;
+
+    bool empty() const noexcept;
+
+    // true iff the slice holds sequence for all of the given region
+    bool contains(const GenomicRegion& region) const noexcept;
+
+    const GeneticSequence& sequence() const noexcept;
+
+    // A view into the shared buffer; valid while any slice over it lives
+    boost::string_ref view(const GenomicRegion& region) const;
+
+    GeneticSequence copy(const GenomicRegion& region) const;
+
+private:
+    GenomicRegion region_;
+    std::shared_ptr<const GeneticSequence> sequence_;
+};
+
+} // namespace octopus
+
+#endif
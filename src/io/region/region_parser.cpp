@@ -8,10 +8,14 @@
 #include <algorithm>
 #include <fstream>
 #include <functional>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
 
 #include <boost/optional.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/type_traits/is_unsigned.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include "exceptions/user_error.hpp"
 #include "utils/string_utils.hpp"
@@ -234,12 +238,170 @@ make_optional_region_line_parser(const boost::filesystem::path& file, const Refe
     }
 }
 
+// Region file caching
+//
+// Large region files (typically exome capture BEDs with hundreds of thousands
+// of records) are parsed on every invocation, which costs seconds when the
+// same file is used across many runs. Parsed regions are therefore snapshotted
+// to a binary sidecar next to the source file and reloaded while the source's
+// write time and size are unchanged. Caching is strictly best effort: any
+// failure to read or write the sidecar (unwritable directory, truncated or
+// stale snapshot, concurrent writers) silently falls back to parsing.
+
+constexpr std::size_t minRegionsToCache {10'000};
+constexpr char regionCacheMagic[] = "OCTRC001";
+
+auto region_cache_path(const boost::filesystem::path& file)
+{
+    return boost::filesystem::path {file.string() + ".region_cache"};
+}
+
+struct RegionCacheKey
+{
+    std::uint64_t source_write_time, source_size;
+    std::string reference_name;
+    std::uint64_t policy;
+};
+
+RegionCacheKey make_region_cache_key(const boost::filesystem::path& file,
+                                     const ReferenceGenome& reference,
+                                     const NonreferenceContigPolicy policy)
+{
+    return {static_cast<std::uint64_t>(boost::filesystem::last_write_time(file)),
+            static_cast<std::uint64_t>(boost::filesystem::file_size(file)),
+            reference.name(),
+            static_cast<std::uint64_t>(policy)};
+}
+
+void write_binary(std::ostream& out, const std::uint64_t n)
+{
+    out.write(reinterpret_cast<const char*>(&n), sizeof n);
+}
+
+void write_binary(std::ostream& out, const std::string& str)
+{
+    write_binary(out, str.size());
+    out.write(str.data(), str.size());
+}
+
+bool read_binary(std::istream& in, std::uint64_t& n)
+{
+    in.read(reinterpret_cast<char*>(&n), sizeof n);
+    return static_cast<bool>(in);
+}
+
+bool read_binary(std::istream& in, std::string& str)
+{
+    constexpr std::uint64_t maxStringLength {1 << 20};
+    std::uint64_t length;
+    if (!read_binary(in, length) || length > maxStringLength) return false;
+    str.resize(length);
+    in.read(&str[0], length);
+    return static_cast<bool>(in);
+}
+
+boost::optional<std::deque<GenomicRegion>>
+try_read_cached_regions(const boost::filesystem::path& file, const RegionCacheKey& key)
+{
+    try {
+        std::ifstream cache {region_cache_path(file).string(), std::ios::binary};
+        if (!cache) return boost::none;
+        char magic[sizeof regionCacheMagic];
+        cache.read(magic, sizeof magic);
+        if (!cache || !std::equal(std::cbegin(magic), std::cend(magic), regionCacheMagic)) {
+            return boost::none;
+        }
+        std::uint64_t write_time, size, policy;
+        std::string reference_name;
+        if (!read_binary(cache, write_time) || !read_binary(cache, size)
+            || !read_binary(cache, reference_name) || !read_binary(cache, policy)) {
+            return boost::none;
+        }
+        if (write_time != key.source_write_time || size != key.source_size
+            || reference_name != key.reference_name || policy != key.policy) {
+            return boost::none;
+        }
+        std::uint64_t num_contigs;
+        if (!read_binary(cache, num_contigs) || num_contigs > (1 << 20)) return boost::none;
+        std::vector<std::string> contigs(num_contigs);
+        for (auto& contig : contigs) {
+            if (!read_binary(cache, contig)) return boost::none;
+        }
+        std::uint64_t num_regions;
+        if (!read_binary(cache, num_regions)) return boost::none;
+        std::deque<GenomicRegion> result {};
+        for (std::uint64_t i {0}; i < num_regions; ++i) {
+            std::uint64_t contig_idx, begin, end;
+            if (!read_binary(cache, contig_idx) || !read_binary(cache, begin) || !read_binary(cache, end)
+                || contig_idx >= num_contigs || begin > end) {
+                return boost::none;
+            }
+            result.emplace_back(contigs[contig_idx],
+                                static_cast<GenomicRegion::Position>(begin),
+                                static_cast<GenomicRegion::Position>(end));
+        }
+        return result;
+    } catch (...) {
+        return boost::none;
+    }
+}
+
+void try_write_region_cache(const boost::filesystem::path& file, const RegionCacheKey& key,
+                            const std::deque<GenomicRegion>& regions) noexcept
+{
+    auto temp_path = region_cache_path(file);
+    try {
+        temp_path += boost::filesystem::unique_path(".%%%%%%%%.tmp");
+        {
+            std::ofstream cache {temp_path.string(), std::ios::binary};
+            if (!cache) return;
+            cache.write(regionCacheMagic, sizeof regionCacheMagic);
+            write_binary(cache, key.source_write_time);
+            write_binary(cache, key.source_size);
+            write_binary(cache, key.reference_name);
+            write_binary(cache, key.policy);
+            std::vector<std::string> contigs {};
+            std::unordered_map<std::string, std::uint64_t> contig_indices {};
+            for (const auto& region : regions) {
+                contig_indices.emplace(region.contig_name(), contigs.size());
+                if (contig_indices.size() > contigs.size()) contigs.push_back(region.contig_name());
+            }
+            write_binary(cache, contigs.size());
+            for (const auto& contig : contigs) write_binary(cache, contig);
+            write_binary(cache, regions.size());
+            for (const auto& region : regions) {
+                write_binary(cache, contig_indices.at(region.contig_name()));
+                write_binary(cache, static_cast<std::uint64_t>(region.begin()));
+                write_binary(cache, static_cast<std::uint64_t>(region.end()));
+            }
+            if (!cache) {
+                cache.close();
+                boost::filesystem::remove(temp_path);
+                return;
+            }
+        }
+        // Rename is atomic, so concurrent invocations never observe a partial snapshot
+        boost::filesystem::rename(temp_path, region_cache_path(file));
+    } catch (...) {
+        boost::system::error_code ignored {};
+        boost::filesystem::remove(temp_path, ignored);
+    }
+}
+
 } // namespace
 
 std::deque<GenomicRegion> extract_regions(const boost::filesystem::path& file,
                                           const ReferenceGenome& reference,
                                           const NonreferenceContigPolicy policy)
 {
+    boost::optional<RegionCacheKey> cache_key {};
+    try {
+        cache_key = make_region_cache_key(file, reference, policy);
+    } catch (...) {}
+    if (cache_key) {
+        auto cached_regions = try_read_cached_regions(file, *cache_key);
+        if (cached_regions) return std::move(*cached_regions);
+    }
     auto stream = open(file);
     std::deque<GenomicRegion> result {};
     if (policy == NonreferenceContigPolicy::exception) {
@@ -256,6 +418,9 @@ std::deque<GenomicRegion> extract_regions(const boost::filesystem::path& file,
         }
     }
     result.shrink_to_fit();
+    if (cache_key && result.size() >= minRegionsToCache) {
+        try_write_region_cache(file, *cache_key, result);
+    }
     return result;
 }
 
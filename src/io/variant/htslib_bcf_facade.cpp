@@ -73,6 +73,9 @@ std::string get_hts_mode(const HtslibBcfFacade::Path& file_path, HtslibBcfFacade
         auto extension = file_path.extension();
         if (extension == ".bcf") {
             result += "b";
+            if (mode == Mode::uncompressed_write) {
+                result += "u";
+            }
         } else if (extension == ".gz" && file_path.stem().extension() == ".vcf") {
             result += "z";
         }
@@ -105,7 +108,7 @@ HtslibBcfFacade::HtslibBcfFacade(Path file_path, Mode mode)
         if (boost::filesystem::exists(file_path_)) {
             file_.reset(bcf_open(file_path_.c_str(), hts_mode.c_str()));
             if (file_ == nullptr) return;
-            header_.reset(bcf_hdr_read(file_.get()));
+            header_.reset(bcf_hdr_read(file_.get()), HtsHeaderDeleter {});
             if (header_ == nullptr) {
                 throw std::runtime_error {"HtslibBcfFacade: could not make header for file " + file_path_.string()};
             }
@@ -115,7 +118,7 @@ HtslibBcfFacade::HtslibBcfFacade(Path file_path, Mode mode)
         }
     } else {
         file_.reset(bcf_open(file_path_.c_str(), hts_mode.c_str()));
-        header_.reset(bcf_hdr_init(hts_mode.c_str()));
+        header_.reset(bcf_hdr_init(hts_mode.c_str()), HtsHeaderDeleter {});
     }
 }
 
@@ -147,6 +150,22 @@ VcfHeader HtslibBcfFacade::fetch_header() const
     return result.build_once();
 }
 
+namespace {
+
+bool is_same_contig(const bcf_hdr_t* header, const bcf1_t* record, const std::string& contig)
+{
+    return contig == bcf_hdr_id2name(header, record->rid);
+}
+
+bool overlaps(const bcf_hdr_t* header, const bcf1_t* record, const GenomicRegion& region)
+{
+    return is_same_contig(header, record, region.contig_name())
+           && record->pos < static_cast<std::int64_t>(region.end())
+           && record->pos + record->rlen > static_cast<std::int64_t>(region.begin());
+}
+
+} // namespace
+
 std::size_t HtslibBcfFacade::count_records() const
 {
     HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
@@ -168,7 +187,7 @@ std::size_t HtslibBcfFacade::count_records(const std::string& contig) const
     }
     if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
         sr.release();
-        throw std::runtime_error {"failed to open file " + file_path_.string()};
+        return count_records_filtered(contig); // no index, so stream and filter
     }
     
     return count_records(sr);
@@ -183,7 +202,7 @@ std::size_t HtslibBcfFacade::count_records(const GenomicRegion& region) const
     }
     if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
         sr.release();
-        throw std::runtime_error {"failed to open file " + file_path_.string()};
+        return count_records_filtered(region); // no index, so stream and filter
     }
     
     return count_records(sr);
@@ -212,7 +231,7 @@ HtslibBcfFacade::iterate(const std::string& contig, const UnpackPolicy level) co
     }
     if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
         sr.release();
-        throw std::runtime_error {"failed to open file " + file_path_.string()};
+        return iterate_filtered(contig, level); // no index, so stream and filter
     }
     
     return std::make_pair(std::make_unique<RecordIterator>(*this, std::move(sr), level),
@@ -230,7 +249,7 @@ HtslibBcfFacade::iterate(const GenomicRegion& region, const UnpackPolicy level)
     }
     if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
         sr.release();
-        throw std::runtime_error {"failed to open file " + file_path_.string()};
+        return iterate_filtered(region, level); // no index, so stream and filter
     }
     
     return std::make_pair(std::make_unique<RecordIterator>(*this, std::move(sr), level),
@@ -262,7 +281,7 @@ HtslibBcfFacade::fetch_records(const std::string& contig, const UnpackPolicy lev
     }
     if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
         sr.release();
-        throw std::runtime_error {"failed to open file " + file_path_.string()};
+        return fetch_records_filtered(contig, level, n_records); // no index, so stream and filter
     }
     
     return fetch_records(sr.get(), level, n_records);
@@ -280,12 +299,106 @@ HtslibBcfFacade::fetch_records(const GenomicRegion& region, const UnpackPolicy l
     }
     if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
         sr.release();
-        throw std::runtime_error {"failed to open file " + file_path_.string()};
+        return fetch_records_filtered(region, level, n_records); // no index, so stream and filter
     }
     
     return fetch_records(sr.get(), level, n_records);
 }
 
+std::size_t HtslibBcfFacade::count_records_filtered(const std::string& contig) const
+{
+    HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
+    if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
+        sr.release();
+        throw std::runtime_error {"failed to open file " + file_path_.string()};
+    }
+    std::size_t result {0};
+    while (bcf_sr_next_line(sr.get())) {
+        if (is_same_contig(bcf_sr_get_header(sr.get(), 0), bcf_sr_get_line(sr.get(), 0), contig)) {
+            ++result;
+        }
+    }
+    return result;
+}
+
+std::size_t HtslibBcfFacade::count_records_filtered(const GenomicRegion& region) const
+{
+    HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
+    if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
+        sr.release();
+        throw std::runtime_error {"failed to open file " + file_path_.string()};
+    }
+    std::size_t result {0};
+    while (bcf_sr_next_line(sr.get())) {
+        if (overlaps(bcf_sr_get_header(sr.get(), 0), bcf_sr_get_line(sr.get(), 0), region)) {
+            ++result;
+        }
+    }
+    return result;
+}
+
+HtslibBcfFacade::RecordIteratorPtrPair
+HtslibBcfFacade::iterate_filtered(const std::string& contig, const UnpackPolicy level) const
+{
+    HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
+    if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
+        sr.release();
+        throw std::runtime_error {"failed to open file " + file_path_.string()};
+    }
+    return std::make_pair(std::make_unique<RecordIterator>(*this, std::move(sr), level, contig),
+                          std::make_unique<RecordIterator>(*this));
+}
+
+HtslibBcfFacade::RecordIteratorPtrPair
+HtslibBcfFacade::iterate_filtered(const GenomicRegion& region, const UnpackPolicy level) const
+{
+    HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
+    if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
+        sr.release();
+        throw std::runtime_error {"failed to open file " + file_path_.string()};
+    }
+    return std::make_pair(std::make_unique<RecordIterator>(*this, std::move(sr), level, region),
+                          std::make_unique<RecordIterator>(*this));
+}
+
+HtslibBcfFacade::RecordContainer
+HtslibBcfFacade::fetch_records_filtered(const std::string& contig, const UnpackPolicy level,
+                                        const std::size_t num_records) const
+{
+    HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
+    if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
+        sr.release();
+        throw std::runtime_error {"failed to open file " + file_path_.string()};
+    }
+    RecordContainer result {};
+    result.reserve(num_records);
+    while (result.size() < num_records && bcf_sr_next_line(sr.get())) {
+        if (is_same_contig(bcf_sr_get_header(sr.get(), 0), bcf_sr_get_line(sr.get(), 0), contig)) {
+            result.push_back(fetch_record(sr.get(), level));
+        }
+    }
+    return result;
+}
+
+HtslibBcfFacade::RecordContainer
+HtslibBcfFacade::fetch_records_filtered(const GenomicRegion& region, const UnpackPolicy level,
+                                        const std::size_t num_records) const
+{
+    HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
+    if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
+        sr.release();
+        throw std::runtime_error {"failed to open file " + file_path_.string()};
+    }
+    RecordContainer result {};
+    result.reserve(num_records);
+    while (result.size() < num_records && bcf_sr_next_line(sr.get())) {
+        if (overlaps(bcf_sr_get_header(sr.get(), 0), bcf_sr_get_line(sr.get(), 0), region)) {
+            result.push_back(fetch_record(sr.get(), level));
+        }
+    }
+    return result;
+}
+
 auto hts_tag_type(const std::string& tag)
 {
     using namespace vcfspec::header::meta::tag;
@@ -356,7 +469,7 @@ void HtslibBcfFacade::write(const VcfHeader& header)
         bcf_hdr_add_sample(hdr, sample.c_str());
     }
     bcf_hdr_write(file_.get(), hdr);
-    header_.reset(hdr);
+    header_.reset(hdr, HtsHeaderDeleter {});
     samples_ = extract_samples(header_.get());
 }
 
@@ -403,6 +516,13 @@ void HtslibBcfFacade::write(const VcfRecord& record)
     bcf_destroy(hts_record);
 }
 
+void HtslibBcfFacade::set_threads(const unsigned num_threads)
+{
+    if (file_ != nullptr && num_threads > 1) {
+        hts_set_threads(file_.get(), static_cast<int>(num_threads));
+    }
+}
+
 // HtslibBcfFacade::RecordIterator
 
 HtslibBcfFacade::RecordIterator::RecordIterator(const HtslibBcfFacade& facade)
@@ -426,6 +546,42 @@ HtslibBcfFacade::RecordIterator::RecordIterator(const HtslibBcfFacade& facade,
     }
 }
 
+HtslibBcfFacade::RecordIterator::RecordIterator(const HtslibBcfFacade& facade,
+                                                HtsBcfSrPtr hts_iterator,
+                                                UnpackPolicy level,
+                                                std::string contig)
+: facade_ {facade}
+, hts_iterator_ {std::move(hts_iterator)}
+, level_ {level}
+, contig_ {std::move(contig)}
+{
+    while (bcf_sr_next_line(hts_iterator_.get())) {
+        if (is_same_contig(bcf_sr_get_header(hts_iterator_.get(), 0), bcf_sr_get_line(hts_iterator_.get(), 0), *contig_)) {
+            record_ = std::make_shared<VcfRecord>(facade_.get().fetch_record(hts_iterator_.get(), level_));
+            return;
+        }
+    }
+    hts_iterator_ = nullptr;
+}
+
+HtslibBcfFacade::RecordIterator::RecordIterator(const HtslibBcfFacade& facade,
+                                                HtsBcfSrPtr hts_iterator,
+                                                UnpackPolicy level,
+                                                GenomicRegion region)
+: facade_ {facade}
+, hts_iterator_ {std::move(hts_iterator)}
+, level_ {level}
+, region_ {std::move(region)}
+{
+    while (bcf_sr_next_line(hts_iterator_.get())) {
+        if (overlaps(bcf_sr_get_header(hts_iterator_.get(), 0), bcf_sr_get_line(hts_iterator_.get(), 0), *region_)) {
+            record_ = std::make_shared<VcfRecord>(facade_.get().fetch_record(hts_iterator_.get(), level_));
+            return;
+        }
+    }
+    hts_iterator_ = nullptr;
+}
+
 HtslibBcfFacade::RecordIterator::reference HtslibBcfFacade::RecordIterator::operator*() const
 {
     return *record_;
@@ -438,11 +594,20 @@ HtslibBcfFacade::RecordIterator::pointer HtslibBcfFacade::RecordIterator::operat
 
 void HtslibBcfFacade::RecordIterator::next()
 {
-    if (bcf_sr_next_line(hts_iterator_.get())) {
+    while (bcf_sr_next_line(hts_iterator_.get())) {
+        if (contig_ || region_) {
+            const auto line = bcf_sr_get_line(hts_iterator_.get(), 0);
+            const auto header = bcf_sr_get_header(hts_iterator_.get(), 0);
+            if (region_) {
+                if (!overlaps(header, line, *region_)) continue;
+            } else if (!is_same_contig(header, line, *contig_)) {
+                continue;
+            }
+        }
         *record_ = facade_.get().fetch_record(hts_iterator_.get(), level_);
-    } else {
-        hts_iterator_ = nullptr;
+        return;
     }
+    hts_iterator_ = nullptr;
 }
 
 HtslibBcfFacade::RecordIterator& HtslibBcfFacade::RecordIterator::operator++()
@@ -636,8 +801,9 @@ float get_bcf_float_missing() noexcept
 
 void set_info(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source)
 {
-    for (const auto& key : source.info_keys()) {
-        const auto& values    = source.info_value(key);
+    for (const auto& p : source.info()) {
+        const auto& key       = p.first;
+        const auto& values    = p.second;
         const auto num_values = static_cast<int>(values.size());
         static constexpr std::size_t defaultBufferCapacity {100};
         switch (bcf_hdr_id2type(header, BCF_HL_INFO, bcf_hdr_id2int(header, BCF_DT_ID, key.c_str()))) {
@@ -930,10 +1096,45 @@ std::size_t HtslibBcfFacade::count_records(HtsBcfSrPtr& sr) const
     return result;
 }
 
+namespace {
+
+// Holds the packed hts record and defers INFO and sample parsing until a
+// VcfRecord field backed by them is first touched
+class LazyBcfUnpacker : public VcfRecord::LazyUnpacker
+{
+public:
+    LazyBcfUnpacker(std::shared_ptr<bcf_hdr_t> header, bcf1_t* record)
+    : header_ {std::move(header)}
+    , record_ {bcf_dup(record), [] (bcf1_t* r) { bcf_destroy(r); }}
+    {}
+
+private:
+    std::shared_ptr<bcf_hdr_t> header_;
+    std::shared_ptr<bcf1_t> record_;
+
+    void do_unpack(const VcfRecord& record) const override
+    {
+        bcf_unpack(record_.get(), BCF_UN_ALL);
+        VcfRecord::Builder builder {};
+        builder.set_pos(1); // only the unpacked columns are used
+        extract_info(header_.get(), record_.get(), builder);
+        if (has_samples(header_.get())) {
+            extract_samples(header_.get(), record_.get(), builder);
+        }
+        set_unpacked_fields(record, builder.build_once());
+    }
+};
+
+} // namespace
+
 VcfRecord HtslibBcfFacade::fetch_record(const bcf_srs_t* sr, UnpackPolicy level) const
 {
     auto hts_record = bcf_sr_get_line(sr, 0);
-    bcf_unpack(hts_record, level == UnpackPolicy::all ? BCF_UN_ALL : BCF_UN_SHR);
+    if (level == UnpackPolicy::lazy) {
+        bcf_unpack(hts_record, BCF_UN_FLT);
+    } else {
+        bcf_unpack(hts_record, level == UnpackPolicy::all ? BCF_UN_ALL : BCF_UN_SHR);
+    }
     VcfRecord::Builder record_builder {};
     extract_chrom(header_.get(), hts_record, record_builder);
     extract_pos(hts_record, record_builder);
@@ -942,9 +1143,13 @@ VcfRecord HtslibBcfFacade::fetch_record(const bcf_srs_t* sr, UnpackPolicy level)
     extract_alt(hts_record, record_builder);
     extract_qual(hts_record, record_builder);
     extract_filter(header_.get(), hts_record, record_builder);
-    extract_info(header_.get(), hts_record, record_builder);
-    if (level == UnpackPolicy::all && has_samples(header_.get())) {
-        extract_samples(header_.get(), hts_record, record_builder);
+    if (level == UnpackPolicy::lazy) {
+        record_builder.set_lazy_unpacker(std::make_shared<LazyBcfUnpacker>(header_, hts_record));
+    } else {
+        extract_info(header_.get(), hts_record, record_builder);
+        if (level == UnpackPolicy::all && has_samples(header_.get())) {
+            extract_samples(header_.get(), hts_record, record_builder);
+        }
     }
     return record_builder.build_once();
 }
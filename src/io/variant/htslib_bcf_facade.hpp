@@ -11,17 +11,18 @@
 #include <iterator>
 
 #include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
 
 #include "htslib/hts.h"
 #include "htslib/vcf.h"
 #include "htslib/synced_bcf_reader.h"
 
+#include "basics/genomic_region.hpp"
 #include "vcf_reader_impl.hpp"
 #include "vcf_record.hpp"
 
 namespace octopus {
 
-class GenomicRegion;
 class VcfHeader;
 
 class HtslibBcfFacade : public IVcfReaderImpl
@@ -33,7 +34,9 @@ public:
     using IVcfReaderImpl::RecordIteratorPtrPair;
     class RecordIterator;
     
-    enum class Mode { read, write };
+    // uncompressed_write skips BGZF entirely; intended for intra-run
+    // temporaries that are read back once and deleted
+    enum class Mode { read, write, uncompressed_write };
     
     HtslibBcfFacade(); // write only, goes to stdout
     HtslibBcfFacade(Path file_path, Mode mode = Mode::read);
@@ -63,7 +66,11 @@ public:
     
     void write(const VcfHeader& header);
     void write(const VcfRecord& record);
-    
+
+    // Gives the underlying htslib handle a pool of worker threads so bgzf
+    // block compression overlaps record conversion; a no-op for uncompressed output
+    void set_threads(unsigned num_threads);
+
 private:
     struct HtsFileDeleter
     {
@@ -87,13 +94,22 @@ private:
     
     Path file_path_;
     std::unique_ptr<htsFile, HtsFileDeleter> file_;
-    std::unique_ptr<bcf_hdr_t, HtsHeaderDeleter> header_;
+    // shared so that lazily unpacked records can keep the header alive
+    std::shared_ptr<bcf_hdr_t> header_;
     std::vector<std::string> samples_;
     
     std::size_t count_records(HtsBcfSrPtr& sr) const;
     VcfRecord fetch_record(const bcf_srs_t* sr, UnpackPolicy level) const;
     RecordContainer fetch_records(bcf_srs_t*, UnpackPolicy level, size_t num_records) const;
     
+    // Streaming fallbacks for files without an index (e.g. uncompressed temporaries)
+    std::size_t count_records_filtered(const std::string& contig) const;
+    std::size_t count_records_filtered(const GenomicRegion& region) const;
+    RecordIteratorPtrPair iterate_filtered(const std::string& contig, UnpackPolicy level) const;
+    RecordIteratorPtrPair iterate_filtered(const GenomicRegion& region, UnpackPolicy level) const;
+    RecordContainer fetch_records_filtered(const std::string& contig, UnpackPolicy level, std::size_t num_records) const;
+    RecordContainer fetch_records_filtered(const GenomicRegion& region, UnpackPolicy level, std::size_t num_records) const;
+    
     friend RecordIterator;
 };
 
@@ -108,6 +124,10 @@ public:
     
     RecordIterator(const HtslibBcfFacade& facade);
     RecordIterator(const HtslibBcfFacade& facade, HtsBcfSrPtr hts_iterator, UnpackPolicy level);
+    RecordIterator(const HtslibBcfFacade& facade, HtsBcfSrPtr hts_iterator, UnpackPolicy level,
+                   std::string contig);
+    RecordIterator(const HtslibBcfFacade& facade, HtsBcfSrPtr hts_iterator, UnpackPolicy level,
+                   GenomicRegion region);
     
     RecordIterator(const RecordIterator&)            = default;
     RecordIterator& operator=(const RecordIterator&) = default;
@@ -138,6 +158,11 @@ private:
     UnpackPolicy level_;
     
     std::shared_ptr<VcfRecord> record_;
+    
+    // Set when iterating an unindexed file, where htslib cannot do the
+    // region filtering for us
+    boost::optional<std::string> contig_;
+    boost::optional<GenomicRegion> region_;
 };
 
 bool operator!=(const HtslibBcfFacade::RecordIterator& lhs, const HtslibBcfFacade::RecordIterator& rhs);
@@ -4,10 +4,11 @@
 #include "vcf_parser.hpp"
 
 #include <algorithm>
+#include <cctype>
 #include <stdexcept>
 
 #include <boost/optional.hpp>
-#include <boost/lexical_cast.hpp>
+#include <boost/utility/string_ref.hpp>
 
 #include "basics/genomic_region.hpp"
 
@@ -34,6 +35,35 @@ std::istream& operator>>(std::istream& str, Token<Delim>& data)
 using Line   = Token<'\n'>;
 using Column = Token<'\t'>;
 
+// The offset index only needs CHROM, POS, and the REF length from each record
+struct RecordIndexFields
+{
+    boost::string_ref chrom;
+    long pos;
+    std::size_t ref_length;
+};
+
+RecordIndexFields parse_record_index_fields(const std::string& line)
+{
+    boost::string_ref str {line};
+    const auto chrom_end = str.find('\t');
+    const auto chrom = str.substr(0, chrom_end);
+    str.remove_prefix(chrom_end + 1);
+    const auto pos_end = str.find('\t');
+    long pos {0};
+    for (const char c : str.substr(0, pos_end)) {
+        pos = 10 * pos + (c - '0');
+    }
+    str.remove_prefix(pos_end + 1);
+    str.remove_prefix(str.find('\t') + 1); // skip ID
+    return {chrom, pos, str.find('\t')};
+}
+
+bool begins_after(const std::string& line, const GenomicRegion& region)
+{
+    return parse_record_index_fields(line).pos >= static_cast<long>(region.end());
+}
+
 // public methods
 
 VcfParser::VcfParser(const fs::path& file_path)
@@ -64,6 +94,10 @@ std::size_t VcfParser::count_records() const
 
 std::size_t VcfParser::count_records(const std::string& contig) const
 {
+    if (is_offset_indexed()) {
+        const auto index_itr = offset_index_.find(contig);
+        return index_itr != std::cend(offset_index_) ? index_itr->second.num_records : 0;
+    }
     const auto result = std::count_if(std::istream_iterator<Line>(file_), std::istream_iterator<Line>(),
                                       [&contig] (const auto& line) { return is_same_contig(line, contig); });
     reset_vcf();
@@ -72,6 +106,22 @@ std::size_t VcfParser::count_records(const std::string& contig) const
 
 std::size_t VcfParser::count_records(const GenomicRegion& region) const
 {
+    if (is_offset_indexed()) {
+        const auto end_offset = contig_end_offset(region.contig_name());
+        if (!end_offset) return 0;
+        seek_to(region);
+        std::size_t result {0};
+        std::string line;
+        while (file_.tellg() < *end_offset && std::getline(file_, line)) {
+            if (overlaps(line, region)) {
+                ++result;
+            } else if (begins_after(line, region)) {
+                break; // records are sorted, so nothing later can overlap
+            }
+        }
+        reset_vcf();
+        return result;
+    }
     const auto result = std::count_if(std::istream_iterator<Line>(file_), std::istream_iterator<Line>(),
                                       [&region] (const auto& line) { return overlaps(line, region); });
     reset_vcf();
@@ -87,14 +137,22 @@ VcfParser::RecordIteratorPtrPair VcfParser::iterate(UnpackPolicy level) const
 
 VcfParser::RecordIteratorPtrPair VcfParser::iterate(const std::string& contig, UnpackPolicy level) const
 {
-    reset_vcf();
+    if (is_offset_indexed()) {
+        seek_to(contig);
+    } else {
+        reset_vcf();
+    }
     return std::make_pair(std::make_unique<RecordIterator>(*this, level, contig),
                           std::make_unique<RecordIterator>());
 }
 
 VcfParser::RecordIteratorPtrPair VcfParser::iterate(const GenomicRegion& region, const UnpackPolicy level) const
 {
-    reset_vcf();
+    if (is_offset_indexed()) {
+        seek_to(region);
+    } else {
+        reset_vcf();
+    }
     return std::make_pair(std::make_unique<RecordIterator>(*this, level, region),
                           std::make_unique<RecordIterator>());
 }
@@ -103,7 +161,7 @@ VcfParser::RecordContainer VcfParser::fetch_records(const UnpackPolicy level) co
 {
     RecordContainer result {};
     result.reserve(count_records());
-    bool unpack_all {level == UnpackPolicy::all};
+    bool unpack_all {level != UnpackPolicy::sites};
     std::transform(std::istream_iterator<Line>(file_), std::istream_iterator<Line>(),
                    std::back_inserter(result), [this, unpack_all] (const auto& line) {
                        return (unpack_all) ? parse_record(line, samples_) : parse_record(line);
@@ -115,8 +173,22 @@ VcfParser::RecordContainer VcfParser::fetch_records(const UnpackPolicy level) co
 VcfParser::RecordContainer VcfParser::fetch_records(const std::string& contig, const UnpackPolicy level) const
 {
     RecordContainer result {};
+    if (is_offset_indexed()) {
+        const auto index_itr = offset_index_.find(contig);
+        if (index_itr != std::cend(offset_index_)) {
+            result.reserve(index_itr->second.num_records);
+            seek_to(contig);
+            const bool unpack_all {level != UnpackPolicy::sites};
+            std::string line;
+            while (result.size() < index_itr->second.num_records && std::getline(file_, line)) {
+                result.push_back((unpack_all) ? parse_record(line, samples_) : parse_record(line));
+            }
+            reset_vcf();
+        }
+        return result;
+    }
     result.reserve(count_records(contig));
-    bool unpack_all {level == UnpackPolicy::all};
+    bool unpack_all {level != UnpackPolicy::sites};
     std::for_each(std::istream_iterator<Line>(file_), std::istream_iterator<Line>(),
                   [this, &result, &contig, unpack_all] (const auto& line) {
                       if (is_same_contig(line, contig)) {
@@ -130,8 +202,25 @@ VcfParser::RecordContainer VcfParser::fetch_records(const std::string& contig, c
 VcfParser::RecordContainer VcfParser::fetch_records(const GenomicRegion& region, const UnpackPolicy level) const
 {
     RecordContainer result {};
+    if (is_offset_indexed()) {
+        const auto end_offset = contig_end_offset(region.contig_name());
+        if (end_offset) {
+            seek_to(region);
+            const bool unpack_all {level != UnpackPolicy::sites};
+            std::string line;
+            while (file_.tellg() < *end_offset && std::getline(file_, line)) {
+                if (overlaps(line, region)) {
+                    result.push_back((unpack_all) ? parse_record(line, samples_) : parse_record(line));
+                } else if (begins_after(line, region)) {
+                    break; // records are sorted, so nothing later can overlap
+                }
+            }
+            reset_vcf();
+        }
+        return result;
+    }
     result.reserve(count_records(region));
-    bool unpack_all {level == UnpackPolicy::all};
+    bool unpack_all {level != UnpackPolicy::sites};
     std::for_each(std::istream_iterator<Line>(file_), std::istream_iterator<Line>(),
                   [this, &result, &region, unpack_all] (const std::string& line) {
                       if (overlaps(line, region)) {
@@ -150,6 +239,103 @@ void VcfParser::reset_vcf() const
     file_.seekg(first_record_pos_);
 }
 
+bool VcfParser::is_offset_indexed() const
+{
+    if (!offset_index_built_) {
+        build_offset_index();
+    }
+    return records_sorted_;
+}
+
+void VcfParser::build_offset_index() const
+{
+    static constexpr std::size_t offsetSampleRate {1000};
+    offset_index_built_ = true;
+    reset_vcf();
+    std::string line;
+    std::string current_contig {};
+    ContigIndex* contig_index {nullptr};
+    long prev_pos {0};
+    auto line_pos = file_.tellg();
+    while (std::getline(file_, line) && !line.empty()) {
+        const auto fields = parse_record_index_fields(line);
+        if (contig_index == nullptr || fields.chrom != current_contig) {
+            current_contig.assign(fields.chrom.data(), fields.chrom.size());
+            const auto insertion = offset_index_.emplace(current_contig, ContigIndex {});
+            if (!insertion.second) {
+                records_sorted_ = false; // the contig appears in separate blocks
+                break;
+            }
+            if (contig_index != nullptr) {
+                contig_index->end_pos = line_pos;
+            }
+            contig_index = &insertion.first->second;
+            contig_index->begin_pos = line_pos;
+        } else if (fields.pos < prev_pos) {
+            records_sorted_ = false;
+            break;
+        }
+        if (contig_index->num_records % offsetSampleRate == 0) {
+            contig_index->sampled_offsets.emplace_back(fields.pos, line_pos);
+        }
+        ++contig_index->num_records;
+        contig_index->max_ref_length = std::max(contig_index->max_ref_length, fields.ref_length);
+        prev_pos = fields.pos;
+        line_pos = file_.tellg();
+    }
+    if (records_sorted_) {
+        if (contig_index != nullptr) {
+            contig_index->end_pos = line_pos;
+        }
+    } else {
+        offset_index_.clear(); // unsorted records can only be full-scanned
+    }
+    reset_vcf();
+}
+
+void VcfParser::seek_to(const std::string& contig) const
+{
+    const auto index_itr = offset_index_.find(contig);
+    file_.clear();
+    if (index_itr != std::cend(offset_index_)) {
+        file_.seekg(index_itr->second.begin_pos);
+    } else {
+        file_.seekg(0, std::ios::end); // no records to find
+    }
+}
+
+void VcfParser::seek_to(const GenomicRegion& region) const
+{
+    const auto index_itr = offset_index_.find(region.contig_name());
+    file_.clear();
+    if (index_itr == std::cend(offset_index_)) {
+        file_.seekg(0, std::ios::end); // no records to find
+        return;
+    }
+    const auto& index = index_itr->second;
+    // Records at or before a sample with this position cannot reach the region
+    const auto max_unreachable_pos = static_cast<long>(region.begin()) - static_cast<long>(index.max_ref_length);
+    const auto sample_itr = std::upper_bound(std::cbegin(index.sampled_offsets), std::cend(index.sampled_offsets),
+                                             max_unreachable_pos,
+                                             [] (const auto pos, const auto& sample) { return pos < sample.first; });
+    if (sample_itr == std::cbegin(index.sampled_offsets)) {
+        file_.seekg(index.begin_pos);
+    } else {
+        file_.seekg(std::prev(sample_itr)->second);
+    }
+}
+
+boost::optional<std::streampos> VcfParser::contig_end_offset(const std::string& contig) const
+{
+    if (offset_index_built_ && records_sorted_) {
+        const auto index_itr = offset_index_.find(contig);
+        if (index_itr != std::cend(offset_index_)) {
+            return index_itr->second.end_pos;
+        }
+    }
+    return boost::none;
+}
+
 // non-member methods
 
 using Field = Token<','>;
@@ -267,149 +453,169 @@ VcfHeader parse_header(std::ifstream& vcf_file)
 
 bool is_same_contig(const std::string& line, const std::string& contig)
 {
-    std::istringstream ss {line};
-    std::istream_iterator<Column> it {ss};
-    return it->data == contig;
+    const boost::string_ref str {line};
+    return str.substr(0, str.find('\t')) == contig;
 }
 
 bool overlaps(const std::string& line, const GenomicRegion& region)
 {
-    std::istringstream ss {line};
-    std::istream_iterator<Column> it {ss};
-    if (it->data != region.contig_name()) return false; // CHROM
-    std::advance(it, 1); // POS
-    const auto begin = std::stol(it->data);
-    std::advance(it, 2); // REF
-    const auto end = begin + static_cast<long>(it->data.length());
+    boost::string_ref str {line};
+    const auto chrom_end = str.find('\t');
+    if (str.substr(0, chrom_end) != region.contig_name()) return false; // CHROM
+    str.remove_prefix(chrom_end + 1);
+    const auto pos_end = str.find('\t');
+    long begin {0};
+    for (const char c : str.substr(0, pos_end)) { // POS
+        begin = 10 * begin + (c - '0');
+    }
+    str.remove_prefix(pos_end + 1);
+    str.remove_prefix(str.find('\t') + 1); // skip ID
+    const auto end = begin + static_cast<long>(str.find('\t')); // REF
     return (std::min(static_cast<long>(region.end()), end) -
                 std::max(static_cast<long>(region.begin()), begin)) > 0;
 }
 
-std::vector<std::string> split(const std::string& str, char delim = ',')
+// Records are tokenised with views over the line buffer; only the fields a
+// record keeps are materialised into strings
+using StringView = boost::string_ref;
+
+template <typename UnaryOp>
+void for_each_token(StringView str, const char delim, UnaryOp op)
+{
+    while (true) {
+        const auto pos = str.find(delim);
+        op(str.substr(0, pos));
+        if (pos == StringView::npos) break;
+        str.remove_prefix(pos + 1);
+    }
+}
+
+std::vector<std::string> split(const StringView str, const char delim = ',')
 {
-    std::stringstream ss {str};
-    std::string item;
     std::vector<std::string> result {};
     result.reserve(std::count(std::cbegin(str), std::cend(str), delim) + 1);
-    while (std::getline(ss, item, delim)) {
-        result.emplace_back(item);
+    for_each_token(str, delim, [&result] (const StringView token) {
+        result.emplace_back(token.data(), token.size());
+    });
+    return result;
+}
+
+// VCF positions are plain unsigned decimals, so this avoids materialising the
+// token just to run it through the locale-aware converters
+auto parse_position(const StringView str) noexcept
+{
+    long result {0};
+    for (const char c : str) {
+        result = 10 * result + (c - '0');
     }
     return result;
 }
 
-void parse_info_field(const std::string& field, VcfRecord::Builder& rb)
+void parse_info_field(const StringView field, VcfRecord::Builder& rb)
 {
-    const auto pos = field.find_first_of('=');
-    if (pos == std::string::npos) {
-        rb.set_info_flag(field);
+    const auto pos = field.find('=');
+    if (pos == StringView::npos) {
+        rb.set_info_flag(field.to_string());
     } else {
-        rb.set_info(field.substr(0, pos), split(field.substr(pos + 1), ','));
+        rb.set_info(field.substr(0, pos).to_string(), split(field.substr(pos + 1), ','));
     }
 }
 
-using InfoField = Token<';'>;
-
-void parse_info(const std::string& column, VcfRecord::Builder& rb)
+void parse_info(const StringView column, VcfRecord::Builder& rb)
 {
-    std::istringstream ss {column};
-    std::for_each(std::istream_iterator<InfoField>(ss), std::istream_iterator<InfoField>(),
-                  [&rb] (const auto& field) {
-                      parse_info_field(field, rb);
-                  });
+    for_each_token(column, ';', [&rb] (const StringView field) {
+        parse_info_field(field, rb);
+    });
 }
 
-bool is_phased(const std::string& genotype)
+bool is_phased(const StringView genotype)
 {
     const auto pos = genotype.find_first_of("|/");
-    if (pos == std::string::npos) {
+    if (pos == StringView::npos) {
         return true; // must be haploid
     }
     return genotype[pos] == '|';
 }
 
-void parse_genotype(const VcfRecord::SampleName& sample, const std::string& genotype,
+void parse_genotype(const VcfRecord::SampleName& sample, const StringView genotype,
                     VcfRecord::Builder& rb)
 {
     const bool phased {is_phased(genotype)};
-    auto allele_numbers = split(genotype, (phased) ? '|' : '/');
     using Phasing = VcfRecord::Builder::Phasing;
     std::vector<boost::optional<unsigned>> alleles {};
-    const auto ploidy = allele_numbers.size();
-    alleles.reserve(ploidy);
-    
-    std::transform(std::cbegin(allele_numbers), std::cend(allele_numbers), std::back_inserter(alleles),
-                   [] (const auto& a) -> boost::optional<unsigned> {
-                       try {
-                           return boost::lexical_cast<unsigned>(a);
-                       } catch (const boost::bad_lexical_cast&) {
-                           return boost::none;
-                       }
-                   });
-    
+    alleles.reserve(std::count(std::cbegin(genotype), std::cend(genotype), phased ? '|' : '/') + 1);
+    for_each_token(genotype, (phased) ? '|' : '/', [&alleles] (const StringView a) {
+        const bool is_number {!a.empty() && std::all_of(std::cbegin(a), std::cend(a),
+                                                        [] (const char c) { return std::isdigit(c); })};
+        if (is_number) {
+            alleles.emplace_back(static_cast<unsigned>(parse_position(a)));
+        } else {
+            alleles.emplace_back(boost::none);
+        }
+    });
     rb.set_genotype(sample, std::move(alleles), (phased) ? Phasing::phased : Phasing::unphased);
 }
 
-using SampleField = Token<':'>;
-
-void parse_sample(const std::string& column, const VcfRecord::SampleName& sample,
+void parse_sample(const StringView column, const VcfRecord::SampleName& sample,
                   const std::vector<std::string>& format, VcfRecord::Builder& rb)
 {
-    auto first_key = std::cbegin(format);
-    std::istringstream ss {column};
-    std::istream_iterator<SampleField> first_value {ss};
-    if (format.front() == "GT") { // GT must always come first, if present
-        parse_genotype(sample, *first_value, rb);
-        ++first_key;
-        ++first_value;
-    }
-    std::for_each(first_value, std::istream_iterator<SampleField> {},
-                  [&rb, &sample, &first_key] (const std::string& value) {
-                      rb.set_format(sample, *first_key, split(value, ','));
-                      ++first_key;
-                  });
+    auto key_itr = std::cbegin(format);
+    bool is_first {true};
+    for_each_token(column, ':', [&] (const StringView value) {
+        if (is_first && format.front() == "GT") { // GT must always come first, if present
+            parse_genotype(sample, value, rb);
+        } else {
+            rb.set_format(sample, *key_itr, split(value, ','));
+        }
+        ++key_itr;
+        is_first = false;
+    });
 }
 
 VcfRecord parse_record(const std::string& line, const std::vector<VcfRecord::SampleName>& samples)
 {
-    std::istringstream ss {line};
-    std::istream_iterator<Column> it {ss}, eos {};
+    StringView str {line};
+    bool exhausted {false};
+    const auto next_column = [&str, &exhausted] () {
+        const auto pos = str.find('\t');
+        const auto result = str.substr(0, pos);
+        if (pos == StringView::npos) {
+            str.clear();
+            exhausted = true;
+        } else {
+            str.remove_prefix(pos + 1);
+        }
+        return result;
+    };
     VcfRecord::Builder rb {};
     
-    rb.set_chrom(it->data);
-    ++it;
-    rb.set_pos(static_cast<GenomicRegion::Position>(std::stol(it->data)));
-    ++it;
-    rb.set_id(it->data);
-    ++it;
-    rb.set_ref(it->data);
-    ++it;
-    rb.set_alt(split(it->data, ','));
-    ++it;
+    rb.set_chrom(next_column().to_string());
+    rb.set_pos(static_cast<GenomicRegion::Position>(parse_position(next_column())));
+    rb.set_id(next_column().to_string());
+    rb.set_ref(next_column().to_string());
+    rb.set_alt(split(next_column(), ','));
     
-    if (it->data == ".") {
+    const auto qual = next_column();
+    if (qual == ".") {
         rb.set_qual(0);
     } else {
         try {
-            rb.set_qual(static_cast<VcfRecord::QualityType>(std::stod(it->data)));
+            rb.set_qual(static_cast<VcfRecord::QualityType>(std::stod(qual.to_string())));
         } catch (const std::invalid_argument& e) {
             rb.set_qual(0); // or should throw?
         }
     }
     
-    ++it;
-    if (it->data != ".") {
-        rb.set_filter(split(it->data, ';'));
+    const auto filter = next_column();
+    if (filter != ".") {
+        rb.set_filter(split(filter, ';'));
     }
-    ++it;
-    parse_info(it->data, rb);
-    ++it;
+    parse_info(next_column(), rb);
     
-    if (!samples.empty() && it != eos) {
-        auto format = split(it->data, ':');
-        ++it;
+    if (!samples.empty() && !exhausted) {
+        auto format = split(next_column(), ':');
         for (const auto& sample : samples) {
-            parse_sample(it->data, sample, format, rb); // set after so can move
-            ++it;
+            parse_sample(next_column(), sample, format, rb); // set after so can move
         }
         rb.set_format(std::move(format));
     }
@@ -428,7 +634,7 @@ VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unp
 {
     local_.seekg(parent_vcf_->file_.tellg());
     if (std::getline(local_, line_)) {
-        if (unpack_ == UnpackPolicy::all) {
+        if (unpack_ != UnpackPolicy::sites) {
             record_ = std::make_shared<VcfRecord>(parse_record(line_, vcf.samples_));
         } else {
             record_ = std::make_shared<VcfRecord>(parse_record(line_));
@@ -442,6 +648,7 @@ VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unp
 : RecordIterator {vcf, unpack}
 {
     contig_ = std::move(contig);
+    end_pos_ = vcf.contig_end_offset(*contig_);
     if (record_ && record_->chrom() != *contig_) {
         next();
     }
@@ -451,6 +658,7 @@ VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unp
 : RecordIterator {vcf, unpack}
 {
     region_ = std::move(region);
+    end_pos_ = vcf.contig_end_offset(region_->contig_name());
     if (record_ && !overlaps(*record_, *region_)) {
         next();
     }
@@ -463,7 +671,7 @@ VcfParser::RecordIterator::RecordIterator(const RecordIterator& other)
 {
     local_.seekg(parent_vcf_->file_.tellg());
     if (std::getline(local_, line_)) {
-        if (unpack_ == UnpackPolicy::all) {
+        if (unpack_ != UnpackPolicy::sites) {
             record_ = std::make_shared<VcfRecord>(parse_record(line_, parent_vcf_->samples_));
         } else {
             record_ = std::make_shared<VcfRecord>(parse_record(line_));
@@ -495,7 +703,13 @@ VcfParser::RecordIterator::pointer VcfParser::RecordIterator::operator->() const
 void VcfParser::RecordIterator::next()
 {
     while (std::getline(local_, line_) && !line_.empty()) {
-        if (unpack_ == UnpackPolicy::all) {
+        if (end_pos_ && local_.tellg() > *end_pos_) {
+            // past the end of the indexed contig block, so compares equal to
+            // the end iterator without scanning the remaining contigs
+            local_.setstate(std::ios::failbit);
+            break;
+        }
+        if (unpack_ != UnpackPolicy::sites) {
             *record_ = parse_record(line_, parent_vcf_->samples_);
         } else {
             *record_ = parse_record(line_);
@@ -10,6 +10,8 @@
 #include <fstream>
 #include <iterator>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 
 #include <boost/filesystem/path.hpp>
 #include <boost/optional.hpp>
@@ -64,6 +66,14 @@ public:
     friend bool operator==(const RecordIterator& lhs, const RecordIterator& rhs);
     
 private:
+    struct ContigIndex
+    {
+        std::streampos begin_pos, end_pos;
+        std::size_t num_records = 0;
+        std::size_t max_ref_length = 0;
+        std::vector<std::pair<long, std::streampos>> sampled_offsets;
+    };
+    
     fs::path file_path_;
     
     mutable std::ifstream file_;
@@ -73,7 +83,18 @@ private:
     const std::vector<std::string> samples_;
     const std::streampos first_record_pos_; // must go after header_!
     
+    // Built lazily on the first contig or region query; maps sorted records
+    // to file offsets so later queries can seek rather than scan from the top
+    mutable std::unordered_map<std::string, ContigIndex> offset_index_;
+    mutable bool offset_index_built_ = false;
+    mutable bool records_sorted_ = true;
+    
     void reset_vcf() const; // logically const
+    bool is_offset_indexed() const; // builds the offset index on first use
+    void build_offset_index() const;
+    void seek_to(const std::string& contig) const;
+    void seek_to(const GenomicRegion& region) const;
+    boost::optional<std::streampos> contig_end_offset(const std::string& contig) const;
 };
 
 class VcfParser::RecordIterator : public IVcfReaderImpl::RecordIterator
@@ -118,6 +139,7 @@ private:
     mutable std::string line_;
     boost::optional<std::string> contig_;
     boost::optional<GenomicRegion> region_;
+    boost::optional<std::streampos> end_pos_;
 };
 
 bool operator!=(const VcfParser::RecordIterator& lhs, const VcfParser::RecordIterator& rhs);
@@ -19,7 +19,8 @@ class VcfRecord;
 class IVcfReaderImpl
 {
 public:
-    enum class UnpackPolicy { all, sites };
+    // lazy defers INFO and sample column parsing until a field is first accessed
+    enum class UnpackPolicy { all, sites, lazy };
     
     using RecordContainer = std::vector<VcfRecord>;
     
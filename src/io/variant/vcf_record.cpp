@@ -64,13 +64,15 @@ const std::vector<VcfRecord::KeyType>& VcfRecord::filter() const noexcept
     return filter_;
 }
 
-bool VcfRecord::has_info(const KeyType& key) const noexcept
+bool VcfRecord::has_info(const KeyType& key) const
 {
+    materialise();
     return info_.count(key) == 1;
 }
 
 std::vector<VcfRecord::KeyType> VcfRecord::info_keys() const
 {
+    materialise();
     std::vector<KeyType> result {};
     result.reserve(info_.size());
     
@@ -83,15 +85,23 @@ std::vector<VcfRecord::KeyType> VcfRecord::info_keys() const
 
 const std::vector<VcfRecord::ValueType>& VcfRecord::info_value(const KeyType& key) const
 {
+    materialise();
     return info_.at(key);
 }
 
-bool VcfRecord::has_format(const KeyType& key) const noexcept
+const VcfRecord::ValueMap& VcfRecord::info() const
 {
+    materialise();
+    return info_;
+}
+
+bool VcfRecord::has_format(const KeyType& key) const
+{
+    materialise();
     return std::find(std::cbegin(format_), std::cend(format_), key) != std::cend(format_);
 }
 
-boost::optional<unsigned> VcfRecord::format_cardinality(const KeyType& key) const noexcept
+boost::optional<unsigned> VcfRecord::format_cardinality(const KeyType& key) const
 {
     boost::optional<unsigned> result {};
     if (has_format(key)) {
@@ -107,33 +117,38 @@ boost::optional<unsigned> VcfRecord::format_cardinality(const KeyType& key) cons
     return result;
 }
 
-const std::vector<VcfRecord::KeyType>& VcfRecord::format() const noexcept
+const std::vector<VcfRecord::KeyType>& VcfRecord::format() const
 {
+    materialise();
     return format_;
 }
 
-unsigned VcfRecord::num_samples() const noexcept
+unsigned VcfRecord::num_samples() const
 {
     return static_cast<unsigned>((has_genotypes()) ? genotypes_.size() : samples_.size());
 }
 
-bool VcfRecord::has_genotypes() const noexcept
+bool VcfRecord::has_genotypes() const
 {
+    materialise();
     return !genotypes_.empty();
 }
 
 unsigned VcfRecord::ploidy(const SampleName& sample) const
 {
+    materialise();
     return static_cast<unsigned>(genotypes_.at(sample).first.size());
 }
 
 bool VcfRecord::is_sample_phased(const SampleName& sample) const
 {
+    materialise();
     return genotypes_.at(sample).second;
 }
 
 bool VcfRecord::is_homozygous(const SampleName& sample) const
 {
+    materialise();
     const auto& genotype = genotypes_.at(sample).first;
     return std::adjacent_find(std::cbegin(genotype), std::cend(genotype),
                               std::not_equal_to<NucleotideSequence>()) == std::cend(genotype);
@@ -146,6 +161,7 @@ bool VcfRecord::is_heterozygous(const SampleName& sample) const
 
 bool VcfRecord::is_homozygous_ref(const SampleName& sample) const
 {
+    materialise();
     const auto& genotype = genotypes_.at(sample).first;
     return std::all_of(std::cbegin(genotype), std::cend(genotype),
                        [this] (const auto& allele) { return allele == ref_; });
@@ -153,18 +169,21 @@ bool VcfRecord::is_homozygous_ref(const SampleName& sample) const
 
 bool VcfRecord::is_homozygous_non_ref(const SampleName& sample) const
 {
+    materialise();
     const auto& genotype = genotypes_.at(sample).first;
     return genotype.front() != ref_ && is_homozygous(sample);
 }
 
 bool VcfRecord::has_ref_allele(const SampleName& sample) const
 {
+    materialise();
     const auto& genotype = genotypes_.at(sample).first;
     return std::find(std::cbegin(genotype), std::cend(genotype), ref_) != std::cend(genotype);
 }
 
 bool VcfRecord::has_alt_allele(const SampleName& sample) const
 {
+    materialise();
     const auto& genotype = genotypes_.at(sample).first;
     return std::find_if_not(std::cbegin(genotype), std::cend(genotype),
                             [this] (const auto& allele) {
@@ -174,6 +193,7 @@ bool VcfRecord::has_alt_allele(const SampleName& sample) const
 
 const std::vector<VcfRecord::ValueType>& VcfRecord::get_sample_value(const SampleName& sample, const KeyType& key) const
 {
+    materialise();
     return (key == vcfspec::format::genotype) ? genotypes_.at(sample).first : samples_.at(sample).at(key);
 }
 
@@ -203,8 +223,24 @@ std::ostream& operator<<(std::ostream& os, const std::vector<T>& v)
 
 } // namespace
 
+void VcfRecord::LazyUnpacker::set_unpacked_fields(const VcfRecord& record, VcfRecord&& unpacked) noexcept
+{
+    record.info_      = std::move(unpacked.info_);
+    record.format_    = std::move(unpacked.format_);
+    record.genotypes_ = std::move(unpacked.genotypes_);
+    record.samples_   = std::move(unpacked.samples_);
+}
+
 // private methods
 
+void VcfRecord::materialise() const
+{
+    if (lazy_unpacker_) {
+        const auto unpacker = std::move(lazy_unpacker_);
+        unpacker->do_unpack(*this);
+    }
+}
+
 std::vector<VcfRecord::SampleName> VcfRecord::samples() const
 {
     std::vector<SampleName> result {};
@@ -236,6 +272,7 @@ std::string VcfRecord::get_allele_number(const NucleotideSequence& allele) const
 
 void VcfRecord::print_info(std::ostream& os) const
 {
+    materialise();
     if (info_.empty()) {
         os << ".";
     } else {
@@ -283,6 +320,7 @@ void VcfRecord::print_other_sample_data(std::ostream& os, const SampleName& samp
 
 void VcfRecord::print_sample_data(std::ostream& os) const
 {
+    materialise();
     if (num_samples() > 0) {
         print(os, format_, ":");
         os << '\t';
@@ -711,6 +749,12 @@ VcfRecord::Builder& VcfRecord::Builder::set_reference_reversion()
     return this->set_info_flag("REVERSION");
 }
 
+VcfRecord::Builder& VcfRecord::Builder::set_lazy_unpacker(std::shared_ptr<const VcfRecord::LazyUnpacker> unpacker)
+{
+    lazy_unpacker_ = std::move(unpacker);
+    return *this;
+}
+
 GenomicRegion::Position VcfRecord::Builder::pos() const noexcept
 {
     return pos_;
@@ -719,7 +763,9 @@ GenomicRegion::Position VcfRecord::Builder::pos() const noexcept
 VcfRecord VcfRecord::Builder::build() const
 {
     if (genotypes_.empty() && samples_.empty()) {
-        return VcfRecord {chrom_, pos_, id_, ref_, alt_, qual_, filter_, info_};
+        VcfRecord result {chrom_, pos_, id_, ref_, alt_, qual_, filter_, info_};
+        result.lazy_unpacker_ = lazy_unpacker_;
+        return result;
     } else {
         return VcfRecord {chrom_, pos_, id_, ref_, alt_, qual_, filter_, info_, format_, genotypes_, samples_};
     }
@@ -728,8 +774,10 @@ VcfRecord VcfRecord::Builder::build() const
 VcfRecord VcfRecord::Builder::build_once() noexcept
 {
     if (genotypes_.empty() && samples_.empty()) {
-        return VcfRecord {std::move(chrom_), pos_, std::move(id_), std::move(ref_),
+        VcfRecord result {std::move(chrom_), pos_, std::move(id_), std::move(ref_),
                           std::move(alt_), qual_, std::move(filter_), std::move(info_)};
+        result.lazy_unpacker_ = std::move(lazy_unpacker_);
+        return result;
     } else {
         return VcfRecord {std::move(chrom_), pos_, std::move(id_), std::move(ref_),
                           std::move(alt_), qual_, std::move(filter_), std::move(info_),
@@ -13,6 +13,7 @@
 #include <utility>
 #include <initializer_list>
 #include <functional>
+#include <memory>
 
 #include <boost/optional.hpp>
 #include <boost/container/flat_map.hpp>
@@ -30,12 +31,14 @@ class VcfRecord : public Comparable<VcfRecord>, public Mappable<VcfRecord>
 {
 public:
     class Builder;
-    
+    class LazyUnpacker;
+
     using NucleotideSequence = std::string;
     using QualityType        = float;
     using SampleName         = std::string;
     using KeyType            = std::string;
     using ValueType          = std::string;
+    using ValueMap           = boost::container::flat_map<KeyType, std::vector<ValueType>>;
     
     VcfRecord() = default;
     
@@ -75,18 +78,19 @@ public:
     boost::optional<QualityType> qual() const noexcept;
     bool has_filter(const KeyType& filter) const noexcept;
     const std::vector<KeyType>& filter() const noexcept;
-    bool has_info(const KeyType& key) const noexcept;
+    bool has_info(const KeyType& key) const;
     std::vector<KeyType> info_keys() const;
     const std::vector<ValueType>& info_value(const KeyType& key) const;
-    
+    const ValueMap& info() const; // avoids the key copies info_keys makes
+
     //
     // Sample releated functions
     //
-    bool has_format(const KeyType& key) const noexcept;
-    boost::optional<unsigned> format_cardinality(const KeyType& key) const noexcept;
-    const std::vector<KeyType>& format() const noexcept;
-    unsigned num_samples() const noexcept;
-    bool has_genotypes() const noexcept;
+    bool has_format(const KeyType& key) const;
+    boost::optional<unsigned> format_cardinality(const KeyType& key) const;
+    const std::vector<KeyType>& format() const;
+    unsigned num_samples() const;
+    bool has_genotypes() const;
     unsigned ploidy(const SampleName& sample) const;
     bool is_sample_phased(const SampleName& sample) const;
     bool is_homozygous(const SampleName& sample) const;
@@ -102,7 +106,6 @@ public:
     
 private:
     using Genotype = std::pair<std::vector<NucleotideSequence>, bool>;
-    using ValueMap = boost::container::flat_map<KeyType, std::vector<ValueType>>;
     
     // mandatory fields
     GenomicRegion region_;
@@ -111,13 +114,18 @@ private:
     std::vector<NucleotideSequence> alt_;
     boost::optional<QualityType> qual_;
     std::vector<KeyType> filter_;
-    ValueMap info_;
-    
+    // INFO and sample columns may be materialised on first access from a lazy unpacker
+    mutable ValueMap info_;
+
     // optional fields
-    std::vector<KeyType> format_;
-    boost::container::flat_map<SampleName, Genotype> genotypes_;
-    boost::container::flat_map<SampleName, ValueMap> samples_;
-    
+    mutable std::vector<KeyType> format_;
+    mutable boost::container::flat_map<SampleName, Genotype> genotypes_;
+    mutable boost::container::flat_map<SampleName, ValueMap> samples_;
+
+    mutable std::shared_ptr<const LazyUnpacker> lazy_unpacker_;
+
+    void materialise() const;
+
     std::string get_allele_number(const NucleotideSequence& allele) const;
     
     std::vector<SampleName> samples() const;
@@ -127,6 +135,28 @@ private:
     void print_sample_data(std::ostream& os) const;
 };
 
+/*
+ Materialises the INFO and sample columns of a record read with
+ UnpackPolicy::lazy when one of them is first accessed. Copies of a lazy
+ record share one unpacker, so concurrent first access from multiple threads
+ is not safe; records that will be shared between threads should be read
+ eagerly or have a field touched first.
+ */
+class VcfRecord::LazyUnpacker
+{
+public:
+    virtual ~LazyUnpacker() = default;
+
+protected:
+    // Moves the unpacked INFO and sample columns of the donor into the target
+    static void set_unpacked_fields(const VcfRecord& record, VcfRecord&& unpacked) noexcept;
+
+private:
+    virtual void do_unpack(const VcfRecord& record) const = 0;
+
+    friend class VcfRecord;
+};
+
 // non-member functions
 
 std::vector<VcfRecord::NucleotideSequence> get_genotype(const VcfRecord& record, const VcfRecord::SampleName& sample);
@@ -221,7 +251,9 @@ public:
     Builder& set_somatic();
     Builder& set_denovo();
     Builder& set_reference_reversion();
-    
+
+    Builder& set_lazy_unpacker(std::shared_ptr<const VcfRecord::LazyUnpacker> unpacker);
+
     GenomicRegion::Position pos() const noexcept;
     
     VcfRecord build() const;
@@ -239,6 +271,7 @@ private:
     decltype(VcfRecord::format_) format_ = {};
     decltype(VcfRecord::genotypes_) genotypes_ = {};
     decltype(VcfRecord::samples_) samples_ = {};
+    std::shared_ptr<const VcfRecord::LazyUnpacker> lazy_unpacker_ = nullptr;
 };
 
 template <typename String1, typename String2, typename Sequence1, typename Sequence2,
@@ -12,12 +12,15 @@
 #include <functional>
 #include <stdexcept>
 #include <numeric>
+#include <thread>
 
 #include "htslib/vcf.h"
 #include "htslib/tbx.h"
 
 #include "basics/contig_region.hpp"
 #include "basics/genomic_region.hpp"
+#include "utils/parallel_sort.hpp"
+#include "utils/thread_pool.hpp"
 #include "vcf_spec.hpp"
 
 namespace octopus {
@@ -117,7 +120,12 @@ void sort(const VcfReader& src, VcfWriter& dst)
         dst << src.fetch_header();
     }
     auto records = src.fetch_records();
-    std::sort(std::begin(records), std::end(records));
+    if (records.size() >= minParallelSortSize) {
+        ThreadPool sort_workers {std::thread::hardware_concurrency()};
+        parallel_sort(std::begin(records), std::end(records), std::less<> {}, sort_workers);
+    } else {
+        std::sort(std::begin(records), std::end(records));
+    }
     dst << records;
 }
 
@@ -378,6 +386,90 @@ auto make_record_iterator_queue(const std::vector<VcfReader>& sources, const std
     return result;
 }
 
+std::size_t count_records(const ReaderContigRecordCountMap& counts, const std::string& contig)
+{
+    return std::accumulate(std::cbegin(counts), std::cend(counts), std::size_t {0},
+                           [&contig] (const auto curr, const auto& reader_counts) {
+                               return curr + reader_counts.second.at(contig);
+                           });
+}
+
+// VcfReader::fetch_records is synchronised, unlike the lazy iterators, so
+// concurrent contig merges batch-fetch their inputs up front
+auto fetch_contig_records(const std::vector<VcfReader>& sources, const std::string& contig,
+                          const ReaderContigRecordCountMap& reader_contig_counts)
+{
+    std::vector<VcfReader::RecordContainer> result {};
+    result.reserve(sources.size());
+    for (const auto& reader : sources) {
+        if (reader_contig_counts.at(reader).at(contig) > 0) {
+            result.push_back(reader.fetch_records(contig, VcfReader::UnpackPolicy::all));
+        }
+    }
+    return result;
+}
+
+using RecordBatchIteratorPair = std::pair<VcfReader::RecordContainer::iterator, VcfReader::RecordContainer::iterator>;
+
+struct RecordBatchCompare
+{
+    bool operator()(const RecordBatchIteratorPair& lhs, const RecordBatchIteratorPair& rhs) const
+    {
+        return *lhs.first > *rhs.first;
+    }
+};
+
+VcfReader::RecordContainer merge_contig_records(std::vector<VcfReader::RecordContainer>& batches)
+{
+    const auto num_records = std::accumulate(std::cbegin(batches), std::cend(batches), std::size_t {0},
+                                             [] (const auto curr, const auto& batch) { return curr + batch.size(); });
+    VcfReader::RecordContainer result {};
+    result.reserve(num_records);
+    std::priority_queue<RecordBatchIteratorPair, std::vector<RecordBatchIteratorPair>, RecordBatchCompare> record_queue {};
+    for (auto& batch : batches) {
+        if (!batch.empty()) {
+            record_queue.emplace(std::begin(batch), std::end(batch));
+        }
+    }
+    while (!record_queue.empty()) {
+        auto p = record_queue.top();
+        record_queue.pop();
+        result.push_back(std::move(*p.first));
+        ++p.first;
+        if (p.first != p.second) {
+            record_queue.push(std::move(p));
+        }
+    }
+    return result;
+}
+
+void parallel_merge(const std::vector<VcfReader>& sources, VcfWriter& dst,
+                    const std::vector<std::string>& contigs,
+                    const ReaderContigRecordCountMap& reader_contig_counts)
+{
+    ThreadPool merge_workers {std::min(static_cast<std::size_t>(std::thread::hardware_concurrency()), contigs.size())};
+    // Bounding the pending merges to the worker count caps the number of
+    // merged contig buffers held in memory while the writer catches up
+    const auto max_pending_merges = std::max(merge_workers.size(), std::size_t {1});
+    std::deque<std::future<VcfReader::RecordContainer>> pending_merges {};
+    auto contig_itr = std::cbegin(contigs);
+    while (contig_itr != std::cend(contigs) || !pending_merges.empty()) {
+        for (; contig_itr != std::cend(contigs) && pending_merges.size() < max_pending_merges; ++contig_itr) {
+            const auto& contig = *contig_itr;
+            if (count_records(reader_contig_counts, contig) > 0) {
+                pending_merges.push_back(merge_workers.push([&sources, &reader_contig_counts, &contig] () {
+                    auto batches = fetch_contig_records(sources, contig, reader_contig_counts);
+                    return merge_contig_records(batches);
+                }));
+            }
+        }
+        if (!pending_merges.empty()) {
+            dst << pending_merges.front().get();
+            pending_merges.pop_front();
+        }
+    }
+}
+
 void merge(const std::vector<VcfReader>& sources, VcfWriter& dst,
            const std::vector<std::string>& contigs)
 {
@@ -398,6 +490,8 @@ void merge(const std::vector<VcfReader>& sources, VcfWriter& dst,
             one_step_merge(sources, dst, contigs, reader_contig_counts);
         } else if (sources.size() == 2) {
             merge_pair(sources.front(), sources.back(), dst, contigs, reader_contig_counts);
+        } else if (contigs.size() > 1 && std::thread::hardware_concurrency() > 1) {
+            parallel_merge(sources, dst, contigs, reader_contig_counts);
         } else {
             for (const auto& contig : contigs) {
                 auto record_queue = make_record_iterator_queue(sources, contig);
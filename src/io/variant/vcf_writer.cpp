@@ -17,10 +17,13 @@ namespace octopus {
 
 namespace {
 
-auto make_vcf_writer(boost::optional<VcfWriter::Path> path = boost::none)
+auto make_vcf_writer(boost::optional<VcfWriter::Path> path = boost::none,
+                     VcfWriter::Compression compression = VcfWriter::Compression::bgzf)
 {
     if (path) {
-        return std::make_unique<HtslibBcfFacade>(std::move(*path), HtslibBcfFacade::Mode::write);
+        const auto mode = compression == VcfWriter::Compression::none
+            ? HtslibBcfFacade::Mode::uncompressed_write : HtslibBcfFacade::Mode::write;
+        return std::make_unique<HtslibBcfFacade>(std::move(*path), mode);
     } else {
         return std::make_unique<HtslibBcfFacade>();
     }
@@ -31,12 +34,14 @@ auto make_vcf_writer(boost::optional<VcfWriter::Path> path = boost::none)
 VcfWriter::VcfWriter()
 : file_path_ {}
 , writer_ {make_vcf_writer()}
+, compression_ {Compression::bgzf}
 , is_header_written_ {false}
 {}
 
-VcfWriter::VcfWriter(Path file_path)
+VcfWriter::VcfWriter(Path file_path, const Compression compression)
 : file_path_ {std::move(file_path)}
 , writer_ {nullptr}
+, compression_ {compression}
 , is_header_written_ {false}
 {
     using namespace boost::filesystem;
@@ -59,7 +64,7 @@ VcfWriter::VcfWriter(Path file_path)
     } else if (exists(index_path2)) {
         remove(index_path2);
     }
-    writer_ = make_vcf_writer(*file_path_);
+    writer_ = make_vcf_writer(*file_path_, compression_);
 }
 
 VcfWriter::VcfWriter(const VcfHeader& header)
@@ -68,8 +73,8 @@ VcfWriter::VcfWriter(const VcfHeader& header)
     write(std::move(header));
 }
 
-VcfWriter::VcfWriter(Path file_path, const VcfHeader& header)
-: VcfWriter {std::move(file_path)}
+VcfWriter::VcfWriter(Path file_path, const VcfHeader& header, const Compression compression)
+: VcfWriter {std::move(file_path), compression}
 {
     write(std::move(header));
 }
@@ -78,6 +83,7 @@ VcfWriter::VcfWriter(VcfWriter&& other)
 {
     std::lock_guard<std::mutex> lock {other.mutex_};
     file_path_         = std::move(other.file_path_);
+    compression_       = other.compression_;
     is_header_written_ = other.is_header_written_;
     writer_            = std::move(other.writer_);
 }
@@ -88,6 +94,7 @@ VcfWriter& VcfWriter::operator=(VcfWriter&& other)
         std::unique_lock<std::mutex> lock_lhs {mutex_, std::defer_lock}, lock_rhs {other.mutex_, std::defer_lock};
         std::lock(lock_lhs, lock_rhs);
         file_path_         = std::move(other.file_path_);
+        compression_       = other.compression_;
         is_header_written_ = other.is_header_written_;
         writer_            = std::move(other.writer_);
     }
@@ -113,6 +120,7 @@ void swap(VcfWriter& lhs, VcfWriter& rhs) noexcept
     std::lock_guard<std::mutex> lock_lhs {lhs.mutex_, std::adopt_lock}, lock_rhs {rhs.mutex_, std::adopt_lock};
     using std::swap;
     swap(lhs.file_path_, rhs.file_path_);
+    swap(lhs.compression_, rhs.compression_);
     swap(lhs.is_header_written_, rhs.is_header_written_);
     swap(lhs.writer_, rhs.writer_);
 }
@@ -127,7 +135,7 @@ void VcfWriter::open(Path file_path)
 {
     std::lock_guard<std::mutex> lock {mutex_};
     file_path_         = std::move(file_path);
-    writer_            = make_vcf_writer(*file_path_);
+    writer_            = make_vcf_writer(*file_path_, compression_);
     is_header_written_ = false;
 }
 
@@ -166,9 +174,18 @@ void VcfWriter::write(const VcfRecord& record)
     }
 }
 
+void VcfWriter::set_threads(const unsigned num_threads)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    if (writer_) {
+        writer_->set_threads(num_threads);
+    }
+}
+
 bool VcfWriter::can_write_index() const noexcept
 {
-    return file_path_ && is_header_written_
+    // uncompressed BCF cannot carry a CSI index; readers stream it instead
+    return file_path_ && is_header_written_ && compression_ == Compression::bgzf
            && is_indexable(*file_path_) && boost::filesystem::exists(*file_path_);
 }
 
@@ -26,10 +26,14 @@ class VcfWriter
 public:
     using Path = boost::filesystem::path;
     
+    // BCF output is BGZF-compressed by default; uncompressed writing skips
+    // the compressor (and indexing), for temporaries that never leave the run
+    enum class Compression { bgzf, none };
+    
     VcfWriter();
-    VcfWriter(Path file_path);
+    VcfWriter(Path file_path, Compression compression = Compression::bgzf);
     VcfWriter(const VcfHeader& header);
-    VcfWriter(Path file_path, const VcfHeader& header);
+    VcfWriter(Path file_path, const VcfHeader& header, Compression compression = Compression::bgzf);
     
     VcfWriter(const VcfWriter&)            = delete;
     VcfWriter& operator=(const VcfWriter&) = delete;
@@ -50,10 +54,15 @@ public:
     
     void write(const VcfHeader& header);
     void write(const VcfRecord& record);
-    
+
+    // Compresses output blocks on a pool of worker threads; a no-op for
+    // uncompressed output
+    void set_threads(unsigned num_threads);
+
 private:
     boost::optional<Path> file_path_;
     std::unique_ptr<HtslibBcfFacade> writer_;
+    Compression compression_;
     bool is_header_written_;
     mutable std::mutex mutex_;
     
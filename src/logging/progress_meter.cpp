@@ -5,6 +5,7 @@
 
 #include <sstream>
 #include <algorithm>
+#include <iterator>
 #include <functional>
 #include <cmath>
 #include <utility>
@@ -59,6 +60,9 @@ unsigned calculate_position_tab_length(const T& region)
     return std::max(18u, max_position_str_length(region));
 }
 
+constexpr std::size_t numStagingShards {16};
+constexpr std::chrono::milliseconds aggregationInterval {100};
+
 } // namespace
 
 ProgressMeter::ProgressMeter(InputRegionMap regions)
@@ -75,7 +79,13 @@ ProgressMeter::ProgressMeter(InputRegionMap regions)
 , position_tab_length_ {}
 , block_compute_times_ {}
 , log_ {}
+, staging_shards_ {}
+, num_staged_ {0}
+, aggregator_stop_requested_ {false}
 {
+    staging_shards_.reserve(numStagingShards);
+    std::generate_n(std::back_inserter(staging_shards_), numStagingShards,
+                    [] () { return std::make_unique<StagingShard>(); });
     for (auto& p : target_regions_) {
         auto covered_regions = extract_covered_regions(p.second);
         p.second.clear();
@@ -95,6 +105,8 @@ ProgressMeter::ProgressMeter(GenomicRegion region)
 
 ProgressMeter::ProgressMeter(ProgressMeter&& other)
 {
+    other.stop_aggregator();
+    other.drain_staged();
     std::lock_guard<std::mutex> lock {other.mutex_};
     using std::move;
     target_regions_       = move(other.target_regions_);
@@ -111,12 +123,20 @@ ProgressMeter::ProgressMeter(ProgressMeter&& other)
     done_                 = move(other.done_);
     position_tab_length_  = move(other.position_tab_length_);
     block_compute_times_  = move(other.block_compute_times_);
+    telemetry_            = move(other.telemetry_);
     log_                  = move(other.log_);
+    staging_shards_       = move(other.staging_shards_);
+    num_staged_.store(other.num_staged_.load());
+    aggregator_stop_requested_ = false;
 }
 
 ProgressMeter& ProgressMeter::operator=(ProgressMeter&& other)
 {
     if (this != &other) {
+        stop_aggregator();
+        drain_staged();
+        other.stop_aggregator();
+        other.drain_staged();
         std::unique_lock<std::mutex> lock_lhs {mutex_, std::defer_lock}, lock_rhs {other.mutex_, std::defer_lock};
         std::lock(lock_lhs, lock_rhs);
         using std::move;
@@ -134,7 +154,11 @@ ProgressMeter& ProgressMeter::operator=(ProgressMeter&& other)
         done_                 = move(other.done_);
         position_tab_length_  = move(other.position_tab_length_);
         block_compute_times_  = move(other.block_compute_times_);
+        telemetry_            = move(other.telemetry_);
         log_                  = move(other.log_);
+        staging_shards_       = move(other.staging_shards_);
+        num_staged_.store(other.num_staged_.load());
+        aggregator_stop_requested_ = false;
     }
     return *this;
 }
@@ -224,6 +248,8 @@ auto estimate_ttc(const std::chrono::system_clock::time_point now,
 
 ProgressMeter::~ProgressMeter()
 {
+    stop_aggregator();
+    drain_staged();
     if (!done_ && !target_regions_.empty() && num_bp_completed_ > 0) {
         const TimeInterval duration {start_, std::chrono::system_clock::now()};
         const auto time_taken = to_string(duration);
@@ -242,6 +268,12 @@ void ProgressMeter::set_max_tick_size(double percent)
     curr_tick_size_ = std::min(max_tick_size_, curr_tick_size_);
 }
 
+void ProgressMeter::set_telemetry_file(const boost::filesystem::path& telemetry_log)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    telemetry_.open(telemetry_log.string(), std::ios_base::app);
+}
+
 void ProgressMeter::start()
 {
     if (!target_regions_.empty()) {
@@ -250,6 +282,7 @@ void ProgressMeter::start()
     }
     start_ = std::chrono::system_clock::now();
     last_tick_ = start_;
+    start_aggregator();
 }
 
 void ProgressMeter::resume()
@@ -264,6 +297,8 @@ void ProgressMeter::pause()
 
 void ProgressMeter::stop()
 {
+    stop_aggregator();
+    drain_staged();
     if (!done_ && !target_regions_.empty()) {
         const TimeInterval duration {start_, std::chrono::system_clock::now()};
         const auto time_taken = to_string(duration);
@@ -296,12 +331,15 @@ void ProgressMeter::reset()
 
 void ProgressMeter::log_completed(const GenomicRegion& region)
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    const auto new_bp_processed = merge(region);
-    const auto new_percent_done = percent_completed(new_bp_processed, num_bp_to_search_);
-    num_bp_completed_ += new_bp_processed;
-    percent_until_tick_ -= new_percent_done;
-    if (percent_until_tick_ <= 0) output_log(region);
+    auto& shard = staging_shard();
+    {
+        std::lock_guard<std::mutex> lock {shard.mutex};
+        shard.regions.push_back(region);
+    }
+    num_staged_.fetch_add(1, std::memory_order_release);
+    if (!aggregator_.joinable()) {
+        drain_staged(); // no aggregation thread, so do the work inline as before
+    }
 }
 
 void ProgressMeter::log_completed(const GenomicRegion::ContigName& contig)
@@ -315,6 +353,65 @@ void ProgressMeter::log_completed(const GenomicRegion::ContigName& contig)
 
 // private methods
 
+ProgressMeter::StagingShard& ProgressMeter::staging_shard()
+{
+    const auto shard_idx = std::hash<std::thread::id> {}(std::this_thread::get_id()) % staging_shards_.size();
+    return *staging_shards_[shard_idx];
+}
+
+void ProgressMeter::start_aggregator()
+{
+    if (aggregator_.joinable()) return;
+    aggregator_stop_requested_ = false;
+    aggregator_ = std::thread {[this] () {
+        std::unique_lock<std::mutex> lock {aggregator_mutex_};
+        while (!aggregator_stop_requested_) {
+            aggregator_condition_.wait_for(lock, aggregationInterval);
+            drain_staged();
+        }
+    }};
+}
+
+void ProgressMeter::stop_aggregator()
+{
+    if (!aggregator_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock {aggregator_mutex_};
+        aggregator_stop_requested_ = true;
+    }
+    aggregator_condition_.notify_all();
+    aggregator_.join();
+}
+
+void ProgressMeter::drain_staged()
+{
+    if (num_staged_.load(std::memory_order_acquire) == 0) return;
+    std::vector<GenomicRegion> staged {};
+    for (auto& shard : staging_shards_) {
+        std::lock_guard<std::mutex> lock {shard->mutex};
+        staged.insert(std::end(staged),
+                      std::make_move_iterator(std::begin(shard->regions)),
+                      std::make_move_iterator(std::end(shard->regions)));
+        shard->regions.clear();
+    }
+    if (staged.empty()) return;
+    num_staged_.fetch_sub(staged.size(), std::memory_order_release);
+    std::lock_guard<std::mutex> lock {mutex_};
+    for (const auto& region : staged) {
+        apply_completed(region);
+    }
+}
+
+void ProgressMeter::apply_completed(const GenomicRegion& region)
+{
+    const auto new_bp_processed = merge(region);
+    const auto new_percent_done = percent_completed(new_bp_processed, num_bp_to_search_);
+    num_bp_completed_ += new_bp_processed;
+    percent_until_tick_ -= new_percent_done;
+    if (percent_until_tick_ <= 0) output_log(region);
+    if (telemetry_.is_open()) write_telemetry(region);
+}
+
 ProgressMeter::RegionSizeType ProgressMeter::merge(const GenomicRegion& region)
 {
     RegionSizeType result {0};
@@ -431,6 +528,38 @@ void ProgressMeter::output_log(const GenomicRegion& region)
     update_tick_size();
 }
 
+void ProgressMeter::write_telemetry(const GenomicRegion& region)
+{
+    const auto now = std::chrono::system_clock::now();
+    const auto run_seconds = std::chrono::duration<double>(now - start_).count();
+    const auto bases_per_second = run_seconds > 0 ? num_bp_completed_ / run_seconds : 0.0;
+    const auto num_bp_remaining = num_bp_to_search_ - num_bp_completed_;
+    const auto eta_seconds = bases_per_second > 0 ? num_bp_remaining / bases_per_second : 0.0;
+    const auto& contig = region.contig_name();
+    RegionSizeType contig_completed_bp {0}, contig_total_bp {0};
+    const auto completed_itr = completed_regions_.find(contig);
+    if (completed_itr != std::cend(completed_regions_)) {
+        contig_completed_bp = sum_region_sizes(completed_itr->second);
+    }
+    const auto target_itr = target_regions_.find(contig);
+    if (target_itr != std::cend(target_regions_)) {
+        contig_total_bp = sum_region_sizes(target_itr->second);
+    }
+    telemetry_ << "{\"time\": " << std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count()
+               << ", \"contig\": \"" << contig << '"'
+               << ", \"begin\": " << region.begin()
+               << ", \"end\": " << region.end()
+               << ", \"completed_bp\": " << num_bp_completed_
+               << ", \"total_bp\": " << num_bp_to_search_
+               << ", \"percent\": " << percent_completed(num_bp_completed_, num_bp_to_search_)
+               << ", \"bases_per_second\": " << bases_per_second
+               << ", \"eta_seconds\": " << eta_seconds
+               << ", \"contig_completed_bp\": " << contig_completed_bp
+               << ", \"contig_total_bp\": " << contig_total_bp
+               << "}\n";
+    telemetry_.flush();
+}
+
 std::string ProgressMeter::position_pad(const GenomicRegion& completed_region) const
 {
     assert(position_tab_length_ > 3);
@@ -8,7 +8,15 @@
 #include <cstddef>
 #include <chrono>
 #include <deque>
+#include <vector>
+#include <memory>
+#include <fstream>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
+#include <boost/filesystem/path.hpp>
 
 #include "config/common.hpp"
 #include "basics/contig_region.hpp"
@@ -34,6 +42,9 @@ public:
     ~ProgressMeter();
     
     void set_max_tick_size(double percent);
+    // Appends a machine readable (JSON lines) throughput record to the given
+    // file on every completed region
+    void set_telemetry_file(const boost::filesystem::path& telemetry_log);
     
     void start();
     void resume();
@@ -60,13 +71,36 @@ private:
     bool done_;
     std::size_t position_tab_length_;
     mutable std::deque<DurationUnits> block_compute_times_;
+    std::ofstream telemetry_;
     mutable std::mutex mutex_;
     logging::InfoLogger log_;
     
+    // Workers only append completed regions to a thread-sharded staging buffer;
+    // an aggregation thread periodically drains the shards and does the region
+    // merging and logging, so log_completed never touches the main mutex
+    struct StagingShard
+    {
+        std::mutex mutex;
+        std::vector<GenomicRegion> regions;
+    };
+    std::vector<std::unique_ptr<StagingShard>> staging_shards_;
+    std::atomic<std::size_t> num_staged_;
+    std::thread aggregator_;
+    std::mutex aggregator_mutex_;
+    std::condition_variable aggregator_condition_;
+    bool aggregator_stop_requested_;
+    
     RegionSizeType merge(const GenomicRegion& region);
     
+    StagingShard& staging_shard();
+    void start_aggregator();
+    void stop_aggregator();
+    void drain_staged();
+    void apply_completed(const GenomicRegion& region);
+    
     void write_header();
     void output_log(const GenomicRegion& region);
+    void write_telemetry(const GenomicRegion& region);
     
     std::string position_pad(const GenomicRegion& completed_region) const;
     std::string completed_pad(const std::string& percent_completed, std::size_t position_tick_size) const;
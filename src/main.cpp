@@ -5,6 +5,13 @@
 #include <cstdlib>
 #include <chrono>
 #include <exception>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
 
 #include "config/config.hpp"
 #include "config/common.hpp"
@@ -13,6 +20,7 @@
 #include "config/option_parser.hpp"
 #include "config/option_collation.hpp"
 #include "core/octopus.hpp"
+#include "io/reference/reference_genome.hpp"
 #include "utils/timing.hpp"
 #include "utils/system_utils.hpp"
 #include "utils/string_utils.hpp"
@@ -66,6 +74,126 @@ void sanity_check(const OptionMap& options)
     }
 }
 
+int run_calling(OptionMap& options, const std::string& command, boost::optional<ReferenceGenome> reference,
+                boost::optional<InputRegionMap> search_regions = boost::none)
+{
+    try {
+        logging::InfoLogger info_log {};
+        const auto start = std::chrono::system_clock::now();
+        sanity_check(options);
+        auto components = collate_genome_calling_components(options, std::move(reference), std::move(search_regions));
+        auto end = std::chrono::system_clock::now();
+        using utils::TimeInterval;
+        stream(info_log) << "Done initialising calling components in " << TimeInterval {start, end};
+        options.clear();
+        if (validate(components)) {
+            run_octopus(components, command);
+        }
+    } catch (const Error& e) {
+        log_error(e);
+        return EXIT_FAILURE;
+    } catch (const std::exception& e) {
+        log_error(e);
+        return EXIT_FAILURE;
+    } catch (...) {
+        log_unknown_error();
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+auto tokenise_command_line(const std::string& line)
+{
+    std::istringstream ss {line};
+    std::vector<std::string> result {};
+    std::string token;
+    while (ss >> token) {
+        result.push_back(std::move(token));
+    }
+    return result;
+}
+
+bool is_comment_line(const std::string& line) noexcept
+{
+    return line.empty() || line.front() == '#';
+}
+
+// Runs each command line in the batch script as its own job, in order, keeping
+// the loaded reference warm between jobs that share a reference path so that
+// only the first such job pays the reference and repeat index setup cost.
+// Resolved search regions are likewise reused between jobs that request the
+// same regions, so a cohort called sample by sample over one target set only
+// parses and coalesces the region files once
+int run_batch(const OptionMap& batch_options, const char* program_path)
+{
+    logging::InfoLogger info_log {};
+    const auto script_path = get_batch_script_path(batch_options);
+    std::ifstream script {script_path.string()};
+    if (!script) {
+        logging::ErrorLogger error_log {};
+        stream(error_log) << "Could not open batch script " << script_path;
+        return EXIT_FAILURE;
+    }
+    boost::optional<ReferenceGenome> warm_reference {};
+    boost::optional<boost::filesystem::path> warm_reference_path {};
+    boost::optional<InputRegionMap> warm_search_regions {};
+    boost::optional<std::string> warm_search_region_signature {};
+    int result {EXIT_SUCCESS};
+    std::size_t job_number {0};
+    std::string line;
+    while (std::getline(script, line)) {
+        if (is_comment_line(line)) continue;
+        ++job_number;
+        stream(info_log) << "Starting batch job " << job_number << ": " << line;
+        OptionMap job_options;
+        try {
+            const auto tokens = tokenise_command_line(line);
+            std::vector<const char*> job_argv {program_path};
+            job_argv.reserve(tokens.size() + 1);
+            for (const auto& token : tokens) {
+                job_argv.push_back(token.c_str());
+            }
+            job_options = parse_options(static_cast<int>(job_argv.size()), job_argv.data());
+        } catch (const Error& e) {
+            log_error(e);
+            result = EXIT_FAILURE;
+            continue;
+        } catch (const std::exception& e) {
+            log_error(e);
+            result = EXIT_FAILURE;
+            continue;
+        }
+        if (!is_run_command(job_options)) continue;
+        try {
+            const auto reference_path = get_reference_path(job_options);
+            if (!warm_reference_path || *warm_reference_path != reference_path) {
+                warm_reference.emplace(options::make_reference(job_options));
+                warm_reference_path = reference_path;
+                warm_search_regions = boost::none;
+                warm_search_region_signature = boost::none;
+            }
+            const auto search_region_signature = options::get_search_region_signature(job_options);
+            if (!warm_search_regions || *warm_search_region_signature != search_region_signature) {
+                warm_search_regions = options::get_search_regions(job_options, *warm_reference);
+                warm_search_region_signature = search_region_signature;
+            }
+            if (run_calling(job_options, line, ReferenceGenome {*warm_reference}, warm_search_regions) != EXIT_SUCCESS) {
+                result = EXIT_FAILURE;
+            }
+        } catch (const Error& e) {
+            log_error(e);
+            result = EXIT_FAILURE;
+        } catch (const std::exception& e) {
+            log_error(e);
+            result = EXIT_FAILURE;
+        } catch (...) {
+            log_unknown_error();
+            result = EXIT_FAILURE;
+        }
+    }
+    return result;
+}
+
 } // namespace
 
 int main(const int argc, const char** argv)
@@ -82,22 +210,29 @@ int main(const int argc, const char** argv)
         log_program_end();
         return EXIT_FAILURE;
     }
-    if (is_run_command(options)) {
+    if (is_batch_run(options)) {
         try {
             init_common(options);
             log_program_startup();
-            logging::InfoLogger info_log {};
-            const auto start = std::chrono::system_clock::now();
-            sanity_check(options);
-            auto components = collate_genome_calling_components(options);
-            auto end = std::chrono::system_clock::now();
-            using utils::TimeInterval;
-            stream(info_log) << "Done initialising calling components in " << TimeInterval {start, end};
-            options.clear();
-            if (validate(components)) {
-                run_octopus(components, to_string(argc, argv));
-            }
+            const auto result = run_batch(options, argv[0]);
+            log_program_end();
+            return result;
+        } catch (const Error& e) {
+            return log_exception(e);
+        } catch (const std::exception& e) {
+            return log_exception(e);
+        } catch (...) {
+            log_unknown_error();
+            log_program_end();
+            return EXIT_FAILURE;
+        }
+    } else if (is_run_command(options)) {
+        try {
+            init_common(options);
+            log_program_startup();
+            const auto result = run_calling(options, to_string(argc, argv), boost::none);
             log_program_end();
+            return result;
         } catch (const Error& e) {
             return log_exception(e);
         } catch (const std::exception& e) {
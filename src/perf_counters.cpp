@@ -0,0 +1,135 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "perf_counters.hpp"
+
+#if defined(PROFILE_HARDWARE_COUNTERS) && defined(__linux__)
+
+#include <array>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#endif
+
+namespace octopus {
+
+HardwareCounts& operator+=(HardwareCounts& lhs, const HardwareCounts& rhs) noexcept
+{
+    lhs.cycles        += rhs.cycles;
+    lhs.instructions  += rhs.instructions;
+    lhs.cache_misses  += rhs.cache_misses;
+    lhs.branch_misses += rhs.branch_misses;
+    return lhs;
+}
+
+HardwareCounts operator-(HardwareCounts lhs, const HardwareCounts& rhs) noexcept
+{
+    lhs.cycles        -= rhs.cycles;
+    lhs.instructions  -= rhs.instructions;
+    lhs.cache_misses  -= rhs.cache_misses;
+    lhs.branch_misses -= rhs.branch_misses;
+    return lhs;
+}
+
+bool hardware_counter_profiling_enabled() noexcept
+{
+#if defined(PROFILE_HARDWARE_COUNTERS) && defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if defined(PROFILE_HARDWARE_COUNTERS) && defined(__linux__)
+
+namespace {
+
+constexpr std::size_t numCounters {4};
+
+int open_counter(const std::uint64_t config, const int group_fd) noexcept
+{
+    ::perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof(attr);
+    attr.config         = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP;
+    return static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+// One counter group per thread, read in a single syscall. Opened on the
+// thread's first read and closed when the thread exits; if the host refuses
+// any event (e.g. perf_event_paranoid, or a VM without a PMU) the whole group
+// is abandoned and every read from this thread returns zeros
+class ThreadCounterGroup
+{
+public:
+    ThreadCounterGroup() noexcept
+    {
+        static constexpr std::array<std::uint64_t, numCounters> configs {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+        };
+        fds_.fill(-1);
+        for (std::size_t i {0}; i < numCounters; ++i) {
+            fds_[i] = open_counter(configs[i], fds_.front());
+            if (fds_[i] < 0) {
+                close_all();
+                return;
+            }
+        }
+    }
+
+    ThreadCounterGroup(const ThreadCounterGroup&)            = delete;
+    ThreadCounterGroup& operator=(const ThreadCounterGroup&) = delete;
+
+    ~ThreadCounterGroup() noexcept { close_all(); }
+
+    HardwareCounts read() const noexcept
+    {
+        HardwareCounts result {};
+        if (fds_.front() < 0) return result;
+        struct GroupReadBuffer
+        {
+            std::uint64_t nr;
+            std::uint64_t values[numCounters];
+        } buffer;
+        if (::read(fds_.front(), &buffer, sizeof(buffer)) != sizeof(buffer)
+            || buffer.nr != numCounters) {
+            return result;
+        }
+        result.cycles        = buffer.values[0];
+        result.instructions  = buffer.values[1];
+        result.cache_misses  = buffer.values[2];
+        result.branch_misses = buffer.values[3];
+        return result;
+    }
+
+private:
+    std::array<int, numCounters> fds_;
+
+    void close_all() noexcept
+    {
+        for (auto& fd : fds_) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+    }
+};
+
+} // namespace
+
+HardwareCounts read_hardware_counters() noexcept
+{
+    thread_local const ThreadCounterGroup counters {};
+    return counters.read();
+}
+
+#endif
+
+} // namespace octopus
@@ -0,0 +1,47 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef perf_counters_hpp
+#define perf_counters_hpp
+
+//#define PROFILE_HARDWARE_COUNTERS
+
+#include <cstdint>
+
+namespace octopus {
+
+// Opt-in sampling of hardware performance counters. When
+// PROFILE_HARDWARE_COUNTERS is defined on Linux, each calling thread opens a
+// perf_event group counting cycles, instructions, cache misses, and branch
+// misses, and the per-stage instrumentation reads the group around each stage
+// scope so regressions that wall time cannot attribute - cache thrashing,
+// branch-heavy rewrites, allocator churn - show up against the stage that
+// caused them. Counting is per thread and excludes the kernel; counters that
+// the host cannot provide read as zero. Without the flag the reads compile to
+// nothing and no file descriptors are opened
+
+struct HardwareCounts
+{
+    std::uint64_t cycles {0}, instructions {0}, cache_misses {0}, branch_misses {0};
+};
+
+HardwareCounts& operator+=(HardwareCounts& lhs, const HardwareCounts& rhs) noexcept;
+HardwareCounts operator-(HardwareCounts lhs, const HardwareCounts& rhs) noexcept;
+
+bool hardware_counter_profiling_enabled() noexcept;
+
+#if defined(PROFILE_HARDWARE_COUNTERS) && defined(__linux__)
+
+// The cumulative counts for the calling thread; deltas between two reads
+// bracket a scope. The thread's counter group is opened on its first read
+HardwareCounts read_hardware_counters() noexcept;
+
+#else
+
+inline HardwareCounts read_hardware_counters() noexcept { return {}; }
+
+#endif
+
+} // namespace octopus
+
+#endif
@@ -34,6 +34,7 @@ const ReadPipe& BufferedReadPipe::source() const noexcept
 
 void BufferedReadPipe::clear() noexcept
 {
+    prefetch_ = std::future<PrefetchedBuffer> {}; // joins any in-flight prefetch
     buffer_.clear();
     buffered_region_ = boost::none;
     hints_.clear();
@@ -69,7 +70,8 @@ bool BufferedReadPipe::is_cached(const GenomicRegion& region) const noexcept
 
 void BufferedReadPipe::setup_buffer(const GenomicRegion& request) const
 {
-    if (!is_cached(request)) {
+    if (is_cached(request)) return;
+    if (!try_install_prefetched_buffer(request)) {
         auto max_region = get_max_fetch_region(request);
         bool unchecked_fetch {false};
         if (can_make_unchecked_fetch()) {
@@ -79,31 +81,75 @@ void BufferedReadPipe::setup_buffer(const GenomicRegion& request) const
             buffered_region_ = source_.get().read_manager().find_covered_subregion(max_region, config_.max_buffer_size);
         }
         buffer_ = source_.get().fetch_reads(expand(*buffered_region_, config_.fetch_expansion));
-        if (unchecked_fetch) {
-            const auto fetch_size = count_reads(buffer_);
-            if (fetch_size > config_.max_buffer_size) {
-                if (default_unchecked_fetch_overflowed_) {
-                    adjusted_unchecked_fetch_overflowed_ = true;
-                } else {
-                    default_unchecked_fetch_overflowed_ = true;
-                }
-                // Clear buffer of reads to rhs of request
-                for (auto& p : buffer_) {
-                    const auto last_overlapped = find_first_after(p.second, request);
-                    p.second.erase(last_overlapped, std::cend(p.second));
-                }
-                buffered_region_ = request;
-            }
-        } else {
-            if (min_checked_fetch_size_) {
-                min_checked_fetch_size_ = std::min(size(*buffered_region_), *min_checked_fetch_size_);
+        record_fetch(request, unchecked_fetch);
+    }
+    launch_prefetch();
+}
+
+void BufferedReadPipe::record_fetch(const GenomicRegion& request, const bool unchecked_fetch) const
+{
+    if (unchecked_fetch) {
+        const auto fetch_size = count_reads(buffer_);
+        if (fetch_size > config_.max_buffer_size) {
+            if (default_unchecked_fetch_overflowed_) {
+                adjusted_unchecked_fetch_overflowed_ = true;
             } else {
-                min_checked_fetch_size_ = size(*buffered_region_);
+                default_unchecked_fetch_overflowed_ = true;
             }
+            // Clear buffer of reads to rhs of request
+            for (auto& p : buffer_) {
+                const auto last_overlapped = find_first_after(p.second, request);
+                p.second.erase(last_overlapped, std::cend(p.second));
+            }
+            buffered_region_ = request;
+        }
+    } else {
+        if (min_checked_fetch_size_) {
+            min_checked_fetch_size_ = std::min(size(*buffered_region_), *min_checked_fetch_size_);
+        } else {
+            min_checked_fetch_size_ = size(*buffered_region_);
         }
     }
 }
 
+bool BufferedReadPipe::try_install_prefetched_buffer(const GenomicRegion& request) const
+{
+    if (!prefetch_.valid()) return false;
+    try {
+        auto prefetched = prefetch_.get();
+        if (!contains(prefetched.region, request)) return false; // mispredicted; discard
+        buffered_region_ = std::move(prefetched.region);
+        buffer_ = std::move(prefetched.reads);
+        record_fetch(request, prefetched.unchecked_fetch);
+        return true;
+    } catch (...) {
+        // The predicted window may not be fetchable (e.g. past the end of the
+        // contig); fall back to a synchronous fetch
+        return false;
+    }
+}
+
+void BufferedReadPipe::launch_prefetch() const
+{
+    if (!config_.prefetch || !buffered_region_) return;
+    // Requests arrive left to right, so predict the next one to land just
+    // right of the current buffer
+    const GenomicRegion next_request {buffered_region_->contig_name(), buffered_region_->end(), buffered_region_->end()};
+    const auto max_region = get_max_fetch_region(next_request);
+    if (is_empty(max_region)) return; // nothing hinted beyond the current buffer
+    const bool unchecked_fetch {can_make_unchecked_fetch()};
+    // The lambda must not touch this object as it may be moved or mutated by
+    // the foreground thread; the read manager is safe to share
+    const auto& source = source_.get();
+    const auto max_buffer_size = config_.max_buffer_size;
+    const auto fetch_expansion = config_.fetch_expansion;
+    prefetch_ = std::async(std::launch::async, [&source, max_region, unchecked_fetch, max_buffer_size, fetch_expansion] () {
+        auto region = unchecked_fetch ? max_region : source.read_manager().find_covered_subregion(max_region, max_buffer_size);
+        auto reads = source.fetch_reads(expand(region, fetch_expansion));
+        return PrefetchedBuffer {std::move(region), std::move(reads), unchecked_fetch};
+    });
+}
+
 GenomicRegion BufferedReadPipe::get_max_fetch_region(const GenomicRegion& request) const
 {
     const auto default_max_region = get_default_max_fetch_region(request);
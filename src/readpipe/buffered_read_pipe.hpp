@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <cstddef>
+#include <future>
 
 #include <boost/optional.hpp>
 
@@ -25,6 +26,9 @@ public:
         boost::optional<GenomicRegion::Size> max_fetch_size = boost::none;
         boost::optional<GenomicRegion::Size> max_hint_gap = boost::none;
         bool allow_unchecked_fetches = true;
+        // Fetch the next buffer window on a background thread after each refill.
+        // Only worthwhile when requests arrive left to right
+        bool prefetch = false;
     };
     
     BufferedReadPipe() = delete;
@@ -54,7 +58,14 @@ public:
     
 private:
     using RegionMap = MappableSetMap<GenomicRegion::ContigName, GenomicRegion>;
-    
+
+    struct PrefetchedBuffer
+    {
+        GenomicRegion region;
+        ReadMap reads;
+        bool unchecked_fetch;
+    };
+
     std::reference_wrapper<const ReadPipe> source_;
     Config config_;
     mutable ReadMap buffer_;
@@ -63,8 +74,12 @@ private:
     mutable bool default_unchecked_fetch_overflowed_ = false;
     mutable bool adjusted_unchecked_fetch_overflowed_ = false;
     mutable boost::optional<GenomicRegion::Size> min_checked_fetch_size_ = boost::none;
-    
+    mutable std::future<PrefetchedBuffer> prefetch_;
+
     void setup_buffer(const GenomicRegion& request) const;
+    void record_fetch(const GenomicRegion& request, bool unchecked_fetch) const;
+    bool try_install_prefetched_buffer(const GenomicRegion& request) const;
+    void launch_prefetch() const;
     GenomicRegion get_max_fetch_region(const GenomicRegion& request) const;
     GenomicRegion get_default_max_fetch_region(const GenomicRegion& request) const;
     bool can_make_unchecked_fetch() const noexcept;
@@ -4,7 +4,6 @@
 #include "downsampler.hpp"
 
 #include <vector>
-#include <deque>
 #include <functional>
 #include <iterator>
 #include <algorithm>
@@ -19,7 +18,6 @@
 #include "concepts/mappable_range.hpp"
 #include "utils/mappable_algorithms.hpp"
 #include "utils/read_algorithms.hpp"
-#include "utils/append.hpp"
 
 // Use boost distributions as std distributions not guaranteed to be deterministic across compilers.
 // Generators are however.
@@ -31,6 +29,18 @@ namespace {
 
 using ReadWrapper = MappableReferenceWrapper<const AlignedRead>;
 
+// References a read together with its index in the source container, so that
+// sampling decisions can be recorded without copying read payloads
+struct IndexedReadWrapper : public Mappable<IndexedReadWrapper>
+{
+    IndexedReadWrapper(const AlignedRead& read, std::size_t index) : read {read}, index {index} {}
+
+    ReadWrapper read;
+    std::size_t index;
+
+    const GenomicRegion& mapped_region() const noexcept { return octopus::mapped_region(read); }
+};
+
 using PositionCoverages = std::vector<unsigned>;
 
 bool has_minimum_coverage(const PositionCoverages& required_coverage)
@@ -87,7 +97,7 @@ auto pick_sample(BidirIt first_unsampled, BidirIt last_unsampled,
     return random_sample(candidates);
 }
 
-void reduce(PositionCoverages& coverages, const ReadWrapper& read, const GenomicRegion& region)
+void reduce(PositionCoverages& coverages, const IndexedReadWrapper& read, const GenomicRegion& region)
 {
     assert(!begins_before(read, region));
     const auto read_offset = begin_distance(region, read);
@@ -130,30 +140,22 @@ void remove_sample(BidirIt& first, BidirIt sample, BidirIt& last)
     }
 }
 
-auto extract_sampled(std::vector<ReadWrapper>& reads,
-                     std::vector<ReadWrapper>::iterator first_unsampled,
-                     std::vector<ReadWrapper>::iterator last_unsampled)
-{
-    reads.erase(first_unsampled, last_unsampled);
-    std::sort(std::begin(reads), std::end(reads));
-    std::vector<AlignedRead> result {};
-    result.reserve(reads.size());
-    std::transform(std::begin(reads), std::end(reads), std::back_inserter(result),
-                   [] (const auto& wrapper) -> AlignedRead { return wrapper.get(); });
-    return result;
-}
-
 } // namespace
 
 template <typename InputIt>
-auto sample(const InputIt first_read, const InputIt last_read, const GenomicRegion& region,
-            const unsigned target_coverage)
+void sample(const InputIt first_read, const InputIt last_read, const GenomicRegion& region,
+            const unsigned target_coverage, std::vector<bool>& keep, const std::size_t first_read_index)
 {
-    if (first_read == last_read) return std::vector<AlignedRead> {};
+    if (first_read == last_read) return;
     const auto positions = decompose(region);
     auto required_coverage = calculate_minimum_coverages(first_read, last_read, region, target_coverage);
     assert(positions.size() == required_coverage.size());
-    std::vector<ReadWrapper> reads {first_read, last_read};
+    std::vector<IndexedReadWrapper> reads {};
+    reads.reserve(std::distance(first_read, last_read));
+    auto read_index = first_read_index;
+    for (auto read_itr = first_read; read_itr != last_read; ++read_itr) {
+        reads.emplace_back(*read_itr, read_index++);
+    }
     const auto max_read_size = size(largest_region(reads)); // for efficient overlap detection
     // The reads are partitioned into three groups: sampled | unsampled | sampled
     // which allows a sampled read to be optimally moved out of the unsampled partition
@@ -165,7 +167,9 @@ auto sample(const InputIt first_read, const InputIt last_read, const GenomicRegi
         reduce(required_coverage, *sampled_itr, region);
         remove_sample(first_unsampled_itr, sampled_itr, last_unsampled_itr);
     }
-    return extract_sampled(reads, first_unsampled_itr, last_unsampled_itr);
+    // Whatever is left in the unsampled partition is dropped
+    std::for_each(first_unsampled_itr, last_unsampled_itr,
+                  [&keep] (const auto& read) { keep[read.index] = false; });
 }
 
 namespace {
@@ -193,48 +197,33 @@ auto find_target_regions(const ReadContainer& reads, const unsigned max_coverage
 
 std::size_t sample(ReadContainer& reads, const unsigned trigger_coverage, const unsigned target_coverage)
 {
-    using std::begin; using std::end; using std::make_move_iterator;
-    
+    using std::begin; using std::end;
+
     if (reads.empty()) return 0;
     const auto targets = find_target_regions(reads, trigger_coverage, target_coverage);
     if (targets.empty()) return 0;
-    
-    // We avoid using ReadContainers member methods for inserting sampled reads as they are order
-    //  N log(size() + N) + N * size(). This is because they assume the input range is unsorted,
-    // and must therefore to a binary search for every read inserted. We can avoid this as
-    // we know the reads are originally sorted, and we sample reads in non-overlapping blocks.
-    // The blocks are themselves sorted, so no comparisons are required.
-    std::vector<std::deque<AlignedRead>> sampled_read_blocks {};
-    sampled_read_blocks.reserve(targets.size());
-    std::vector<std::vector<AlignedRead>> unsampled_read_blocks {};
-    unsampled_read_blocks.reserve(targets.size());
-    std::size_t num_reads {0};
-    
-    // Downsample in reverse order because erasing near back of MappableFlatMultiSet is much
-    // cheaper than erasing near front.
-    std::for_each(std::crbegin(targets), std::crend(targets), [&] (const auto& region) {
+
+    // Sampling records its decisions in a keep-set of indices over the source
+    // container; the kept reads are then compacted in place with a single pass of
+    // moves, so no read payload is ever copied or rebuilt into a new container.
+    std::vector<bool> keep(reads.size(), true);
+    for (const auto& region : targets) {
         const auto contained = bases(contained_range(begin(reads), end(reads), region));
-        num_reads += std::distance(end(contained), end(reads));
-        unsampled_read_blocks.emplace_back(make_move_iterator(end(contained)), make_move_iterator(end(reads)));
-        auto sampled_reads = sample(begin(contained), end(contained), region, target_coverage);
-        num_reads += sampled_reads.size();
-        sampled_read_blocks.emplace_back(make_move_iterator(begin(sampled_reads)), make_move_iterator(end(sampled_reads)));
-        reads.erase(begin(contained), end(reads));
-        reads.shrink_to_fit();
-    });
-    
-    num_reads += reads.size();
-    std::vector<AlignedRead> buffer {};
-    buffer.reserve(num_reads);
-    buffer.assign(make_move_iterator(begin(reads)), make_move_iterator(end(reads)));
-    reads.clear();
-    reads.shrink_to_fit();
-    for (auto i = static_cast<int>(targets.size()) - 1; i >= 0; --i) {
-        utils::append(std::move(sampled_read_blocks[i]), buffer);
-        utils::append(std::move(unsampled_read_blocks[i]), buffer);
+        const auto first_read_index = static_cast<std::size_t>(std::distance(begin(reads), begin(contained)));
+        sample(begin(contained), end(contained), region, target_coverage, keep, first_read_index);
     }
-    reads = ReadContainer {make_move_iterator(begin(buffer)), make_move_iterator(end(buffer))};
-    return num_reads;
+    auto result_itr = begin(reads);
+    std::size_t read_index {0};
+    for (auto read_itr = begin(reads); read_itr != end(reads); ++read_itr, ++read_index) {
+        if (keep[read_index]) {
+            if (result_itr != read_itr) *result_itr = std::move(*read_itr);
+            ++result_itr;
+        }
+    }
+    const auto num_removed = static_cast<std::size_t>(std::distance(result_itr, end(reads)));
+    reads.erase(result_itr, end(reads));
+    reads.shrink_to_fit();
+    return num_removed;
 }
 
 // Downsampler
@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <cstdint>
 
 #include "basics/cigar_string.hpp"
 #include "basics/aligned_read.hpp"
@@ -255,6 +256,36 @@ private:
     virtual BidirIt do_partition(BidirIt first, BidirIt last) const = 0;
 };
 
+namespace detail {
+
+// A packed necessary condition for IsDuplicate built from the cheap read
+// fields: any mismatch here rules out duplication with two integer compares,
+// so only key-equal neighbours pay for the cigar and contig comparisons
+struct DuplicateKey
+{
+    std::uint64_t position, fragment;
+};
+
+inline bool operator==(const DuplicateKey& lhs, const DuplicateKey& rhs) noexcept
+{
+    return lhs.position == rhs.position && lhs.fragment == rhs.fragment;
+}
+
+inline DuplicateKey make_duplicate_key(const AlignedRead& read) noexcept
+{
+    DuplicateKey result {};
+    result.position = (static_cast<std::uint64_t>(mapped_begin(read)) << 32) | mapped_end(read);
+    if (read.has_other_segment()) {
+        const auto& segment = read.next_segment();
+        result.fragment = (static_cast<std::uint64_t>(segment.inferred_template_length()) << 32)
+                          | (segment.begin() << 2) | 2;
+    }
+    result.fragment |= read.is_marked_reverse_mapped();
+    return result;
+}
+
+} // namespace detail
+
 template <typename ForwardIt>
 struct IsNotDuplicate : ContextReadFilter<ForwardIt>
 {
@@ -264,7 +295,23 @@ struct IsNotDuplicate : ContextReadFilter<ForwardIt>
     
     ForwardIt do_remove(ForwardIt first, ForwardIt last) const override
     {
-        return std::unique(first, last, IsDuplicate {});
+        // Fetched reads arrive coordinate sorted, so duplicates sit next to
+        // each other and one pass with a rolling key suffices; this keeps
+        // std::unique semantics but screens each neighbour with the packed
+        // key before the full comparison
+        if (first == last) return last;
+        const IsDuplicate is_duplicate {};
+        auto result = first;
+        auto result_key = detail::make_duplicate_key(*result);
+        for (auto itr = std::next(first); itr != last; ++itr) {
+            const auto key = detail::make_duplicate_key(*itr);
+            if (!(key == result_key) || !is_duplicate(*result, *itr)) {
+                ++result;
+                if (result != itr) *result = std::move(*itr);
+                result_key = key;
+            }
+        }
+        return ++result;
     }
     
     ForwardIt do_partition(ForwardIt first, ForwardIt last) const override
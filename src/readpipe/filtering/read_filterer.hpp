@@ -9,11 +9,15 @@
 #include <memory>
 #include <algorithm>
 #include <iterator>
+#include <future>
 #include <type_traits>
 #include <utility>
+#include <cstdint>
+#include <cstddef>
 
 #include <boost/optional.hpp>
 
+#include "config/common.hpp"
 #include "read_filter.hpp"
 
 namespace octopus { namespace readpipe
@@ -47,7 +51,9 @@ public:
     
     void add(BasicFilterPtr filter);
     void add(ContextFilterPtr filter);
-    
+
+    void set_execution_policy(ExecutionPolicy policy) noexcept;
+
     unsigned num_filters() const noexcept;
     
     void shrink_to_fit() noexcept; // Just removes extra capcity for filters
@@ -61,13 +67,39 @@ public:
     BidirIt partition(ReadIterator first, ReadIterator last, FilterCountMap& filter_counts) const;
     
 private:
+    // One verdict per read: 0 if the read passes all basic filters, otherwise
+    // 1 + the index of the first failing filter
+    using FilterVerdict = std::uint8_t;
+
     std::vector<BasicFilterPtr> basic_filters_;
     std::vector<ContextFilterPtr> context_filters_;
-    
+    ExecutionPolicy execution_policy_ = ExecutionPolicy::seq;
+
     bool passes_all_basic_filters(const AlignedRead& read) const noexcept;
     auto find_failing_basic_filter(const AlignedRead& read) const noexcept;
+    std::vector<FilterVerdict> basic_filter_verdicts(BidirIt first, BidirIt last) const;
 };
 
+namespace detail {
+
+// Like std::remove_if, but driven by precomputed verdicts
+template <typename BidirIt, typename Verdict>
+BidirIt remove_filtered(BidirIt first, BidirIt last, const std::vector<Verdict>& verdicts)
+{
+    std::size_t i {0};
+    for (; first != last && verdicts[i] == 0; ++first, ++i) {}
+    if (first == last) return last;
+    auto result = first++;
+    for (++i; first != last; ++first, ++i) {
+        if (verdicts[i] == 0) {
+            *result++ = std::move(*first);
+        }
+    }
+    return result;
+}
+
+} // namespace detail
+
 template <typename BidirIt>
 void ReadFilterer<BidirIt>::add(BasicFilterPtr filter)
 {
@@ -80,6 +112,12 @@ void ReadFilterer<BidirIt>::add(ContextFilterPtr filter)
     context_filters_.emplace_back(std::move(filter));
 }
 
+template <typename BidirIt>
+void ReadFilterer<BidirIt>::set_execution_policy(const ExecutionPolicy policy) noexcept
+{
+    execution_policy_ = policy;
+}
+
 template <typename BidirIt>
 unsigned ReadFilterer<BidirIt>::num_filters() const noexcept
 {
@@ -97,19 +135,17 @@ template <typename BidirIt>
 BidirIt ReadFilterer<BidirIt>::remove(BidirIt first, BidirIt last) const
 {
     if (first == last || num_filters() == 0) return last;
-    
+
     if (!basic_filters_.empty()) {
-        last = std::remove_if(first, last,
-                              [this] (const AlignedRead& read) {
-                                  return !passes_all_basic_filters(read);
-                              });
+        const auto verdicts = basic_filter_verdicts(first, last);
+        last = detail::remove_filtered(first, last, verdicts);
     }
-    
+
     std::for_each(cbegin(context_filters_), cend(context_filters_),
                   [first, &last] (const auto& filter) {
                       last = filter->remove(first, last);
                   });
-    
+
     return last;
 }
 
@@ -156,20 +192,13 @@ BidirIt ReadFilterer<BidirIt>::remove(BidirIt first, BidirIt last,
     }
     
     if (!basic_filters_.empty()) {
+        const auto verdicts = basic_filter_verdicts(first, last);
         std::vector<std::size_t> flat_counts(basic_filters_.size(), 0);
-        
-        last = std::remove_if(first, last,
-                              [this, &flat_counts] (const AlignedRead& read) {
-                                  const auto it = find_failing_basic_filter(read);
-                                  
-                                  if (it != std::cend(basic_filters_)) {
-                                      ++flat_counts[std::distance(std::cbegin(basic_filters_), it)];
-                                      return true;
-                                  }
-                                  
-                                  return false;
-                              });
-        
+        for (const auto verdict : verdicts) {
+            if (verdict > 0) ++flat_counts[verdict - 1];
+        }
+        last = detail::remove_filtered(first, last, verdicts);
+
         filter_counts.reserve(num_filters());
         
         std::transform(std::cbegin(basic_filters_), std::cend(basic_filters_), std::cbegin(flat_counts),
@@ -260,6 +289,44 @@ auto ReadFilterer<BidirIt>::find_failing_basic_filter(const AlignedRead& read) c
                             [&read] (const auto& filter) { return (*filter)(read); });
 }
 
+template <typename BidirIt>
+std::vector<typename ReadFilterer<BidirIt>::FilterVerdict>
+ReadFilterer<BidirIt>::basic_filter_verdicts(BidirIt first, BidirIt last) const
+{
+    const auto num_reads = static_cast<std::size_t>(std::distance(first, last));
+    std::vector<FilterVerdict> result(num_reads);
+    const auto fill_verdicts = [this] (BidirIt read_itr, FilterVerdict* verdict_itr, std::size_t n) {
+        for (std::size_t i {0}; i < n; ++i, ++read_itr) {
+            const auto itr = find_failing_basic_filter(*read_itr);
+            verdict_itr[i] = itr != std::cend(basic_filters_)
+                ? static_cast<FilterVerdict>(1 + std::distance(std::cbegin(basic_filters_), itr))
+                : 0;
+        }
+    };
+    // Verdicts only read the container, so chunks can be evaluated concurrently
+    // and the survivors compacted afterwards, keeping the stable ordering
+    constexpr std::size_t minReadsPerThread {16'384};
+    if (execution_policy_ != ExecutionPolicy::seq && num_reads >= 2 * minReadsPerThread) {
+        const auto num_threads = std::min(std::size_t {4}, num_reads / minReadsPerThread);
+        const auto chunk_size = num_reads / num_threads;
+        std::vector<std::future<void>> chunk_futures {};
+        chunk_futures.reserve(num_threads - 1);
+        auto chunk_first = first;
+        std::size_t offset {0};
+        for (std::size_t t {1}; t < num_threads; ++t) {
+            chunk_futures.push_back(std::async(std::launch::async, fill_verdicts,
+                                               chunk_first, result.data() + offset, chunk_size));
+            std::advance(chunk_first, chunk_size);
+            offset += chunk_size;
+        }
+        fill_verdicts(chunk_first, result.data() + offset, num_reads - offset);
+        for (auto& f : chunk_futures) f.get();
+    } else {
+        fill_verdicts(first, result.data(), num_reads);
+    }
+    return result;
+}
+
 // non-member methods
 
 template <typename Container>
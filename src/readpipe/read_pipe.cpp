@@ -10,6 +10,7 @@
 
 #include "utils/read_stats.hpp"
 #include "utils/mappable_algorithms.hpp"
+#include "utils/parallel_sort.hpp"
 
 namespace octopus {
 
@@ -63,6 +64,11 @@ void ReadPipe::set_read_manager(const ReadManager& source) noexcept
     source_ = source;
 }
 
+void ReadPipe::enable_parallel_sorting(ThreadPool& workers) noexcept
+{
+    sort_workers_ = &workers;
+}
+
 unsigned ReadPipe::num_samples() const noexcept
 {
     return static_cast<unsigned>(samples_.size());
@@ -76,24 +82,29 @@ const std::vector<SampleName>& ReadPipe::samples() const noexcept
 namespace {
 
 template <typename Map>
-void sort_each(Map& reads)
+void sort_each(Map& reads, ThreadPool* workers)
 {
     for (auto& p : reads) {
-        std::sort(std::begin(p.second), std::end(p.second));
+        if (workers) {
+            parallel_sort(std::begin(p.second), std::end(p.second), std::less<> {}, *workers);
+        } else {
+            std::sort(std::begin(p.second), std::end(p.second));
+        }
     }
 }
 
-auto fetch_batch(const ReadManager& rm, const std::vector<SampleName>& samples, const GenomicRegion& region)
+auto fetch_batch(const ReadManager& rm, const std::vector<SampleName>& samples, const GenomicRegion& region,
+                 ThreadPool* sort_workers)
 {
     auto result = rm.fetch_reads(samples, region);
-    sort_each(result);
+    sort_each(result, sort_workers);
     return result;
 }
 
 template <typename Container>
 void move_construct(Container&& src, ReadMap::mapped_type& dst)
 {
-    dst.insert(std::make_move_iterator(std::begin(src)), std::make_move_iterator(std::end(src)));
+    dst.insert_sorted(std::make_move_iterator(std::begin(src)), std::make_move_iterator(std::end(src)));
 }
 
 template <>
@@ -110,8 +121,8 @@ void insert_each(Container&& src, ReadMap& dst)
         if (sample_dst.empty()) {
             move_construct(std::move(p.second), sample_dst);
         } else {
-            sample_dst.insert(std::make_move_iterator(std::begin(p.second)),
-                              std::make_move_iterator(std::end(p.second)));
+            sample_dst.insert_sorted(std::make_move_iterator(std::begin(p.second)),
+                                     std::make_move_iterator(std::end(p.second)));
         }
         p.second.clear();
         p.second.shrink_to_fit();
@@ -136,7 +147,7 @@ ReadMap ReadPipe::fetch_reads(const GenomicRegion& region) const
         result.emplace(std::piecewise_construct, std::forward_as_tuple(sample), std::forward_as_tuple());
     }
     for (const auto& batch : batch_samples(samples_)) {
-        auto batch_reads = fetch_batch(source_, batch, region);
+        auto batch_reads = fetch_batch(source_, batch, region, sort_workers_);
         if (debug_log_) {
             stream(*debug_log_) << "Fetched " << count_reads(batch_reads) << " unfiltered reads from " << region;
         }
@@ -166,12 +177,20 @@ ReadMap ReadPipe::fetch_reads(const GenomicRegion& region) const
         if (postfilter_transformer_) {
             transform_reads(batch_reads, *postfilter_transformer_);
         }
+        // All transforms are done, so duplicate payloads are stable and can be pooled
+        std::size_t num_interned {0};
+        for (auto& p : batch_reads) {
+            num_interned += intern_duplicate_read_data(p.second);
+        }
+        if (debug_log_ && num_interned > 0) {
+            stream(*debug_log_) << "Interned " << num_interned << " duplicate read sequences in " << region;
+        }
         if (debug_log_) {
             stream(*debug_log_) << "There are " << count_reads(batch_reads) << " reads in " << region
                             << " after filtering";
         }
         if (downsampler_) {
-            auto reads = make_mappable_map(std::move(batch_reads));
+            auto reads = make_mappable_map<ReadContainer>(std::move(batch_reads));
             const auto n = downsample(reads, *downsampler_);
             if (debug_log_) stream(*debug_log_) << "Downsampling removed " << n << " reads from " << region;
             insert_each(std::move(reads), result);
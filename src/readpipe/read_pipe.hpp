@@ -20,6 +20,9 @@
 #include "downsampling/downsampler.hpp"
 
 namespace octopus {
+
+class ThreadPool;
+
 /*
  ReadPipe provides a wrapper for the basic manipulation of AlignedRead's. It is responsable for
  actually fetching the reads from file, and applying any filters, transforms etc. The result is
@@ -69,6 +72,9 @@ public:
     ReadMap fetch_reads(const GenomicRegion& region) const;
     ReadMap fetch_reads(const std::vector<GenomicRegion>& regions) const;
     
+    // Large read batches are sorted with the given pool rather than on the fetching thread
+    void enable_parallel_sorting(ThreadPool& workers) noexcept;
+    
     //Report get_report() const;
     
 private:
@@ -78,6 +84,7 @@ private:
     boost::optional<ReadTransformer> postfilter_transformer_;
     boost::optional<Downsampler> downsampler_;
     std::vector<SampleName> samples_;
+    ThreadPool* sort_workers_ = nullptr;
     mutable boost::optional<logging::DebugLogger> debug_log_;
 };
 
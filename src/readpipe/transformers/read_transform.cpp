@@ -24,6 +24,38 @@ void CapBaseQualities::operator()(AlignedRead& read) const noexcept
     cap_qualities(read, max_);
 }
 
+namespace {
+
+auto make_sorted(std::vector<AlignedRead::BaseQuality> qualities)
+{
+    std::sort(std::begin(qualities), std::end(qualities));
+    qualities.erase(std::unique(std::begin(qualities), std::end(qualities)), std::end(qualities));
+    return qualities;
+}
+
+} // namespace
+
+BinBaseQualities::BinBaseQualities(std::vector<BaseQuality> palette)
+: palette_ {make_sorted(std::move(palette))}
+{}
+
+void BinBaseQualities::operator()(AlignedRead& read) const noexcept
+{
+    if (palette_.empty()) return;
+    for (auto& quality : read.base_qualities()) {
+        const auto succ_itr = std::lower_bound(std::cbegin(palette_), std::cend(palette_), quality);
+        if (succ_itr == std::cend(palette_)) {
+            quality = palette_.back();
+        } else if (succ_itr == std::cbegin(palette_) || *succ_itr == quality) {
+            quality = *succ_itr;
+        } else {
+            // Ties snap down so binning never makes a base look more certain
+            const auto pred = *std::prev(succ_itr);
+            quality = (*succ_itr - quality) < (quality - pred) ? *succ_itr : pred;
+        }
+    }
+}
+
 void MaskOverlappedSegment::operator()(AlignedRead& read) const noexcept
 {
     // Only reads in the forward direction are masked to prevent double masking
@@ -30,6 +30,25 @@ private:
     const BaseQuality max_;
 };
 
+// Snaps each base quality to the nearest value in the given palette.
+// Instruments that emit a handful of quality values leave the palette small,
+// and binning everything onto it concentrates the pair HMM penalties on a
+// few values. Must run before any masking transform so masked zeros are not
+// raised back onto the palette
+struct BinBaseQualities
+{
+    using BaseQuality = AlignedRead::BaseQuality;
+    
+    BinBaseQualities() = default;
+    
+    explicit BinBaseQualities(std::vector<BaseQuality> palette);
+    
+    void operator()(AlignedRead& read) const noexcept;
+    
+private:
+    const std::vector<BaseQuality> palette_; // sorted ascending
+};
+
 struct MaskOverlappedSegment
 {
     void operator()(AlignedRead& read) const noexcept;
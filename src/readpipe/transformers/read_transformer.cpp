@@ -3,7 +3,9 @@
 
 #include "read_transformer.hpp"
 
-#include <iostream>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
 
 namespace octopus { namespace readpipe {
 
@@ -37,20 +39,6 @@ void ReadTransformer::transform_read(AlignedRead& read) const
     }
 }
 
-struct ReadTemplateLess
-{
-    bool operator()(const AlignedRead& lhs, const AlignedRead& rhs) const noexcept
-    {
-        return lhs.name() == rhs.name() ? lhs < rhs : lhs.name() < rhs.name();
-    }
-};
-
-template <typename Container>
-void group_templates(Container& reads)
-{
-    std::sort(std::begin(reads), std::end(reads), ReadTemplateLess {});
-}
-
 void ReadTransformer::transform_template(ReadTemplate& read_template) const
 {
     for (const auto& transform : template_transforms_) {
@@ -58,40 +46,36 @@ void ReadTransformer::transform_template(ReadTemplate& read_template) const
     }
 }
 
-struct ReadTemplateEqual
+struct ReadNameHash
 {
-    ReadTemplateEqual(const AlignedRead& read) : read_ {read} {}
-    
-    bool operator()(const AlignedRead& other) const noexcept
+    std::size_t operator()(const AlignedRead* read) const noexcept
     {
-        return other.name() == read_.name();
+        return std::hash<std::string> {}(read->name());
     }
-
-private:
-    const AlignedRead& read_;
 };
 
-void ReadTransformer::transform_templates(ReadReferenceVector::iterator first, ReadReferenceVector::iterator last) const
+struct ReadNameEqual
 {
-    ReadReferenceVector read_template {};
-    read_template.reserve(3);
-    for (; first != last;) {
-        const auto next = std::find_if_not(std::next(first), last, ReadTemplateEqual {*first});
-        read_template.assign(first, next);
-        transform_template(read_template);
-        first = next;
+    bool operator()(const AlignedRead* lhs, const AlignedRead* rhs) const noexcept
+    {
+        return lhs->name() == rhs->name();
     }
-}
-
-void ReadTransformer::transform_templates(ReadReferenceVector& reads) const
-{
-    transform_templates(std::begin(reads), std::end(reads));
-}
+};
 
 void ReadTransformer::transform(ReadReferenceVector& reads) const
 {
-    group_templates(reads);
-    transform_templates(reads);
+    // Templates are transformed independently of one another, so same-name reads
+    // are grouped with a single hashing pass rather than sorting the whole batch
+    std::unordered_map<const AlignedRead*, ReadTemplate, ReadNameHash, ReadNameEqual> read_templates {};
+    read_templates.reserve(reads.size());
+    for (auto read : reads) {
+        auto& read_template = read_templates[std::addressof(read.get())];
+        if (read_template.empty()) read_template.reserve(3);
+        read_template.push_back(read);
+    }
+    for (auto& p : read_templates) {
+        transform_template(p.second);
+    }
 }
 
 } // namespace readpipe
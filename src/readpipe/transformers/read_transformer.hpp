@@ -46,35 +46,30 @@ public:
 private:
     std::vector<ReadTransform> read_transforms_;
     std::vector<TemplateTransform> template_transforms_;
-    
+
     void transform_read(AlignedRead& read) const;
-    template <typename ForwardIt>
-    auto make_references(ForwardIt first, ForwardIt last) const;
     void transform(ReadReferenceVector& reads) const;
-    void transform_templates(ReadReferenceVector& reads) const;
-    void transform_templates(ReadReferenceVector::iterator first, ReadReferenceVector::iterator last) const;
     void transform_template(ReadTemplate& read_template) const;
 };
 
 // private methods
 
-template <typename ForwardIt>
-auto ReadTransformer::make_references(ForwardIt first, ForwardIt last) const
-{
-    ReadReferenceVector result {};
-    result.reserve(std::distance(first, last));
-    std::copy(first, last, std::back_inserter(result));
-    return result;
-}
-
 template <typename ForwardIt>
 void ReadTransformer::transform_reads(ForwardIt first, ForwardIt last) const
 {
-    if (!read_transforms_.empty()) {
-        std::for_each(first, last, [this] (AlignedRead& read) { transform_read(read); });
-    }
-    if (!template_transforms_.empty()) {
-        auto read_references = make_references(first, last);
+    if (template_transforms_.empty()) {
+        if (!read_transforms_.empty()) {
+            std::for_each(first, last, [this] (AlignedRead& read) { transform_read(read); });
+        }
+    } else {
+        // The read transforms are applied in the same pass that collects each
+        // read for template grouping, while the read is hot in cache
+        ReadReferenceVector read_references {};
+        read_references.reserve(std::distance(first, last));
+        std::for_each(first, last, [&] (AlignedRead& read) {
+            transform_read(read);
+            read_references.emplace_back(read);
+        });
         transform(read_references);
     }
 }
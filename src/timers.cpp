@@ -46,3 +46,80 @@ void print_all_timers()
         std::cout << misc_timer[i].format() << '\n';
     }
 }
+
+namespace octopus {
+
+StageProfiler stage_profiler {};
+
+namespace {
+
+constexpr std::array<const char*, StageProfiler::num_stages> stageNames {
+    "candidate-generation", "haplotype-generation", "likelihood-calculation",
+    "model-fitting", "calling", "phasing", "output"
+};
+
+auto to_seconds(const std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+} // namespace
+
+void StageProfiler::add(const Stage stage, const std::string& contig, const std::chrono::nanoseconds duration,
+                        const HardwareCounts& counts)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    auto& stats = stats_[contig][static_cast<std::size_t>(stage)];
+    stats.total += duration;
+    ++stats.count;
+    stats.counts += counts;
+}
+
+bool StageProfiler::empty() const noexcept
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return stats_.empty();
+}
+
+void StageProfiler::write_report(std::ostream& os) const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    const auto write_line = [&os] (const std::string& contig, const char* stage, const StageStats& stats) {
+        os << contig << '\t' << stage << '\t' << to_seconds(stats.total) << '\t' << stats.count;
+        if (hardware_counter_profiling_enabled()) {
+            os << '\t' << stats.counts.cycles << '\t' << stats.counts.instructions
+               << '\t' << stats.counts.cache_misses << '\t' << stats.counts.branch_misses;
+        }
+        os << '\n';
+    };
+    os << "contig\tstage\tseconds\tcount";
+    if (hardware_counter_profiling_enabled()) {
+        os << "\tcycles\tinstructions\tcache-misses\tbranch-misses";
+    }
+    os << '\n';
+    ContigStats totals {};
+    for (const auto& p : stats_) {
+        for (std::size_t s {0}; s < num_stages; ++s) {
+            const auto& stats = p.second[s];
+            if (stats.count > 0) {
+                write_line(p.first, stageNames[s], stats);
+                totals[s].total  += stats.total;
+                totals[s].count  += stats.count;
+                totals[s].counts += stats.counts;
+            }
+        }
+    }
+    for (std::size_t s {0}; s < num_stages; ++s) {
+        if (totals[s].count > 0) {
+            write_line("*", stageNames[s], totals[s]);
+        }
+    }
+}
+
+void StageProfiler::clear() noexcept
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    stats_.clear();
+}
+
+} // namespace octopus
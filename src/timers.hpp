@@ -7,9 +7,19 @@
 //#define BENCHMARK
 
 #include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
 
 #include <boost/timer/timer.hpp>
 
+#include "perf_counters.hpp"
+
 // variant caller timers
 extern boost::timer::cpu_timer init_timer;
 extern boost::timer::cpu_timer haplotype_likelihood_timer;
@@ -40,4 +50,86 @@ void init_timers();
 
 void print_all_timers();
 
+namespace octopus {
+
+// Always-on aggregation of wall clock time spent in each calling stage, keyed
+// by contig; unlike the BENCHMARK timers above this is cheap enough to leave
+// enabled, as it costs two clock reads per stage per active region. When
+// hardware counter profiling is compiled in, each stage also accumulates the
+// cycle, instruction, cache miss, and branch miss deltas of its scopes, and
+// the report grows the matching columns
+class StageProfiler
+{
+public:
+    enum class Stage : std::size_t
+    {
+        candidate_generation, haplotype_generation, likelihood_calculation,
+        model_fitting, calling, phasing, output
+    };
+
+    static constexpr std::size_t num_stages {7};
+
+    void add(Stage stage, const std::string& contig, std::chrono::nanoseconds duration,
+             const HardwareCounts& counts = HardwareCounts {});
+
+    bool empty() const noexcept;
+    void write_report(std::ostream& os) const;
+    void clear() noexcept;
+
+private:
+    struct StageStats
+    {
+        std::chrono::nanoseconds total {0};
+        std::uint64_t count {0};
+        HardwareCounts counts {};
+    };
+    using ContigStats = std::array<StageStats, num_stages>;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, ContigStats> stats_;
+};
+
+extern StageProfiler stage_profiler;
+
+class ScopedStageTimer
+{
+public:
+    ScopedStageTimer() = delete;
+    ScopedStageTimer(StageProfiler::Stage stage, std::string contig)
+    : stage_ {stage}
+    , contig_ {std::move(contig)}
+    , start_ {std::chrono::steady_clock::now()}
+    , start_counts_ {read_hardware_counters()}
+    , stopped_ {false}
+    {}
+
+    ScopedStageTimer(const ScopedStageTimer&)            = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+    ~ScopedStageTimer() noexcept
+    {
+        try {
+            stop();
+        } catch (...) {}
+    }
+
+    void stop()
+    {
+        if (!stopped_) {
+            stopped_ = true;
+            stage_profiler.add(stage_, contig_, std::chrono::steady_clock::now() - start_,
+                               read_hardware_counters() - start_counts_);
+        }
+    }
+
+private:
+    StageProfiler::Stage stage_;
+    std::string contig_;
+    std::chrono::steady_clock::time_point start_;
+    HardwareCounts start_counts_;
+    bool stopped_;
+};
+
+} // namespace octopus
+
 #endif
@@ -8,6 +8,9 @@
 #include <deque>
 #include <iterator>
 #include <utility>
+#include <cstddef>
+
+#include <boost/container/small_vector.hpp>
 
 namespace octopus { namespace utils {
 
@@ -118,10 +121,29 @@ auto append(std::vector<T>&& src, std::deque<T>& dest)
     const auto result = dest.insert(std::cend(dest),
                                     std::make_move_iterator(std::begin(src)),
                                     std::make_move_iterator(std::end(src)));
-    
+
     src.clear();
     src.shrink_to_fit();
-    
+
+    return result;
+}
+
+template <typename T, std::size_t N>
+auto append(const boost::container::small_vector<T, N>& src, boost::container::small_vector<T, N>& dest)
+{
+    return dest.insert(std::cend(dest), std::cbegin(src), std::cend(src));
+}
+
+template <typename T, std::size_t N>
+auto append(boost::container::small_vector<T, N>&& src, boost::container::small_vector<T, N>& dest)
+{
+    const auto result = dest.insert(std::cend(dest),
+                                    std::make_move_iterator(std::begin(src)),
+                                    std::make_move_iterator(std::end(src)));
+
+    src.clear();
+    src.shrink_to_fit();
+
     return result;
 }
 
@@ -7,26 +7,76 @@
 
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#ifdef OCTOPUS_USE_ZSTD
+#include <boost/iostreams/filter/zstd.hpp>
+#endif
 #include <boost/iostreams/copy.hpp>
 
 namespace octopus { namespace utils {
 
-std::string compress(const std::string& data)
+namespace {
+
+template <typename Stream>
+void push_compressor(Stream& stream, const CompressionCodec codec, const int level)
+{
+    switch (codec) {
+        case CompressionCodec::gzip:
+            stream.push(boost::iostreams::gzip_compressor(boost::iostreams::gzip_params {
+                level < 0 ? boost::iostreams::gzip::default_compression : level}));
+            break;
+        case CompressionCodec::zstd:
+#ifdef OCTOPUS_USE_ZSTD
+            stream.push(boost::iostreams::zstd_compressor(boost::iostreams::zstd_params {
+                level < 0 ? boost::iostreams::zstd::default_compression
+                          : static_cast<std::uint32_t>(level)}));
+            break;
+#endif
+            // built without zstd support; fall through to zlib
+        case CompressionCodec::zlib:
+        default:
+            stream.push(boost::iostreams::zlib_compressor(boost::iostreams::zlib_params {
+                level < 0 ? boost::iostreams::zlib::default_compression : level}));
+    }
+}
+
+template <typename Stream>
+void push_decompressor(Stream& stream, const CompressionCodec codec)
+{
+    switch (codec) {
+        case CompressionCodec::gzip:
+            stream.push(boost::iostreams::gzip_decompressor());
+            break;
+        case CompressionCodec::zstd:
+#ifdef OCTOPUS_USE_ZSTD
+            stream.push(boost::iostreams::zstd_decompressor());
+            break;
+#endif
+            // built without zstd support; fall through to zlib
+        case CompressionCodec::zlib:
+        default:
+            stream.push(boost::iostreams::zlib_decompressor());
+    }
+}
+
+} // namespace
+
+std::string compress(const std::string& data, const CompressionCodec codec, const int level)
 {
     std::stringstream decompressed {data};
     boost::iostreams::filtering_streambuf<boost::iostreams::input> stream;
-    stream.push(boost::iostreams::zlib_compressor());
+    push_compressor(stream, codec, level);
     stream.push(decompressed);
     std::stringstream compressed {};
     boost::iostreams::copy(stream, compressed);
     return compressed.str();
 }
 
-std::string decompress(const std::string& data)
+std::string decompress(const std::string& data, const CompressionCodec codec)
 {
     std::stringstream compressed {data};
     boost::iostreams::filtering_streambuf<boost::iostreams::input> stream;
-    stream.push(boost::iostreams::zlib_decompressor());
+    push_decompressor(stream, codec);
     stream.push(compressed);
     std::stringstream decompressed;
     boost::iostreams::copy(stream, decompressed);
@@ -35,12 +85,12 @@ std::string decompress(const std::string& data)
 
 std::string Compress::operator()(const std::string str) const
 {
-    return compress(str);
+    return compress(str, codec, level);
 }
 
 std::string Decompress::operator()(const std::string str) const
 {
-    return decompress(str);
+    return decompress(str, codec);
 }
 
 } // namespace utils
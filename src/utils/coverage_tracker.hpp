@@ -48,16 +48,16 @@ public:
     bool any(const Region& region) const noexcept;
     
     std::size_t sum() const noexcept;
-    std::size_t sum(const Region& region) const noexcept;
-    
+    std::size_t sum(const Region& region) const;
+
     DepthType max() const noexcept;
-    DepthType max(const Region& region) const noexcept;
-    
+    DepthType max(const Region& region) const;
+
     DepthType min() const noexcept;
     DepthType min(const Region& region) const noexcept;
-    
+
     double mean() const noexcept;
-    double mean(const Region& region) const noexcept;
+    double mean(const Region& region) const;
     
     double stdev() const noexcept;
     double stdev(const Region& region) const noexcept;
@@ -78,12 +78,22 @@ private:
     std::deque<DepthType> coverage_ = {};
     Region encompassing_region_;
     std::size_t num_tracked_ = 0;
-    
+    // Per-block maxima and sums over coverage_, built lazily on the first large
+    // range query after a mutation, so repeated queries over wide windows resolve
+    // from block summaries rather than walking every base
+    mutable std::vector<DepthType> block_maxes_ = {};
+    mutable std::vector<std::size_t> block_sums_ = {};
+    mutable bool summaries_current_ = false;
+
+    static constexpr std::size_t summaryBlockSize {256};
+
     using Iterator     = typename decltype(coverage_)::const_iterator;
     using IteratorPair = std::pair<Iterator, Iterator>;
-    
+
     void do_add(const Region& region);
     IteratorPair range(const Region& region) const;
+    void update_summaries() const;
+    std::size_t sum_range(Iterator first, Iterator last) const;
 };
 
 // non-member methods
@@ -138,11 +148,11 @@ std::size_t CoverageTracker<Region, T>::sum() const noexcept
 }
 
 template <typename Region, typename T>
-std::size_t CoverageTracker<Region, T>::sum(const Region& region) const noexcept
+std::size_t CoverageTracker<Region, T>::sum(const Region& region) const
 {
     if (octopus::is_empty(region)) return 0;
     const auto p = range(region);
-    return std::accumulate(p.first, p.second, std::size_t {0});
+    return sum_range(p.first, p.second);
 }
 
 template <typename Region, typename T>
@@ -153,12 +163,33 @@ T CoverageTracker<Region, T>::max() const noexcept
 }
 
 template <typename Region, typename T>
-T CoverageTracker<Region, T>::max(const Region& region) const noexcept
+T CoverageTracker<Region, T>::max(const Region& region) const
 {
     if (octopus::is_empty(region)) return 0;
     const auto p = range(region);
     if (p.first == p.second) return 0;
-    return *std::max_element(p.first, p.second);
+    const auto num_positions = static_cast<std::size_t>(std::distance(p.first, p.second));
+    if (num_positions < 2 * summaryBlockSize) {
+        return *std::max_element(p.first, p.second);
+    }
+    update_summaries();
+    const auto o1 = static_cast<std::size_t>(std::distance(std::cbegin(coverage_), p.first));
+    const auto o2 = o1 + num_positions;
+    const auto first_whole_block = (o1 + summaryBlockSize - 1) / summaryBlockSize;
+    const auto last_whole_block  = o2 / summaryBlockSize;
+    T result {0};
+    const auto left_edge_end = std::next(std::cbegin(coverage_), first_whole_block * summaryBlockSize);
+    if (p.first != left_edge_end) {
+        result = *std::max_element(p.first, left_edge_end);
+    }
+    for (auto block = first_whole_block; block < last_whole_block; ++block) {
+        result = std::max(result, block_maxes_[block]);
+    }
+    const auto right_edge_begin = std::next(std::cbegin(coverage_), last_whole_block * summaryBlockSize);
+    if (right_edge_begin != p.second) {
+        result = std::max(result, *std::max_element(right_edge_begin, p.second));
+    }
+    return result;
 }
 
 template <typename Region, typename T>
@@ -185,11 +216,12 @@ double CoverageTracker<Region, T>::mean() const noexcept
 }
 
 template <typename Region, typename T>
-double CoverageTracker<Region, T>::mean(const Region& region) const noexcept
+double CoverageTracker<Region, T>::mean(const Region& region) const
 {
     if (octopus::is_empty(region)) return 0;
     const auto p = range(region);
-    return maths::mean(p.first, p.second);
+    if (p.first == p.second) return 0;
+    return static_cast<double>(sum_range(p.first, p.second)) / std::distance(p.first, p.second);
 }
 
 template <typename Region, typename T>
@@ -278,6 +310,9 @@ void CoverageTracker<Region, T>::clear() noexcept
     coverage_.clear();
     coverage_.shrink_to_fit();
     num_tracked_ = 0;
+    block_maxes_.clear();
+    block_sums_.clear();
+    summaries_current_ = false;
 }
 
 // private methods
@@ -325,6 +360,7 @@ void CoverageTracker<Region, T>::do_add(const Region& region)
         std::transform(first, std::next(first, size(region)), first, [] (auto count) noexcept { return count + 1; });
     }
     ++num_tracked_;
+    summaries_current_ = false;
 }
 
 template <typename Region, typename T>
@@ -340,6 +376,46 @@ typename CoverageTracker<Region, T>::IteratorPair CoverageTracker<Region, T>::ra
     return {range_start_itr, std::next(range_start_itr, overlap_size(region, encompassing_region_))};
 }
 
+template <typename Region, typename T>
+void CoverageTracker<Region, T>::update_summaries() const
+{
+    if (summaries_current_) return;
+    const auto num_blocks = (coverage_.size() + summaryBlockSize - 1) / summaryBlockSize;
+    block_maxes_.resize(num_blocks);
+    block_sums_.resize(num_blocks);
+    auto block_begin = std::cbegin(coverage_);
+    for (std::size_t block {0}; block < num_blocks; ++block) {
+        auto remaining = coverage_.size() - block * summaryBlockSize;
+        if (remaining > summaryBlockSize) remaining = summaryBlockSize;
+        const auto block_end = std::next(block_begin, remaining);
+        block_maxes_[block] = *std::max_element(block_begin, block_end);
+        block_sums_[block]  = std::accumulate(block_begin, block_end, std::size_t {0});
+        block_begin = block_end;
+    }
+    summaries_current_ = true;
+}
+
+template <typename Region, typename T>
+std::size_t CoverageTracker<Region, T>::sum_range(const Iterator first, const Iterator last) const
+{
+    const auto num_positions = static_cast<std::size_t>(std::distance(first, last));
+    if (num_positions < 2 * summaryBlockSize) {
+        return std::accumulate(first, last, std::size_t {0});
+    }
+    update_summaries();
+    const auto o1 = static_cast<std::size_t>(std::distance(std::cbegin(coverage_), first));
+    const auto o2 = o1 + num_positions;
+    const auto first_whole_block = (o1 + summaryBlockSize - 1) / summaryBlockSize;
+    const auto last_whole_block  = o2 / summaryBlockSize;
+    const auto left_edge_end = std::next(std::cbegin(coverage_), first_whole_block * summaryBlockSize);
+    auto result = std::accumulate(first, left_edge_end, std::size_t {0});
+    for (auto block = first_whole_block; block < last_whole_block; ++block) {
+        result += block_sums_[block];
+    }
+    const auto right_edge_begin = std::next(std::cbegin(coverage_), last_whole_block * summaryBlockSize);
+    return std::accumulate(right_edge_begin, last, result);
+}
+
 } // namespace octopus
 
 #endif
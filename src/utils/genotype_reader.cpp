@@ -135,13 +135,21 @@ make_allele(const VcfRecord& call, VcfRecord::NucleotideSequence allele_sequence
     return ContigAllele {region, std::move(allele_sequence)};
 }
 
-auto extract_genotype(const VcfRecord& call, const SampleName& sample)
+// Scratch space reused across records and phase sets during batched genotype
+// extraction
+struct GenotypeExtractionBuffers
+{
+    std::vector<boost::optional<ContigAllele>> alleles;
+    std::vector<std::size_t> unknown_pad_indices;
+};
+
+void extract_genotype(const VcfRecord& call, const SampleName& sample, GenotypeExtractionBuffers& buffers)
 {
     auto genotype = get_genotype(call, sample);
     boost::optional<int> max_ref_pad {};
-    std::vector<std::size_t> unknown_pad_indices {};
+    buffers.unknown_pad_indices.clear();
     const auto ploidy = genotype.size();
-    std::vector<boost::optional<ContigAllele>> result(ploidy, boost::none);
+    buffers.alleles.assign(ploidy, boost::none);
     for (std::size_t i {0}; i < ploidy; ++i) {
         auto& allele = genotype[i];
         if (is_ref_pad_size_known(allele, call)) {
@@ -151,18 +159,17 @@ auto extract_genotype(const VcfRecord& call, const SampleName& sample)
             } else {
                 max_ref_pad = allele_pad;
             }
-            result[i] = make_allele(call, std::move(allele), allele_pad);
+            buffers.alleles[i] = make_allele(call, std::move(allele), allele_pad);
         } else {
-            unknown_pad_indices.push_back(i);
+            buffers.unknown_pad_indices.push_back(i);
         }
     }
     if (!max_ref_pad) {
         max_ref_pad = has_non_complex_indel(call) ? 1 : 0;
     }
-    for (auto idx : unknown_pad_indices) {
-        result[idx] = make_allele(call, std::move(genotype[idx]), *max_ref_pad);
+    for (auto idx : buffers.unknown_pad_indices) {
+        buffers.alleles[idx] = make_allele(call, std::move(genotype[idx]), *max_ref_pad);
     }
-    return result;
 }
 
 } // namespace
@@ -296,21 +303,45 @@ auto make_genotype(std::vector<Haplotype::Builder>&& haplotypes)
 Genotype<Haplotype> extract_genotype(const std::vector<CallWrapper>& phased_calls,
                                      const GenomicRegion& region,
                                      const SampleName& sample,
-                                     const ReferenceGenome& reference)
+                                     const ReferenceGenome& reference,
+                                     const ReferenceSlice& ref_window,
+                                     GenotypeExtractionBuffers& buffers)
 {
     assert(!phased_calls.empty());
     assert(contains(region, encompassing_region(phased_calls)));
     const auto max_ploidy = get_max_ploidy(phased_calls, sample);
     std::vector<Haplotype::Builder> haplotypes(max_ploidy, Haplotype::Builder {region, reference});
+    // Gaps between called alleles are filled from the prefetched window so
+    // that building the haplotypes triggers no reference fetches
+    std::vector<ContigRegion::Position> haplotype_ends(max_ploidy, region.begin());
+    const auto push_reference_padding = [&] (Haplotype::Builder& haplotype,
+                                             const ContigRegion::Position begin, const ContigRegion::Position end) {
+        if (begin < end) {
+            const ContigRegion pad_region {begin, end};
+            const GenomicRegion pad_genomic_region {region.contig_name(), pad_region};
+            // Phase sets can reach outside the batch's records, in which case
+            // the padding is not in the window and falls through to a fetch
+            auto pad_sequence = ref_window.contains(pad_genomic_region)
+                ? ref_window.copy(pad_genomic_region)
+                : reference.fetch_sequence(pad_genomic_region);
+            haplotype.push_back(ContigAllele {pad_region, std::move(pad_sequence)});
+        }
+    };
     for (const auto& call : phased_calls) {
-        auto genotype = extract_genotype(call.call, sample);
-        assert(genotype.size() <= max_ploidy);
-        for (unsigned i {0}; i < genotype.size(); ++i) {
-            if (genotype[i] && haplotypes[i].can_push_back(*genotype[i])) {
-                haplotypes[i].push_back(std::move(*genotype[i]));
+        extract_genotype(call.call, sample, buffers);
+        assert(buffers.alleles.size() <= max_ploidy);
+        for (unsigned i {0}; i < buffers.alleles.size(); ++i) {
+            auto& allele = buffers.alleles[i];
+            if (allele && haplotypes[i].can_push_back(*allele)) {
+                push_reference_padding(haplotypes[i], haplotype_ends[i], mapped_begin(*allele));
+                haplotype_ends[i] = std::max(haplotype_ends[i], mapped_end(*allele));
+                haplotypes[i].push_back(std::move(*allele));
             }
         }
     }
+    for (unsigned i {0}; i < max_ploidy; ++i) {
+        push_reference_padding(haplotypes[i], haplotype_ends[i], region.contig_region().end());
+    }
     return make_genotype(std::move(haplotypes));
 }
 
@@ -323,6 +354,14 @@ GenotypeMap extract_genotypes(const std::vector<VcfRecord>& calls,
 {
     if (calls.empty()) return {};
     GenotypeMap result {samples.size()};
+    // Every genotype region below falls inside this window, so one reference
+    // fetch serves all haplotypes of all samples in the batch
+    auto window = encompassing_region(calls);
+    if (call_region) {
+        window = encompassing_region(*call_region, window);
+    }
+    const auto ref_window = reference.fetch_slice(window);
+    GenotypeExtractionBuffers buffers {};
     
     for (const auto& sample : samples) {
         const auto wrapped_calls = segment_overlapped_copy(wrap_calls(calls, sample));
@@ -334,7 +373,7 @@ GenotypeMap extract_genotypes(const std::vector<VcfRecord>& calls,
             result.emplace(std::piecewise_construct,
                            std::forward_as_tuple(sample),
                            std::forward_as_tuple(InitList {
-                                extract_genotype(wrapped_calls.front(), *call_region, sample, reference)
+                                extract_genotype(wrapped_calls.front(), *call_region, sample, reference, ref_window, buffers)
                             }));
         } else { // wrapped_calls.size() > 1
             auto it = std::cbegin(wrapped_calls);
@@ -347,19 +386,19 @@ GenotypeMap extract_genotypes(const std::vector<VcfRecord>& calls,
             result.emplace(std::piecewise_construct,
                            std::forward_as_tuple(sample),
                            std::forward_as_tuple(InitList {
-                                extract_genotype(*it, region, sample, reference)
+                                extract_genotype(*it, region, sample, reference, ref_window, buffers)
                             }));
             ++it;
             for (auto penultimate = std::prev(std::cend(wrapped_calls)); it != penultimate; ++it) {
                 region = *intervening_region(std::prev(it)->back(), std::next(it)->front());
-                result.at(sample).insert(extract_genotype(*it, region, sample, reference));
+                result.at(sample).insert(extract_genotype(*it, region, sample, reference, ref_window, buffers));
             }
             if (call_region) {
                 region = right_overhang_region(*call_region, std::prev(it)->back());
             } else {
                 region = right_overhang_region(it->back(), std::prev(it)->back());
             }
-            result.at(sample).insert(extract_genotype(*it, region, sample, reference));
+            result.at(sample).insert(extract_genotype(*it, region, sample, reference, ref_window, buffers));
         }
     }
     
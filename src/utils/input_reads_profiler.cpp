@@ -7,7 +7,11 @@
 #include <deque>
 #include <iterator>
 #include <algorithm>
+#include <array>
+#include <numeric>
 #include <utility>
+#include <future>
+#include <thread>
 #include <cassert>
 
 #include "mappable_algorithms.hpp"
@@ -59,9 +63,15 @@ auto get_covered_sample_regions(const std::vector<SampleName>& samples, const In
     result.reserve(input_regions.size());
     for (const auto& p : input_regions) {
         InputRegionMap::mapped_type contig_regions {};
+        // The index metadata check is instant and definitive when negative, so
+        // regions without reads are discarded without touching any file; only
+        // regions the indices claim are covered are actually probed for reads
         std::copy_if(std::cbegin(p.second), std::cend(p.second),
                      std::inserter(contig_regions, std::begin(contig_regions)),
-                     [&] (const auto& region) { return read_manager.has_reads(samples, region); });
+                     [&] (const auto& region) {
+                         return read_manager.could_contain_reads(samples, region)
+                                && read_manager.has_reads(samples, region);
+                     });
         if (!contig_regions.empty()) {
             result.emplace(p.first, std::move(contig_regions));
         }
@@ -69,22 +79,23 @@ auto get_covered_sample_regions(const std::vector<SampleName>& samples, const In
     return result;
 }
 
-auto choose_sample_region(const GenomicRegion& from, GenomicRegion::Size max_size)
+auto choose_sample_region(const GenomicRegion& from, GenomicRegion::Size max_size,
+                          std::default_random_engine& gen)
 {
     if (size(from) <= max_size) return from;
     const auto max_begin = from.end() - max_size;
-    static std::default_random_engine gen {};
     std::uniform_int_distribution<GenomicRegion::Position> dist {from.begin(), max_begin};
     return GenomicRegion {from.contig_name(), dist(gen), from.end()};
 }
 
 auto draw_sample(const SampleName& sample, const InputRegionMap& regions,
-                 const ReadManager& source, const ReadSetProfileConfig& config)
+                 const ReadManager& source, const ReadSetProfileConfig& config,
+                 std::default_random_engine& gen)
 {
-    const auto contig_itr = random_select(std::cbegin(regions), std::cend(regions));
+    const auto contig_itr = random_select(std::cbegin(regions), std::cend(regions), gen);
     assert(!contig_itr->second.empty());
-    const auto region_itr = random_select(std::cbegin(contig_itr->second), std::cend(contig_itr->second));
-    const auto sample_region = choose_sample_region(*region_itr, config.max_sample_size);
+    const auto region_itr = random_select(std::cbegin(contig_itr->second), std::cend(contig_itr->second), gen);
+    const auto sample_region = choose_sample_region(*region_itr, config.max_sample_size, gen);
     auto test_region = source.find_covered_subregion(sample, sample_region, config.max_sample_size);
     if (is_empty(test_region)) {
         test_region = expand_rhs(test_region, 1);
@@ -93,11 +104,12 @@ auto draw_sample(const SampleName& sample, const InputRegionMap& regions,
 }
 
 auto draw_sample_from_begin(const SampleName& sample, const InputRegionMap& regions,
-                            const ReadManager& source, const ReadSetProfileConfig& config)
+                            const ReadManager& source, const ReadSetProfileConfig& config,
+                            std::default_random_engine& gen)
 {
-    const auto contig_itr = random_select(std::cbegin(regions), std::cend(regions));
+    const auto contig_itr = random_select(std::cbegin(regions), std::cend(regions), gen);
     assert(!contig_itr->second.empty());
-    const auto region_itr = random_select(std::cbegin(contig_itr->second), std::cend(contig_itr->second));
+    const auto region_itr = random_select(std::cbegin(contig_itr->second), std::cend(contig_itr->second), gen);
     auto test_region = source.find_covered_subregion(sample, *region_itr, config.max_sample_size);
     if (is_empty(test_region)) {
         test_region = expand_rhs(test_region, 1);
@@ -105,6 +117,37 @@ auto draw_sample_from_begin(const SampleName& sample, const InputRegionMap& regi
     return source.fetch_reads(sample, test_region);
 }
 
+// Maintains a fixed capacity uniform random sample of a stream of values
+// (Vitter's algorithm R), so the per-read statistics stay bounded however
+// many reads the drawn regions turn out to contain
+template <typename T>
+class ReservoirSampler
+{
+public:
+    ReservoirSampler(std::size_t capacity) : capacity_ {capacity} { samples_.reserve(capacity_); }
+    
+    void add(T value, std::default_random_engine& gen)
+    {
+        ++num_observed_;
+        if (samples_.size() < capacity_) {
+            samples_.push_back(std::move(value));
+        } else {
+            std::uniform_int_distribution<std::size_t> dist {0, num_observed_ - 1};
+            const auto idx = dist(gen);
+            if (idx < capacity_) samples_[idx] = std::move(value);
+        }
+    }
+    
+    bool empty() const noexcept { return samples_.empty(); }
+    const std::vector<T>& samples() const noexcept { return samples_; }
+    std::vector<T> extract() noexcept { return std::move(samples_); }
+    
+private:
+    std::vector<T> samples_;
+    std::size_t capacity_;
+    std::size_t num_observed_ = 0;
+};
+
 using ReadSetSamples = std::vector<ReadManager::ReadContainer>;
 
 bool all_empty(const ReadSetSamples& samples)
@@ -113,14 +156,15 @@ bool all_empty(const ReadSetSamples& samples)
 }
 
 auto draw_samples(const SampleName& sample, const InputRegionMap& regions,
-                  const ReadManager& source, const ReadSetProfileConfig& config)
+                  const ReadManager& source, const ReadSetProfileConfig& config,
+                  std::default_random_engine& gen)
 {
     ReadSetSamples result {};
     result.reserve(config.max_samples_per_sample);
     std::generate_n(std::back_inserter(result), config.max_samples_per_sample,
-                    [&] () { return draw_sample(sample, regions, source, config); });
+                    [&] () { return draw_sample(sample, regions, source, config, gen); });
     if (all_empty(result)) {
-        result.back() = draw_sample_from_begin(sample, regions, source, config);
+        result.back() = draw_sample_from_begin(sample, regions, source, config, gen);
     }
     return result;
 }
@@ -128,22 +172,58 @@ auto draw_samples(const SampleName& sample, const InputRegionMap& regions,
 auto draw_samples(const std::vector<SampleName>& samples, const InputRegionMap& regions,
                   const ReadManager& source, const ReadSetProfileConfig& config)
 {
-    std::vector<ReadSetSamples> result {};
-    result.reserve(samples.size());
-    for (const auto& sample : samples) {
-        result.push_back(draw_samples(sample, regions, source, config));
+    std::vector<ReadSetSamples> result(samples.size());
+    const auto num_workers = std::min(static_cast<std::size_t>(std::thread::hardware_concurrency()), samples.size());
+    if (num_workers > 1) {
+        // Samples are drawn independently and the read manager is safe to share,
+        // so profiling strides over concurrent workers, each with its own
+        // generator to keep the draws data race free
+        std::vector<std::future<void>> draws {};
+        draws.reserve(num_workers);
+        for (std::size_t w {0}; w < num_workers; ++w) {
+            draws.push_back(std::async(std::launch::async, [&, w] () {
+                std::default_random_engine gen {static_cast<std::default_random_engine::result_type>(w)};
+                for (auto s = w; s < samples.size(); s += num_workers) {
+                    result[s] = draw_samples(samples[s], regions, source, config, gen);
+                }
+            }));
+        }
+        for (auto& draw : draws) draw.get();
+    } else {
+        std::default_random_engine gen {};
+        for (std::size_t s {0}; s < samples.size(); ++s) {
+            result[s] = draw_samples(samples[s], regions, source, config, gen);
+        }
     }
     return result;
 }
 
-auto get_read_bytes(const std::vector<ReadSetSamples>& read_sets)
+using BaseQualityCounts = std::array<std::size_t, 1 + std::numeric_limits<std::uint8_t>::max()>;
+
+// The smallest set of base quality values covering at least the requested
+// mass of the counted bases, or empty if no set within the palette size
+// limit does - an unbinned quality alphabet has no useful palette
+auto extract_base_quality_palette(const BaseQualityCounts& counts, const ReadSetProfileConfig& config)
 {
-    std::deque<std::size_t> result {};
-    for (const auto& set : read_sets) {
-        for (const auto& reads : set) {
-            std::transform(std::cbegin(reads), std::cend(reads), std::back_inserter(result), estimate_read_size);
+    std::vector<AlignedRead::BaseQuality> result {};
+    const auto num_bases = std::accumulate(std::cbegin(counts), std::cend(counts), std::size_t {0});
+    if (num_bases == 0) return result;
+    std::vector<AlignedRead::BaseQuality> qualities(counts.size());
+    std::iota(std::begin(qualities), std::end(qualities), AlignedRead::BaseQuality {0});
+    std::sort(std::begin(qualities), std::end(qualities),
+              [&] (const auto lhs, const auto rhs) { return counts[lhs] > counts[rhs]; });
+    const auto min_covered_bases = static_cast<std::size_t>(config.min_base_quality_palette_mass * num_bases);
+    std::size_t covered_bases {0};
+    for (const auto quality : qualities) {
+        if (result.size() == config.max_base_quality_palette_size) {
+            result.clear();
+            break;
         }
+        result.push_back(quality);
+        covered_bases += counts[quality];
+        if (covered_bases >= min_covered_bases) break;
     }
+    std::sort(std::begin(result), std::end(result));
     return result;
 }
 
@@ -160,26 +240,33 @@ profile_reads(const std::vector<SampleName>& samples,
     if (sampling_regions.empty()) return boost::none;
     const auto read_sets = draw_samples(samples, sampling_regions, source, config);
     if (read_sets.empty()) return boost::none;
-    const auto bytes = get_read_bytes(read_sets);
-    if (bytes.empty()) return boost::none;
+    std::default_random_engine gen {};
+    ReservoirSampler<std::size_t> read_bytes {config.max_read_samples};
+    ReservoirSampler<unsigned> read_lengths {config.max_read_samples};
     ReadSetProfile result {};
-    result.mean_read_bytes = maths::mean(bytes);
-    result.read_bytes_stdev = maths::stdev(bytes);
     result.sample_mean_depth.resize(samples.size());
     result.sample_depth_stdev.resize(samples.size());
+    result.max_read_length = 0;
     result.max_mapping_quality = 0;
+    result.sample_base_quality_palette.resize(samples.size());
     std::deque<unsigned> depths {};
-    std::vector<unsigned> read_lengths {};
     for (std::size_t s {0}; s < samples.size(); ++s) {
         std::deque<unsigned> sample_depths {};
+        BaseQualityCounts sample_base_quality_counts {};
         for (const auto& reads : read_sets[s]) {
             if (!reads.empty()) {
                 utils::append(calculate_positional_coverage(reads), sample_depths);
-                read_lengths.reserve(read_lengths.size() + reads.size());
-                std::transform(std::cbegin(reads), std::cend(reads), std::back_inserter(read_lengths),
-                               [] (const auto& read) { return sequence_size(read); });
+                for (const auto& read : reads) {
+                    read_bytes.add(estimate_read_size(read), gen);
+                    read_lengths.add(sequence_size(read), gen);
+                    result.max_read_length = std::max(result.max_read_length, sequence_size(read));
+                    for (const auto quality : read.base_qualities()) {
+                        ++sample_base_quality_counts[quality];
+                    }
+                }
             }
         }
+        result.sample_base_quality_palette[s] = extract_base_quality_palette(sample_base_quality_counts, config);
         if (!sample_depths.empty()) {
             result.sample_mean_depth[s] = maths::mean(sample_depths);
             result.sample_depth_stdev[s] = maths::stdev(sample_depths);
@@ -189,11 +276,14 @@ profile_reads(const std::vector<SampleName>& samples,
         }
         utils::append(std::move(sample_depths), depths);
     }
+    if (read_bytes.empty()) return boost::none;
+    result.mean_read_bytes = maths::mean(read_bytes.samples());
+    result.read_bytes_stdev = maths::stdev(read_bytes.samples());
     assert(!depths.empty());
     result.mean_depth = maths::mean(depths);
     result.depth_stdev = maths::stdev(depths);
-    result.max_read_length = *std::max_element(std::cbegin(read_lengths), std::cend(read_lengths));
-    result.median_read_length = maths::median(read_lengths);
+    auto length_samples = read_lengths.extract();
+    result.median_read_length = maths::median(length_samples);
     return result;
 }
 
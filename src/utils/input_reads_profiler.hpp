@@ -20,6 +20,9 @@ struct ReadSetProfileConfig
 {
     unsigned max_samples_per_sample = 10;
     unsigned max_sample_size = 1000;
+    std::size_t max_read_samples = 100'000; // per-read statistics reservoir capacity
+    unsigned max_base_quality_palette_size = 8;
+    double min_base_quality_palette_mass = 0.999;
 };
 
 struct ReadSetProfile
@@ -30,6 +33,10 @@ struct ReadSetProfile
     std::vector<std::size_t> sample_depth_stdev;
     AlignedRead::NucleotideSequence::size_type max_read_length, median_read_length;
     AlignedRead::MappingQuality max_mapping_quality;
+    // Per sample, the few base quality values that cover nearly all sampled
+    // bases, sorted ascending; empty when the sample's quality alphabet is
+    // not small (e.g. instruments that emit unbinned qualities)
+    std::vector<std::vector<AlignedRead::BaseQuality>> sample_base_quality_palette;
 };
 
 boost::optional<ReadSetProfile>
@@ -28,4 +28,18 @@ map_query_to_target(const KmerPerfectHashes& query, const KmerHashTable& target)
     return  map_query_to_target(query, target, mapping_counts);
 }
 
+unsigned max_query_to_target_hits(const KmerPerfectHashes& query, const KmerHashTable& target,
+                                  MappedIndexCounts& mapping_counts)
+{
+    unsigned result {0};
+    for (std::size_t query_index {0}; query_index < query.size(); ++query_index) {
+        for (const auto target_index : target.first[query[query_index]]) {
+            if (target_index >= query_index) {
+                result = std::max(result, ++mapping_counts[target_index - query_index]);
+            }
+        }
+    }
+    return result;
+}
+
 } // namespace octopus
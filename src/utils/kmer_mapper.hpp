@@ -39,11 +39,12 @@ constexpr auto perfect_hash(const char base) noexcept
 
 using KmerHashType = std::uint_fast32_t;
 
+// The hash is the kmer packed two bits per base (non-ACGT bases encode as 'A')
 template <unsigned char K, typename InputIt>
 constexpr auto perfect_kmer_hash(InputIt first)
 {
     unsigned k {1};
-    
+
     return std::accumulate(first, std::next(first, K), KmerHashType {0},
                            [&k] (const unsigned curr, const char base) {
                                const auto result = curr + k * perfect_hash(base);
@@ -52,6 +53,14 @@ constexpr auto perfect_kmer_hash(InputIt first)
                            });
 }
 
+// Advances the packed kmer window one base by dropping the leading base's two
+// bits and packing the next base on top, avoiding rehashing the full kmer
+template <unsigned char K>
+constexpr auto roll_kmer_hash(const KmerHashType hash, const char next_base) noexcept
+{
+    return (hash >> 2) | (static_cast<KmerHashType>(perfect_hash(next_base)) << (2 * (K - 1)));
+}
+
 using KmerPerfectHashes = std::vector<KmerHashType>;
 
 template <unsigned char K>
@@ -62,13 +71,17 @@ auto compute_kmer_hashes(const std::string& sequence)
     }
     
     KmerPerfectHashes result(sequence.size() - K + 1);
-    
+
     auto result_it = std::begin(result);
-    
-    for (auto it = std::cbegin(sequence); it != std::prev(std::cend(sequence), K - 1); ++it, ++result_it) {
-        *result_it = perfect_kmer_hash<K>(it);
+
+    auto hash = perfect_kmer_hash<K>(std::cbegin(sequence));
+    *result_it++ = hash;
+
+    for (auto it = std::next(std::cbegin(sequence), K); it != std::cend(sequence); ++it, ++result_it) {
+        hash = roll_kmer_hash<K>(hash, *it);
+        *result_it = hash;
     }
-    
+
     return result;
 }
 
@@ -86,6 +99,18 @@ inline void clear_kmer_hash_table(KmerHashTable& table)
     table.second = 0;
 }
 
+// Returns a cleared thread-local hash table whose bins keep their capacity
+// between uses, so callers that rebuild a short-lived table per target (one
+// per haplotype, usually) don't pay to reallocate every bin each time. The
+// memory is only reclaimed when the thread exits.
+template <unsigned char K>
+KmerHashTable& thread_local_kmer_hash_table()
+{
+    thread_local auto table = init_kmer_hash_table<K>();
+    clear_kmer_hash_table(table);
+    return table;
+}
+
 template <unsigned char K>
 void populate_kmer_hash_table(const std::string& sequence, KmerHashTable& result)
 {
@@ -94,23 +119,72 @@ void populate_kmer_hash_table(const std::string& sequence, KmerHashTable& result
     }
     
     const auto last_index = sequence.size() - K;
-    
-    auto it = std::cbegin(sequence);
-    
-    for (std::size_t index {0}; index <= last_index; ++index, ++it) {
-        result.first[perfect_kmer_hash<K>(it)].push_back(index);
+
+    auto hash = perfect_kmer_hash<K>(std::cbegin(sequence));
+    result.first[hash].push_back(0);
+
+    auto it = std::next(std::cbegin(sequence), K);
+
+    for (std::size_t index {1}; index <= last_index; ++index, ++it) {
+        hash = roll_kmer_hash<K>(hash, *it);
+        result.first[hash].push_back(index);
     }
-    
-    for (auto& bin : result.first) bin.shrink_to_fit();
-    
+
     result.second = sequence.size() - K + 1;
 }
 
+// Rebinds a table built for one sequence onto another in place. Haplotypes
+// from one region usually differ at a few substituted sites, in which case
+// only the kmers overlapping the changed bases need rebinning; an indel
+// shifts every downstream position, so any length change (or too many
+// differences) falls back to a full rebuild.
+template <unsigned char K>
+void update_kmer_hash_table(const std::string& prev, const std::string& curr, KmerHashTable& result)
+{
+    if (prev.size() == curr.size() && curr.size() >= K) {
+        const auto max_diffs = std::max(std::size_t {1}, curr.size() / (8 * K));
+        std::vector<std::size_t> diffs {};
+        diffs.reserve(max_diffs + 1);
+        for (std::size_t index {0}; index < curr.size(); ++index) {
+            if (prev[index] != curr[index]) {
+                diffs.push_back(index);
+                if (diffs.size() > max_diffs) break;
+            }
+        }
+        if (diffs.size() <= max_diffs) {
+            const auto last_index = curr.size() - K;
+            std::size_t next_unprocessed {0}; // kmer starts below this are already rebinned
+            for (const auto site : diffs) {
+                auto first_affected = site >= K - 1 ? site - (K - 1) : 0;
+                first_affected = std::max(first_affected, next_unprocessed);
+                const auto last_affected = std::min(site, last_index);
+                for (auto index = first_affected; index <= last_affected; ++index) {
+                    const auto old_hash = perfect_kmer_hash<K>(std::next(std::cbegin(prev), index));
+                    const auto new_hash = perfect_kmer_hash<K>(std::next(std::cbegin(curr), index));
+                    if (old_hash != new_hash) {
+                        // The bins hold each sequence position exactly once, in
+                        // increasing order
+                        auto& old_bin = result.first[old_hash];
+                        old_bin.erase(std::lower_bound(std::begin(old_bin), std::end(old_bin), index));
+                        auto& new_bin = result.first[new_hash];
+                        new_bin.insert(std::lower_bound(std::begin(new_bin), std::end(new_bin), index), index);
+                    }
+                }
+                next_unprocessed = std::max(next_unprocessed, last_affected + 1);
+            }
+            return;
+        }
+    }
+    clear_kmer_hash_table(result);
+    populate_kmer_hash_table<K>(curr, result);
+}
+
 template <unsigned char K>
 KmerHashTable make_kmer_hash_table(const std::string& sequence)
 {
     auto result = init_kmer_hash_table<K>();
     populate_kmer_hash_table<K>(sequence, result);
+    for (auto& bin : result.first) bin.shrink_to_fit();
     return result;
 }
 
@@ -184,6 +258,12 @@ map_query_to_target(const KmerPerfectHashes& query, const KmerHashTable& target,
 std::vector<std::size_t>
 map_query_to_target(const KmerPerfectHashes& query, const KmerHashTable& target);
 
+// Returns the hit count of the query's best mapping position, for callers that
+// only need a similarity score and not the positions themselves. The mapping
+// counts are left dirty, as with map_query_to_target.
+unsigned max_query_to_target_hits(const KmerPerfectHashes& query, const KmerHashTable& target,
+                                  MappedIndexCounts& mapping_counts);
+
 template <unsigned char K>
 std::vector<std::size_t> map_query_to_target(const std::string& query, const std::string& target)
 {
@@ -5,7 +5,9 @@
 #define maths_hpp
 
 #include <vector>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <cmath>
 #include <numeric>
 #include <algorithm>
@@ -34,6 +36,49 @@ namespace constants
     constexpr T ln10Div10 = T {0.230258509299404568401799145468436420760110148862877297603};
 }
 
+namespace detail {
+
+template <std::size_t N>
+constexpr auto make_phred_to_error_probability_lookup() noexcept
+{
+    std::array<double, N> result {};
+    constexpr double tenthRoot {0.794328234724281502065918393184512007130882518152084162063}; // 10^(-1/10)
+    double p {1};
+    for (std::size_t i {0}; i < N; ++i) {
+        // This const_cast mess is because std::array::operator[] is not marked constexpr (until C++17)
+        const_cast<double&>(static_cast<std::array<double, N> const&>(result)[i]) = p;
+        p *= tenthRoot;
+    }
+    return result;
+}
+
+template <std::size_t N>
+constexpr auto make_phred_to_ln_error_probability_lookup() noexcept
+{
+    std::array<double, N> result {};
+    for (std::size_t i {0}; i < N; ++i) {
+        const_cast<double&>(static_cast<std::array<double, N> const&>(result)[i]) = -constants::ln10Div10<> * i;
+    }
+    return result;
+}
+
+} // namespace detail
+
+// Phred-to-probability conversions over the full byte quality range, generated
+// at compile time so hot per-base loops never call std::pow or std::log
+
+inline double phred_to_error_probability(const std::uint8_t quality) noexcept
+{
+    static constexpr auto lookup = detail::make_phred_to_error_probability_lookup<256>();
+    return lookup[quality];
+}
+
+inline double phred_to_ln_error_probability(const std::uint8_t quality) noexcept
+{
+    static constexpr auto lookup = detail::make_phred_to_ln_error_probability_lookup<256>();
+    return lookup[quality];
+}
+
 template <typename RealType,
           typename = std::enable_if_t<std::is_floating_point<RealType>::value>>
 RealType round(const RealType val, const unsigned precision = 2)
@@ -267,6 +312,43 @@ auto log_sum_exp(ForwardIt first, ForwardIt last)
                                           }));
 }
 
+// Fused max + sum log_sum_exp over contiguous values: a single sweep keeps the
+// running maximum and rescales the partial sum whenever it grows, so the data
+// is only read once rather than once for the maximum and again for the sum
+template <typename RealType,
+          typename = std::enable_if_t<std::is_floating_point<RealType>::value>>
+RealType log_sum_exp(const RealType* values, const std::size_t count)
+{
+    assert(count > 0);
+    auto max = values[0];
+    RealType sum {1};
+    for (std::size_t i {1}; i < count; ++i) {
+        const auto x = values[i];
+        if (x <= max) {
+            sum += std::exp(x - max);
+        } else {
+            sum *= std::exp(max - x);
+            sum += RealType {1};
+            max = x;
+        }
+    }
+    return max + std::log(sum);
+}
+
+template <typename RealType, typename Allocator,
+          typename = std::enable_if_t<std::is_floating_point<RealType>::value>>
+RealType log_sum_exp(const std::vector<RealType, Allocator>& values)
+{
+    return log_sum_exp(values.data(), values.size());
+}
+
+template <typename RealType, std::size_t N,
+          typename = std::enable_if_t<std::is_floating_point<RealType>::value>>
+RealType log_sum_exp(const std::array<RealType, N>& values)
+{
+    return log_sum_exp(values.data(), values.size());
+}
+
 template <typename Container>
 auto log_sum_exp(const Container& values)
 {
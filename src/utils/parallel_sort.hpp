@@ -0,0 +1,137 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef parallel_sort_hpp
+#define parallel_sort_hpp
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+#include "thread_pool.hpp"
+
+namespace octopus {
+
+// Below this many elements the submission and merge overheads outweigh any
+// parallel speedup, so the sorts fall back to the standard algorithms
+constexpr std::size_t minParallelSortSize {65'536};
+
+namespace detail {
+
+// Merges consecutive sorted runs delimited by bounds - bounds.front() is the
+// start of the range, bounds.back() the end - pairwise per level until a single
+// run remains. Merges within a level are independent and run on the pool. Stable
+template <typename RandomIt, typename Compare>
+void merge_adjacent_runs(std::vector<RandomIt>& bounds, Compare comp, ThreadPool& workers)
+{
+    while (bounds.size() > 2) {
+        std::vector<std::future<void>> merges {};
+        merges.reserve(bounds.size() / 2);
+        std::vector<RandomIt> next_bounds {};
+        next_bounds.reserve(bounds.size() / 2 + 1);
+        next_bounds.push_back(bounds.front());
+        std::size_t i {0};
+        for (; i + 2 < bounds.size(); i += 2) {
+            const auto run_first = bounds[i], run_middle = bounds[i + 1], run_last = bounds[i + 2];
+            merges.push_back(workers.push([run_first, run_middle, run_last, comp] () {
+                std::inplace_merge(run_first, run_middle, run_last, comp);
+            }));
+            next_bounds.push_back(run_last);
+        }
+        if (i + 1 < bounds.size()) {
+            next_bounds.push_back(bounds.back()); // odd run out; passes through to the next level
+        }
+        for (auto& merge : merges) merge.get();
+        bounds = std::move(next_bounds);
+    }
+}
+
+template <typename RandomIt, typename Compare, typename ChunkSort>
+void parallel_merge_sort(RandomIt first, RandomIt last, Compare comp, ThreadPool& workers, ChunkSort chunk_sort)
+{
+    const auto size = static_cast<std::size_t>(std::distance(first, last));
+    const auto num_chunks = workers.size();
+    const auto chunk_size = (size + num_chunks - 1) / num_chunks;
+    std::vector<RandomIt> bounds {};
+    bounds.reserve(num_chunks + 1);
+    bounds.push_back(first);
+    for (auto itr = first; itr != last;) {
+        itr = static_cast<std::size_t>(std::distance(itr, last)) > chunk_size ? std::next(itr, chunk_size) : last;
+        bounds.push_back(itr);
+    }
+    std::vector<std::future<void>> sorts {};
+    sorts.reserve(bounds.size() - 1);
+    for (std::size_t i {0}; i + 1 < bounds.size(); ++i) {
+        const auto chunk_first = bounds[i], chunk_last = bounds[i + 1];
+        sorts.push_back(workers.push([chunk_first, chunk_last, comp, chunk_sort] () {
+            chunk_sort(chunk_first, chunk_last, comp);
+        }));
+    }
+    for (auto& sort : sorts) sort.get();
+    merge_adjacent_runs(bounds, comp, workers);
+}
+
+} // namespace detail
+
+// Thread-pool based merge sort: the range is split into one chunk per worker,
+// chunks are sorted concurrently, and the sorted runs then merged pairwise in
+// parallel levels. The calling thread blocks until the range is sorted, so it
+// must not itself be one of the pool's workers
+
+template <typename RandomIt, typename Compare>
+void parallel_sort(RandomIt first, RandomIt last, Compare comp, ThreadPool& workers)
+{
+    const auto size = static_cast<std::size_t>(std::distance(first, last));
+    if (workers.size() < 2 || size < minParallelSortSize) {
+        std::sort(first, last, comp);
+    } else {
+        detail::parallel_merge_sort(first, last, comp, workers,
+                                    [] (RandomIt chunk_first, RandomIt chunk_last, Compare chunk_comp) {
+                                        std::sort(chunk_first, chunk_last, chunk_comp);
+                                    });
+    }
+}
+
+template <typename RandomIt>
+void parallel_sort(RandomIt first, RandomIt last, ThreadPool& workers)
+{
+    parallel_sort(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type> {}, workers);
+}
+
+template <typename RandomIt, typename Compare>
+void parallel_stable_sort(RandomIt first, RandomIt last, Compare comp, ThreadPool& workers)
+{
+    const auto size = static_cast<std::size_t>(std::distance(first, last));
+    if (workers.size() < 2 || size < minParallelSortSize) {
+        std::stable_sort(first, last, comp);
+    } else {
+        detail::parallel_merge_sort(first, last, comp, workers,
+                                    [] (RandomIt chunk_first, RandomIt chunk_last, Compare chunk_comp) {
+                                        std::stable_sort(chunk_first, chunk_last, chunk_comp);
+                                    });
+    }
+}
+
+template <typename RandomIt>
+void parallel_stable_sort(RandomIt first, RandomIt last, ThreadPool& workers)
+{
+    parallel_stable_sort(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type> {}, workers);
+}
+
+// Merges consecutive sorted runs delimited by bounds into a single sorted
+// range, as the final phase of a merge sort whose runs were produced elsewhere
+template <typename RandomIt, typename Compare>
+void parallel_merge_runs(std::vector<RandomIt> bounds, Compare comp, ThreadPool& workers)
+{
+    if (bounds.size() > 2) {
+        detail::merge_adjacent_runs(bounds, comp, workers);
+    }
+}
+
+} // namespace octopus
+
+#endif
@@ -129,10 +129,11 @@ std::vector<GenomicRegion> find_uniform_coverage_regions(const T& reads)
 
 namespace detail {
 
-inline MappableFlatMultiSet<AlignedRead>
-copy_each(const MappableFlatMultiSet<AlignedRead>& reads, const GenomicRegion& region, NonMapTag)
+template <typename Allocator>
+MappableFlatMultiSet<AlignedRead, Allocator>
+copy_each(const MappableFlatMultiSet<AlignedRead, Allocator>& reads, const GenomicRegion& region, NonMapTag)
 {
-    MappableFlatMultiSet<AlignedRead> result {};
+    MappableFlatMultiSet<AlignedRead, Allocator> result {};
     result.reserve(reads.size());
     for (const auto& read : reads) {
         result.emplace(copy(read, region));
@@ -0,0 +1,281 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "reference_repeat_index.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "io/reference/reference_genome.hpp"
+
+namespace octopus {
+
+namespace {
+
+constexpr char indexMagic[8] {'O', 'C', 'T', 'O', 'R', 'E', 'P', 'T'};
+constexpr std::uint32_t indexVersion {1};
+
+struct IndexHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t max_period;
+    std::uint32_t num_contigs;
+    std::uint32_t reserved;
+    std::uint64_t index_offset;
+};
+
+static_assert(sizeof(IndexHeader) == 32, "IndexHeader is not packed as expected");
+
+} // namespace
+
+ReferenceRepeatIndex::ReferenceRepeatIndex(Path index_path)
+: path_ {std::move(index_path)}
+{
+    static_assert(sizeof(Record) == 12, "index Record is not packed as expected");
+    map_and_index();
+}
+
+ReferenceRepeatIndex::ReferenceRepeatIndex(const ReferenceRepeatIndex& other)
+: path_ {other.path_}
+{
+    map_and_index();
+}
+
+ReferenceRepeatIndex& ReferenceRepeatIndex::operator=(const ReferenceRepeatIndex& other)
+{
+    if (this != &other) {
+        *this = ReferenceRepeatIndex {other};
+    }
+    return *this;
+}
+
+ReferenceRepeatIndex::ReferenceRepeatIndex(ReferenceRepeatIndex&& other) noexcept
+: path_ {std::move(other.path_)}
+, data_ {other.data_}
+, size_ {other.size_}
+, max_period_ {other.max_period_}
+, contigs_ {std::move(other.contigs_)}
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+ReferenceRepeatIndex& ReferenceRepeatIndex::operator=(ReferenceRepeatIndex&& other) noexcept
+{
+    using std::swap;
+    swap(path_, other.path_);
+    swap(data_, other.data_);
+    swap(size_, other.size_);
+    swap(max_period_, other.max_period_);
+    swap(contigs_, other.contigs_);
+    return *this;
+}
+
+ReferenceRepeatIndex::~ReferenceRepeatIndex() noexcept
+{
+    unmap();
+}
+
+const ReferenceRepeatIndex::Path& ReferenceRepeatIndex::path() const noexcept
+{
+    return path_;
+}
+
+unsigned ReferenceRepeatIndex::max_indexed_period() const noexcept
+{
+    return max_period_;
+}
+
+std::vector<TandemRepeat>
+ReferenceRepeatIndex::fetch_overlapped(const GenomicRegion& region, const GenomicRegion::Size max_period) const
+{
+    std::vector<TandemRepeat> result {};
+    const auto contig_itr = contigs_.find(region.contig_name());
+    if (contig_itr == std::cend(contigs_)) return result;
+    const auto& contig = contig_itr->second;
+    const auto region_begin = static_cast<std::uint32_t>(region.begin());
+    const auto region_end   = static_cast<std::uint32_t>(region.end());
+    // No record starting before this position can reach into the requested region
+    const std::uint32_t min_begin {region_begin > contig.max_length ? region_begin - contig.max_length : 0};
+    auto record_itr = std::lower_bound(contig.records, contig.records + contig.num_records, min_begin,
+                                       [] (const Record& record, const std::uint32_t begin) {
+                                           return record.begin < begin;
+                                       });
+    for (; record_itr != contig.records + contig.num_records; ++record_itr) {
+        if (record_itr->begin >= region_end) break;
+        if (record_itr->period > max_period) continue;
+        const auto record_end = record_itr->begin + record_itr->length;
+        if (record_end > region_begin) {
+            const auto clipped_begin = std::max(record_itr->begin, region_begin);
+            const auto clipped_end   = std::min(record_end, region_end);
+            if (clipped_end - clipped_begin >= 2 * record_itr->period) {
+                result.emplace_back(GenomicRegion {region.contig_name(), clipped_begin, clipped_end},
+                                    record_itr->period);
+            }
+        }
+    }
+    // Clipping can reorder runs that started before the region
+    std::sort(std::begin(result), std::end(result),
+              [] (const TandemRepeat& lhs, const TandemRepeat& rhs) {
+                  return lhs.region < rhs.region;
+              });
+    return result;
+}
+
+void ReferenceRepeatIndex::map_and_index()
+{
+    const auto fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error {"ReferenceRepeatIndex: could not open " + path_.string()};
+    }
+    struct ::stat file_stats;
+    if (::fstat(fd, &file_stats) < 0 || file_stats.st_size < static_cast<off_t>(sizeof(IndexHeader))) {
+        ::close(fd);
+        throw std::runtime_error {"ReferenceRepeatIndex: could not read " + path_.string()};
+    }
+    size_ = static_cast<std::size_t>(file_stats.st_size);
+    const auto mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        size_ = 0;
+        throw std::runtime_error {"ReferenceRepeatIndex: could not map " + path_.string()};
+    }
+    data_ = static_cast<const char*>(mapping);
+    IndexHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (!std::equal(std::cbegin(indexMagic), std::cend(indexMagic), header.magic)
+        || header.version != indexVersion
+        || header.index_offset == 0 || header.index_offset > size_) {
+        unmap();
+        throw std::runtime_error {path_.string() + " is not a valid reference repeat index"};
+    }
+    max_period_ = header.max_period;
+    const char* index_itr {data_ + header.index_offset};
+    contigs_.reserve(header.num_contigs);
+    for (std::uint32_t i {0}; i < header.num_contigs; ++i) {
+        std::uint32_t name_length;
+        std::memcpy(&name_length, index_itr, sizeof(name_length));
+        index_itr += sizeof(name_length);
+        std::string name {index_itr, index_itr + name_length};
+        index_itr += name_length;
+        std::uint64_t records_offset, num_records;
+        std::uint32_t max_length;
+        std::memcpy(&records_offset, index_itr, sizeof(records_offset));
+        index_itr += sizeof(records_offset);
+        std::memcpy(&num_records, index_itr, sizeof(num_records));
+        index_itr += sizeof(num_records);
+        std::memcpy(&max_length, index_itr, sizeof(max_length));
+        index_itr += sizeof(max_length);
+        contigs_.emplace(std::move(name),
+                         ContigIndex {reinterpret_cast<const Record*>(data_ + records_offset),
+                                      num_records, max_length});
+    }
+}
+
+void ReferenceRepeatIndex::unmap() noexcept
+{
+    if (data_) {
+        ::munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+ReferenceRepeatIndex::Path reference_repeat_index_path(const ReferenceRepeatIndex::Path& reference_path)
+{
+    return reference_path.string() + ".repeats";
+}
+
+namespace {
+
+template <typename T>
+void write_value(std::ofstream& index, const T& value)
+{
+    index.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+void build_reference_repeat_index(const ReferenceGenome& reference, const ReferenceRepeatIndex::Path& index_path,
+                                  const unsigned max_period)
+{
+    std::ofstream index {index_path.string(), std::ios::binary | std::ios::trunc};
+    if (!index) {
+        throw std::runtime_error {"could not write reference repeat index " + index_path.string()};
+    }
+    IndexHeader header {};
+    std::copy(std::cbegin(indexMagic), std::cend(indexMagic), header.magic);
+    header.version    = indexVersion;
+    header.max_period = max_period;
+    index.write(reinterpret_cast<const char*>(&header), sizeof(header)); // index_offset patched below
+    struct IndexEntry
+    {
+        std::string name;
+        std::uint64_t records_offset, num_records;
+        std::uint32_t max_length;
+    };
+    std::vector<IndexEntry> contig_entries {};
+    std::uint64_t block_offset {sizeof(IndexHeader)};
+    for (const auto& contig : reference.contig_names()) {
+        const auto contig_region = reference.contig_region(contig);
+        auto sequence = reference.fetch_sequence(contig_region);
+        auto repeats = find_exact_tandem_repeats(sequence, contig_region, 1, max_period);
+        // The run extraction can emit a sub-run of a longer run with the same
+        // period, depending on surrounding sequence; only the maximal runs are
+        // meaningful, so contained duplicates are dropped from the index
+        std::sort(std::begin(repeats), std::end(repeats),
+                  [] (const TandemRepeat& lhs, const TandemRepeat& rhs) {
+                      if (lhs.region.begin() != rhs.region.begin()) return lhs.region.begin() < rhs.region.begin();
+                      if (lhs.region.end() != rhs.region.end()) return lhs.region.end() > rhs.region.end();
+                      return lhs.period < rhs.period;
+                  });
+        std::vector<GenomicRegion::Position> max_ends(max_period + 1, 0);
+        repeats.erase(std::remove_if(std::begin(repeats), std::end(repeats),
+                                     [&max_ends] (const TandemRepeat& repeat) {
+                                         if (repeat.region.end() <= max_ends[repeat.period]) return true;
+                                         max_ends[repeat.period] = repeat.region.end();
+                                         return false;
+                                     }), std::end(repeats));
+        std::sort(std::begin(repeats), std::end(repeats),
+                  [] (const TandemRepeat& lhs, const TandemRepeat& rhs) {
+                      return lhs.region < rhs.region;
+                  });
+        IndexEntry entry {};
+        entry.name           = contig;
+        entry.records_offset = block_offset;
+        entry.num_records    = repeats.size();
+        for (const auto& repeat : repeats) {
+            write_value(index, static_cast<std::uint32_t>(repeat.region.begin()));
+            write_value(index, static_cast<std::uint32_t>(size(repeat.region)));
+            write_value(index, static_cast<std::uint32_t>(repeat.period));
+            entry.max_length = std::max(entry.max_length, static_cast<std::uint32_t>(size(repeat.region)));
+        }
+        block_offset += repeats.size() * 3 * sizeof(std::uint32_t);
+        contig_entries.push_back(std::move(entry));
+    }
+    header.index_offset = block_offset;
+    header.num_contigs  = static_cast<std::uint32_t>(contig_entries.size());
+    for (const auto& entry : contig_entries) {
+        write_value(index, static_cast<std::uint32_t>(entry.name.size()));
+        index.write(entry.name.data(), static_cast<std::streamsize>(entry.name.size()));
+        write_value(index, entry.records_offset);
+        write_value(index, entry.num_records);
+        write_value(index, entry.max_length);
+    }
+    index.seekp(0);
+    index.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!index) {
+        throw std::runtime_error {"could not write reference repeat index " + index_path.string()};
+    }
+}
+
+} // namespace octopus
@@ -0,0 +1,97 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef reference_repeat_index_hpp
+#define reference_repeat_index_hpp
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/filesystem/path.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "repeat_finder.hpp"
+
+namespace octopus {
+
+class ReferenceGenome;
+
+/*
+ ReferenceRepeatIndex is a binary sidecar holding every exact tandem repeat in
+ a reference up to a fixed period, found once and serialized beside the .fai.
+ Repeats are stored as fixed size, position sorted entries per contig and the
+ file is mapped rather than read, so a query costs a binary search over shared
+ pages instead of re-scanning reference sequence with the suffix machinery.
+ Queries touch no mutable state, so one index can be shared between threads.
+ The format is host endian; indexes are machine local and rebuilt when older
+ than their reference.
+ */
+class ReferenceRepeatIndex
+{
+public:
+    using Path = boost::filesystem::path;
+
+    ReferenceRepeatIndex() = delete;
+
+    ReferenceRepeatIndex(Path index_path);
+
+    ReferenceRepeatIndex(const ReferenceRepeatIndex&);
+    ReferenceRepeatIndex& operator=(const ReferenceRepeatIndex&);
+    ReferenceRepeatIndex(ReferenceRepeatIndex&&) noexcept;
+    ReferenceRepeatIndex& operator=(ReferenceRepeatIndex&&) noexcept;
+
+    ~ReferenceRepeatIndex() noexcept;
+
+    const Path& path() const noexcept;
+
+    unsigned max_indexed_period() const noexcept;
+
+    // All repeats with period at most max_period that overlap the given
+    // region, clipped to the region and in position order. Clipped runs
+    // shorter than two whole periods are dropped, matching what a windowed
+    // scan of the region would report. Note the run extraction is sensitive
+    // to the period range it searches, so only queries with max_period equal
+    // to the indexed period reproduce a direct scan
+    std::vector<TandemRepeat> fetch_overlapped(const GenomicRegion& region, GenomicRegion::Size max_period) const;
+
+private:
+    struct Record
+    {
+        std::uint32_t begin;
+        std::uint32_t length;
+        std::uint32_t period;
+    };
+
+    struct ContigIndex
+    {
+        const Record* records;
+        std::size_t num_records;
+        std::uint32_t max_length;
+    };
+
+    Path path_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    unsigned max_period_ = 0;
+    std::unordered_map<std::string, ContigIndex> contigs_;
+
+    void map_and_index();
+    void unmap() noexcept;
+};
+
+// The sidecar path used for a given reference FASTA
+ReferenceRepeatIndex::Path reference_repeat_index_path(const ReferenceRepeatIndex::Path& reference_path);
+
+// Scans the reference contig by contig and serializes every exact tandem
+// repeat with period up to max_period. This is the one-off cost the index
+// saves every later run from repaying. The default period matches what the
+// repeat consumers ask for
+void build_reference_repeat_index(const ReferenceGenome& reference, const ReferenceRepeatIndex::Path& index_path,
+                                  unsigned max_period = 6);
+
+} // namespace octopus
+
+#endif
@@ -3,11 +3,20 @@
 
 #include "repeat_finder.hpp"
 
+#include "reference_repeat_index.hpp"
+
 namespace octopus {
 
 std::vector<TandemRepeat>
 find_exact_tandem_repeats(const ReferenceGenome& reference, const GenomicRegion& region, unsigned max_period)
 {
+    // The run extraction is sensitive to the period range it searches, so the
+    // index can only stand in for a scan over the same period range
+    if (const auto* repeat_index = reference.repeat_index()) {
+        if (max_period == repeat_index->max_indexed_period()) {
+            return repeat_index->fetch_overlapped(region, max_period);
+        }
+    }
     auto sequence = reference.fetch_sequence(region);
     return find_exact_tandem_repeats(sequence, region, 1, max_period);
 }
@@ -54,8 +63,7 @@ std::vector<GenomicRegion>
 find_repeat_regions(const ReferenceGenome& reference, const GenomicRegion& region,
                     const InexactRepeatDefinition repeat_def)
 {
-    auto sequence = reference.fetch_sequence(region);
-    auto seeds = find_exact_tandem_repeats(sequence, region, 1, repeat_def.max_exact_repeat_seed_period);
+    const auto seeds = find_exact_tandem_repeats(reference, region, repeat_def.max_exact_repeat_seed_period);
     return find_repeat_regions(seeds, region, repeat_def);
 }
 
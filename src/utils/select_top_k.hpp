@@ -6,6 +6,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <numeric>
 #include <iterator>
 #include <queue>
 #include <cstddef>
@@ -15,9 +16,53 @@
 namespace octopus {
 
 using Index = std::size_t;
+using IndexVector = std::vector<Index>;
 using IndexTuple = std::vector<Index>;
 using IndexTupleVector = std::vector<IndexTuple>;
 
+// Returns the indices of the k greatest scores in descending score order,
+// without materialising a sorted copy of the scored values. Scores are
+// produced lazily by score(index), so callers ranking by a stored posterior
+// need only pass an indexing lambda
+template <typename ScoreGetter>
+IndexVector
+select_top_k_indices(const std::size_t num_values, const std::size_t k, ScoreGetter score)
+{
+    const auto compare = [&score] (Index lhs, Index rhs) { return score(lhs) > score(rhs); };
+    IndexVector result {};
+    result.reserve(std::min(k, num_values));
+    for (Index idx {0}; idx < num_values; ++idx) {
+        if (result.size() < k) {
+            result.push_back(idx);
+            std::push_heap(std::begin(result), std::end(result), compare);
+        } else if (k > 0 && score(idx) > score(result.front())) {
+            std::pop_heap(std::begin(result), std::end(result), compare);
+            result.back() = idx;
+            std::push_heap(std::begin(result), std::end(result), compare);
+        }
+    }
+    std::sort_heap(std::begin(result), std::end(result), compare);
+    return result;
+}
+
+// Visits indices in descending score order until the visitor returns false,
+// paying O(n) to heapify then O(log n) per visited index - cheaper than a
+// full sort whenever the visitor stops early
+template <typename ScoreGetter, typename UnaryVisitor>
+void visit_in_descending_score_order(const std::size_t num_values, ScoreGetter score, UnaryVisitor visit)
+{
+    const auto compare = [&score] (Index lhs, Index rhs) { return score(lhs) < score(rhs); };
+    IndexVector heap(num_values);
+    std::iota(std::begin(heap), std::end(heap), Index {0});
+    std::make_heap(std::begin(heap), std::end(heap), compare);
+    while (!heap.empty()) {
+        std::pop_heap(std::begin(heap), std::end(heap), compare);
+        const auto idx = heap.back();
+        heap.pop_back();
+        if (!visit(idx)) break;
+    }
+}
+
 namespace detail {
 
 template <typename T>
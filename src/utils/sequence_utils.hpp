@@ -13,6 +13,14 @@
 #include <algorithm>
 #include <functional>
 #include <random>
+#include <cstdint>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
 
 #include <boost/optional.hpp>
 
@@ -68,12 +76,61 @@ inline bool is_dna_or_rna_nucleotide(const char b) noexcept
     return b == 'A' || b == 'C' || b == 'G' || b == 'T' || b == 'U';
 }
 
+#ifdef __SSE2__
+
+inline std::size_t count_gc(const char* sequence, const std::size_t size) noexcept
+{
+    const auto g = _mm_set1_epi8('G');
+    const auto c = _mm_set1_epi8('C');
+    const auto ones = _mm_set1_epi8(1);
+    auto block_sums = _mm_setzero_si128();
+    std::size_t i {0};
+    for (; i + 16 <= size; i += 16) {
+        const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sequence + i));
+        const auto matches = _mm_or_si128(_mm_cmpeq_epi8(block, g), _mm_cmpeq_epi8(block, c));
+        block_sums = _mm_add_epi64(block_sums, _mm_sad_epu8(_mm_and_si128(matches, ones), _mm_setzero_si128()));
+    }
+    alignas(16) std::uint64_t partial_sums[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(partial_sums), block_sums);
+    auto result = static_cast<std::size_t>(partial_sums[0] + partial_sums[1]);
+    for (; i < size; ++i) {
+        if (sequence[i] == 'G' || sequence[i] == 'C') ++result;
+    }
+    return result;
+}
+
+inline bool contains_n(const char* sequence, const std::size_t size) noexcept
+{
+    const auto n = _mm_set1_epi8('N');
+    std::size_t i {0};
+    for (; i + 16 <= size; i += 16) {
+        const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sequence + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, n)) != 0) return true;
+    }
+    return std::find(sequence + i, sequence + size, 'N') != sequence + size;
+}
+
+#else // __SSE2__
+
+inline std::size_t count_gc(const char* sequence, const std::size_t size) noexcept
+{
+    return std::count_if(sequence, sequence + size,
+                         [] (const char base) noexcept { return base == 'G' || base == 'C'; });
+}
+
+inline bool contains_n(const char* sequence, const std::size_t size) noexcept
+{
+    return std::find(sequence, sequence + size, 'N') != sequence + size;
+}
+
+#endif // __SSE2__
+
 } // namespace detail
 
 template <typename SequenceType>
 bool has_ns(const SequenceType& sequence) noexcept
 {
-    return std::find(std::cbegin(sequence), std::cend(sequence), 'N') != std::cend(sequence);
+    return detail::contains_n(sequence.data(), sequence.size());
 }
 
 template <typename SequenceType>
@@ -225,12 +282,69 @@ OutputIt reverse_complement_copy(BidirIt first, BidirIt last, OutputIt result)
                           result, [] (const char base) { return complement(base); });
 }
 
+namespace detail {
+
+#ifdef __SSSE3__
+
+inline void reverse_complement_copy(const char* sequence, const std::size_t size, char* result) noexcept
+{
+    // The complements of the canonical bases (either case) and N are determined
+    // by their low nibbles, so blocks verified to contain only those characters
+    // can be complemented and reversed with byte shuffles; anything else takes
+    // the table, as in the scalar version
+    const auto nibble_complements = _mm_setr_epi8(4, 'T', 4, 'G', 'A', 'A', 4, 'C', 4, 4, 4, 4, 4, 4, 'N', 4);
+    const auto reversed_bytes = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const auto low_nibbles = _mm_set1_epi8(0x0F);
+    const auto upper_case = _mm_set1_epi8(static_cast<char>(0xDF));
+    const auto a = _mm_set1_epi8('A');
+    const auto c = _mm_set1_epi8('C');
+    const auto g = _mm_set1_epi8('G');
+    const auto t = _mm_set1_epi8('T');
+    const auto u = _mm_set1_epi8('U');
+    const auto n = _mm_set1_epi8('N');
+    std::size_t i {0};
+    for (; i + 16 <= size; i += 16) {
+        const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sequence + size - 16 - i));
+        const auto upper = _mm_and_si128(block, upper_case);
+        auto canonical = _mm_or_si128(_mm_cmpeq_epi8(upper, a), _mm_cmpeq_epi8(upper, c));
+        canonical = _mm_or_si128(canonical, _mm_cmpeq_epi8(upper, g));
+        canonical = _mm_or_si128(canonical, _mm_cmpeq_epi8(upper, t));
+        canonical = _mm_or_si128(canonical, _mm_cmpeq_epi8(upper, u));
+        canonical = _mm_or_si128(canonical, _mm_cmpeq_epi8(block, n));
+        if (_mm_movemask_epi8(canonical) == 0xFFFF) {
+            const auto complements = _mm_shuffle_epi8(nibble_complements, _mm_and_si128(block, low_nibbles));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i),
+                             _mm_shuffle_epi8(complements, reversed_bytes));
+        } else {
+            for (std::size_t j {i}; j < i + 16; ++j) {
+                result[j] = complement(sequence[size - 1 - j]);
+            }
+        }
+    }
+    for (; i < size; ++i) {
+        result[i] = complement(sequence[size - 1 - i]);
+    }
+}
+
+#else // __SSSE3__
+
+inline void reverse_complement_copy(const char* sequence, const std::size_t size, char* result) noexcept
+{
+    for (std::size_t i {0}; i < size; ++i) {
+        result[i] = complement(sequence[size - 1 - i]);
+    }
+}
+
+#endif // __SSSE3__
+
+} // namespace detail
+
 template <typename SequenceType>
 SequenceType reverse_complement_copy(const SequenceType& sequence)
 {
     SequenceType result {};
     result.resize(sequence.size());
-    reverse_complement_copy(std::cbegin(sequence), std::cend(sequence), std::begin(result));
+    detail::reverse_complement_copy(sequence.data(), sequence.size(), &result[0]);
     return result;
 }
 
@@ -355,8 +469,7 @@ std::unordered_map<char, size_t> count_bases(const SequenceType& sequence)
 template <typename SequenceType>
 double gc_content(const SequenceType& sequence) noexcept
 {
-    const auto gc_count = std::count_if(std::cbegin(sequence), std::cend(sequence),
-                                        [] (const char base) { return base == 'G' || base == 'C'; });
+    const auto gc_count = detail::count_gc(sequence.data(), sequence.size());
     return static_cast<double>(gc_count) / sequence.size();
 }
 
@@ -16,6 +16,7 @@
 #include <sstream>
 #include <iomanip>
 #include <locale>
+#include <cstdio>
 
 namespace octopus { namespace utils {
 
@@ -46,6 +47,14 @@ bool begins_with_vowel(const std::string& str);
 template <typename T, typename = typename std::enable_if_t<std::is_floating_point<T>::value>>
 std::string to_string(const T val, const unsigned precision = 2)
 {
+    // Most values formatted this way end up in record INFO and FORMAT fields,
+    // where constructing an ostream per value is measurable churn
+    char buffer[64];
+    const auto n = std::snprintf(buffer, sizeof(buffer), "%.*Lf",
+                                 static_cast<int>(precision), static_cast<long double>(val));
+    if (n > 0 && static_cast<std::size_t>(n) < sizeof(buffer)) {
+        return std::string {buffer, static_cast<std::size_t>(n)};
+    }
     std::ostringstream out;
     out << std::fixed << std::setprecision(precision) << val;
     return out.str();
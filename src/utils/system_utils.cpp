@@ -5,6 +5,13 @@
 
 #include <sys/resource.h>
 
+#ifdef __APPLE__
+#include <mach/mach.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
 namespace octopus {
 
 std::size_t get_max_open_files()
@@ -14,4 +21,26 @@ std::size_t get_max_open_files()
     return lim.rlim_cur;
 }
 
+boost::optional<MemoryFootprint> get_current_resident_set_size()
+{
+#ifdef __APPLE__
+    mach_task_basic_info info;
+    mach_msg_type_number_t count {MACH_TASK_BASIC_INFO_COUNT};
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+        return MemoryFootprint {static_cast<std::size_t>(info.resident_size)};
+    }
+#else
+    std::ifstream statm {"/proc/self/statm"};
+    std::size_t total_pages, resident_pages;
+    if (statm >> total_pages >> resident_pages) {
+        const auto page_size = sysconf(_SC_PAGESIZE);
+        if (page_size > 0) {
+            return MemoryFootprint {resident_pages * static_cast<std::size_t>(page_size)};
+        }
+    }
+#endif
+    return boost::none;
+}
+
 } // namespace octopus
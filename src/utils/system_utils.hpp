@@ -6,10 +6,18 @@
 
 #include <cstddef>
 
+#include <boost/optional.hpp>
+
+#include "memory_footprint.hpp"
+
 namespace octopus {
 
 std::size_t get_max_open_files();
 
+// The current physical memory usage (resident set size) of the calling
+// process, if the platform exposes it
+boost::optional<MemoryFootprint> get_current_resident_set_size();
+
 } // namespace octopus
 
 #endif
@@ -3,6 +3,8 @@
 
 #include "thread_pool.hpp"
 
+#include <stdexcept>
+
 namespace octopus {
 
 ThreadPool::ThreadPool() : ThreadPool {0} {}
@@ -10,22 +12,25 @@ ThreadPool::ThreadPool() : ThreadPool {0} {}
 ThreadPool::ThreadPool(const std::size_t n_threads)
 : stop_ {false}
 , n_idle_ {n_threads}
+, next_queue_ {0}
+, num_tasks_ {0}
+, queues_ (n_threads > 0 ? n_threads : 1)
 {
     workers_.reserve(n_threads);
     for (std::size_t i {0}; i < n_threads; ++i) {
-        workers_.emplace_back([this] {
+        workers_.emplace_back([this, i] {
             std::function<void()> task;
             while (true) {
-                std::unique_lock<std::mutex> lk {mutex_};
-                cv_.wait(lk, [this] () { return stop_ || !tasks_.empty(); });
-                if (stop_ && tasks_.empty()) return;
-                task = std::move(tasks_.front());
-                tasks_.pop();
-                --n_idle_;
-                lk.unlock();
-                task();
-                lk.lock();
-                ++n_idle_;
+                if (try_pop_task(i, task)) {
+                    --n_idle_;
+                    task();
+                    task = nullptr;
+                    ++n_idle_;
+                } else {
+                    std::unique_lock<std::mutex> lk {sleep_mutex_};
+                    cv_.wait(lk, [this] () { return stop_ || num_tasks_ > 0; });
+                    if (stop_ && num_tasks_ == 0) return;
+                }
             }
         });
     }
@@ -34,7 +39,7 @@ ThreadPool::ThreadPool(const std::size_t n_threads)
 ThreadPool::~ThreadPool() noexcept
 {
     {
-        std::lock_guard<std::mutex> lk {mutex_};
+        std::lock_guard<std::mutex> lk {sleep_mutex_};
         stop_ = true;
     }
     cv_.notify_all();
@@ -60,8 +65,64 @@ std::size_t ThreadPool::n_idle() const noexcept
 
 void ThreadPool::clear() noexcept
 {
-    std::lock_guard<std::mutex> lk {mutex_};
-    while (!tasks_.empty()) tasks_.pop();
+    for (auto& queue : queues_) {
+        std::lock_guard<std::mutex> lk {queue.mutex};
+        num_tasks_ -= queue.tasks.size();
+        queue.tasks.clear();
+    }
+}
+
+void ThreadPool::do_push(std::function<void()> task)
+{
+    if (stop_) throw std::runtime_error {"ThreadPool: calling push on stopped pool"};
+    const auto num_queues = queues_.size();
+    const auto origin = next_queue_++;
+    bool pushed {false};
+    // Submissions rotate over the queues, settling for the first uncontended
+    // one so concurrent producers rarely block each other
+    for (std::size_t k {0}; k < num_queues && !pushed; ++k) {
+        auto& queue = queues_[(origin + k) % num_queues];
+        std::unique_lock<std::mutex> lk {queue.mutex, std::try_to_lock};
+        if (lk.owns_lock()) {
+            queue.tasks.push_back(std::move(task));
+            ++num_tasks_;
+            pushed = true;
+        }
+    }
+    if (!pushed) {
+        auto& queue = queues_[origin % num_queues];
+        std::lock_guard<std::mutex> lk {queue.mutex};
+        queue.tasks.push_back(std::move(task));
+        ++num_tasks_;
+    }
+    {
+        // Lock so the wakeup cannot slip between a worker's failed pop and its wait
+        std::lock_guard<std::mutex> lk {sleep_mutex_};
+        cv_.notify_one();
+    }
+}
+
+bool ThreadPool::try_pop_task(const std::size_t worker_idx, std::function<void()>& task)
+{
+    const auto num_queues = queues_.size();
+    for (std::size_t k {0}; k < num_queues; ++k) {
+        auto& queue = queues_[(worker_idx + k) % num_queues];
+        std::lock_guard<std::mutex> lk {queue.mutex};
+        if (!queue.tasks.empty()) {
+            if (k == 0) {
+                // Owners drain their queue in submission order; thieves take
+                // from the other end to stay out of the owner's way
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            } else {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            --num_tasks_;
+            return true;
+        }
+    }
+    return false;
 }
 
 } // namespace octopus
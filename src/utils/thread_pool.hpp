@@ -1,14 +1,14 @@
 // Copyright (c) 2015-2018 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-// This thread pool implementation is mostly derived from https://github.com/progschj/ThreadPool
+// This thread pool implementation was originally derived from https://github.com/progschj/ThreadPool
 
 #ifndef thread_pool_hpp
 #define thread_pool_hpp
 
 #include <cstddef>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <thread>
@@ -27,31 +27,45 @@ class ThreadPool
 public:
     ThreadPool();
     explicit ThreadPool(std::size_t n_threads);
-    
+
     ThreadPool(const ThreadPool&)             = delete;
     ThreadPool& operator=(const ThreadPool&)  = delete;
     ThreadPool(ThreadPool&& other) noexcept   = delete;
     ThreadPool& operator=(ThreadPool&& other) = delete;
-    
+
     ~ThreadPool() noexcept;
-    
+
     std::size_t size() const noexcept;
     bool empty() const noexcept;
     std::size_t n_idle() const noexcept;
-    
+
     void clear() noexcept;
-    
+
     template <typename F, typename... Args>
     auto push(F&& f, Args&&... args) -> std::future<std::result_of_t<F(Args...)>>;
-    
+
 private:
-    std::mutex mutex_;
+    // Each worker owns a deque; submissions are spread over the deques and
+    // idle workers steal from their neighbours, so pushes and pops contend a
+    // striped lock rather than one pool-wide mutex
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::mutex sleep_mutex_;
     std::condition_variable cv_;
     std::atomic<bool> stop_;
     std::atomic<std::size_t> n_idle_;
-    
+    std::atomic<std::size_t> next_queue_;
+    std::atomic<std::size_t> num_tasks_;
+
+    std::vector<TaskQueue> queues_;
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
+
+    void do_push(std::function<void()> task);
+    bool try_pop_task(std::size_t worker_idx, std::function<void()>& task);
 };
 
 template <typename F, typename... Args>
@@ -60,12 +74,7 @@ auto ThreadPool::push(F&& f, Args&&... args) -> std::future<std::result_of_t<F(A
     using f_result_type = std::result_of_t<F(Args...)>;
     auto task = std::make_shared<std::packaged_task<f_result_type()>>(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
     auto result = task->get_future();
-    {
-        std::lock_guard<std::mutex> lk {mutex_};
-        if (stop_) throw std::runtime_error {"ThreadPool: calling push on stopped pool"};
-        tasks_.emplace([task] () { (*task)(); });
-    }
-    cv_.notify_one();
+    do_push([task] () { (*task)(); });
     return result;
 }
 
@@ -7,17 +7,17 @@
 #include <chrono>
 
 template <typename D = std::chrono::nanoseconds, typename F>
-D benchmark(F f, unsigned num_tests)
+D benchmark(F f, const unsigned num_tests)
 {
     D total {0};
-    
-    for (; num_tests > 0; --num_tests) {
+
+    for (auto n = num_tests; n > 0; --n) {
         const auto start = std::chrono::system_clock::now();
         f();
         const auto end = std::chrono::system_clock::now();
         total += std::chrono::duration_cast<D>(end - start);
     }
-    
+
     return D {total / num_tests};
 }
 
@@ -0,0 +1,183 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// Micro-benchmark for the SIMD pair HMM aligners in simd_pair_hmm.cpp.
+//
+// Replays read/haplotype pairs from a TSV file with one record per line:
+//
+//     <haplotype sequence> TAB <read sequence> TAB <base qualities, phred+33> [TAB <mapped offset>]
+//
+// as can be captured from the inputs to HaplotypeLikelihoodModel::evaluate. If
+// no file is given a fixed-seed random workload is generated, so two builds of
+// this benchmark always align the same cells. Each available band width (8,
+// 16, and 32 if the CPU supports the matching kernels) is timed over each of
+// the scoring align variants and reported as cells per second.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/models/pairhmm/simd_pair_hmm.hpp"
+
+#include "benchmark_utils.hpp"
+
+namespace {
+
+struct AlignmentPair
+{
+    std::string truth, target;
+    std::vector<std::int8_t> qualities;
+    std::size_t offset;
+};
+
+auto read_pairs(const std::string& path)
+{
+    std::vector<AlignmentPair> result {};
+    std::ifstream file {path};
+    if (!file) {
+        throw std::runtime_error {"could not open " + path};
+    }
+    std::string line {};
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        std::istringstream record {line};
+        AlignmentPair pair {};
+        std::string qualities;
+        record >> pair.truth >> pair.target >> qualities;
+        if (!(record >> pair.offset)) {
+            pair.offset = (pair.truth.size() - pair.target.size()) / 2;
+        }
+        pair.qualities.reserve(qualities.size());
+        std::transform(std::cbegin(qualities), std::cend(qualities), std::back_inserter(pair.qualities),
+                       [] (const char c) { return static_cast<std::int8_t>(c - 33); });
+        if (pair.qualities.size() == pair.target.size()) {
+            result.push_back(std::move(pair));
+        }
+    }
+    return result;
+}
+
+auto make_random_pairs(const std::size_t num_pairs, const std::size_t target_len, const std::size_t max_pad)
+{
+    std::mt19937 rng {42};
+    std::uniform_int_distribution<int> base {0, 3}, quality {10, 40}, error {0, 99};
+    constexpr char bases[] {"ACGT"};
+    std::vector<AlignmentPair> result(num_pairs);
+    for (auto& pair : result) {
+        pair.offset = max_pad;
+        pair.truth.resize(target_len + 2 * max_pad);
+        for (auto& b : pair.truth) b = bases[base(rng)];
+        pair.target.resize(target_len);
+        pair.qualities.resize(target_len);
+        for (std::size_t i {0}; i < target_len; ++i) {
+            pair.target[i] = error(rng) < 95 ? pair.truth[pair.offset + i] : bases[base(rng)];
+            pair.qualities[i] = quality(rng);
+        }
+    }
+    return result;
+}
+
+// The alignment window for a given band, or -1 if the pair's haplotype does
+// not contain the read by at least the band either side of the mapped position
+int alignment_offset(const AlignmentPair& pair, const int band) noexcept
+{
+    const auto truth_alignment_size = static_cast<int>(pair.target.size()) + 2 * band - 1;
+    const auto result = std::max(0, static_cast<int>(pair.offset) - band);
+    if (result + truth_alignment_size > static_cast<int>(pair.truth.size())) {
+        return -1;
+    }
+    return result;
+}
+
+template <typename F>
+double cells_per_second(F&& f, const std::size_t cells, const unsigned num_reps)
+{
+    const auto mean_duration = benchmark<std::chrono::nanoseconds>(f, num_reps);
+    return cells / (mean_duration.count() / 1e9);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    namespace simd = octopus::hmm::simd;
+    constexpr unsigned numReps {5};
+    const auto max_band = simd::max_band_size();
+    std::vector<AlignmentPair> pairs {};
+    try {
+        if (argc > 1) {
+            pairs = read_pairs(argv[1]);
+        } else {
+            pairs = make_random_pairs(20000, 100, max_band);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    if (pairs.empty()) {
+        std::cerr << "no usable read/haplotype pairs\n";
+        return 1;
+    }
+    std::cout << "pairs: " << pairs.size() << " max band: " << max_band << '\n';
+    int checksum {0};
+    for (int band {static_cast<int>(simd::min_flank_pad())}; band <= max_band; band *= 2) {
+        std::size_t cells {0};
+        std::size_t num_aligned {0};
+        std::vector<std::int8_t> gap_open {}, snv_priors {};
+        for (const auto& pair : pairs) {
+            if (alignment_offset(pair, band) >= 0) {
+                cells += band * pair.target.size();
+                ++num_aligned;
+            }
+            if (pair.truth.size() > gap_open.size()) {
+                gap_open.assign(pair.truth.size(), 45);
+                snv_priors.assign(pair.truth.size(), 45);
+            }
+        }
+        if (num_aligned == 0) {
+            std::cout << "band " << band << ": no pairs padded enough to align\n";
+            continue;
+        }
+        const auto run_variant = [&] (const char* name, auto&& align_one) {
+            const auto run_all = [&] () {
+                for (const auto& pair : pairs) {
+                    const auto offset = alignment_offset(pair, band);
+                    if (offset >= 0) {
+                        checksum += align_one(pair, offset);
+                    }
+                }
+            };
+            run_all(); // warm up
+            const auto rate = cells_per_second(run_all, cells, numReps);
+            std::cout << "band " << band << ' ' << name << ": "
+                      << rate / 1e9 << " Gcells/s over " << num_aligned << " alignments\n";
+        };
+        run_variant("flat-gap", [&] (const AlignmentPair& pair, const int offset) {
+            const auto truth_size = static_cast<int>(pair.target.size()) + 2 * band - 1;
+            return simd::align(pair.truth.data() + offset, pair.target.data(), pair.qualities.data(),
+                               truth_size, static_cast<int>(pair.target.size()),
+                               short {45}, short {10}, short {2});
+        });
+        run_variant("gap-vector", [&] (const AlignmentPair& pair, const int offset) {
+            const auto truth_size = static_cast<int>(pair.target.size()) + 2 * band - 1;
+            return simd::align(pair.truth.data() + offset, pair.target.data(), pair.qualities.data(),
+                               truth_size, static_cast<int>(pair.target.size()),
+                               gap_open.data() + offset, short {10}, short {2});
+        });
+        run_variant("snv-mask", [&] (const AlignmentPair& pair, const int offset) {
+            const auto truth_size = static_cast<int>(pair.target.size()) + 2 * band - 1;
+            return simd::align(pair.truth.data() + offset, pair.target.data(), pair.qualities.data(),
+                               truth_size, static_cast<int>(pair.target.size()),
+                               pair.truth.data() + offset, snv_priors.data() + offset,
+                               gap_open.data() + offset, short {10}, short {2});
+        });
+    }
+    // Keep the alignment results live so the calls cannot be optimised away
+    return checksum == 42 ? 2 : 0;
+}
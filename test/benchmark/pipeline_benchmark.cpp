@@ -0,0 +1,169 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// End-to-end pipeline benchmark driven by pinned scenarios.
+//
+// The scenario file is JSON of the form:
+//
+// {
+//     "scenarios": [
+//         {
+//             "name": "individual.chr20_slice",
+//             "args": ["--reference", "ref.fa", "--reads", "slice.bam",
+//                      "-T", "20:30000000-30100000", "-o", "out.vcf"],
+//             "budgets": {"init": 5.0, "run": 120.0}
+//         }
+//     ]
+// }
+//
+// Every scenario goes through the real entry points - option parsing,
+// component collation, and run_octopus - so a calling scenario exercises a
+// caller end to end (including filtering when requested) and a --filter-vcf
+// scenario exercises just the filter stack. Stage wall times are reported as
+// JSON for trend tracking, and any stage exceeding its budget (in seconds)
+// fails the run, so a CI job can assert against regressions.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "config/option_parser.hpp"
+#include "core/calling_components.hpp"
+#include "core/octopus.hpp"
+#include "logging/logging.hpp"
+#include "utils/string_utils.hpp"
+
+namespace {
+
+struct StageTiming
+{
+    std::string name;
+    double seconds;
+    boost::optional<double> budget;
+};
+
+struct ScenarioResult
+{
+    std::string name;
+    std::vector<StageTiming> stages;
+    boost::optional<std::string> error;
+};
+
+double seconds_since(const std::chrono::system_clock::time_point start)
+{
+    const auto duration = std::chrono::system_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+}
+
+ScenarioResult run_scenario(const boost::property_tree::ptree& scenario)
+{
+    ScenarioResult result {};
+    result.name = scenario.get<std::string>("name");
+    std::vector<std::string> args {"octopus"};
+    for (const auto& p : scenario.get_child("args")) {
+        args.push_back(p.second.get_value<std::string>());
+    }
+    std::vector<const char*> argv(args.size());
+    std::transform(std::cbegin(args), std::cend(args), std::begin(argv),
+                   [] (const auto& arg) { return arg.c_str(); });
+    const auto budget = [&scenario] (const std::string& stage) -> boost::optional<double> {
+        return scenario.get_optional<double>("budgets." + stage);
+    };
+    try {
+        const auto init_start = std::chrono::system_clock::now();
+        auto options = octopus::options::parse_options(static_cast<int>(argv.size()), argv.data());
+        auto components = octopus::collate_genome_calling_components(options);
+        result.stages.push_back({"init", seconds_since(init_start), budget("init")});
+        if (!octopus::validate(components)) {
+            throw std::runtime_error {"scenario components failed validation"};
+        }
+        options.clear();
+        const auto run_start = std::chrono::system_clock::now();
+        octopus::run_octopus(components, octopus::utils::join(args, ' '));
+        result.stages.push_back({"run", seconds_since(run_start), budget("run")});
+    } catch (const std::exception& e) {
+        result.error = std::string {e.what()};
+    } catch (...) {
+        result.error = std::string {"unknown error"};
+    }
+    return result;
+}
+
+void write_results(const std::vector<ScenarioResult>& results, std::ostream& out)
+{
+    boost::property_tree::ptree root {}, scenarios {};
+    for (const auto& result : results) {
+        boost::property_tree::ptree node {}, stages {};
+        node.put("name", result.name);
+        for (const auto& stage : result.stages) {
+            boost::property_tree::ptree stage_node {};
+            stage_node.put("seconds", stage.seconds);
+            if (stage.budget) {
+                stage_node.put("budget", *stage.budget);
+                stage_node.put("within_budget", stage.seconds <= *stage.budget);
+            }
+            stages.add_child(stage.name, stage_node);
+        }
+        node.add_child("stages", stages);
+        if (result.error) {
+            node.put("error", *result.error);
+        }
+        scenarios.push_back(std::make_pair("", node));
+    }
+    root.add_child("results", scenarios);
+    boost::property_tree::write_json(out, root);
+}
+
+bool all_within_budget(const std::vector<ScenarioResult>& results) noexcept
+{
+    return std::all_of(std::cbegin(results), std::cend(results),
+                       [] (const auto& result) {
+                           return !result.error
+                                  && std::all_of(std::cbegin(result.stages), std::cend(result.stages),
+                                                 [] (const auto& stage) {
+                                                     return !stage.budget || stage.seconds <= *stage.budget;
+                                                 });
+                       });
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "usage: octopus-bench <scenarios.json> [<results.json>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    octopus::logging::init();
+    boost::property_tree::ptree config {};
+    try {
+        boost::property_tree::read_json(argv[1], config);
+    } catch (const std::exception& e) {
+        std::cerr << "could not read scenario file " << argv[1] << ": " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::vector<ScenarioResult> results {};
+    for (const auto& p : config.get_child("scenarios")) {
+        results.push_back(run_scenario(p.second));
+    }
+    if (argc > 2) {
+        std::ofstream out {argv[2]};
+        if (!out) {
+            std::cerr << "could not open results file " << argv[2] << std::endl;
+            return EXIT_FAILURE;
+        }
+        write_results(results, out);
+    }
+    write_results(results, std::cout);
+    return all_within_budget(results) ? EXIT_SUCCESS : EXIT_FAILURE;
+}